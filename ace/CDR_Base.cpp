@@ -10,6 +10,22 @@
 #include "ace/OS_Memory.h"
 #include "ace/OS_NS_string.h"
 
+#if !defined (ACE_LACKS_CDR_SIMD_SWAP)
+# if (defined (__x86_64__) && defined (__SSE2__)) || defined (_M_X64)
+#   define ACE_CDR_SIMD_SWAP_SSE2
+#   include <emmintrin.h>
+#   if defined (__clang__) \
+       || (defined (__GNUC__) \
+           && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#     define ACE_CDR_SIMD_SWAP_AVX2
+#     include <immintrin.h>
+#   endif /* __clang__ || __GNUC__ >= 4.9 */
+# elif defined (__aarch64__) && defined (__ARM_NEON)
+#   define ACE_CDR_SIMD_SWAP_NEON
+#   include <arm_neon.h>
+# endif /* x86-64 || AArch64 */
+#endif /* ! ACE_LACKS_CDR_SIMD_SWAP */
+
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
 #if defined (NONNATIVE_LONGDOUBLE)
@@ -21,11 +37,188 @@ static const ACE_INT16 max_fifteen_bit = 0x3fff;
 // See comments in CDR_Base.inl about optimization cases for swap_XX_array.
 //
 
+// The bulk of the arrays is swapped with vector instructions where
+// they're known to be there: SSE2 on x86-64, plus AVX2 when the CPU
+// has it, and NEON on AArch64.  Each of the simd_swap_X functions
+// swaps the elements of the first blocks of the array and returns how
+// many it swapped, leaving the rest to the scalar code below.
+
+#if defined (ACE_CDR_SIMD_SWAP_SSE2)
+
+#if defined (ACE_CDR_SIMD_SWAP_AVX2)
+
+// The CPU is only checked once.
+static bool
+cpu_has_avx2 (void)
+{
+  static bool const has_avx2 =
+    (__builtin_cpu_init (), __builtin_cpu_supports ("avx2") != 0);
+  return has_avx2;
+}
+
+// Byte permutations of each 16 bytes, for 2, 4 and 8 byte elements.
+static char const swap_2_shuffle[16] =
+  { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+static char const swap_4_shuffle[16] =
+  { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+static char const swap_8_shuffle[16] =
+  { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+// Permute the bytes of the first multiple of 16 of @a size bytes,
+// returning how many were.
+__attribute__ ((target ("avx2")))
+static size_t
+avx2_swap (char const *orig, char *target, size_t size, char const *shuffle)
+{
+  __m128i const mask_128 =
+    _mm_loadu_si128 (reinterpret_cast<__m128i const *> (shuffle));
+  __m256i const mask = _mm256_broadcastsi128_si256 (mask_128);
+
+  size_t done = 0;
+  for (; done + 32 <= size; done += 32)
+    {
+      __m256i const v =
+        _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (orig + done));
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (target + done),
+                           _mm256_shuffle_epi8 (v, mask));
+    }
+  if (done + 16 <= size)
+    {
+      __m128i const v =
+        _mm_loadu_si128 (reinterpret_cast<__m128i const *> (orig + done));
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (target + done),
+                        _mm_shuffle_epi8 (v, mask_128));
+      done += 16;
+    }
+  return done;
+}
+
+#endif /* ACE_CDR_SIMD_SWAP_AVX2 */
+
+// Swap the two bytes of each 16 bit word.
+static inline __m128i
+sse2_swap_words (__m128i v)
+{
+  return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+}
+
+static size_t
+simd_swap_2 (char const *orig, char *target, size_t n)
+{
+#if defined (ACE_CDR_SIMD_SWAP_AVX2)
+  if (n >= 16 && cpu_has_avx2 ())
+    return avx2_swap (orig, target, 2 * n, swap_2_shuffle) / 2;
+#endif /* ACE_CDR_SIMD_SWAP_AVX2 */
+
+  size_t const end = 2 * n - (2 * n) % 16;
+  for (size_t i = 0; i < end; i += 16)
+    {
+      __m128i const v =
+        _mm_loadu_si128 (reinterpret_cast<__m128i const *> (orig + i));
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (target + i),
+                        sse2_swap_words (v));
+    }
+  return end / 2;
+}
+
+static size_t
+simd_swap_4 (char const *orig, char *target, size_t n)
+{
+#if defined (ACE_CDR_SIMD_SWAP_AVX2)
+  if (n >= 8 && cpu_has_avx2 ())
+    return avx2_swap (orig, target, 4 * n, swap_4_shuffle) / 4;
+#endif /* ACE_CDR_SIMD_SWAP_AVX2 */
+
+  size_t const end = 4 * n - (4 * n) % 16;
+  for (size_t i = 0; i < end; i += 16)
+    {
+      // Swap the words of each element, then their bytes.
+      __m128i v =
+        _mm_loadu_si128 (reinterpret_cast<__m128i const *> (orig + i));
+      v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+      v = _mm_shufflehi_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (target + i),
+                        sse2_swap_words (v));
+    }
+  return end / 4;
+}
+
+static size_t
+simd_swap_8 (char const *orig, char *target, size_t n)
+{
+#if defined (ACE_CDR_SIMD_SWAP_AVX2)
+  if (n >= 4 && cpu_has_avx2 ())
+    return avx2_swap (orig, target, 8 * n, swap_8_shuffle) / 8;
+#endif /* ACE_CDR_SIMD_SWAP_AVX2 */
+
+  size_t const end = 8 * n - (8 * n) % 16;
+  for (size_t i = 0; i < end; i += 16)
+    {
+      __m128i v =
+        _mm_loadu_si128 (reinterpret_cast<__m128i const *> (orig + i));
+      v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (0, 1, 2, 3));
+      v = _mm_shufflehi_epi16 (v, _MM_SHUFFLE (0, 1, 2, 3));
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (target + i),
+                        sse2_swap_words (v));
+    }
+  return end / 8;
+}
+
+#elif defined (ACE_CDR_SIMD_SWAP_NEON)
+
+static size_t
+simd_swap_2 (char const *orig, char *target, size_t n)
+{
+  size_t const end = 2 * n - (2 * n) % 16;
+  for (size_t i = 0; i < end; i += 16)
+    vst1q_u8 (reinterpret_cast<uint8_t *> (target + i),
+              vrev16q_u8 (vld1q_u8 (reinterpret_cast<uint8_t const *> (orig + i))));
+  return end / 2;
+}
+
+static size_t
+simd_swap_4 (char const *orig, char *target, size_t n)
+{
+  size_t const end = 4 * n - (4 * n) % 16;
+  for (size_t i = 0; i < end; i += 16)
+    vst1q_u8 (reinterpret_cast<uint8_t *> (target + i),
+              vrev32q_u8 (vld1q_u8 (reinterpret_cast<uint8_t const *> (orig + i))));
+  return end / 4;
+}
+
+static size_t
+simd_swap_8 (char const *orig, char *target, size_t n)
+{
+  size_t const end = 8 * n - (8 * n) % 16;
+  for (size_t i = 0; i < end; i += 16)
+    vst1q_u8 (reinterpret_cast<uint8_t *> (target + i),
+              vrev64q_u8 (vld1q_u8 (reinterpret_cast<uint8_t const *> (orig + i))));
+  return end / 8;
+}
+
+#endif /* ACE_CDR_SIMD_SWAP_SSE2 */
+
+#if defined (ACE_CDR_SIMD_SWAP_SSE2) || defined (ACE_CDR_SIMD_SWAP_NEON)
+# define ACE_CDR_SIMD_SWAP(SIZE, ORIG, TARGET, N) \
+  do { \
+    size_t const simd_done = simd_swap_##SIZE (ORIG, TARGET, N); \
+    if (simd_done == N) \
+      return; \
+    ORIG += SIZE * simd_done; \
+    TARGET += SIZE * simd_done; \
+    N -= simd_done; \
+  } while (0)
+#else
+# define ACE_CDR_SIMD_SWAP(SIZE, ORIG, TARGET, N) do {} while (0)
+#endif /* ACE_CDR_SIMD_SWAP_SSE2 || ACE_CDR_SIMD_SWAP_NEON */
+
 void
 ACE_CDR::swap_2_array (char const * orig, char* target, size_t n)
 {
   // ACE_ASSERT(n > 0); The caller checks that n > 0
 
+  ACE_CDR_SIMD_SWAP (2, orig, target, n);
+
   // We pretend that AMD64/GNU G++ systems have a Pentium CPU to
   // take advantage of the inline assembly implementation.
 
@@ -253,6 +446,8 @@ ACE_CDR::swap_4_array (char const * orig, char* target, size_t n)
 {
   // ACE_ASSERT (n > 0); The caller checks that n > 0
 
+  ACE_CDR_SIMD_SWAP (4, orig, target, n);
+
 #if ACE_SIZEOF_LONG == 8
   // Later, we read from *orig in 64 bit chunks,
   // so make sure we don't generate unaligned readings.
@@ -461,6 +656,8 @@ ACE_CDR::swap_8_array (char const * orig, char* target, size_t n)
 {
   // ACE_ASSERT(n > 0); The caller checks that n > 0
 
+  ACE_CDR_SIMD_SWAP (8, orig, target, n);
+
   char const * const end = orig + 8*n;
   while (orig < end)
     {
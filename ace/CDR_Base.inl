@@ -40,6 +40,10 @@ ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 //   (none of the above)
 //   => shift/masks using 32bit words.
 //
+// In addition, the bulk of the arrays is swapped with SSE2 on x86-64,
+// AVX2 if the CPU has it, or NEON on AArch64, unless
+// ACE_LACKS_CDR_SIMD_SWAP is defined; see CDR_Base.cpp.
+//
 //
 // Some things you could find useful to know if you intend to mess
 // with this optimizations for swaps:
@@ -0,0 +1,118 @@
+// $Id$
+
+#ifndef ACE_CDR_FIXED_T_CPP
+#define ACE_CDR_FIXED_T_CPP
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/CDR_Fixed_T.h"
+
+#if !defined (__ACE_INLINE__)
+#include "ace/CDR_Fixed_T.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+template <typename S, typename FIELDS> ACE_CDR::Boolean
+ACE_CDR_Fixed<S, FIELDS>::write_array (ACE_OutputCDR &cdr,
+                                       const S *x,
+                                       ACE_CDR::ULong length)
+{
+  if (length == 0)
+    return true;
+
+  // One at a time if the structures would not be where <layout>
+  // puts them, <stride> apart.
+  if (!aligned_array
+      || !ACE_CDR_Fixed<S, FIELDS>::aligned (cdr.current_alignment ()))
+    {
+      for (ACE_CDR::ULong i = 0; i != length; ++i)
+        if (!ACE_CDR_Fixed<S, FIELDS>::write (cdr, x[i]))
+          return false;
+      return true;
+    }
+
+  // There is no padding after the last structure.
+  size_t const size = (length - 1) * static_cast<size_t> (stride) + wire_size;
+  char *buf = 0;
+  if (cdr.adjust (size, alignment, buf) != 0)
+    return false;
+
+  bool const swap = ACE_CDR_Fixed<S, FIELDS>::swap (cdr);
+  if (!swap && ACE_CDR_Fixed<S, FIELDS>::array_copyable ())
+    {
+      ACE_OS::memcpy (buf, x, size);
+      return true;
+    }
+
+  for (ACE_CDR::ULong i = 0; i != length; ++i, buf += stride)
+    layout::pack (reinterpret_cast<char const *> (x + i), buf, swap);
+  return true;
+}
+
+template <typename S, typename FIELDS> ACE_CDR::Boolean
+ACE_CDR_Fixed<S, FIELDS>::read_array (ACE_InputCDR &cdr,
+                                      S *x,
+                                      ACE_CDR::ULong length)
+{
+  if (length == 0)
+    return true;
+
+  // One at a time if the structures would not be where <layout>
+  // puts them, <stride> apart.
+  if (!aligned_array
+      || !ACE_CDR_Fixed<S, FIELDS>::aligned (
+            reinterpret_cast<size_t> (cdr.rd_ptr ())))
+    {
+      for (ACE_CDR::ULong i = 0; i != length; ++i)
+        if (!ACE_CDR_Fixed<S, FIELDS>::read (cdr, x[i]))
+          return false;
+      return true;
+    }
+
+  size_t const size = (length - 1) * static_cast<size_t> (stride) + wire_size;
+  char *buf = 0;
+  if (cdr.adjust (size, alignment, buf) != 0)
+    return false;
+
+  bool const swap = cdr.do_byte_swap ();
+  if (!swap && ACE_CDR_Fixed<S, FIELDS>::array_copyable ())
+    {
+      ACE_OS::memcpy (x, buf, size);
+      return true;
+    }
+
+  for (ACE_CDR::ULong i = 0; i != length; ++i, buf += stride)
+    layout::unpack (buf, reinterpret_cast<char *> (x + i), swap);
+  return true;
+}
+
+template <typename S, typename FIELDS> ACE_CDR::Boolean
+ACE_CDR_Fixed<S, FIELDS>::write_array (ACE_SizeCDR &cdr,
+                                       const S *x,
+                                       ACE_CDR::ULong length)
+{
+  if (length == 0)
+    return true;
+
+  // One at a time if the structures would not be where <layout>
+  // puts them, <stride> apart.
+  if (!aligned_array
+      || !ACE_CDR_Fixed<S, FIELDS>::aligned (cdr.total_length ()))
+    {
+      for (ACE_CDR::ULong i = 0; i != length; ++i)
+        if (!ACE_CDR_Fixed<S, FIELDS>::write (cdr, x[i]))
+          return false;
+      return true;
+    }
+
+  cdr.adjust ((length - 1) * static_cast<size_t> (stride) + wire_size,
+              alignment);
+  return cdr.good_bit ();
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_CDR_FIXED_T_CPP */
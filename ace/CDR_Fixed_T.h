@@ -0,0 +1,460 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    CDR_Fixed_T.h
+ *
+ *  $Id$
+ *
+ *  Marshaling of fixed-layout structures whose CDR layout is
+ *  computed at compile time.
+ *
+ *  A structure made only of the fixed size CDR types can be described
+ *  to ACE_CDR_Fixed by specializing ACE_CDR_Fixed_Traits with the list
+ *  of its fields, in the order they go on the wire:
+ *
+ *  @code
+ *  struct Sample
+ *  {
+ *    ACE_CDR::Long id;
+ *    ACE_CDR::Short flags;
+ *    ACE_CDR::Double value;
+ *  };
+ *
+ *  template <>
+ *  struct ACE_CDR_Fixed_Traits<Sample>
+ *  {
+ *    typedef ACE_CDR_Fixed_Field<ACE_CDR::Long, offsetof (Sample, id),
+ *            ACE_CDR_Fixed_Field<ACE_CDR::Short, offsetof (Sample, flags),
+ *            ACE_CDR_Fixed_Field<ACE_CDR::Double, offsetof (Sample, value)
+ *            > > > fields;
+ *  };
+ *
+ *  ACE_CDR::Boolean
+ *  operator<< (ACE_OutputCDR &cdr, const Sample &x)
+ *  {
+ *    return ACE_CDR_Fixed<Sample>::write (cdr, x);
+ *  }
+ *  @endcode
+ *
+ *  The position of every field on the wire, the size of the
+ *  structure on the wire and whether that is the same as its layout
+ *  in memory are then all known to the compiler.  Writing or reading
+ *  the structure makes a single ACE_OutputCDR::adjust() or
+ *  ACE_InputCDR::adjust() call instead of one per field and, when the
+ *  layouts match and no byte swapping is needed, copies it with a
+ *  single memcpy.  Otherwise the fields are copied, and swapped if
+ *  need be, into the space reserved for the structure.
+ *
+ *  The result is the same stream as writing the fields one at a time
+ *  with the CDR operators.  Since a field is only aligned for itself,
+ *  a structure whose first field is not its most aligned one has a
+ *  different layout when it does not start at a multiple of its
+ *  alignment in the stream; it is then written field by field.
+ */
+//=============================================================================
+
+#ifndef ACE_CDR_FIXED_T_H
+#define ACE_CDR_FIXED_T_H
+
+#include /**/ "ace/pre.h"
+
+#include "ace/CDR_Stream.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/CDR_Size.h"
+#include "ace/OS_NS_string.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/// Ends the list of fields of a structure.
+struct ACE_CDR_Fixed_End
+{
+};
+
+/**
+ * @struct ACE_CDR_Fixed_Field
+ *
+ * @brief A field of type @a T at offset @a OFFSET in the structure,
+ * followed on the wire by the fields in @a NEXT.
+ */
+template <typename T, size_t OFFSET, typename NEXT = ACE_CDR_Fixed_End>
+struct ACE_CDR_Fixed_Field
+{
+};
+
+/**
+ * @struct ACE_CDR_Fixed_Traits
+ *
+ * @brief Specialized for each structure written with ACE_CDR_Fixed,
+ * with a @c fields typedef listing its fields.
+ */
+template <typename S>
+struct ACE_CDR_Fixed_Traits;
+
+/// Swaps the bytes of a value of @a SIZE bytes.
+template <size_t SIZE>
+struct ACE_CDR_Fixed_Swap;
+
+template <>
+struct ACE_CDR_Fixed_Swap<1>
+{
+  static void swap (char const *orig, char *target) { *target = *orig; }
+};
+
+template <>
+struct ACE_CDR_Fixed_Swap<2>
+{
+  static void swap (char const *orig, char *target)
+  {
+    ACE_CDR::swap_2 (orig, target);
+  }
+};
+
+template <>
+struct ACE_CDR_Fixed_Swap<4>
+{
+  static void swap (char const *orig, char *target)
+  {
+    ACE_CDR::swap_4 (orig, target);
+  }
+};
+
+template <>
+struct ACE_CDR_Fixed_Swap<8>
+{
+  static void swap (char const *orig, char *target)
+  {
+    ACE_CDR::swap_8 (orig, target);
+  }
+};
+
+/**
+ * @struct ACE_CDR_Fixed_Scalar
+ *
+ * @brief Size, alignment and copying of a CDR type of @a SIZE bytes.
+ */
+template <typename T, size_t SIZE>
+struct ACE_CDR_Fixed_Scalar
+{
+  enum
+  {
+    size = SIZE,
+#if defined (ACE_LACKS_CDR_ALIGNMENT)
+    alignment = 1,
+#else
+    alignment = SIZE,
+#endif /* ACE_LACKS_CDR_ALIGNMENT */
+    /// True if the value is the same in memory as on the wire.
+    copyable = (sizeof (T) == SIZE)
+  };
+
+  /// Copy the value at @a x to the wire at @a buf.
+  static void pack (char const *x, char *buf, bool swap)
+  {
+    if (swap)
+      ACE_CDR_Fixed_Swap<SIZE>::swap (x, buf);
+    else
+      ACE_OS::memcpy (buf, x, SIZE);
+  }
+
+  /// Copy the value on the wire at @a buf to @a x.
+  static void unpack (char const *buf, char *x, bool swap)
+  {
+    if (swap)
+      ACE_CDR_Fixed_Swap<SIZE>::swap (buf, x);
+    else
+      ACE_OS::memcpy (x, buf, SIZE);
+  }
+};
+
+/// The CDR types a fixed-layout structure can be made of.
+template <typename T>
+struct ACE_CDR_Fixed_Type;
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Char>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::Char, ACE_CDR::OCTET_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Octet>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::Octet, ACE_CDR::OCTET_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Short>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::Short, ACE_CDR::SHORT_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::UShort>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::UShort, ACE_CDR::SHORT_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Long>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::Long, ACE_CDR::LONG_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::ULong>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::ULong, ACE_CDR::LONG_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::LongLong>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::LongLong, ACE_CDR::LONGLONG_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::ULongLong>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::ULongLong, ACE_CDR::LONGLONG_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Float>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::Float, ACE_CDR::LONG_SIZE>
+{
+};
+
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Double>
+  : public ACE_CDR_Fixed_Scalar<ACE_CDR::Double, ACE_CDR::LONGLONG_SIZE>
+{
+};
+
+/// A Boolean goes on the wire as an octet that is 0 or 1, whatever
+/// its representation in memory.
+template <>
+struct ACE_CDR_Fixed_Type<ACE_CDR::Boolean>
+{
+  enum
+  {
+    size = ACE_CDR::OCTET_SIZE,
+    alignment = ACE_CDR::OCTET_ALIGN,
+    copyable = 0
+  };
+
+  static void pack (char const *x, char *buf, bool)
+  {
+    *buf = *reinterpret_cast<ACE_CDR::Boolean const *> (x) ? 1 : 0;
+  }
+
+  static void unpack (char const *buf, char *x, bool)
+  {
+    *reinterpret_cast<ACE_CDR::Boolean *> (x) = (*buf != 0);
+  }
+};
+
+/**
+ * @struct ACE_CDR_Fixed_Layout
+ *
+ * @brief The layout on the wire of the fields in @a FIELDS, the
+ * first of which starts at (or after, once aligned) byte @a POS of
+ * the structure.
+ */
+template <typename FIELDS, size_t POS>
+struct ACE_CDR_Fixed_Layout;
+
+template <size_t POS>
+struct ACE_CDR_Fixed_Layout<ACE_CDR_Fixed_End, POS>
+{
+  enum
+  {
+    end = POS,
+    alignment = 1,
+    lead_alignment = 1,
+    native = 1
+  };
+
+  static void pack (char const *, char *, bool) {}
+  static void unpack (char const *, char *, bool) {}
+  static int pack_each (ACE_OutputCDR &, char const *, bool) { return 0; }
+  static int unpack_each (ACE_InputCDR &, char *, bool) { return 0; }
+  static void size_each (ACE_SizeCDR &) {}
+};
+
+template <typename T, size_t OFFSET, typename NEXT, size_t POS>
+struct ACE_CDR_Fixed_Layout<ACE_CDR_Fixed_Field<T, OFFSET, NEXT>, POS>
+{
+  typedef ACE_CDR_Fixed_Type<T> type;
+
+  enum
+  {
+    /// Where the field is on the wire, from the start of the structure.
+    position = (POS + type::alignment - 1) / type::alignment * type::alignment
+  };
+
+  typedef ACE_CDR_Fixed_Layout<NEXT, position + type::size> next;
+
+  enum
+  {
+    /// Where the last field ends on the wire.
+    end = next::end,
+
+    /// Alignment of the first field.
+    lead_alignment = type::alignment,
+
+    /// Alignment of the most aligned field.
+    alignment = (static_cast<size_t> (type::alignment)
+                 > static_cast<size_t> (next::alignment)
+                 ? static_cast<size_t> (type::alignment)
+                 : static_cast<size_t> (next::alignment)),
+
+    /// True if all the fields are at the same place, and the same,
+    /// in memory as on the wire.
+    native = (static_cast<size_t> (position) == OFFSET
+              && type::copyable
+              && next::native)
+  };
+
+  /// Copy the fields of the structure at @a s to the wire at @a buf,
+  /// which is where the structure starts.
+  static void pack (char const *s, char *buf, bool swap)
+  {
+    type::pack (s + OFFSET, buf + position, swap);
+    next::pack (s, buf, swap);
+  }
+
+  /// Copy the fields on the wire at @a buf to the structure at @a s.
+  static void unpack (char const *buf, char *s, bool swap)
+  {
+    type::unpack (buf + position, s + OFFSET, swap);
+    next::unpack (buf, s, swap);
+  }
+
+  /// Write the fields one at a time, as the CDR operators would.
+  static int pack_each (ACE_OutputCDR &cdr, char const *s, bool swap)
+  {
+    char *buf = 0;
+    if (cdr.adjust (type::size, type::alignment, buf) != 0)
+      return -1;
+    type::pack (s + OFFSET, buf, swap);
+    return next::pack_each (cdr, s, swap);
+  }
+
+  /// Read the fields one at a time, as the CDR operators would.
+  static int unpack_each (ACE_InputCDR &cdr, char *s, bool swap)
+  {
+    char *buf = 0;
+    if (cdr.adjust (type::size, type::alignment, buf) != 0)
+      return -1;
+    type::unpack (buf, s + OFFSET, swap);
+    return next::unpack_each (cdr, s, swap);
+  }
+
+  /// Account for the fields one at a time.
+  static void size_each (ACE_SizeCDR &cdr)
+  {
+    cdr.adjust (type::size, type::alignment);
+    next::size_each (cdr);
+  }
+};
+
+/**
+ * @class ACE_CDR_Fixed
+ *
+ * @brief Writes and reads structures of type @a S, made of the
+ * fields in @a FIELDS, to and from CDR streams.
+ */
+template <typename S,
+          typename FIELDS = typename ACE_CDR_Fixed_Traits<S>::fields>
+class ACE_CDR_Fixed
+{
+public:
+  typedef ACE_CDR_Fixed_Layout<FIELDS, 0> layout;
+
+  enum
+  {
+    /// Size of a structure on the wire, up to the end of its last
+    /// field.
+    wire_size = layout::end,
+
+    /// Alignment of a structure on the wire.
+    alignment = layout::alignment,
+
+    /// Distance between the structures of an array on the wire.
+    stride = (wire_size + alignment - 1) / alignment * alignment,
+
+    /// True if the fields are where @c layout puts them wherever the
+    /// structure starts in the stream, which is the case when the
+    /// first field is the most aligned.  Otherwise that is only the
+    /// case when the structure starts at a multiple of @c alignment.
+    self_aligned = (static_cast<size_t> (layout::lead_alignment)
+                    == static_cast<size_t> (alignment)),
+
+    /// True if the structures of an array are all where @c layout
+    /// puts them, @c stride apart, once the first one is.
+    aligned_array = (self_aligned || wire_size % alignment == 0),
+
+    /// True if a structure is the same in memory as on the wire when
+    /// no byte swapping is needed.
+    native_layout = layout::native
+  };
+
+  /// Write @a x to @a cdr.
+  static ACE_CDR::Boolean write (ACE_OutputCDR &cdr, const S &x);
+
+  /// Read @a x from @a cdr.
+  static ACE_CDR::Boolean read (ACE_InputCDR &cdr, S &x);
+
+  /// Account for @a x in @a cdr.
+  static ACE_CDR::Boolean write (ACE_SizeCDR &cdr, const S &x);
+
+  /// Write the @a length structures at @a x to @a cdr, with a single
+  /// memcpy if their layout in memory is the same as on the wire.
+  static ACE_CDR::Boolean write_array (ACE_OutputCDR &cdr,
+                                       const S *x,
+                                       ACE_CDR::ULong length);
+
+  /// Read @a length structures from @a cdr into @a x.
+  static ACE_CDR::Boolean read_array (ACE_InputCDR &cdr,
+                                      S *x,
+                                      ACE_CDR::ULong length);
+
+  /// Account for the @a length structures at @a x in @a cdr.
+  static ACE_CDR::Boolean write_array (ACE_SizeCDR &cdr,
+                                       const S *x,
+                                       ACE_CDR::ULong length);
+
+private:
+  /// True if a structure starting at stream position @a pos has its
+  /// fields where @c layout puts them.
+  static bool aligned (size_t pos);
+
+  /// True if @a cdr writes in the other byte order.
+  static bool swap (const ACE_OutputCDR &cdr);
+
+  /// True if an array is the same in memory as on the wire.
+  static bool array_copyable (void);
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/CDR_Fixed_T.inl"
+#endif /* __ACE_INLINE__ */
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/CDR_Fixed_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("CDR_Fixed_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_CDR_FIXED_T_H */
@@ -0,0 +1,82 @@
+// -*- C++ -*-
+//
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+template <typename S, typename FIELDS> ACE_INLINE bool
+ACE_CDR_Fixed<S, FIELDS>::aligned (size_t pos)
+{
+  return self_aligned || pos % alignment == 0;
+}
+
+template <typename S, typename FIELDS> ACE_INLINE bool
+ACE_CDR_Fixed<S, FIELDS>::swap (const ACE_OutputCDR &cdr)
+{
+  // Like ACE_OutputCDR::write_2() and friends.
+#if defined (ACE_ENABLE_SWAP_ON_WRITE)
+  return cdr.do_byte_swap ();
+#else
+  ACE_UNUSED_ARG (cdr);
+  return false;
+#endif /* ACE_ENABLE_SWAP_ON_WRITE */
+}
+
+template <typename S, typename FIELDS> ACE_INLINE bool
+ACE_CDR_Fixed<S, FIELDS>::array_copyable (void)
+{
+  return native_layout && sizeof (S) == static_cast<size_t> (stride);
+}
+
+template <typename S, typename FIELDS> ACE_INLINE ACE_CDR::Boolean
+ACE_CDR_Fixed<S, FIELDS>::write (ACE_OutputCDR &cdr, const S &x)
+{
+  bool const swap = ACE_CDR_Fixed<S, FIELDS>::swap (cdr);
+  char const *const src = reinterpret_cast<char const *> (&x);
+
+  if (!ACE_CDR_Fixed<S, FIELDS>::aligned (cdr.current_alignment ()))
+    return layout::pack_each (cdr, src, swap) == 0;
+
+  char *buf = 0;
+  if (cdr.adjust (wire_size, alignment, buf) != 0)
+    return false;
+
+  if (native_layout && !swap)
+    ACE_OS::memcpy (buf, src, wire_size);
+  else
+    layout::pack (src, buf, swap);
+  return true;
+}
+
+template <typename S, typename FIELDS> ACE_INLINE ACE_CDR::Boolean
+ACE_CDR_Fixed<S, FIELDS>::read (ACE_InputCDR &cdr, S &x)
+{
+  bool const swap = cdr.do_byte_swap ();
+  char *const dst = reinterpret_cast<char *> (&x);
+
+  if (!ACE_CDR_Fixed<S, FIELDS>::aligned (
+         reinterpret_cast<size_t> (cdr.rd_ptr ())))
+    return layout::unpack_each (cdr, dst, swap) == 0;
+
+  char *buf = 0;
+  if (cdr.adjust (wire_size, alignment, buf) != 0)
+    return false;
+
+  if (native_layout && !swap)
+    ACE_OS::memcpy (dst, buf, wire_size);
+  else
+    layout::unpack (buf, dst, swap);
+  return true;
+}
+
+template <typename S, typename FIELDS> ACE_INLINE ACE_CDR::Boolean
+ACE_CDR_Fixed<S, FIELDS>::write (ACE_SizeCDR &cdr, const S &)
+{
+  if (ACE_CDR_Fixed<S, FIELDS>::aligned (cdr.total_length ()))
+    cdr.adjust (wire_size, alignment);
+  else
+    layout::size_each (cdr);
+  return cdr.good_bit ();
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -1029,6 +1029,24 @@ ACE_OutputCDR::consolidate (void)
   return 0;
 }
 
+ACE_Message_Block *
+ACE_OutputCDR::duplicate_chain (void) const
+{
+  ACE_Message_Block * const chain = this->start_.duplicate ();
+  if (chain == 0)
+    return 0;
+
+  // Leave out the blocks after current_, which hold no data yet.
+  ACE_Message_Block *last = chain;
+  for (const ACE_Message_Block *i = &this->start_;
+       i != this->current_;
+       i = i->cont ())
+    last = last->cont ();
+  ACE_Message_Block::release (last->cont ());
+  last->cont (0);
+  return chain;
+}
+
 
 ACE_Message_Block*
 ACE_OutputCDR::find (char* loc)
@@ -1070,6 +1088,8 @@ ACE_InputCDR::ACE_InputCDR (const char *buf,
                             ACE_CDR::Octet major_version,
                             ACE_CDR::Octet minor_version)
   : start_ (buf, bufsiz),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (byte_order != ACE_CDR_BYTE_ORDER),
     good_bit_ (true),
     major_version_ (major_version),
@@ -1091,6 +1111,8 @@ ACE_InputCDR::ACE_InputCDR (size_t bufsiz,
                             ACE_CDR::Octet major_version,
                             ACE_CDR::Octet minor_version)
   : start_ (bufsiz),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (byte_order != ACE_CDR_BYTE_ORDER),
     good_bit_ (true),
     major_version_ (major_version),
@@ -1111,6 +1133,8 @@ ACE_InputCDR::ACE_InputCDR (const ACE_Message_Block *data,
                             ACE_CDR::Octet minor_version,
                             ACE_Lock* lock)
   : start_ (0, ACE_Message_Block::MB_DATA, 0, 0, 0, lock),
+    chain_ (0),
+    chain_length_ (0),
     good_bit_ (true),
     major_version_ (major_version),
     minor_version_ (minor_version),
@@ -1132,6 +1156,8 @@ ACE_InputCDR::ACE_InputCDR (ACE_Data_Block *data,
                             ACE_CDR::Octet major_version,
                             ACE_CDR::Octet minor_version)
   : start_ (data, flag),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (byte_order != ACE_CDR_BYTE_ORDER),
     good_bit_ (true),
     major_version_ (major_version),
@@ -1154,6 +1180,8 @@ ACE_InputCDR::ACE_InputCDR (ACE_Data_Block *data,
                             ACE_CDR::Octet major_version,
                             ACE_CDR::Octet minor_version)
   : start_ (data, flag),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (byte_order != ACE_CDR_BYTE_ORDER),
     good_bit_ (true),
     major_version_ (major_version),
@@ -1184,6 +1212,8 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs,
                             ACE_CDR::Long offset)
   : start_ (rhs.start_,
             ACE_CDR::MAX_ALIGNMENT),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (rhs.do_byte_swap_),
     good_bit_ (true),
     major_version_ (rhs.major_version_),
@@ -1203,12 +1233,24 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs,
   const size_t newpos =
     (rhs.start_.rd_ptr() - incoming_start)  + offset;
 
-  if (newpos <= this->start_.space ()
-      && newpos + size <= this->start_.space ())
+  // When reading a chain, the block ends at its write pointer; a
+  // range running into the next blocks is copied out of the chain,
+  // but the blocks already read are gone.
+  const size_t limit = rhs.chain_ == 0
+    ? this->start_.space ()
+    : static_cast<size_t> (rhs.start_.wr_ptr () - incoming_start);
+
+  if (newpos <= limit
+      && newpos + size <= limit)
     {
       this->start_.rd_ptr (newpos);
       this->start_.wr_ptr (newpos + size);
     }
+  else if (rhs.chain_ != 0 && offset >= 0)
+    {
+      if (this->copy_chain (rhs, static_cast<size_t> (offset), size) == -1)
+        this->good_bit_ = false;
+    }
   else
     {
       this->good_bit_ = false;
@@ -1225,6 +1267,8 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs,
                             size_t size)
   : start_ (rhs.start_,
             ACE_CDR::MAX_ALIGNMENT),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (rhs.do_byte_swap_),
     good_bit_ (true),
     major_version_ (rhs.major_version_),
@@ -1244,8 +1288,22 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs,
   const size_t newpos =
     rhs.start_.rd_ptr() - incoming_start;
 
-  if (newpos <= this->start_.space ()
-      && newpos + size <= this->start_.space ())
+  if (rhs.chain_ != 0 && size > rhs.start_.length ())
+    {
+      // The encapsulation runs into the next blocks of the chain.
+      if (this->copy_chain (rhs, 0, size) == 0)
+        {
+          ACE_CDR::Octet byte_order = 0;
+          (void) this->read_octet (byte_order);
+          this->do_byte_swap_ = (byte_order != ACE_CDR_BYTE_ORDER);
+        }
+      else
+        {
+          this->good_bit_ = false;
+        }
+    }
+  else if (newpos <= this->start_.space ()
+           && newpos + size <= this->start_.space ())
     {
       // Notice that ACE_Message_Block::duplicate may leave the
       // wr_ptr() with a higher value than what we actually want.
@@ -1271,6 +1329,8 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs,
 ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs)
   : start_ (rhs.start_,
             ACE_CDR::MAX_ALIGNMENT),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (rhs.do_byte_swap_),
     good_bit_ (true),
     major_version_ (rhs.major_version_),
@@ -1290,6 +1350,15 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs)
   this->start_.rd_ptr (rd_offset);
   this->start_.wr_ptr (wr_offset);
 
+  if (rhs.chain_ != 0)
+    {
+      this->chain_ = rhs.chain_->duplicate ();
+      if (this->chain_ != 0)
+        this->chain_length_ = rhs.chain_length_;
+      else
+        this->good_bit_ = false;
+    }
+
 #if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
   ACE_NEW (this->monitor_,
            ACE::Monitor_Control::Size_Monitor);
@@ -1299,6 +1368,8 @@ ACE_InputCDR::ACE_InputCDR (const ACE_InputCDR& rhs)
 
 ACE_InputCDR::ACE_InputCDR (ACE_InputCDR::Transfer_Contents x)
   : start_ (x.rhs_.start_.data_block ()),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (x.rhs_.do_byte_swap_),
     good_bit_ (true),
     major_version_ (x.rhs_.major_version_),
@@ -1312,6 +1383,11 @@ ACE_InputCDR::ACE_InputCDR (ACE_InputCDR::Transfer_Contents x)
   ACE_Data_Block* db = this->start_.data_block ()->clone_nocopy ();
   (void) x.rhs_.start_.replace_data_block (db);
 
+  this->chain_ = x.rhs_.chain_;
+  this->chain_length_ = x.rhs_.chain_length_;
+  x.rhs_.chain_ = 0;
+  x.rhs_.chain_length_ = 0;
+
 #if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
   ACE_NEW (this->monitor_,
            ACE::Monitor_Control::Size_Monitor);
@@ -1319,6 +1395,30 @@ ACE_InputCDR::ACE_InputCDR (ACE_InputCDR::Transfer_Contents x)
 #endif /* ACE_HAS_MONITOR_POINTS==1 */
 }
 
+ACE_InputCDR::ACE_InputCDR (ACE_InputCDR::Chain data,
+                            int byte_order,
+                            ACE_CDR::Octet major_version,
+                            ACE_CDR::Octet minor_version)
+  : start_ (0, ACE_Message_Block::MB_DATA, 0, 0, 0, 0),
+    chain_ (0),
+    chain_length_ (0),
+    do_byte_swap_ (byte_order != ACE_CDR_BYTE_ORDER),
+    good_bit_ (true),
+    major_version_ (major_version),
+    minor_version_ (minor_version),
+    char_translator_ (0),
+    wchar_translator_ (0)
+{
+  if (data.data_ != 0 && this->reset_chain (data.data_) == -1)
+    this->reset (data.data_, byte_order);
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_NEW (this->monitor_,
+           ACE::Monitor_Control::Size_Monitor);
+  this->monitor_->receive (this->length ());
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+}
+
 ACE_InputCDR&
 ACE_InputCDR::operator= (const ACE_InputCDR& rhs)
 {
@@ -1329,6 +1429,15 @@ ACE_InputCDR::operator= (const ACE_InputCDR& rhs)
       this->start_.wr_ptr (rhs.start_.wr_ptr ());
       this->do_byte_swap_ = rhs.do_byte_swap_;
       this->good_bit_ = true;
+      this->release_chain ();
+      if (rhs.chain_ != 0)
+        {
+          this->chain_ = rhs.chain_->duplicate ();
+          if (this->chain_ != 0)
+            this->chain_length_ = rhs.chain_length_;
+          else
+            this->good_bit_ = false;
+        }
       this->char_translator_ = rhs.char_translator_;
       this->major_version_ = rhs.major_version_;
       this->minor_version_ = rhs.minor_version_;
@@ -1356,6 +1465,8 @@ ACE_InputCDR::ACE_InputCDR (const ACE_OutputCDR& rhs,
             ACE_Time_Value::max_time,
             data_block_allocator,
             message_block_allocator),
+    chain_ (0),
+    chain_length_ (0),
     do_byte_swap_ (rhs.do_byte_swap_),
     good_bit_ (true),
     major_version_ (rhs.major_version_),
@@ -1662,42 +1773,109 @@ ACE_InputCDR::read_array (void* x,
 {
   if (length == 0)
     return true;
+
+  if (this->chain_ != 0)
+    return this->read_array_chain (static_cast<char *> (x),
+                                   size,
+                                   align,
+                                   length);
+
   char* buf = 0;
 
   if (this->adjust (size * length, align, buf) == 0)
-    {
+    return this->copy_array (buf, static_cast<char *> (x), size, length);
+  return false;
+}
+
+ACE_CDR::Boolean
+ACE_InputCDR::copy_array (const char *buf,
+                          char *x,
+                          size_t size,
+                          ACE_CDR::ULong length)
+{
 #if defined (ACE_DISABLE_SWAP_ON_READ)
-      ACE_OS::memcpy (x, buf, size*length);
+  ACE_OS::memcpy (x, buf, size*length);
 #else
-      if (!this->do_byte_swap_ || size == 1)
-        ACE_OS::memcpy (x, buf, size*length);
-      else
+  if (!this->do_byte_swap_ || size == 1)
+    ACE_OS::memcpy (x, buf, size*length);
+  else
+    {
+      switch (size)
         {
-          char *target = reinterpret_cast<char*> (x);
-          switch (size)
-            {
-            case 2:
-              ACE_CDR::swap_2_array (buf, target, length);
-              break;
-            case 4:
-              ACE_CDR::swap_4_array (buf, target, length);
-              break;
-            case 8:
-              ACE_CDR::swap_8_array (buf, target, length);
-              break;
-            case 16:
-              ACE_CDR::swap_16_array (buf, target, length);
-              break;
-            default:
-              // TODO: print something?
-              this->good_bit_ = false;
-              return false;
-            }
+        case 2:
+          ACE_CDR::swap_2_array (buf, x, length);
+          break;
+        case 4:
+          ACE_CDR::swap_4_array (buf, x, length);
+          break;
+        case 8:
+          ACE_CDR::swap_8_array (buf, x, length);
+          break;
+        case 16:
+          ACE_CDR::swap_16_array (buf, x, length);
+          break;
+        default:
+          // TODO: print something?
+          this->good_bit_ = false;
+          return false;
         }
+    }
 #endif /* ACE_DISABLE_SWAP_ON_READ */
-      return this->good_bit_;
+  return this->good_bit_;
+}
+
+ACE_CDR::Boolean
+ACE_InputCDR::read_array_chain (char *x,
+                                size_t size,
+                                size_t align,
+                                ACE_CDR::ULong length)
+{
+  if (this->align_read_ptr (align) == -1)
+    return false;
+
+  if (length * size > this->length ())
+    {
+      this->good_bit_ = false;
+      return false;
     }
-  return false;
+
+  while (length > 0)
+    {
+      if (this->start_.length () == 0 && !this->next_block ())
+        {
+          this->good_bit_ = false;
+          return false;
+        }
+
+      // The elements that are all in this block.
+      size_t n = this->start_.length () / size;
+      if (n > length)
+        n = length;
+
+      if (n > 0)
+        {
+          if (!this->copy_array (this->rd_ptr (),
+                                 x,
+                                 size,
+                                 static_cast<ACE_CDR::ULong> (n)))
+            return false;
+          this->start_.rd_ptr (n * size);
+        }
+      else
+        {
+          // This element straddles two blocks.
+          char *buf = 0;
+          n = 1;
+          if (this->adjust_chain (size, 1, buf) == -1
+              || !this->copy_array (buf, x, size, 1))
+            return false;
+        }
+
+      x += n * size;
+      length -= static_cast<ACE_CDR::ULong> (n);
+    }
+
+  return this->good_bit_;
 }
 
 ACE_CDR::Boolean
@@ -1767,7 +1945,7 @@ ACE_InputCDR::read_boolean_array (ACE_CDR::Boolean *x,
 ACE_CDR::Boolean
 ACE_InputCDR::read_1 (ACE_CDR::Octet *x)
 {
-  if (this->rd_ptr () < this->wr_ptr ())
+  if (this->rd_ptr () < this->wr_ptr () || this->next_block ())
     {
       *x = *reinterpret_cast<ACE_CDR::Octet*> (this->rd_ptr ());
       this->start_.rd_ptr (1);
@@ -1879,9 +2057,8 @@ ACE_InputCDR::skip_string (void)
               return true;
             }
         }
-      else if (this->rd_ptr () + len <= this->wr_ptr ())
+      else if (this->skip_bytes (len))
         {
-          this->rd_ptr (len);
           return true;
         }
       this->good_bit_ = false;
@@ -1915,6 +2092,8 @@ ACE_InputCDR::skip_bytes (size_t len)
       this->rd_ptr (len);
       return true;
     }
+  if (this->chain_ != 0)
+    return this->skip_chain (len);
   this->good_bit_ = false;
   return false;
 }
@@ -1922,6 +2101,8 @@ ACE_InputCDR::skip_bytes (size_t len)
 int
 ACE_InputCDR::grow (size_t newsize)
 {
+  this->release_chain ();
+
   if (ACE_CDR::grow (&this->start_, newsize) == -1)
     return -1;
 
@@ -1943,6 +2124,7 @@ ACE_InputCDR::reset (const ACE_Message_Block* data,
                      int byte_order)
 {
   this->reset_byte_order (byte_order);
+  this->release_chain ();
   ACE_CDR::consolidate (&this->start_, data);
 
 #if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
@@ -1954,6 +2136,11 @@ void
 ACE_InputCDR::steal_from (ACE_InputCDR &cdr)
 {
   this->do_byte_swap_ = cdr.do_byte_swap_;
+  this->release_chain ();
+  this->chain_ = cdr.chain_;
+  this->chain_length_ = cdr.chain_length_;
+  cdr.chain_ = 0;
+  cdr.chain_length_ = 0;
   this->start_.data_block (cdr.start_.data_block ()->duplicate ());
 
   // If the message block had a DONT_DELETE flags, just clear it off..
@@ -2030,6 +2217,14 @@ ACE_InputCDR::exchange_data_blocks (ACE_InputCDR &cdr)
       this->start_.wr_ptr (dwr_pos);
     }
 
+  // Exchange the rest of the chains.
+  ACE_Message_Block * const dchain = cdr.chain_;
+  size_t const dchain_length = cdr.chain_length_;
+  cdr.chain_ = this->chain_;
+  cdr.chain_length_ = this->chain_length_;
+  this->chain_ = dchain;
+  this->chain_length_ = dchain_length;
+
   ACE_CDR::Octet const dmajor = cdr.major_version_;
   ACE_CDR::Octet const dminor = cdr.minor_version_;
 
@@ -2048,6 +2243,10 @@ ACE_InputCDR::exchange_data_blocks (ACE_InputCDR &cdr)
 ACE_Data_Block *
 ACE_InputCDR::clone_from (ACE_InputCDR &cdr)
 {
+  if (cdr.consolidate_chain () == -1)
+    return 0;
+  this->release_chain ();
+
   this->do_byte_swap_ = cdr.do_byte_swap_;
 
   // Get the read & write pointer positions in the incoming CDR
@@ -2145,6 +2344,9 @@ ACE_InputCDR::clone_from (ACE_InputCDR &cdr)
 ACE_Message_Block*
 ACE_InputCDR::steal_contents (void)
 {
+  if (this->consolidate_chain () == -1)
+    return 0;
+
   ACE_Message_Block* block = this->start_.clone ();
   this->start_.data_block (block->data_block ()->clone ());
 
@@ -2164,6 +2366,7 @@ ACE_InputCDR::steal_contents (void)
 void
 ACE_InputCDR::reset_contents (void)
 {
+  this->release_chain ();
   this->start_.data_block (this->start_.data_block ()->clone_nocopy ());
 
   // Reset the flags...
@@ -2174,6 +2377,218 @@ ACE_InputCDR::reset_contents (void)
 #endif /* ACE_HAS_MONITOR_POINTS==1 */
 }
 
+int
+ACE_InputCDR::reset_chain (const ACE_Message_Block *data)
+{
+#if !defined (ACE_LACKS_CDR_ALIGNMENT)
+  // Each block must start at the alignment of its position in the
+  // stream.
+  ptrdiff_t const base = reinterpret_cast<ptrdiff_t> (data->rd_ptr ());
+  size_t offset = 0;
+  for (const ACE_Message_Block *i = data; i != 0; i = i->cont ())
+    {
+      if (i->length () != 0
+          && (reinterpret_cast<ptrdiff_t> (i->rd_ptr ()) - base
+              - static_cast<ptrdiff_t> (offset))
+             % ACE_CDR::MAX_ALIGNMENT != 0)
+        return -1;
+      offset += i->length ();
+    }
+#endif /* ACE_LACKS_CDR_ALIGNMENT */
+
+  ACE_Message_Block *chain = 0;
+  if (data->cont () != 0)
+    {
+      chain = data->cont ()->duplicate ();
+      if (chain == 0)
+        return -1;
+    }
+
+  this->release_chain ();
+  this->start_.data_block (data->data_block ()->duplicate ());
+  this->start_.rd_ptr (data->rd_ptr ());
+  this->start_.wr_ptr (data->wr_ptr ());
+  this->chain_ = chain;
+  this->chain_length_ = ACE_CDR::total_length (chain, 0);
+  return 0;
+}
+
+int
+ACE_InputCDR::copy_chain (const ACE_InputCDR &rhs,
+                          size_t skip,
+                          size_t size)
+{
+  ACE_InputCDR tmp (rhs);
+  if (!tmp.skip_bytes (skip) || size > tmp.length ())
+    return -1;
+
+  ACE_Message_Block mb (size + ACE_CDR::MAX_ALIGNMENT);
+  if (mb.size () < size + ACE_CDR::MAX_ALIGNMENT)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+
+  // Keep the alignment the data has in the stream.
+  ACE_CDR::mb_align (&mb);
+  mb.rd_ptr (static_cast<size_t> (reinterpret_cast<ptrdiff_t> (tmp.rd_ptr ())
+                                  % ACE_CDR::MAX_ALIGNMENT));
+  mb.wr_ptr (mb.rd_ptr ());
+  if (!tmp.read_array (mb.wr_ptr (),
+                       ACE_CDR::OCTET_SIZE,
+                       ACE_CDR::OCTET_ALIGN,
+                       static_cast<ACE_CDR::ULong> (size)))
+    return -1;
+  mb.wr_ptr (size);
+
+  this->release_chain ();
+  this->start_.data_block (mb.data_block ()->duplicate ());
+  this->start_.rd_ptr (mb.rd_ptr ());
+  this->start_.wr_ptr (mb.wr_ptr ());
+  return 0;
+}
+
+bool
+ACE_InputCDR::next_block (void)
+{
+  while (this->chain_ != 0)
+    {
+      ACE_Message_Block * const mb = this->chain_;
+      this->chain_ = mb->cont ();
+      this->chain_length_ -= mb->length ();
+      mb->cont (0);
+
+      if (mb->length () != 0)
+        {
+          this->start_.data_block (mb->data_block ()->duplicate ());
+          this->start_.rd_ptr (mb->rd_ptr ());
+          this->start_.wr_ptr (mb->wr_ptr ());
+          mb->release ();
+          return true;
+        }
+      mb->release ();
+    }
+  return false;
+}
+
+int
+ACE_InputCDR::adjust_chain (size_t size,
+                            size_t align,
+                            char *&buf)
+{
+  if (this->align_read_ptr (align) == -1)
+    return -1;
+
+  if (this->start_.length () == 0)
+    (void) this->next_block ();
+
+  if (size <= this->start_.length ())
+    {
+      buf = this->rd_ptr ();
+      this->start_.rd_ptr (size);
+      return 0;
+    }
+
+  if (size > this->length ())
+    {
+      this->good_bit_ = false;
+      return -1;
+    }
+
+  if (size > 2 * ACE_CDR::MAX_ALIGNMENT)
+    {
+      // Too big for <bounce_>: stop reading the chain in place.
+      if (this->consolidate_chain () == -1)
+        {
+          this->good_bit_ = false;
+          return -1;
+        }
+      return this->adjust (size, align, buf);
+    }
+
+  // Put the value together in <bounce_>, at the alignment it has in
+  // the stream.
+  buf = ACE_ptr_align_binary (this->bounce_, ACE_CDR::MAX_ALIGNMENT)
+    + reinterpret_cast<ptrdiff_t> (this->rd_ptr ()) % ACE_CDR::MAX_ALIGNMENT;
+  for (char *dst = buf; size > 0; )
+    {
+      if (this->start_.length () == 0 && !this->next_block ())
+        {
+          this->good_bit_ = false;
+          return -1;
+        }
+      size_t const n = size < this->start_.length ()
+        ? size
+        : this->start_.length ();
+      ACE_OS::memcpy (dst, this->rd_ptr (), n);
+      this->start_.rd_ptr (n);
+      dst += n;
+      size -= n;
+    }
+  return 0;
+}
+
+ACE_CDR::Boolean
+ACE_InputCDR::skip_chain (size_t n)
+{
+  if (n > this->length ())
+    {
+      this->good_bit_ = false;
+      return false;
+    }
+
+  while (n > this->start_.length ())
+    {
+      n -= this->start_.length ();
+      if (!this->next_block ())
+        {
+          this->good_bit_ = false;
+          return false;
+        }
+    }
+  this->start_.rd_ptr (n);
+  return true;
+}
+
+int
+ACE_InputCDR::consolidate_chain (void)
+{
+  if (this->chain_ == 0)
+    return 0;
+
+  size_t const newsize =
+    ACE_CDR::first_size (this->length () + ACE_CDR::MAX_ALIGNMENT);
+  ACE_Message_Block mb (newsize);
+  if (mb.size () < newsize)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+
+  // Keep the alignment of the read pointer.
+  ACE_CDR::mb_align (&mb);
+  mb.rd_ptr (static_cast<size_t> (reinterpret_cast<ptrdiff_t> (this->rd_ptr ())
+                                  % ACE_CDR::MAX_ALIGNMENT));
+  mb.wr_ptr (mb.rd_ptr ());
+  mb.copy (this->rd_ptr (), this->start_.length ());
+  for (const ACE_Message_Block *i = this->chain_; i != 0; i = i->cont ())
+    mb.copy (i->rd_ptr (), i->length ());
+
+  this->release_chain ();
+  this->start_.data_block (mb.data_block ()->duplicate ());
+  this->start_.rd_ptr (mb.rd_ptr ());
+  this->start_.wr_ptr (mb.wr_ptr ());
+  return 0;
+}
+
+void
+ACE_InputCDR::release_chain (void)
+{
+  ACE_Message_Block::release (this->chain_);
+  this->chain_ = 0;
+  this->chain_length_ = 0;
+}
+
 #if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
 
 void
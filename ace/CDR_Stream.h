@@ -410,6 +410,19 @@ public:
    */
   int consolidate (void);
 
+  /**
+   * Return a chain of message blocks sharing the data of the stream,
+   * from begin() to current(), for sending it with a gather write
+   * such as ACE_SOCK_Stream::send_chain(), or reading it with an
+   * ACE_InputCDR made from an ACE_InputCDR::Chain, without copying.
+   * The caller releases the chain.  The data is shared, so the stream
+   * must not be reset, nor its buffer freed, while the chain is in
+   * use; writing more to the stream doesn't change the chain.
+   *
+   * @return 0 if there's no memory for the chain.
+   */
+  ACE_Message_Block *duplicate_chain (void) const;
+
   /**
    * Access the underlying buffer (read only).  @note This
    * method only returns a pointer to the first block in the
@@ -736,6 +749,38 @@ public:
   /// Transfer the contents from <rhs> to a new CDR
   ACE_InputCDR (Transfer_Contents rhs);
 
+  /// Helper class to read a chain of message blocks in place.
+  struct ACE_Export Chain
+  {
+    explicit Chain (const ACE_Message_Block *data);
+
+    const ACE_Message_Block *data_;
+  };
+
+  /**
+   * Create an input stream that reads the chain of message blocks
+   * @a data in place, without consolidating it.  The data blocks of
+   * the chain are shared, by incrementing their reference counts, so
+   * the caller can release the chain immediately upon return.
+   *
+   * Each block must start with the alignment its position in the
+   * stream calls for, as in the chains written by ACE_OutputCDR,
+   * which makes the alignment of the data the same as if the chain
+   * were contiguous.  Other chains are consolidated as by the
+   * ACE_Message_Block constructor.
+   *
+   * Values straddling two blocks are put together in a small buffer
+   * of the stream; arrays are copied out a block at a time.  The
+   * operations that need contiguous data, such as adjust() with more
+   * than 16 bytes, consolidate what's left of the chain the first time
+   * they find it split.  rd_ptr(), wr_ptr() and start() refer to the
+   * block being read, while length() counts the whole chain.
+   */
+  ACE_InputCDR (Chain data,
+                int byte_order = ACE_CDR::BYTE_ORDER_NATIVE,
+                ACE_CDR::Octet major_version = ACE_CDR_GIOP_MAJOR_VERSION,
+                ACE_CDR::Octet minor_version = ACE_CDR_GIOP_MINOR_VERSION);
+
   /// Destructor
   virtual ~ACE_InputCDR (void);
 
@@ -893,8 +938,8 @@ public:
    * @return The start of the message block chain for this CDR
    *         stream.
    *
-   * @note In the current implementation the chain has length 1, but
-   *       we are planning to change that.
+   * @note The chain has length 1.  A stream reading a chain in place
+   *       returns the block being read.
    */
   const ACE_Message_Block* start (void) const;
 
@@ -1011,9 +1056,17 @@ public:
 protected:
 
   /// The start of the chain of message blocks, even though in the
-  /// current version the chain always has length 1.
+  /// current version the chain always has length 1.  When reading a
+  /// chain in place, the block being read.
   ACE_Message_Block start_;
 
+  /// When reading a chain in place, the duplicate of the blocks
+  /// left to read after <start_>; 0 otherwise.
+  ACE_Message_Block *chain_;
+
+  /// Number of bytes in <chain_>.
+  size_t chain_length_;
+
   /// The CDR stream byte order does not match the one on the machine,
   /// swapping is needed while reading.
   bool do_byte_swap_;
@@ -1074,11 +1127,57 @@ private:
   ACE_CDR::Boolean read_wchar_array_i (ACE_CDR::WChar * x,
                                        ACE_CDR::ULong length);
 
+  /// Copy @a length elements of @a size bytes from @a buf to @a x,
+  /// swapping them if needed.
+  ACE_CDR::Boolean copy_array (const char *buf,
+                               char *x,
+                               size_t size,
+                               ACE_CDR::ULong length);
+
+  /// Read a chain in place starting with @a data, if its blocks are
+  /// aligned right.
+  int reset_chain (const ACE_Message_Block *data);
+
+  /// Make this stream a copy of the @a size bytes @a skip bytes past
+  /// the read pointer of @a rhs, which is reading a chain.
+  int copy_chain (const ACE_InputCDR &rhs,
+                  size_t skip,
+                  size_t size);
+
+  /// Move <start_> to the next block of the chain with data.  Returns
+  /// @c false at the end of the chain.
+  bool next_block (void);
+
+  /// adjust() for data not all in <start_>.
+  int adjust_chain (size_t size,
+                    size_t align,
+                    char *&buf);
+
+  /// read_array() for a stream reading a chain.
+  ACE_CDR::Boolean read_array_chain (char *x,
+                                     size_t size,
+                                     size_t align,
+                                     ACE_CDR::ULong length);
+
+  /// Skip @a n bytes of the chain.
+  ACE_CDR::Boolean skip_chain (size_t n);
+
+  /// Copy the rest of the chain into <start_> and stop reading it in
+  /// place.
+  int consolidate_chain (void);
+
+  /// Release the chain, if any.
+  void release_chain (void);
+
   /// Move the rd_ptr ahead by @a offset bytes.
   void rd_ptr (size_t offset);
 
   /// Points to the continuation field of the current message block.
   char* end (void);
+
+  /// Where values straddling two blocks of a chain are put together,
+  /// at the alignment they have in the stream.
+  char bounce_[4 * ACE_CDR::MAX_ALIGNMENT];
 };
 
 // ****************************************************************
@@ -136,6 +136,12 @@ ACE_InputCDR::Transfer_Contents::Transfer_Contents (ACE_InputCDR &rhs)
 {
 }
 
+ACE_INLINE
+ACE_InputCDR::Chain::Chain (const ACE_Message_Block *data)
+  : data_ (data)
+{
+}
+
 // ****************************************************************
 
 ACE_INLINE
@@ -618,6 +624,8 @@ ACE_OutputCDR::wchar_translator (ACE_WChar_Codeset_Translator * wctran)
 ACE_INLINE
 ACE_InputCDR::~ACE_InputCDR (void)
 {
+  this->release_chain ();
+
 #if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
   this->monitor_->remove_ref ();
 #endif /* ACE_HAS_MONITOR_POINTS==1 */
@@ -715,7 +723,7 @@ ACE_InputCDR::read_longdouble (ACE_CDR::LongDouble &x)
 ACE_INLINE size_t
 ACE_InputCDR::length (void) const
 {
-  return this->start_.length ();
+  return this->start_.length () + this->chain_length_;
 }
 
 ACE_INLINE ACE_CDR::Boolean
@@ -1061,11 +1069,11 @@ ACE_InputCDR::adjust (size_t size,
       return 0;
     }
 
+  if (this->chain_ != 0)
+    return this->adjust_chain (size, align, buf);
+
   this->good_bit_ = false;
   return -1;
-#if defined (ACE_LACKS_CDR_ALIGNMENT)
-  ACE_UNUSED_ARG (align);
-#endif /* ACE_LACKS_CDR_ALIGNMENT */
 }
 
 ACE_INLINE int
@@ -1503,6 +1511,11 @@ ACE_InputCDR::align_read_ptr (size_t alignment)
       return 0;
     }
 
+  // The padding runs into the next block of the chain.
+  if (this->chain_ != 0)
+    return
+      this->skip_chain (static_cast<size_t> (buf - this->rd_ptr ())) ? 0 : -1;
+
   this->good_bit_ = false;
   return -1;
 }
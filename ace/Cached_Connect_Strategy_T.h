@@ -43,8 +43,23 @@ ACE_BEGIN_VERSIONED_NAMESPACE_DECL
  * plug-in connection strategy for ACE_Strategy_Connector.
  * It's added value is re-use of established connections and
  * tweaking the role of the cache as per the caching strategy.
+ *
+ * The cache is a CONNECTION_MAP, an ACE_Hash_Map_Manager_Ex by
+ * default, which may be any map with its interface and a
+ * BUCKET_ITERATOR, such as ACE_Concurrent_Hash_Map.  The caching
+ * utility of CACHING_STRATEGY must be instantiated for the same map.
+ * Whatever the map, connections are found and cached under MUTEX,
+ * which also guards the caching attributes and the recycle states,
+ * so with ACE_Concurrent_Hash_Map the strategy still connects and
+ * caches one thread at a time.  It only keeps the map's own locks
+ * from being a second point of contention.
  */
-template <class SVC_HANDLER, ACE_PEER_CONNECTOR_1, class CACHING_STRATEGY, class ATTRIBUTES, class MUTEX>
+template <class SVC_HANDLER, ACE_PEER_CONNECTOR_1, class CACHING_STRATEGY, class ATTRIBUTES, class MUTEX,
+          class CONNECTION_MAP = ACE_Hash_Map_Manager_Ex<ACE_Refcounted_Hash_Recyclable<ACE_PEER_CONNECTOR_ADDR>,
+                                                         std::pair<SVC_HANDLER *, ATTRIBUTES>,
+                                                         ACE_Hash<ACE_Refcounted_Hash_Recyclable<ACE_PEER_CONNECTOR_ADDR> >,
+                                                         ACE_Equal_To<ACE_Refcounted_Hash_Recyclable<ACE_PEER_CONNECTOR_ADDR> >,
+                                                         ACE_Null_Mutex> >
 class ACE_Cached_Connect_Strategy_Ex
  : public ACE_Cached_Connect_Strategy<SVC_HANDLER, ACE_PEER_CONNECTOR_2, MUTEX>
 {
@@ -83,7 +98,8 @@ public:
                                     ACE_Hash<REFCOUNTED_HASH_RECYCLABLE_ADDRESS>,
                                     ACE_Equal_To<REFCOUNTED_HASH_RECYCLABLE_ADDRESS>,
                                     CACHING_STRATEGY,
-                                    ATTRIBUTES>
+                                    ATTRIBUTES,
+                                    CONNECTION_MAP>
           CONNECTION_CACHE;
   typedef typename CONNECTION_CACHE::CACHE_ENTRY CONNECTION_CACHE_ENTRY;
   typedef typename CONNECTION_CACHE::key_type KEY;
@@ -201,12 +217,17 @@ protected:
  */
 template <class SVC_HANDLER, ACE_PEER_CONNECTOR_1,
           class CACHING_STRATEGY, class ATTRIBUTES,
-          class MUTEX>
+          class MUTEX,
+          class CONNECTION_MAP = ACE_Hash_Map_Manager_Ex<ACE_Refcounted_Hash_Recyclable<ACE_PEER_CONNECTOR_ADDR>,
+                                                         std::pair<SVC_HANDLER *, ATTRIBUTES>,
+                                                         ACE_Hash<ACE_Refcounted_Hash_Recyclable<ACE_PEER_CONNECTOR_ADDR> >,
+                                                         ACE_Equal_To<ACE_Refcounted_Hash_Recyclable<ACE_PEER_CONNECTOR_ADDR> >,
+                                                         ACE_Null_Mutex> >
 class ACE_Bounded_Cached_Connect_Strategy
-  : public ACE_Cached_Connect_Strategy_Ex<SVC_HANDLER, ACE_PEER_CONNECTOR_2, CACHING_STRATEGY, ATTRIBUTES, MUTEX>
+  : public ACE_Cached_Connect_Strategy_Ex<SVC_HANDLER, ACE_PEER_CONNECTOR_2, CACHING_STRATEGY, ATTRIBUTES, MUTEX, CONNECTION_MAP>
 {
 
-   typedef ACE_Cached_Connect_Strategy_Ex<SVC_HANDLER, ACE_PEER_CONNECTOR_2, CACHING_STRATEGY, ATTRIBUTES, MUTEX>
+   typedef ACE_Cached_Connect_Strategy_Ex<SVC_HANDLER, ACE_PEER_CONNECTOR_2, CACHING_STRATEGY, ATTRIBUTES, MUTEX, CONNECTION_MAP>
    CCSEBASE;
 
   // = Typedefs for managing the map
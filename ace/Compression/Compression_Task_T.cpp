@@ -0,0 +1,345 @@
+// $Id$
+
+#ifndef ACE_COMPRESSION_TASK_T_CPP
+#define ACE_COMPRESSION_TASK_T_CPP
+
+#include "ace/Compression/Compression_Task_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Log_Category.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Compression_Task)
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::ACE_Compression_Task (size_t threads)
+  : threads_ (threads),
+#if defined (ACE_HAS_THREADS)
+    passed_on_ (lock_, cond_attr_),
+#else
+    passed_on_ (lock_),
+#endif
+    next_taken_ (0),
+    next_passed_on_ (0),
+    started_ (0),
+    running_ (0),
+    stop_ (0)
+{
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::ACE_Compression_Task");
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Compression_Task (void)
+{
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Compression_Task");
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::threads (void) const
+{
+  return this->threads_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::dump");
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("threads_ = %B\n"), this->threads_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("running_ = %B\n"), this->running_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("next_taken_ = %Q\n"), this->next_taken_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::open (void *)
+{
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::open");
+
+  if (this->threads_ == 0)
+    return 0;
+
+  {
+    ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+    this->started_ = 0;
+    this->running_ = this->threads_;
+  }
+
+  return this->activate (THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED,
+                         static_cast<int> (this->threads_));
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::close (u_long flags)
+{
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::close");
+
+  // Only stop the workers when the module closes, not each time one
+  // of them exits.
+  if (flags == 0 || this->thr_count () == 0)
+    return 0;
+
+  // The workers pass on what is queued before they get to stop_.
+  ACE_NEW_RETURN (this->stop_,
+                  ACE_Message_Block (0, ACE_Message_Block::MB_STOP),
+                  -1);
+  if (this->putq (this->stop_) == -1)
+    {
+      this->stop_->release ();
+      this->stop_ = 0;
+      return -1;
+    }
+
+  return this->wait ();
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::put (ACE_Message_Block *msg,
+                                                       ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::put");
+
+  if (this->thr_count () > 0)
+    return this->putq (msg, timeout);
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->put_lock_, -1);
+
+  ACE_Message_Block *out = 0;
+  if (this->transform_i (msg, out, 0) == -1)
+    return -1;
+
+  return out == 0 ? 0 : this->put_next (out, timeout);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::transform_i (ACE_Message_Block *msg,
+                                                               ACE_Message_Block *&out,
+                                                               size_t worker)
+{
+  if (!msg->is_data_msg ())
+    {
+      out = msg;
+      return 0;
+    }
+
+  int const result = this->transform (msg, out, worker);
+  if (result == -1 && out != 0)
+    {
+      out->release ();
+      out = 0;
+    }
+  else if (out != 0)
+    out->msg_priority (msg->msg_priority ());
+
+  msg->release ();
+  return result;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::svc (void)
+{
+  ACE_TRACE ("ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>::svc");
+
+  size_t worker = 0;
+  {
+    ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+    worker = this->started_++;
+  }
+
+  for (;;)
+    {
+      ACE_Message_Block *msg = 0;
+      ACE_UINT64 number = 0;
+
+      // Number the messages in the order of the queue.
+      {
+        ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->dequeue_lock_, -1);
+
+        if (this->getq (msg) == -1)
+          return -1;
+
+        if (msg == this->stop_)
+          {
+            // Leave stop_ to the other workers, the last one releases it.
+            ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+            if (--this->running_ > 0)
+              this->ungetq (msg);
+            else
+              {
+                msg->release ();
+                this->stop_ = 0;
+              }
+            return 0;
+          }
+
+        number = this->next_taken_++;
+      }
+
+      ACE_Message_Block *out = 0;
+      if (this->transform_i (msg, out, worker) == -1)
+        ACELIB_ERROR ((LM_ERROR,
+                       ACE_TEXT ("(%t) %p\n"),
+                       ACE_TEXT ("ACE_Compression_Task::transform")));
+
+      // Pass on the messages in the order they were taken.  Only the
+      // worker whose turn it is gets past the wait, so the message is
+      // passed on without the lock.
+      {
+        ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+        while (this->next_passed_on_ != number)
+          this->passed_on_.wait ();
+      }
+
+      if (out != 0 && this->put_next (out) == -1)
+        ACELIB_ERROR ((LM_ERROR,
+                       ACE_TEXT ("(%t) %p\n"),
+                       ACE_TEXT ("ACE_Compression_Task::put_next")));
+
+      ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+      ++this->next_passed_on_;
+      this->passed_on_.broadcast ();
+    }
+}
+
+// ------------------------------------------------------------
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Compress_Task)
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::ACE_Compress_Task (ACE_Compressor &compressor,
+                                                                  size_t threads,
+                                                                  size_t block_size)
+  : ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY> (threads),
+    compressors_ (0),
+    count_ (threads == 0 ? 1 : threads)
+{
+  ACE_TRACE ("ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::ACE_Compress_Task");
+
+  ACE_NEW (this->compressors_, ACE_Streaming_Compressor *[this->count_]);
+  for (size_t i = 0; i < this->count_; ++i)
+    ACE_NEW (this->compressors_[i],
+             ACE_Streaming_Compressor (compressor, block_size));
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Compress_Task (void)
+{
+  ACE_TRACE ("ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Compress_Task");
+
+  if (this->compressors_ != 0)
+    for (size_t i = 0; i < this->count_; ++i)
+      delete this->compressors_[i];
+  delete [] this->compressors_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::min_size (size_t min_size)
+{
+  for (size_t i = 0; i < this->count_; ++i)
+    this->compressors_[i]->min_size (min_size);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::bypass_ratio (float ratio)
+{
+  for (size_t i = 0; i < this->count_; ++i)
+    this->compressors_[i]->bypass_ratio (ratio);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> ACE_Streaming_Compressor &
+ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::streaming_compressor (size_t worker)
+{
+  return *this->compressors_[worker];
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY>::transform (ACE_Message_Block *msg,
+                                                          ACE_Message_Block *&out,
+                                                          size_t worker)
+{
+  ACE_Streaming_Compressor &compressor = *this->compressors_[worker];
+
+  if (compressor.compress (msg, out) == -1 || compressor.flush (out) == -1)
+    {
+      compressor.reset ();
+      return -1;
+    }
+
+  return 0;
+}
+
+// ------------------------------------------------------------
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Decompress_Task)
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY>::ACE_Decompress_Task (ACE_Compressor &compressor,
+                                                                      bool threaded,
+                                                                      size_t max_block_size)
+  : ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY> (threaded ? 1 : 0),
+    decompressor_ (compressor, max_block_size)
+{
+  ACE_TRACE ("ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY>::ACE_Decompress_Task");
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Decompress_Task (void)
+{
+  ACE_TRACE ("ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Decompress_Task");
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> ACE_Streaming_Decompressor &
+ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY>::streaming_decompressor (void)
+{
+  return this->decompressor_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY>::transform (ACE_Message_Block *msg,
+                                                            ACE_Message_Block *&out,
+                                                            size_t)
+{
+  return this->decompressor_.decompress (msg, out);
+}
+
+// ------------------------------------------------------------
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Compression_Module)
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Compression_Module<ACE_SYNCH_USE, TIME_POLICY>::ACE_Compression_Module (const ACE_TCHAR *module_name,
+                                                                            ACE_Compressor &compressor,
+                                                                            size_t threads,
+                                                                            size_t block_size)
+{
+  ACE_TRACE ("ACE_Compression_Module<ACE_SYNCH_USE, TIME_POLICY>::ACE_Compression_Module");
+
+  typedef ACE_Compress_Task<ACE_SYNCH_USE, TIME_POLICY> WRITER;
+  typedef ACE_Decompress_Task<ACE_SYNCH_USE, TIME_POLICY> READER;
+
+  ACE_Task<ACE_SYNCH_USE, TIME_POLICY> *writer = 0;
+  ACE_Task<ACE_SYNCH_USE, TIME_POLICY> *reader = 0;
+
+  ACE_NEW (writer, WRITER (compressor, threads, block_size));
+  ACE_NEW_NORETURN (reader, READER (compressor, threads > 0));
+  if (reader == 0)
+    {
+      delete writer;
+      return;
+    }
+
+  if (this->open (module_name, writer, reader, 0, ACE_Module_Base::M_DELETE) == -1)
+    ACELIB_ERROR ((LM_ERROR,
+                   ACE_TEXT ("%p\n"),
+                   ACE_TEXT ("ACE_Compression_Module")));
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_COMPRESSION_TASK_T_CPP */
@@ -0,0 +1,254 @@
+// -*- C++ -*-
+//=============================================================================
+/**
+ *  @file   Compression_Task_T.h
+ *
+ *  $Id$
+ *
+ *  ACE_Task and ACE_Module building blocks that compress and
+ *  decompress the messages flowing through an ACE_Stream with an
+ *  ACE_Compressor.
+ */
+//=============================================================================
+
+#ifndef ACE_COMPRESSION_TASK_T_H
+#define ACE_COMPRESSION_TASK_T_H
+
+#include /**/ "ace/pre.h"
+
+#include "ace/Task_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Module.h"
+#include "ace/Compression/Streaming_Compressor.h"
+
+#if defined (ACE_HAS_THREADS)
+# include "ace/Condition_Attributes.h"
+#endif
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Compression_Task
+ *
+ * @brief Base of the tasks that transform the data messages put to
+ *        them and pass them on to the next task in order.
+ *
+ * Messages that are not data messages, see
+ * ACE_Message_Block::is_data_msg(), are passed on as they are.
+ *
+ * Given no threads, a message is transformed in put() by the thread
+ * that puts it; threads putting at the same time take turns, as they
+ * share the state of the transformation.  Given threads, open()
+ * spawns that many workers, put() only queues the message, and the
+ * workers transform the messages in parallel, so that a reactor
+ * thread putting messages to the stream does not wait for them.  Each
+ * message is passed on once it and all the messages queued before it
+ * are, so the order of the messages is kept, and a next task that
+ * blocks in put() holds up the workers with later messages until it
+ * returns.  close(1), which ACE_Module::close() calls, passes on what
+ * is queued before it stops the workers.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Compression_Task : public ACE_Task<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  /// Destruction
+  virtual ~ACE_Compression_Task (void);
+
+  // = ACE_Task hooks
+  virtual int open (void *args = 0);
+  virtual int close (u_long flags = 0);
+  virtual int put (ACE_Message_Block *msg, ACE_Time_Value *timeout = 0);
+  virtual int svc (void);
+
+  /// Number of workers, 0 if messages are transformed in put().
+  size_t threads (void) const;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  /// Transform messages with @a threads workers.
+  ACE_Compression_Task (size_t threads);
+
+  /**
+   * Transform the data message @a msg, which the caller releases,
+   * into the message @a out passes on, or none if @a out is left 0.
+   * @a worker, below threads() or 0 without threads, tells which
+   * worker calls, so that each worker may have its own state.
+   * Returns 0 on success or -1 on failure.
+   */
+  virtual int transform (ACE_Message_Block *msg,
+                         ACE_Message_Block *&out,
+                         size_t worker) = 0;
+
+private:
+  /// Transform @a msg in @a worker if it is a data message and pass
+  /// it on.
+  int transform_i (ACE_Message_Block *msg,
+                   ACE_Message_Block *&out,
+                   size_t worker);
+
+  size_t const threads_;
+
+  /// Serializes put() without workers, so that the messages are
+  /// passed on in the order they are transformed.
+  ACE_SYNCH_MUTEX_T put_lock_;
+
+  /// Serializes taking a message from the queue and numbering it.
+  ACE_SYNCH_MUTEX_T dequeue_lock_;
+
+  /// Protects the fields below.  Not held while a message is passed
+  /// on, so that a next task that blocks only holds up the workers
+  /// waiting for their turn.
+  ACE_SYNCH_MUTEX_T lock_;
+
+#if defined (ACE_HAS_THREADS)
+  /// Attributes to initialize the condition with.
+  ACE_Condition_Attributes_T<TIME_POLICY> cond_attr_;
+#endif
+
+  /// Signaled each time a message is passed on.
+  ACE_SYNCH_CONDITION_T passed_on_;
+
+  /// Number of the next message taken from the queue and of the next
+  /// message to pass on.
+  ACE_UINT64 next_taken_;
+  ACE_UINT64 next_passed_on_;
+
+  /// Workers started and running.
+  size_t started_;
+  size_t running_;
+
+  /// Put to the queue by close() to stop the workers.
+  ACE_Message_Block *stop_;
+};
+
+/**
+ * @class ACE_Compress_Task
+ *
+ * @brief Compresses the data messages put to it with an
+ *        ACE_Streaming_Compressor.
+ *
+ * Each message becomes a message of the frames of its data, so it can
+ * be decompressed as soon as it arrives.  Each worker has its own
+ * ACE_Streaming_Compressor, whose min_size() and bypass_ratio() skip
+ * compressing small messages and data that does not compress.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Compress_Task : public ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  /// Compress blocks of @a block_size bytes with @a compressor and
+  /// @a threads workers.
+  ACE_Compress_Task (ACE_Compressor &compressor,
+                     size_t threads = 0,
+                     size_t block_size = ACE_Streaming_Compressor::DEFAULT_BLOCK_SIZE);
+
+  virtual ~ACE_Compress_Task (void);
+
+  /// Set the min_size() of the streaming compressors.
+  void min_size (size_t min_size);
+
+  /// Set the bypass_ratio() of the streaming compressors.
+  void bypass_ratio (float ratio);
+
+  /// The streaming compressor of @a worker.
+  ACE_Streaming_Compressor &streaming_compressor (size_t worker = 0);
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  virtual int transform (ACE_Message_Block *msg,
+                         ACE_Message_Block *&out,
+                         size_t worker);
+
+private:
+  /// One per worker, or one without threads.
+  ACE_Streaming_Compressor **compressors_;
+  size_t const count_;
+};
+
+/**
+ * @class ACE_Decompress_Task
+ *
+ * @brief Decompresses the frames made by an ACE_Compress_Task with
+ *        an ACE_Streaming_Decompressor.
+ *
+ * The data messages put to it may be cut anywhere, e.g., as read from
+ * a socket; each becomes a message of the data of the frames it
+ * completes.  The frames of a stream must be decompressed in order,
+ * so it has one worker at most.  Once a frame is not valid every data
+ * message put to it fails.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Decompress_Task : public ACE_Compression_Task<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  /// Decompress frames of at most @a max_block_size bytes with
+  /// @a compressor, in a worker thread if @a threaded.
+  ACE_Decompress_Task (ACE_Compressor &compressor,
+                       bool threaded = false,
+                       size_t max_block_size = ACE_Streaming_Compressor::MAX_BLOCK_SIZE);
+
+  virtual ~ACE_Decompress_Task (void);
+
+  /// The streaming decompressor.
+  ACE_Streaming_Decompressor &streaming_decompressor (void);
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  virtual int transform (ACE_Message_Block *msg,
+                         ACE_Message_Block *&out,
+                         size_t worker);
+
+private:
+  ACE_Streaming_Decompressor decompressor_;
+};
+
+/**
+ * @class ACE_Compression_Module
+ *
+ * @brief An ACE_Module that compresses the messages written down an
+ *        ACE_Stream and decompresses those read up from it.
+ *
+ * The writer is an ACE_Compress_Task with the given number of
+ * workers, the reader an ACE_Decompress_Task with a worker if there
+ * are any.  The module deletes both tasks.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Compression_Module : public ACE_Module<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  ACE_Compression_Module (const ACE_TCHAR *module_name,
+                          ACE_Compressor &compressor,
+                          size_t threads = 0,
+                          size_t block_size = ACE_Streaming_Compressor::DEFAULT_BLOCK_SIZE);
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/Compression/Compression_Task_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("Compression_Task_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_COMPRESSION_TASK_T_H */
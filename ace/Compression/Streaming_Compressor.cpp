@@ -0,0 +1,344 @@
+// $Id$
+
+#include "Streaming_Compressor.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/Min_Max.h"
+
+#if !defined (__ACE_INLINE__)
+#include "Streaming_Compressor.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace
+{
+  /// Bit of the payload length of a frame whose data is stored as is.
+  const ACE_UINT32 STORED = 0x80000000U;
+
+  inline void
+  put32 (char *p, ACE_UINT32 value)
+  {
+    p[0] = static_cast<char> (value >> 24);
+    p[1] = static_cast<char> (value >> 16);
+    p[2] = static_cast<char> (value >> 8);
+    p[3] = static_cast<char> (value);
+  }
+
+  inline ACE_UINT32
+  get32 (const char *p)
+  {
+    const ACE_Byte *b = reinterpret_cast<const ACE_Byte *> (p);
+    return (static_cast<ACE_UINT32> (b[0]) << 24)
+      | (static_cast<ACE_UINT32> (b[1]) << 16)
+      | (static_cast<ACE_UINT32> (b[2]) << 8)
+      | static_cast<ACE_UINT32> (b[3]);
+  }
+
+  inline ACE_Message_Block *
+  chain_tail (ACE_Message_Block *mb)
+  {
+    if (mb != 0)
+      while (mb->cont () != 0)
+        mb = mb->cont ();
+    return mb;
+  }
+
+  inline void
+  append (ACE_Message_Block *mb,
+          ACE_Message_Block *&out,
+          ACE_Message_Block *&tail)
+  {
+    if (tail == 0)
+      out = mb;
+    else
+      tail->cont (mb);
+    tail = mb;
+  }
+}
+
+ACE_Streaming_Compressor::ACE_Streaming_Compressor (ACE_Compressor &compressor,
+                                                    size_t block_size)
+  : compressor_ (compressor),
+    block_size_ (block_size == 0
+                 ? static_cast<size_t> (DEFAULT_BLOCK_SIZE)
+                 : ace_min (block_size, static_cast<size_t> (MAX_BLOCK_SIZE))),
+    min_size_ (DEFAULT_MIN_SIZE),
+    bypass_ratio_ (0.95f),
+    compression_ratio_ (0.0f),
+    bypass_ (0),
+    next_bypass_ (1),
+    buffer_ (block_size_),
+    scratch_ (FRAME_HEADER_SIZE + block_size_)
+{
+}
+
+ACE_Streaming_Compressor::~ACE_Streaming_Compressor (void)
+{
+}
+
+int
+ACE_Streaming_Compressor::compress (const ACE_Message_Block *in,
+                                    ACE_Message_Block *&out)
+{
+  ACE_Message_Block *tail = chain_tail (out);
+
+  for (const ACE_Message_Block *mb = in; mb != 0; mb = mb->cont ())
+    {
+      const char *data = mb->rd_ptr ();
+      size_t len = mb->length ();
+
+      // Complete the buffered block first.
+      if (this->buffer_.length () > 0)
+        {
+          size_t const n = ace_min (len, this->buffer_.space ());
+          this->buffer_.copy (data, n);
+          data += n;
+          len -= n;
+          if (this->buffer_.space () > 0)
+            continue;
+
+          if (this->frame (this->buffer_.rd_ptr (),
+                           this->buffer_.length (),
+                           out,
+                           tail) == -1)
+            return -1;
+          this->buffer_.reset ();
+        }
+
+      // Whole blocks are compressed where they are.
+      for (; len >= this->block_size_; len -= this->block_size_)
+        {
+          if (this->frame (data, this->block_size_, out, tail) == -1)
+            return -1;
+          data += this->block_size_;
+        }
+
+      if (len > 0)
+        this->buffer_.copy (data, len);
+    }
+
+  return 0;
+}
+
+int
+ACE_Streaming_Compressor::flush (ACE_Message_Block *&out)
+{
+  if (this->buffer_.length () == 0)
+    return 0;
+
+  ACE_Message_Block *tail = chain_tail (out);
+  if (this->frame (this->buffer_.rd_ptr (),
+                   this->buffer_.length (),
+                   out,
+                   tail) == -1)
+    return -1;
+
+  this->buffer_.reset ();
+  return 0;
+}
+
+int
+ACE_Streaming_Compressor::frame (const char *data,
+                                 size_t len,
+                                 ACE_Message_Block *&out,
+                                 ACE_Message_Block *&tail)
+{
+  char *const header = this->scratch_.base ();
+  ACE_UINT64 compressed = ACE_UINT64 (-1);
+
+  if (len < 2 || len < this->min_size_)
+    ;
+  else if (this->bypass_ > 0)
+    --this->bypass_;
+  else
+    {
+      // Compressing is only worth it if it saves a byte.
+      compressed = this->compressor_.compress (data,
+                                               len,
+                                               header + FRAME_HEADER_SIZE,
+                                               len - 1);
+
+      float const ratio =
+        compressed == ACE_UINT64 (-1) || compressed == 0
+        ? 1.0f
+        : static_cast<float> (compressed) / len;
+      this->compression_ratio_ = (3 * this->compression_ratio_ + ratio) / 4;
+
+      if (this->compression_ratio_ > this->bypass_ratio_)
+        {
+          this->bypass_ = this->next_bypass_;
+          this->next_bypass_ =
+            ace_min (2 * this->next_bypass_,
+                     static_cast<size_t> (MAX_BYPASS_BLOCKS));
+        }
+      else
+        this->next_bypass_ = 1;
+    }
+
+  ACE_Message_Block *mb = 0;
+
+  if (compressed == ACE_UINT64 (-1) || compressed == 0)
+    {
+      ACE_NEW_RETURN (mb, ACE_Message_Block (FRAME_HEADER_SIZE + len), -1);
+      put32 (mb->wr_ptr (), static_cast<ACE_UINT32> (len));
+      put32 (mb->wr_ptr () + 4, static_cast<ACE_UINT32> (len) | STORED);
+      ACE_OS::memcpy (mb->wr_ptr () + FRAME_HEADER_SIZE, data, len);
+      mb->wr_ptr (FRAME_HEADER_SIZE + len);
+    }
+  else
+    {
+      size_t const frame_len = FRAME_HEADER_SIZE + static_cast<size_t> (compressed);
+      put32 (header, static_cast<ACE_UINT32> (len));
+      put32 (header + 4, static_cast<ACE_UINT32> (compressed));
+      ACE_NEW_RETURN (mb, ACE_Message_Block (frame_len), -1);
+      mb->copy (header, frame_len);
+    }
+
+  append (mb, out, tail);
+  return 0;
+}
+
+// ------------------------------------------------------------
+
+ACE_Streaming_Decompressor::ACE_Streaming_Decompressor (ACE_Compressor &compressor,
+                                                        size_t max_block_size)
+  : compressor_ (compressor),
+    max_block_size_ (max_block_size),
+    header_length_ (0),
+    data_length_ (0),
+    payload_length_ (0),
+    stored_ (false),
+    failed_ (false)
+{
+}
+
+ACE_Streaming_Decompressor::~ACE_Streaming_Decompressor (void)
+{
+}
+
+int
+ACE_Streaming_Decompressor::decompress (const ACE_Message_Block *in,
+                                        ACE_Message_Block *&out)
+{
+  if (this->failed_)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_Message_Block *tail = chain_tail (out);
+
+  for (const ACE_Message_Block *mb = in; mb != 0; mb = mb->cont ())
+    {
+      const char *data = mb->rd_ptr ();
+      size_t len = mb->length ();
+
+      while (len > 0)
+        {
+          if (this->header_length_ < ACE_Streaming_Compressor::FRAME_HEADER_SIZE)
+            {
+              size_t const n =
+                ace_min (len,
+                         ACE_Streaming_Compressor::FRAME_HEADER_SIZE
+                         - this->header_length_);
+              ACE_OS::memcpy (this->header_ + this->header_length_, data, n);
+              this->header_length_ += n;
+              data += n;
+              len -= n;
+
+              if (this->header_length_ == ACE_Streaming_Compressor::FRAME_HEADER_SIZE
+                  && this->parse_header () == -1)
+                {
+                  this->failed_ = true;
+                  return -1;
+                }
+              continue;
+            }
+
+          if (this->payload_.length () == 0 && len >= this->payload_length_)
+            {
+              // The whole payload is here: decode it where it is.
+              if (this->decode (data, out, tail) == -1)
+                return -1;
+              data += this->payload_length_;
+              len -= this->payload_length_;
+            }
+          else
+            {
+              if (this->payload_.size () < this->payload_length_
+                  && this->payload_.size (this->payload_length_) == -1)
+                return -1;
+
+              size_t const n =
+                ace_min (len, this->payload_length_ - this->payload_.length ());
+              this->payload_.copy (data, n);
+              data += n;
+              len -= n;
+              if (this->payload_.length () < this->payload_length_)
+                continue;
+
+              if (this->decode (this->payload_.rd_ptr (), out, tail) == -1)
+                return -1;
+              this->payload_.reset ();
+            }
+
+          this->header_length_ = 0;
+        }
+    }
+
+  return 0;
+}
+
+int
+ACE_Streaming_Decompressor::parse_header (void)
+{
+  ACE_UINT32 const payload = get32 (this->header_ + 4);
+
+  this->data_length_ = get32 (this->header_);
+  this->payload_length_ = payload & ~STORED;
+  this->stored_ = (payload & STORED) != 0;
+
+  // A stored payload is the data, a compressed one is shorter.
+  if (this->data_length_ == 0
+      || this->data_length_ > this->max_block_size_
+      || this->payload_length_ == 0
+      || (this->stored_
+          ? this->payload_length_ != this->data_length_
+          : this->payload_length_ >= this->data_length_))
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return 0;
+}
+
+int
+ACE_Streaming_Decompressor::decode (const char *payload,
+                                    ACE_Message_Block *&out,
+                                    ACE_Message_Block *&tail)
+{
+  ACE_Message_Block *mb = 0;
+  ACE_NEW_RETURN (mb, ACE_Message_Block (this->data_length_), -1);
+
+  if (this->stored_)
+    ACE_OS::memcpy (mb->wr_ptr (), payload, this->data_length_);
+  else if (this->compressor_.decompress (payload,
+                                         this->payload_length_,
+                                         mb->wr_ptr (),
+                                         this->data_length_)
+           != this->data_length_)
+    {
+      mb->release ();
+      this->failed_ = true;
+      errno = EINVAL;
+      return -1;
+    }
+
+  mb->wr_ptr (this->data_length_);
+  append (mb, out, tail);
+  return 0;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
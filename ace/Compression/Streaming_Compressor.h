@@ -0,0 +1,240 @@
+// -*- C++ -*-
+//=============================================================================
+/**
+ *  @file   Streaming_Compressor.h
+ *
+ *  $Id$
+ *
+ *  Incremental compression of ACE_Message_Block chains with any
+ *  ACE_Compressor.
+ *
+ *  The data is cut into blocks that are compressed one at a time, so
+ *  that a sender needs to stage no more than a block and a receiver
+ *  can decompress each block as soon as it has arrived.  Each block
+ *  becomes a frame of FRAME_HEADER_SIZE bytes, the length of the data
+ *  and the length of the payload as 4 byte unsigned integers in
+ *  network byte order, followed by the payload.  A block that the
+ *  compressor cannot make smaller is stored as is, which the high bit
+ *  of the payload length tells, so that data never grows by more than
+ *  the header of its frames.
+ */
+//=============================================================================
+
+#ifndef ACE_STREAMING_COMPRESSOR_H
+#define ACE_STREAMING_COMPRESSOR_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ACE_Compression_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Compression/Compressor.h"
+#include "ace/Message_Block.h"
+#include "ace/Copy_Disabled.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Streaming_Compressor
+ *
+ * @brief Compresses a stream of ACE_Message_Block chains into frames.
+ *
+ * compress() may be given any amount of data at a time: it buffers
+ * what does not fill a block and appends a frame to its output for
+ * each block that is complete.  flush() makes a frame of what is
+ * buffered, e.g., at the end of a message or before the connection
+ * is idle.  Only the data of the ACE_Message_Block chain is read, the
+ * blocks are neither released nor consumed.
+ *
+ * Compressing is skipped for blocks shorter than min_size(), which
+ * rarely compress, and, while the running compression_ratio() of the
+ * blocks tried is above bypass_ratio(), for a number of blocks that
+ * doubles each time the ratio stays above it, up to MAX_BYPASS_BLOCKS.
+ * This spends little time on data that is already compressed or
+ * encrypted, while the next block that is tried again shows when the
+ * data compresses anew.
+ *
+ * An ACE_Streaming_Compressor is not thread safe, but any number of
+ * them may share an ACE_Compressor that is, such as the singletons of
+ * the compressors of ACE.
+ */
+class ACE_Compression_Export ACE_Streaming_Compressor
+  : private ACE_Copy_Disabled
+{
+public:
+  enum
+  {
+    /// Bytes of the header of a frame.
+    FRAME_HEADER_SIZE = 8,
+
+    /// Bytes compressed at a time by default.
+    DEFAULT_BLOCK_SIZE = 64 * 1024,
+
+    /// Largest number of bytes compressed at a time.
+    MAX_BLOCK_SIZE = 4 * 1024 * 1024,
+
+    /// Blocks shorter than this are not compressed by default.
+    DEFAULT_MIN_SIZE = 64,
+
+    /// Largest number of blocks not compressed in a row once the
+    /// compression ratio is above the bypass ratio.
+    MAX_BYPASS_BLOCKS = 64
+  };
+
+  /// Compress blocks of @a block_size bytes, at most MAX_BLOCK_SIZE,
+  /// with @a compressor.
+  ACE_Streaming_Compressor (ACE_Compressor &compressor,
+                            size_t block_size = DEFAULT_BLOCK_SIZE);
+
+  ~ACE_Streaming_Compressor (void);
+
+  /**
+   * Compress the data of the chain @a in, appending a frame to the
+   * chain @a out, or setting @a out if it is 0, for each block
+   * completed.  The rest of the data is kept for the next call.
+   * Returns 0 on success, -1 on failure, in which case no more than
+   * the frames of the blocks completed before the failure are
+   * appended.
+   */
+  int compress (const ACE_Message_Block *in, ACE_Message_Block *&out);
+
+  /// Append a frame of the data kept by compress() to @a out, if
+  /// there is any.  Returns 0 on success, -1 on failure.
+  int flush (ACE_Message_Block *&out);
+
+  /// Number of bytes kept by compress() for the next frame.
+  size_t pending (void) const;
+
+  /// Discard the data kept by compress().
+  void reset (void);
+
+  /// Number of bytes compressed at a time.
+  size_t block_size (void) const;
+
+  /// The compressor of the blocks.
+  ACE_Compressor &compressor (void) const;
+
+  /// Get/set the length below which blocks are stored as is.
+  size_t min_size (void) const;
+  void min_size (size_t min_size);
+
+  /// Get/set the compression ratio above which blocks are stored as
+  /// is for a while, 0.95 by default.  A ratio of 1 or more never
+  /// skips compressing.
+  float bypass_ratio (void) const;
+  void bypass_ratio (float ratio);
+
+  /// Running ratio of compressed to original bytes of the recent
+  /// blocks that were compressed, weighting the last one by a quarter.
+  float compression_ratio (void) const;
+
+private:
+  /// Append a frame of the @a len bytes at @a data after @a tail,
+  /// which is 0 if the output chain is empty, and make it the tail.
+  int frame (const char *data,
+             size_t len,
+             ACE_Message_Block *&out,
+             ACE_Message_Block *&tail);
+
+  ACE_Compressor &compressor_;
+  size_t const block_size_;
+
+  size_t min_size_;
+  float bypass_ratio_;
+  float compression_ratio_;
+
+  /// Blocks to store as is before compressing is tried again, and
+  /// how many the next bypass will be.
+  size_t bypass_;
+  size_t next_bypass_;
+
+  /// The data that does not fill a block yet.
+  ACE_Message_Block buffer_;
+
+  /// Where a block is compressed before it is copied to a frame of
+  /// its compressed size.
+  ACE_Message_Block scratch_;
+};
+
+/**
+ * @class ACE_Streaming_Decompressor
+ *
+ * @brief Decompresses the frames made by an ACE_Streaming_Compressor.
+ *
+ * decompress() may be given the frames cut anywhere, e.g., as they
+ * are read from a socket: it keeps what is not a complete frame and
+ * appends an ACE_Message_Block of the data of each frame completed
+ * to its output.  A frame of data longer than the largest block size
+ * given to the constructor is refused, so a peer cannot make the
+ * receiver allocate more than that.
+ */
+class ACE_Compression_Export ACE_Streaming_Decompressor
+  : private ACE_Copy_Disabled
+{
+public:
+  /// Decompress frames of at most @a max_block_size bytes with
+  /// @a compressor.
+  ACE_Streaming_Decompressor (
+    ACE_Compressor &compressor,
+    size_t max_block_size = ACE_Streaming_Compressor::MAX_BLOCK_SIZE);
+
+  ~ACE_Streaming_Decompressor (void);
+
+  /**
+   * Decompress the frames in the data of the chain @a in, appending
+   * the data of each frame completed to the chain @a out, or setting
+   * @a out if it is 0.  The rest of the data is kept for the next
+   * call.  Returns 0 on success or -1 if a frame is not valid, after
+   * which the stream cannot be decompressed any further until
+   * reset().
+   */
+  int decompress (const ACE_Message_Block *in, ACE_Message_Block *&out);
+
+  /// Number of bytes of an incomplete frame kept by decompress().
+  size_t pending (void) const;
+
+  /// Discard the incomplete frame kept by decompress().
+  void reset (void);
+
+private:
+  /// Check the header of the next frame.
+  int parse_header (void);
+
+  /// Append the data of the frame whose payload is at @a payload
+  /// after @a tail and make it the tail.
+  int decode (const char *payload,
+              ACE_Message_Block *&out,
+              ACE_Message_Block *&tail);
+
+  ACE_Compressor &compressor_;
+  size_t const max_block_size_;
+
+  /// The header of the next frame and how much of it has arrived.
+  char header_[ACE_Streaming_Compressor::FRAME_HEADER_SIZE];
+  size_t header_length_;
+
+  /// What the header tells.
+  size_t data_length_;
+  size_t payload_length_;
+  bool stored_;
+
+  /// The part of the payload that has arrived, unless the whole
+  /// payload arrives in one ACE_Message_Block.
+  ACE_Message_Block payload_;
+
+  /// Set when a frame was not valid.
+  bool failed_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "Streaming_Compressor.inl"
+#endif /* __ACE_INLINE__ */
+
+#include /**/ "ace/post.h"
+
+#endif // ACE_STREAMING_COMPRESSOR_H
@@ -0,0 +1,74 @@
+// -*- C++ -*-
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE size_t
+ACE_Streaming_Compressor::pending (void) const
+{
+  return this->buffer_.length ();
+}
+
+ACE_INLINE void
+ACE_Streaming_Compressor::reset (void)
+{
+  this->buffer_.reset ();
+}
+
+ACE_INLINE size_t
+ACE_Streaming_Compressor::block_size (void) const
+{
+  return this->block_size_;
+}
+
+ACE_INLINE ACE_Compressor &
+ACE_Streaming_Compressor::compressor (void) const
+{
+  return this->compressor_;
+}
+
+ACE_INLINE size_t
+ACE_Streaming_Compressor::min_size (void) const
+{
+  return this->min_size_;
+}
+
+ACE_INLINE void
+ACE_Streaming_Compressor::min_size (size_t min_size)
+{
+  this->min_size_ = min_size;
+}
+
+ACE_INLINE float
+ACE_Streaming_Compressor::bypass_ratio (void) const
+{
+  return this->bypass_ratio_;
+}
+
+ACE_INLINE void
+ACE_Streaming_Compressor::bypass_ratio (float ratio)
+{
+  this->bypass_ratio_ = ratio;
+}
+
+ACE_INLINE float
+ACE_Streaming_Compressor::compression_ratio (void) const
+{
+  return this->compression_ratio_;
+}
+
+ACE_INLINE size_t
+ACE_Streaming_Decompressor::pending (void) const
+{
+  return this->header_length_ + this->payload_.length ();
+}
+
+ACE_INLINE void
+ACE_Streaming_Decompressor::reset (void)
+{
+  this->header_length_ = 0;
+  this->payload_.reset ();
+  this->failed_ = false;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
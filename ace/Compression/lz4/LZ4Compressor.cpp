@@ -0,0 +1,329 @@
+// $Id$
+
+#include "LZ4Compressor.h"
+#include "ace/OS_NS_string.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace
+{
+  /// Shortest match the format can code.
+  const size_t MIN_MATCH = 4;
+
+  /// Bytes at the end of a block that are always literals.
+  const size_t LAST_LITERALS = 5;
+
+  /// No match starts within this many bytes of the end of a block.
+  const size_t MF_LIMIT = 12;
+
+  /// Farthest a match can be behind the data it codes.
+  const size_t MAX_DISTANCE = 65535;
+
+  /// Entries of the hash table are 1 << HASH_LOG, 16K bytes.
+  const unsigned int HASH_LOG = 12;
+
+  /// Each 1 << SKIP_TRIGGER positions without a match, the search
+  /// steps one byte farther, so data that does not compress is
+  /// skipped over quickly.
+  const unsigned int SKIP_TRIGGER = 6;
+
+  /// Largest block the format allows.
+  const ACE_UINT64 MAX_INPUT_SIZE = 0x7E000000;
+
+  inline ACE_UINT32
+  read32 (const ACE_Byte *p)
+  {
+    ACE_UINT32 v;
+    ACE_OS::memcpy (&v, p, sizeof v);
+    return v;
+  }
+
+  inline ACE_UINT64
+  read64 (const ACE_Byte *p)
+  {
+    ACE_UINT64 v;
+    ACE_OS::memcpy (&v, p, sizeof v);
+    return v;
+  }
+
+  inline ACE_UINT32
+  hash (ACE_UINT32 sequence, unsigned int hash_log)
+  {
+    return (sequence * 2654435761U) >> (32 - hash_log);
+  }
+
+  /// Write the bytes that extend a nibble of 15 to @a len.
+  inline ACE_Byte *
+  put_length (ACE_Byte *op, size_t len)
+  {
+    for (len -= 15; len >= 255; len -= 255)
+      *op++ = 255;
+    *op++ = static_cast<ACE_Byte> (len);
+    return op;
+  }
+
+  /// Add the bytes that extend a nibble of 15 to @a len, or return
+  /// false if the input ends first.
+  inline bool
+  get_length (const ACE_Byte *&ip, const ACE_Byte *iend, size_t &len)
+  {
+    ACE_Byte b;
+    do
+      {
+        if (ip == iend)
+          return false;
+        b = *ip++;
+        len += b;
+      }
+    while (b == 255);
+    return true;
+  }
+
+  /// Bytes to code @a len literals, but the literals themselves.
+  inline size_t
+  literal_overhead (size_t len)
+  {
+    return 1 + (len >= 15 ? (len - 15) / 255 + 1 : 0);
+  }
+}
+
+ACE_LZ4Compressor::ACE_LZ4Compressor (void)
+  : ACE_Compressor (ACE_COMPRESSORID_LZ4)
+{
+}
+
+ACE_LZ4Compressor::~ACE_LZ4Compressor (void)
+{
+}
+
+ACE_UINT64
+ACE_LZ4Compressor::compress_bound (ACE_UINT64 in_len)
+{
+  return in_len + in_len / 255 + 16;
+}
+
+ACE_UINT64
+ACE_LZ4Compressor::compress (const void *in_ptr,
+                             ACE_UINT64 in_len,
+                             void *out_ptr,
+                             ACE_UINT64 max_out_len)
+{
+  const ACE_Byte *const src = static_cast<const ACE_Byte *> (in_ptr);
+  ACE_Byte *const dst = static_cast<ACE_Byte *> (out_ptr);
+
+  if (src == 0 || dst == 0 || in_len == 0)
+    return 0;
+  if (in_len > MAX_INPUT_SIZE)
+    return ACE_UINT64 (-1);
+
+  const ACE_Byte *const iend = src + in_len;
+  const ACE_Byte *anchor = src;
+  ACE_Byte *op = dst;
+  ACE_Byte *const oend = dst + (max_out_len < compress_bound (in_len)
+                                ? max_out_len
+                                : compress_bound (in_len));
+
+  if (in_len > MF_LIMIT)
+    {
+      const ACE_Byte *const mflimit = iend - MF_LIMIT;
+      const ACE_Byte *const matchlimit = iend - LAST_LITERALS;
+
+      // A short input gets a smaller table, which is cheaper to
+      // clear than the data is to compress.
+      unsigned int hash_log = HASH_LOG;
+      while (hash_log > 8 && (ACE_UINT64 (1) << hash_log) > in_len)
+        --hash_log;
+
+      // Positions of the last sequence of each hash from src.  Each
+      // candidate is checked against the data, so a collision only
+      // costs a missed match.
+      ACE_UINT32 table[1 << HASH_LOG];
+      ACE_OS::memset (table, 0, sizeof (ACE_UINT32) << hash_log);
+
+      const ACE_Byte *ip = src + 1;
+
+      for (;;)
+        {
+          // Find the next match.
+          const ACE_Byte *match = 0;
+          unsigned int attempts = 1U << SKIP_TRIGGER;
+          for (;;)
+            {
+              ACE_UINT32 const sequence = read32 (ip);
+              ACE_UINT32 const h = hash (sequence, hash_log);
+              match = src + table[h];
+              table[h] = static_cast<ACE_UINT32> (ip - src);
+              if (static_cast<size_t> (ip - match) <= MAX_DISTANCE
+                  && read32 (match) == sequence)
+                break;
+
+              ip += attempts++ >> SKIP_TRIGGER;
+              if (ip > mflimit)
+                goto last_literals;
+            }
+
+          // Extend it backwards over the pending literals.
+          while (ip > anchor && match > src && ip[-1] == match[-1])
+            {
+              --ip;
+              --match;
+            }
+
+          // Token and literals.
+          size_t const literals = ip - anchor;
+          if (static_cast<size_t> (oend - op)
+              < literal_overhead (literals) + literals + 2)
+            return ACE_UINT64 (-1);
+
+          ACE_Byte *const token = op++;
+          if (literals >= 15)
+            {
+              *token = 15 << 4;
+              op = put_length (op, literals);
+            }
+          else
+            *token = static_cast<ACE_Byte> (literals << 4);
+          ACE_OS::memcpy (op, anchor, literals);
+          op += literals;
+
+          // Offset.
+          size_t const offset = ip - match;
+          *op++ = static_cast<ACE_Byte> (offset);
+          *op++ = static_cast<ACE_Byte> (offset >> 8);
+
+          // Match length, a word at a time while the words are equal.
+          ip += MIN_MATCH;
+          match += MIN_MATCH;
+          const ACE_Byte *const start = ip;
+          while (ip + 8 <= matchlimit && read64 (ip) == read64 (match))
+            {
+              ip += 8;
+              match += 8;
+            }
+          while (ip < matchlimit && *ip == *match)
+            {
+              ++ip;
+              ++match;
+            }
+
+          size_t const length = ip - start;
+          if (length >= 15)
+            {
+              if (static_cast<size_t> (oend - op) < (length - 15) / 255 + 1)
+                return ACE_UINT64 (-1);
+              *token |= 15;
+              op = put_length (op, length);
+            }
+          else
+            *token |= static_cast<ACE_Byte> (length);
+
+          anchor = ip;
+          if (ip > mflimit)
+            break;
+
+          // Index a position within the match, which helps with
+          // data repeated at several distances.
+          table[hash (read32 (ip - 2), hash_log)] =
+            static_cast<ACE_UINT32> (ip - 2 - src);
+        }
+    }
+
+last_literals:
+  size_t const literals = iend - anchor;
+  if (static_cast<size_t> (oend - op) < literal_overhead (literals) + literals)
+    return ACE_UINT64 (-1);
+
+  if (literals >= 15)
+    {
+      *op++ = 15 << 4;
+      op = put_length (op, literals);
+    }
+  else
+    *op++ = static_cast<ACE_Byte> (literals << 4);
+  ACE_OS::memcpy (op, anchor, literals);
+  op += literals;
+
+  ACE_UINT64 const out_len = op - dst;
+  this->update_stats (in_len, out_len);
+  return out_len;
+}
+
+ACE_UINT64
+ACE_LZ4Compressor::decompress (const void *in_ptr,
+                               ACE_UINT64 in_len,
+                               void *out_ptr,
+                               ACE_UINT64 max_out_len)
+{
+  const ACE_Byte *ip = static_cast<const ACE_Byte *> (in_ptr);
+  ACE_Byte *const dst = static_cast<ACE_Byte *> (out_ptr);
+
+  if (ip == 0 || dst == 0 || in_len == 0)
+    return 0;
+
+  const ACE_Byte *const iend = ip + in_len;
+  ACE_Byte *op = dst;
+  ACE_Byte *const oend = dst + max_out_len;
+
+  for (;;)
+    {
+      unsigned int const token = *ip++;
+
+      size_t literals = token >> 4;
+      if (literals == 15 && !get_length (ip, iend, literals))
+        return ACE_UINT64 (-1);
+      if (static_cast<size_t> (iend - ip) < literals
+          || static_cast<size_t> (oend - op) < literals)
+        return ACE_UINT64 (-1);
+      ACE_OS::memcpy (op, ip, literals);
+      ip += literals;
+      op += literals;
+
+      // The last sequence ends the block after its literals.
+      if (ip == iend)
+        break;
+
+      if (iend - ip < 2)
+        return ACE_UINT64 (-1);
+      size_t const offset = ip[0] | (static_cast<size_t> (ip[1]) << 8);
+      ip += 2;
+      if (offset == 0 || offset > static_cast<size_t> (op - dst))
+        return ACE_UINT64 (-1);
+
+      size_t length = token & 15;
+      if (length == 15 && !get_length (ip, iend, length))
+        return ACE_UINT64 (-1);
+      length += MIN_MATCH;
+      if (static_cast<size_t> (oend - op) < length)
+        return ACE_UINT64 (-1);
+
+      // A match may overlap the data it produces, which repeats the
+      // last offset bytes: copy in pieces no longer than the offset.
+      const ACE_Byte *match = op - offset;
+      if (offset >= length)
+        {
+          ACE_OS::memcpy (op, match, length);
+          op += length;
+        }
+      else
+        {
+          if (offset >= 8)
+            for (; length >= 8; length -= 8)
+              {
+                ACE_OS::memcpy (op, match, 8);
+                op += 8;
+                match += 8;
+              }
+          while (length-- > 0)
+            *op++ = *match++;
+        }
+
+      if (ip == iend)
+        return ACE_UINT64 (-1);
+    }
+
+  return op - dst;
+}
+
+ACE_SINGLETON_TEMPLATE_INSTANTIATE(ACE_Singleton, ACE_LZ4Compressor, ACE_SYNCH_MUTEX);
+
+ACE_END_VERSIONED_NAMESPACE_DECL
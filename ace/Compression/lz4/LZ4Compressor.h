@@ -0,0 +1,95 @@
+// -*- C++ -*-
+//=============================================================================
+/**
+ *  @file   LZ4Compressor.h
+ *
+ *  $Id$
+ *
+ *  LZ4 is a byte oriented LZ77 compressor that trades ratio for
+ *  speed: it finds matches through a single hash table of the last
+ *  position of each 4 byte sequence and codes no entropy, so that it
+ *  compresses at hundreds of MB/s and decompresses at memory speed.
+ *  This is an in-tree implementation of the LZ4 block format, so its
+ *  output can be read by any LZ4 block decompressor and the other way
+ *  around.
+ *
+ *  FORMAT: a block is a series of sequences, each a token byte whose
+ *  high nibble is a count of literals and low nibble a match length
+ *  less 4, the literals, and the 2 byte little endian offset back to
+ *  the match.  A nibble of 15 is extended by following bytes that are
+ *  added up to the first one below 255.  The last sequence has only
+ *  literals, of which there are at least 5, and no match starts
+ *  within the last 12 bytes of the block.
+ */
+//=============================================================================
+
+#ifndef ACE_LZ4COMPRESSOR_H
+#define ACE_LZ4COMPRESSOR_H
+
+#include /**/ "ace/pre.h"
+
+#include "ACE_LZ4Compression_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Compression/Compressor.h"
+#include "ace/Singleton.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+class ACE_LZ4Compression_Export ACE_LZ4Compressor : public ACE_Compressor
+{
+public:
+  /**
+   * Default constructor. Should use instance() to get global instance.
+   */
+  ACE_LZ4Compressor (void);
+
+  virtual ~ACE_LZ4Compressor (void);
+
+  /**
+   * Compress the @a in_ptr buffer for @a in_len into the
+   * @a out_ptr buffer with a maximum @a max_out_len using the
+   * LZ4 block format.  If the @a max_out_len is exhausted through
+   * the compress process then a value of -1 will be returned from
+   * the function, otherwise the return value will indicate the
+   * resultant @a out_ptr compressed buffer length.
+   *
+   * @note Data that does not compress grows by up to
+   * compress_bound() - @a in_len bytes.
+   */
+  virtual ACE_UINT64 compress (const void *in_ptr,
+                               ACE_UINT64 in_len,
+                               void *out_ptr,
+                               ACE_UINT64 max_out_len);
+
+  /**
+   * DeCompress the @a in_ptr buffer for @a in_len into the
+   * @a out_ptr buffer with a maximum @a max_out_len.  If the
+   * @a max_out_len is exhausted during decompression, or @a in_ptr
+   * is not a valid LZ4 block, then a value of -1 will be returned
+   * from the function, otherwise the return value will indicate
+   * the resultant @a out_ptr decompressed buffer length.  Nothing
+   * is read or written outside of the two buffers whatever the
+   * input.
+   */
+  virtual ACE_UINT64 decompress (const void *in_ptr,
+                                 ACE_UINT64 in_len,
+                                 void *out_ptr,
+                                 ACE_UINT64 max_out_len);
+
+  /// The largest size of @a in_len bytes once compressed.
+  static ACE_UINT64 compress_bound (ACE_UINT64 in_len);
+};
+
+ACE_LZ4COMPRESSION_SINGLETON_DECLARE(ACE_Singleton, ACE_LZ4Compressor, ACE_SYNCH_MUTEX);
+
+typedef class ACE_Singleton<ACE_LZ4Compressor, ACE_SYNCH_MUTEX> ACE_LZ4Compression;
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#include /**/ "ace/post.h"
+
+#endif // ACE_LZ4COMPRESSOR_H
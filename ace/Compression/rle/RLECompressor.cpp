@@ -2,6 +2,22 @@
 
 #include "RLECompressor.h"
 #include "ace/OS_NS_string.h"
+#include "ace/Min_Max.h"
+
+// Look for runs 16 bytes at a time with SSE2, which every x86_64
+// processor has, and 32 at a time with AVX2 when the compiler targets
+// it (e.g., -mavx2).  Define ACE_LACKS_RLE_SIMD to look a word at a
+// time instead, which is what other processors do.
+#if !defined (ACE_LACKS_RLE_SIMD)
+# if (defined (__x86_64__) && defined (__SSE2__)) || defined (_M_X64)
+#   define ACE_RLECOMPRESSOR_SSE2
+#   include <emmintrin.h>
+# endif
+# if defined (ACE_RLECOMPRESSOR_SSE2) && defined (__AVX2__)
+#   define ACE_RLECOMPRESSOR_AVX2
+#   include <immintrin.h>
+# endif
+#endif /* !ACE_LACKS_RLE_SIMD */
 
 #if defined (__BORLANDC__) && (__BORLANDC__ <= 0x660)
 #  pragma option push -w-8072
@@ -9,6 +25,119 @@
 
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
+namespace
+{
+    inline unsigned int
+    rle_lowest_bit(ACE_UINT32 mask)
+    {
+#if defined (__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+        unsigned int i = 0;
+        for (; (mask & 1u) == 0; mask >>= 1) {
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    // Number of bytes from p equal to *p, before end.
+    inline size_t
+    rle_run_length(const ACE_Byte *p, const ACE_Byte *end)
+    {
+        const ACE_Byte *const start = p;
+        ACE_Byte const b = *p;
+
+#if defined (ACE_RLECOMPRESSOR_AVX2)
+        __m256i const b32 = _mm256_set1_epi8(char(b));
+        for (; end - p >= 32; p += 32) {
+            ACE_UINT32 const equal = ACE_UINT32(_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(_mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(p)), b32)));
+            if (equal != 0xFFFFFFFFU) {
+                return size_t(p - start) + rle_lowest_bit(~equal);
+            }
+        }
+#endif /* ACE_RLECOMPRESSOR_AVX2 */
+
+#if defined (ACE_RLECOMPRESSOR_SSE2)
+        __m128i const b16 = _mm_set1_epi8(char(b));
+        for (; end - p >= 16; p += 16) {
+            ACE_UINT32 const equal = ACE_UINT32(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(p)), b16)));
+            if (equal != 0xFFFFU) {
+                return size_t(p - start) + rle_lowest_bit(~equal);
+            }
+        }
+#else
+        // A word at a time while the whole word is equal.
+        ACE_UINT64 const b8 = ACE_UINT64(b) * ACE_UINT64(0x0101010101010101);
+        for (; end - p >= 8; p += 8) {
+            ACE_UINT64 w;
+            ACE_OS::memcpy(&w, p, sizeof w);
+            if (w != b8) {
+                break;
+            }
+        }
+#endif /* ACE_RLECOMPRESSOR_SSE2 */
+
+        while (p < end && *p == b) {
+            ++p;
+        }
+        return size_t(p - start);
+    }
+
+    // First byte from p equal to the byte after it, or end if none
+    // is before end - 1.
+    inline const ACE_Byte *
+    rle_find_pair(const ACE_Byte *p, const ACE_Byte *end)
+    {
+#if defined (ACE_RLECOMPRESSOR_AVX2)
+        for (; end - p >= 33; p += 32) {
+            ACE_UINT32 const pairs = ACE_UINT32(_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 1)))));
+            if (pairs != 0) {
+                return p + rle_lowest_bit(pairs);
+            }
+        }
+#endif /* ACE_RLECOMPRESSOR_AVX2 */
+
+#if defined (ACE_RLECOMPRESSOR_SSE2)
+        for (; end - p >= 17; p += 16) {
+            ACE_UINT32 const pairs = ACE_UINT32(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1)))));
+            if (pairs != 0) {
+                return p + rle_lowest_bit(pairs);
+            }
+        }
+#else
+        // A word at a time while no byte of it equals the next one.
+        ACE_UINT64 const ones = ACE_UINT64(0x0101010101010101);
+        for (; end - p >= 9; p += 8) {
+            ACE_UINT64 w0, w1;
+            ACE_OS::memcpy(&w0, p, sizeof w0);
+            ACE_OS::memcpy(&w1, p + 1, sizeof w1);
+            ACE_UINT64 const d = w0 ^ w1;
+            if (((d - ones) & ~d & (ones << 7)) != 0) {
+                break;
+            }
+        }
+#endif /* ACE_RLECOMPRESSOR_SSE2 */
+
+        for (; end - p >= 2; ++p) {
+            if (p[0] == p[1]) {
+                return p;
+            }
+        }
+        return end;
+    }
+}
+
 ACE_RLECompressor::ACE_RLECompressor(void)
     : ACE_Compressor(ACE_COMPRESSORID_RLE)
 {
@@ -19,6 +148,12 @@ ACE_RLECompressor::~ACE_RLECompressor(void)
 }
 
 // Compress using Run Length Encoding (RLE)
+//
+// A run starts wherever a byte equals the next one and takes all the
+// bytes equal to it, 128 at most per packet; a single byte left over
+// from a run longer than 128 starts a copy packet.  The bytes up to
+// the next run are copied, 128 at most per packet.  The runs and the
+// next runs are found 16 or 32 bytes at a time by the kernels above.
 ACE_UINT64
 ACE_RLECompressor::compress( const void *in_ptr,
                              ACE_UINT64 in_len,
@@ -28,69 +163,72 @@ ACE_RLECompressor::compress( const void *in_ptr,
     const ACE_Byte *in_p    = static_cast<const ACE_Byte *>(in_ptr);
     ACE_Byte *out_p         = static_cast<ACE_Byte *>(out_ptr);
 
-    ACE_UINT64 src_len      = in_len;  // Save for stats
     ACE_UINT64 out_index    = 0;
-    ACE_UINT64 out_base     = 0;
-    size_t     run_count    = 0;
-    bool       run_code     = false;
+    ACE_UINT64 copy_base    = 0;    // Header of the open copy packet
+    size_t     copy_count   = 0;    // Its length, 0 if none is open
 
     if (in_p && out_p && in_len) {
 
-        while (in_len-- > 0) {
-
-            ACE_Byte cur_byte = *in_p++;
-
-            switch (out_index ? run_count : 128U) {  // BootStrap to 128
+        const ACE_Byte *const in_end = in_p + in_len;
 
-            case 128:
+        while (in_p < in_end) {
 
-                if ((out_base = out_index++) >= max_out_len) {
-                    return ACE_UINT64(-1);      // Output Exhausted
-                }
-                run_code  = false;
-                run_count = 0; // Switch off compressing
+            const ACE_Byte *copy_end;
 
-                // Fall Through
+            if (in_end - in_p >= 2 && in_p[0] == in_p[1]) {
 
-            default:
+                size_t          run_len  = rle_run_length(in_p, in_end);
+                ACE_Byte const  run_byte = *in_p;
 
-                // Fix problem where input exhaused but maybe compressing
-                if (in_len ? cur_byte == *in_p : run_code) {
+                copy_count = 0;                 // Close any copy packet
 
-                    if (run_code) {             // In Compression?
-                        out_p[out_base] = ACE_Byte(run_count++ | 0x80);
-                        continue;               // Stay in Compression
-                    } else if (run_count) {     // Xfering to Compression
-                        if ((out_base = out_index++) >= max_out_len) {
-                            return ACE_UINT64(-1); // Output Exhausted
-                        }
-                        run_count = 0;
+                for (; run_len > 128; run_len -= 128, in_p += 128) {
+                    if (max_out_len - out_index < 2) {
+                        return ACE_UINT64(-1);  // Output Exhausted
                     }
-                    run_code  = true;           // We Are Now Compressing
+                    out_p[out_index++] = 0xFF;
+                    out_p[out_index++] = run_byte;
+                }
 
-                } else if (run_code) {          // Are we in Compression?
-                    // Finalise the Compression Run Length
-                    out_p[out_base] = ACE_Byte(run_count | 0x80);
-                    // Reset for Uncmpressed
-                    if (in_len && (out_base = out_index++) >= max_out_len) {
+                if (run_len >= 2) {
+                    if (max_out_len - out_index < 2) {
                         return ACE_UINT64(-1);  // Output Exhausted
                     }
-                    run_code    = false;
-                    run_count   = 0;
-                    continue;   // Now restart Uncompressed
+                    out_p[out_index++] = ACE_Byte((run_len - 1) | 0x80);
+                    out_p[out_index++] = run_byte;
+                    in_p += run_len;
+                    continue;
                 }
 
-                break;
+                copy_end = in_p + 1;            // One left over
+
+            } else {
+                copy_end = rle_find_pair(in_p + 1, in_end);
             }
 
-            out_p[out_base] = ACE_Byte(run_count++ | (run_code ? 0x80 : 0));
+            while (in_p < copy_end) {
 
-            if (out_index >= max_out_len) {
-                return ACE_UINT64(-1);          // Output Exhausted
+                if (copy_count == 0 || copy_count == 128) {
+                    if (out_index >= max_out_len) {
+                        return ACE_UINT64(-1);  // Output Exhausted
+                    }
+                    copy_base  = out_index++;
+                    copy_count = 0;
+                }
+
+                size_t const cpy_len = ace_min(size_t(copy_end - in_p),
+                                               128 - copy_count);
+                if (max_out_len - out_index < cpy_len) {
+                    return ACE_UINT64(-1);      // Output Exhausted
+                }
+                ACE_OS::memcpy(out_p + out_index, in_p, cpy_len);
+                out_index   += cpy_len;
+                in_p        += cpy_len;
+                copy_count  += cpy_len;
+                out_p[copy_base] = ACE_Byte(copy_count - 1);
             }
-            out_p[out_index++] = cur_byte;
         }
-        this->update_stats(src_len, out_index);
+        this->update_stats(in_len, out_index);
     }
 
     return out_index;  // return as our output length
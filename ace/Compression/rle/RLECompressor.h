@@ -21,7 +21,7 @@
  *  ALGORITHM: This algorithm is an optimized version of the traditional
  *  RLE algorithm in that it behaves better with very few runs.
  *
- *  With a run of a character where that run is >= 3 this is
+ *  With a run of a character where that run is >= 2 this is
  *  replaced with the repeat indicator 0X80 and then the repeat count OR'd
  *  over this ident.  This repeat count is therefore has a maximum value
  *  of 127 (0x7F) which is to be interpreted as the next character repeated
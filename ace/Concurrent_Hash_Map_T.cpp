@@ -0,0 +1,240 @@
+
+//=============================================================================
+/**
+ *  @file    Concurrent_Hash_Map_T.cpp
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+
+#ifndef ACE_CONCURRENT_HASH_MAP_T_CPP
+#define ACE_CONCURRENT_HASH_MAP_T_CPP
+
+#include "ace/Concurrent_Hash_Map_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if !defined (__ACE_INLINE__)
+# include "ace/Concurrent_Hash_Map_T.inl"
+#endif /* __ACE_INLINE__ */
+
+#include "ace/Malloc_Base.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Concurrent_Hash_Map)
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Concurrent_Hash_Map (ACE_Allocator *table_alloc,
+                                                                                                    ACE_Allocator *entry_alloc)
+  : table_allocator_ (0),
+    stripes_ (0),
+    stripe_mask_ (0)
+{
+  if (this->create_stripes (ACE_DEFAULT_MAP_SIZE,
+                            table_alloc,
+                            entry_alloc,
+                            ACE_DEFAULT_CONCURRENT_MAP_STRIPES) == -1)
+    ACELIB_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"),
+                ACE_TEXT ("ACE_Concurrent_Hash_Map")));
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Concurrent_Hash_Map (size_t size,
+                                                                                                    ACE_Allocator *table_alloc,
+                                                                                                    ACE_Allocator *entry_alloc,
+                                                                                                    size_t stripes)
+  : table_allocator_ (0),
+    stripes_ (0),
+    stripe_mask_ (0)
+{
+  if (this->create_stripes (size, table_alloc, entry_alloc, stripes) == -1)
+    ACELIB_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"),
+                ACE_TEXT ("ACE_Concurrent_Hash_Map")));
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::~ACE_Concurrent_Hash_Map (void)
+{
+  ACE_DES_ARRAY_FREE (this->stripes_,
+                      this->stripe_mask_ + 1,
+                      this->table_allocator_->free,
+                      Stripe);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::create_stripes (size_t size,
+                                                                                           ACE_Allocator *table_alloc,
+                                                                                           ACE_Allocator *entry_alloc,
+                                                                                           size_t stripes)
+{
+  if (table_alloc == 0)
+    table_alloc = ACE_Allocator::instance ();
+  this->table_allocator_ = table_alloc;
+
+  size_t count = 1;
+  while (count < stripes)
+    count <<= 1;
+
+  void *ptr = 0;
+  ACE_ALLOCATOR_RETURN (ptr,
+                        table_alloc->malloc (count * sizeof (Stripe)),
+                        -1);
+
+  this->stripes_ = static_cast<Stripe *> (ptr);
+  this->stripe_mask_ = count - 1;
+
+  size_t const buckets = this->stripe_size (size);
+  for (size_t i = 0; i < count; ++i)
+    new (&this->stripes_[i]) Stripe (buckets, table_alloc, entry_alloc);
+
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> size_t
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::stripe_size (size_t size) const
+{
+  size_t const buckets = size / (this->stripe_mask_ + 1);
+  return buckets == 0 ? 1 : buckets;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::open (size_t size,
+                                                                                 ACE_Allocator *table_alloc,
+                                                                                 ACE_Allocator *entry_alloc)
+{
+  size_t const buckets = this->stripe_size (size);
+
+  for (size_t i = 0; i <= this->stripe_mask_; ++i)
+    {
+      Stripe &s = this->stripes_[i];
+      ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+      if (s.map_.open (buckets, table_alloc, entry_alloc) == -1)
+        return -1;
+    }
+
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::close (void)
+{
+  for (size_t i = 0; i <= this->stripe_mask_; ++i)
+    {
+      Stripe &s = this->stripes_[i];
+      ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+      s.map_.close ();
+    }
+
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind_all (void)
+{
+  for (size_t i = 0; i <= this->stripe_mask_; ++i)
+    {
+      Stripe &s = this->stripes_[i];
+      ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+      s.map_.unbind_all ();
+    }
+
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> size_t
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::current_size (void) const
+{
+  size_t size = 0;
+  for (size_t i = 0; i <= this->stripe_mask_; ++i)
+    {
+      Stripe &s = this->stripes_[i];
+      ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, 0);
+      size += s.map_.current_size ();
+    }
+  return size;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> size_t
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::total_size (void) const
+{
+  size_t size = 0;
+  for (size_t i = 0; i <= this->stripe_mask_; ++i)
+    {
+      Stripe &s = this->stripes_[i];
+      ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, 0);
+      size += s.map_.total_size ();
+    }
+  return size;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("stripes = %B\n"), this->stripe_mask_ + 1));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("current_size = %B\n"), this->current_size ()));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("total_size = %B\n"), this->total_size ()));
+  if (this->table_allocator_ != 0)
+    this->table_allocator_->dump ();
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+// ------------------------------------------------------------
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Concurrent_Hash_Map_Iterator)
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::skip_done (void)
+{
+  while (this->iter_.done () && this->stripe_ < this->map_man_->stripe_mask_)
+    {
+      ++this->stripe_;
+      this->iter_ = STRIPE_ITERATOR (this->map_man_->stripes_[this->stripe_].map_);
+    }
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("stripe_ = %B\n"), this->stripe_));
+  this->iter_.dump ();
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+// ------------------------------------------------------------
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Concurrent_Hash_Map_Reverse_Iterator)
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::skip_done (void)
+{
+  while (this->iter_.done () && this->stripe_ > 0)
+    {
+      --this->stripe_;
+      this->iter_ = STRIPE_ITERATOR (this->map_man_->stripes_[this->stripe_].map_);
+    }
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("stripe_ = %B\n"), this->stripe_));
+  this->iter_.dump ();
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_CONCURRENT_HASH_MAP_T_CPP */
@@ -0,0 +1,515 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Concurrent_Hash_Map_T.h
+ *
+ *  $Id$
+ *
+ *  A hash map with the interface of ACE_Hash_Map_Manager_Ex whose
+ *  entries are split between independently locked stripes.
+ */
+//=============================================================================
+
+#ifndef ACE_CONCURRENT_HASH_MAP_T_H
+#define ACE_CONCURRENT_HASH_MAP_T_H
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/config-all.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Hash_Map_Manager_T.h"
+#include "ace/Null_Mutex.h"
+#include <iterator>
+
+/// Number of stripes of an ACE_Concurrent_Hash_Map unless given to
+/// its constructor.
+#if !defined (ACE_DEFAULT_CONCURRENT_MAP_STRIPES)
+# define ACE_DEFAULT_CONCURRENT_MAP_STRIPES 16
+#endif /* ACE_DEFAULT_CONCURRENT_MAP_STRIPES */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+class ACE_Allocator;
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map_Iterator;
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map_Reverse_Iterator;
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map_Bucket_Iterator;
+
+/**
+ * @class ACE_Concurrent_Hash_Map
+ *
+ * @brief Hash map that threads can search and update concurrently.
+ *
+ * An ACE_Hash_Map_Manager_Ex holds a single ACE_LOCK for all its
+ * operations, so its users are serialized even when they look up
+ * different keys, and readers bounce the cache line of the lock
+ * between processors.  This map splits its entries between a power
+ * of two number of stripes, chosen from the high bits of the hash of
+ * the key.  Every stripe is an ACE_Hash_Map_Manager_Ex with its own
+ * ACE_LOCK, in its own cache lines, so operations on keys of
+ * different stripes proceed in parallel.  With an
+ * ACE_RW_Thread_Mutex, find() only takes the read lock of its
+ * stripe and lookups of the same stripe proceed in parallel too.
+ *
+ * The interface is that of ACE_Hash_Map_Manager_Ex, with the same
+ * return values and entries, so that the map can replace it, e.g. in
+ * ACE_Hash_Cache_Map_Manager, except that:
+ * - there is no single lock for the whole map; mutex() returns the
+ *   lock of the stripe of a key, which the caller holds while using
+ *   an entry that another thread may unbind;
+ * - current_size() locks the stripes in turn to add up their sizes,
+ *   so it is exact only when the map is not being updated;
+ * - the iterators do not lock the map (as those of
+ *   ACE_Hash_Map_Manager_Ex) and visit the stripes in turn.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map
+{
+public:
+  friend class ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>;
+  friend class ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>;
+  friend class ACE_Concurrent_Hash_Map_Bucket_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>;
+
+  typedef EXT_ID
+          KEY;
+  typedef INT_ID
+          VALUE;
+  typedef ACE_LOCK lock_type;
+  typedef ACE_Hash_Map_Entry<EXT_ID, INT_ID>
+          ENTRY;
+
+  /// The map of a single stripe, locked by the stripe.
+  typedef ACE_Hash_Map_Manager_Ex<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex>
+          STRIPE_MAP;
+
+  // = ACE-style iterator typedefs.
+  typedef ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          ITERATOR;
+  typedef ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          REVERSE_ITERATOR;
+  typedef ACE_Concurrent_Hash_Map_Bucket_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          BUCKET_ITERATOR;
+
+  // = STL-style iterator typedefs.
+  typedef ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          iterator;
+  typedef ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          reverse_iterator;
+
+  // = STL-style typedefs/traits.
+  typedef EXT_ID                             key_type;
+  typedef INT_ID                             data_type;
+  typedef ACE_Hash_Map_Entry<EXT_ID, INT_ID> value_type;
+  typedef value_type &                       reference;
+  typedef value_type const &                 const_reference;
+  typedef value_type *                       pointer;
+  typedef value_type const *                 const_pointer;
+  typedef ptrdiff_t                          difference_type;
+  typedef size_t                             size_type;
+
+  /**
+   * Initialize a map with ACE_DEFAULT_CONCURRENT_MAP_STRIPES stripes
+   * and ACE_DEFAULT_MAP_SIZE buckets in all.  The stripes and their
+   * tables are allocated from @a table_alloc, the entries from
+   * @a entry_alloc; both default to ACE_Allocator::instance().
+   */
+  ACE_Concurrent_Hash_Map (ACE_Allocator *table_alloc = 0,
+                           ACE_Allocator *entry_alloc = 0);
+
+  /// Initialize a map with @a stripes stripes, rounded up to a power
+  /// of two, and @a size buckets in all.
+  ACE_Concurrent_Hash_Map (size_t size,
+                           ACE_Allocator *table_alloc = 0,
+                           ACE_Allocator *entry_alloc = 0,
+                           size_t stripes = ACE_DEFAULT_CONCURRENT_MAP_STRIPES);
+
+  /**
+   * Reinitialize the stripes with @a size buckets in all, releasing
+   * their entries.  The number of stripes does not change.
+   * @return -1 on failure, 0 on success
+   */
+  int open (size_t size = ACE_DEFAULT_MAP_SIZE,
+            ACE_Allocator *table_alloc = 0,
+            ACE_Allocator *entry_alloc = 0);
+
+  /// Close down the stripes and release their entries and tables.
+  int close (void);
+
+  /// Removes all the entries in the map.
+  int unbind_all (void);
+
+  /// Cleanup the map.
+  ~ACE_Concurrent_Hash_Map (void);
+
+  /**
+   * Associate @a ext_id with @a int_id.  If @a ext_id is already in
+   * the map then the map is not changed.
+   *
+   * @retval 0 if a new entry is bound successfully.
+   * @retval 1 if an attempt is made to bind an existing entry.
+   * @retval -1 if a failure occurs; check @c errno for more information.
+   */
+  int bind (const EXT_ID &ext_id,
+            const INT_ID &int_id);
+
+  /// Same as a normal bind, except the new or existing entry is also
+  /// passed back to the caller.
+  int bind (const EXT_ID &ext_id,
+            const INT_ID &int_id,
+            ENTRY *&entry);
+
+  /**
+   * Associate @a ext_id with @a int_id if and only if @a ext_id is not
+   * in the map.  If @a ext_id is already in the map then the @a int_id
+   * parameter is assigned the existing value in the map.  Returns 0
+   * if a new entry is bound successfully, returns 1 if an attempt is
+   * made to bind an existing entry, and returns -1 if failures occur.
+   */
+  int trybind (const EXT_ID &ext_id,
+               INT_ID &int_id);
+
+  /// Same as a normal trybind, except the new or existing entry is
+  /// also passed back to the caller.
+  int trybind (const EXT_ID &ext_id,
+               INT_ID &int_id,
+               ENTRY *&entry);
+
+  /**
+   * Reassociate @a ext_id with @a int_id.  If @a ext_id is not in the
+   * map then behaves just like bind().  Returns 0 if a new entry is
+   * bound successfully, returns 1 if an existing entry was rebound,
+   * and returns -1 if failures occur.
+   */
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id);
+
+  /// Same as a normal rebind, except the entry is also passed back to
+  /// the caller.
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id,
+              ENTRY *&entry);
+
+  /// Same as a normal rebind, except the previous value of an
+  /// existing entry is passed back in @a old_int_id.
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id,
+              INT_ID &old_int_id);
+
+  /// Same as a normal rebind, except the key of an existing entry is
+  /// replaced by @a ext_id as well, and its previous key and value are
+  /// passed back in @a old_ext_id and @a old_int_id.
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id,
+              EXT_ID &old_ext_id,
+              INT_ID &old_int_id);
+
+  /// Locate @a ext_id and pass out parameter via @a int_id.
+  /// Return 0 if found, returns -1 if not found.
+  int find (const EXT_ID &ext_id,
+            INT_ID &int_id) const;
+
+  /// Returns 0 if the @a ext_id is in the mapping, otherwise -1.
+  int find (const EXT_ID &ext_id) const;
+
+  /// Locate @a ext_id and pass out its entry.
+  /// Return 0 if found, returns -1 if not found.
+  int find (const EXT_ID &ext_id,
+            ENTRY *&entry) const;
+
+  /// Unbind (remove) the @a ext_id from the map.  Returns 0 if
+  /// successful, -1 if @a ext_id is not in the map.
+  int unbind (const EXT_ID &ext_id);
+
+  /// Same as the other unbind, except the value of the entry removed
+  /// is passed back in @a int_id.
+  int unbind (const EXT_ID &ext_id,
+              INT_ID &int_id);
+
+  /// Remove @a entry from the map.
+  int unbind (ENTRY *entry);
+
+  /// Returns the current number of entries in the map.  Each stripe
+  /// is locked in turn while its size is read, so while other threads
+  /// update the map this is only an approximation.  Must not be called
+  /// while holding the lock of a stripe.
+  size_t current_size (void) const;
+
+  /// Returns the number of buckets of all the stripes, locking them
+  /// in turn as current_size() does.
+  size_t total_size (void) const;
+
+  /// Returns the number of stripes.
+  size_t stripes (void) const;
+
+  /// Returns the lock of the stripe of @a ext_id, to hold while using
+  /// its entry or iterating over its bucket.
+  ACE_LOCK &mutex (const EXT_ID &ext_id);
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  // = STL styled iterator factory functions.
+
+  /// Return forward iterator.
+  iterator begin (void);
+  iterator end (void);
+
+  /// Return reverse iterator.
+  reverse_iterator rbegin (void);
+  reverse_iterator rend (void);
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  enum { CACHE_LINE_SIZE = 64 };
+
+  /// A map and its lock.
+  struct Stripe
+  {
+    Stripe (size_t size,
+            ACE_Allocator *table_alloc,
+            ACE_Allocator *entry_alloc)
+      : map_ (size, table_alloc, entry_alloc)
+    {
+    }
+
+    /// Keeps the lock out of the cache line of the previous stripe's
+    /// map, which its users write to.
+    char pad_[CACHE_LINE_SIZE];
+
+    mutable ACE_LOCK lock_;
+
+    STRIPE_MAP map_;
+  };
+
+  /// Allocate @a stripes stripes, rounded up to a power of two, with
+  /// @a size buckets in all.
+  int create_stripes (size_t size,
+                      ACE_Allocator *table_alloc,
+                      ACE_Allocator *entry_alloc,
+                      size_t stripes);
+
+  /// Stripe of @a ext_id.
+  Stripe &stripe (const EXT_ID &ext_id) const;
+
+  /// Buckets of a stripe for @a size buckets in all.
+  size_t stripe_size (size_t size) const;
+
+  /// Function object used for hashing keys.
+  HASH_KEY hash_key_;
+
+  /// Allocator of the stripes.
+  ACE_Allocator *table_allocator_;
+
+  /// The stripes, a power of two number of them.
+  Stripe *stripes_;
+
+  /// Number of stripes minus one.
+  size_t stripe_mask_;
+
+  // = Disallow these operations.
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &))
+  ACE_UNIMPLEMENTED_FUNC (ACE_Concurrent_Hash_Map (const ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &))
+};
+
+/**
+ * @class ACE_Concurrent_Hash_Map_Iterator
+ *
+ * @brief Forward iterator for the ACE_Concurrent_Hash_Map.
+ *
+ * Visits the entries of every stripe in turn.  This class does not
+ * lock the map; iterate while no other thread updates it.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map_Iterator
+{
+public:
+  // = STL-style typedefs/traits.
+  typedef ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          container_type;
+
+  typedef std::forward_iterator_tag                iterator_category;
+  typedef typename container_type::value_type      value_type;
+  typedef typename container_type::reference       reference;
+  typedef typename container_type::pointer         pointer;
+  typedef typename container_type::difference_type difference_type;
+
+  /// Iterate from the first entry of @a mm, or from its end if
+  /// @a tail is true.
+  ACE_Concurrent_Hash_Map_Iterator (container_type &mm, bool tail = false);
+
+  /// Pass back the next entry that hasn't been seen in the map.
+  /// Returns 0 when all items have been seen, else 1.
+  int next (ACE_Hash_Map_Entry<EXT_ID, INT_ID> *&next_entry) const;
+
+  /// Returns 1 when all items have been seen, else 0.
+  int done (void) const;
+
+  /// Move forward by one element in the map.  Returns 0 when all
+  /// elements have been seen, else 1.
+  int advance (void);
+
+  /// Returns a reference to the interal element @c this is pointing to.
+  ACE_Hash_Map_Entry<EXT_ID, INT_ID>& operator* (void) const;
+
+  /// Returns a pointer to the interal element @c this is pointing to.
+  ACE_Hash_Map_Entry<EXT_ID, INT_ID>* operator-> (void) const;
+
+  // = STL styled iteration.
+  ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &operator++ (void);
+  ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> operator++ (int);
+
+  /// Check if two iterators point to the same position.
+  bool operator== (const ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+  bool operator!= (const ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  typedef typename container_type::STRIPE_MAP::ITERATOR STRIPE_ITERATOR;
+
+  /// Move on to the first entry of the next stripes while the current
+  /// one has no more entries.
+  void skip_done (void);
+
+  /// Map we are iterating over.
+  container_type *map_man_;
+
+  /// Stripe of the current entry.
+  size_t stripe_;
+
+  /// Position in that stripe.
+  STRIPE_ITERATOR iter_;
+};
+
+/**
+ * @class ACE_Concurrent_Hash_Map_Reverse_Iterator
+ *
+ * @brief Reverse iterator for the ACE_Concurrent_Hash_Map.
+ *
+ * Visits the entries of every stripe in turn, from the last stripe
+ * to the first.  Like ACE_Concurrent_Hash_Map_Iterator, this class
+ * does not lock the map.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map_Reverse_Iterator
+{
+public:
+  // = STL-style typedefs/traits.
+  typedef ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          container_type;
+
+  typedef std::forward_iterator_tag                iterator_category;
+  typedef typename container_type::value_type      value_type;
+  typedef typename container_type::reference       reference;
+  typedef typename container_type::pointer         pointer;
+  typedef typename container_type::difference_type difference_type;
+
+  /// Iterate from the last entry of @a mm, or from its reverse end if
+  /// @a head is true.
+  ACE_Concurrent_Hash_Map_Reverse_Iterator (container_type &mm,
+                                            bool head = false);
+
+  /// Pass back the next entry that hasn't been seen in the map.
+  /// Returns 0 when all items have been seen, else 1.
+  int next (ACE_Hash_Map_Entry<EXT_ID, INT_ID> *&next_entry) const;
+
+  /// Returns 1 when all items have been seen, else 0.
+  int done (void) const;
+
+  /// Move backward by one element in the map.  Returns 0 when all
+  /// elements have been seen, else 1.
+  int advance (void);
+
+  /// Returns a reference to the interal element @c this is pointing to.
+  ACE_Hash_Map_Entry<EXT_ID, INT_ID>& operator* (void) const;
+
+  /// Returns a pointer to the interal element @c this is pointing to.
+  ACE_Hash_Map_Entry<EXT_ID, INT_ID>* operator-> (void) const;
+
+  // = STL styled iteration.
+  ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &operator++ (void);
+  ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> operator++ (int);
+
+  /// Check if two iterators point to the same position.
+  bool operator== (const ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+  bool operator!= (const ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  typedef typename container_type::STRIPE_MAP::REVERSE_ITERATOR STRIPE_ITERATOR;
+
+  /// Move on to the last entry of the previous stripes while the
+  /// current one has no more entries.
+  void skip_done (void);
+
+  /// Map we are iterating over.
+  container_type *map_man_;
+
+  /// Stripe of the current entry.
+  size_t stripe_;
+
+  /// Position in that stripe.
+  STRIPE_ITERATOR iter_;
+};
+
+/**
+ * @class ACE_Concurrent_Hash_Map_Bucket_Iterator
+ *
+ * @brief Iterator over the entries of the bucket of a key.
+ *
+ * The bucket is that of the key in the map of its stripe, so this is
+ * an ACE_Hash_Map_Bucket_Iterator over that map.  It does not lock
+ * the stripe; hold the lock returned by
+ * ACE_Concurrent_Hash_Map::mutex() for the key while iterating.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Concurrent_Hash_Map_Bucket_Iterator
+  : public ACE_Hash_Map_Bucket_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex>
+{
+public:
+  typedef ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          container_type;
+
+  /// Iterate from the first entry of the bucket of @a ext_id, or from
+  /// its end if @a tail is not 0.
+  ACE_Concurrent_Hash_Map_Bucket_Iterator (container_type &mm,
+                                           const EXT_ID &ext_id,
+                                           int tail = 0);
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/Concurrent_Hash_Map_T.inl"
+#endif /* __ACE_INLINE__ */
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/Concurrent_Hash_Map_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("Concurrent_Hash_Map_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_CONCURRENT_HASH_MAP_T_H */
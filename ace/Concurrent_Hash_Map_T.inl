@@ -0,0 +1,355 @@
+// -*- C++ -*-
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+typename ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::Stripe &
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::stripe (const EXT_ID &ext_id) const
+{
+  // The maps of the stripes use the low bits of the hash, pick the
+  // stripe with high bits of a multiplicative hash.
+  ACE_UINT64 const h =
+    static_cast<ACE_UINT64> (this->hash_key_ (ext_id))
+    * ACE_UINT64_LITERAL (0x9E3779B97F4A7C15);
+  return this->stripes_[static_cast<size_t> (h >> 32) & this->stripe_mask_];
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::bind (const EXT_ID &ext_id,
+                                                                                 const INT_ID &int_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.bind (ext_id, int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::bind (const EXT_ID &ext_id,
+                                                                                 const INT_ID &int_id,
+                                                                                 ENTRY *&entry)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.bind (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::trybind (const EXT_ID &ext_id,
+                                                                                    INT_ID &int_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.trybind (ext_id, int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::trybind (const EXT_ID &ext_id,
+                                                                                    INT_ID &int_id,
+                                                                                    ENTRY *&entry)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.trybind (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                                   const INT_ID &int_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.rebind (ext_id, int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                                   const INT_ID &int_id,
+                                                                                   ENTRY *&entry)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.rebind (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                                   const INT_ID &int_id,
+                                                                                   INT_ID &old_int_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.rebind (ext_id, int_id, old_int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                                   const INT_ID &int_id,
+                                                                                   EXT_ID &old_ext_id,
+                                                                                   INT_ID &old_int_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.rebind (ext_id, int_id, old_ext_id, old_int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find (const EXT_ID &ext_id,
+                                                                                 INT_ID &int_id) const
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.find (ext_id, int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find (const EXT_ID &ext_id) const
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.find (ext_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find (const EXT_ID &ext_id,
+                                                                                 ENTRY *&entry) const
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.find (ext_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (const EXT_ID &ext_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.unbind (ext_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (const EXT_ID &ext_id,
+                                                                                   INT_ID &int_id)
+{
+  Stripe &s = this->stripe (ext_id);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.unbind (ext_id, int_id);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (ENTRY *entry)
+{
+  Stripe &s = this->stripe (entry->ext_id_);
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, s.lock_, -1);
+  return s.map_.unbind (entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE size_t
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::stripes (void) const
+{
+  return this->stripe_mask_ + 1;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_LOCK &
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::mutex (const EXT_ID &ext_id)
+{
+  return this->stripe (ext_id).lock_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+typename ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::iterator
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::begin (void)
+{
+  return iterator (*this);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+typename ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::iterator
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::end (void)
+{
+  return iterator (*this, true);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+typename ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::reverse_iterator
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rbegin (void)
+{
+  return reverse_iterator (*this);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+typename ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::reverse_iterator
+ACE_Concurrent_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rend (void)
+{
+  return reverse_iterator (*this, true);
+}
+
+// ------------------------------------------------------------
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Concurrent_Hash_Map_Iterator (container_type &mm,
+                                                                                                                      bool tail)
+  : map_man_ (&mm),
+    stripe_ (tail ? mm.stripe_mask_ : 0),
+    iter_ (mm.stripes_[stripe_].map_, tail)
+{
+  if (!tail)
+    this->skip_done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::next (ACE_Hash_Map_Entry<EXT_ID, INT_ID> *&entry) const
+{
+  return this->iter_.next (entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::done (void) const
+{
+  return this->iter_.done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::advance (void)
+{
+  this->iter_.advance ();
+  this->skip_done ();
+  return !this->iter_.done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Hash_Map_Entry<EXT_ID, INT_ID> &
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator* (void) const
+{
+  return *this->iter_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator-> (void) const
+{
+  return &*this->iter_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (void)
+{
+  this->advance ();
+  return *this;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (int)
+{
+  ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> retv (*this);
+  this->advance ();
+  return retv;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator== (const ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return this->stripe_ == rhs.stripe_
+    && this->map_man_ == rhs.map_man_
+    && this->iter_ == rhs.iter_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator!= (const ACE_Concurrent_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return !(*this == rhs);
+}
+
+// ------------------------------------------------------------
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Concurrent_Hash_Map_Reverse_Iterator (container_type &mm,
+                                                                                                                                      bool head)
+  : map_man_ (&mm),
+    stripe_ (head ? 0 : mm.stripe_mask_),
+    iter_ (mm.stripes_[stripe_].map_, head)
+{
+  if (!head)
+    this->skip_done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::next (ACE_Hash_Map_Entry<EXT_ID, INT_ID> *&entry) const
+{
+  return this->iter_.next (entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::done (void) const
+{
+  return this->iter_.done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::advance (void)
+{
+  this->iter_.advance ();
+  this->skip_done ();
+  return !this->iter_.done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Hash_Map_Entry<EXT_ID, INT_ID> &
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator* (void) const
+{
+  return *this->iter_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator-> (void) const
+{
+  return &*this->iter_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (void)
+{
+  this->advance ();
+  return *this;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (int)
+{
+  ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> retv (*this);
+  this->advance ();
+  return retv;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator== (const ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return this->stripe_ == rhs.stripe_
+    && this->map_man_ == rhs.map_man_
+    && this->iter_ == rhs.iter_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator!= (const ACE_Concurrent_Hash_Map_Reverse_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return !(*this == rhs);
+}
+
+// ------------------------------------------------------------
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Concurrent_Hash_Map_Bucket_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Concurrent_Hash_Map_Bucket_Iterator (container_type &mm,
+                                                                                                                                    const EXT_ID &ext_id,
+                                                                                                                                    int tail)
+  : ACE_Hash_Map_Bucket_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex> (mm.stripe (ext_id).map_,
+                                                                                         ext_id,
+                                                                                         tail)
+{
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -73,6 +73,13 @@
 #define ACE_REACTOR_NOTIFICATION_ARRAY_SIZE 1024
 #endif /* ACE_REACTOR_NOTIFICATION_ARRAY_SIZE */
 
+// Number of events the ACE_Dev_Poll_Reactor harvests from a single
+// epoll_wait() call.  Larger values amortize the system call across
+// several dispatches at the cost of strict per-event fairness.
+#if !defined (ACE_DEFAULT_DEV_POLL_EVENTS_PER_WAIT)
+#define ACE_DEFAULT_DEV_POLL_EVENTS_PER_WAIT 1
+#endif /* ACE_DEFAULT_DEV_POLL_EVENTS_PER_WAIT */
+
 # if !defined (ACE_DEFAULT_TIMEOUT)
 #   define ACE_DEFAULT_TIMEOUT 5
 # endif /* ACE_DEFAULT_TIMEOUT */
@@ -326,6 +333,20 @@
 #   define ACE_DEFAULT_TIMER_WHEEL_RESOLUTION 100
 # endif /* ACE_DEFAULT_TIMER_WHEEL_RESOLUTION */
 
+// Defaults for ACE Timer Hierarchical Wheel: resolution in
+// microseconds, number of levels and log2 of the slots per level.
+# if !defined (ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_RESOLUTION)
+#   define ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_RESOLUTION 1000
+# endif /* ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_RESOLUTION */
+
+# if !defined (ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_LEVELS)
+#   define ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_LEVELS 4
+# endif /* ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_LEVELS */
+
+# if !defined (ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_SLOT_BITS)
+#   define ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_SLOT_BITS 8
+# endif /* ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_SLOT_BITS */
+
 // Default size for ACE Timer Hash table
 # if !defined (ACE_DEFAULT_TIMER_HASH_TABLE_SIZE)
 #   define ACE_DEFAULT_TIMER_HASH_TABLE_SIZE 1024
@@ -348,6 +369,17 @@
 #   define ACE_DEFAULT_FREE_LIST_INC 100
 # endif /* ACE_DEFAULT_FREE_LIST_INC */
 
+// Number of chunks moved at a time between the per-thread caches of
+// an ACE_TSS_Cached_Allocator and its shared depot.
+# if !defined (ACE_DEFAULT_TSS_CACHED_ALLOCATOR_MAGAZINE_SIZE)
+#   define ACE_DEFAULT_TSS_CACHED_ALLOCATOR_MAGAZINE_SIZE 64
+# endif /* ACE_DEFAULT_TSS_CACHED_ALLOCATOR_MAGAZINE_SIZE */
+
+// Size of the slabs an ACE_Slab_Allocator carves its chunks from.
+# if !defined (ACE_DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE)
+#   define ACE_DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE (64 * 1024)
+# endif /* ACE_DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE */
+
 # if !defined (ACE_UNIQUE_NAME_LEN)
 #   define ACE_UNIQUE_NAME_LEN 100
 # endif /* ACE_UNIQUE_NAME_LEN */
@@ -384,6 +416,12 @@
 #   define ACE_MAXLOGMSGLEN 4 * 1024
 # endif /* ACE_MAXLOGMSGLEN */
 
+// Size of the ring buffer of each thread logging through an
+// ACE_Log_Msg_Async.
+# if !defined (ACE_DEFAULT_LOG_MSG_ASYNC_RING_SIZE)
+#   define ACE_DEFAULT_LOG_MSG_ASYNC_RING_SIZE (64 * 1024)
+# endif /* ACE_DEFAULT_LOG_MSG_ASYNC_RING_SIZE */
+
 // Max size of an ACE Token.
 # define ACE_MAXTOKENNAMELEN 40
 
@@ -12,6 +12,10 @@
 # include "ace/OS_NS_fcntl.h"
 # include "ace/OS_NS_stropts.h"
 
+# if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+#   include "ace/Reactor_Instrumentation.h"
+# endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 # if defined (ACE_HAS_DEV_POLL)
 #    if defined (ACE_LINUX)
 #      include /**/ <linux/devpoll.h>
@@ -135,13 +139,32 @@ ACE_Dev_Poll_Reactor_Notify::notify (ACE_Event_Handler *eh,
   // When using the queue, always try to write to the notify pipe. If it
   // fills up, ignore it safely because the already-written bytes will
   // eventually cause the notify handler to be dispatched.
-  if (-1 == this->notification_queue_.push_new_notification (buffer))
+  int const notification_required =
+    this->notification_queue_.push_new_notification (buffer);
+  if (-1 == notification_required)
     return -1;             // Also decrement eh's reference count
 
   // The notification has been queued, so it will be delivered at some
   // point (and may have been already); release the refcnt guard.
   eh_guard.release ();
 
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  // Only the notification that finds the queue empty signals the
+  // eventfd; the reactor keeps signaling it to itself while it
+  // dequeues the others.
+  if (notification_required == 1
+      && this->notification_pipe_.signal () == -1)
+    return -1;
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (this->dp_reactor_->instrumentation () != 0)
+    this->dp_reactor_->instrumentation ()->notify_queued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
+  return 0;
+#else
+  ACE_UNUSED_ARG (notification_required);
+
   // Now pop the pipe to force the callback for dispatching when ready. If
   // the send fails due to a full pipe, don't fail - assume the already-sent
   // pipe bytes will cause the entire notification queue to be processed.
@@ -153,7 +176,13 @@ ACE_Dev_Poll_Reactor_Notify::notify (ACE_Event_Handler *eh,
   if (n == -1 && (errno != EAGAIN))
     return -1;
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (this->dp_reactor_->instrumentation () != 0)
+    this->dp_reactor_->instrumentation ()->notify_queued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   return 0;
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 #else
 
   ACE_Dev_Poll_Handler_Guard eh_guard (eh);
@@ -167,6 +196,11 @@ ACE_Dev_Poll_Reactor_Notify::notify (ACE_Event_Handler *eh,
 
   eh_guard.release ();
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (this->dp_reactor_->instrumentation () != 0)
+    this->dp_reactor_->instrumentation ()->notify_queued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   return 0;
 #endif /* ACE_HAS_REACTOR_NOTIFICATION_QUEUE */
 }
@@ -202,9 +236,6 @@ ACE_Dev_Poll_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
   // by "walking" the array of pollfd structures returned from
   // `/dev/poll' or `/dev/epoll' but that is potentially much more
   // expensive than simply checking for an EWOULDBLOCK.
-  size_t to_read;
-  char *read_p;
-
 #if defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE)
   // The idea in the queued case is to be sure we never end up with a notify
   // queued but no byte in the pipe. If that happens, the notify won't be
@@ -213,10 +244,13 @@ ACE_Dev_Poll_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
   // pipe, so be sure to do it in the reverse order here to avoid a race
   // between removing the last notification from the queue and the notify
   // side writing its byte.
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  ACE_UNUSED_ARG (handle);
+  (void) this->notification_pipe_.clear ();
+#else
   char b[1024];
-  read_p = b;
-  to_read = sizeof(b);
-  (void)ACE::recv (handle, read_p, to_read);
+  (void)ACE::recv (handle, b, sizeof(b));
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 
   bool more_messages_queued = false;
   ACE_Notification_Buffer next;
@@ -230,6 +264,11 @@ ACE_Dev_Poll_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
       if (result <= 0)   // Nothing dequeued or error
         return result;
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      if (this->dp_reactor_->instrumentation () != 0)
+        this->dp_reactor_->instrumentation ()->notify_dequeued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       // If it's just a wake-up, toss it and see if there's anything else.
       if (buffer.eh_ != 0)
         break;
@@ -239,13 +278,19 @@ ACE_Dev_Poll_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
   // in case the notification limit stops dequeuing notifies before
   // emptying the queue.
   if (more_messages_queued)
-    (void) ACE::send (this->notification_pipe_.write_handle (),
-                      (char *)&next,
-                      1); /* one byte is enough */
+    {
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+      (void) this->notification_pipe_.signal ();
+#else
+      (void) ACE::send (this->notification_pipe_.write_handle (),
+                        (char *)&next,
+                        1); /* one byte is enough */
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
+    }
   return 1;
 #else
-  to_read = sizeof buffer;
-  read_p = (char *)&buffer;
+  size_t const to_read = sizeof buffer;
+  char * const read_p = (char *)&buffer;
 
   ssize_t n = ACE::recv (handle, read_p, to_read);
 
@@ -264,6 +309,11 @@ ACE_Dev_Poll_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
             return -1;
         }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      if (this->dp_reactor_->instrumentation () != 0)
+        this->dp_reactor_->instrumentation ()->notify_dequeued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       return 1;
     }
 
@@ -318,6 +368,15 @@ ACE_Dev_Poll_Reactor_Notify::dispatch_notify (ACE_Notification_Buffer &buffer)
       // now. The guard insures that it is decremented properly.
       ACE_Dev_Poll_Handler_Guard eh_guard (buffer.eh_, false);
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      ACE_Reactor_Instrumentation *const instrumentation =
+        this->dp_reactor_->instrumentation ();
+      ACE_hrtime_t const start =
+        instrumentation == 0 ? 0 : instrumentation->start ();
+      const char *const type =
+        instrumentation == 0 ? 0 : instrumentation->handler_type (buffer.eh_);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       switch (buffer.mask_)
         {
         case ACE_Event_Handler::READ_MASK:
@@ -336,6 +395,14 @@ ACE_Dev_Poll_Reactor_Notify::dispatch_notify (ACE_Notification_Buffer &buffer)
                       ACE_TEXT ("dispatch_notify invalid mask = %d\n"),
                       buffer.mask_));
         }
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      if (instrumentation != 0)
+        instrumentation->upcall (ACE_Reactor_Instrumentation::NOTIFY,
+                                 start,
+                                 type);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       if (result == -1)
         buffer.eh_->handle_close (ACE_INVALID_HANDLE, buffer.mask_);
     }
@@ -372,7 +439,16 @@ ACE_Dev_Poll_Reactor_Notify::purge_pending_notifications (
 
 #if defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE)
 
-  return notification_queue_.purge_pending_notifications (eh, mask);
+  int const n = notification_queue_.purge_pending_notifications (eh, mask);
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (n > 0
+      && this->dp_reactor_ != 0
+      && this->dp_reactor_->instrumentation () != 0)
+    this->dp_reactor_->instrumentation ()->notify_dequeued (n);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
+  return n;
 
 #else /* defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE) */
   ACE_UNUSED_ARG (eh);
@@ -583,11 +659,16 @@ ACE_Dev_Poll_Reactor::ACE_Dev_Poll_Reactor (ACE_Sig_Handler *sh,
   : initialized_ (false)
   , poll_fd_ (ACE_INVALID_HANDLE)
   // , ready_set_ ()
-#if defined (ACE_HAS_DEV_POLL)
+#if defined (ACE_HAS_EVENT_POLL)
+  , events_ (0)
+  , start_pevents_ (0)
+  , end_pevents_ (0)
+  , max_events_ (ACE_DEFAULT_DEV_POLL_EVENTS_PER_WAIT)
+#else
   , dp_fds_ (0)
   , start_pfds_ (0)
   , end_pfds_ (0)
-#endif  /* ACE_HAS_DEV_POLL */
+#endif  /* ACE_HAS_EVENT_POLL */
   , token_ (*this, s_queue)
   , lock_adapter_ (token_)
   , deactivated_ (0)
@@ -599,6 +680,9 @@ ACE_Dev_Poll_Reactor::ACE_Dev_Poll_Reactor (ACE_Sig_Handler *sh,
   , delete_notify_handler_ (false)
   , mask_signals_ (mask_signals)
   , restart_ (0)
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  , instrumentation_ (0)
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
 {
   ACE_TRACE ("ACE_Dev_Poll_Reactor::ACE_Dev_Poll_Reactor");
 
@@ -626,11 +710,16 @@ ACE_Dev_Poll_Reactor::ACE_Dev_Poll_Reactor (size_t size,
   : initialized_ (false)
   , poll_fd_ (ACE_INVALID_HANDLE)
   // , ready_set_ ()
-#if defined (ACE_HAS_DEV_POLL)
+#if defined (ACE_HAS_EVENT_POLL)
+  , events_ (0)
+  , start_pevents_ (0)
+  , end_pevents_ (0)
+  , max_events_ (ACE_DEFAULT_DEV_POLL_EVENTS_PER_WAIT)
+#else
   , dp_fds_ (0)
   , start_pfds_ (0)
   , end_pfds_ (0)
-#endif  /* ACE_HAS_DEV_POLL */
+#endif  /* ACE_HAS_EVENT_POLL */
   , token_ (*this, s_queue)
   , lock_adapter_ (token_)
   , deactivated_ (0)
@@ -642,6 +731,9 @@ ACE_Dev_Poll_Reactor::ACE_Dev_Poll_Reactor (size_t size,
   , delete_notify_handler_ (false)
   , mask_signals_ (mask_signals)
   , restart_ (0)
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  , instrumentation_ (0)
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
 {
   if (this->open (size,
                   rs,
@@ -678,11 +770,6 @@ ACE_Dev_Poll_Reactor::open (size_t size,
   if (this->initialized_)
     return -1;
 
-#ifdef ACE_HAS_EVENT_POLL
-  ACE_OS::memset (&this->event_, 0, sizeof (this->event_));
-  this->event_.data.fd = ACE_INVALID_HANDLE;
-#endif /* ACE_HAS_EVENT_POLL */
-
   this->restart_ = restart;
   this->signal_handler_ = sh;
   this->timer_queue_ = tq;
@@ -731,6 +818,13 @@ ACE_Dev_Poll_Reactor::open (size_t size,
 
 #if defined (ACE_HAS_EVENT_POLL)
 
+  // Allocate the array before opening the device to avoid a potential
+  // resource leak if allocation fails.
+  ACE_NEW_RETURN (this->events_,
+                  epoll_event[this->max_events_],
+                  -1);
+  this->start_pevents_ = this->end_pevents_ = this->events_;
+
   // Initialize epoll:
   this->poll_fd_ = ::epoll_create (size);
   if (this->poll_fd_ == -1)
@@ -831,8 +925,10 @@ ACE_Dev_Poll_Reactor::close (void)
 
 #if defined (ACE_HAS_EVENT_POLL)
 
-  ACE_OS::memset (&this->event_, 0, sizeof (this->event_));
-  this->event_.data.fd = ACE_INVALID_HANDLE;
+  delete [] this->events_;
+  this->events_ = 0;
+  this->start_pevents_ = 0;
+  this->end_pevents_ = 0;
 
 #else
 
@@ -915,7 +1011,7 @@ ACE_Dev_Poll_Reactor::work_pending_i (ACE_Time_Value * max_wait_time)
     return 0;
 
 #if defined (ACE_HAS_EVENT_POLL)
-  if (this->event_.data.fd != ACE_INVALID_HANDLE)
+  if (this->start_pevents_ != this->end_pevents_)
 #else
   if (this->start_pfds_ != this->end_pfds_)
 #endif /* ACE_HAS_EVENT_POLL */
@@ -937,14 +1033,29 @@ ACE_Dev_Poll_Reactor::work_pending_i (ACE_Time_Value * max_wait_time)
      ? -1 /* Infinity */
      : static_cast<long> (this_timeout->msec ()));
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_hrtime_t const start =
+    this->instrumentation_ == 0 ? 0 : this->instrumentation_->start ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 #if defined (ACE_HAS_EVENT_POLL)
 
-  // Wait for an event.
+  // Wait for events.
   int const nfds = ::epoll_wait (this->poll_fd_,
-                                 &this->event_,
-                                 1,
+                                 this->events_,
+                                 this->max_events_,
                                  static_cast<int> (timeout));
 
+  // If nfds == 0 then end_pevents_ == start_pevents_ meaning that
+  // there is no work pending.  The repo lock is taken since
+  // remove_handler_i() discards harvested events for removed handles.
+  if (nfds > 0)
+    {
+      ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, grd, this->repo_lock_, -1);
+      this->start_pevents_ = this->events_;
+      this->end_pevents_ = this->events_ + nfds;
+    }
+
 #else
 
   struct dvpoll dvp;
@@ -966,6 +1077,11 @@ ACE_Dev_Poll_Reactor::work_pending_i (ACE_Time_Value * max_wait_time)
     this->end_pfds_ = this->start_pfds_ + nfds;
 #endif  /* ACE_HAS_EVENT_POLL */
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (this->instrumentation_ != 0)
+    this->instrumentation_->waited (start);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   // If timers are pending, override any timeout from the poll.
   return (nfds == 0 && timers_pending != 0 ? 1 : nfds);
 }
@@ -1076,6 +1192,28 @@ ACE_Dev_Poll_Reactor::dispatch_timer_handler (Token_Guard &guard)
   typedef ACE_Member_Function_Command<Token_Guard> Guard_Release;
 
   Guard_Release release(guard, &Token_Guard::release_token);
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_Reactor_Instrumentation *const instrumentation =
+    this->instrumentation_;
+  if (instrumentation != 0 && !this->timer_queue_->is_empty ())
+    {
+      // We hold the token, so the earliest timer is the one
+      // expire_single() dispatches, if it is due.
+      ACE_Time_Value const now = this->timer_queue_->gettimeofday ();
+      ACE_Time_Value const expiry = this->timer_queue_->earliest_time ();
+      ACE_hrtime_t const start = instrumentation->start ();
+      int const result = this->timer_queue_->expire_single(release);
+      if (result > 0)
+        {
+          instrumentation->timer_expired (expiry, now);
+          instrumentation->upcall (ACE_Reactor_Instrumentation::TIMEOUT,
+                                   start);
+        }
+      return result;
+    }
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   return this->timer_queue_->expire_single(release);
 }
 
@@ -1126,14 +1264,13 @@ ACE_Dev_Poll_Reactor::dispatch_io_event (Token_Guard &guard)
 #endif /* ACE_HAS_EVENT_POLL */
 
 #if defined (ACE_HAS_EVENT_POLL)
-  // epoll_wait() pulls one event which is stored in event_. If the handle
-  // is invalid, there's no event there. Else process it. In any event, we
-  // have the event, so clear event_ for the next thread.
-  const ACE_HANDLE handle = this->event_.data.fd;
-  __uint32_t revents      = this->event_.events;
-  this->event_.data.fd = ACE_INVALID_HANDLE;
-  this->event_.events = 0;
-  if (handle != ACE_INVALID_HANDLE)
+  // epoll_wait() pulls up to max_events_ events which are stored in
+  // events_. Take the next one, if any, and step past it (with the repo
+  // lock held, below) so the next thread to get the token moves on to
+  // the following event without polling again.
+  ACE_HANDLE handle = ACE_INVALID_HANDLE;
+  __uint32_t revents = 0;
+  if (this->start_pevents_ != this->end_pevents_)
 
 #else
   // Since the underlying event demultiplexing mechansim (`/dev/poll'
@@ -1174,10 +1311,27 @@ ACE_Dev_Poll_Reactor::dispatch_io_event (Token_Guard &guard)
       bool reactor_resumes_eh = false;
       {
         ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, grd, this->repo_lock_, -1);
+#if defined (ACE_HAS_EVENT_POLL)
+        handle  = this->start_pevents_->data.fd;
+        revents = this->start_pevents_->events;
+        ++this->start_pevents_;
+
+        // The event was discarded by remove_handler_i() after it was
+        // harvested.
+        if (handle == ACE_INVALID_HANDLE)
+          return 0;
+#endif /* ACE_HAS_EVENT_POLL */
         info = this->handler_rep_.find (handle);
         if (info == 0)   // No registered handler any longer
           return 0;
 
+#if defined (ACE_HAS_EVENT_POLL)
+        // The handler was suspended after its event was harvested;
+        // resuming it will re-arm the handle, so drop the event.
+        if (info->suspended)
+          return 0;
+#endif /* ACE_HAS_EVENT_POLL */
+
         // Figure out what to do first in order to make it easier to manage
         // the bit twiddling and possible pfds increment before releasing
         // the token for dispatch.
@@ -1281,7 +1435,21 @@ ACE_Dev_Poll_Reactor::dispatch_io_event (Token_Guard &guard)
         // returns the number of notfies dispatched, not an indication of
         // re-callback requested). If anything other than the notify, come
         // back with either 0 or < 0.
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+        ACE_hrtime_t const start =
+          this->instrumentation_ == 0 ? 0 : this->instrumentation_->start ();
+        const char *const type =
+          this->instrumentation_ == 0 ? 0 : this->instrumentation_->handler_type (eh);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
         status = this->upcall (eh, callback, handle);
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+        if (this->instrumentation_ != 0)
+          this->instrumentation_->upcall (
+            ACE_Reactor_Instrumentation::upcall_type (disp_mask),
+            start,
+            type,
+            handle);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
 
         // If the callback returned 0, epoll-based needs to resume the
         // suspended handler but dev/poll doesn't.
@@ -1611,7 +1779,19 @@ ACE_Dev_Poll_Reactor::remove_handler_i (ACE_HANDLE handle,
   // If there are no longer any outstanding events on the given handle
   // then remove it from the handler repository.
   if (!handle_reg_changed && info->mask == ACE_Event_Handler::NULL_MASK)
-    this->handler_rep_.unbind (handle, requires_reference_counting);
+    {
+      this->handler_rep_.unbind (handle, requires_reference_counting);
+
+#if defined (ACE_HAS_EVENT_POLL)
+      // Discard any event already harvested for the handle so it is not
+      // dispatched to whatever is registered on the handle next.
+      for (struct epoll_event *e = this->start_pevents_;
+           e != this->end_pevents_;
+           ++e)
+        if (e->data.fd == handle)
+          e->data.fd = ACE_INVALID_HANDLE;
+#endif /* ACE_HAS_EVENT_POLL */
+    }
 
   return 0;
 }
@@ -2220,6 +2400,57 @@ ACE_Dev_Poll_Reactor::requeue_position (void)
   ACE_NOTSUP_RETURN (-1);
 }
 
+int
+ACE_Dev_Poll_Reactor::max_events_per_wait (int n)
+{
+  ACE_TRACE ("ACE_Dev_Poll_Reactor::max_events_per_wait");
+
+#if defined (ACE_HAS_EVENT_POLL)
+  if (n < 1)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_MT (ACE_GUARD_RETURN (ACE_Dev_Poll_Reactor_Token, mon, this->token_, -1));
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, grd, this->repo_lock_, -1);
+
+  // Don't lose events that were harvested but not yet dispatched.
+  if (this->start_pevents_ != this->end_pevents_)
+    {
+      errno = EBUSY;
+      return -1;
+    }
+
+  // The array is only allocated once the reactor is opened.
+  if (this->events_ != 0)
+    {
+      struct epoll_event *events = 0;
+      ACE_NEW_RETURN (events, epoll_event[n], -1);
+      delete [] this->events_;
+      this->events_ = events;
+      this->start_pevents_ = this->end_pevents_ = this->events_;
+    }
+
+  this->max_events_ = n;
+
+  return 0;
+#else
+  ACE_UNUSED_ARG (n);
+  ACE_NOTSUP_RETURN (-1);
+#endif /* ACE_HAS_EVENT_POLL */
+}
+
+int
+ACE_Dev_Poll_Reactor::max_events_per_wait (void) const
+{
+#if defined (ACE_HAS_EVENT_POLL)
+  return this->max_events_;
+#else
+  return static_cast<int> (this->handler_rep_.max_size ());
+#endif /* ACE_HAS_EVENT_POLL */
+}
+
 int
 ACE_Dev_Poll_Reactor::mask_ops (ACE_Event_Handler *event_handler,
                                 ACE_Reactor_Mask mask,
@@ -2414,6 +2645,11 @@ ACE_Dev_Poll_Reactor::dump (void) const
               this->initialized_));
   ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("poll_fd_ = %d"), this->poll_fd_));
   ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("size_ = %u"), this->handler_rep_.size ()));
+#if defined (ACE_HAS_EVENT_POLL)
+  ACELIB_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("max_events_ = %d"),
+              this->max_events_));
+#endif /* ACE_HAS_EVENT_POLL */
   ACELIB_DEBUG ((LM_DEBUG,
               ACE_TEXT ("deactivated_ = %d"),
               this->deactivated_));
@@ -52,6 +52,9 @@ ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 // Forward declarations
 class ACE_Sig_Handler;
 class ACE_Dev_Poll_Reactor;
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+class ACE_Reactor_Instrumentation;
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
 
 
 // ---------------------------------------------------------------------
@@ -182,7 +185,11 @@ protected:
    * on, as well as the ACE_HANDLE that threads wanting the attention
    * of the ACE_Dev_Poll_Reactor will write to.
    */
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  ACE_Notification_Event notification_pipe_;
+#else
   ACE_Pipe notification_pipe_;
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 
   /**
    * Keeps track of the maximum number of times that the
@@ -204,8 +211,15 @@ protected:
    * the events in user-space.  The pipe is still needed to wake up
    * the reactor thread, but only one event is sent through the pipe
    * at a time.
+   *
+   * With an eventfd instead of the pipe, the queue is lock-free and
+   * notify() only signals the eventfd when it was empty.
    */
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  ACE_Notification_Queue_Lock_Free notification_queue_;
+#else
   ACE_Notification_Queue notification_queue_;
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 #endif /* ACE_HAS_REACTOR_NOTIFICATION_QUEUE */
 };
 
@@ -660,6 +674,15 @@ public:
   /// the application.
   virtual int resumable_handler (void);
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  /// Record the latencies of this reactor in @a instrumentation, or
+  /// stop recording them if it is 0.  This must be done before the
+  /// event loop is run, and @a instrumentation must outlive the
+  /// reactor.
+  void instrumentation (ACE_Reactor_Instrumentation *instrumentation);
+  ACE_Reactor_Instrumentation *instrumentation (void) const;
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   /// Return true if we any event associations were made by the reactor
   /// for the handles that it waits on, false otherwise.
   virtual bool uses_event_associations (void);
@@ -858,6 +881,28 @@ public:
    */
   virtual int requeue_position (void);
 
+  /// Set the maximum number of events harvested by a single
+  /// epoll_wait() call.
+  /**
+   * By default only one event is retrieved per call, relying on the
+   * kernel for fairness between handles.  A larger value lets the
+   * threads running the event loop take the remaining harvested
+   * events one at a time, leader/follower style, without re-entering
+   * the kernel.  Each harvested handle is still suspended (via
+   * @c EPOLLONESHOT) until its upcall completes.
+   *
+   * @return 0 on success, -1 on failure.  @c errno is set to
+   *         @c EBUSY if harvested events are still waiting to be
+   *         dispatched.
+   *
+   * @note Only supported when using epoll; `/dev/poll' always
+   *       retrieves all ready events.
+   */
+  int max_events_per_wait (int n);
+
+  /// Get the maximum number of events harvested by a single wait.
+  int max_events_per_wait (void) const;
+
   /**
    * @name Low-level wait_set mask manipulation methods
    *
@@ -1014,12 +1059,29 @@ protected:
   ACE_HANDLE poll_fd_;
 
 #if defined (ACE_HAS_EVENT_POLL)
-  /// Event structure to be filled by epoll_wait. epoll_wait() only gets
-  /// one event at a time and we rely on it's internals for fairness.
-  /// If this struct's fd is ACE_INVALID_HANDLE, the rest is indeterminate.
-  /// If the fd is good, the event is one that's been retrieved by
-  /// epoll_wait() but not yet processed.
-  struct epoll_event event_;
+  /// Event array to be filled by epoll_wait().  By default epoll_wait()
+  /// only gets one event at a time and we rely on it's internals for
+  /// fairness; see max_events_per_wait().
+  struct epoll_event *events_;
+
+  /// Pointer to the next harvested event that has not yet been
+  /// dispatched.  An entry whose fd is ACE_INVALID_HANDLE was
+  /// discarded because its handler was removed before dispatch.
+  /**
+   * Both the token and @c repo_lock_ must be held to move this
+   * pointer.
+   */
+  struct epoll_event *start_pevents_;
+
+  /// The last harvested event plus one.
+  /**
+   * Once this->start_pevents_ == this->end_pevents_ all harvested
+   * events have been dispatched and epoll_wait() is called again.
+   */
+  struct epoll_event *end_pevents_;
+
+  /// Number of elements in the @c events_ array.
+  int max_events_;
 
 #else
   /// The pollfd array that `/dev/poll' will feed its results to.
@@ -1093,6 +1155,11 @@ protected:
   /// via an EINTR signal.
   bool restart_;
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  /// Where latencies are recorded, 0 if they are not.
+  ACE_Reactor_Instrumentation *instrumentation_;
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 protected:
 
   /**
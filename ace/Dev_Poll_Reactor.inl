@@ -90,6 +90,21 @@ ACE_Dev_Poll_Reactor::upcall (ACE_Event_Handler *event_handler,
   return status;
 }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+ACE_INLINE void
+ACE_Dev_Poll_Reactor::instrumentation (
+  ACE_Reactor_Instrumentation *instrumentation)
+{
+  this->instrumentation_ = instrumentation;
+}
+
+ACE_INLINE ACE_Reactor_Instrumentation *
+ACE_Dev_Poll_Reactor::instrumentation (void) const
+{
+  return this->instrumentation_;
+}
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 
 /************************************************************************/
 // Methods for ACE_Dev_Poll_Reactor::Token_Guard
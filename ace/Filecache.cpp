@@ -5,12 +5,19 @@
 #include "ace/Log_Category.h"
 #include "ace/ACE.h"
 #include "ace/Guard_T.h"
+#include "ace/RW_Thread_Mutex.h"
 #include "ace/OS_NS_string.h"
 #include "ace/OS_NS_time.h"
 #include "ace/OS_NS_unistd.h"
 #include "ace/OS_NS_fcntl.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_sys_sendfile.h"
 #include "ace/Truncate.h"
 
+#if defined (ACE_HAS_INOTIFY)
+# include <sys/inotify.h>
+#endif /* ACE_HAS_INOTIFY */
+
 #if defined (ACE_WIN32)
 // Specifies no sharing flags.
 #define R_MASK ACE_DEFAULT_OPEN_PERMS
@@ -118,6 +125,20 @@ ACE_Filecache_Handle::handle (void) const
   return this->handle_;
 }
 
+ssize_t
+ACE_Filecache_Handle::sendfile (ACE_HANDLE out_fd,
+                                off_t *offset,
+                                size_t count) const
+{
+  if (this->file_ == 0 || this->file_->handle () == ACE_INVALID_HANDLE)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return ACE_OS::sendfile (out_fd, this->file_->handle (), offset, count);
+}
+
 int
 ACE_Filecache_Handle::error (void) const
 {
@@ -226,81 +247,227 @@ ACE_Filecache::instance (void)
 
 ACE_Filecache::ACE_Filecache (void)
   : size_ (ACE_DEFAULT_VIRTUAL_FILESYSTEM_TABLE_SIZE),
-    hash_ (size_)
+    hash_ (size_),
+    hand_ (0),
+    max_size_ (static_cast<ACE_OFF_T> (ACE_DEFAULT_VIRTUAL_FILESYSTEM_CACHE_SIZE)
+               * 1024 * 1024),
+    cached_size_ (0),
+    generation_ (0),
+    inotify_ (ACE_INVALID_HANDLE)
 {
+#if defined (ACE_HAS_INOTIFY)
+  this->inotify_ = ::inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+#endif /* ACE_HAS_INOTIFY */
 }
 
 ACE_Filecache::~ACE_Filecache (void)
 {
+  this->purge ();
+
+  if (this->inotify_ != ACE_INVALID_HANDLE)
+    ACE_OS::close (this->inotify_);
 }
 
-ACE_Filecache_Object *
-ACE_Filecache::insert_i (const ACE_TCHAR *filename,
-                         ACE_SYNCH_RW_MUTEX &filelock,
-                         int mapit)
+int
+ACE_Filecache::watch (const ACE_TCHAR *filename)
+{
+#if defined (ACE_HAS_INOTIFY)
+  if (this->inotify_ != ACE_INVALID_HANDLE)
+    // A change of the link count tells that the file was removed or
+    // replaced, which does not delete it while it is open.
+    return ::inotify_add_watch (this->inotify_,
+                                ACE_TEXT_ALWAYS_CHAR (filename),
+                                IN_MODIFY | IN_ATTRIB
+                                | IN_MOVE_SELF | IN_DELETE_SELF);
+#else
+  ACE_UNUSED_ARG (filename);
+#endif /* ACE_HAS_INOTIFY */
+  return -1;
+}
+
+void
+ACE_Filecache::unwatch_i (int wd, bool cached)
 {
-  ACE_Filecache_Object *handle = 0;
+  if (wd == -1)
+    return;
 
-  if (this->hash_.find (filename, handle) == -1)
+  size_t files = 0;
+  if (this->watches_.find (wd, files) == 0)
     {
-      ACE_NEW_RETURN (handle,
-                      ACE_Filecache_Object (filename, filelock, 0, mapit),
-                      0);
-
-      //      ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("   (%t) CVF: creating %s\n"), filename));
-
-      if (this->hash_.bind (filename, handle) == -1)
+      if (!cached)
+        return;
+      if (--files > 0)
         {
-          delete handle;
-          handle = 0;
+          this->watches_.rebind (wd, files);
+          return;
         }
+      this->watches_.unbind (wd);
     }
-  else
-    handle = 0;
 
-  return handle;
+#if defined (ACE_HAS_INOTIFY)
+  ::inotify_rm_watch (this->inotify_, wd);
+#endif /* ACE_HAS_INOTIFY */
 }
 
-ACE_Filecache_Object *
-ACE_Filecache::remove_i (const ACE_TCHAR *filename)
+void
+ACE_Filecache::invalidate_i (void)
 {
-  ACE_Filecache_Object *handle = 0;
+#if defined (ACE_HAS_INOTIFY)
+  if (this->inotify_ == ACE_INVALID_HANDLE)
+    return;
 
-  // Disassociate file from the cache.
-  if (this->hash_.unbind (filename, handle) == 0)
+  union
+  {
+    struct inotify_event event_;
+    char buf_[4096];
+  } events;
+
+  for (;;)
     {
-      handle->stale_ = 1;
+      ssize_t const n = ACE_OS::read (this->inotify_,
+                                      events.buf_,
+                                      sizeof events.buf_);
+      if (n <= 0)
+        break;
+
+      for (ssize_t i = 0; i < n; )
+        {
+          const struct inotify_event *event =
+            reinterpret_cast<const struct inotify_event *> (events.buf_ + i);
+          i += sizeof (struct inotify_event) + event->len;
+
+          // Even IN_IGNORED, which tells that a watch was removed,
+          // counts: a fetch() may have been given the same watch for
+          // a link to the file before it took the lock, and must not
+          // cache with it.
+          ++this->generation_;
+
+          if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+              // Changes were lost.
+              while (this->hand_ != 0)
+                this->remove_i (this->hand_);
+              continue;
+            }
+
+          // Files that are links to the same inode share the watch.
+          size_t files = 0;
+          if (this->watches_.find (event->wd, files) != 0)
+            continue;
+
+          ACE_Filecache_Object *file = this->hand_;
+          for (size_t left = this->hash_.current_size (); left > 0; --left)
+            {
+              ACE_Filecache_Object *const next = file->next_;
+              if (file->wd_ == event->wd)
+                this->remove_i (file);
+              file = next;
+            }
+        }
+    }
+#endif /* ACE_HAS_INOTIFY */
+}
+
+void
+ACE_Filecache::evict_i (ACE_OFF_T size)
+{
+  while (this->hand_ != 0 && this->cached_size_ + size > this->max_size_)
+    {
+      ACE_Filecache_Object *const file = this->hand_;
 
-      // Try a lock.  If it succeeds, we can delete it now.
-      // Otherwise, it will clean itself up later.
-      if (handle->lock_.tryacquire_write () == 0)
+      if (file->referenced_)
         {
-          delete handle;
-          handle = 0;
+          // Fetched since the hand last went past: second chance.
+          file->referenced_ = false;
+          this->hand_ = file->next_;
         }
+      else
+        this->remove_i (file);
+    }
+}
+
+int
+ACE_Filecache::insert_i (ACE_Filecache_Object *file,
+                         unsigned long generation)
+{
+  if (file->size_ > this->max_size_ || generation != this->generation_)
+    return -1;
+
+  // Count the watch first, so that evicting a link to the file does
+  // not remove it.
+  if (file->wd_ != -1)
+    {
+      size_t files = 0;
+      this->watches_.find (file->wd_, files);
+      this->watches_.rebind (file->wd_, files + 1);
+    }
+
+  this->evict_i (file->size_);
+
+  if (this->hash_.bind (file->filename_, file) != 0)
+    {
+      this->unwatch_i (file->wd_, true);
+      return -1;
+    }
+
+  // Put it just behind the hand, so it is the last one looked at.
+  if (this->hand_ == 0)
+    {
+      file->next_ = file->prev_ = file;
+      this->hand_ = file;
     }
   else
-    handle = 0;
+    {
+      file->next_ = this->hand_;
+      file->prev_ = this->hand_->prev_;
+      file->prev_->next_ = file;
+      this->hand_->prev_ = file;
+    }
 
-  return handle;
+  // Only a file fetched again gets a second chance.
+  file->referenced_ = false;
+  this->cached_size_ += file->size_;
+
+  return 0;
 }
 
 ACE_Filecache_Object *
-ACE_Filecache::update_i (const ACE_TCHAR *filename,
-                         ACE_SYNCH_RW_MUTEX &filelock,
-                         int mapit)
+ACE_Filecache::remove_i (ACE_Filecache_Object *file)
 {
-  ACE_Filecache_Object *handle = 0;
+  // Disassociate file from the cache.
+  this->hash_.unbind (file->filename_);
 
-  handle = this->remove_i (filename);
-  handle = this->insert_i (filename, filelock, mapit);
+  if (file->next_ == file)
+    this->hand_ = 0;
+  else
+    {
+      if (this->hand_ == file)
+        this->hand_ = file->next_;
+      file->prev_->next_ = file->next_;
+      file->next_->prev_ = file->prev_;
+    }
+  file->next_ = file->prev_ = 0;
 
-  return handle;
+  this->cached_size_ -= file->size_;
+  this->unwatch_i (file->wd_, true);
+  file->wd_ = -1;
+  file->stale_ = 1;
+
+  // The last one using it deletes it otherwise.
+  if (file->reference_count_ == 0)
+    {
+      delete file;
+      file = 0;
+    }
+
+  return file;
 }
 
 int
 ACE_Filecache::find (const ACE_TCHAR *filename)
 {
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+
   return this->hash_.find (filename);
 }
 
@@ -310,19 +477,10 @@ ACE_Filecache::remove (const ACE_TCHAR *filename)
 {
   ACE_Filecache_Object *handle = 0;
 
-  ACE_OFF_T loc = ACE::hash_pjw (filename) % this->size_;
-  ACE_SYNCH_RW_MUTEX &hashlock = this->hash_lock_[loc];
-  // ACE_SYNCH_RW_MUTEX &filelock = this->file_lock_[loc];
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
 
   if (this->hash_.find (filename, handle) != -1)
-    {
-      ACE_WRITE_GUARD_RETURN (ACE_SYNCH_RW_MUTEX,
-                              ace_mon,
-                              hashlock,
-                              0);
-
-      return this->remove_i (filename);
-    }
+    return this->remove_i (handle);
 
   return 0;
 }
@@ -332,45 +490,80 @@ ACE_Filecache_Object *
 ACE_Filecache::fetch (const ACE_TCHAR *filename, int mapit)
 {
   ACE_Filecache_Object *handle = 0;
+  unsigned long generation = 0;
 
-  ACE_OFF_T loc = ACE::hash_pjw (filename) % this->size_;
-  ACE_SYNCH_RW_MUTEX &hashlock = this->hash_lock_[loc];
-  ACE_SYNCH_RW_MUTEX &filelock = this->file_lock_[loc];
+  {
+    ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
 
-  filelock.acquire_read ();
+    this->invalidate_i ();
 
-  if (this->hash_.find (filename, handle) == -1)
-    {
-      ACE_WRITE_GUARD_RETURN (ACE_SYNCH_RW_MUTEX,
-                              ace_mon,
-                              hashlock,
-                              0);
+    if (this->hash_.find (filename, handle) == 0)
+      {
+        // Unless the file is watched, see if it changed on disk.
+        if ((mapit == 0 || handle->mapped ())
+            && (handle->wd_ != -1 || !handle->update ()))
+          {
+            handle->referenced_ = true;
+            handle->acquire ();
+            return handle;
+          }
+
+        // Take the IN_IGNORED of its watch now, rather than as a
+        // change while the file is opened again.
+        this->remove_i (handle);
+        this->invalidate_i ();
+      }
+
+    generation = this->generation_;
+  }
+
+  // Open and map the file without holding the lock.  It is watched
+  // first, so a change after it is opened is not missed.
+  int const wd = this->watch (filename);
+
+  ACE_NEW_NORETURN (handle,
+                    ACE_Filecache_Object (filename, 0, mapit));
 
-      // Second check in the method call
-      handle = this->insert_i (filename, filelock, mapit);
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
 
-      if (handle == 0)
-        filelock.release ();
+  if (handle == 0)
+    {
+      this->unwatch_i (wd, false);
+      return 0;
     }
-  else
+
+  handle->wd_ = wd;
+  handle->acquire ();
+
+  this->invalidate_i ();
+
+  // Another thread may have cached it meanwhile.
+  ACE_Filecache_Object *cached = 0;
+  if (this->hash_.find (filename, cached) == 0
+      && (mapit == 0 || cached->mapped ()))
     {
-      if (handle->update ())
-        {
-          {
-            // Double check locking pattern
-            ACE_WRITE_GUARD_RETURN (ACE_SYNCH_RW_MUTEX,
-                                    ace_mon,
-                                    hashlock,
-                                    0);
+      cached->referenced_ = true;
+      cached->acquire ();
+      this->unwatch_i (wd, false);
+      delete handle;
+      return cached;
+    }
 
-            // Second check in the method call
-            handle = this->update_i (filename, filelock, mapit);
+  // Removing it may remove the watch it shares with handle.
+  if (cached != 0)
+    {
+      this->remove_i (cached);
+      this->invalidate_i ();
+    }
 
-            if (handle == 0)
-              filelock.release ();
-          }
-        }
-      //      ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("   (%t) CVF: found %s\n"), filename));
+  // A file that failed, does not fit, or may have changed since it
+  // was opened is handed out, but not cached.
+  if (handle->error_ != ACE_Filecache_Object::ACE_SUCCESS
+      || this->insert_i (handle, generation) != 0)
+    {
+      this->unwatch_i (wd, false);
+      handle->wd_ = -1;
+      handle->stale_ = 1;
     }
 
   return handle;
@@ -381,11 +574,11 @@ ACE_Filecache::create (const ACE_TCHAR *filename, int size)
 {
   ACE_Filecache_Object *handle = 0;
 
-  ACE_OFF_T loc = ACE::hash_pjw (filename) % this->size_;
-  ACE_SYNCH_RW_MUTEX &filelock = this->file_lock_[loc];
-
   ACE_NEW_RETURN (handle,
-                  ACE_Filecache_Object (filename, size, filelock),
+                  ACE_Filecache_Object (filename,
+                                        size,
+                                        ACE_Filecache_Object::ACE_WRITING,
+                                        0),
                   0);
   handle->acquire ();
 
@@ -398,62 +591,78 @@ ACE_Filecache::finish (ACE_Filecache_Object *&file)
   if (file == 0)
     return file;
 
-  ACE_OFF_T loc = ACE::hash_pjw (file->filename_) % this->size_;
-  ACE_SYNCH_RW_MUTEX &hashlock = this->hash_lock_[loc];
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
 
-  if (file != 0)
-    switch (file->action_)
+  file->release ();
+
+  switch (file->action_)
+    {
+    case ACE_Filecache_Object::ACE_WRITING:
       {
-      case ACE_Filecache_Object::ACE_WRITING:
+        // The copy cached, if any, is out of date.  A file written is
+        // not cached, the next fetch maps it anew.
+        ACE_Filecache_Object *cached = 0;
+        if (this->hash_.find (file->filename_, cached) == 0)
+          this->remove_i (cached);
+
+        delete file;
+        file = 0;
+      }
+      break;
+
+    default:
+      // Last one using a stale file is responsible for deleting it.
+      if (file->stale_ && file->reference_count_ == 0)
         {
-          ACE_WRITE_GUARD_RETURN (ACE_SYNCH_RW_MUTEX,
-                                  ace_mon,
-                                  hashlock,
-                                  0);
+          delete file;
+          file = 0;
+        }
+      break;
+    }
 
-          file->release ();
+  return file;
+}
 
-          this->remove_i (file->filename_);
-#if 0
-          int result = this->hash_.bind (file->filename (), file);
+ACE_OFF_T
+ACE_Filecache::max_size (void) const
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
 
-          if (result == 0)
-            file->acquire ();
-#else
-        // Last one using a stale file is resposible for deleting it.
-        if (file->stale_)
-          {
-            // Try a lock.  If it succeds, we can delete it now.
-            // Otherwise, it will clean itself up later.
-            if (file->lock_.tryacquire_write () == 0)
-              {
-                delete file;
-                file = 0;
-              }
-          }
-#endif
-        }
+  return this->max_size_;
+}
 
-        break;
-      default:
-        file->release ();
+void
+ACE_Filecache::max_size (ACE_OFF_T max_size)
+{
+  ACE_GUARD (ACE_SYNCH_MUTEX, ace_mon, this->lock_);
 
-        // Last one using a stale file is resposible for deleting it.
-        if (file->stale_)
-          {
-            // Try a lock.  If it succeds, we can delete it now.
-            // Otherwise, it will clean itself up later.
-            if (file->lock_.tryacquire_write () == 0)
-              {
-                delete file;
-                file = 0;
-              }
-          }
+  this->max_size_ = max_size;
+  this->evict_i (0);
+}
 
-        break;
-      }
+ACE_OFF_T
+ACE_Filecache::cached_size (void) const
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
 
-  return file;
+  return this->cached_size_;
+}
+
+size_t
+ACE_Filecache::current_size (void) const
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
+
+  return this->hash_.current_size ();
+}
+
+void
+ACE_Filecache::purge (void)
+{
+  ACE_GUARD (ACE_SYNCH_MUTEX, ace_mon, this->lock_);
+
+  while (this->hand_ != 0)
+    this->remove_i (this->hand_);
 }
 
 void
@@ -478,14 +687,16 @@ ACE_Filecache_Object::ACE_Filecache_Object (void)
     error_ (0),
     stale_ (0),
     // sa_ (),
-    junklock_ (),
-    lock_ (junklock_)
+    reference_count_ (0),
+    referenced_ (false),
+    next_ (0),
+    prev_ (0),
+    wd_ (-1)
 {
   this->init ();
 }
 
 ACE_Filecache_Object::ACE_Filecache_Object (const ACE_TCHAR *filename,
-                                            ACE_SYNCH_RW_MUTEX &lock,
                                             LPSECURITY_ATTRIBUTES sa,
                                             int mapit)
   : tempname_ (0),
@@ -497,8 +708,11 @@ ACE_Filecache_Object::ACE_Filecache_Object (const ACE_TCHAR *filename,
     error_ (0),
     stale_ (0),
     sa_ (sa),
-    junklock_ (),
-    lock_ (lock)
+    reference_count_ (0),
+    referenced_ (false),
+    next_ (0),
+    prev_ (0),
+    wd_ (-1)
 {
   this->init ();
 
@@ -554,14 +768,21 @@ ACE_Filecache_Object::ACE_Filecache_Object (const ACE_TCHAR *filename,
 
 ACE_Filecache_Object::ACE_Filecache_Object (const ACE_TCHAR *filename,
                                             ACE_OFF_T size,
-                                            ACE_SYNCH_RW_MUTEX &lock,
+                                            Creation_States state,
                                             LPSECURITY_ATTRIBUTES sa)
   : stale_ (0),
     sa_ (sa),
-    lock_ (lock)
+    reference_count_ (0),
+    referenced_ (false),
+    next_ (0),
+    prev_ (0),
+    wd_ (-1)
 {
   this->init ();
 
+  ACE_ASSERT (state == ACE_Filecache_Object::ACE_WRITING);
+  ACE_UNUSED_ARG (state);
+
   this->size_ = size;
   ACE_OS::strcpy (this->filename_, filename);
   this->action_ = ACE_Filecache_Object::ACE_WRITING;
@@ -616,14 +837,13 @@ ACE_Filecache_Object::~ACE_Filecache_Object (void)
       ACE_OS::close (this->handle_);
       this->handle_ = ACE_INVALID_HANDLE;
     }
-
-  this->lock_.release ();
 }
 
 int
 ACE_Filecache_Object::acquire (void)
 {
-  return this->lock_.tryacquire_read ();
+  ++this->reference_count_;
+  return 0;
 }
 
 int
@@ -678,7 +898,8 @@ ACE_Filecache_Object::release (void)
 #endif
     }
 
-  return this->lock_.release ();
+  --this->reference_count_;
+  return 0;
 }
 
 int
@@ -725,6 +946,12 @@ ACE_Filecache_Object::address (void) const
   return this->mmap_.addr ();
 }
 
+int
+ACE_Filecache_Object::mapped (void) const
+{
+  return this->mmap_.addr () != MAP_FAILED;
+}
+
 int
 ACE_Filecache_Object::update (void) const
 {
@@ -25,7 +25,7 @@
 #include "ace/Hash_Map_Manager_T.h"
 #include "ace/Null_Mutex.h"
 #include "ace/Synch_Traits.h"
-#include "ace/RW_Thread_Mutex.h"
+#include "ace/Thread_Mutex.h"
 #include "ace/OS_NS_sys_stat.h"
 
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
@@ -69,6 +69,12 @@ class ACE_Filecache_Object;
  * ACE_Filecache_Handle foo("foo.html", content_length);
  * this->peer ().recv (foo.address (), content_length);
  * }
+ * E.g. 4,
+ * {
+ * ACE_Filecache_Handle foo("foo.html", ACE_NOMAP);
+ * off_t offset = 0;
+ * foo.sendfile (this->peer ().get_handle (), &offset, foo.size ());
+ * }
  * TODO:
  */
 class ACE_Export ACE_Filecache_Handle
@@ -111,9 +117,20 @@ public:
   /// Base address of memory mapped file.
   void *address (void) const;
 
-  /// A handle (e.g., UNIX file descriptor, or NT file handle).
+  /// A handle (e.g., UNIX file descriptor, or NT file handle).  It
+  /// is dup'd from that of the cached file, and closed with this.
   ACE_HANDLE handle (void) const;
 
+  /**
+   * Send @a count bytes of the file from @a offset to @a out_fd with
+   * ACE_OS::sendfile(), straight from the page cache where the
+   * platform allows, and advance @a offset by the bytes sent.  The
+   * handle of the cached file is used as is, since sendfile() does
+   * not move its file offset, so many threads may send the same file
+   * at once.  Returns the bytes sent or -1.
+   */
+  ssize_t sendfile (ACE_HANDLE out_fd, off_t *offset, size_t count) const;
+
   /// Any associated error in handle creation and acquisition.
   int error (void) const;
 
@@ -153,6 +170,9 @@ typedef ACE_Hash_Map_Manager_Ex<const ACE_TCHAR *, ACE_Filecache_Object *, ACE_H
 
 typedef ACE_Hash_Map_Entry<const ACE_TCHAR *, ACE_Filecache_Object *> ACE_Filecache_Hash_Entry;
 
+typedef ACE_Hash_Map_Manager_Ex<int, size_t, ACE_Hash<int>, ACE_Equal_To<int>, ACE_Null_Mutex>
+        ACE_Filecache_Watches;
+
 /**
  * @class ACE_Filecache
  *
@@ -161,6 +181,21 @@ typedef ACE_Hash_Map_Entry<const ACE_TCHAR *, ACE_Filecache_Object *> ACE_Fileca
  * the Cached Virtual Filesystem. On insertion, the reference
  * count is incremented. On destruction, reference count is
  * decremented.
+ *
+ * The files cached take max_size() bytes at most.  When a file does
+ * not fit, the files not fetched for the longest while are evicted,
+ * as a CLOCK approximation of LRU: each fetch marks its file, and the
+ * clock hand goes round the files, clearing the mark of those marked
+ * and evicting the first that is not.  A file that is in use when it
+ * is evicted is deleted when the last handle to it is released.  A
+ * file larger than max_size() is handed out but not cached.
+ *
+ * Where the platform has inotify (ACE_HAS_INOTIFY), a file changed,
+ * replaced or removed on disk is dropped from the cache by the next
+ * fetch() after the kernel tells, so a hit costs no system call but
+ * a read of the pending events.  Elsewhere, and for files that could
+ * not be watched, each hit stat()s the file and compares its
+ * modification time, as before.
  */
 class ACE_Export ACE_Filecache
 {
@@ -188,25 +223,52 @@ public:
   /// was deleted.
   ACE_Filecache_Object *finish (ACE_Filecache_Object *&new_file);
 
+  /// Get/set the most bytes of files to cache.  Setting it evicts
+  /// files until those cached fit.
+  ACE_OFF_T max_size (void) const;
+  void max_size (ACE_OFF_T max_size);
+
+  /// Bytes of the files cached.
+  ACE_OFF_T cached_size (void) const;
+
+  /// Number of files cached.
+  size_t current_size (void) const;
+
+  /// Evict all the files.
+  void purge (void);
+
 protected:
-  ACE_Filecache_Object *insert_i (const ACE_TCHAR *filename,
-                                  ACE_SYNCH_RW_MUTEX &filelock,
-                                  int mapit);
-  ACE_Filecache_Object *remove_i (const ACE_TCHAR *filename);
-  ACE_Filecache_Object *update_i (const ACE_TCHAR *filename,
-                                  ACE_SYNCH_RW_MUTEX &filelock,
-                                  int mapit);
+  /// Cache @a file, evicting others so it fits, unless it is larger
+  /// than max_size() or a file changed since @a generation.  Returns
+  /// 0 if it is cached.
+  int insert_i (ACE_Filecache_Object *file, unsigned long generation);
+
+  /// Drop @a file from the cache and delete it unless it is in use.
+  /// Returns @a file if it is still in use, else 0.
+  ACE_Filecache_Object *remove_i (ACE_Filecache_Object *file);
+
+  /// Evict files until @a size more bytes fit.
+  void evict_i (ACE_OFF_T size);
+
+  /// Drop the files changed on disk since the last call.
+  void invalidate_i (void);
+
+  /// Watch @a file for changes, returns the watch or -1.
+  int watch (const ACE_TCHAR *filename);
+
+  /// Stop watching with @a wd, which a file that was cached used if
+  /// @a cached, unless a file cached still uses it.
+  void unwatch_i (int wd, bool cached);
 
 public:
 
   enum
   {
-    /// For this stupid implementation, use an array.  Someday, use a
-    /// balanced search tree, or real hash table.
+    /// The number of buckets of the hash table.
     ACE_DEFAULT_VIRTUAL_FILESYSTEM_TABLE_SIZE = 512,
 
-    /// This determines the highwater mark in megabytes for the cache.
-    /// This will be ignored for now.
+    /// This determines the default highwater mark in megabytes for
+    /// the cache.
     ACE_DEFAULT_VIRTUAL_FILESYSTEM_CACHE_SIZE = 20
   };
 
@@ -223,9 +285,26 @@ private:
   /// The reference to the instance
   static ACE_Filecache *cvf_;
 
-  // = Synchronization variables.
-  ACE_SYNCH_RW_MUTEX hash_lock_[ACE_DEFAULT_VIRTUAL_FILESYSTEM_TABLE_SIZE];
-  ACE_SYNCH_RW_MUTEX file_lock_[ACE_DEFAULT_VIRTUAL_FILESYSTEM_TABLE_SIZE];
+  /// Protects the table, the clock and the reference counts of the
+  /// files.  No file is opened nor mapped while it is held.
+  mutable ACE_SYNCH_MUTEX lock_;
+
+  /// The files cached, in a circular list, and the clock hand, which
+  /// is 0 if there are none.
+  ACE_Filecache_Object *hand_;
+
+  ACE_OFF_T max_size_;
+  ACE_OFF_T cached_size_;
+
+  /// Count of the changes seen on disk and of the watches removed,
+  /// so a file opened while one was seen, or whose watch was removed
+  /// by another thread before it could be cached, is not cached.
+  unsigned long generation_;
+
+  /// The inotify instance, and the number of files cached for each of
+  /// its watches, which files sharing an inode share.
+  ACE_HANDLE inotify_;
+  ACE_Filecache_Watches watches_;
 };
 
 /**
@@ -242,25 +321,37 @@ class ACE_Export ACE_Filecache_Object
 public:
   friend class ACE_Filecache;
 
+  enum Creation_States
+  {
+    ACE_READING = 1,
+    ACE_WRITING = 2
+  };
+
   /// Creates a file for reading.
   ACE_Filecache_Object (const ACE_TCHAR *filename,
-                        ACE_SYNCH_RW_MUTEX &lock,
                         LPSECURITY_ATTRIBUTES sa = 0,
                         int mapit = 1);
 
-  /// Creates a file for writing.
+  /**
+   * Creates a file of @a size bytes for writing; @a state must be
+   * ACE_WRITING.  None of the arguments has a default, so that no
+   * call is taken for one of the constructor for reading, whose
+   * LPSECURITY_ATTRIBUTES is an int on most platforms.
+   */
   ACE_Filecache_Object (const ACE_TCHAR *filename,
                         ACE_OFF_T size,
-                        ACE_SYNCH_RW_MUTEX &lock,
-                        LPSECURITY_ATTRIBUTES sa = 0);
+                        Creation_States state,
+                        LPSECURITY_ATTRIBUTES sa);
 
   /// Only if reference count is zero should this be called.
   ~ACE_Filecache_Object (void);
 
-  /// Increment the reference_count_.
+  /// Increment the reference_count_.  ACE_Filecache calls it with its
+  /// lock held.
   int acquire (void);
 
-  /// Decrement the reference_count_.
+  /// Decrement the reference_count_, and unmap and close a file that
+  /// was written.  ACE_Filecache calls it with its lock held.
   int release (void);
 
   // = error_ accessors
@@ -283,6 +374,9 @@ public:
   /// True if file on disk is newer than cached file.
   int update (void) const;
 
+  /// True if the file is memory mapped.
+  int mapped (void) const;
+
 protected:
   /// Prevent from being called.
   ACE_Filecache_Object (void);
@@ -297,12 +391,6 @@ private:
 
 public:
 
-  enum Creation_States
-  {
-    ACE_READING = 1,
-    ACE_WRITING = 2
-  };
-
   enum Error_Conditions
   {
     ACE_SUCCESS = 0,
@@ -334,17 +422,25 @@ private:
   int action_;
   int error_;
 
-  /// If set to 1, means the object is flagged for removal.
+  /// If set to 1, means the object is flagged for removal, and is
+  /// not in the cache.
   int stale_;
 
   /// Security attribute object.
   LPSECURITY_ATTRIBUTES sa_;
 
-  /// The default initializer
-  ACE_SYNCH_RW_MUTEX junklock_;
-
   /// Provides a bookkeeping mechanism for users of this object.
-  ACE_SYNCH_RW_MUTEX &lock_;
+  long reference_count_;
+
+  /// Set by each fetch, cleared by the clock hand going past.
+  bool referenced_;
+
+  /// The next and previous files on the clock.
+  ACE_Filecache_Object *next_;
+  ACE_Filecache_Object *prev_;
+
+  /// The inotify watch of the file, or -1.
+  int wd_;
 };
 
 ACE_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,443 @@
+
+//=============================================================================
+/**
+ *  @file    Flat_Hash_Map_T.cpp
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+
+#ifndef ACE_FLAT_HASH_MAP_T_CPP
+#define ACE_FLAT_HASH_MAP_T_CPP
+
+#include "ace/Flat_Hash_Map_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if !defined (__ACE_INLINE__)
+# include "ace/Flat_Hash_Map_T.inl"
+#endif /* __ACE_INLINE__ */
+
+#include "ace/Malloc_Base.h"
+#include "ace/OS_NS_string.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+template <class EXT_ID, class INT_ID> void
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Flat_Hash_Map)
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("capacity_ = %B\n"), this->table_.capacity_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("size_ = %B\n"), this->table_.size_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("deleted_ = %B\n"), this->table_.deleted_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("old capacity_ = %B\n"), this->old_.capacity_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("old size_ = %B\n"), this->old_.size_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("migrate_group_ = %B\n"), this->migrate_group_));
+  if (this->table_allocator_ != 0)
+    this->table_allocator_->dump ();
+  this->lock_.dump ();
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::open (size_t size,
+                                                                           ACE_Allocator *table_alloc)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  // Release the previous table before allocating a new one.
+  this->close_i ();
+
+  if (table_alloc == 0)
+    table_alloc = ACE_Allocator::instance ();
+
+  this->table_allocator_ = table_alloc;
+
+  if (size == 0)
+    return -1;
+
+  return this->create_table (this->table_, capacity_for (size));
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::close_i (void)
+{
+  this->free_table (this->old_);
+  this->free_table (this->table_);
+  this->migrate_group_ = 0;
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind_all_i (void)
+{
+  this->free_table (this->old_);
+  this->migrate_group_ = 0;
+
+  Table &table = this->table_;
+  for (size_t i = 0; i < table.capacity_; ++i)
+    {
+      if (table.ctrl_[i] >= 0)
+        {
+          ENTRY *entry = table.slots_ + i;
+          ACE_DES_FREE_TEMPLATE2 (entry, ACE_NOOP,
+                                  ACE_Flat_Hash_Map_Entry, EXT_ID, INT_ID);
+        }
+      table.ctrl_[i] = static_cast<signed char> (CTRL_EMPTY);
+    }
+
+  table.size_ = 0;
+  table.deleted_ = 0;
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::create_table (Table &table,
+                                                                                   size_t capacity)
+{
+  if (this->table_allocator_ == 0)
+    this->table_allocator_ = ACE_Allocator::instance ();
+
+  // The control bytes follow the slots, in the same block.
+  void *ptr = 0;
+  ACE_ALLOCATOR_RETURN (ptr,
+                        this->table_allocator_->malloc (capacity * sizeof (ENTRY)
+                                                        + capacity),
+                        -1);
+
+  table.slots_ = reinterpret_cast<ENTRY *> (ptr);
+  table.ctrl_ = reinterpret_cast<signed char *> (table.slots_ + capacity);
+  table.capacity_ = capacity;
+  table.size_ = 0;
+  table.deleted_ = 0;
+  ACE_OS::memset (table.ctrl_, CTRL_EMPTY, capacity);
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::free_table (Table &table)
+{
+  if (table.capacity_ == 0)
+    return;
+
+  for (size_t i = 0; table.size_ > 0 && i < table.capacity_; ++i)
+    if (table.ctrl_[i] >= 0)
+      {
+        ENTRY *entry = table.slots_ + i;
+        ACE_DES_FREE_TEMPLATE2 (entry, ACE_NOOP,
+                                ACE_Flat_Hash_Map_Entry, EXT_ID, INT_ID);
+        --table.size_;
+      }
+
+  this->table_allocator_->free (table.slots_);
+  table.slots_ = 0;
+  table.ctrl_ = 0;
+  table.capacity_ = 0;
+  table.size_ = 0;
+  table.deleted_ = 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> size_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::capacity_for (size_t size)
+{
+  size_t capacity = GROUP_WIDTH;
+  while (max_load (capacity) < size)
+    capacity *= 2;
+  return capacity;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> size_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::free_slot (const Table &table,
+                                                                                size_t hash) const
+{
+  size_t const group_mask = table.capacity_ / GROUP_WIDTH - 1;
+  size_t group = (hash >> 7) & group_mask;
+
+  // The load factor leaves free slots in the table, so the loop ends.
+  for (size_t probe = 1; ; ++probe)
+    {
+      size_t const first = group * GROUP_WIDTH;
+      unsigned int const mask = match_free (table.ctrl_ + first);
+      if (mask != 0)
+        return first + lowest_bit (mask);
+
+      group = (group + probe) & group_mask;
+    }
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::insert_i (const EXT_ID &ext_id,
+                                                                               const INT_ID &int_id,
+                                                                               size_t hash)
+{
+  Table &table = this->table_;
+
+  if (table.capacity_ == 0
+      || table.size_ + table.deleted_ >= max_load (table.capacity_))
+    {
+      if (this->grow () == -1)
+        return 0;
+    }
+  else if (this->old_.capacity_ != 0)
+    this->migrate (MIGRATE_GROUPS);
+
+  size_t const index = this->free_slot (table, hash);
+  ENTRY *entry = table.slots_ + index;
+  new (entry) ENTRY (ext_id, int_id);
+
+  if (table.ctrl_[index] == CTRL_DELETED)
+    --table.deleted_;
+  table.ctrl_[index] = static_cast<signed char> (hash & 0x7F);
+  ++table.size_;
+  return entry;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::grow (void)
+{
+  if (this->table_.capacity_ == 0)
+    return this->create_table (this->table_, GROUP_WIDTH);
+
+  // The previous move is always done by now (see below), but growing
+  // again before it is would take a third table.
+  if (this->old_.capacity_ != 0)
+    this->migrate (this->old_.capacity_ / GROUP_WIDTH);
+
+  // Only clean up the deleted slots if less than half the slots hold
+  // an entry.
+  size_t capacity = this->table_.capacity_;
+  if (this->table_.size_ >= capacity / 2)
+    capacity *= 2;
+
+  Table table;
+  if (this->create_table (table, capacity) == -1)
+    return -1;
+
+  this->old_ = this->table_;
+  this->table_ = table;
+  this->migrate_group_ = 0;
+
+  // The new table has room for every entry of the old one before it
+  // is 7/8 full again, and the old one has at most capacity / 16
+  // groups left to move, so moving MIGRATE_GROUPS groups on every
+  // insertion empties it well before that.
+  this->migrate (MIGRATE_GROUPS);
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::migrate (size_t groups)
+{
+  Table &old = this->old_;
+  Table &table = this->table_;
+  size_t const old_groups = old.capacity_ / GROUP_WIDTH;
+
+  for (;
+       groups > 0 && old.size_ > 0 && this->migrate_group_ < old_groups;
+       --groups, ++this->migrate_group_)
+    {
+      size_t const first = this->migrate_group_ * GROUP_WIDTH;
+
+      for (size_t i = first; i < first + GROUP_WIDTH; ++i)
+        {
+          if (old.ctrl_[i] < 0)
+            continue;
+
+          ENTRY *entry = old.slots_ + i;
+          size_t const hash = this->hash (entry->ext_id_);
+          size_t const index = this->free_slot (table, hash);
+
+          new (table.slots_ + index) ENTRY (*entry);
+          table.ctrl_[index] = static_cast<signed char> (hash & 0x7F);
+          ++table.size_;
+
+          ACE_DES_FREE_TEMPLATE2 (entry, ACE_NOOP,
+                                  ACE_Flat_Hash_Map_Entry, EXT_ID, INT_ID);
+
+          // Marked deleted rather than empty so that the lookups of
+          // the entries left in the old table go on past this slot.
+          old.ctrl_[i] = static_cast<signed char> (CTRL_DELETED);
+          --old.size_;
+        }
+    }
+
+  if (old.size_ == 0)
+    {
+      this->free_table (old);
+      this->migrate_group_ = 0;
+    }
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::erase (Table &table,
+                                                                            size_t index)
+{
+  ENTRY *entry = table.slots_ + index;
+  ACE_DES_FREE_TEMPLATE2 (entry, ACE_NOOP,
+                          ACE_Flat_Hash_Map_Entry, EXT_ID, INT_ID);
+  --table.size_;
+
+  // Lookups stop at a group with an empty slot, so if the group
+  // already had one no lookup goes past it and the slot can be made
+  // empty too.
+  size_t const first = index - index % GROUP_WIDTH;
+  if (match_empty (table.ctrl_ + first) != 0)
+    table.ctrl_[index] = static_cast<signed char> (CTRL_EMPTY);
+  else
+    {
+      table.ctrl_[index] = static_cast<signed char> (CTRL_DELETED);
+      ++table.deleted_;
+    }
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+typename ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::Table *
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::table_of (ENTRY *entry)
+{
+  if (entry >= this->table_.slots_
+      && entry < this->table_.slots_ + this->table_.capacity_)
+    return &this->table_;
+
+  if (entry >= this->old_.slots_
+      && entry < this->old_.slots_ + this->old_.capacity_)
+    return &this->old_;
+
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind_i (ENTRY *entry)
+{
+  Table *table = this->table_of (entry);
+  if (table == 0)
+    return -1;
+
+  size_t const index = static_cast<size_t> (entry - table->slots_);
+  if (table->ctrl_[index] < 0)
+    return -1;
+
+  this->erase (*table, index);
+
+  if (table == &this->old_ && this->old_.size_ == 0)
+    {
+      this->free_table (this->old_);
+      this->migrate_group_ = 0;
+    }
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::bind_i (const EXT_ID &ext_id,
+                                                                             const INT_ID &int_id,
+                                                                             ENTRY *&entry)
+{
+  size_t const hash = this->hash (ext_id);
+
+  entry = this->find_entry (ext_id, hash);
+  if (entry != 0)
+    return 1;
+
+  entry = this->insert_i (ext_id, int_id, hash);
+  return entry == 0 ? -1 : 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::trybind_i (const EXT_ID &ext_id,
+                                                                                INT_ID &int_id,
+                                                                                ENTRY *&entry)
+{
+  size_t const hash = this->hash (ext_id);
+
+  entry = this->find_entry (ext_id, hash);
+  if (entry != 0)
+    {
+      int_id = entry->int_id_;
+      return 1;
+    }
+
+  entry = this->insert_i (ext_id, int_id, hash);
+  return entry == 0 ? -1 : 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind_i (const EXT_ID &ext_id,
+                                                                               const INT_ID &int_id,
+                                                                               ENTRY *&entry)
+{
+  size_t const hash = this->hash (ext_id);
+
+  entry = this->find_entry (ext_id, hash);
+  if (entry != 0)
+    {
+      entry->int_id_ = int_id;
+      return 1;
+    }
+
+  entry = this->insert_i (ext_id, int_id, hash);
+  return entry == 0 ? -1 : 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::next_full (int &table,
+                                                                                ssize_t &index) const
+{
+  for (; table < 2; ++table, index = -1)
+    {
+      const Table &t = table == 0 ? this->old_ : this->table_;
+      ssize_t const capacity = static_cast<ssize_t> (t.capacity_);
+
+      for (++index; index < capacity; ++index)
+        if (t.ctrl_[index] >= 0)
+          return;
+    }
+
+  index = 0;
+}
+
+// ------------------------------------------------------------
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Flat_Hash_Map_Iterator)
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("table_ = %d "), this->table_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("index_ = %d"), static_cast<int> (this->index_)));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Flat_Hash_Map_Const_Iterator)
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> void
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("table_ = %d "), this->table_));
+  ACELIB_DEBUG ((LM_DEBUG,  ACE_TEXT ("index_ = %d"), static_cast<int> (this->index_)));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_FLAT_HASH_MAP_T_CPP */
@@ -0,0 +1,613 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Flat_Hash_Map_T.h
+ *
+ *  $Id$
+ *
+ *  An open addressing hash map with the interface of
+ *  ACE_Hash_Map_Manager_Ex.
+ */
+//=============================================================================
+
+#ifndef ACE_FLAT_HASH_MAP_T_H
+#define ACE_FLAT_HASH_MAP_T_H
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/config-all.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Basic_Types.h"
+#include "ace/Default_Constants.h"
+#include "ace/Functor_T.h"
+#include "ace/Log_Category.h"
+#include <iterator>
+
+// Compare the control bytes of a whole group with SSE2, which every
+// x86_64 processor has.  Define ACE_LACKS_FLAT_HASH_MAP_SIMD to use
+// the portable loops instead.
+#if !defined (ACE_LACKS_FLAT_HASH_MAP_SIMD)
+# if (defined (__x86_64__) && defined (__SSE2__)) || defined (_M_X64)
+#   define ACE_FLAT_HASH_MAP_SSE2
+#   include <emmintrin.h>
+# endif
+#endif /* !ACE_LACKS_FLAT_HASH_MAP_SIMD */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+class ACE_Allocator;
+
+/**
+ * @class ACE_Flat_Hash_Map_Entry
+ *
+ * @brief An entry of ACE_Flat_Hash_Map, stored in the table itself.
+ */
+template <class EXT_ID, class INT_ID>
+class ACE_Flat_Hash_Map_Entry
+{
+public:
+  ACE_Flat_Hash_Map_Entry (const EXT_ID &ext_id, const INT_ID &int_id);
+  ~ACE_Flat_Hash_Map_Entry (void);
+
+  /// Read/write the key.
+  EXT_ID& key (void);
+  const EXT_ID& key (void) const;
+
+  /// Read/write the item.
+  INT_ID& item (void);
+  const INT_ID& item (void) const;
+
+  /// Key used to look up an entry.
+  /// @deprecated Use key()
+  EXT_ID ext_id_;
+
+  /// The contents of the entry itself.
+  /// @deprecated Use item()
+  INT_ID int_id_;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+};
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Flat_Hash_Map_Iterator;
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Flat_Hash_Map_Const_Iterator;
+
+/**
+ * @class ACE_Flat_Hash_Map
+ *
+ * @brief Hash map keeping its entries in a single array.
+ *
+ * ACE_Hash_Map_Manager_Ex allocates every entry separately and
+ * chains the entries of a bucket, so a lookup in a large map usually
+ * misses the cache once for the bucket and once per entry compared.
+ * This map stores the entries themselves in an array of slots, with
+ * one control byte per slot, in the manner of the SwissTable hash
+ * maps:
+ *
+ * - the control byte of a slot holding an entry has the 7 low bits of
+ *   the key's hash, the others mark the slot empty or deleted;
+ * - slots are probed by groups of GROUP_WIDTH, the 16 control bytes of
+ *   a group being compared with the hash at once (with SSE2 where
+ *   available), so most lookups compare a single key and touch two
+ *   cache lines;
+ * - a lookup stops at the first group with an empty slot.
+ *
+ * The table grows once it is 7/8 full, counting deleted slots.  The
+ * entries are not all moved to the new table at once, which would
+ * stall the bind() that makes it grow: the old table is kept, and
+ * every insertion moves the entries of the next MIGRATE_GROUPS
+ * groups of the old table, until it is empty and released.  Lookups
+ * meanwhile search both tables.
+ *
+ * The interface is that of ACE_Hash_Map_Manager_Ex, with the same
+ * return values, except that:
+ * - entries move when the table grows, so an entry pointer or
+ *   iterator is only valid until the next insertion; unbind() never
+ *   moves entries, so entries may be unbound while iterating;
+ * - the iterators only go forward;
+ * - a single allocator is used, for the tables.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Flat_Hash_Map
+{
+public:
+  friend class ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>;
+  friend class ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>;
+
+  typedef EXT_ID
+          KEY;
+  typedef INT_ID
+          VALUE;
+  typedef ACE_LOCK lock_type;
+  typedef ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>
+          ENTRY;
+
+  // = ACE-style iterator typedefs.
+  typedef ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          ITERATOR;
+  typedef ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          CONST_ITERATOR;
+
+  // = STL-style iterator typedefs.
+  typedef ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          iterator;
+  typedef ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          const_iterator;
+
+  // = STL-style typedefs/traits.
+  typedef EXT_ID                                  key_type;
+  typedef INT_ID                                  data_type;
+  typedef ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> value_type;
+  typedef value_type &                            reference;
+  typedef value_type const &                      const_reference;
+  typedef value_type *                            pointer;
+  typedef value_type const *                      const_pointer;
+  typedef ptrdiff_t                               difference_type;
+  typedef size_t                                  size_type;
+
+  enum
+  {
+    /// Number of slots probed at once.
+    GROUP_WIDTH = 16,
+
+    /// Groups of the old table moved to the new one by every
+    /// insertion while the table grows.
+    MIGRATE_GROUPS = 2
+  };
+
+  /**
+   * Initialize an empty map, which allocates its table from
+   * @a table_alloc when the first entry is bound.  If @a table_alloc
+   * is 0 it defaults to ACE_Allocator::instance().
+   */
+  ACE_Flat_Hash_Map (ACE_Allocator *table_alloc = 0);
+
+  /// Initialize a map that can hold @a size entries before growing.
+  ACE_Flat_Hash_Map (size_t size,
+                     ACE_Allocator *table_alloc = 0);
+
+  /**
+   * Initialize a map that can hold @a size entries before growing,
+   * allocating its table from @a table_alloc, or from
+   * ACE_Allocator::instance() if it is 0.
+   * @return -1 on failure, 0 on success
+   */
+  int open (size_t size = ACE_DEFAULT_MAP_SIZE,
+            ACE_Allocator *table_alloc = 0);
+
+  /// Close down the map and release its table.
+  int close (void);
+
+  /// Removes all the entries in the map, keeping its table.
+  int unbind_all (void);
+
+  /// Cleanup the map.
+  ~ACE_Flat_Hash_Map (void);
+
+  /**
+   * Associate @a ext_id with @a int_id.  If @a ext_id is already in
+   * the map then the map is not changed.
+   *
+   * @retval 0 if a new entry is bound successfully.
+   * @retval 1 if an attempt is made to bind an existing entry.
+   * @retval -1 if a failure occurs; check @c errno for more information.
+   */
+  int bind (const EXT_ID &ext_id,
+            const INT_ID &int_id);
+
+  /// Same as a normal bind, except the new or existing entry is also
+  /// passed back to the caller.
+  int bind (const EXT_ID &ext_id,
+            const INT_ID &int_id,
+            ENTRY *&entry);
+
+  /**
+   * Associate @a ext_id with @a int_id if and only if @a ext_id is not
+   * in the map.  If @a ext_id is already in the map then the @a int_id
+   * parameter is assigned the existing value in the map.  Returns 0
+   * if a new entry is bound successfully, returns 1 if an attempt is
+   * made to bind an existing entry, and returns -1 if failures occur.
+   */
+  int trybind (const EXT_ID &ext_id,
+               INT_ID &int_id);
+
+  /// Same as a normal trybind, except the new or existing entry is
+  /// also passed back to the caller.
+  int trybind (const EXT_ID &ext_id,
+               INT_ID &int_id,
+               ENTRY *&entry);
+
+  /**
+   * Reassociate @a ext_id with @a int_id.  If @a ext_id is not in the
+   * map then behaves just like bind().  Returns 0 if a new entry is
+   * bound successfully, returns 1 if an existing entry was rebound,
+   * and returns -1 if failures occur.
+   */
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id);
+
+  /// Same as a normal rebind, except the entry is also passed back to
+  /// the caller.
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id,
+              ENTRY *&entry);
+
+  /// Same as a normal rebind, except the previous value of an
+  /// existing entry is passed back in @a old_int_id.
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id,
+              INT_ID &old_int_id);
+
+  /// Same as a normal rebind, except the key of an existing entry is
+  /// replaced by @a ext_id as well, and its previous key and value are
+  /// passed back in @a old_ext_id and @a old_int_id.
+  int rebind (const EXT_ID &ext_id,
+              const INT_ID &int_id,
+              EXT_ID &old_ext_id,
+              INT_ID &old_int_id);
+
+  /// Locate @a ext_id and pass out parameter via @a int_id.
+  /// Return 0 if found, returns -1 if not found.
+  int find (const EXT_ID &ext_id,
+            INT_ID &int_id) const;
+
+  /// Returns 0 if the @a ext_id is in the mapping, otherwise -1.
+  int find (const EXT_ID &ext_id) const;
+
+  /// Locate @a ext_id and pass out its entry.
+  /// Return 0 if found, returns -1 if not found.
+  int find (const EXT_ID &ext_id,
+            ENTRY *&entry) const;
+
+  /// Unbind (remove) the @a ext_id from the map.  Returns 0 if
+  /// successful, -1 if @a ext_id is not in the map.
+  int unbind (const EXT_ID &ext_id);
+
+  /// Same as the other unbind, except the value of the entry removed
+  /// is passed back in @a int_id.
+  int unbind (const EXT_ID &ext_id,
+              INT_ID &int_id);
+
+  /// Remove @a entry from the map.  Returns 0 if successful, -1 if
+  /// @a entry is not an entry of the map.
+  int unbind (ENTRY *entry);
+
+  /// Remove the entry at @a pos.  Returns 0 if successful, -1 if
+  /// @a pos is the end of the map.
+  int unbind (iterator pos);
+
+  /// Returns the current number of entries in the map.
+  size_t current_size (void) const;
+
+  /// Returns the number of slots of the table.
+  size_t total_size (void) const;
+
+  /// True while entries are being moved to a new table.
+  bool rehashing (void) const;
+
+  /**
+   * Returns a reference to the underlying ACE_LOCK.  This makes it
+   * possible to acquire the lock explicitly, which can be useful in
+   * some cases if you instantiate the ACE_Atomic_Op with an
+   * ACE_Recursive_Mutex or ACE_Process_Mutex, or if you need to
+   * guard the state of an iterator.
+   * @note The right name would be lock, but HP/C++ will choke on that!
+   */
+  ACE_LOCK &mutex (void);
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  // = STL styled iterator factory functions.
+
+  /// Return forward iterator.
+  iterator begin (void);
+  iterator end (void);
+  const_iterator begin (void) const;
+  const_iterator end (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  // = The following methods do the actual work.  These methods assume
+  // that the locks are held by the private methods.
+
+  int bind_i (const EXT_ID &ext_id, const INT_ID &int_id, ENTRY *&entry);
+  int trybind_i (const EXT_ID &ext_id, INT_ID &int_id, ENTRY *&entry);
+  int rebind_i (const EXT_ID &ext_id, const INT_ID &int_id, ENTRY *&entry);
+  int find_i (const EXT_ID &ext_id, ENTRY *&entry) const;
+  int unbind_i (ENTRY *entry);
+  int close_i (void);
+  int unbind_all_i (void);
+
+  /// Returns 1 if <id1> == <id2>, else 0.
+  int equal (const EXT_ID &id1, const EXT_ID &id2) const;
+
+  /// Hash of @a ext_id, mixed so that its low bits depend on all the
+  /// bits of the HASH_KEY value.
+  size_t hash (const EXT_ID &ext_id) const;
+
+private:
+  /// Control bytes of the slots not holding an entry.  Those of the
+  /// slots holding one are in [0, 127].
+  enum
+  {
+    CTRL_EMPTY = -128,
+    CTRL_DELETED = -2
+  };
+
+  /// An array of slots and their control bytes.
+  struct Table
+  {
+    ENTRY *slots_;
+    signed char *ctrl_;
+
+    /// Number of slots, a power of two multiple of GROUP_WIDTH, or 0
+    /// if the table is not allocated.
+    size_t capacity_;
+
+    /// Slots holding an entry.
+    size_t size_;
+
+    /// Slots marked deleted.
+    size_t deleted_;
+  };
+
+  /// Allocate @a capacity slots for @a table, all empty.
+  int create_table (Table &table, size_t capacity);
+
+  /// Destroy the entries of @a table and release it.
+  void free_table (Table &table);
+
+  /// Slot of @a ext_id in @a table, or -1.
+  ssize_t find_slot (const Table &table,
+                     const EXT_ID &ext_id,
+                     size_t hash) const;
+
+  /// Entry of @a ext_id in either table, or 0.
+  ENTRY *find_entry (const EXT_ID &ext_id, size_t hash) const;
+
+  /// First empty or deleted slot in the probe sequence of @a hash.
+  size_t free_slot (const Table &table, size_t hash) const;
+
+  /// Construct a new entry in the table, growing it or moving
+  /// entries of the old table first.  @a ext_id must not be in the
+  /// map yet.
+  ENTRY *insert_i (const EXT_ID &ext_id,
+                   const INT_ID &int_id,
+                   size_t hash);
+
+  /// Start moving the entries to a new table.
+  int grow (void);
+
+  /// Move the entries of the next @a groups groups of the old table to
+  /// the new one, releasing the old table once it is empty.
+  void migrate (size_t groups);
+
+  /// Destroy the entry in slot @a index of @a table.
+  void erase (Table &table, size_t index);
+
+  /// Table holding @a entry, or 0.
+  Table *table_of (ENTRY *entry);
+
+  /// Smallest capacity holding @a size entries without growing.
+  static size_t capacity_for (size_t size);
+
+  /// Entries a table of @a capacity slots holds before growing.
+  static size_t max_load (size_t capacity);
+
+  /// @name Group probing
+  //@{
+  /// Bit i is set if control byte i of @a group is @a h2.
+  static unsigned int match (const signed char *group, signed char h2);
+
+  /// Bit i is set if slot i of @a group is empty.
+  static unsigned int match_empty (const signed char *group);
+
+  /// Bit i is set if slot i of @a group is empty or deleted.
+  static unsigned int match_free (const signed char *group);
+
+  /// Index of the lowest bit set in @a mask, which is not 0.
+  static unsigned int lowest_bit (unsigned int mask);
+  //@}
+
+  /// Position following slot @a index of table @a table (0 for the
+  /// old one, 1 for the current one), as updated by next_full().
+  void next_full (int &table, ssize_t &index) const;
+
+  /// Entry at a position returned by next_full().
+  ENTRY *entry_at (int table, ssize_t index) const;
+
+  /// Synchronization variable for the MT_SAFE
+  /// ACE_Flat_Hash_Map.
+  mutable ACE_LOCK lock_;
+
+  /// Function object used for hashing keys.
+  HASH_KEY hash_key_;
+
+  /// Function object used for comparing keys.
+  COMPARE_KEYS compare_keys_;
+
+  /// Pointer to a memory allocator used for the tables.
+  ACE_Allocator *table_allocator_;
+
+  /// The table new entries go to.
+  Table table_;
+
+  /// The table entries are moved from while growing.
+  Table old_;
+
+  /// Next group of old_ to move.
+  size_t migrate_group_;
+
+  // = Disallow these operations.
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &))
+  ACE_UNIMPLEMENTED_FUNC (ACE_Flat_Hash_Map (const ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &))
+};
+
+/**
+ * @class ACE_Flat_Hash_Map_Iterator
+ *
+ * @brief Forward iterator for the ACE_Flat_Hash_Map.
+ *
+ * This class does not perform any internal locking of the
+ * ACE_Flat_Hash_Map it is iterating upon since locking is
+ * inherently inefficient and/or error-prone within an STL-style
+ * iterator.  If you require locking, you can explicitly use an
+ * ACE_GUARD or ACE_READ_GUARD on the ACE_Flat_Hash_Map's internal
+ * lock, which is accessible via its mutex() method.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Flat_Hash_Map_Iterator
+{
+public:
+  // = STL-style typedefs/traits.
+  typedef ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          container_type;
+
+  typedef std::forward_iterator_tag                iterator_category;
+  typedef typename container_type::value_type      value_type;
+  typedef typename container_type::reference       reference;
+  typedef typename container_type::pointer         pointer;
+  typedef typename container_type::difference_type difference_type;
+
+  /// Iterate from the first entry of @a mm, or from its end if
+  /// @a tail is true.
+  ACE_Flat_Hash_Map_Iterator (container_type &mm, bool tail = false);
+
+  /// Pass back the next entry that hasn't been seen in the map.
+  /// Returns 0 when all items have been seen, else 1.
+  int next (ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *&next_entry) const;
+
+  /// Returns 1 when all items have been seen, else 0.
+  int done (void) const;
+
+  /// Move forward by one element in the map.  Returns 0 when all
+  /// elements have been seen, else 1.
+  int advance (void);
+
+  /// Returns a reference to the interal element @c this is pointing to.
+  ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>& operator* (void) const;
+
+  /// Returns a pointer to the interal element @c this is pointing to.
+  ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>* operator-> (void) const;
+
+  // = STL styled iteration.
+  ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &operator++ (void);
+  ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> operator++ (int);
+
+  /// Check if two iterators point to the same position.
+  bool operator== (const ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+  bool operator!= (const ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// Map we are iterating over.
+  container_type *map_man_;
+
+  /// Table of the current entry, 0 for the old table, 1 for the new
+  /// one, and 2 at the end.
+  int table_;
+
+  /// Slot of the current entry.
+  ssize_t index_;
+};
+
+/**
+ * @class ACE_Flat_Hash_Map_Const_Iterator
+ *
+ * @brief Const forward iterator for the ACE_Flat_Hash_Map.
+ *
+ * Like ACE_Flat_Hash_Map_Iterator, this class does not lock the map.
+ */
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+class ACE_Flat_Hash_Map_Const_Iterator
+{
+public:
+  // = STL-style typedefs/traits.
+  typedef ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          container_type;
+
+  typedef std::forward_iterator_tag                iterator_category;
+  typedef typename container_type::value_type      value_type;
+  typedef typename container_type::const_reference reference;
+  typedef typename container_type::const_pointer   pointer;
+  typedef typename container_type::difference_type difference_type;
+
+  /// Iterate from the first entry of @a mm, or from its end if
+  /// @a tail is true.
+  ACE_Flat_Hash_Map_Const_Iterator (const container_type &mm,
+                                    bool tail = false);
+
+  /// Pass back the next entry that hasn't been seen in the map.
+  /// Returns 0 when all items have been seen, else 1.
+  int next (ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *&next_entry) const;
+
+  /// Returns 1 when all items have been seen, else 0.
+  int done (void) const;
+
+  /// Move forward by one element in the map.  Returns 0 when all
+  /// elements have been seen, else 1.
+  int advance (void);
+
+  /// Returns a reference to the interal element @c this is pointing to.
+  const ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>& operator* (void) const;
+
+  /// Returns a pointer to the interal element @c this is pointing to.
+  const ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>* operator-> (void) const;
+
+  // = STL styled iteration.
+  ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &operator++ (void);
+  ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> operator++ (int);
+
+  /// Check if two iterators point to the same position.
+  bool operator== (const ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+  bool operator!= (const ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &) const;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// Map we are iterating over.
+  const container_type *map_man_;
+
+  /// Table of the current entry, 0 for the old table, 1 for the new
+  /// one, and 2 at the end.
+  int table_;
+
+  /// Slot of the current entry.
+  ssize_t index_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#  include "ace/Flat_Hash_Map_T.inl"
+#endif /* __ACE_INLINE__ */
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/Flat_Hash_Map_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("Flat_Hash_Map_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_FLAT_HASH_MAP_T_H */
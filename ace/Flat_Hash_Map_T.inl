@@ -0,0 +1,622 @@
+// -*- C++ -*-
+//
+// $Id$
+
+#include "ace/Guard_T.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+template <class EXT_ID, class INT_ID> ACE_INLINE
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::ACE_Flat_Hash_Map_Entry (const EXT_ID &ext_id,
+                                                                  const INT_ID &int_id)
+  : ext_id_ (ext_id),
+    int_id_ (int_id)
+{
+}
+
+template <class EXT_ID, class INT_ID> ACE_INLINE
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::~ACE_Flat_Hash_Map_Entry (void)
+{
+}
+
+template <class EXT_ID, class INT_ID> ACE_INLINE EXT_ID &
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::key (void)
+{
+  return this->ext_id_;
+}
+
+template <class EXT_ID, class INT_ID> ACE_INLINE const EXT_ID &
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::key (void) const
+{
+  return this->ext_id_;
+}
+
+template <class EXT_ID, class INT_ID> ACE_INLINE INT_ID &
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::item (void)
+{
+  return this->int_id_;
+}
+
+template <class EXT_ID, class INT_ID> ACE_INLINE const INT_ID &
+ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID>::item (void) const
+{
+  return this->int_id_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Flat_Hash_Map (ACE_Allocator *table_alloc)
+  : table_allocator_ (table_alloc),
+    migrate_group_ (0)
+{
+  this->table_.slots_ = 0;
+  this->table_.ctrl_ = 0;
+  this->table_.capacity_ = 0;
+  this->table_.size_ = 0;
+  this->table_.deleted_ = 0;
+  this->old_ = this->table_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Flat_Hash_Map (size_t size,
+                                                                                        ACE_Allocator *table_alloc)
+  : table_allocator_ (table_alloc),
+    migrate_group_ (0)
+{
+  this->table_.slots_ = 0;
+  this->table_.ctrl_ = 0;
+  this->table_.capacity_ = 0;
+  this->table_.size_ = 0;
+  this->table_.deleted_ = 0;
+  this->old_ = this->table_;
+
+  if (this->open (size, table_alloc) == -1)
+    ACELIB_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"),
+                ACE_TEXT ("ACE_Flat_Hash_Map open")));
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::close (void)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->close_i ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind_all (void)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->unbind_all_i ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::~ACE_Flat_Hash_Map (void)
+{
+  this->close ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE size_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::current_size (void) const
+{
+  return this->table_.size_ + this->old_.size_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE size_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::total_size (void) const
+{
+  return this->table_.capacity_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rehashing (void) const
+{
+  return this->old_.capacity_ != 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_LOCK &
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::mutex (void)
+{
+  return this->lock_;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::equal (const EXT_ID &id1,
+                                                                            const EXT_ID &id2) const
+{
+  return this->compare_keys_ (id1, id2);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE size_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::hash (const EXT_ID &ext_id) const
+{
+  // Hash functions like ACE_Hash<int> return the key itself, so the
+  // hash is multiplied by the golden ratio to carry every bit into the
+  // upper half, which is folded back onto the control and group bits.
+  ACE_UINT64 const h =
+    static_cast<ACE_UINT64> (this->hash_key_ (ext_id))
+    * ACE_UINT64_LITERAL (0x9E3779B97F4A7C15);
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE size_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::max_load (size_t capacity)
+{
+  return capacity - capacity / 8;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE unsigned int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::match (const signed char *group,
+                                                                            signed char h2)
+{
+#if defined (ACE_FLAT_HASH_MAP_SSE2)
+  __m128i const ctrl =
+    _mm_loadu_si128 (reinterpret_cast<const __m128i *> (group));
+  return static_cast<unsigned int> (
+    _mm_movemask_epi8 (_mm_cmpeq_epi8 (ctrl, _mm_set1_epi8 (h2))));
+#else
+  unsigned int mask = 0;
+  for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    if (group[i] == h2)
+      mask |= 1u << i;
+  return mask;
+#endif /* ACE_FLAT_HASH_MAP_SSE2 */
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE unsigned int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::match_empty (const signed char *group)
+{
+  return match (group, static_cast<signed char> (CTRL_EMPTY));
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE unsigned int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::match_free (const signed char *group)
+{
+#if defined (ACE_FLAT_HASH_MAP_SSE2)
+  // The control bytes of free slots are the negative ones.
+  return static_cast<unsigned int> (
+    _mm_movemask_epi8 (
+      _mm_loadu_si128 (reinterpret_cast<const __m128i *> (group))));
+#else
+  unsigned int mask = 0;
+  for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    if (group[i] < 0)
+      mask |= 1u << i;
+  return mask;
+#endif /* ACE_FLAT_HASH_MAP_SSE2 */
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE unsigned int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::lowest_bit (unsigned int mask)
+{
+#if defined (__GNUC__)
+  return static_cast<unsigned int> (__builtin_ctz (mask));
+#else
+  unsigned int i = 0;
+  while ((mask & 1u) == 0)
+    {
+      mask >>= 1;
+      ++i;
+    }
+  return i;
+#endif /* __GNUC__ */
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ssize_t
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find_slot (const Table &table,
+                                                                                const EXT_ID &ext_id,
+                                                                                size_t hash) const
+{
+  if (table.size_ == 0)
+    return -1;
+
+  signed char const h2 = static_cast<signed char> (hash & 0x7F);
+  size_t const group_mask = table.capacity_ / GROUP_WIDTH - 1;
+  size_t group = (hash >> 7) & group_mask;
+
+  // Triangular probing visits every group once.
+  for (size_t probe = 1; probe <= group_mask + 1; ++probe)
+    {
+      size_t const first = group * GROUP_WIDTH;
+      signed char const *ctrl = table.ctrl_ + first;
+
+      for (unsigned int mask = match (ctrl, h2); mask != 0; mask &= mask - 1)
+        {
+          size_t const index = first + lowest_bit (mask);
+          if (this->equal (table.slots_[index].ext_id_, ext_id))
+            return static_cast<ssize_t> (index);
+        }
+
+      if (match_empty (ctrl) != 0)
+        break;
+
+      group = (group + probe) & group_mask;
+    }
+
+  return -1;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find_entry (const EXT_ID &ext_id,
+                                                                                 size_t hash) const
+{
+  ssize_t index = this->find_slot (this->table_, ext_id, hash);
+  if (index != -1)
+    return this->table_.slots_ + index;
+
+  index = this->find_slot (this->old_, ext_id, hash);
+  if (index != -1)
+    return this->old_.slots_ + index;
+
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find_i (const EXT_ID &ext_id,
+                                                                             ENTRY *&entry) const
+{
+  entry = this->find_entry (ext_id, this->hash (ext_id));
+  return entry == 0 ? -1 : 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find (const EXT_ID &ext_id,
+                                                                           INT_ID &int_id) const
+{
+  ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = 0;
+  if (this->find_i (ext_id, entry) == -1)
+    return -1;
+
+  int_id = entry->int_id_;
+  return 0;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find (const EXT_ID &ext_id) const
+{
+  ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = 0;
+  return this->find_i (ext_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::find (const EXT_ID &ext_id,
+                                                                           ENTRY *&entry) const
+{
+  ACE_READ_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->find_i (ext_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::bind (const EXT_ID &ext_id,
+                                                                           const INT_ID &int_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = 0;
+  return this->bind_i (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::bind (const EXT_ID &ext_id,
+                                                                           const INT_ID &int_id,
+                                                                           ENTRY *&entry)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->bind_i (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::trybind (const EXT_ID &ext_id,
+                                                                              INT_ID &int_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = 0;
+  return this->trybind_i (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::trybind (const EXT_ID &ext_id,
+                                                                              INT_ID &int_id,
+                                                                              ENTRY *&entry)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->trybind_i (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                             const INT_ID &int_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = 0;
+  return this->rebind_i (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                             const INT_ID &int_id,
+                                                                             ENTRY *&entry)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->rebind_i (ext_id, int_id, entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                             const INT_ID &int_id,
+                                                                             INT_ID &old_int_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  size_t const hash = this->hash (ext_id);
+  ENTRY *entry = this->find_entry (ext_id, hash);
+  if (entry == 0)
+    return this->insert_i (ext_id, int_id, hash) == 0 ? -1 : 0;
+
+  old_int_id = entry->int_id_;
+  entry->int_id_ = int_id;
+  return 1;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::rebind (const EXT_ID &ext_id,
+                                                                             const INT_ID &int_id,
+                                                                             EXT_ID &old_ext_id,
+                                                                             INT_ID &old_int_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  size_t const hash = this->hash (ext_id);
+  ENTRY *entry = this->find_entry (ext_id, hash);
+  if (entry == 0)
+    return this->insert_i (ext_id, int_id, hash) == 0 ? -1 : 0;
+
+  old_ext_id = entry->ext_id_;
+  old_int_id = entry->int_id_;
+  entry->ext_id_ = ext_id;
+  entry->int_id_ = int_id;
+  return 1;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (const EXT_ID &ext_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = this->find_entry (ext_id, this->hash (ext_id));
+  return entry == 0 ? -1 : this->unbind_i (entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (const EXT_ID &ext_id,
+                                                                             INT_ID &int_id)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  ENTRY *entry = this->find_entry (ext_id, this->hash (ext_id));
+  if (entry == 0)
+    return -1;
+
+  int_id = entry->int_id_;
+  return this->unbind_i (entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (ENTRY *entry)
+{
+  ACE_WRITE_GUARD_RETURN (ACE_LOCK, ace_mon, this->lock_, -1);
+
+  return this->unbind_i (entry);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::unbind (iterator pos)
+{
+  if (pos.done ())
+    return -1;
+
+  return this->unbind (&*pos);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::entry_at (int table,
+                                                                               ssize_t index) const
+{
+  return (table == 0 ? this->old_.slots_ : this->table_.slots_) + index;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_INLINE typename ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::iterator
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::begin (void)
+{
+  return iterator (*this);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_INLINE typename ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::iterator
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::end (void)
+{
+  return iterator (*this, true);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_INLINE typename ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::const_iterator
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::begin (void) const
+{
+  return const_iterator (*this);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK>
+ACE_INLINE typename ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::const_iterator
+ACE_Flat_Hash_Map<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::end (void) const
+{
+  return const_iterator (*this, true);
+}
+
+// ------------------------------------------------------------
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Flat_Hash_Map_Iterator (container_type &mm,
+                                                                                                          bool tail)
+  : map_man_ (&mm),
+    table_ (tail ? 2 : 0),
+    index_ (tail ? 0 : -1)
+{
+  if (!tail)
+    mm.next_full (this->table_, this->index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::next (ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *&entry) const
+{
+  if (this->done ())
+    return 0;
+
+  entry = this->map_man_->entry_at (this->table_, this->index_);
+  return 1;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::done (void) const
+{
+  return this->table_ == 2;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::advance (void)
+{
+  if (!this->done ())
+    this->map_man_->next_full (this->table_, this->index_);
+  return !this->done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> &
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator* (void) const
+{
+  return *this->map_man_->entry_at (this->table_, this->index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator-> (void) const
+{
+  return this->map_man_->entry_at (this->table_, this->index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (void)
+{
+  this->advance ();
+  return *this;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (int)
+{
+  ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> retv (*this);
+  this->advance ();
+  return retv;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator== (const ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return this->map_man_ == rhs.map_man_
+    && this->table_ == rhs.table_
+    && (this->table_ == 2 || this->index_ == rhs.index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator!= (const ACE_Flat_Hash_Map_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return !(*this == rhs);
+}
+
+// ------------------------------------------------------------
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::ACE_Flat_Hash_Map_Const_Iterator (const container_type &mm,
+                                                                                                                      bool tail)
+  : map_man_ (&mm),
+    table_ (tail ? 2 : 0),
+    index_ (tail ? 0 : -1)
+{
+  if (!tail)
+    mm.next_full (this->table_, this->index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::next (ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *&entry) const
+{
+  if (this->done ())
+    return 0;
+
+  entry = this->map_man_->entry_at (this->table_, this->index_);
+  return 1;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::done (void) const
+{
+  return this->table_ == 2;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE int
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::advance (void)
+{
+  if (!this->done ())
+    this->map_man_->next_full (this->table_, this->index_);
+  return !this->done ();
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE const ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> &
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator* (void) const
+{
+  return *this->map_man_->entry_at (this->table_, this->index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE const ACE_Flat_Hash_Map_Entry<EXT_ID, INT_ID> *
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator-> (void) const
+{
+  return this->map_man_->entry_at (this->table_, this->index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (void)
+{
+  this->advance ();
+  return *this;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator++ (int)
+{
+  ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> retv (*this);
+  this->advance ();
+  return retv;
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator== (const ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return this->map_man_ == rhs.map_man_
+    && this->table_ == rhs.table_
+    && (this->table_ == 2 || this->index_ == rhs.index_);
+}
+
+template <class EXT_ID, class INT_ID, class HASH_KEY, class COMPARE_KEYS, class ACE_LOCK> ACE_INLINE bool
+ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>::operator!= (const ACE_Flat_Hash_Map_Const_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK> &rhs) const
+{
+  return !(*this == rhs);
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -33,9 +33,9 @@ class ACE_Allocator;
 #define ACE_CACHE_MAP_MANAGER \
         ACE_Cache_Map_Manager<KEY, \
                               VALUE, \
-                              ACE_Hash_Map_Manager_Ex<KEY, std::pair<VALUE, ATTRIBUTES>, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex>, \
-                              ACE_Hash_Map_Iterator_Ex<KEY, std::pair<VALUE, ATTRIBUTES>, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex>, \
-                              ACE_Hash_Map_Reverse_Iterator_Ex<KEY, std::pair<VALUE, ATTRIBUTES>, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex>, \
+                              CMAP_TYPE, \
+                              typename CMAP_TYPE::ITERATOR, \
+                              typename CMAP_TYPE::REVERSE_ITERATOR, \
                               CACHING_STRATEGY, \
                               ATTRIBUTES>
 
@@ -43,7 +43,9 @@ class ACE_Allocator;
   * @class ACE_Hash_Cache_Map_Manager
   *
   * @brief Defines a abstraction which will purge entries from a map.
-  * The map considered is the ACE_Hash_Map_Manager_Ex.
+  * The map considered is the ACE_Hash_Map_Manager_Ex, or CMAP_TYPE
+  * if given, which must have its interface and ACE_Hash_Map_Entry
+  * entries, such as ACE_Concurrent_Hash_Map.
   *
   * The Hash_Cache_Map_Manager will manage the map it contains
   * and provide purging on demand from the map. The strategy for
@@ -58,7 +60,8 @@ class ACE_Allocator;
   * isn't efficient.  Locking has to be provided by the
   * application.
   */
-template <class KEY, class VALUE, class HASH_KEY, class COMPARE_KEYS, class CACHING_STRATEGY, class ATTRIBUTES>
+template <class KEY, class VALUE, class HASH_KEY, class COMPARE_KEYS, class CACHING_STRATEGY, class ATTRIBUTES,
+          class CMAP_TYPE = ACE_Hash_Map_Manager_Ex<KEY, std::pair<VALUE, ATTRIBUTES>, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex> >
 class ACE_Hash_Cache_Map_Manager : public ACE_CACHE_MAP_MANAGER
 {
  public:
@@ -69,8 +72,8 @@ class ACE_Hash_Cache_Map_Manager : public ACE_CACHE_MAP_MANAGER
    * class.
    */
   typedef std::pair<VALUE, ATTRIBUTES> CACHE_VALUE;
-  typedef ACE_Hash_Map_Manager_Ex<KEY, CACHE_VALUE, HASH_KEY, COMPARE_KEYS, ACE_Null_Mutex> HASH_MAP;
-  typedef ACE_Hash_Map_Entry<KEY, CACHE_VALUE> CACHE_ENTRY;
+  typedef CMAP_TYPE HASH_MAP;
+  typedef typename CMAP_TYPE::ENTRY CACHE_ENTRY;
   typedef KEY key_type;
   typedef VALUE mapped_type;
 
@@ -154,6 +154,8 @@ public:
           REVERSE_ITERATOR;
   typedef ACE_Hash_Map_Const_Reverse_Iterator_Ex<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
           CONST_REVERSE_ITERATOR;
+  typedef ACE_Hash_Map_Bucket_Iterator<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
+          BUCKET_ITERATOR;
 
   // = STL-style iterator typedefs.
   typedef ACE_Hash_Map_Iterator_Ex<EXT_ID, INT_ID, HASH_KEY, COMPARE_KEYS, ACE_LOCK>
@@ -0,0 +1,1163 @@
+// $Id$
+
+#include "ace/Log_Binary.h"
+#include "ace/Log_Msg.h"
+#include "ace/Log_Record.h"
+#include "ace/Log_Category.h"
+#include "ace/CDR_Stream.h"
+#include "ace/ACE.h"
+#include "ace/Thread.h"
+#include "ace/Guard_T.h"
+#include "ace/OS_Memory.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_fcntl.h"
+#include "ace/OS_NS_signal.h"
+#include "ace/OS_NS_stdio.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_Thread.h"
+#include "ace/OS_NS_unistd.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// Each record of a binary log starts with its byte order, its kind,
+// two reserved bytes and its length, padding included, in that byte
+// order.  Records are padded to a multiple of 8 bytes, so that each
+// one can be decoded in place.
+//
+// HEADER: version, program name, host name.
+// FORMAT: number and text of a format string.
+// BINARY: type, pid, time stamp, category name, number of the format
+//         string and the values of the directives of the format, in
+//         order.
+// TEXT:   category name and an ACE_Log_Record, as encoded by
+//         operator<<.
+enum
+{
+  ACE_LOG_BINARY_HEADER = 1,
+  ACE_LOG_BINARY_FORMAT = 2,
+  ACE_LOG_BINARY_BINARY = 3,
+  ACE_LOG_BINARY_TEXT = 4
+};
+
+static ACE_CDR::ULong const log_binary_version = 2;
+
+// Size of the header of each record.
+static size_t const record_header_size = 8;
+
+// Records are written out once this many bytes have been buffered.
+static size_t const writer_buffer_size = 64 * 1024;
+
+// Longest record read back.
+static size_t const max_record_size = 16 * 1024 * 1024;
+
+// The characters that may come between a % and its conversion.
+static const ACE_TCHAR flag_chars[] = ACE_TEXT ("-+0 #123456789.Lh*");
+
+// Conversion of an ACE_TCHAR string.
+#if !defined (ACE_WIN32) && defined (ACE_USES_WCHAR)
+# define ACE_LOG_BINARY_TSTRING ACE_TEXT ("ls")
+#else
+# define ACE_LOG_BINARY_TSTRING ACE_TEXT ("s")
+#endif /* !ACE_WIN32 && ACE_USES_WCHAR */
+
+// Start a record of @a kind, returning where its length goes.
+static char *
+begin_record (ACE_OutputCDR &cdr, ACE_CDR::Octet kind)
+{
+  cdr.write_octet (static_cast<ACE_CDR::Octet> (cdr.byte_order ()));
+  cdr.write_octet (kind);
+  cdr.write_ushort (0);
+  return cdr.write_long_placeholder ();
+}
+
+// Pad the record to a multiple of 8 bytes and fill in its length.
+static int
+end_record (ACE_OutputCDR &cdr, char *length)
+{
+  if (cdr.align_write_ptr (8) == -1 || !cdr.good_bit ())
+    return -1;
+  return cdr.replace (static_cast<ACE_CDR::Long> (cdr.total_length ()),
+                      length) ? 0 : -1;
+}
+
+// Write @a text, or "(null)", truncated to the size of a message,
+// which is all that could be printed of it.
+static void
+write_text (ACE_OutputCDR &cdr, const char *text)
+{
+  if (text == 0)
+    text = "(null)";
+  size_t length = 0;
+  while (length < ACE_MAXLOGMSGLEN && text[length] != '\0')
+    ++length;
+  cdr.write_ulong (static_cast<ACE_CDR::ULong> (length + 1));
+  cdr.write_char_array (text, static_cast<ACE_CDR::ULong> (length));
+  cdr.write_char ('\0');
+}
+
+// Write the name of @a category, empty if there is none.
+static void
+write_category (ACE_OutputCDR &cdr, ACE_Log_Category_TSS *category)
+{
+  write_text (cdr,
+              category != 0 && category->name () != 0
+                ? category->name ()
+                : "");
+}
+
+// Read a string written by write_text(), without copying it.
+static bool
+read_text (ACE_InputCDR &cdr, const char *&text)
+{
+  ACE_CDR::ULong length = 0;
+  if (!cdr.read_ulong (length)
+      || length == 0
+      || length > cdr.length ())
+    return false;
+  text = cdr.rd_ptr ();
+  return cdr.skip_bytes (length) && text[length - 1] == '\0';
+}
+
+// The letter of @a priority printed by %.1M.
+static ACE_TCHAR
+priority_letter (ACE_Log_Priority priority)
+{
+  switch (priority)
+    {
+    case LM_SHUTDOWN:  return ACE_TEXT ('S');
+    case LM_TRACE:     return ACE_TEXT ('T');
+    case LM_DEBUG:     return ACE_TEXT ('D');
+    case LM_INFO:      return ACE_TEXT ('I');
+    case LM_NOTICE:    return ACE_TEXT ('N');
+    case LM_WARNING:   return ACE_TEXT ('W');
+    case LM_STARTUP:   return ACE_TEXT ('U');
+    case LM_ERROR:     return ACE_TEXT ('E');
+    case LM_CRITICAL:  return ACE_TEXT ('C');
+    case LM_ALERT:     return ACE_TEXT ('A');
+    case LM_EMERGENCY: return ACE_TEXT ('!');
+    default:           return ACE_TEXT ('?');
+    }
+}
+
+// Same as in Log_Msg.cpp: count is a size_t, len is an int and
+// assumed to be non-negative.
+#define ACE_UPDATE_COUNT(COUNT, LEN) \
+   do { if (static_cast<size_t> (LEN) > COUNT) COUNT = 0; \
+     else COUNT -= static_cast<size_t> (LEN); \
+   } while (0)
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Log_Binary_Writer)
+
+ACE_Log_Binary_Writer::ACE_Log_Binary_Writer (void)
+  : handle_ (ACE_INVALID_HANDLE),
+    write_errno_ (0),
+    buffer_ (0),
+    length_ (0),
+    size_ (0),
+    next_id_ (0)
+{
+}
+
+ACE_Log_Binary_Writer::~ACE_Log_Binary_Writer (void)
+{
+  this->close ();
+}
+
+int
+ACE_Log_Binary_Writer::open (const ACE_TCHAR *path)
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+
+  if (this->handle_ != ACE_INVALID_HANDLE)
+    {
+      errno = EISCONN;
+      return -1;
+    }
+
+  if (this->buffer_ == 0)
+    ACE_NEW_RETURN (this->buffer_, char[writer_buffer_size], -1);
+
+  this->handle_ = ACE_OS::open (path,
+                                O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
+                                ACE_DEFAULT_FILE_PERMS);
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    return -1;
+  this->length_ = 0;
+  this->size_ = 0;
+  this->write_errno_ = 0;
+
+  char host_name[MAXHOSTNAMELEN + 1];
+  if (ACE_OS::hostname (host_name, sizeof host_name) == -1)
+    host_name[0] = '\0';
+  const ACE_TCHAR *const program_name = ACE_Log_Msg::program_name ();
+
+  char buf[ACE_Log_Record::MAXLOGMSGLEN + ACE_CDR::MAX_ALIGNMENT];
+  ACE_OutputCDR cdr (buf, sizeof buf);
+  char *const length = begin_record (cdr, ACE_LOG_BINARY_HEADER);
+  cdr.write_ulong (log_binary_version);
+  write_text (cdr,
+              program_name != 0
+                ? ACE_TEXT_ALWAYS_CHAR (program_name)
+                : "<unknown>");
+  write_text (cdr, host_name);
+  if (end_record (cdr, length) == -1 || this->append (cdr) == -1)
+    {
+      ACE_OS::close (this->handle_);
+      this->handle_ = ACE_INVALID_HANDLE;
+      return -1;
+    }
+  return this->flush_i ();
+}
+
+int
+ACE_Log_Binary_Writer::close (void)
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+
+  int result = 0;
+  if (this->handle_ != ACE_INVALID_HANDLE)
+    {
+      result = this->flush_i ();
+      if (this->write_errno_ != 0)
+        {
+          errno = this->write_errno_;
+          result = -1;
+        }
+      if (ACE_OS::close (this->handle_) == -1)
+        result = -1;
+      this->handle_ = ACE_INVALID_HANDLE;
+    }
+  this->write_errno_ = 0;
+
+  // The numbers of the formats are only valid in the log they were
+  // given in.
+  for (FORMAT_MAP::ITERATOR i = this->formats_.begin ();
+       i != this->formats_.end ();
+       ++i)
+    {
+      ACE_OS::free ((*i).int_id_->text_);
+      delete (*i).int_id_;
+    }
+  this->formats_.unbind_all ();
+  this->next_id_ = 0;
+
+  delete [] this->buffer_;
+  this->buffer_ = 0;
+  this->length_ = 0;
+  return result;
+}
+
+int
+ACE_Log_Binary_Writer::flush (void)
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+  int const result = this->flush_i ();
+  if (this->write_errno_ != 0)
+    {
+      errno = this->write_errno_;
+      this->write_errno_ = 0;
+      return -1;
+    }
+  return result;
+}
+
+int
+ACE_Log_Binary_Writer::flush_i (void)
+{
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    {
+      errno = EBADF;
+      return -1;
+    }
+  if (this->length_ == 0)
+    return 0;
+
+  ssize_t const n = ACE::write_n (this->handle_, this->buffer_, this->length_);
+  this->length_ = 0;
+  if (n == -1)
+    {
+      this->write_errno_ = errno;
+      return -1;
+    }
+  this->size_ += static_cast<ACE_UINT64> (n);
+  return 0;
+}
+
+int
+ACE_Log_Binary_Writer::append (ACE_OutputCDR &cdr)
+{
+  // Keep the records whole in each write, as far as possible.
+  size_t const size = cdr.total_length ();
+  if (this->length_ + size > writer_buffer_size && this->flush_i () == -1)
+    return -1;
+
+  for (const ACE_Message_Block *mb = cdr.begin (); mb != 0; mb = mb->cont ())
+    {
+      const char *data = mb->rd_ptr ();
+      size_t left = mb->length ();
+      while (left > 0)
+        {
+          if (this->length_ == writer_buffer_size && this->flush_i () == -1)
+            return -1;
+          size_t n = writer_buffer_size - this->length_;
+          if (n > left)
+            n = left;
+          ACE_OS::memcpy (this->buffer_ + this->length_, data, n);
+          this->length_ += n;
+          data += n;
+          left -= n;
+        }
+    }
+  return 0;
+}
+
+int
+ACE_Log_Binary_Writer::format_id (const ACE_TCHAR *format, ACE_UINT32 &id)
+{
+  // The format strings are normally literals, but the same address
+  // could be reused for another one, so the text is checked too.
+  Format *entry = 0;
+  if (this->formats_.find (format, entry) == 0
+      && ACE_OS::strcmp (entry->text_, format) == 0)
+    {
+      id = entry->id_;
+      return 0;
+    }
+
+  ACE_TCHAR *const text = ACE_OS::strdup (format);
+  if (text == 0)
+    return -1;
+  if (entry == 0)
+    {
+      ACE_NEW_NORETURN (entry, Format);
+      if (entry == 0 || this->formats_.bind (format, entry) == -1)
+        {
+          delete entry;
+          ACE_OS::free (text);
+          return -1;
+        }
+    }
+  else
+    ACE_OS::free (entry->text_);
+  entry->id_ = this->next_id_++;
+  entry->text_ = text;
+  id = entry->id_;
+
+  char buf[ACE_Log_Record::MAXLOGMSGLEN + ACE_CDR::MAX_ALIGNMENT];
+  ACE_OutputCDR cdr (buf, sizeof buf);
+  char *const length = begin_record (cdr, ACE_LOG_BINARY_FORMAT);
+  cdr.write_ulong (id);
+  write_text (cdr, ACE_TEXT_ALWAYS_CHAR (format));
+  if (end_record (cdr, length) == -1)
+    return -1;
+  return this->append (cdr);
+}
+
+int
+ACE_Log_Binary_Writer::log (ACE_Log_Msg &log_msg,
+                            ACE_Log_Priority priority,
+                            const ACE_TCHAR *format,
+                            va_list argp,
+                            ACE_Log_Category_TSS *category)
+{
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  ACE_Time_Value const now = ACE_OS::gettimeofday ();
+
+  char buf[ACE_Log_Record::MAXLOGMSGLEN + ACE_CDR::MAX_ALIGNMENT];
+  ACE_OutputCDR cdr (buf, sizeof buf);
+  char *const length = begin_record (cdr, ACE_LOG_BINARY_BINARY);
+  cdr << ACE_CDR::Long (priority);
+  cdr << ACE_CDR::Long (log_msg.getpid ());
+  cdr << ACE_CDR::LongLong (now.sec ());
+  cdr << ACE_CDR::Long (now.usec ());
+  write_category (cdr, category);
+  char *const id = cdr.write_long_placeholder ();
+
+  // Record the values of the directives, parsing the format as
+  // ACE_Log_Msg::log() does.
+  va_list ap;
+  va_copy (ap, argp);
+  int result = 0;
+  const ACE_TCHAR *f = format;
+  while (*f != '\0' && result == 0)
+    {
+      if (*f++ != '%')
+        continue;
+      if (*f == '%')
+        {
+          ++f;
+          continue;
+        }
+
+      bool const time_value = *f == '#';
+      for (; *f != '\0' && ACE_OS::strchr (flag_chars, *f) != 0; ++f)
+        if (*f == '*')
+          cdr.write_long (va_arg (ap, int));
+
+      switch (*f)
+        {
+        case '\0':
+          continue;
+
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        case 'c': case 'S':
+          cdr.write_long (va_arg (ap, int));
+          break;
+
+        case 'R':
+          {
+            int const status = va_arg (ap, int);
+            log_msg.op_status (status);
+            cdr.write_long (status);
+          }
+          break;
+
+        case 'A': case 'F': case 'f': case 'e': case 'E': case 'g': case 'G':
+          cdr.write_double (va_arg (ap, double));
+          break;
+
+        case 'Q':
+          cdr.write_ulonglong (va_arg (ap, ACE_UINT64));
+          break;
+
+        case 'q':
+          cdr.write_longlong (va_arg (ap, ACE_INT64));
+          break;
+
+        case 'b':
+          cdr.write_longlong (va_arg (ap, ssize_t));
+          break;
+
+        case 'B':
+          cdr.write_ulonglong (va_arg (ap, size_t));
+          break;
+
+        case ':':
+          cdr.write_longlong (va_arg (ap, time_t));
+          break;
+
+        case '@':
+          cdr.write_ulonglong (reinterpret_cast<uintptr_t> (va_arg (ap, void *)));
+          break;
+
+        case 's':
+          {
+            const ACE_TCHAR *const str = va_arg (ap, ACE_TCHAR *);
+            write_text (cdr, str != 0 ? ACE_TEXT_ALWAYS_CHAR (str) : 0);
+          }
+          break;
+
+        case 'C':
+          write_text (cdr, va_arg (ap, char *));
+          break;
+
+        case 'p':
+          {
+            const ACE_TCHAR *const str = va_arg (ap, ACE_TCHAR *);
+            write_text (cdr, str != 0 ? ACE_TEXT_ALWAYS_CHAR (str) : 0);
+            cdr.write_long (log_msg.errnum ());
+          }
+          break;
+
+        case 'm':
+          cdr.write_long (log_msg.errnum ());
+          break;
+
+        case 'l':
+          cdr.write_long (log_msg.linenum ());
+          break;
+
+        case 'N':
+          write_text (cdr,
+                      log_msg.file () != 0
+                        ? log_msg.file ()
+                        : "<unknown file>");
+          break;
+
+        case 'n':
+          write_text (cdr,
+                      ACE_Log_Msg::program_name () != 0
+                        ? ACE_TEXT_ALWAYS_CHAR (ACE_Log_Msg::program_name ())
+                        : "<unknown>");
+          break;
+
+        case 't':
+          {
+#if defined (ACE_WIN32)
+            cdr.write_ulonglong (static_cast<unsigned> (ACE_Thread::self ()));
+#else
+            ACE_hthread_t t_id;
+            ACE_OS::thr_self (t_id);
+            cdr.write_ulonglong ((unsigned long) t_id);
+#endif /* ACE_WIN32 */
+          }
+          break;
+
+        case 'D': case 'T':
+          // Without an argument, the time stamp of the record is used.
+          if (time_value)
+            {
+              const ACE_Time_Value *const tv = va_arg (ap, ACE_Time_Value *);
+              cdr.write_longlong (tv->sec ());
+              cdr.write_long (tv->usec ());
+            }
+          break;
+
+        case 'P': case 'M':
+          // From the header of the record.
+          break;
+
+        case 'a': case 'r': case '{': case '}': case '$': case 'I':
+        case 'w': case 'W': case 'z': case 'Z': case '?':
+          // These have side effects, or arguments that can't be copied.
+          errno = ENOTSUP;
+          result = -1;
+          break;
+
+        default:
+          // Not a directive: printed as is.
+          break;
+        }
+      ++f;
+    }
+  va_end (ap);
+
+  if (result == -1 || end_record (cdr, length) == -1)
+    return -1;
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  ACE_UINT32 format_number = 0;
+  if (this->format_id (format, format_number) == -1)
+    return -1;
+  cdr.replace (static_cast<ACE_CDR::Long> (format_number), id);
+  if (this->append (cdr) == -1)
+    return -1;
+
+  // The message is in the log now: should writing it out fail, it
+  // must not be recorded again as text.
+  if (priority >= LM_ERROR)
+    this->flush_i ();
+  return 0;
+}
+
+int
+ACE_Log_Binary_Writer::log (ACE_Log_Record &log_record)
+{
+  char buf[ACE_Log_Record::MAXLOGMSGLEN + ACE_CDR::MAX_ALIGNMENT];
+  ACE_OutputCDR cdr (buf, sizeof buf);
+  char *const length = begin_record (cdr, ACE_LOG_BINARY_TEXT);
+  write_category (cdr, log_record.category ());
+  cdr << log_record;
+  if (end_record (cdr, length) == -1)
+    return -1;
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    {
+      errno = EBADF;
+      return -1;
+    }
+  if (this->append (cdr) == -1)
+    return -1;
+  return log_record.type () >= LM_ERROR ? this->flush_i () : 0;
+}
+
+ACE_UINT64
+ACE_Log_Binary_Writer::size (void) const
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX,
+                    ace_mon,
+                    const_cast<ACE_SYNCH_MUTEX &> (this->lock_),
+                    0);
+  return this->size_ + this->length_;
+}
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Log_Binary_Reader)
+
+ACE_Log_Binary_Reader::ACE_Log_Binary_Reader (void)
+  : fp_ (0),
+    buffer_ (0),
+    buffer_size_ (0),
+    msg_ (0)
+{
+}
+
+ACE_Log_Binary_Reader::~ACE_Log_Binary_Reader (void)
+{
+  this->close ();
+  delete [] reinterpret_cast<ACE_CDR::LongLong *> (this->buffer_);
+  delete [] this->msg_;
+}
+
+int
+ACE_Log_Binary_Reader::open (const ACE_TCHAR *path)
+{
+  if (this->fp_ != 0)
+    {
+      errno = EISCONN;
+      return -1;
+    }
+  if (this->msg_ == 0)
+    ACE_NEW_RETURN (this->msg_, ACE_TCHAR[ACE_MAXLOGMSGLEN + 1], -1);
+
+  this->fp_ = ACE_OS::fopen (path, ACE_TEXT ("rb"));
+  if (this->fp_ == 0)
+    return -1;
+  this->formats_.clear ();
+  this->program_name_.clear ();
+  this->host_name_.clear ();
+  this->category_.clear ();
+  return 0;
+}
+
+int
+ACE_Log_Binary_Reader::close (void)
+{
+  if (this->fp_ == 0)
+    return 0;
+  int const result = ACE_OS::fclose (this->fp_);
+  this->fp_ = 0;
+  return result;
+}
+
+const ACE_TCHAR *
+ACE_Log_Binary_Reader::program_name (void) const
+{
+  return this->program_name_.c_str ();
+}
+
+const ACE_TCHAR *
+ACE_Log_Binary_Reader::host_name (void) const
+{
+  return this->host_name_.c_str ();
+}
+
+const ACE_TCHAR *
+ACE_Log_Binary_Reader::category (void) const
+{
+  return this->category_.c_str ();
+}
+
+ssize_t
+ACE_Log_Binary_Reader::read_record (void)
+{
+  if (this->fp_ == 0)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  if (this->buffer_size_ < ACE_Log_Record::MAXVERBOSELOGMSGLEN)
+    {
+      // Allocated as 8-byte words, to be aligned for CDR.
+      size_t const words =
+        ACE_Log_Record::MAXVERBOSELOGMSGLEN / sizeof (ACE_CDR::LongLong) + 1;
+      ACE_CDR::LongLong *words_buffer = 0;
+      ACE_NEW_RETURN (words_buffer, ACE_CDR::LongLong[words], -1);
+      this->buffer_ = reinterpret_cast<char *> (words_buffer);
+      this->buffer_size_ = words * sizeof (ACE_CDR::LongLong);
+    }
+
+  size_t const n = ACE_OS::fread (this->buffer_, 1, record_header_size, this->fp_);
+  if (n == 0)
+    return 0;
+  if (n != record_header_size)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_InputCDR header (this->buffer_, record_header_size, this->buffer_[0]);
+  ACE_CDR::ULong length = 0;
+  if (!header.skip_bytes (4)
+      || !header.read_ulong (length)
+      || length < record_header_size
+      || length % 8 != 0
+      || length > max_record_size)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (length > this->buffer_size_)
+    {
+      size_t const words = length / sizeof (ACE_CDR::LongLong);
+      ACE_CDR::LongLong *words_buffer = 0;
+      ACE_NEW_RETURN (words_buffer, ACE_CDR::LongLong[words], -1);
+      ACE_OS::memcpy (words_buffer, this->buffer_, record_header_size);
+      delete [] reinterpret_cast<ACE_CDR::LongLong *> (this->buffer_);
+      this->buffer_ = reinterpret_cast<char *> (words_buffer);
+      this->buffer_size_ = length;
+    }
+
+  size_t const body = length - record_header_size;
+  if (ACE_OS::fread (this->buffer_ + record_header_size, 1, body, this->fp_)
+      != body)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  return static_cast<ssize_t> (length);
+}
+
+int
+ACE_Log_Binary_Reader::read (ACE_Log_Record &log_record)
+{
+  for (;;)
+    {
+      ssize_t const length = this->read_record ();
+      if (length <= 0)
+        return static_cast<int> (length);
+
+      ACE_InputCDR cdr (this->buffer_,
+                        static_cast<size_t> (length),
+                        this->buffer_[0]);
+      ACE_CDR::Octet const kind =
+        static_cast<ACE_CDR::Octet> (this->buffer_[1]);
+      cdr.skip_bytes (record_header_size);
+
+      switch (kind)
+        {
+        case ACE_LOG_BINARY_HEADER:
+          {
+            ACE_CDR::ULong version = 0;
+            const char *program_name = 0;
+            const char *host_name = 0;
+            if (!cdr.read_ulong (version)
+                || version != log_binary_version
+                || !read_text (cdr, program_name)
+                || !read_text (cdr, host_name))
+              {
+                errno = EINVAL;
+                return -1;
+              }
+            this->program_name_ = ACE_TEXT_CHAR_TO_TCHAR (program_name);
+            this->host_name_ = ACE_TEXT_CHAR_TO_TCHAR (host_name);
+          }
+          break;
+
+        case ACE_LOG_BINARY_FORMAT:
+          {
+            ACE_CDR::ULong id = 0;
+            const char *text = 0;
+            if (!cdr.read_ulong (id)
+                || !read_text (cdr, text)
+                || id > this->formats_.size ())
+              {
+                errno = EINVAL;
+                return -1;
+              }
+            if (id == this->formats_.size ())
+              this->formats_.push_back (ACE_TString ());
+            this->formats_[id] = ACE_TEXT_CHAR_TO_TCHAR (text);
+          }
+          break;
+
+        case ACE_LOG_BINARY_BINARY:
+          {
+            ACE_CDR::Long type = 0;
+            ACE_CDR::Long pid = 0;
+            ACE_CDR::LongLong sec = 0;
+            ACE_CDR::Long usec = 0;
+            const char *category = 0;
+            ACE_CDR::ULong id = 0;
+            if (!(cdr >> type) || !(cdr >> pid) || !(cdr >> sec)
+                || !(cdr >> usec) || !read_text (cdr, category)
+                || !(cdr >> id)
+                || id >= this->formats_.size ())
+              {
+                errno = EINVAL;
+                return -1;
+              }
+            this->category_ = ACE_TEXT_CHAR_TO_TCHAR (category);
+            log_record.type (type);
+            log_record.pid (pid);
+            log_record.time_stamp (ACE_Time_Value (static_cast<time_t> (sec),
+                                                   usec));
+            if (this->format (cdr, this->formats_[id].c_str (), log_record) == -1)
+              {
+                errno = EINVAL;
+                return -1;
+              }
+          }
+          return 1;
+
+        case ACE_LOG_BINARY_TEXT:
+          {
+            const char *category = 0;
+            if (!read_text (cdr, category) || !(cdr >> log_record))
+              {
+                errno = EINVAL;
+                return -1;
+              }
+            this->category_ = ACE_TEXT_CHAR_TO_TCHAR (category);
+          }
+          return 1;
+
+        default:
+          // Left for later versions.
+          break;
+        }
+    }
+}
+
+int
+ACE_Log_Binary_Reader::format (ACE_InputCDR &cdr,
+                               const ACE_TCHAR *format_str,
+                               ACE_Log_Record &log_record)
+{
+  ACE_Log_Priority const priority =
+    static_cast<ACE_Log_Priority> (log_record.type ());
+
+  ACE_TCHAR *bp = this->msg_;
+  size_t bspace = ACE_MAXLOGMSGLEN;  // Leave room for Nul term.
+  *bp = '\0';
+
+  while (*format_str != '\0' && bspace > 0)
+    {
+      if (*format_str != '%')
+        {
+          *bp++ = *format_str++;
+          --bspace;
+          continue;
+        }
+      if (format_str[1] == '%')
+        {
+          *bp++ = *format_str;
+          format_str += 2;
+          --bspace;
+          continue;
+        }
+
+      // Rebuild the format specifier, with the recorded values of the
+      // '*' width and precision, and convert the directive to the
+      // equivalent sprintf conversion, as ACE_Log_Msg::log() does.
+      const ACE_TCHAR *start_format = format_str;
+      ACE_TCHAR format[128];
+      ACE_TCHAR *fp = format;
+      int this_len = 0;
+      bool literal = false;
+
+      *fp++ = *format_str++;   // Copy in the %
+      for (;
+           *format_str != '\0' && ACE_OS::strchr (flag_chars, *format_str) != 0;
+           ++format_str)
+        {
+          if (fp - format > 100)
+            return -1;
+          if (*format_str == '*')
+            {
+              ACE_CDR::Long wp = 0;
+              if (!cdr.read_long (wp))
+                return -1;
+              fp += ACE_OS::sprintf (fp, ACE_TEXT ("%d"), static_cast<int> (wp));
+            }
+          else
+            *fp++ = *format_str;
+        }
+      *fp = '\0';
+
+      switch (*format_str)
+        {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+          {
+            ACE_CDR::Long value = 0;
+            if (!cdr.read_long (value))
+              return -1;
+            fp[0] = *format_str;
+            fp[1] = '\0';
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         static_cast<int> (value));
+          }
+          break;
+
+        case 'c':
+          {
+            ACE_CDR::Long value = 0;
+            if (!cdr.read_long (value))
+              return -1;
+#if defined (ACE_WIN32) && defined (ACE_USES_WCHAR)
+            ACE_OS::strcpy (fp, ACE_TEXT ("C"));
+#else
+            ACE_OS::strcpy (fp, ACE_TEXT ("c"));
+#endif /* ACE_WIN32 && ACE_USES_WCHAR */
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         static_cast<int> (value));
+          }
+          break;
+
+        case 'R': case 'l':
+          {
+            ACE_CDR::Long value = 0;
+            if (!cdr.read_long (value))
+              return -1;
+            ACE_OS::strcpy (fp, ACE_TEXT ("d"));
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         static_cast<int> (value));
+          }
+          break;
+
+        case 'S':
+          {
+            ACE_CDR::Long sig = 0;
+            if (!cdr.read_long (sig))
+              return -1;
+            ACE_OS::strcpy (fp, ACE_TEXT ("s"));
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         ACE_OS::strsignal (sig));
+          }
+          break;
+
+        case 'A': case 'F': case 'f': case 'e': case 'E': case 'g': case 'G':
+          {
+            ACE_CDR::Double value = 0;
+            if (!cdr.read_double (value))
+              return -1;
+            if (*format_str == 'A')
+              ACE_OS::strcpy (fp, ACE_TEXT ("f"));
+            else
+              {
+                fp[0] = *format_str;
+                fp[1] = '\0';
+              }
+            this_len = ACE_OS::snprintf (bp, bspace, format, value);
+          }
+          break;
+
+        case 'Q': case 'B': case '@':
+          {
+            ACE_CDR::ULongLong value = 0;
+            if (!cdr.read_ulonglong (value))
+              return -1;
+            if (*format_str == 'Q')
+              {
+                const ACE_TCHAR *fmt = ACE_UINT64_FORMAT_SPECIFIER;
+                ACE_OS::strcpy (fp, &fmt[1]);    // Skip leading %
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             static_cast<ACE_UINT64> (value));
+              }
+            else if (*format_str == 'B')
+              {
+                const ACE_TCHAR *fmt = ACE_SIZE_T_FORMAT_SPECIFIER;
+                ACE_OS::strcpy (fp, &fmt[1]);    // Skip leading %
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             static_cast<size_t> (value));
+              }
+            else
+              {
+                ACE_OS::strcpy (fp, ACE_TEXT ("p"));
+                this_len = ACE_OS::snprintf
+                  (bp, bspace, format,
+                   reinterpret_cast<void *> (static_cast<uintptr_t> (value)));
+              }
+          }
+          break;
+
+        case 'q': case 'b': case ':':
+          {
+            ACE_CDR::LongLong value = 0;
+            if (!cdr.read_longlong (value))
+              return -1;
+            if (*format_str == 'q')
+              {
+                const ACE_TCHAR *fmt = ACE_INT64_FORMAT_SPECIFIER;
+                ACE_OS::strcpy (fp, &fmt[1]);    // Skip leading %
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             static_cast<ACE_INT64> (value));
+              }
+            else if (*format_str == 'b')
+              {
+                const ACE_TCHAR *fmt = ACE_SSIZE_T_FORMAT_SPECIFIER;
+                ACE_OS::strcpy (fp, &fmt[1]);    // Skip leading %
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             static_cast<ssize_t> (value));
+              }
+            else
+              {
+                // Assume a 32 bit time_t and change if needed.
+                const ACE_TCHAR *fmt = ACE_TEXT ("%d");
+                if (sizeof (time_t) == 8)
+                  fmt = ACE_INT64_FORMAT_SPECIFIER;
+                ACE_OS::strcpy (fp, &fmt[1]);    // Skip leading %
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             static_cast<time_t> (value));
+              }
+          }
+          break;
+
+        case 's': case 'N': case 'n':
+          {
+            const char *str = 0;
+            if (!read_text (cdr, str))
+              return -1;
+            ACE_OS::strcpy (fp, ACE_LOG_BINARY_TSTRING);
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         ACE_TEXT_CHAR_TO_TCHAR (str));
+          }
+          break;
+
+        case 'C':
+          {
+            const char *str = 0;
+            if (!read_text (cdr, str))
+              return -1;
+#if defined (ACE_WIN32) && defined (ACE_USES_WCHAR)
+            ACE_OS::strcpy (fp, ACE_TEXT ("S"));
+#else
+            ACE_OS::strcpy (fp, ACE_TEXT ("s"));
+#endif /* ACE_WIN32 && ACE_USES_WCHAR */
+            this_len = ACE_OS::snprintf (bp, bspace, format, str);
+          }
+          break;
+
+        case 'p': case 'm':
+          {
+            const char *str = 0;
+            ACE_CDR::Long errnum = 0;
+            if ((*format_str == 'p' && !read_text (cdr, str))
+                || !cdr.read_long (errnum))
+              return -1;
+            const char *const msg = ACE_OS::strerror (ACE::map_errno (errnum));
+            if (*format_str == 'p')
+              {
+#if !defined (ACE_WIN32) && defined (ACE_USES_WCHAR)
+                ACE_OS::strcpy (fp, ACE_TEXT ("ls: %ls"));
+#else
+                ACE_OS::strcpy (fp, ACE_TEXT ("s: %s"));
+#endif /* !ACE_WIN32 && ACE_USES_WCHAR */
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             ACE_TEXT_CHAR_TO_TCHAR (str),
+                                             ACE_TEXT_CHAR_TO_TCHAR (msg));
+              }
+            else
+              {
+                ACE_OS::strcpy (fp, ACE_LOG_BINARY_TSTRING);
+                this_len = ACE_OS::snprintf (bp, bspace, format,
+                                             ACE_TEXT_CHAR_TO_TCHAR (msg));
+              }
+          }
+          break;
+
+        case 'P':
+#if defined (ACE_OPENVMS)
+          ACE_OS::strcpy (fp, ACE_TEXT ("x"));
+#else
+          ACE_OS::strcpy (fp, ACE_TEXT ("d"));
+#endif /* ACE_OPENVMS */
+          this_len = ACE_OS::snprintf (bp, bspace, format,
+                                       static_cast<int> (log_record.pid ()));
+          break;
+
+        case 'M':
+          if (format[1] == ACE_TEXT ('.') && format[2] == ACE_TEXT ('1'))
+            {
+              fp = format + 1;
+#if defined (ACE_USES_WCHAR)
+# if defined (ACE_WIN32)
+              ACE_OS::strcpy (fp, ACE_TEXT ("c"));
+# else
+              ACE_OS::strcpy (fp, ACE_TEXT ("lc"));
+# endif /* ACE_WIN32 */
+              this_len = ACE_OS::snprintf (bp, bspace, format,
+                                           (wint_t) priority_letter (priority));
+#else
+              ACE_OS::strcpy (fp, ACE_TEXT ("c"));
+              this_len = ACE_OS::snprintf (bp, bspace, format,
+                                           (int) priority_letter (priority));
+#endif /* ACE_USES_WCHAR */
+            }
+          else
+            {
+              ACE_OS::strcpy (fp, ACE_LOG_BINARY_TSTRING);
+              this_len = ACE_OS::snprintf
+                (bp, bspace, format,
+                 ACE_Log_Record::priority_name (priority));
+            }
+          break;
+
+        case 't':
+          {
+            ACE_CDR::ULongLong t_id = 0;
+            if (!cdr.read_ulonglong (t_id))
+              return -1;
+#if defined (ACE_WIN32)
+            ACE_OS::strcpy (fp, ACE_TEXT ("u"));
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         static_cast<unsigned> (t_id));
+#else
+            ACE_OS::strcpy (fp, ACE_TEXT ("lu"));
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         static_cast<unsigned long> (t_id));
+#endif /* ACE_WIN32 */
+          }
+          break;
+
+        case 'D': case 'T':
+          {
+            ACE_Time_Value tv = log_record.time_stamp ();
+            if (format[1] == ACE_TEXT ('#'))
+              {
+                ACE_CDR::LongLong sec = 0;
+                ACE_CDR::Long usec = 0;
+                if (!cdr.read_longlong (sec) || !cdr.read_long (usec))
+                  return -1;
+                tv.set (static_cast<time_t> (sec), usec);
+              }
+            ACE_TCHAR day_and_time[27];
+            const ACE_TCHAR *const s =
+              ACE::timestamp (tv,
+                              day_and_time,
+                              sizeof (day_and_time) / sizeof (ACE_TCHAR));
+            ACE_OS::strcpy (fp, ACE_LOG_BINARY_TSTRING);
+            this_len = ACE_OS::snprintf (bp, bspace, format,
+                                         *format_str == 'D' ? day_and_time : s);
+          }
+          break;
+
+        case '\0':
+          // The format ends in the middle of a directive.
+          literal = true;
+          --format_str;
+          break;
+
+        default:
+          // Not a directive after all: copy it as is.
+          literal = true;
+          break;
+        }
+
+      if (literal)
+        {
+          while (start_format != format_str + 1 && bspace > 0)
+            {
+              *bp++ = *start_format++;
+              --bspace;
+            }
+          *bp = '\0';
+        }
+      else
+        {
+          ACE_UPDATE_COUNT (bspace, this_len);
+          bp += ACE_OS::strlen (bp);
+        }
+      ++format_str;
+    }
+
+  *bp = '\0';
+  return log_record.msg_data (this->msg_);
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,243 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Log_Binary.h
+ *
+ *  $Id$
+ *
+ *  Binary logging: messages are recorded with their format string and
+ *  the raw values of their arguments, and formatted offline.
+ */
+//=============================================================================
+
+#ifndef ACE_LOG_BINARY_H
+#define ACE_LOG_BINARY_H
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/config-all.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Log_Priority.h"
+#include "ace/Hash_Map_Manager_T.h"
+#include "ace/Functor_T.h"
+#include "ace/Null_Mutex.h"
+#include "ace/Synch_Traits.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Vector_T.h"
+#include "ace/SString.h"
+
+#include <stdarg.h>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+class ACE_Log_Msg;
+class ACE_Log_Record;
+class ACE_Log_Category_TSS;
+class ACE_InputCDR;
+class ACE_OutputCDR;
+
+/**
+ * @class ACE_Log_Binary_Writer
+ *
+ * @brief Records log messages in binary form, leaving their
+ * formatting to ACE_Log_Binary_Reader.
+ *
+ * When the @c BINARY flag of ACE_Log_Msg is set and a writer has been
+ * given to ACE_Log_Msg::binary_writer(), the messages aren't formatted
+ * on the spot.  Instead, the writer copies the values of their
+ * arguments, and of the ACE_Log_Msg state some directives print, such
+ * as the line number for @c %l, into a compact CDR-encoded record,
+ * and refers to the format string by a number.  The text of each
+ * format string is only recorded the first time it's used.  Records
+ * are buffered and written out when the buffer is full, after each
+ * message of priority @c LM_ERROR or above, and by flush().
+ *
+ * The directives that have side effects or need more than their
+ * arguments, i.e., @c %a, @c %r, @c %{, @c %}, @c %$, @c %I, @c %?,
+ * and the wide-character ones, @c %w, @c %W, @c %z and @c %Z, can't
+ * be deferred: such messages are formatted by ACE_Log_Msg as usual
+ * and recorded as text, as are the messages logged with a callback or
+ * a timestamp prefix.
+ *
+ * The messages go to the writer instead of the other destinations of
+ * ACE_Log_Msg.  The program name prefix of @c VERBOSE isn't recorded;
+ * ACE_Log_Binary_Reader provides the program name and host name, and
+ * the name of the category of each message.
+ */
+class ACE_Export ACE_Log_Binary_Writer
+{
+public:
+  ACE_Log_Binary_Writer (void);
+
+  /// Close the log.
+  ~ACE_Log_Binary_Writer (void);
+
+  /// Create the binary log @a path, overwriting any existing file.
+  int open (const ACE_TCHAR *path);
+
+  /// Write out the buffered records and close the log.
+  int close (void);
+
+  /// Write out the buffered records.  Also fails if writing out
+  /// records failed since the last flush(), with that @c errno.
+  int flush (void);
+
+  /**
+   * Record the message of @a priority in @a category that @a log_msg
+   * would format from @a format and @a argp.  Returns -1 with @c errno
+   * set to @c ENOTSUP, without consuming @a argp, if @a format has
+   * directives that can't be deferred.  Only returns -1 if the
+   * message was not recorded, so that ACE_Log_Msg can record it as
+   * text instead; once it is recorded, failing to write it out is
+   * reported by the next flush() or close().
+   */
+  int log (ACE_Log_Msg &log_msg,
+           ACE_Log_Priority priority,
+           const ACE_TCHAR *format,
+           va_list argp,
+           ACE_Log_Category_TSS *category = 0);
+
+  /// Record a message that has already been formatted.
+  int log (ACE_Log_Record &log_record);
+
+  /// Number of bytes written to the log so far.
+  ACE_UINT64 size (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// A format string, with the number it's known by in the log.
+  struct Format
+  {
+    ACE_UINT32 id_;
+    ACE_TCHAR *text_;
+  };
+
+  typedef ACE_Hash_Map_Manager_Ex<const void *,
+                                  Format *,
+                                  ACE_Pointer_Hash<const void *>,
+                                  ACE_Equal_To<const void *>,
+                                  ACE_Null_Mutex> FORMAT_MAP;
+
+  /// Get the number of @a format, recording its text if it's new or
+  /// has changed; the caller holds <lock_>.
+  int format_id (const ACE_TCHAR *format, ACE_UINT32 &id);
+
+  /// Append the record encoded in @a cdr to the buffer; the caller
+  /// holds <lock_>.
+  int append (ACE_OutputCDR &cdr);
+
+  /// Write out the buffer; the caller holds <lock_>.
+  int flush_i (void);
+
+  ACE_HANDLE handle_;
+
+  /// @c errno of the last failure to write out records, 0 if none
+  /// since the last flush().
+  int write_errno_;
+
+  /// Records not written out yet.
+  char *buffer_;
+  size_t length_;
+
+  ACE_UINT64 size_;
+
+  /// The format strings seen so far, by address.
+  FORMAT_MAP formats_;
+  ACE_UINT32 next_id_;
+
+  ACE_SYNCH_MUTEX lock_;
+
+  // = Disallow copying.
+  ACE_UNIMPLEMENTED_FUNC (ACE_Log_Binary_Writer (const ACE_Log_Binary_Writer &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Log_Binary_Writer &))
+};
+
+/**
+ * @class ACE_Log_Binary_Reader
+ *
+ * @brief Formats the messages of a log written by
+ * ACE_Log_Binary_Writer.
+ *
+ * The messages come out as ACE_Log_Record objects, with the text
+ * ACE_Log_Msg would have given them, which can be printed with the
+ * verbose headers of one's choice.  The log can be read on another
+ * host than the one that wrote it; the messages of @c %m, @c %p and
+ * @c %S are those of the reading host, though.
+ */
+class ACE_Export ACE_Log_Binary_Reader
+{
+public:
+  ACE_Log_Binary_Reader (void);
+
+  /// Close the log.
+  ~ACE_Log_Binary_Reader (void);
+
+  /// Open the binary log @a path.
+  int open (const ACE_TCHAR *path);
+
+  /// Close the log.
+  int close (void);
+
+  /**
+   * Read the next message and format it into @a log_record.
+   *
+   * @retval 1 if a message was read.
+   * @retval 0 at the end of the log.
+   * @retval -1 if the log is corrupted or can't be read.
+   */
+  int read (ACE_Log_Record &log_record);
+
+  /// Name of the program that wrote the log.
+  const ACE_TCHAR *program_name (void) const;
+
+  /// Name of the host the log was written on, if known.
+  const ACE_TCHAR *host_name (void) const;
+
+  /// Name of the category of the last message read, empty if it was
+  /// logged without one.
+  const ACE_TCHAR *category (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// Read the next record into <buffer_>, returning its size, 0 at the
+  /// end of the log or -1.
+  ssize_t read_record (void);
+
+  /// Format the message of @a format from the arguments in @a cdr.
+  int format (ACE_InputCDR &cdr,
+              const ACE_TCHAR *format,
+              ACE_Log_Record &log_record);
+
+  FILE *fp_;
+
+  /// The current record, aligned for CDR.
+  char *buffer_;
+  size_t buffer_size_;
+
+  /// The format strings, by number.
+  ACE_Vector<ACE_TString> formats_;
+
+  ACE_TString program_name_;
+  ACE_TString host_name_;
+  ACE_TString category_;
+
+  /// Where messages are formatted.
+  ACE_TCHAR *msg_;
+
+  // = Disallow copying.
+  ACE_UNIMPLEMENTED_FUNC (ACE_Log_Binary_Reader (const ACE_Log_Binary_Reader &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Log_Binary_Reader &))
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#include /**/ "ace/post.h"
+#endif /* ACE_LOG_BINARY_H */
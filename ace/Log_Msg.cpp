@@ -33,6 +33,7 @@
 #endif /* ACE_HAS_TRACE */
 
 #include "ace/Log_Msg.h"
+#include "ace/Log_Binary.h"
 #include "ace/Log_Msg_Callback.h"
 #include "ace/Log_Msg_IPC.h"
 #include "ace/Log_Msg_NT_Event_Log.h"
@@ -115,6 +116,7 @@ class ACE_Log_Msg_Manager
 public:
   static ACE_Log_Msg_Backend *log_backend_;
   static ACE_Log_Msg_Backend *custom_backend_;
+  static ACE_Log_Binary_Writer *binary_writer_;
 
   static u_long log_backend_flags_;
 
@@ -134,6 +136,7 @@ private:
 
 ACE_Log_Msg_Backend *ACE_Log_Msg_Manager::log_backend_ = 0;
 ACE_Log_Msg_Backend *ACE_Log_Msg_Manager::custom_backend_ = 0;
+ACE_Log_Binary_Writer *ACE_Log_Msg_Manager::binary_writer_ = 0;
 
 u_long ACE_Log_Msg_Manager::log_backend_flags_ = 0;
 
@@ -229,6 +232,9 @@ ACE_Log_Msg_Manager::close (void)
 
   // we are never responsible for custom backend
   ACE_Log_Msg_Manager::custom_backend_ = 0;
+
+  // nor for the binary log
+  ACE_Log_Msg_Manager::binary_writer_ = 0;
 }
 
 # if defined (ACE_HAS_THREAD_SPECIFIC_STORAGE) || \
@@ -841,7 +847,11 @@ ACE_Log_Msg::open (const ACE_TCHAR *prog_name,
         ACE_Log_Msg_Manager::custom_backend_->open (logger_key);
 
       if (status != -1)
-        ACE_SET_BITS (ACE_Log_Msg::flags_, ACE_Log_Msg::CUSTOM);
+        {
+          ACE_SET_BITS (ACE_Log_Msg::flags_, ACE_Log_Msg::CUSTOM);
+          if (ACE_BIT_ENABLED (flags, ACE_Log_Msg::ASYNC))
+            ACE_SET_BITS (ACE_Log_Msg::flags_, ACE_Log_Msg::ASYNC);
+        }
     }
 
   // Remember, ACE_Log_Msg::STDERR bit is on by default...
@@ -881,6 +891,11 @@ ACE_Log_Msg::open (const ACE_TCHAR *prog_name,
     ACE_SET_BITS (ACE_Log_Msg::flags_,
                   ACE_Log_Msg::SILENT);
 
+  if (ACE_BIT_ENABLED (flags,
+                       ACE_Log_Msg::BINARY))
+    ACE_SET_BITS (ACE_Log_Msg::flags_,
+                  ACE_Log_Msg::BINARY);
+
   return status;
 }
 
@@ -1006,6 +1021,21 @@ ACE_Log_Msg::log (const ACE_TCHAR *format_str,
   // errno!
   ACE_Errno_Guard guard (errno);
 
+  // Leave the formatting to the reader of the binary log if the
+  // directives allow it.
+  if (ACE_BIT_ENABLED (ACE_Log_Msg::flags_, ACE_Log_Msg::BINARY)
+      && ACE_BIT_DISABLED (ACE_Log_Msg::flags_, ACE_Log_Msg::SILENT)
+      && ACE_BIT_DISABLED (ACE_Log_Msg::flags_, ACE_Log_Msg::MSG_CALLBACK)
+      && ACE_Log_Msg_Manager::binary_writer_ != 0
+      && this->timestamp_ == 0
+      && ACE_Log_Msg::msg_off_ == 0
+      && ACE_Log_Msg_Manager::binary_writer_->log (*this,
+                                                   log_priority,
+                                                   format_str,
+                                                   argp,
+                                                   category) == 0)
+    return 0;
+
   ACE_Log_Record log_record (log_priority,
                              ACE_OS::gettimeofday (),
                              this->getpid ());
@@ -2237,6 +2267,31 @@ ACE_Log_Msg::log (ACE_Log_Record &log_record,
           && this->msg_callback () != 0)
         this->msg_callback ()->log (log_record);
 
+      // An asynchronous backend takes care of serializing the output.
+      if (ACE_BIT_ENABLED (ACE_Log_Msg::flags_, ACE_Log_Msg::ASYNC)
+          && ACE_BIT_ENABLED (ACE_Log_Msg::flags_, ACE_Log_Msg::CUSTOM)
+          && ACE_Log_Msg_Manager::custom_backend_ != 0)
+        {
+          result =
+            ACE_Log_Msg_Manager::custom_backend_->log (log_record);
+
+          if (tracing)
+            this->start_tracing ();
+          return result;
+        }
+
+      // The binary log takes care of serializing the output too.
+      if (ACE_BIT_ENABLED (ACE_Log_Msg::flags_, ACE_Log_Msg::BINARY)
+          && ACE_Log_Msg_Manager::binary_writer_ != 0)
+        {
+          result =
+            ACE_Log_Msg_Manager::binary_writer_->log (log_record);
+
+          if (tracing)
+            this->start_tracing ();
+          return result;
+        }
+
       // Make sure that the lock is held during all this.
       ACE_MT (ACE_GUARD_RETURN (ACE_Recursive_Thread_Mutex, ace_mon,
                                 *ACE_Log_Msg_Manager::get_lock (),
@@ -2479,6 +2534,28 @@ ACE_Log_Msg::msg_backend (void)
   return ACE_Log_Msg_Manager::custom_backend_;
 }
 
+ACE_Log_Binary_Writer *
+ACE_Log_Msg::binary_writer (ACE_Log_Binary_Writer *w)
+{
+  ACE_TRACE ("ACE_Log_Msg::binary_writer");
+  ACE_MT (ACE_GUARD_RETURN (ACE_Recursive_Thread_Mutex, ace_mon,
+                            *ACE_Log_Msg_Manager::get_lock (), 0));
+
+  ACE_Log_Binary_Writer *tmp = ACE_Log_Msg_Manager::binary_writer_;
+  ACE_Log_Msg_Manager::binary_writer_ = w;
+  return tmp;
+}
+
+ACE_Log_Binary_Writer *
+ACE_Log_Msg::binary_writer (void)
+{
+  ACE_TRACE ("ACE_Log_Msg::binary_writer");
+  ACE_MT (ACE_GUARD_RETURN (ACE_Recursive_Thread_Mutex, ace_mon,
+                            *ACE_Log_Msg_Manager::get_lock (), 0));
+
+  return ACE_Log_Msg_Manager::binary_writer_;
+}
+
 void
 ACE_Log_Msg::msg_ostream (ACE_OSTREAM_TYPE *m, bool delete_ostream)
 {
@@ -135,6 +135,7 @@ ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
 class ACE_Log_Msg_Callback;
 class ACE_Log_Msg_Backend;
+class ACE_Log_Binary_Writer;
 
 // ****************************************************************
 
@@ -202,7 +203,14 @@ public:
     /// Write messages to the system's event log.
     SYSLOG = 128,
     /// Write messages to the user provided backend
-    CUSTOM = 256
+    CUSTOM = 256,
+    /// With CUSTOM, only write messages to the user provided backend,
+    /// without serializing the calls; the backend must be thread-safe,
+    /// e.g., ACE_Log_Msg_Async.
+    ASYNC = 512,
+    /// Only write messages to the binary log set by binary_writer(),
+    /// deferring their formatting when possible.
+    BINARY = 1024
  };
 
   // = Initialization and termination routines.
@@ -377,6 +385,15 @@ public:
   static ACE_Log_Msg_Backend *msg_backend (ACE_Log_Msg_Backend *b);
   static ACE_Log_Msg_Backend *msg_backend (void);
 
+  /**
+   * Set the binary log the messages go to when the BINARY flag is
+   * set, and return the previous one.  Like the backend, the binary
+   * log is a per-process entity; it isn't opened or closed by
+   * ACE_Log_Msg.
+   */
+  static ACE_Log_Binary_Writer *binary_writer (ACE_Log_Binary_Writer *w);
+  static ACE_Log_Binary_Writer *binary_writer (void);
+
   /// Nesting depth increment.
   int inc (void);
 
@@ -0,0 +1,459 @@
+// $Id$
+
+#include "ace/Log_Msg_Async.h"
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+#include "ace/Log_Msg.h"
+#include "ace/Thread.h"
+#include "ace/Guard_T.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_signal.h"
+#include "ace/OS_NS_stdio.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_Thread.h"
+#include "ace/OS_NS_unistd.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// Room for the formatted records of a batch.
+static size_t const batch_size = 16 * ACE_Log_Record::MAXVERBOSELOGMSGLEN;
+
+// How often the thread writing out the records wakes up to do so,
+// unless a ring fills up before.
+static ACE_Time_Value const flush_interval (0, 10000);
+
+// Round @a size up to a power of 2 of at least 1K.
+static size_t
+ring_capacity (size_t size)
+{
+  size_t capacity = 1024;
+  while (capacity < size)
+    capacity <<= 1;
+  return capacity;
+}
+
+ACE_Log_Msg_Async *ACE_Log_Msg_Async::crash_backend_ = 0;
+
+ACE_Log_Msg_Async::Ring::Ring (size_t capacity)
+  : buffer_ (0),
+    capacity_ (capacity),
+    head_ (0),
+    tail_ (0),
+    owned_ (true),
+    next_ (0)
+{
+  ACE_NEW (this->buffer_, char[capacity]);
+}
+
+ACE_Log_Msg_Async::Ring::~Ring (void)
+{
+  delete [] this->buffer_;
+}
+
+ACE_Log_Msg_Async::Holder::Holder (void)
+  : ring_ (0),
+    draining_ (false)
+{
+}
+
+ACE_Log_Msg_Async::Holder::~Holder (void)
+{
+  // The thread is exiting: its ring can go to another thread, after
+  // the records still in it.
+  if (this->ring_ != 0)
+    this->ring_->owned_.store (false, std::memory_order_release);
+}
+
+ACE_Log_Msg_Async::ACE_Log_Msg_Async (ACE_Log_Msg_Backend *target,
+                                      size_t ring_size,
+                                      Overflow_Policy policy,
+                                      FILE *fp)
+  : target_ (target),
+    fp_ (fp),
+    ring_size_ (ring_capacity (ring_size)),
+    policy_ (policy),
+    rings_ (0),
+    batch_ (0),
+    batch_len_ (0),
+    flags_ (0),
+    host_name_ (0),
+    wakeup_ (wakeup_lock_),
+    sleeping_ (false),
+    done_ (false),
+    thr_handle_ (0),
+    running_ (false),
+    dropped_ (0)
+{
+  if (this->target_ == 0)
+    {
+      ACE_NEW (this->batch_, ACE_TCHAR[batch_size]);
+      if (this->batch_ != 0)
+        this->batch_[0] = '\0';
+    }
+}
+
+ACE_Log_Msg_Async::~ACE_Log_Msg_Async (void)
+{
+  this->close ();
+
+  // The holder of the calling thread is deleted with <holder_>, after
+  // the rings are gone.
+  Holder *const holder = this->holder_.ts_object ();
+  if (holder != 0)
+    holder->ring_ = 0;
+
+  Ring *ring = this->rings_.load ();
+  while (ring != 0)
+    {
+      Ring *const next = ring->next_;
+      delete ring;
+      ring = next;
+    }
+  delete [] this->batch_;
+}
+
+int
+ACE_Log_Msg_Async::open (const ACE_TCHAR *logger_key)
+{
+  if (this->target_ != 0 && this->target_->open (logger_key) == -1)
+    return -1;
+
+  if (this->running_)
+    return 0;
+
+  this->done_.store (false);
+  if (ACE_Thread::spawn (ACE_Log_Msg_Async::svc_run,
+                         this,
+                         THR_NEW_LWP | THR_JOINABLE,
+                         0,
+                         &this->thr_handle_) == -1)
+    return -1;
+  this->running_ = true;
+  return 0;
+}
+
+int
+ACE_Log_Msg_Async::reset (void)
+{
+  this->flush ();
+  return this->target_ == 0 ? 0 : this->target_->reset ();
+}
+
+int
+ACE_Log_Msg_Async::close (void)
+{
+  if (crash_backend_ == this)
+    crash_backend_ = 0;
+
+  if (this->running_)
+    {
+      {
+        ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->wakeup_lock_, -1);
+        this->done_.store (true);
+        this->wakeup_.signal ();
+      }
+      ACE_Thread::join (this->thr_handle_);
+      this->running_ = false;
+    }
+
+  // Records logged since the thread exited.
+  this->flush ();
+  return this->target_ == 0 ? 0 : this->target_->close ();
+}
+
+ssize_t
+ACE_Log_Msg_Async::log (ACE_Log_Record &log_record)
+{
+  Holder *const holder = this->holder_;
+  if (holder == 0)
+    return -1;
+
+  if (holder->draining_)
+    {
+      // Logged while writing out the records, e.g., by the target
+      // backend: nobody else would write this one out.
+      this->write (log_record);
+      return 0;
+    }
+
+  if (holder->ring_ == 0)
+    {
+      holder->ring_ = this->acquire_ring ();
+      if (holder->ring_ == 0)
+        return -1;
+    }
+  Ring &ring = *holder->ring_;
+  size_t const mask = ring.capacity_ - 1;
+
+  const ACE_TCHAR *const text = log_record.msg_data ();
+  size_t const max_len =
+    (ring.capacity_ / 4 - sizeof (Entry)) / sizeof (ACE_TCHAR) - 1;
+  size_t len = ACE_OS::strlen (text);
+  if (len > max_len)
+    len = max_len;
+  size_t const size =
+    (sizeof (Entry) + (len + 1) * sizeof (ACE_TCHAR) + 7) & ~size_t (7);
+
+  // An entry doesn't wrap around the end of the ring; it is preceded
+  // by padding instead.
+  size_t const head = ring.head_.load (std::memory_order_relaxed);
+  size_t const offset = head & mask;
+  size_t const padding =
+    offset + size > ring.capacity_ ? ring.capacity_ - offset : 0;
+
+  while (ring.capacity_
+         - (head - ring.tail_.load (std::memory_order_acquire))
+         < padding + size)
+    {
+      if (this->policy_ == DROP)
+        {
+          ++this->dropped_;
+          errno = ENOSPC;
+          return -1;
+        }
+      if (this->drain (holder) == 0)
+        ACE_OS::thr_yield ();
+    }
+
+  if (padding >= sizeof (Entry))
+    {
+      Entry *const pad = reinterpret_cast<Entry *> (ring.buffer_ + offset);
+      pad->size_ = static_cast<ACE_UINT32> (padding);
+      pad->type_ = 0;
+    }
+
+  Entry *const entry =
+    reinterpret_cast<Entry *> (ring.buffer_ + ((head + padding) & mask));
+  ACE_Time_Value const time_stamp = log_record.time_stamp ();
+  entry->size_ = static_cast<ACE_UINT32> (size);
+  entry->type_ = log_record.type ();
+  entry->pid_ = static_cast<ACE_UINT32> (log_record.pid ());
+  entry->usec_ = static_cast<ACE_UINT32> (time_stamp.usec ());
+  entry->sec_ = static_cast<ACE_INT64> (time_stamp.sec ());
+  ACE_TCHAR *const data = reinterpret_cast<ACE_TCHAR *> (entry + 1);
+  ACE_OS::memcpy (data, text, len * sizeof (ACE_TCHAR));
+  data[len] = '\0';
+
+  // Publish the entry, then see if the thread writing out the records
+  // must be woken up before its next round, to make room.
+  size_t const new_head = head + padding + size;
+  ring.head_.store (new_head, std::memory_order_release);
+  if (new_head - ring.tail_.load (std::memory_order_relaxed)
+        > ring.capacity_ / 2
+      && this->sleeping_.load ())
+    {
+      ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->wakeup_lock_, 0);
+      this->wakeup_.signal ();
+    }
+  return 0;
+}
+
+size_t
+ACE_Log_Msg_Async::flush (void)
+{
+  return this->drain (this->holder_);
+}
+
+int
+ACE_Log_Msg_Async::flush_on_crash (void)
+{
+#if defined (ACE_LACKS_UNIX_SIGNALS)
+  ACE_NOTSUP_RETURN (-1);
+#else
+  static int const signals[] =
+    {
+      SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT
+    };
+
+  crash_backend_ = this;
+  for (size_t i = 0; i < sizeof signals / sizeof signals[0]; ++i)
+    if (ACE_OS::signal (signals[i],
+                        (ACE_SignalHandler) ACE_Log_Msg_Async::crash_handler)
+        == SIG_ERR)
+      return -1;
+  return 0;
+#endif /* ACE_LACKS_UNIX_SIGNALS */
+}
+
+size_t
+ACE_Log_Msg_Async::dropped (void) const
+{
+  return this->dropped_.load ();
+}
+
+ACE_Log_Msg_Async::Ring *
+ACE_Log_Msg_Async::acquire_ring (void)
+{
+  for (Ring *ring = this->rings_.load (); ring != 0; ring = ring->next_)
+    {
+      bool owned = false;
+      if (!ring->owned_.load (std::memory_order_relaxed)
+          && ring->owned_.compare_exchange_strong (owned,
+                                                   true,
+                                                   std::memory_order_acquire))
+        return ring;
+    }
+
+  Ring *ring = 0;
+  ACE_NEW_RETURN (ring, Ring (this->ring_size_), 0);
+  if (ring->buffer_ == 0)
+    {
+      delete ring;
+      errno = ENOMEM;
+      return 0;
+    }
+
+  ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->ring_lock_, 0);
+  ring->next_ = this->rings_.load (std::memory_order_relaxed);
+  this->rings_.store (ring, std::memory_order_release);
+  return ring;
+}
+
+size_t
+ACE_Log_Msg_Async::drain (Holder *holder)
+{
+  // Get these before taking <drain_lock_>, since they take the lock of
+  // ACE_Log_Msg, which a thread blocked in log() may hold.
+  ACE_Log_Msg *const log_msg = ACE_LOG_MSG;
+  u_long const flags = log_msg->flags ();
+  const ACE_TCHAR *const host_name = log_msg->local_host ();
+
+  ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->drain_lock_, 0);
+  this->flags_ = flags;
+  this->host_name_ = host_name;
+
+  if (holder != 0)
+    holder->draining_ = true;
+  size_t const count = this->drain_i ();
+  if (holder != 0)
+    holder->draining_ = false;
+  return count;
+}
+
+size_t
+ACE_Log_Msg_Async::drain_i (void)
+{
+  size_t count = 0;
+  for (Ring *ring = this->rings_.load (std::memory_order_acquire);
+       ring != 0;
+       ring = ring->next_)
+    {
+      size_t const mask = ring->capacity_ - 1;
+      size_t tail = ring->tail_.load (std::memory_order_relaxed);
+      size_t const head = ring->head_.load (std::memory_order_acquire);
+      while (tail != head)
+        {
+          size_t const offset = tail & mask;
+          if (ring->capacity_ - offset < sizeof (Entry))
+            {
+              // Padding too short for an entry.
+              tail += ring->capacity_ - offset;
+              continue;
+            }
+
+          Entry const *const entry =
+            reinterpret_cast<Entry const *> (ring->buffer_ + offset);
+          if (entry->type_ != 0)
+            {
+              this->record_.type (entry->type_);
+              this->record_.pid (entry->pid_);
+              this->record_.time_stamp (
+                ACE_Time_Value (static_cast<time_t> (entry->sec_),
+                                static_cast<suseconds_t> (entry->usec_)));
+              this->record_.msg_data (
+                reinterpret_cast<const ACE_TCHAR *> (entry + 1));
+              this->write (this->record_);
+              ++count;
+            }
+          tail += entry->size_;
+        }
+      ring->tail_.store (tail, std::memory_order_release);
+    }
+
+  this->write_batch ();
+  return count;
+}
+
+void
+ACE_Log_Msg_Async::write (ACE_Log_Record &log_record)
+{
+  if (this->target_ != 0)
+    {
+      this->target_->log (log_record);
+      return;
+    }
+  if (this->batch_ == 0)
+    return;
+
+  if (batch_size - this->batch_len_ < ACE_Log_Record::MAXVERBOSELOGMSGLEN)
+    this->write_batch ();
+  ACE_TCHAR *const msg = this->batch_ + this->batch_len_;
+  if (log_record.format_msg (this->host_name_, this->flags_, msg) == 0)
+    this->batch_len_ += ACE_OS::strlen (msg);
+  else
+    *msg = '\0';
+}
+
+void
+ACE_Log_Msg_Async::write_batch (void)
+{
+  if (this->batch_len_ == 0 || this->fp_ == 0)
+    return;
+
+#if !defined (ACE_WIN32) && defined (ACE_USES_WCHAR)
+  ACE_OS::fprintf (this->fp_, ACE_TEXT ("%ls"), this->batch_);
+#else
+  ACE_OS::fprintf (this->fp_, ACE_TEXT ("%s"), this->batch_);
+#endif
+  ACE_OS::fflush (this->fp_);
+  this->batch_len_ = 0;
+  this->batch_[0] = '\0';
+}
+
+ACE_THR_FUNC_RETURN
+ACE_Log_Msg_Async::svc_run (void *arg)
+{
+  ACE_Log_Msg_Async *const self = static_cast<ACE_Log_Msg_Async *> (arg);
+  Holder *const holder = self->holder_;
+
+  // Write out the records in batches, every flush_interval or when a
+  // ring is half full.
+  while (!self->done_.load ())
+    {
+      self->drain (holder);
+
+      ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, self->wakeup_lock_, 0);
+      self->sleeping_.store (true);
+      if (!self->done_.load ())
+        {
+          ACE_Time_Value const timeout =
+            ACE_OS::gettimeofday () + flush_interval;
+          self->wakeup_.wait (&timeout);
+        }
+      self->sleeping_.store (false);
+    }
+
+  self->drain (holder);
+  return 0;
+}
+
+void
+ACE_Log_Msg_Async::crash_handler (int signum)
+{
+  ACE_Log_Msg_Async *const backend = crash_backend_;
+  if (backend != 0 && backend->drain_lock_.tryacquire () == 0)
+    {
+      backend->drain_i ();
+      backend->drain_lock_.release ();
+    }
+
+  // Let the signal take its course.
+  ACE_OS::signal (signum, SIG_DFL);
+  ACE_OS::kill (ACE_OS::getpid (), signum);
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */
@@ -0,0 +1,270 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Log_Msg_Async.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+#ifndef ACE_LOG_MSG_ASYNC_H
+#define ACE_LOG_MSG_ASYNC_H
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/config-all.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+#include "ace/Log_Msg_Backend.h"
+#include "ace/Log_Record.h"
+#include "ace/TSS_T.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+#include "ace/Default_Constants.h"
+
+#include <atomic>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Log_Msg_Async
+ *
+ * @brief Implements an ACE_Log_Msg_Backend that writes the log records
+ * from a thread of its own.
+ *
+ * ACE_Log_Msg writes each record to its destinations synchronously,
+ * holding a process-wide lock, so every thread that logs waits for
+ * the output of all the others.  This backend only copies the record,
+ * i.e., its priority, time stamp, process id and text, into a ring
+ * buffer of the calling thread, without locking.  A thread started by
+ * open() drains the rings every 10 milliseconds, or as soon as one of
+ * them is half full, formats the records and writes them to the target
+ * backend, or to a FILE, flushing once per batch.
+ *
+ * Each thread that logs gets a ring of @c ring_size bytes the first
+ * time it logs; the ring is reused by another thread once that thread
+ * has exited, so memory stays bounded by the number of threads logging
+ * at once.  When a ring is full the record is dropped, and counted,
+ * or the calling thread blocks, writing out the pending records
+ * itself, depending on the overflow policy.  The records of a thread
+ * are written in order, but those of different threads are not
+ * interleaved by time stamp.
+ *
+ * For ACE_Log_Msg to hand the records over without taking its lock,
+ * set both the @c CUSTOM and @c ASYNC flags:
+ * @code
+ * ACE_Log_Msg_Async async_backend;
+ * ACE_Log_Msg::msg_backend (&async_backend);
+ * ACE_LOG_MSG->open (argv[0], ACE_Log_Msg::CUSTOM | ACE_Log_Msg::ASYNC);
+ * @endcode
+ * The other destinations of ACE_Log_Msg, such as @c STDERR and
+ * @c OSTREAM, are then bypassed.
+ *
+ * Records still in the rings are lost if the process crashes, unless
+ * flush_on_crash() has been called.
+ */
+class ACE_Export ACE_Log_Msg_Async : public ACE_Log_Msg_Backend
+{
+public:
+  /// What log() does when the ring of the calling thread is full.
+  enum Overflow_Policy
+  {
+    /// Drop the record and count it; see dropped().
+    DROP,
+    /// Wait for room, writing out the pending records.
+    BLOCK
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param target     Backend the records are written to by the
+   *                   thread of this backend, which opens and closes
+   *                   it.  If 0, the records are formatted according
+   *                   to the VERBOSE and VERBOSE_LITE flags of
+   *                   ACE_Log_Msg and written to @a fp.
+   * @param ring_size  Size in bytes of the ring of each thread; it is
+   *                   rounded up to a power of 2.  Messages longer
+   *                   than a quarter of it are truncated.
+   * @param policy     What to do when a ring is full.
+   * @param fp         Where the records go when there is no target.
+   */
+  ACE_Log_Msg_Async (ACE_Log_Msg_Backend *target = 0,
+                     size_t ring_size = ACE_DEFAULT_LOG_MSG_ASYNC_RING_SIZE,
+                     Overflow_Policy policy = DROP,
+                     FILE *fp = stderr);
+
+  /// Close the backend and release the rings.
+  virtual ~ACE_Log_Msg_Async (void);
+
+  /// Open the target backend, passing it @a logger_key, and start the
+  /// thread that writes the records.
+  virtual int open (const ACE_TCHAR *logger_key);
+
+  /// Write out the pending records and reset the target backend.
+  virtual int reset (void);
+
+  /// Write out the pending records, stop the thread and close the
+  /// target backend.
+  virtual int close (void);
+
+  /// Copy @a log_record into the ring of the calling thread.  Returns
+  /// -1 with @c errno set to @c ENOSPC if it was dropped.
+  virtual ssize_t log (ACE_Log_Record &log_record);
+
+  /// Write out the records pending in all the rings from the calling
+  /// thread, and return how many there were.
+  size_t flush (void);
+
+  /**
+   * Write out the pending records when the process gets one of the
+   * signals of a crash, such as @c SIGSEGV or @c SIGABRT, before
+   * letting the signal take its course.  This is a last resort that
+   * isn't async-signal-safe: it is skipped if the records are being
+   * written out by another thread at the time.  Only one backend at
+   * a time can flush on crash.
+   */
+  int flush_on_crash (void);
+
+  /// Number of records dropped so far because a ring was full.
+  size_t dropped (void) const;
+
+private:
+  /// A compact log record, followed by its text in a ring.
+  struct Entry
+  {
+    /// Bytes taken by the entry, text included.
+    ACE_UINT32 size_;
+
+    /// Type of the record, or 0 for padding up to the end of the ring.
+    ACE_UINT32 type_;
+
+    ACE_UINT32 pid_;
+    ACE_UINT32 usec_;
+    ACE_INT64 sec_;
+  };
+
+  /// The ring of a thread.  Only that thread writes to it, and only
+  /// the thread writing out the records reads from it.
+  struct Ring
+  {
+    Ring (size_t capacity);
+    ~Ring (void);
+
+    char *buffer_;
+    size_t const capacity_;
+
+    /// Where the producer writes next.
+    std::atomic<size_t> head_;
+
+    char pad0_[64];
+
+    /// Where the consumer reads next.
+    std::atomic<size_t> tail_;
+
+    char pad1_[64];
+
+    /// Whether a thread is using the ring.
+    std::atomic<bool> owned_;
+
+    /// Next ring in the list of rings.
+    Ring *next_;
+  };
+
+  /// The thread-specific state: the ring of the thread, and whether
+  /// the thread is writing out records.
+  struct Holder
+  {
+    Holder (void);
+    ~Holder (void);
+
+    Ring *ring_;
+    bool draining_;
+  };
+
+  /// Get a ring for the calling thread, reusing that of a thread that
+  /// has exited if possible.
+  Ring *acquire_ring (void);
+
+  /// Write out the records of all the rings; the caller holds
+  /// <drain_lock_>.
+  size_t drain_i (void);
+
+  /// Write out the records of all the rings from @a holder.
+  size_t drain (Holder *holder);
+
+  /// Write out a record, or buffer it for the next batch.
+  void write (ACE_Log_Record &log_record);
+
+  /// Write out the current batch of formatted records.
+  void write_batch (void);
+
+  /// Entry point of the thread writing out the records.
+  static ACE_THR_FUNC_RETURN svc_run (void *arg);
+
+  /// Handler of the crash signals.
+  static void crash_handler (int signum);
+
+  /// The backend flushed on crash.
+  static ACE_Log_Msg_Async *crash_backend_;
+
+  /// Backend the records go to, if any.
+  ACE_Log_Msg_Backend *target_;
+
+  /// Where the records go otherwise.
+  FILE *fp_;
+
+  size_t const ring_size_;
+  Overflow_Policy const policy_;
+
+  /// The rings of all the threads.  Rings are only ever added.
+  std::atomic<Ring *> rings_;
+
+  /// Serializes the creation of the rings.
+  ACE_Thread_Mutex ring_lock_;
+
+  ACE_TSS<Holder> holder_;
+
+  /// Held while writing out records.
+  ACE_Thread_Mutex drain_lock_;
+
+  /// The record passed to the target, and the formatted records of the
+  /// current batch when there's no target.
+  ACE_Log_Record record_;
+  ACE_TCHAR *batch_;
+  size_t batch_len_;
+
+  /// The flags and host name of ACE_Log_Msg the records are formatted
+  /// with.
+  u_long flags_;
+  const ACE_TCHAR *host_name_;
+
+  /// The thread writing out the records waits on this when there's
+  /// nothing to write.
+  ACE_Thread_Mutex wakeup_lock_;
+  ACE_Condition_Thread_Mutex wakeup_;
+  std::atomic<bool> sleeping_;
+  std::atomic<bool> done_;
+
+  /// The thread writing out the records, if started.
+  ACE_hthread_t thr_handle_;
+  bool running_;
+
+  std::atomic<size_t> dropped_;
+
+  // = Disallow copying.
+  ACE_UNIMPLEMENTED_FUNC (ACE_Log_Msg_Async (const ACE_Log_Msg_Async &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Log_Msg_Async &))
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_LOG_MSG_ASYNC_H */
@@ -0,0 +1,594 @@
+// $Id$
+
+#ifndef ACE_MESSAGE_QUEUE_LOCK_FREE_T_CPP
+#define ACE_MESSAGE_QUEUE_LOCK_FREE_T_CPP
+
+#include "ace/Message_Queue_Lock_Free_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_CPP11)
+
+#include "ace/Log_Category.h"
+#include "ace/Notification_Strategy.h"
+#include "ace/Truncate.h"
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+#include "ace/Monitor_Size.h"
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Message_Queue_SPSC)
+ACE_ALLOC_HOOK_DEFINE(ACE_Message_Queue_MPSC)
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::ACE_Message_Queue_Lock_Free_Base (size_t hwm,
+                                                                                   size_t lwm,
+                                                                                   ACE_Notification_Strategy *ns)
+  : ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY> (hwm, lwm, ns),
+    count_ (0),
+    bytes_ (0),
+    length_ (0),
+    dequeue_waiters_ (0),
+    enqueue_waiters_ (0)
+{
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Message_Queue_Lock_Free_Base (void)
+{
+  // The subclasses flush the queue since <pop_i> is gone by now.
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::open (size_t hwm,
+                                                       size_t lwm,
+                                                       ACE_Notification_Strategy *ns)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::open");
+  this->count_ = 0;
+  this->bytes_ = 0;
+  this->length_ = 0;
+  return ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::open (hwm, lwm, ns);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::add_message (ACE_Message_Block *new_item)
+{
+  size_t mb_bytes = 0;
+  size_t mb_length = 0;
+  new_item->total_size_and_length (mb_bytes, mb_length);
+  this->bytes_ += mb_bytes;
+  this->length_ += mb_length;
+  return ++this->count_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::remove_message (ACE_Message_Block *item)
+{
+  size_t mb_bytes = 0;
+  size_t mb_length = 0;
+  item->total_size_and_length (mb_bytes, mb_length);
+  this->bytes_ -= mb_bytes;
+  this->length_ -= mb_length;
+  return --this->count_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::wait_not_full (ACE_Time_Value *timeout)
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+
+  // Announce ourselves before looking at the queue again; the
+  // consumer looks at the waiter count after making room.
+  ++this->enqueue_waiters_;
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+
+  int const result = this->wait_not_full_cond (timeout);
+  --this->enqueue_waiters_;
+  return result;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::wait_not_empty (ACE_Time_Value *timeout)
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+
+  // Announce ourselves before looking at the queue again; producers
+  // look at the waiter count after pushing.
+  ++this->dequeue_waiters_;
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+
+  int const result = this->wait_not_empty_cond (timeout);
+  --this->dequeue_waiters_;
+  return result;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_tail (ACE_Message_Block *new_item,
+                                                               ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_tail");
+
+  if (new_item == 0)
+    return -1;
+
+  if (this->state_ == ACE_Message_Queue_Base::DEACTIVATED)
+    {
+      errno = ESHUTDOWN;
+      return -1;
+    }
+
+  if (this->is_full_i () && this->wait_not_full (timeout) == -1)
+    return -1;
+
+  size_t queue_count = 0;
+  for (ACE_Message_Block *mb = new_item; mb != 0; )
+    {
+      ACE_Message_Block * const next = mb->next ();
+      mb->next (0);
+      mb->prev (0);
+
+      queue_count = this->add_message (mb);
+      while (!this->push_i (mb))
+        if (this->wait_not_full (timeout) == -1)
+          {
+            this->remove_message (mb);
+            mb->next (next);
+            return -1;
+          }
+
+      mb = next;
+    }
+
+  // Wake up the consumer if it went to sleep before it could see the
+  // new messages.
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+  if (this->dequeue_waiters_.load (std::memory_order_relaxed) > 0)
+    {
+      ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+      if (this->signal_dequeue_waiters () == -1)
+        return -1;
+    }
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  this->monitor_->receive (this->length_.load ());
+#endif
+
+  if (this->notification_strategy_ != 0)
+    this->notification_strategy_->notify ();
+
+  return ACE_Utils::truncate_cast<int> (queue_count);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue (ACE_Message_Block *new_item,
+                                                          ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue");
+  return this->enqueue_tail (new_item, timeout);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_head (ACE_Message_Block *&first_item,
+                                                               ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_head");
+
+  if (this->state_ == ACE_Message_Queue_Base::DEACTIVATED)
+    {
+      errno = ESHUTDOWN;
+      return -1;
+    }
+
+  if (!this->pop_i (first_item))
+    {
+      if (this->wait_not_empty (timeout) == -1)
+        return -1;
+
+      // Only the consumer takes messages, so one is there now.
+      if (!this->pop_i (first_item))
+        {
+          errno = EWOULDBLOCK;
+          return -1;
+        }
+    }
+
+  size_t const queue_count = this->remove_message (first_item);
+
+  // Let the producers continue once we have fallen below the low
+  // water mark.
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+  if (this->enqueue_waiters_.load (std::memory_order_relaxed) > 0
+      && this->bytes_.load () <= this->low_water_mark_)
+    {
+      ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+      if (this->signal_enqueue_waiters () == -1)
+        return -1;
+    }
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  this->monitor_->receive (this->length_.load ());
+#endif
+
+  return ACE_Utils::truncate_cast<int> (queue_count);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain (ACE_Message_Block *first_item,
+                                                                ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain");
+  return this->enqueue_tail (first_item, timeout);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch (ACE_Message_Block *&first_item,
+                                                                size_t max_count,
+                                                                ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch");
+
+  if (max_count == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  // Wait for the first message like <dequeue_head>, then take what
+  // the producers have pushed since without waiting.
+  if (this->dequeue_head (first_item, timeout) == -1)
+    return -1;
+
+  ACE_Message_Block *last_item = first_item;
+  int count = 1;
+  for (ACE_Message_Block *item = 0;
+       static_cast<size_t> (count) < max_count && this->pop_i (item);
+       ++count)
+    {
+      this->remove_message (item);
+      last_item->next (item);
+      item->prev (last_item);
+      last_item = item;
+    }
+
+  if (count > 1)
+    {
+      std::atomic_thread_fence (std::memory_order_seq_cst);
+      if (this->enqueue_waiters_.load (std::memory_order_relaxed) > 0
+          && this->bytes_.load () <= this->low_water_mark_)
+        {
+          ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+          if (this->signal_enqueue_waiters () == -1)
+            return -1;
+        }
+    }
+
+  return count;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_head (ACE_Message_Block *,
+                                                               ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_prio (ACE_Message_Block *,
+                                                               ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::enqueue_deadline (ACE_Message_Block *,
+                                                                   ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_prio (ACE_Message_Block *&,
+                                                               ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_tail (ACE_Message_Block *&,
+                                                               ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dequeue_deadline (ACE_Message_Block *&,
+                                                                   ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::peek_dequeue_head (ACE_Message_Block *&,
+                                                                    ACE_Time_Value *)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::is_full_i (void)
+{
+  return this->bytes_.load () >= this->high_water_mark_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::is_full (void)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::is_full");
+  return this->is_full_i ();
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::is_empty (void)
+{
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::is_empty");
+  return this->count_.load () == 0;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::message_bytes (void)
+{
+  return this->bytes_.load ();
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::message_length (void)
+{
+  return this->length_.load ();
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::message_count (void)
+{
+  return this->count_.load ();
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::message_bytes (size_t new_value)
+{
+  this->bytes_ = new_value;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::message_length (size_t new_value)
+{
+  this->length_ = new_value;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::flush_i (void)
+{
+  int number_flushed = 0;
+
+  ACE_Message_Block *mb = 0;
+  while (this->pop_i (mb))
+    {
+      ++number_flushed;
+      this->remove_message (mb);
+
+      // Make sure to use <release> rather than <delete> since this is
+      // reference counted.
+      mb->release ();
+    }
+
+  return number_flushed;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::dump");
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("state = %d\n")
+              ACE_TEXT ("low_water_mark = %B\n")
+              ACE_TEXT ("high_water_mark = %B\n")
+              ACE_TEXT ("cur_bytes = %B\n")
+              ACE_TEXT ("cur_length = %B\n")
+              ACE_TEXT ("cur_count = %B\n")
+              ACE_TEXT ("dequeue_waiters = %d\n")
+              ACE_TEXT ("enqueue_waiters = %d\n"),
+              this->state_,
+              this->low_water_mark_,
+              this->high_water_mark_,
+              this->bytes_.load (),
+              this->length_.load (),
+              this->count_.load (),
+              this->dequeue_waiters_.load (),
+              this->enqueue_waiters_.load ()));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+// ****************************************************************
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::ACE_Message_Queue_SPSC (size_t capacity,
+                                                               size_t hwm,
+                                                               size_t lwm,
+                                                               ACE_Notification_Strategy *ns)
+  : ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY> (hwm, lwm, ns),
+    ring_ (0),
+    mask_ (0),
+    read_index_ (0),
+    cached_write_index_ (0),
+    write_index_ (0),
+    cached_read_index_ (0)
+{
+  ACE_TRACE ("ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::ACE_Message_Queue_SPSC");
+
+  size_t size = 2;
+  while (size < capacity)
+    size <<= 1;
+
+  ACE_NEW (this->ring_,
+           ACE_Message_Block *[size]);
+  this->mask_ = size - 1;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Message_Queue_SPSC (void)
+{
+  ACE_TRACE ("ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Message_Queue_SPSC");
+
+  if (this->ring_ != 0 && this->close () == -1)
+    ACELIB_ERROR ((LM_ERROR,
+                ACE_TEXT ("close")));
+
+  delete [] this->ring_;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> size_t
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::capacity (void) const
+{
+  return this->ring_ == 0 ? 0 : this->mask_ + 1;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::push_i (ACE_Message_Block *new_item)
+{
+  if (this->ring_ == 0)
+    return false;
+
+  size_t const write_index =
+    this->write_index_.load (std::memory_order_relaxed);
+
+  if (write_index - this->cached_read_index_ > this->mask_)
+    {
+      this->cached_read_index_ =
+        this->read_index_.load (std::memory_order_acquire);
+      if (write_index - this->cached_read_index_ > this->mask_)
+        return false;
+    }
+
+  this->ring_[write_index & this->mask_] = new_item;
+  this->write_index_.store (write_index + 1, std::memory_order_release);
+  return true;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::pop_i (ACE_Message_Block *&first_item)
+{
+  size_t const read_index =
+    this->read_index_.load (std::memory_order_relaxed);
+
+  if (read_index == this->cached_write_index_)
+    {
+      this->cached_write_index_ =
+        this->write_index_.load (std::memory_order_acquire);
+      if (read_index == this->cached_write_index_)
+        return false;
+    }
+
+  first_item = this->ring_[read_index & this->mask_];
+  this->read_index_.store (read_index + 1, std::memory_order_release);
+  return true;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::is_empty_i (void)
+{
+  return this->read_index_.load (std::memory_order_acquire)
+    == this->write_index_.load (std::memory_order_acquire);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY>::is_full_i (void)
+{
+  return this->write_index_.load (std::memory_order_acquire)
+           - this->read_index_.load (std::memory_order_acquire) > this->mask_
+    || ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>::is_full_i ();
+}
+
+// ****************************************************************
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::ACE_Message_Queue_MPSC (size_t hwm,
+                                                               size_t lwm,
+                                                               ACE_Notification_Strategy *ns)
+  : ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY> (hwm, lwm, ns),
+    stack_ (0),
+    consumer_list_ (0)
+{
+  ACE_TRACE ("ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::ACE_Message_Queue_MPSC");
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Message_Queue_MPSC (void)
+{
+  ACE_TRACE ("ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::~ACE_Message_Queue_MPSC");
+
+  if (!this->is_empty_i () && this->close () == -1)
+    ACELIB_ERROR ((LM_ERROR,
+                ACE_TEXT ("close")));
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::push_i (ACE_Message_Block *new_item)
+{
+  // The block is only linked into the stack, and so seen by the
+  // consumer, once the exchange succeeds.
+  ACE_Message_Block *top = this->stack_.load (std::memory_order_relaxed);
+  do
+    new_item->next (top);
+  while (!this->stack_.compare_exchange_weak (top,
+                                              new_item,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+  return true;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::pop_i (ACE_Message_Block *&first_item)
+{
+  if (this->consumer_list_ == 0)
+    {
+      ACE_Message_Block *top =
+        this->stack_.exchange (0, std::memory_order_acquire);
+
+      // Reverse the stack into FIFO order.
+      while (top != 0)
+        {
+          ACE_Message_Block * const next = top->next ();
+          top->next (this->consumer_list_);
+          this->consumer_list_ = top;
+          top = next;
+        }
+
+      if (this->consumer_list_ == 0)
+        return false;
+    }
+
+  first_item = this->consumer_list_;
+  this->consumer_list_ = first_item->next ();
+  first_item->next (0);
+  return true;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> bool
+ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY>::is_empty_i (void)
+{
+  return this->consumer_list_ == 0
+    && this->stack_.load (std::memory_order_acquire) == 0;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_CPP11 */
+
+#endif /* !ACE_MESSAGE_QUEUE_LOCK_FREE_T_CPP */
@@ -0,0 +1,321 @@
+/* -*- C++ -*- */
+
+//=============================================================================
+/**
+ *  @file    Message_Queue_Lock_Free_T.h
+ *
+ *  $Id$
+ *
+ *  Message queues that hand messages from producers to the consumer
+ *  without taking the queue lock.
+ */
+//=============================================================================
+
+#ifndef ACE_MESSAGE_QUEUE_LOCK_FREE_T_H
+#define ACE_MESSAGE_QUEUE_LOCK_FREE_T_H
+
+#include /**/ "ace/pre.h"
+
+#include "ace/Message_Queue_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_CPP11)
+
+#include <atomic>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Message_Queue_Lock_Free_Base
+ *
+ * @brief Common part of ACE_Message_Queue_SPSC and
+ * ACE_Message_Queue_MPSC.
+ *
+ * Messages travel from the producers to the consumer through a
+ * lock-free structure provided by the subclass, and the queue
+ * statistics are kept in atomic counters.  The lock and conditions
+ * inherited from ACE_Message_Queue are only used by threads that
+ * have to wait because the queue is empty or full and by the threads
+ * that wake them up, so an uncontended <enqueue_tail>/<dequeue_head>
+ * pair does not make any system call.
+ *
+ * Since the queue is strictly FIFO and has a single consumer, many
+ * ACE_Message_Queue features are not supported:
+ * * <enqueue_head>, <enqueue_prio> and <enqueue_deadline>; <enqueue>
+ *   is the same as <enqueue_tail>.
+ * * <dequeue_tail>, <dequeue_prio>, <dequeue_deadline> and
+ *   <peek_dequeue_head>.
+ * * ACE_Message_Queue_Iterator and ACE_Message_Queue_Reverse_Iterator.
+ * <flush> and <close> remove messages, so they may only be called by
+ * the consumer or once the producers have stopped.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Message_Queue_Lock_Free_Base
+  : public ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  virtual ~ACE_Message_Queue_Lock_Free_Base (void);
+
+  /// Reset the water marks, statistics and notification strategy.
+  /// May only be called while the queue is empty.
+  virtual int open (size_t hwm = ACE_Message_Queue_Base::DEFAULT_HWM,
+                    size_t lwm = ACE_Message_Queue_Base::DEFAULT_LWM,
+                    ACE_Notification_Strategy *ns = 0);
+
+  // = Enqueue and dequeue methods.
+
+  /**
+   * Enqueue an ACE_Message_Block * at the end of the queue.  A chain
+   * of messages linked through their next() pointers is enqueued in
+   * order, but other producers' messages may be interleaved with it.
+   * Blocks while the queue is full unless @a timeout expires, in
+   * which case any part of the chain not enqueued yet is dropped from
+   * the queue (it is not released).  Returns -1 on failure, else the
+   * number of items on the queue.
+   */
+  virtual int enqueue_tail (ACE_Message_Block *new_item,
+                            ACE_Time_Value *timeout = 0);
+
+  /// Same as <enqueue_tail>.
+  virtual int enqueue (ACE_Message_Block *new_item,
+                       ACE_Time_Value *timeout = 0);
+
+  /**
+   * Dequeue and return the ACE_Message_Block * at the head of the
+   * queue, waiting at most until @a timeout for one to arrive.  Must
+   * only be called by the consumer thread.  Returns -1 on failure,
+   * else the number of items still on the queue.
+   */
+  virtual int dequeue_head (ACE_Message_Block *&first_item,
+                            ACE_Time_Value *timeout = 0);
+
+  /// Same as <enqueue_tail>.
+  virtual int enqueue_chain (ACE_Message_Block *first_item,
+                             ACE_Time_Value *timeout = 0);
+
+  /**
+   * Dequeue up to @a max_count messages, linked through their next()
+   * pointers, waiting at most until @a timeout for the first one.
+   * Must only be called by the consumer thread.  Returns -1 on
+   * failure, else the number of messages dequeued.
+   */
+  virtual int dequeue_batch (ACE_Message_Block *&first_item,
+                             size_t max_count,
+                             ACE_Time_Value *timeout = 0);
+
+  // = Not supported.
+  virtual int enqueue_head (ACE_Message_Block *new_item,
+                            ACE_Time_Value *timeout = 0);
+  virtual int enqueue_prio (ACE_Message_Block *new_item,
+                            ACE_Time_Value *timeout = 0);
+  virtual int enqueue_deadline (ACE_Message_Block *new_item,
+                                ACE_Time_Value *timeout = 0);
+  virtual int dequeue_prio (ACE_Message_Block *&dequeued,
+                            ACE_Time_Value *timeout = 0);
+  virtual int dequeue_tail (ACE_Message_Block *&dequeued,
+                            ACE_Time_Value *timeout = 0);
+  virtual int dequeue_deadline (ACE_Message_Block *&dequeued,
+                                ACE_Time_Value *timeout = 0);
+  virtual int peek_dequeue_head (ACE_Message_Block *&first_item,
+                                 ACE_Time_Value *timeout = 0);
+
+  // = Check if queue is full/empty, without taking the lock.
+  virtual bool is_full (void);
+  virtual bool is_empty (void);
+
+  // = Queue statistic methods, without taking the lock.
+  virtual size_t message_bytes (void);
+  virtual size_t message_length (void);
+  virtual size_t message_count (void);
+  virtual void message_bytes (size_t new_size);
+  virtual void message_length (size_t new_length);
+
+  /// Dump the state of an object.
+  virtual void dump (void) const;
+
+protected:
+  ACE_Message_Queue_Lock_Free_Base (size_t hwm,
+                                    size_t lwm,
+                                    ACE_Notification_Strategy *ns);
+
+  /// Hand @a new_item to the consumer.  Returns false if there is no
+  /// room for it.
+  virtual bool push_i (ACE_Message_Block *new_item) = 0;
+
+  /// Take the oldest message.  Only called by the consumer.  Returns
+  /// false if there is none.
+  virtual bool pop_i (ACE_Message_Block *&first_item) = 0;
+
+  /// True if the consumer has nothing to take.
+  virtual bool is_empty_i (void) = 0;
+
+  /// True if more than the high water mark of bytes is queued.
+  virtual bool is_full_i (void);
+
+  /// Remove and release all the messages.
+  virtual int flush_i (void);
+
+  /// Block until the queue is not full, the queue is deactivated or
+  /// @a timeout expires.
+  int wait_not_full (ACE_Time_Value *timeout);
+
+  /// Block until the queue is not empty, the queue is deactivated or
+  /// @a timeout expires.
+  int wait_not_empty (ACE_Time_Value *timeout);
+
+  /// Account for a message about to be pushed and return the new
+  /// message count.
+  size_t add_message (ACE_Message_Block *new_item);
+
+  /// Account for a message that was popped and return the new message
+  /// count.
+  size_t remove_message (ACE_Message_Block *item);
+
+  /// Number of messages, bytes and length on the queue.  A message is
+  /// counted before it is pushed and after it is popped.
+  std::atomic<size_t> count_;
+  std::atomic<size_t> bytes_;
+  std::atomic<size_t> length_;
+
+  /// Number of threads waiting in <wait_not_empty> and
+  /// <wait_not_full>.
+  std::atomic<int> dequeue_waiters_;
+  std::atomic<int> enqueue_waiters_;
+
+private:
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY> &))
+  ACE_UNIMPLEMENTED_FUNC (ACE_Message_Queue_Lock_Free_Base (const ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY> &))
+};
+
+/**
+ * @class ACE_Message_Queue_SPSC
+ *
+ * @brief Lock-free message queue for a single producer and a single
+ * consumer thread, based on a bounded ring of message pointers.
+ *
+ * Besides the high water mark, the queue is full once @a capacity
+ * messages are queued.  The producer and consumer sides of the ring
+ * are kept on separate cache lines and each side caches the other's
+ * index, so the two threads only touch shared cache lines when the
+ * ring looks empty or full.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Message_Queue_SPSC
+  : public ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  enum
+  {
+    /// Default number of messages the ring holds.
+    DEFAULT_CAPACITY = 1024
+  };
+
+  /// Create a queue for @a capacity messages, rounded up to the next
+  /// power of two.
+  ACE_Message_Queue_SPSC (size_t capacity = DEFAULT_CAPACITY,
+                          size_t hwm = ACE_Message_Queue_Base::DEFAULT_HWM,
+                          size_t lwm = ACE_Message_Queue_Base::DEFAULT_LWM,
+                          ACE_Notification_Strategy *ns = 0);
+
+  /// Release the queued messages and the ring.
+  virtual ~ACE_Message_Queue_SPSC (void);
+
+  /// Number of messages the ring holds.
+  size_t capacity (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  virtual bool push_i (ACE_Message_Block *new_item);
+  virtual bool pop_i (ACE_Message_Block *&first_item);
+  virtual bool is_empty_i (void);
+  virtual bool is_full_i (void);
+
+private:
+  enum { CACHE_LINE_SIZE = 64 };
+
+  /// The ring and the mask to turn an index into a ring position.
+  ACE_Message_Block **ring_;
+  size_t mask_;
+
+  char pad0_[CACHE_LINE_SIZE];
+
+  /// Consumer side: the next position to read and the producer's
+  /// index as last seen.
+  std::atomic<size_t> read_index_;
+  size_t cached_write_index_;
+
+  char pad1_[CACHE_LINE_SIZE];
+
+  /// Producer side: the next position to write and the consumer's
+  /// index as last seen.
+  std::atomic<size_t> write_index_;
+  size_t cached_read_index_;
+
+  char pad2_[CACHE_LINE_SIZE];
+};
+
+/**
+ * @class ACE_Message_Queue_MPSC
+ *
+ * @brief Lock-free, unbounded message queue for any number of
+ * producer threads and a single consumer thread.
+ *
+ * Producers push messages onto an intrusive stack linked through
+ * ACE_Message_Block::next() with a compare-and-swap.  The consumer
+ * takes the whole stack with a single exchange whenever it runs out
+ * of messages and reverses it into FIFO order, so no memory is
+ * allocated per message and every message block is only touched by
+ * one thread at a time.
+ */
+template <ACE_SYNCH_DECL, class TIME_POLICY = ACE_System_Time_Policy>
+class ACE_Message_Queue_MPSC
+  : public ACE_Message_Queue_Lock_Free_Base<ACE_SYNCH_USE, TIME_POLICY>
+{
+public:
+  ACE_Message_Queue_MPSC (size_t hwm = ACE_Message_Queue_Base::DEFAULT_HWM,
+                          size_t lwm = ACE_Message_Queue_Base::DEFAULT_LWM,
+                          ACE_Notification_Strategy *ns = 0);
+
+  /// Release the queued messages.
+  virtual ~ACE_Message_Queue_MPSC (void);
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  virtual bool push_i (ACE_Message_Block *new_item);
+  virtual bool pop_i (ACE_Message_Block *&first_item);
+  virtual bool is_empty_i (void);
+
+private:
+  enum { CACHE_LINE_SIZE = 64 };
+
+  /// Messages pushed by the producers, newest first.
+  std::atomic<ACE_Message_Block *> stack_;
+
+  char pad_[CACHE_LINE_SIZE];
+
+  /// Messages taken by the consumer, oldest first.
+  ACE_Message_Block *consumer_list_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/Message_Queue_Lock_Free_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("Message_Queue_Lock_Free_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#endif /* ACE_HAS_CPP11 */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_MESSAGE_QUEUE_LOCK_FREE_T_H */
@@ -14,6 +14,10 @@
 #include "ace/Message_Queue_NT.h"
 #endif /* ACE_HAS_WIN32_OVERLAPPED_IO */
 
+#if defined (ACE_HAS_CPP11)
+#include "ace/Message_Queue_Lock_Free_T.h"
+#endif /* ACE_HAS_CPP11 */
+
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 # pragma once
 #endif /* ACE_LACKS_PRAGMA_ONCE */
@@ -336,6 +340,96 @@ ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::dequeue_dead
   return cur_count;
 }
 
+// Add <count> items to the end of the queue under a single lock
+// acquisition.
+
+template <class ACE_MESSAGE_TYPE, ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::enqueue_batch (ACE_MESSAGE_TYPE *new_items[],
+                                                                      size_t count,
+                                                                      ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::enqueue_batch");
+
+  if (count == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_Message_Block *first = 0;
+  ACE_Message_Block *last = 0;
+
+  for (size_t i = 0; i < count; ++i)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_NEW_NORETURN (mb,
+                        ACE_Message_Block ((char *) new_items[i],
+                                           sizeof (*new_items[i]),
+                                           ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::DEFAULT_PRIORITY));
+      if (mb == 0)
+        {
+          this->release_chain (first);
+          errno = ENOMEM;
+          return -1;
+        }
+
+      if (last == 0)
+        first = mb;
+      else
+        last->next (mb);
+      last = mb;
+    }
+
+  int const result = this->queue_.enqueue_chain (first, timeout);
+  if (result == -1)
+    // Zap the messages.
+    this->release_chain (first);
+  return result;
+}
+
+// Remove up to <max_count> items from the front of the queue under a
+// single lock acquisition.
+
+template <class ACE_MESSAGE_TYPE, ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch (ACE_MESSAGE_TYPE *items[],
+                                                                      size_t max_count,
+                                                                      ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch");
+
+  ACE_Message_Block *mb = 0;
+
+  int const count = this->queue_.dequeue_batch (mb, max_count, timeout);
+
+  for (int i = 0; i < count; ++i)
+    {
+      ACE_Message_Block *next_mb = mb->next ();
+      items[i] = reinterpret_cast<ACE_MESSAGE_TYPE *> (mb->base ());
+      // Delete the message block.
+      mb->next (0);
+      mb->release ();
+      mb = next_mb;
+    }
+
+  return count;
+}
+
+// Release the message blocks, but not the items, of a series built by
+// <enqueue_batch>.
+
+template <class ACE_MESSAGE_TYPE, ACE_SYNCH_DECL, class TIME_POLICY> void
+ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::release_chain (ACE_Message_Block *first)
+{
+  while (first != 0)
+    {
+      ACE_Message_Block *next_mb = first->next ();
+      first->next (0);
+      first->prev (0);
+      first->release ();
+      first = next_mb;
+    }
+}
+
 template <class ACE_MESSAGE_TYPE, ACE_SYNCH_DECL, class TIME_POLICY> int
 ACE_Message_Queue_Ex<ACE_MESSAGE_TYPE, ACE_SYNCH_USE, TIME_POLICY>::notify (void)
 {
@@ -1717,6 +1811,66 @@ ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_deadline_i (ACE_Message_B
 #endif /* ACE_HAS_TIMED_MESSAGE_BLOCKS */
 }
 
+// Actually put a series of nodes at the end (no locking so must be
+// called with locks held).
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain_i (ACE_Message_Block *first_item)
+{
+  ACE_TRACE ("ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain_i");
+
+  size_t const old_count = this->cur_count_;
+  int const queue_count = this->enqueue_tail_i (first_item);
+  if (queue_count == -1)
+    return -1;
+
+  // <enqueue_tail_i> only woke up one dequeueing thread; there's work
+  // for more than one now.
+  if (this->cur_count_ - old_count > 1
+      && this->not_empty_cond_.broadcast () != 0)
+    return -1;
+
+  return queue_count;
+}
+
+// Actually get up to <max_count> nodes from the front (no locking so
+// must be called with locks held).  This method assumes that the
+// queue has at least one item in it when it is called.
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch_i (ACE_Message_Block *&first_item,
+                                                   size_t max_count)
+{
+  ACE_TRACE ("ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch_i");
+
+  first_item = 0;
+  ACE_Message_Block *last_item = 0;
+  int count = 0;
+
+  while (static_cast<size_t> (count) < max_count && !this->is_empty_i ())
+    {
+      ACE_Message_Block *item = 0;
+      if (this->dequeue_head_i (item) == -1)
+        {
+          if (count == 0)
+            return -1;
+          break;
+        }
+
+      if (last_item == 0)
+        first_item = item;
+      else
+        {
+          last_item->next (item);
+          item->prev (last_item);
+        }
+      last_item = item;
+      ++count;
+    }
+
+  return count;
+}
+
 // Take a look at the first item without removing it.
 
 template <ACE_SYNCH_DECL, class TIME_POLICY> int
@@ -2042,6 +2196,75 @@ ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_deadline (ACE_Message_Blo
   return this->dequeue_deadline_i (dequeued);
 }
 
+// Add a series of items to the end of the queue.  If timeout == 0
+// block indefinitely (or until an alert occurs).  Otherwise, block for
+// upto the amount of time specified by timeout.
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain (ACE_Message_Block *first_item,
+                                                 ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain");
+  int queue_count = 0;
+  ACE_Notification_Strategy *notifier = 0;
+  {
+    ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+
+    if (this->state_ == ACE_Message_Queue_Base::DEACTIVATED)
+      {
+        errno = ESHUTDOWN;
+        return -1;
+      }
+
+    if (this->wait_not_full_cond (timeout) == -1)
+      return -1;
+
+    queue_count = this->enqueue_chain_i (first_item);
+
+    if (queue_count == -1)
+      return -1;
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+    this->monitor_->receive (this->cur_length_);
+#endif
+    notifier = this->notification_strategy_;
+  }
+  if (0 != notifier)
+    notifier->notify ();
+  return queue_count;
+}
+
+// Remove up to <max_count> items from the front of the queue.  If
+// timeout == 0 block indefinitely (or until an alert occurs).
+// Otherwise, block for upto the amount of time specified by timeout.
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch (ACE_Message_Block *&first_item,
+                                                 size_t max_count,
+                                                 ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch");
+
+  if (max_count == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+
+  if (this->state_ == ACE_Message_Queue_Base::DEACTIVATED)
+    {
+      errno = ESHUTDOWN;
+      return -1;
+    }
+
+  if (this->wait_not_empty_cond (timeout) == -1)
+    return -1;
+
+  return this->dequeue_batch_i (first_item, max_count);
+}
+
 template <ACE_SYNCH_DECL, class TIME_POLICY> int
 ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::notify (void)
 {
@@ -2259,6 +2482,43 @@ ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_head (ACE_Message
   return result;
 }
 
+// Dequeue up to <max_count> messages from the (logical) head of the
+// queue, refreshing the priority status boundaries first, as
+// <dequeue_head> does.
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch (ACE_Message_Block *&first_item,
+                                                         size_t max_count,
+                                                         ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::dequeue_batch");
+
+  if (max_count == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX_T, ace_mon, this->lock_, -1);
+
+  if (this->state_ == ACE_Message_Queue_Base::DEACTIVATED)
+    {
+      errno = ESHUTDOWN;
+      return -1;
+    }
+
+  // refresh priority status boundaries in the queue
+  int result = this->refresh_queue (ACE_OS::gettimeofday ());
+  if (result < 0)
+    return result;
+
+  result = this->wait_not_empty_cond (timeout);
+  if (result == -1)
+    return result;
+
+  return this->dequeue_batch_i (first_item, max_count);
+}
+
 // Dequeue and return the <ACE_Message_Block *> at the (logical) head
 // of the queue.
 
@@ -2449,6 +2709,42 @@ ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_i (ACE_Message_Bl
 // Message Queue constructor to update the priorities of all enqueued
 // messages.
 
+// Enqueue each message of the series in accordance with its priority.
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain_i (ACE_Message_Block *first_item)
+{
+  ACE_TRACE ("ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::enqueue_chain_i");
+
+  if (first_item == 0)
+    return -1;
+
+  int result = 0;
+  bool several = first_item->next () != 0;
+
+  while (first_item != 0)
+    {
+      ACE_Message_Block *next_item = first_item->next ();
+      first_item->next (0);
+      first_item->prev (0);
+
+      result = this->enqueue_i (first_item);
+      if (result == -1)
+        {
+          // Leave the rest of the series linked to the failed message,
+          // as the caller handed it in.
+          first_item->next (next_item);
+          return -1;
+        }
+      first_item = next_item;
+    }
+
+  if (several && this->not_empty_cond_.broadcast () != 0)
+    return -1;
+
+  return result;
+}
+
 template <ACE_SYNCH_DECL, class TIME_POLICY> int
 ACE_Dynamic_Message_Queue<ACE_SYNCH_USE, TIME_POLICY>::sublist_enqueue_i (ACE_Message_Block *new_item,
                                                              const ACE_Time_Value &current_time,
@@ -2987,6 +3283,41 @@ ACE_Message_Queue_Factory<ACE_SYNCH_USE, TIME_POLICY>::create_laxity_message_que
 // Factory method for a dynamically prioritized (by laxity)
 // <ACE_Dynamic_Message_Queue>.
 
+#if defined (ACE_HAS_CPP11)
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY> *
+ACE_Message_Queue_Factory<ACE_SYNCH_USE, TIME_POLICY>::create_spsc_message_queue (size_t capacity,
+                                                                     size_t hwm,
+                                                                     size_t lwm,
+                                                                     ACE_Notification_Strategy *ns)
+{
+  typedef ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY> QUEUE_TYPE;
+  QUEUE_TYPE *tmp = 0;
+
+  ACE_NEW_RETURN (tmp,
+                  QUEUE_TYPE (capacity, hwm, lwm, ns),
+                  0);
+  return tmp;
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY>
+ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY> *
+ACE_Message_Queue_Factory<ACE_SYNCH_USE, TIME_POLICY>::create_mpsc_message_queue (size_t hwm,
+                                                                     size_t lwm,
+                                                                     ACE_Notification_Strategy *ns)
+{
+  typedef ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY> QUEUE_TYPE;
+  QUEUE_TYPE *tmp = 0;
+
+  ACE_NEW_RETURN (tmp,
+                  QUEUE_TYPE (hwm, lwm, ns),
+                  0);
+  return tmp;
+}
+
+#endif /* ACE_HAS_CPP11 */
+
 #if defined (ACE_VXWORKS)
   // factory method for a wrapped VxWorks message queue
 
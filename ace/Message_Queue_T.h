@@ -39,6 +39,11 @@ class ACE_Message_Queue_Vx;
 class ACE_Message_Queue_NT;
 #endif /* ACE_HAS_WIN32_OVERLAPPED_IO*/
 
+#if defined (ACE_HAS_CPP11)
+template <ACE_SYNCH_DECL, class TIME_POLICY> class ACE_Message_Queue_SPSC;
+template <ACE_SYNCH_DECL, class TIME_POLICY> class ACE_Message_Queue_MPSC;
+#endif /* ACE_HAS_CPP11 */
+
 #if defined (ACE_HAS_MONITOR_POINTS) && ACE_HAS_MONITOR_POINTS == 1
 namespace ACE
 {
@@ -350,6 +355,52 @@ public:
    */
   virtual int dequeue_deadline (ACE_Message_Block *&dequeued,
                                 ACE_Time_Value *timeout = 0);
+
+  /**
+   * Enqueue a series of ACE_Message_Block objects connected via their
+   * @c next() pointers at the tail of the queue.  This is the same as
+   * enqueue_tail(), except that all the threads waiting to dequeue
+   * are woken up if more than one block is added, so that a pool of
+   * consumers can pick up the whole batch.  The lock is taken and the
+   * notification strategy called only once for the whole series.
+   *
+   * @param first_item Pointer to the first ACE_Message_Block of the
+   *                   series.
+   * @param timeout    The absolute time the caller will wait until
+   *                   for the blocks to be queued.
+   *
+   * @retval >0 The number of ACE_Message_Blocks on the queue after adding
+   *             the specified blocks.
+   * @retval -1 On failure.  errno holds the reason. Common errno values are:
+   *            - EWOULDBLOCK: the timeout elapsed
+   *            - ESHUTDOWN: the queue was deactivated or pulsed
+   */
+  virtual int enqueue_chain (ACE_Message_Block *first_item,
+                             ACE_Time_Value *timeout = 0);
+
+  /**
+   * Dequeue up to @a max_count ACE_Message_Blocks from the head of the
+   * queue under a single lock acquisition.  Waits for at least one
+   * block to arrive, then takes whatever else is queued up to the
+   * limit without waiting any longer.
+   *
+   * @param first_item  Reference to an ACE_Message_Block * that will
+   *                    be set to the first dequeued block; the others
+   *                    follow it through their @c next() pointers, in
+   *                    queue order.
+   * @param max_count   The maximum number of blocks to dequeue.
+   * @param timeout     The absolute time the caller will wait until
+   *                    for a block to be dequeued.
+   *
+   * @retval >0 The number of ACE_Message_Blocks dequeued.
+   * @retval -1 On failure.  errno holds the reason. Common errno values are:
+   *            - EWOULDBLOCK: the timeout elapsed
+   *            - ESHUTDOWN: the queue was deactivated or pulsed
+   *            - EINVAL: @a max_count is 0
+   */
+  virtual int dequeue_batch (ACE_Message_Block *&first_item,
+                             size_t max_count,
+                             ACE_Time_Value *timeout = 0);
   //@}
 
   /** @name Queue statistics methods
@@ -536,6 +587,16 @@ protected:
   /// deadline time.
   virtual int dequeue_deadline_i (ACE_Message_Block *&first_item);
 
+  /// Enqueue a series of <ACE_Message_Block *> at the end of the
+  /// queue and wake up the threads waiting to dequeue.
+  virtual int enqueue_chain_i (ACE_Message_Block *first_item);
+
+  /// Dequeue up to @a max_count <ACE_Message_Block *> with
+  /// <dequeue_head_i> and link them through their next() pointers.
+  /// Returns the number dequeued.
+  virtual int dequeue_batch_i (ACE_Message_Block *&first_item,
+                               size_t max_count);
+
   // = Check the boundary conditions (assumes locks are held).
 
   /// True if queue is full, else false.
@@ -819,6 +880,15 @@ public:
   virtual int dequeue_head (ACE_Message_Block *&first_item,
                             ACE_Time_Value *timeout = 0);
 
+  /**
+   * Dequeue up to @a max_count <ACE_Message_Block *> from the head of
+   * the queue, linked through their next() pointers.  Returns -1 on
+   * failure, else the number of items dequeued.
+   */
+  virtual int dequeue_batch (ACE_Message_Block *&first_item,
+                             size_t max_count,
+                             ACE_Time_Value *timeout = 0);
+
   /// Dump the state of the queue.
   virtual void dump (void) const;
 
@@ -855,6 +925,10 @@ protected:
    */
   virtual int enqueue_i (ACE_Message_Block *new_item);
 
+  /// Enqueue each message of a series linked through their next()
+  /// pointers with <enqueue_i>.
+  virtual int enqueue_chain_i (ACE_Message_Block *first_item);
+
   /// Enqueue a message in priority order within a given priority status sublist
   virtual int sublist_enqueue_i (ACE_Message_Block *new_item,
                                  const ACE_Time_Value &current_time,
@@ -964,6 +1038,25 @@ public:
                                  u_long dynamic_priority_offset =  0x200000UL); // 2^(22-1)
 
 
+#if defined (ACE_HAS_CPP11)
+
+  /// Factory method for a lock-free single-producer/single-consumer
+  /// ACE_Message_Queue_SPSC holding at most @a capacity messages.
+  static ACE_Message_Queue_SPSC<ACE_SYNCH_USE, TIME_POLICY> *
+    create_spsc_message_queue (size_t capacity,
+                               size_t hwm = ACE_Message_Queue_Base::DEFAULT_HWM,
+                               size_t lwm = ACE_Message_Queue_Base::DEFAULT_LWM,
+                               ACE_Notification_Strategy * = 0);
+
+  /// Factory method for a lock-free multi-producer/single-consumer
+  /// ACE_Message_Queue_MPSC.
+  static ACE_Message_Queue_MPSC<ACE_SYNCH_USE, TIME_POLICY> *
+    create_mpsc_message_queue (size_t hwm = ACE_Message_Queue_Base::DEFAULT_HWM,
+                               size_t lwm = ACE_Message_Queue_Base::DEFAULT_LWM,
+                               ACE_Notification_Strategy * = 0);
+
+#endif /* ACE_HAS_CPP11 */
+
 #if defined (ACE_VXWORKS)
 
   /// Factory method for a wrapped VxWorks message queue
@@ -1254,6 +1347,46 @@ public:
    */
   virtual int dequeue_deadline (ACE_MESSAGE_TYPE *&dequeued,
                                 ACE_Time_Value *timeout = 0);
+
+  /**
+   * Enqueue @a count items at the tail of the queue, in array order,
+   * taking the queue lock and waking up the dequeueing threads only
+   * once.
+   *
+   * @param new_items The items to enqueue.
+   * @param count     Number of items in @a new_items.
+   * @param timeout   The absolute time the caller will wait until
+   *                  for the items to be queued.
+   *
+   * @retval >0 The number of items on the queue after adding
+   *             the specified items.
+   * @retval -1 On failure; none of the items is queued.  errno holds
+   *            the reason. Common errno values are:
+   *            - EWOULDBLOCK: the timeout elapsed
+   *            - ESHUTDOWN: the queue was deactivated or pulsed
+   */
+  virtual int enqueue_batch (ACE_MESSAGE_TYPE *new_items[],
+                             size_t count,
+                             ACE_Time_Value *timeout = 0);
+
+  /**
+   * Dequeue up to @a max_count items from the head of the queue under
+   * a single lock acquisition.  Waits for at least one item to arrive.
+   *
+   * @param items     Array of at least @a max_count pointers that is
+   *                  filled with the dequeued items, in queue order.
+   * @param max_count The maximum number of items to dequeue.
+   * @param timeout   The absolute time the caller will wait until
+   *                  for an item to be dequeued.
+   *
+   * @retval >0 The number of items dequeued.
+   * @retval -1 On failure.  errno holds the reason. Common errno values are:
+   *            - EWOULDBLOCK: the timeout elapsed
+   *            - ESHUTDOWN: the queue was deactivated or pulsed
+   */
+  virtual int dequeue_batch (ACE_MESSAGE_TYPE *items[],
+                             size_t max_count,
+                             ACE_Time_Value *timeout = 0);
   //@}
 
   /** @name Queue statistics methods
@@ -1404,6 +1537,10 @@ public:
   ACE_ALLOC_HOOK_DECLARE;
 
 protected:
+  /// Release the message blocks of a series built by <enqueue_batch>,
+  /// leaving the items they refer to alone.
+  void release_chain (ACE_Message_Block *first);
+
   /// Implement this via an ACE_Message_Queue.
   ACE_Message_Queue<ACE_SYNCH_USE, TIME_POLICY> queue_;
 };
@@ -0,0 +1,96 @@
+// $Id$
+
+#include "ace/Monitor_Histogram.h"
+
+#if defined (ACE_HAS_MONITOR_FRAMEWORK) && (ACE_HAS_MONITOR_FRAMEWORK == 1)
+
+#include "ace/ACE.h"
+#include "ace/OS_NS_stdio.h"
+
+#if !defined (__ACE_INLINE__)
+#include "ace/Monitor_Histogram.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace ACE
+{
+  namespace Monitor_Control
+  {
+    Histogram_Monitor::Histogram_Monitor (const char* name)
+      : Monitor_Base (name, Monitor_Control_Types::MC_LIST)
+      , samples_ (0)
+      , sum_ (0)
+    {
+      for (size_t i = 0; i < BUCKETS; ++i)
+        {
+          this->buckets_[i] = 0;
+        }
+    }
+
+    Histogram_Monitor::~Histogram_Monitor (void)
+    {
+    }
+
+    void
+    Histogram_Monitor::update (void)
+    {
+      Monitor_Control_Types::NameList list;
+      char buf[64];
+
+      ACE_OS::sprintf (buf,
+                       "samples: %lu",
+                       this->samples_.value ());
+      list.push_back (buf);
+
+      ACE_OS::sprintf (buf,
+                       "sum: " ACE_UINT64_FORMAT_SPECIFIER_ASCII,
+                       this->sum_.value ());
+      list.push_back (buf);
+
+      for (size_t i = 0; i < BUCKETS; ++i)
+        {
+          unsigned long const count = this->buckets_[i].value ();
+          if (count == 0)
+            {
+              continue;
+            }
+
+          if (i == BUCKETS - 1)
+            {
+              ACE_OS::sprintf (buf,
+                               ">= " ACE_UINT64_FORMAT_SPECIFIER_ASCII ": %lu",
+                               ACE_UINT64 (1) << (i - 1),
+                               count);
+            }
+          else
+            {
+              ACE_OS::sprintf (buf,
+                               "< " ACE_UINT64_FORMAT_SPECIFIER_ASCII ": %lu",
+                               ACE_UINT64 (1) << i,
+                               count);
+            }
+          list.push_back (buf);
+        }
+
+      this->receive (list);
+    }
+
+    void
+    Histogram_Monitor::clear_i (void)
+    {
+      for (size_t i = 0; i < BUCKETS; ++i)
+        {
+          this->buckets_[i] = 0;
+        }
+      this->samples_ = 0;
+      this->sum_ = 0;
+
+      this->Monitor_Base::clear_i ();
+    }
+  }
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_MONITOR_FRAMEWORK==1 */
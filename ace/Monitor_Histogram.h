@@ -0,0 +1,107 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ * @file Monitor_Histogram.h
+ *
+ * $Id$
+ */
+//=============================================================================
+
+#ifndef HISTOGRAM_MONITOR_H
+#define HISTOGRAM_MONITOR_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/ACE_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+#pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Monitor_Base.h"
+
+#if defined (ACE_HAS_MONITOR_FRAMEWORK) && (ACE_HAS_MONITOR_FRAMEWORK == 1)
+
+#include "ace/ACE.h"
+#include "ace/Atomic_Op.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace ACE
+{
+  namespace Monitor_Control
+  {
+    /**
+     * @class Histogram_Monitor
+     *
+     * @brief Monitor counting samples in power of two buckets.
+     *
+     * record() only updates ACE_Atomic_Op counters, so it can be
+     * called on hot paths by several threads at once.  The counters
+     * are lock-free where ACE_Atomic_Op is specialized for their type,
+     * e.g., with the GCC atomic builtins; elsewhere, such as for the
+     * 64-bit sum on targets that only have the x86 ones, each update
+     * takes a mutex.  The counts are published
+     * as the list of this monitor by update(), which Monitor_Admin
+     * calls periodically when the monitor is registered with an
+     * update interval.  The list has the number of samples, their
+     * sum, then one "< limit: count" entry per non-empty bucket.
+     *
+     * Bucket 0 counts samples of 0, bucket i samples from 2^(i-1) up
+     * to 2^i, and the last bucket everything larger.
+     */
+    class ACE_Export Histogram_Monitor : public Monitor_Base
+    {
+    public:
+      enum
+      {
+        BUCKETS = 32
+      };
+
+      Histogram_Monitor (const char* name);
+      virtual ~Histogram_Monitor (void);
+
+      /// Count @a sample.
+      void record (ACE_UINT64 sample);
+
+      /// Publish the counts as the list of this monitor.
+      virtual void update (void);
+
+      /// Number of samples recorded.
+      unsigned long samples (void) const;
+
+      /// Sum of the samples recorded.
+      ACE_UINT64 sum (void) const;
+
+      /// Number of samples recorded in bucket @a i.
+      unsigned long bucket (size_t i) const;
+
+      /// Bucket that @a sample is counted in.
+      static size_t bucket_index (ACE_UINT64 sample);
+
+    protected:
+      /// Reset the counts as well as the published list.
+      virtual void clear_i (void);
+
+    private:
+      typedef ACE_Atomic_Op<ACE_SYNCH_MUTEX, unsigned long> Counter;
+
+      Counter buckets_[BUCKETS];
+      Counter samples_;
+      ACE_Atomic_Op<ACE_SYNCH_MUTEX, ACE_UINT64> sum_;
+    };
+  }
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/Monitor_Histogram.inl"
+#endif /* __ACE_INLINE__ */
+
+#endif /* ACE_HAS_MONITOR_FRAMEWORK==1 */
+
+#include /**/ "ace/post.h"
+
+#endif // HISTOGRAM_MONITOR_H
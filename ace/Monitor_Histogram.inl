@@ -0,0 +1,58 @@
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace ACE
+{
+  namespace Monitor_Control
+  {
+    ACE_INLINE
+    size_t
+    Histogram_Monitor::bucket_index (ACE_UINT64 sample)
+    {
+      if (sample == 0)
+        {
+          return 0;
+        }
+
+      if (sample >= (ACE_UINT64 (1) << (BUCKETS - 2)))
+        {
+          return BUCKETS - 1;
+        }
+
+      return ACE::log2 (static_cast<u_long> (sample)) + 1;
+    }
+
+    ACE_INLINE
+    void
+    Histogram_Monitor::record (ACE_UINT64 sample)
+    {
+      ++this->buckets_[Histogram_Monitor::bucket_index (sample)];
+      ++this->samples_;
+      this->sum_ += sample;
+    }
+
+    ACE_INLINE
+    unsigned long
+    Histogram_Monitor::samples (void) const
+    {
+      return this->samples_.value ();
+    }
+
+    ACE_INLINE
+    ACE_UINT64
+    Histogram_Monitor::sum (void) const
+    {
+      return this->sum_.value ();
+    }
+
+    ACE_INLINE
+    unsigned long
+    Histogram_Monitor::bucket (size_t i) const
+    {
+      return i < BUCKETS ? this->buckets_[i].value () : 0;
+    }
+  }
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
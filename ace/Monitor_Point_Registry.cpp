@@ -5,6 +5,7 @@
 #if defined (ACE_HAS_MONITOR_FRAMEWORK) && (ACE_HAS_MONITOR_FRAMEWORK == 1)
 
 #include "ace/Monitor_Base.h"
+#include "ace/OS_NS_Thread.h"
 
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
@@ -20,8 +21,25 @@ namespace ACE
     }
 
     Monitor_Point_Registry::Monitor_Point_Registry (void)
-      : constraint_id_ (0)
+      : map_ (0)
+#if defined (ACE_HAS_CPP11)
+      , epoch_ (0)
+#endif /* ACE_HAS_CPP11 */
+      , constraint_id_ (0)
     {
+#if defined (ACE_HAS_CPP11)
+      this->readers_[0] = 0;
+      this->readers_[1] = 0;
+#endif /* ACE_HAS_CPP11 */
+
+      Map *map = 0;
+      ACE_NEW (map, Map);
+      this->map_ = map;
+    }
+
+    Monitor_Point_Registry::~Monitor_Point_Registry (void)
+    {
+      delete this->map_;
     }
 
     bool
@@ -39,9 +57,27 @@ namespace ACE
       {
         ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->mutex_, false);
 
-        type->add_ref ();
+        Map *map = this->copy_map ();
 
-        status = this->map_.bind (type->name (), type);
+        if (map == 0)
+          {
+            status = -1;
+          }
+        else
+          {
+            type->add_ref ();
+
+            status = map->bind (type->name (), type);
+
+            if (status == 0)
+              {
+                this->publish (map);
+              }
+            else
+              {
+                delete map;
+              }
+          }
 
         /// Temporary debugging code.
 //        ACELIB_DEBUG ((LM_DEBUG, "adding %s\n", type->name ()));
@@ -74,7 +110,26 @@ namespace ACE
         ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->mutex_, false);
 
         ACE_CString name_str (name, 0, false);
-        status = this->map_.unbind (name_str, mp);
+        Map *map = this->copy_map ();
+
+        if (map == 0)
+          {
+            status = -1;
+          }
+        else
+          {
+            status = map->unbind (name_str, mp);
+
+            if (status == 0)
+              {
+                // Nobody can find mp once this returns.
+                this->publish (map);
+              }
+            else
+              {
+                delete map;
+              }
+          }
 
         /// Temporary debugging code.
 //        ACELIB_DEBUG ((LM_DEBUG, "removing %s\n", name_str.c_str ()));
@@ -107,9 +162,14 @@ namespace ACE
       Monitor_Control_Types::NameList name_holder_;
 
       {
-        ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->mutex_, 0);
+        Read_Guard guard (*this);
 
-        for (Map::CONST_ITERATOR i (this->map_); !i.done (); i.advance ())
+        if (guard.map () == 0)
+          {
+            return name_holder_;
+          }
+
+        for (Map::CONST_ITERATOR i (*guard.map ()); !i.done (); i.advance ())
           {
             name_holder_.push_back (i->key ());
           }
@@ -123,14 +183,12 @@ namespace ACE
     {
       Map::data_type mp = 0;
 
-      {
-        ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->mutex_, 0);
-
-        this->map_.find (name, mp);
-      }
+      Read_Guard guard (*this);
 
-      if (mp != 0)
+      if (guard.map () != 0
+          && guard.map ()->find (name, mp) == 0)
         {
+          // The registry keeps its reference for as long as we read.
           mp->add_ref ();
         }
 
@@ -154,8 +212,10 @@ namespace ACE
     void
     Monitor_Point_Registry::cleanup (void)
     {
-      for (Map::ITERATOR i = this->map_.begin ();
-           i != this->map_.end ();
+      Map *map = this->map_;
+
+      for (Map::ITERATOR i = map->begin ();
+           i != map->end ();
            i.advance ())
         {
           Map::ENTRY* entry = 0;
@@ -163,6 +223,102 @@ namespace ACE
           entry->int_id_->remove_ref ();
         }
     }
+
+    Monitor_Point_Registry::Map *
+    Monitor_Point_Registry::copy_map (void) const
+    {
+      const Map *current = this->map_;
+      Map *map = 0;
+
+      ACE_NEW_RETURN (map,
+                      Map (current->current_size () + ACE_DEFAULT_MAP_SIZE),
+                      0);
+
+      for (Map::CONST_ITERATOR i (*current); !i.done (); i.advance ())
+        {
+          if (map->bind (i->key (), i->item ()) == -1)
+            {
+              delete map;
+              return 0;
+            }
+        }
+
+      return map;
+    }
+
+    void
+    Monitor_Point_Registry::publish (Map *map)
+    {
+#if defined (ACE_HAS_CPP11)
+      Map *const previous = this->map_.exchange (map);
+
+      // Readers that announced themselves in the previous epoch may
+      // still be using the previous map; the next ones can only get
+      // the new map.
+      unsigned long const epoch = this->epoch_.fetch_add (1);
+
+      while (this->readers_[epoch & 1].load () != 0)
+        {
+          ACE_OS::thr_yield ();
+        }
+
+      delete previous;
+#else
+      delete this->map_;
+      this->map_ = map;
+#endif /* ACE_HAS_CPP11 */
+    }
+
+    Monitor_Point_Registry::Read_Guard::Read_Guard (
+        const Monitor_Point_Registry &registry)
+      : registry_ (registry)
+      , map_ (0)
+#if defined (ACE_HAS_CPP11)
+      , epoch_ (0)
+#endif /* ACE_HAS_CPP11 */
+    {
+#if defined (ACE_HAS_CPP11)
+      // Count ourselves in the current epoch.  If it changed before
+      // we did, a writer may not wait for us, so start again.
+      for (;;)
+        {
+          this->epoch_ = registry.epoch_.load ();
+          ++registry.readers_[this->epoch_ & 1];
+
+          if (registry.epoch_.load () == this->epoch_)
+            {
+              break;
+            }
+
+          --registry.readers_[this->epoch_ & 1];
+        }
+
+      this->map_ = registry.map_.load ();
+#else
+      if (registry.mutex_.acquire () == 0)
+        {
+          this->map_ = registry.map_;
+        }
+#endif /* ACE_HAS_CPP11 */
+    }
+
+    Monitor_Point_Registry::Read_Guard::~Read_Guard (void)
+    {
+#if defined (ACE_HAS_CPP11)
+      --this->registry_.readers_[this->epoch_ & 1];
+#else
+      if (this->map_ != 0)
+        {
+          this->registry_.mutex_.release ();
+        }
+#endif /* ACE_HAS_CPP11 */
+    }
+
+    const Monitor_Point_Registry::Map *
+    Monitor_Point_Registry::Read_Guard::map (void) const
+    {
+      return this->map_;
+    }
   }
 }
 
@@ -29,6 +29,10 @@
 #include "ace/Monitor_Control_Types.h"
 #include "ace/Singleton.h"
 
+#if defined (ACE_HAS_CPP11)
+# include <atomic>
+#endif /* ACE_HAS_CPP11 */
+
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
 namespace ACE
@@ -42,6 +46,14 @@ namespace ACE
      *
      * @brief Storage for instantiated monitor points.
      *
+     * Monitor points are looked up much more often than they are
+     * added or removed, so add() and remove() replace the whole map
+     * with a modified copy.  With ACE_HAS_CPP11, get() and names()
+     * then read the current map without taking a lock: they only
+     * announce themselves in a reader count for the current epoch,
+     * and a writer frees the map it replaced, and drops the reference
+     * on a removed monitor point, once the readers of the previous
+     * epoch are gone.
      */
     class ACE_Export Monitor_Point_Registry
     {
@@ -75,14 +87,62 @@ namespace ACE
     private:
       /// Prevent that users can make an instance.
       Monitor_Point_Registry (void);
+      ~Monitor_Point_Registry (void);
 
       /// Underlying container for the registry.
       typedef ACE_Hash_Map_Manager<ACE_CString,
                                    Monitor_Base*,
                                    ACE_SYNCH_NULL_MUTEX> Map;
 
+      /**
+       * @class Read_Guard
+       *
+       * @brief Gives access to the current map for as long as it
+       * exists.
+       */
+      class Read_Guard
+      {
+      public:
+        Read_Guard (const Monitor_Point_Registry &registry);
+        ~Read_Guard (void);
+
+        /// The map, 0 if it could not be accessed.
+        const Map *map (void) const;
+
+      private:
+        const Monitor_Point_Registry &registry_;
+        const Map *map_;
+#if defined (ACE_HAS_CPP11)
+        unsigned long epoch_;
+#endif /* ACE_HAS_CPP11 */
+      };
+
+      friend class Read_Guard;
+
+      /// Copy of the current map, to be modified then published.
+      /// Called with @c mutex_ held.
+      Map *copy_map (void) const;
+
+      /// Make @a map the current map, and delete the previous one
+      /// once nobody can be reading it anymore.  Called with
+      /// @c mutex_ held.
+      void publish (Map *map);
+
+      /// Serializes add() and remove(), and all the accesses to the
+      /// map without ACE_HAS_CPP11.
       mutable ACE_SYNCH_MUTEX mutex_;
-      Map map_;
+
+#if defined (ACE_HAS_CPP11)
+      std::atomic<Map *> map_;
+
+      /// Incremented each time the map is replaced.
+      std::atomic<unsigned long> epoch_;
+
+      /// Number of readers in the even and odd epochs.
+      mutable std::atomic<long> readers_[2];
+#else
+      Map *map_;
+#endif /* ACE_HAS_CPP11 */
 
       /// Since we're accessed as a singleton, we can keep track of
       /// dispensing unique ids for constraints.
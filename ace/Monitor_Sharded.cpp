@@ -0,0 +1,125 @@
+// $Id$
+
+#include "ace/Monitor_Sharded.h"
+
+#if defined (ACE_HAS_MONITOR_FRAMEWORK) && (ACE_HAS_MONITOR_FRAMEWORK == 1)
+
+#include "ace/Guard_T.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_unistd.h"
+
+#if !defined (__ACE_INLINE__)
+#include "ace/Monitor_Sharded.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace ACE
+{
+  namespace Monitor_Control
+  {
+    Monitor_Shards::Monitor_Shards (void)
+      : shards_ (0)
+      , mask_ (0)
+    {
+      long const processors = ACE_OS::num_processors ();
+      size_t count = 1;
+
+      while (processors > 0 && count < static_cast<size_t> (processors))
+        {
+          count <<= 1;
+        }
+
+      ACE_NEW (this->shards_, Shard[count]);
+      this->mask_ = count - 1;
+      this->reset ();
+    }
+
+    Monitor_Shards::~Monitor_Shards (void)
+    {
+      delete [] this->shards_;
+    }
+
+    ACE_INT64
+    Monitor_Shards::value (void) const
+    {
+      ACE_INT64 sum = 0;
+
+      for (size_t i = 0; i <= this->mask_; ++i)
+        {
+          sum += this->shards_[i].value_.value ();
+        }
+
+      return sum;
+    }
+
+    void
+    Monitor_Shards::reset (void)
+    {
+      for (size_t i = 0; i <= this->mask_; ++i)
+        {
+          this->shards_[i].value_ = 0;
+        }
+    }
+
+    //=========================================================
+
+    Sharded_Counter_Monitor::Sharded_Counter_Monitor (const char* name)
+      : Monitor_Base (name, Monitor_Control_Types::MC_COUNTER)
+    {
+    }
+
+    Sharded_Counter_Monitor::~Sharded_Counter_Monitor (void)
+    {
+    }
+
+    void
+    Sharded_Counter_Monitor::update (void)
+    {
+      double const count = static_cast<double> (this->value ());
+
+      ACE_GUARD (ACE_SYNCH_MUTEX, guard, this->mutex_);
+
+      // What receive() would have left after that many calls.
+      this->data_.timestamp_ = ACE_OS::gettimeofday ();
+      this->data_.value_ = count;
+      this->data_.last_ = count;
+      this->data_.maximum_ = count;
+    }
+
+    void
+    Sharded_Counter_Monitor::clear_i (void)
+    {
+      this->shards_.reset ();
+      this->Monitor_Base::clear_i ();
+    }
+
+    //=========================================================
+
+    Sharded_Gauge_Monitor::Sharded_Gauge_Monitor (const char* name)
+      : Monitor_Base (name, Monitor_Control_Types::MC_NUMBER)
+    {
+    }
+
+    Sharded_Gauge_Monitor::~Sharded_Gauge_Monitor (void)
+    {
+    }
+
+    void
+    Sharded_Gauge_Monitor::update (void)
+    {
+      this->receive (static_cast<double> (this->value ()));
+    }
+
+    void
+    Sharded_Gauge_Monitor::clear_i (void)
+    {
+      this->shards_.reset ();
+      this->Monitor_Base::clear_i ();
+    }
+  }
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_MONITOR_FRAMEWORK==1 */
@@ -0,0 +1,162 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ * @file Monitor_Sharded.h
+ *
+ * $Id$
+ */
+//=============================================================================
+
+#ifndef SHARDED_MONITOR_H
+#define SHARDED_MONITOR_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/ACE_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+#pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Monitor_Base.h"
+
+#if defined (ACE_HAS_MONITOR_FRAMEWORK) && (ACE_HAS_MONITOR_FRAMEWORK == 1)
+
+#include "ace/Atomic_Op.h"
+#include "ace/Copy_Disabled.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace ACE
+{
+  namespace Monitor_Control
+  {
+    /**
+     * @class Monitor_Shards
+     *
+     * @brief A value split in one atomic counter per CPU.
+     *
+     * Each thread adds to the counter of the CPU it runs on, or of
+     * its thread id without ACE_HAS_SCHED_GETCPU, each on its own
+     * cache line, so threads updating the value at the same time do
+     * not contend.  Reading the value adds up all the counters.
+     */
+    class ACE_Export Monitor_Shards : private ACE_Copy_Disabled
+    {
+    public:
+      /// One shard per processor, rounded up to a power of two.
+      Monitor_Shards (void);
+      ~Monitor_Shards (void);
+
+      /// Add @a delta to the shard of the calling thread.
+      void add (ACE_INT64 delta);
+
+      /// Sum of the shards.
+      ACE_INT64 value (void) const;
+
+      /// Set the shards back to zero.  Additions made at the same
+      /// time may be lost.
+      void reset (void);
+
+      /// Number of shards.
+      size_t size (void) const;
+
+    private:
+      /// Shard of the calling thread.
+      size_t current (void) const;
+
+      enum { CACHE_LINE_SIZE = 64 };
+
+      struct Shard
+      {
+        ACE_Atomic_Op<ACE_SYNCH_MUTEX, ACE_INT64> value_;
+        char pad_[CACHE_LINE_SIZE];
+      };
+
+      Shard *shards_;
+
+      /// Number of shards minus one.
+      size_t mask_;
+    };
+
+    /**
+     * @class Sharded_Counter_Monitor
+     *
+     * @brief Counter monitor for hot paths.
+     *
+     * increment() only adds to a Monitor_Shards, without taking the
+     * monitor's lock like receive() does.  The shards are added up
+     * into the monitor's data by update(), which Monitor_Admin calls
+     * periodically when the monitor is registered with an update
+     * interval; value() reads them directly.
+     */
+    class ACE_Export Sharded_Counter_Monitor : public Monitor_Base
+    {
+    public:
+      Sharded_Counter_Monitor (const char* name);
+      virtual ~Sharded_Counter_Monitor (void);
+
+      /// Count @a n more events.
+      void increment (ACE_UINT64 n = 1);
+
+      /// Number of events counted, read from the shards.
+      ACE_UINT64 value (void) const;
+
+      /// Store value() as the count of this monitor.
+      virtual void update (void);
+
+    protected:
+      /// Reset the shards as well as the count.
+      virtual void clear_i (void);
+
+    private:
+      Monitor_Shards shards_;
+    };
+
+    /**
+     * @class Sharded_Gauge_Monitor
+     *
+     * @brief Number monitor for a level changed on hot paths.
+     *
+     * add() only adds to a Monitor_Shards.  update() receives the
+     * level read from the shards as a new sample, so the minimum,
+     * maximum and average of the monitor are those of the level at
+     * each update.
+     */
+    class ACE_Export Sharded_Gauge_Monitor : public Monitor_Base
+    {
+    public:
+      Sharded_Gauge_Monitor (const char* name);
+      virtual ~Sharded_Gauge_Monitor (void);
+
+      /// Change the level by @a delta.
+      void add (ACE_INT64 delta);
+
+      /// Current level, read from the shards.
+      ACE_INT64 value (void) const;
+
+      /// Receive value() as a sample.
+      virtual void update (void);
+
+    protected:
+      /// Reset the shards as well as the samples.
+      virtual void clear_i (void);
+
+    private:
+      Monitor_Shards shards_;
+    };
+  }
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/Monitor_Sharded.inl"
+#endif /* __ACE_INLINE__ */
+
+#endif /* ACE_HAS_MONITOR_FRAMEWORK==1 */
+
+#include /**/ "ace/post.h"
+
+#endif // SHARDED_MONITOR_H
@@ -0,0 +1,74 @@
+// $Id$
+
+#include "ace/ACE.h"
+#include "ace/OS_NS_Thread.h"
+#include "ace/os_include/os_sched.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace ACE
+{
+  namespace Monitor_Control
+  {
+    ACE_INLINE
+    size_t
+    Monitor_Shards::current (void) const
+    {
+#if defined (ACE_HAS_SCHED_GETCPU)
+      int const cpu = ::sched_getcpu ();
+      if (cpu >= 0)
+        {
+          return static_cast<size_t> (cpu) & this->mask_;
+        }
+#endif /* ACE_HAS_SCHED_GETCPU */
+
+      ACE_thread_t const self = ACE_OS::thr_self ();
+      return ACE::hash_pjw (reinterpret_cast<const char *> (&self),
+                            sizeof self) & this->mask_;
+    }
+
+    ACE_INLINE
+    void
+    Monitor_Shards::add (ACE_INT64 delta)
+    {
+      this->shards_[this->current ()].value_ += delta;
+    }
+
+    ACE_INLINE
+    size_t
+    Monitor_Shards::size (void) const
+    {
+      return this->mask_ + 1;
+    }
+
+    ACE_INLINE
+    void
+    Sharded_Counter_Monitor::increment (ACE_UINT64 n)
+    {
+      this->shards_.add (static_cast<ACE_INT64> (n));
+    }
+
+    ACE_INLINE
+    ACE_UINT64
+    Sharded_Counter_Monitor::value (void) const
+    {
+      return static_cast<ACE_UINT64> (this->shards_.value ());
+    }
+
+    ACE_INLINE
+    void
+    Sharded_Gauge_Monitor::add (ACE_INT64 delta)
+    {
+      this->shards_.add (delta);
+    }
+
+    ACE_INLINE
+    ACE_INT64
+    Sharded_Gauge_Monitor::value (void) const
+    {
+      return this->shards_.value ();
+    }
+  }
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -8,6 +8,12 @@
 
 #include "ace/Guard_T.h"
 
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+# include "ace/Log_Category.h"
+# include "ace/OS_NS_unistd.h"
+# include /**/ <sys/eventfd.h>
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
+
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
 ACE_Notification_Queue::
@@ -222,4 +228,424 @@ ACE_Notification_Queue::pop_next_notification(
   return 1;
 }
 
+#if defined (ACE_HAS_CPP11)
+
+ACE_Notification_Queue_Lock_Free::
+ACE_Notification_Queue_Lock_Free()
+  : ACE_Copy_Disabled()
+  , array_count_(0)
+  , free_(0)
+  , pending_(0)
+  , size_(0)
+  , notify_queue_()
+{
+  for (unsigned int i = 0; i != MAX_ARRAYS; ++i)
+    {
+      arrays_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+ACE_Notification_Queue_Lock_Free::
+~ACE_Notification_Queue_Lock_Free()
+{
+  reset();
+}
+
+int
+ACE_Notification_Queue_Lock_Free::open()
+{
+  ACE_TRACE ("ACE_Notification_Queue_Lock_Free::open");
+
+  if (free_.load() != 0)
+    return 0;
+
+  Node * node = allocate_more_buffers();
+  if (node == 0)
+    {
+      return -1;
+    }
+
+  free_nodes(node, node);
+  return 0;
+}
+
+void
+ACE_Notification_Queue_Lock_Free::reset()
+{
+  ACE_TRACE ("ACE_Notification_Queue_Lock_Free::reset");
+
+  // Release all the event handlers still in the queue ...
+  take_pending();
+  for (ACE_Notification_Queue_Node * node = notify_queue_.head();
+       node != 0;
+       node = node->next())
+    {
+      if (node->get().eh_ == 0)
+        {
+          continue;
+        }
+      (void) node->get().eh_->remove_reference();
+    }
+  Buffer_List().swap(notify_queue_);
+
+  // ... and free up the nodes.
+  unsigned int const count = array_count_.load();
+  for (unsigned int i = 0; i != count; ++i)
+    {
+      delete [] arrays_[i].load();
+      arrays_[i].store(0);
+    }
+
+  array_count_.store(0);
+  free_.store(0);
+  size_.store(0);
+}
+
+ACE_Notification_Queue_Lock_Free::Node *
+ACE_Notification_Queue_Lock_Free::node(ACE_UINT32 index) const
+{
+  // Array k has (ACE_REACTOR_NOTIFICATION_ARRAY_SIZE << k) nodes,
+  // after the first (ACE_REACTOR_NOTIFICATION_ARRAY_SIZE << k) -
+  // ACE_REACTOR_NOTIFICATION_ARRAY_SIZE.
+  ACE_UINT64 const base = ACE_REACTOR_NOTIFICATION_ARRAY_SIZE;
+  ACE_UINT64 const arrays = index / base + 1;
+  unsigned int k = 0;
+  while ((ACE_UINT64 (2) << k) <= arrays)
+    {
+      ++k;
+    }
+
+  ACE_UINT64 const first = (base << k) - base;
+  return arrays_[k].load(std::memory_order_acquire) + (index - first);
+}
+
+ACE_Notification_Queue_Lock_Free::Node *
+ACE_Notification_Queue_Lock_Free::allocate_node()
+{
+  ACE_UINT64 head = free_.load(std::memory_order_acquire);
+  for (;;)
+    {
+      ACE_UINT32 const first = static_cast<ACE_UINT32>(head);
+      if (first == 0)
+        {
+          // Another thread may have grown the queue while this one
+          // waited for the lock; then take a node it allocated.
+          ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, mon, this->grow_lock_, 0);
+          head = free_.load(std::memory_order_acquire);
+          if (static_cast<ACE_UINT32>(head) == 0)
+            {
+              return allocate_more_buffers();
+            }
+          continue;
+        }
+
+      // The node may be taken, and its free_next_ changed, by another
+      // thread in the meantime, but then the count in free_ changes
+      // too and the exchange fails.
+      Node * const node = this->node(first - 1);
+      ACE_UINT64 const next =
+        (((head >> 32) + 1) << 32)
+        | node->free_next_.load(std::memory_order_relaxed);
+      if (free_.compare_exchange_weak(head,
+                                      next,
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire))
+        {
+          return node;
+        }
+    }
+}
+
+ACE_Notification_Queue_Lock_Free::Node *
+ACE_Notification_Queue_Lock_Free::allocate_more_buffers()
+{
+  ACE_TRACE ("ACE_Notification_Queue_Lock_Free::allocate_more_buffers");
+
+  // Reserve the next array, as long as the index of its last node
+  // plus one fits in 32 bits.
+  ACE_UINT64 const base = ACE_REACTOR_NOTIFICATION_ARRAY_SIZE;
+  unsigned int k = array_count_.load();
+  do
+    {
+      if (k == MAX_ARRAYS
+          || (base << (k + 1)) - base > ACE_UINT64 (0xffffffff))
+        {
+          errno = ENOMEM;
+          return 0;
+        }
+    }
+  while (!array_count_.compare_exchange_weak(k, k + 1));
+
+  size_t const count = static_cast<size_t>(base << k);
+  ACE_UINT32 const first = static_cast<ACE_UINT32>((base << k) - base);
+
+  Node * array = 0;
+  ACE_NEW_RETURN (array, Node[count], 0);
+
+  for (size_t i = 0; i != count; ++i)
+    {
+      array[i].index_ = first + static_cast<ACE_UINT32>(i);
+      array[i].free_next_.store(i + 1 == count
+                                ? 0
+                                : first + static_cast<ACE_UINT32>(i) + 2,
+                                std::memory_order_relaxed);
+    }
+  arrays_[k].store(array, std::memory_order_release);
+
+  if (count > 1)
+    {
+      free_nodes(array + 1, array + count - 1);
+    }
+  return array;
+}
+
+size_t
+ACE_Notification_Queue_Lock_Free::capacity() const
+{
+  size_t const base = ACE_REACTOR_NOTIFICATION_ARRAY_SIZE;
+  return (base << array_count_.load()) - base;
+}
+
+void
+ACE_Notification_Queue_Lock_Free::free_nodes(Node * first, Node * last)
+{
+  ACE_UINT64 head = free_.load(std::memory_order_relaxed);
+  ACE_UINT64 next = 0;
+  do
+    {
+      last->free_next_.store(static_cast<ACE_UINT32>(head),
+                             std::memory_order_relaxed);
+      next = (((head >> 32) + 1) << 32) | (first->index_ + 1);
+    }
+  while (!free_.compare_exchange_weak(head,
+                                      next,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed));
+}
+
+void
+ACE_Notification_Queue_Lock_Free::take_pending()
+{
+  Node * stack = pending_.exchange(0, std::memory_order_acquire);
+
+  // The stack has the last notification pushed first.
+  Node * reversed = 0;
+  while (stack != 0)
+    {
+      Node * const next = stack->pending_next_;
+      stack->pending_next_ = reversed;
+      reversed = stack;
+      stack = next;
+    }
+
+  while (reversed != 0)
+    {
+      Node * const node = reversed;
+      reversed = node->pending_next_;
+      notify_queue_.push_back(node);
+    }
+}
+
+int
+ACE_Notification_Queue_Lock_Free::purge_pending_notifications(
+  ACE_Event_Handler * eh,
+  ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Notification_Queue_Lock_Free::purge_pending_notifications");
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, mon, this->consumer_lock_, -1);
+
+  take_pending();
+  if (notify_queue_.is_empty ())
+    return 0;
+
+  int number_purged = 0;
+  ACE_Notification_Queue_Node * node = notify_queue_.head();
+  while(node != 0)
+    {
+      if (!node->matches_for_purging(eh))
+        {
+          node = node->next();
+          continue;
+        }
+
+      if (!node->mask_disables_all_notifications(mask))
+        {
+          node->clear_mask(mask);
+          node = node->next();
+          continue;
+        }
+
+      ACE_Notification_Queue_Node * next = node->next();
+
+      notify_queue_.unsafe_remove(node);
+      ++number_purged;
+
+      node->get().eh_->remove_reference ();
+
+      Node * const free_node = static_cast<Node *>(node);
+      free_nodes(free_node, free_node);
+
+      node = next;
+    }
+
+  size_.fetch_sub(number_purged);
+  return number_purged;
+}
+
+int
+ACE_Notification_Queue_Lock_Free::push_new_notification(
+  ACE_Notification_Buffer const & buffer)
+{
+  ACE_TRACE ("ACE_Notification_Queue_Lock_Free::push_new_notification");
+
+  Node * const node = allocate_node();
+  if (node == 0)
+    {
+      return -1;
+    }
+
+  node->set(buffer);
+
+  Node * head = pending_.load(std::memory_order_relaxed);
+  do
+    {
+      node->pending_next_ = head;
+    }
+  while (!pending_.compare_exchange_weak(head,
+                                         node,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+
+  // Counted once it can be popped, so that the consumer does not see
+  // more notifications than it can pop.
+  if (size_.fetch_add(1) != 0)
+    {
+      return 0;
+    }
+
+  return 1;
+}
+
+int
+ACE_Notification_Queue_Lock_Free::pop_next_notification(
+  ACE_Notification_Buffer & current,
+  bool & more_messages_queued,
+  ACE_Notification_Buffer & next)
+{
+  ACE_TRACE ("ACE_Notification_Queue_Lock_Free::pop_next_notification");
+
+  more_messages_queued = false;
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, mon, this->consumer_lock_, -1);
+
+  if (notify_queue_.is_empty ())
+    {
+      take_pending();
+      if (notify_queue_.is_empty ())
+        return 0;
+    }
+
+  Node * const node = static_cast<Node *>(notify_queue_.pop_front());
+
+  current = node->get();
+  free_nodes(node, node);
+
+  // A notification counted by a push has been pushed, so if there is
+  // another one, it is either in notify_queue_ or in pending_.
+  if (size_.fetch_sub(1) > 1)
+    {
+      more_messages_queued = true;
+      if (notify_queue_.is_empty ())
+        {
+          take_pending();
+        }
+      if (!notify_queue_.is_empty ())
+        {
+          next = notify_queue_.head()->get();
+        }
+    }
+
+  return 1;
+}
+
+#endif /* ACE_HAS_CPP11 */
+
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+
+ACE_Notification_Event::ACE_Notification_Event()
+  : ACE_Copy_Disabled()
+  , handle_(ACE_INVALID_HANDLE)
+{
+}
+
+ACE_Notification_Event::~ACE_Notification_Event()
+{
+  close();
+}
+
+int
+ACE_Notification_Event::open()
+{
+  ACE_TRACE ("ACE_Notification_Event::open");
+
+  handle_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  return handle_ == ACE_INVALID_HANDLE ? -1 : 0;
+}
+
+int
+ACE_Notification_Event::close()
+{
+  ACE_TRACE ("ACE_Notification_Event::close");
+
+  if (handle_ == ACE_INVALID_HANDLE)
+    return 0;
+
+  int const result = ACE_OS::close(handle_);
+  handle_ = ACE_INVALID_HANDLE;
+  return result;
+}
+
+int
+ACE_Notification_Event::signal()
+{
+  ACE_UINT64 const one = 1;
+  if (ACE_OS::write(handle_, &one, sizeof one)
+      == static_cast<ssize_t>(sizeof one))
+    return 0;
+
+  // The counter is full, which is as signaled as it gets.
+  if (errno == EAGAIN)
+    return 0;
+
+  return -1;
+}
+
+int
+ACE_Notification_Event::clear()
+{
+  ACE_UINT64 count = 0;
+  ssize_t const n = ACE_OS::read(handle_, &count, sizeof count);
+  if (n == static_cast<ssize_t>(sizeof count))
+    return 1;
+
+  if (n == -1 && (errno == EWOULDBLOCK || errno == EAGAIN))
+    return 0;
+
+  return -1;
+}
+
+void
+ACE_Notification_Event::dump() const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Notification_Event::dump");
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("handle_ = %d\n"), this->handle_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
+
 ACE_END_VERSIONED_NAMESPACE_DECL
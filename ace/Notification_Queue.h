@@ -17,6 +17,20 @@
 #include "ace/Intrusive_List_Node.h"
 #include "ace/Unbounded_Queue.h"
 
+// Where eventfd and the C++11 atomics are available, the reactors
+// queue their notifications in an ACE_Notification_Queue_Lock_Free
+// and wake up their event loop with an ACE_Notification_Event
+// instead of a pipe.
+#if defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE) \
+    && defined (ACE_HAS_EVENTFD) && defined (ACE_HAS_CPP11) \
+    && !defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+# define ACE_HAS_REACTOR_EVENTFD_NOTIFY
+#endif
+
+#if defined (ACE_HAS_CPP11)
+# include <atomic>
+#endif /* ACE_HAS_CPP11 */
+
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
 /**
@@ -146,6 +160,198 @@ private:
   ACE_SYNCH_MUTEX notify_queue_lock_;
 };
 
+#if defined (ACE_HAS_CPP11)
+/**
+ * @class ACE_Notification_Queue_Lock_Free
+ *
+ * @brief An ACE_Notification_Queue that the notifying threads never
+ * lock.
+ *
+ * push_new_notification() takes a node from a lock-free free list
+ * and pushes it on a lock-free stack of pending notifications.  The
+ * thread dispatching the notifications takes the whole stack at once
+ * when it runs out of notifications and delivers them in the order
+ * they were pushed.  Only pop_next_notification() and
+ * purge_pending_notifications() take a lock, to keep out of each
+ * other's way.
+ *
+ * Like ACE_Notification_Queue, push_new_notification() returns 1 only
+ * when the queue was empty, so however many notifications are pushed
+ * before the reactor gets to them, it is woken up once.
+ *
+ * The nodes are allocated ACE_REACTOR_NOTIFICATION_ARRAY_SIZE at a
+ * time at first, then twice as many each time the free list runs
+ * out, and are only released by reset(), which may not be called
+ * while other threads use the queue.  Growing the queue takes a lock,
+ * so that the threads that find the free list empty at the same time
+ * allocate one array between them.
+ */
+class ACE_Export ACE_Notification_Queue_Lock_Free : private ACE_Copy_Disabled
+{
+public:
+  ACE_Notification_Queue_Lock_Free();
+  ~ACE_Notification_Queue_Lock_Free();
+
+  /**
+   * @brief Pre-allocate resources in the queue
+   */
+  int open();
+
+  /**
+   * @brief Release all resources in the queue
+   */
+  void reset();
+
+  /**
+   * @brief Remove all elements in the queue matching @c eh and @c mask
+   */
+  int purge_pending_notifications(ACE_Event_Handler * eh,
+                                  ACE_Reactor_Mask mask);
+
+  /**
+   * @brief Add a new notification to the queue
+   *
+   * @return -1 on failure, 1 if the queue was empty and 0 otherwise.
+   */
+  int push_new_notification(ACE_Notification_Buffer const & buffer);
+
+  /**
+   * @brief Extract the next notification from the queue
+   *
+   * @return -1 on failure, 1 if a message was popped, 0 otherwise
+   */
+  int pop_next_notification(
+      ACE_Notification_Buffer & current,
+      bool & more_messages_queued,
+      ACE_Notification_Buffer & next);
+
+  /// Number of nodes allocated.
+  size_t capacity() const;
+
+private:
+  /// A notification, in the pending stack, the queue of the consumer
+  /// or the free list.
+  class Node : public ACE_Notification_Queue_Node
+  {
+  public:
+    /// Next node down the pending stack.
+    Node * pending_next_;
+
+    /// Index plus one of the next node in the free list, 0 for none.
+    std::atomic<ACE_UINT32> free_next_;
+
+    /// Index of the node among all the nodes allocated.
+    ACE_UINT32 index_;
+  };
+
+  /// Return the node at @c index.
+  Node * node(ACE_UINT32 index) const;
+
+  /// Take a node from the free list, or allocate more if it is still
+  /// empty once @c grow_lock_ is held.
+  Node * allocate_node();
+
+  /// Allocate another array of nodes, put all but one of them in
+  /// the free list and return that one.  The caller holds
+  /// @c grow_lock_, or is the only thread using the queue.
+  Node * allocate_more_buffers();
+
+  /// Put the nodes from @c first to @c last, linked by their
+  /// @c free_next_, in the free list.
+  void free_nodes(Node * first, Node * last);
+
+  /// Move the pending notifications to the end of @c notify_queue_.
+  void take_pending();
+
+private:
+  enum
+  {
+    /// At most this many arrays of nodes, each twice as big as the
+    /// previous one.
+    MAX_ARRAYS = 32
+  };
+
+  /// The arrays of nodes allocated.
+  std::atomic<Node *> arrays_[MAX_ARRAYS];
+
+  /// Number of arrays allocated, or being allocated.
+  std::atomic<unsigned int> array_count_;
+
+  /// Head of the free list: the index plus one of its first node in
+  /// the lower 32 bits, 0 when it is empty, and a count of the
+  /// changes in the upper 32 bits, so that taking a node does not
+  /// succeed if it was taken and put back in the meantime.
+  std::atomic<ACE_UINT64> free_;
+
+  /// Notifications pushed and not yet taken by the consumer, the
+  /// last one first.
+  std::atomic<Node *> pending_;
+
+  /// Number of notifications in the queue.
+  std::atomic<size_t> size_;
+
+  typedef ACE_Intrusive_List<ACE_Notification_Queue_Node> Buffer_List;
+
+  /// Notifications taken from @c pending_, first one first.
+  Buffer_List notify_queue_;
+
+  /// Serializes the consumers, i.e., pop_next_notification() and
+  /// purge_pending_notifications().
+  ACE_SYNCH_MUTEX consumer_lock_;
+
+  /// Serializes the growth of the queue.
+  ACE_SYNCH_MUTEX grow_lock_;
+};
+#endif /* ACE_HAS_CPP11 */
+
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+/**
+ * @class ACE_Notification_Event
+ *
+ * @brief An eventfd to wake up the reactor thread with.
+ *
+ * Used by the reactors instead of ACE_Pipe when the notifications
+ * themselves are kept in an ACE_Notification_Queue_Lock_Free: a
+ * single handle, non-blocking and close-on-exec, that never fills up
+ * and is written eight bytes at a time.  The read and write handles
+ * are the same, as far as the code written for ACE_Pipe is concerned.
+ */
+class ACE_Export ACE_Notification_Event : private ACE_Copy_Disabled
+{
+public:
+  ACE_Notification_Event();
+  ~ACE_Notification_Event();
+
+  /// Create the eventfd.
+  int open();
+
+  /// Close the eventfd.
+  int close();
+
+  /// The eventfd, to wait for it to be signaled.
+  ACE_HANDLE read_handle() const;
+
+  /// The eventfd, again.
+  ACE_HANDLE write_handle() const;
+
+  /// Wake up the thread waiting for the eventfd.
+  int signal();
+
+  /**
+   * @brief Consume the signals sent so far
+   *
+   * @return -1 on failure, 1 if the eventfd was signaled, 0 otherwise
+   */
+  int clear();
+
+  /// Dump the state of an object.
+  void dump() const;
+
+private:
+  ACE_HANDLE handle_;
+};
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
+
 ACE_END_VERSIONED_NAMESPACE_DECL
 
 #if defined (__ACE_INLINE__)
@@ -42,5 +42,19 @@ ACE_Notification_Queue_Node::clear_mask(ACE_Reactor_Mask mask)
   ACE_CLR_BITS(contents_.mask_, mask);
 }
 
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+ACE_INLINE ACE_HANDLE
+ACE_Notification_Event::read_handle() const
+{
+  return handle_;
+}
+
+ACE_INLINE ACE_HANDLE
+ACE_Notification_Event::write_handle() const
+{
+  return handle_;
+}
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
+
 ACE_END_VERSIONED_NAMESPACE_DECL
 
@@ -597,6 +597,7 @@ class ACE_Export ACE_POSIX_Asynch_Accept_Result : public virtual ACE_Asynch_Acce
 {
   /// Factory classes will have special permissions.
   friend class ACE_POSIX_Asynch_Accept;
+  friend class ACE_Uring_Asynch_Accept;
 
   /// The Proactor constructs the Result class for faking results.
   friend class ACE_POSIX_Proactor;
@@ -765,6 +766,7 @@ class ACE_Export ACE_POSIX_Asynch_Connect_Result : public virtual ACE_Asynch_Con
 {
   /// Factory classes will have special permissions.
   friend class ACE_POSIX_Asynch_Connect;
+  friend class ACE_Uring_Asynch_Connect;
 
   /// The Proactor constructs the Result class for faking results.
   friend class ACE_POSIX_Proactor;
@@ -70,7 +70,10 @@ public:
     PROACTOR_SUN    = 3,
 
     /// Callback notifications
-    PROACTOR_CB     = 4
+    PROACTOR_CB     = 4,
+
+    /// Linux io_uring submission/completion rings
+    PROACTOR_URING  = 5
   };
 
 
@@ -95,7 +98,11 @@ public:
 
   enum Opcode {
     ACE_OPCODE_READ = 1,
-    ACE_OPCODE_WRITE = 2
+    ACE_OPCODE_WRITE = 2,
+    /// Only started by proactors that accept/connect natively
+    /// (see ACE_Uring_Proactor).
+    ACE_OPCODE_ACCEPT = 3,
+    ACE_OPCODE_CONNECT = 4
   };
 
   virtual Proactor_Type  get_impl_type (void);
@@ -0,0 +1,192 @@
+// $Id$
+
+#include "ace/Reactor_Instrumentation.h"
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+
+#include "ace/Guard_T.h"
+#include "ace/Log_Category.h"
+#include "ace/OS_NS_stdio.h"
+
+#if !defined (__ACE_INLINE__)
+#include "ace/Reactor_Instrumentation.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+namespace
+{
+  const char *const upcall_names[ACE_Reactor_Instrumentation::UPCALL_TYPES] =
+    {
+      "Input",
+      "Output",
+      "Exception",
+      "Timeout",
+      "Notify"
+    };
+}
+
+ACE_Reactor_Instrumentation::ACE_Reactor_Instrumentation (
+    const char *name,
+    const ACE_Time_Value &update_interval)
+  : name_ (name),
+    update_interval_ (update_interval),
+    scale_factor_ (ACE_High_Res_Timer::global_scale_factor ()),
+    wait_time_ (0),
+    timer_lateness_ (0),
+    notify_queue_depth_ (0),
+    slow_upcalls_ (0),
+    notify_pending_ (0),
+    slow_threshold_usec_ (0)
+{
+  this->wait_time_ =
+    this->add_monitor<ACE::Monitor_Control::Histogram_Monitor> ("/WaitTime");
+
+  for (int i = 0; i < UPCALL_TYPES; ++i)
+    {
+      ACE_CString suffix ("/Upcall/");
+      suffix += upcall_names[i];
+      this->upcall_time_[i] =
+        this->add_monitor<ACE::Monitor_Control::Histogram_Monitor> (
+          suffix.c_str ());
+    }
+
+  this->timer_lateness_ =
+    this->add_monitor<ACE::Monitor_Control::Histogram_Monitor> (
+      "/TimerLateness");
+  this->notify_queue_depth_ =
+    this->add_monitor<ACE::Monitor_Control::Size_Monitor> (
+      "/NotifyQueueDepth");
+
+  ACE_CString slow_name (this->name_ + "/SlowUpcalls");
+  ACE_NEW (this->slow_upcalls_,
+           ACE::Monitor_Control::Monitor_Base (
+             slow_name.c_str (),
+             ACE::Monitor_Control::Monitor_Control_Types::MC_LIST));
+  this->slow_upcalls_->add_to_registry (this->update_interval_);
+}
+
+ACE_Reactor_Instrumentation::~ACE_Reactor_Instrumentation (void)
+{
+  ACE::Monitor_Control::Monitor_Base *monitors[UPCALL_TYPES + 4] =
+    {
+      this->wait_time_,
+      this->timer_lateness_,
+      this->notify_queue_depth_,
+      this->slow_upcalls_
+    };
+  for (int i = 0; i < UPCALL_TYPES; ++i)
+    monitors[4 + i] = this->upcall_time_[i];
+
+  for (size_t i = 0; i < sizeof monitors / sizeof monitors[0]; ++i)
+    {
+      if (monitors[i] != 0)
+        {
+          monitors[i]->remove_from_registry ();
+          monitors[i]->remove_ref ();
+        }
+    }
+}
+
+template <class MONITOR> MONITOR *
+ACE_Reactor_Instrumentation::add_monitor (const char *suffix)
+{
+  ACE_CString name (this->name_ + suffix);
+  MONITOR *monitor = 0;
+  ACE_NEW_RETURN (monitor,
+                  MONITOR (name.c_str ()),
+                  0);
+  monitor->add_to_registry (this->update_interval_);
+  return monitor;
+}
+
+void
+ACE_Reactor_Instrumentation::slow_upcall_threshold (
+  const ACE_Time_Value &threshold)
+{
+  ACE_UINT64 usec = 0;
+  threshold.to_usec (usec);
+  this->slow_threshold_usec_ = usec;
+}
+
+ACE_Time_Value
+ACE_Reactor_Instrumentation::slow_upcall_threshold (void) const
+{
+  return ACE_Time_Value (
+    static_cast<time_t> (this->slow_threshold_usec_ / ACE_ONE_SECOND_IN_USECS),
+    static_cast<suseconds_t> (this->slow_threshold_usec_
+                              % ACE_ONE_SECOND_IN_USECS));
+}
+
+ACE_Reactor_Instrumentation::Upcall
+ACE_Reactor_Instrumentation::upcall_type (ACE_Reactor_Mask mask)
+{
+  if (ACE_BIT_ENABLED (mask, ACE_Event_Handler::WRITE_MASK)
+      || ACE_BIT_ENABLED (mask, ACE_Event_Handler::CONNECT_MASK))
+    return OUTPUT;
+
+  if (ACE_BIT_ENABLED (mask, ACE_Event_Handler::EXCEPT_MASK))
+    return EXCEPTION;
+
+  return INPUT;
+}
+
+void
+ACE_Reactor_Instrumentation::slow_upcall (Upcall upcall,
+                                          ACE_UINT64 usec,
+                                          const char *handler_type,
+                                          ACE_HANDLE handle)
+{
+  char buf[256];
+  ACE_OS::snprintf (buf,
+                    sizeof buf,
+                    "%s %s handle %ld: " ACE_UINT64_FORMAT_SPECIFIER_ASCII
+                    " usec",
+                    upcall_names[upcall],
+                    handler_type == 0 ? "(none)" : handler_type,
+                    (long) handle,
+                    usec);
+
+  ACE_GUARD (ACE_SYNCH_MUTEX, guard, this->slow_lock_);
+
+  if (this->slow_list_.size () >= SLOW_UPCALLS)
+    {
+      // Drop the oldest one.
+      for (size_t i = 1; i < this->slow_list_.size (); ++i)
+        this->slow_list_[i - 1] = this->slow_list_[i];
+      this->slow_list_[this->slow_list_.size () - 1] = buf;
+    }
+  else
+    this->slow_list_.push_back (buf);
+
+  this->slow_upcalls_->receive (this->slow_list_);
+}
+
+void
+ACE_Reactor_Instrumentation::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Reactor_Instrumentation::dump");
+
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("name_ = %C\n"),
+                 this->name_.c_str ()));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("notify_pending_ = %d\n"),
+                 this->notify_pending_.value ()));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("wait samples = %u\n"),
+                 this->wait_time_->samples ()));
+  for (int i = 0; i < UPCALL_TYPES; ++i)
+    ACELIB_DEBUG ((LM_DEBUG,
+                   ACE_TEXT ("%C upcalls = %u\n"),
+                   upcall_names[i],
+                   this->upcall_time_[i]->samples ()));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
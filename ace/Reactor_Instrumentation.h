@@ -0,0 +1,191 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Reactor_Instrumentation.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+#ifndef ACE_REACTOR_INSTRUMENTATION_H
+#define ACE_REACTOR_INSTRUMENTATION_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/ACE_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+
+#include "ace/Copy_Disabled.h"
+#include "ace/Event_Handler.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/Monitor_Histogram.h"
+#include "ace/Monitor_Size.h"
+#include "ace/Thread_Mutex.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Reactor_Instrumentation
+ *
+ * @brief Monitor points measuring where a reactor spends its time.
+ *
+ * An instance given to ACE_Select_Reactor, ACE_TP_Reactor or
+ * ACE_Dev_Poll_Reactor with their instrumentation() method records,
+ * in microseconds:
+ *
+ * - @c name/WaitTime: time spent in the event demultiplexer;
+ * - @c name/Upcall/Input, @c Output, @c Exception, @c Timeout and
+ *   @c Notify: time spent in the upcalls of each type (ACE_Select_Reactor
+ *   times all the timers expiring at once as a single upcall);
+ * - @c name/TimerLateness: how late the earliest expired timer is
+ *   when the reactor gets to it.
+ *
+ * These are ACE::Monitor_Control::Histogram_Monitor points, which
+ * only publish their counts when they are updated.  In addition,
+ * @c name/NotifyQueueDepth samples the number of notifications
+ * pending each time one is dequeued, and @c name/SlowUpcalls lists the
+ * last upcalls that took longer than slow_upcall_threshold(), with
+ * the type of their handler.
+ *
+ * All the monitor points are added to the registry, with
+ * @a update_interval if it is not zero, so they can be looked up by
+ * name through Monitor_Admin.
+ *
+ * The reactors only look at the instrumentation when ACE is built
+ * with ACE_HAS_MONITOR_POINTS, and then only when an instance was
+ * given to them, so it costs nothing otherwise.  It must be given
+ * before the event loop is run and outlive the reactor.
+ */
+class ACE_Export ACE_Reactor_Instrumentation : private ACE_Copy_Disabled
+{
+public:
+  /// Upcall types timed separately.
+  enum Upcall
+  {
+    INPUT,
+    OUTPUT,
+    EXCEPTION,
+    TIMEOUT,
+    NOTIFY,
+    UPCALL_TYPES
+  };
+
+  /// Number of slow upcalls listed by @c name/SlowUpcalls.
+  enum
+  {
+    SLOW_UPCALLS = 16
+  };
+
+  ACE_Reactor_Instrumentation (
+    const char *name = "Reactor",
+    const ACE_Time_Value &update_interval = ACE_Time_Value::zero);
+  ~ACE_Reactor_Instrumentation (void);
+
+  /// Prefix of the names of the monitor points.
+  const char *name (void) const;
+
+  /// Upcalls taking at least @a threshold are listed by
+  /// @c name/SlowUpcalls; none are if it is zero, the default.
+  void slow_upcall_threshold (const ACE_Time_Value &threshold);
+  ACE_Time_Value slow_upcall_threshold (void) const;
+
+  /// Upcall type of the handle_* method called for @a mask.
+  static Upcall upcall_type (ACE_Reactor_Mask mask);
+
+  /// @name Recording, called by the reactors.
+  //@{
+  /// Current time, to be passed to the other methods.
+  ACE_hrtime_t start (void) const;
+
+  /// The reactor waited for events since @a start.
+  void waited (ACE_hrtime_t start);
+
+  /// The type of @a eh to list the upcall under if it is slow, or 0
+  /// if slow upcalls are not listed.  Taken before the upcall, which
+  /// may delete @a eh.
+  const char *handler_type (ACE_Event_Handler *eh) const;
+
+  /// An upcall of type @a upcall to a handler of type @a handler_type,
+  /// for @a handle, took from @a start until now.
+  void upcall (Upcall upcall,
+               ACE_hrtime_t start,
+               const char *handler_type = 0,
+               ACE_HANDLE handle = ACE_INVALID_HANDLE);
+
+  /// A timer due at @a expiry is dispatched at @a now.
+  void timer_expired (const ACE_Time_Value &expiry,
+                      const ACE_Time_Value &now);
+
+  /// A notification was queued.
+  void notify_queued (void);
+
+  /// @a count notifications were dequeued, or purged.
+  void notify_dequeued (size_t count = 1);
+  //@}
+
+  /// @name Monitor points.
+  //@{
+  ACE::Monitor_Control::Histogram_Monitor *wait_time (void) const;
+  ACE::Monitor_Control::Histogram_Monitor *upcall_time (Upcall upcall) const;
+  ACE::Monitor_Control::Histogram_Monitor *timer_lateness (void) const;
+  ACE::Monitor_Control::Size_Monitor *notify_queue_depth (void) const;
+  ACE::Monitor_Control::Monitor_Base *slow_upcalls (void) const;
+  //@}
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+private:
+  /// Microseconds from @a start until now.
+  ACE_UINT64 elapsed_usec (ACE_hrtime_t start) const;
+
+  /// Add @a upcall to the slow upcalls.
+  void slow_upcall (Upcall upcall,
+                    ACE_UINT64 usec,
+                    const char *handler_type,
+                    ACE_HANDLE handle);
+
+  /// Create the monitor point named by our name and @a suffix and
+  /// add it to the registry.
+  template <class MONITOR> MONITOR *add_monitor (const char *suffix);
+
+  ACE_CString name_;
+  ACE_Time_Value update_interval_;
+
+  /// Ticks of the high resolution timer per microsecond.
+  ACE_High_Res_Timer::global_scale_factor_type scale_factor_;
+
+  ACE::Monitor_Control::Histogram_Monitor *wait_time_;
+  ACE::Monitor_Control::Histogram_Monitor *upcall_time_[UPCALL_TYPES];
+  ACE::Monitor_Control::Histogram_Monitor *timer_lateness_;
+  ACE::Monitor_Control::Size_Monitor *notify_queue_depth_;
+  ACE::Monitor_Control::Monitor_Base *slow_upcalls_;
+
+  /// Notifications queued and not dequeued yet.
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> notify_pending_;
+
+  /// Slow upcall threshold in microseconds, 0 if none.
+  ACE_UINT64 slow_threshold_usec_;
+
+  /// The last slow upcalls, the oldest first.
+  ACE::Monitor_Control::Monitor_Control_Types::NameList slow_list_;
+  ACE_SYNCH_MUTEX slow_lock_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/Reactor_Instrumentation.inl"
+#endif /* __ACE_INLINE__ */
+
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_REACTOR_INSTRUMENTATION_H */
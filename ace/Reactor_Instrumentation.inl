@@ -0,0 +1,125 @@
+// -*- C++ -*-
+//
+// $Id$
+
+#include "ace/OS_NS_time.h"
+
+#include <typeinfo>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE const char *
+ACE_Reactor_Instrumentation::name (void) const
+{
+  return this->name_.c_str ();
+}
+
+ACE_INLINE ACE_hrtime_t
+ACE_Reactor_Instrumentation::start (void) const
+{
+  return ACE_OS::gethrtime ();
+}
+
+ACE_INLINE ACE_UINT64
+ACE_Reactor_Instrumentation::elapsed_usec (ACE_hrtime_t start) const
+{
+  ACE_hrtime_t const now = ACE_OS::gethrtime ();
+  if (now <= start || this->scale_factor_ == 0)
+    return 0;
+
+#if defined (ACE_WIN32)
+  return ((now - start) * ACE_HR_SCALE_CONVERSION) / this->scale_factor_;
+#else
+  return (now - start) / this->scale_factor_;
+#endif /* ACE_WIN32 */
+}
+
+ACE_INLINE void
+ACE_Reactor_Instrumentation::waited (ACE_hrtime_t start)
+{
+  this->wait_time_->record (this->elapsed_usec (start));
+}
+
+ACE_INLINE const char *
+ACE_Reactor_Instrumentation::handler_type (ACE_Event_Handler *eh) const
+{
+  if (this->slow_threshold_usec_ == 0 || eh == 0)
+    return 0;
+  return typeid (*eh).name ();
+}
+
+ACE_INLINE void
+ACE_Reactor_Instrumentation::upcall (Upcall upcall,
+                                     ACE_hrtime_t start,
+                                     const char *handler_type,
+                                     ACE_HANDLE handle)
+{
+  ACE_UINT64 const usec = this->elapsed_usec (start);
+  this->upcall_time_[upcall]->record (usec);
+
+  if (this->slow_threshold_usec_ != 0 && usec >= this->slow_threshold_usec_)
+    this->slow_upcall (upcall, usec, handler_type, handle);
+}
+
+ACE_INLINE void
+ACE_Reactor_Instrumentation::timer_expired (const ACE_Time_Value &expiry,
+                                            const ACE_Time_Value &now)
+{
+  if (now > expiry)
+    {
+      ACE_UINT64 usec = 0;
+      (now - expiry).to_usec (usec);
+      this->timer_lateness_->record (usec);
+    }
+  else
+    this->timer_lateness_->record (0);
+}
+
+ACE_INLINE void
+ACE_Reactor_Instrumentation::notify_queued (void)
+{
+  ++this->notify_pending_;
+}
+
+ACE_INLINE void
+ACE_Reactor_Instrumentation::notify_dequeued (size_t count)
+{
+  long const pending = (this->notify_pending_ -= static_cast<long> (count));
+
+  // A notification may be dequeued before the thread which queued it
+  // gets to count it.
+  this->notify_queue_depth_->receive (
+    pending < 0 ? 0 : static_cast<size_t> (pending));
+}
+
+ACE_INLINE ACE::Monitor_Control::Histogram_Monitor *
+ACE_Reactor_Instrumentation::wait_time (void) const
+{
+  return this->wait_time_;
+}
+
+ACE_INLINE ACE::Monitor_Control::Histogram_Monitor *
+ACE_Reactor_Instrumentation::upcall_time (Upcall upcall) const
+{
+  return upcall < UPCALL_TYPES ? this->upcall_time_[upcall] : 0;
+}
+
+ACE_INLINE ACE::Monitor_Control::Histogram_Monitor *
+ACE_Reactor_Instrumentation::timer_lateness (void) const
+{
+  return this->timer_lateness_;
+}
+
+ACE_INLINE ACE::Monitor_Control::Size_Monitor *
+ACE_Reactor_Instrumentation::notify_queue_depth (void) const
+{
+  return this->notify_queue_depth_;
+}
+
+ACE_INLINE ACE::Monitor_Control::Monitor_Base *
+ACE_Reactor_Instrumentation::slow_upcalls (void) const
+{
+  return this->slow_upcalls_;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
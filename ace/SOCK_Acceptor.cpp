@@ -365,7 +365,8 @@ ACE_SOCK_Acceptor::open (const ACE_Addr &local_sap,
                          int reuse_addr,
                          int protocol_family,
                          int backlog,
-                         int protocol)
+                         int protocol,
+                         int reuse_port)
 {
   ACE_TRACE ("ACE_SOCK_Acceptor::open");
 
@@ -385,10 +386,31 @@ ACE_SOCK_Acceptor::open (const ACE_Addr &local_sap,
                       protocol,
                       reuse_addr) == -1)
     return -1;
-  else
-    return this->shared_open (local_sap,
-                              protocol_family,
-                              backlog);
+
+  // SO_REUSEPORT has to be in place before the bind in shared_open().
+  if (reuse_port)
+    {
+#if defined (SO_REUSEPORT)
+      int one = 1;
+      if (ACE_OS::setsockopt (this->get_handle (),
+                              SOL_SOCKET,
+                              SO_REUSEPORT,
+                              (const char*) &one,
+                              sizeof one) == -1)
+        {
+          ACE_Errno_Guard g (errno);
+          this->close ();
+          return -1;
+        }
+#else
+      this->close ();
+      ACE_NOTSUP_RETURN (-1);
+#endif /* SO_REUSEPORT */
+    }
+
+  return this->shared_open (local_sap,
+                            protocol_family,
+                            backlog);
 }
 
 // General purpose routine for performing server ACE_SOCK creation.
@@ -397,14 +419,16 @@ ACE_SOCK_Acceptor::ACE_SOCK_Acceptor (const ACE_Addr &local_sap,
                                       int reuse_addr,
                                       int protocol_family,
                                       int backlog,
-                                      int protocol)
+                                      int protocol,
+                                      int reuse_port)
 {
   ACE_TRACE ("ACE_SOCK_Acceptor::ACE_SOCK_Acceptor");
   if (this->open (local_sap,
                   reuse_addr,
                   protocol_family,
                   backlog,
-                  protocol) == -1)
+                  protocol,
+                  reuse_port) == -1)
     ACELIB_ERROR ((LM_ERROR,
                 ACE_TEXT ("%p\n"),
                 ACE_TEXT ("ACE_SOCK_Acceptor")));
@@ -47,13 +47,17 @@ public:
    * Initialize a passive-mode BSD-style acceptor socket (no QoS).
    * @a local_sap is the address that we're going to listen for
    * connections on.  If @a reuse_addr is 1 then we'll use the
-   * @c SO_REUSEADDR to reuse this address.
+   * @c SO_REUSEADDR to reuse this address.  If @a reuse_port is 1
+   * then we'll use @c SO_REUSEPORT so that several acceptors (e.g.,
+   * one per ACE_Sharded_Reactor shard) may listen on the same address
+   * and have the kernel balance incoming connections among them.
    */
   ACE_SOCK_Acceptor (const ACE_Addr &local_sap,
                      int reuse_addr = 0,
                      int protocol_family = PF_UNSPEC,
                      int backlog = ACE_DEFAULT_BACKLOG,
-                     int protocol = 0);
+                     int protocol = 0,
+                     int reuse_port = 0);
 
   /// Initialize a passive-mode QoS-enabled acceptor socket.  Returns 0
   /// on success and -1 on failure.
@@ -70,14 +74,17 @@ public:
    * Initialize a passive-mode BSD-style acceptor socket (no QoS).
    * @a local_sap is the address that we're going to listen for
    * connections on.  If @a reuse_addr is 1 then we'll use the
-   * @c SO_REUSEADDR to reuse this address.  Returns 0 on success and
-   * -1 on failure.
+   * @c SO_REUSEADDR to reuse this address.  If @a reuse_port is 1
+   * then we'll use @c SO_REUSEPORT to let other acceptors bind the
+   * same address; fails with @c ENOTSUP where that option is not
+   * available.  Returns 0 on success and -1 on failure.
    */
   int open (const ACE_Addr &local_sap,
             int reuse_addr = 0,
             int protocol_family = PF_UNSPEC,
             int backlog = ACE_DEFAULT_BACKLOG,
-            int protocol = 0);
+            int protocol = 0,
+            int reuse_port = 0);
 
   /// Initialize a passive-mode QoS-enabled acceptor socket.  Returns 0
   /// on success and -1 on failure.
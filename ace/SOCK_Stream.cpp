@@ -1,6 +1,7 @@
 // $Id$
 
 #include "ace/SOCK_Stream.h"
+#include "ace/Message_Block.h"
 
 #if !defined (__ACE_INLINE__)
 #include "ace/SOCK_Stream.inl"
@@ -37,4 +38,54 @@ ACE_SOCK_Stream::close (void)
   return ACE_SOCK::close ();
 }
 
+ssize_t
+ACE_SOCK_Stream::send_chain (ACE_Message_Block *&chain,
+                             const ACE_Time_Value *timeout) const
+{
+  ACE_TRACE ("ACE_SOCK_Stream::send_chain");
+
+  iovec iov[ACE_IOV_MAX];
+  int iovcnt = 0;
+
+  for (const ACE_Message_Block *mb = chain;
+       mb != 0 && iovcnt < ACE_IOV_MAX;
+       mb = mb->cont ())
+    if (mb->length () > 0)
+      {
+        iov[iovcnt].iov_base = mb->rd_ptr ();
+        iov[iovcnt].iov_len =
+          ACE_Utils::truncate_cast<u_long> (mb->length ());
+        ++iovcnt;
+      }
+
+  ssize_t const result =
+    iovcnt == 0 ? 0 : ACE::sendv (this->get_handle (), iov, iovcnt, timeout);
+  if (result == -1)
+    return -1;
+
+  // Consume what was sent, releasing the blocks that are done with.
+  size_t left = static_cast<size_t> (result);
+  while (chain != 0)
+    {
+      size_t const length = chain->length ();
+      if (length > left)
+        {
+          chain->rd_ptr (left);
+          break;
+        }
+
+      left -= length;
+      ACE_Message_Block *const done = chain;
+      chain = chain->cont ();
+      done->cont (0);
+      done->release ();
+
+      // Stop after the last block sent unless empty blocks follow it.
+      if (left == 0 && chain != 0 && chain->length () > 0)
+        break;
+    }
+
+  return result;
+}
+
 ACE_END_VERSIONED_NAMESPACE_DECL
@@ -144,6 +144,27 @@ public:
 
   //@}
 
+  /**
+   * Send as much as possible of the @a chain of message blocks linked
+   * through their @c cont pointers with a single gather-write, without
+   * copying the data.  The read pointers of the blocks are advanced
+   * past the data that was sent, the blocks that went out completely
+   * are released and @a chain is set to the first block with data
+   * left, or 0 once the whole chain has been sent.  After a partial
+   * write, e.g., when a non-blocking socket is full, call again with
+   * the same @a chain to resume.
+   *
+   * At most ACE_IOV_MAX blocks are sent per call.  The @c next
+   * pointers of the blocks are ignored.  @a timeout has the same
+   * meaning as for ACE::sendv().
+   *
+   * @retval  the number of bytes sent, 0 if @a chain had no data.
+   * @retval  -1 an error occurred and nothing was sent.  If the
+   *          @a timeout period is reached, errno is ETIME.
+   */
+  ssize_t send_chain (ACE_Message_Block *&chain,
+                      const ACE_Time_Value *timeout = 0) const;
+
   // = Send/receive ``urgent'' data (see TCP specs...).
   ssize_t send_urg (const void *ptr,
                     size_t len = sizeof (char),
@@ -0,0 +1,283 @@
+// $Id$
+
+#include "ace/SOCK_Zerocopy_Sender.h"
+#include "ace/SOCK_Stream.h"
+#include "ace/Message_Block.h"
+#include "ace/Log_Category.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_sys_socket.h"
+#include "ace/os_include/netinet/os_in.h"
+
+#if defined (ACE_LINUX) && defined (SO_ZEROCOPY) && defined (MSG_ZEROCOPY)
+# include <linux/errqueue.h>
+# define ACE_HAS_SOCK_ZEROCOPY
+#endif /* ACE_LINUX && SO_ZEROCOPY && MSG_ZEROCOPY */
+
+#if !defined (__ACE_INLINE__)
+#include "ace/SOCK_Zerocopy_Sender.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_SOCK_Zerocopy_Sender)
+
+ACE_SOCK_Zerocopy_Sender::ACE_SOCK_Zerocopy_Sender (void)
+  : handle_ (ACE_INVALID_HANDLE),
+    next_sequence_ (0),
+    copied_ (0)
+{
+}
+
+ACE_SOCK_Zerocopy_Sender::~ACE_SOCK_Zerocopy_Sender (void)
+{
+  this->close ();
+}
+
+int
+ACE_SOCK_Zerocopy_Sender::open (const ACE_SOCK_Stream &stream)
+{
+  ACE_TRACE ("ACE_SOCK_Zerocopy_Sender::open");
+
+#if defined (ACE_HAS_SOCK_ZEROCOPY)
+  int one = 1;
+  if (ACE_OS::setsockopt (stream.get_handle (),
+                          SOL_SOCKET,
+                          SO_ZEROCOPY,
+                          (const char*) &one,
+                          sizeof one) == -1)
+    return -1;
+
+  this->close ();
+  this->handle_ = stream.get_handle ();
+  this->next_sequence_ = 0;
+  this->copied_ = 0;
+  return 0;
+#else
+  ACE_UNUSED_ARG (stream);
+  ACE_NOTSUP_RETURN (-1);
+#endif /* ACE_HAS_SOCK_ZEROCOPY */
+}
+
+int
+ACE_SOCK_Zerocopy_Sender::close (void)
+{
+  ACE_TRACE ("ACE_SOCK_Zerocopy_Sender::close");
+
+  Pending_Send send;
+  while (this->pending_.dequeue_head (send) == 0)
+    send.blocks_->release ();
+  this->handle_ = ACE_INVALID_HANDLE;
+  return 0;
+}
+
+ssize_t
+ACE_SOCK_Zerocopy_Sender::send_chain (ACE_Message_Block *&chain,
+                                      const ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_SOCK_Zerocopy_Sender::send_chain");
+
+#if defined (ACE_HAS_SOCK_ZEROCOPY)
+  iovec iov[ACE_IOV_MAX];
+  int iovcnt = 0;
+
+  for (const ACE_Message_Block *mb = chain;
+       mb != 0 && iovcnt < ACE_IOV_MAX;
+       mb = mb->cont ())
+    if (mb->length () > 0)
+      {
+        iov[iovcnt].iov_base = mb->rd_ptr ();
+        iov[iovcnt].iov_len = mb->length ();
+        ++iovcnt;
+      }
+
+  if (iovcnt == 0)
+    {
+      if (chain != 0)
+        chain->release ();
+      chain = 0;
+      return 0;
+    }
+
+  msghdr msg;
+  ACE_OS::memset (&msg, 0, sizeof msg);
+  msg.msg_iov = iov;
+  msg.msg_iovlen = iovcnt;
+
+  ssize_t result;
+  if (timeout == 0)
+    result = ACE_OS::sendmsg (this->handle_, &msg, MSG_ZEROCOPY);
+  else
+    {
+      int val = 0;
+      if (ACE::enter_send_timedwait (this->handle_, timeout, val) == -1)
+        return -1;
+      result = ACE_OS::sendmsg (this->handle_, &msg, MSG_ZEROCOPY);
+      ACE::restore_non_blocking_mode (this->handle_, val);
+    }
+  if (result <= 0)
+    return result;
+
+  // Move what was sent to a new pending send.  The kernel keeps
+  // reading a partially sent block, so it is duplicated.
+  ACE_Message_Block *sent = 0;
+  ACE_Message_Block *last = 0;
+  size_t left = static_cast<size_t> (result);
+  while (chain != 0)
+    {
+      size_t const length = chain->length ();
+      ACE_Message_Block *done = 0;
+      if (length > left)
+        {
+          if (left > 0)
+            {
+              ACE_Message_Block *const rest = chain->cont ();
+              chain->cont (0);
+              done = chain->duplicate ();
+              chain->cont (rest);
+              chain->rd_ptr (left);
+              left = 0;
+            }
+        }
+      else
+        {
+          left -= length;
+          done = chain;
+          chain = chain->cont ();
+          done->cont (0);
+        }
+
+      if (done == 0)
+        break;
+      if (last == 0)
+        sent = done;
+      else
+        last->cont (done);
+      last = done;
+
+      if (left == 0 && chain != 0 && chain->length () > 0)
+        break;
+    }
+
+  Pending_Send send;
+  send.sequence_ = this->next_sequence_++;
+  send.done_ = false;
+  send.blocks_ = sent;
+  if (this->pending_.enqueue_tail (send) == -1)
+    {
+      // Better leak the blocks than have the kernel read freed memory.
+      ACELIB_ERROR ((LM_ERROR,
+                     ACE_TEXT ("ACE_SOCK_Zerocopy_Sender::send_chain: %p\n"),
+                     ACE_TEXT ("enqueue_tail")));
+    }
+  return result;
+#else
+  ACE_UNUSED_ARG (chain);
+  ACE_UNUSED_ARG (timeout);
+  ACE_NOTSUP_RETURN (-1);
+#endif /* ACE_HAS_SOCK_ZEROCOPY */
+}
+
+int
+ACE_SOCK_Zerocopy_Sender::handle_completions (void)
+{
+  ACE_TRACE ("ACE_SOCK_Zerocopy_Sender::handle_completions");
+
+#if defined (ACE_HAS_SOCK_ZEROCOPY)
+  int completed = 0;
+
+  for (;;)
+    {
+      union
+      {
+        cmsghdr align_;
+        char buffer_[CMSG_SPACE (sizeof (sock_extended_err)
+                                 + sizeof (sockaddr_in6))];
+      } control;
+
+      msghdr msg;
+      ACE_OS::memset (&msg, 0, sizeof msg);
+      msg.msg_control = &control;
+      msg.msg_controllen = sizeof control;
+
+      // Reading the error queue never blocks.
+      if (ACE_OS::recvmsg (this->handle_, &msg, MSG_ERRQUEUE) == -1)
+        {
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+          return -1;
+        }
+
+      for (cmsghdr *cmsg = CMSG_FIRSTHDR (&msg);
+           cmsg != 0;
+           cmsg = CMSG_NXTHDR (&msg, cmsg))
+        {
+          if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+              && !(cmsg->cmsg_level == SOL_IPV6
+                   && cmsg->cmsg_type == IPV6_RECVERR))
+            continue;
+
+          sock_extended_err err;
+          ACE_OS::memcpy (&err, CMSG_DATA (cmsg), sizeof err);
+          if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0)
+            continue;
+
+          // The completion covers the sends from ee_info to ee_data.
+          ACE_UINT32 const count = err.ee_data - err.ee_info + 1;
+          if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+            this->copied_ += count;
+          completed += static_cast<int> (count);
+          this->complete (err.ee_info, err.ee_data);
+        }
+    }
+
+  this->release_done ();
+  return completed;
+#else
+  ACE_NOTSUP_RETURN (-1);
+#endif /* ACE_HAS_SOCK_ZEROCOPY */
+}
+
+void
+ACE_SOCK_Zerocopy_Sender::complete (ACE_UINT32 first, ACE_UINT32 last)
+{
+  // Sequence numbers wrap around, hence the unsigned arithmetic.
+  ACE_UINT32 const span = last - first;
+  ACE_Unbounded_Queue_Iterator<Pending_Send> iter (this->pending_);
+  for (Pending_Send *send = 0; iter.next (send) != 0; iter.advance ())
+    if (send->sequence_ - first <= span)
+      send->done_ = true;
+}
+
+void
+ACE_SOCK_Zerocopy_Sender::release_done (void)
+{
+  // Completions normally arrive in order; one that overtakes an
+  // earlier send is kept until that send completes too.
+  Pending_Send *send = 0;
+  while (this->pending_.get (send) == 0 && send->done_)
+    {
+      ACE_Message_Block *const blocks = send->blocks_;
+      Pending_Send dummy;
+      this->pending_.dequeue_head (dummy);
+      blocks->release ();
+    }
+}
+
+void
+ACE_SOCK_Zerocopy_Sender::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_SOCK_Zerocopy_Sender::dump");
+
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("handle_ = %d\n"), this->handle_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("next_sequence_ = %u\n"),
+                 this->next_sequence_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("pending_ = %B\n"), this->pending_.size ()));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("copied_ = %B\n"), this->copied_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -0,0 +1,158 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    SOCK_Zerocopy_Sender.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+#ifndef ACE_SOCK_ZEROCOPY_SENDER_H
+#define ACE_SOCK_ZEROCOPY_SENDER_H
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/ACE_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Unbounded_Queue.h"
+#include "ace/Basic_Types.h"
+#include "ace/os_include/os_stddef.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// Forward declarations.
+class ACE_Message_Block;
+class ACE_SOCK_Stream;
+class ACE_Time_Value;
+
+/**
+ * @class ACE_SOCK_Zerocopy_Sender
+ *
+ * @brief Sends message block chains on a connected socket with the
+ * Linux @c MSG_ZEROCOPY option.
+ *
+ * Like ACE_SOCK_Stream::send_chain(), but the kernel transmits the data
+ * straight out of the message blocks instead of copying it to the
+ * socket buffer.  The blocks that were sent are therefore not released
+ * by send_chain(): they are kept until the kernel reports on the error
+ * queue of the socket that it is done with them, and released by
+ * handle_completions().  The socket reports its readiness for
+ * exceptions (@c POLLERR) when completions are waiting, so an event
+ * handler can call handle_completions() from handle_exception(), or
+ * simply after each send.
+ *
+ * Zero-copy pays off for large sends only; the kernel still copies the
+ * data when it cannot do otherwise, e.g., on the loopback interface,
+ * which copied() keeps track of.  When too many sends are pending
+ * send_chain() fails with @c ENOBUFS until some have completed.
+ *
+ * On platforms without @c MSG_ZEROCOPY, open() fails with @c ENOTSUP.
+ */
+class ACE_Export ACE_SOCK_Zerocopy_Sender
+{
+public:
+  /// Constructor.
+  ACE_SOCK_Zerocopy_Sender (void);
+
+  /// Destructor.  Calls close().
+  ~ACE_SOCK_Zerocopy_Sender (void);
+
+  /// Enable zero-copy sends on the socket of @a stream, which must be
+  /// connected and stay open while this object is in use.
+  int open (const ACE_SOCK_Stream &stream);
+
+  /**
+   * Release all the pending message blocks, whether their sends have
+   * completed or not.  This is only safe once the socket has been
+   * closed or when pending() is 0, as the kernel may otherwise still
+   * read the blocks.
+   */
+  int close (void);
+
+  /**
+   * Send as much as possible of the @a chain of message blocks linked
+   * through their @c cont pointers with a single zero-copy
+   * gather-write.  @a chain is updated as by
+   * ACE_SOCK_Stream::send_chain(), except that the blocks that were
+   * sent are moved to the pending sends rather than released.
+   *
+   * @retval  the number of bytes sent, 0 if @a chain had no data.
+   * @retval  -1 an error occurred and nothing was sent.
+   */
+  ssize_t send_chain (ACE_Message_Block *&chain,
+                      const ACE_Time_Value *timeout = 0);
+
+  /**
+   * Read the completions waiting on the error queue of the socket,
+   * without blocking, and release the message blocks of the sends that
+   * have completed.  Returns the number of sends that completed, or -1
+   * on error.
+   */
+  int handle_completions (void);
+
+  /// Number of sends waiting for their completion.
+  size_t pending (void) const;
+
+  /// Number of completed sends for which the kernel had to copy the
+  /// data after all.  If most are, zero-copy is not worth its cost.
+  size_t copied (void) const;
+
+  /// Socket the data is sent on.
+  ACE_HANDLE get_handle (void) const;
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// A send waiting for its completion.
+  struct Pending_Send
+  {
+    /// Sequence number the kernel gave the send.
+    ACE_UINT32 sequence_;
+
+    /// Set once the completion has been received.
+    bool done_;
+
+    /// Message blocks holding the data of the send, linked through
+    /// their @c cont pointers.
+    ACE_Message_Block *blocks_;
+  };
+
+  /// Mark the sends from @a first to @a last as done.
+  void complete (ACE_UINT32 first, ACE_UINT32 last);
+
+  /// Release the blocks of the leading sends that are done.
+  void release_done (void);
+
+  /// Socket the data is sent on.
+  ACE_HANDLE handle_;
+
+  /// Sequence number of the next send.
+  ACE_UINT32 next_sequence_;
+
+  /// Sends waiting for their completion, in the order they were made.
+  ACE_Unbounded_Queue<Pending_Send> pending_;
+
+  /// Number of sends the kernel copied.
+  size_t copied_;
+
+  // = Disallow copying.
+  ACE_UNIMPLEMENTED_FUNC (ACE_SOCK_Zerocopy_Sender (const ACE_SOCK_Zerocopy_Sender &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_SOCK_Zerocopy_Sender &))
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/SOCK_Zerocopy_Sender.inl"
+#endif /* __ACE_INLINE__ */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_SOCK_ZEROCOPY_SENDER_H */
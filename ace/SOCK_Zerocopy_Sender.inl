@@ -0,0 +1,25 @@
+// -*- C++ -*-
+//
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE size_t
+ACE_SOCK_Zerocopy_Sender::pending (void) const
+{
+  return this->pending_.size ();
+}
+
+ACE_INLINE size_t
+ACE_SOCK_Zerocopy_Sender::copied (void) const
+{
+  return this->copied_;
+}
+
+ACE_INLINE ACE_HANDLE
+ACE_SOCK_Zerocopy_Sender::get_handle (void) const
+{
+  return this->handle_;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
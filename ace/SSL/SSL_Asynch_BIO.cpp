@@ -7,6 +7,9 @@
 #include "SSL_Asynch_Stream.h"
 #include "ace/OS_NS_string.h"
 #include "ace/Truncate.h"
+#include "ace/Guard_T.h"
+#include "ace/Object_Manager.h"
+#include "ace/Recursive_Thread_Mutex.h"
 
 #if (defined (ACE_HAS_VERSIONED_NAMESPACE) && ACE_HAS_VERSIONED_NAMESPACE == 1)
 # define ACE_ASYNCH_BIO_WRITE_NAME ACE_PREPROC_CONCATENATE(ACE_VERSIONED_NAMESPACE_NAME, _ACE_Asynch_BIO_write)
@@ -42,6 +45,7 @@ extern "C"
 
 #define BIO_TYPE_ACE  ( 21 | BIO_TYPE_SOURCE_SINK )
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
 static BIO_METHOD methods_ACE =
   {
     BIO_TYPE_ACE, // BIO_TYPE_PROXY_SERVER,
@@ -56,12 +60,60 @@ static BIO_METHOD methods_ACE =
     0
   };
 
+// The accessors of OpenSSL >= 1.1.0, where BIO is opaque.
+# define BIO_get_data(b)        ((b)->ptr)
+# define BIO_set_data(b, p)     ((b)->ptr = (p))
+# define BIO_get_init(b)        ((b)->init)
+# define BIO_set_init(b, i)     ((b)->init = (i))
+# define BIO_get_shutdown(b)    ((b)->shutdown)
+# define BIO_set_shutdown(b, s) ((b)->shutdown = (s))
+#else
+// OpenSSL >= 1.1.0 makes BIO_METHOD opaque, so it is made once, on
+// first use, and lives until exit as the static one did.
+static BIO_METHOD *methods_ACE = 0;
+#endif  /* OPENSSL_VERSION_NUMBER < 0x10100000L */
+
 ACE_BEGIN_VERSIONED_NAMESPACE_DECL
 
+static BIO_METHOD *
+ACE_SSL_BIO_methods (void)
+{
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+  return &methods_ACE;
+#else
+  ACE_MT (ACE_GUARD_RETURN (ACE_Recursive_Thread_Mutex,
+                            ace_ssl_mon,
+                            *ACE_Static_Object_Lock::instance (),
+                            0));
+
+  if (methods_ACE == 0)
+    {
+      BIO_METHOD * const methods =
+        ::BIO_meth_new (BIO_TYPE_ACE, "ACE_Asynch_BIO");
+      if (methods == 0)
+        return 0;
+
+      ::BIO_meth_set_write (methods, ACE_ASYNCH_BIO_WRITE_NAME);
+      ::BIO_meth_set_read (methods, ACE_ASYNCH_BIO_READ_NAME);
+      ::BIO_meth_set_puts (methods, ACE_ASYNCH_BIO_PUTS_NAME);
+      ::BIO_meth_set_ctrl (methods, ACE_ASYNCH_BIO_CTRL_NAME);
+      ::BIO_meth_set_create (methods, ACE_ASYNCH_BIO_NEW_NAME);
+      ::BIO_meth_set_destroy (methods, ACE_ASYNCH_BIO_FREE_NAME);
+      methods_ACE = methods;
+    }
+
+  return methods_ACE;
+#endif  /* OPENSSL_VERSION_NUMBER < 0x10100000L */
+}
+
 BIO *
 ACE_SSL_make_BIO (void * ssl_asynch_stream)
 {
-  BIO * const pBIO = BIO_new (&methods_ACE);
+  BIO_METHOD * const methods = ACE_SSL_BIO_methods ();
+  if (methods == 0)
+    return 0;
+
+  BIO * const pBIO = BIO_new (methods);
 
   if (pBIO)
     BIO_ctrl (pBIO,
@@ -108,10 +160,9 @@ ACE_END_VERSIONED_NAMESPACE_DECL
 int
 ACE_ASYNCH_BIO_NEW_NAME (BIO * pBIO)
 {
-  pBIO->init  = 0;    // not initialized
-  pBIO->num   = 0;    // still zero ( we can use it )
-  pBIO->ptr   = 0;    // will be pointer to ACE_SSL_Asynch_Stream
-  pBIO->flags = 0;    //
+  BIO_set_init (pBIO, 0);   // not initialized
+  BIO_set_data (pBIO, 0);   // will be pointer to ACE_SSL_Asynch_Stream
+  BIO_clear_flags (pBIO, ~0);
 
   return 1;
 }
@@ -119,12 +170,11 @@ ACE_ASYNCH_BIO_NEW_NAME (BIO * pBIO)
 int
 ACE_ASYNCH_BIO_FREE_NAME (BIO * pBIO)
 {
-  if (pBIO && pBIO->shutdown)
+  if (pBIO && BIO_get_shutdown (pBIO))
     {
-      pBIO->ptr   = 0;
-      pBIO->init  = 0;
-      pBIO->num   = 0;
-      pBIO->flags = 0;
+      BIO_set_data (pBIO, 0);
+      BIO_set_init (pBIO, 0);
+      BIO_clear_flags (pBIO, ~0);
 
       return 1;
     }
@@ -138,9 +188,9 @@ ACE_ASYNCH_BIO_READ_NAME (BIO * pBIO, char * buf, int len)
   BIO_clear_retry_flags (pBIO);
 
   ACE_SSL_Asynch_Stream * const p_stream =
-    static_cast<ACE_SSL_Asynch_Stream *> (pBIO->ptr);
+    static_cast<ACE_SSL_Asynch_Stream *> (BIO_get_data (pBIO));
 
-  if (pBIO->init == 0 || p_stream == 0 || buf == 0 || len <= 0)
+  if (BIO_get_init (pBIO) == 0 || p_stream == 0 || buf == 0 || len <= 0)
     return -1;
 
   BIO_clear_retry_flags (pBIO);
@@ -168,9 +218,9 @@ ACE_ASYNCH_BIO_WRITE_NAME (BIO * pBIO, const char * buf, int len)
   BIO_clear_retry_flags (pBIO);
 
   ACE_SSL_Asynch_Stream * p_stream =
-    static_cast<ACE_SSL_Asynch_Stream *> (pBIO->ptr);
+    static_cast<ACE_SSL_Asynch_Stream *> (BIO_get_data (pBIO));
 
-  if (pBIO->init == 0 || p_stream == 0 || buf == 0 || len <= 0)
+  if (BIO_get_init (pBIO) == 0 || p_stream == 0 || buf == 0 || len <= 0)
     return -1;
 
   BIO_clear_retry_flags (pBIO);
@@ -200,9 +250,9 @@ ACE_ASYNCH_BIO_CTRL_NAME (BIO * pBIO, int cmd, long num, void *ptr)
   switch (cmd)
     {
     case BIO_C_SET_FILE_PTR:
-      pBIO->shutdown = static_cast<int> (num);
-      pBIO->ptr = ptr;
-      pBIO->init = 1;
+      BIO_set_shutdown (pBIO, static_cast<int> (num));
+      BIO_set_data (pBIO, ptr);
+      BIO_set_init (pBIO, 1);
       break;
 
     case BIO_CTRL_INFO:
@@ -210,11 +260,11 @@ ACE_ASYNCH_BIO_CTRL_NAME (BIO * pBIO, int cmd, long num, void *ptr)
       break;
 
     case BIO_CTRL_GET_CLOSE:
-      ret = pBIO->shutdown;
+      ret = BIO_get_shutdown (pBIO);
       break;
 
     case BIO_CTRL_SET_CLOSE:
-      pBIO->shutdown = static_cast<int> (num);
+      BIO_set_shutdown (pBIO, static_cast<int> (num));
       break;
 
     case BIO_CTRL_PENDING:
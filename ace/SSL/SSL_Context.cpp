@@ -142,7 +142,8 @@ ACE_SSL_Context::ssl_library_init (void)
     {
       // Initialize the locking callbacks before initializing anything
       // else.
-#ifdef ACE_HAS_THREADS
+#if defined (ACE_HAS_THREADS) && OPENSSL_VERSION_NUMBER < 0x10100000L
+      // OpenSSL >= 1.1.0 locks by itself and has no callbacks.
       int const num_locks = ::CRYPTO_num_locks ();
 
       this->locks_ = new lock_type[num_locks];
@@ -154,7 +155,7 @@ ACE_SSL_Context::ssl_library_init (void)
       ::CRYPTO_set_id_callback (ACE_SSL_THREAD_ID_NAME);
 # endif  /* !WIN32 */
       ::CRYPTO_set_locking_callback (ACE_SSL_LOCKING_CALLBACK_NAME);
-#endif  /* ACE_HAS_THREADS */
+#endif  /* ACE_HAS_THREADS && OPENSSL_VERSION_NUMBER < 0x10100000L */
 
       ::SSLeay_add_ssl_algorithms ();
       ::SSL_load_error_strings ();
@@ -168,15 +169,16 @@ ACE_SSL_Context::ssl_library_init (void)
       ::RAND_screen ();
 #endif  /* WIN32 */
 
-#if OPENSSL_VERSION_NUMBER >= 0x00905100L
-      // OpenSSL < 0.9.5 doesn't have EGD support.
+#if OPENSSL_VERSION_NUMBER >= 0x00905100L && !defined (OPENSSL_NO_EGD)
+      // OpenSSL < 0.9.5 doesn't have EGD support, nor OpenSSL >= 1.1.0
+      // unless configured with it.
 
       const char *egd_socket_file =
         ACE_OS::getenv (ACE_SSL_EGD_FILE_ENV);
 
       if (egd_socket_file != 0)
         (void) this->egd_file (egd_socket_file);
-#endif  /* OPENSSL_VERSION_NUMBER */
+#endif  /* OPENSSL_VERSION_NUMBER >= 0x00905100L && !OPENSSL_NO_EGD */
 
       const char *rand_file = ACE_OS::getenv (ACE_SSL_RAND_FILE_ENV);
 
@@ -202,18 +204,21 @@ ACE_SSL_Context::ssl_library_fini (void)
   --ssl_library_init_count;
   if (ssl_library_init_count == 0)
     {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+      // OpenSSL >= 1.1.0 cleans up at exit.
       ::ERR_free_strings ();
       ::EVP_cleanup ();
+#endif  /* OPENSSL_VERSION_NUMBER < 0x10100000L */
 
       // Clean up the locking callbacks after everything else has been
       // cleaned up.
-#ifdef ACE_HAS_THREADS
+#if defined (ACE_HAS_THREADS) && OPENSSL_VERSION_NUMBER < 0x10100000L
       ::CRYPTO_set_locking_callback (0);
       ssl_locks = 0;
 
       delete [] this->locks_;
       this->locks_ = 0;
-#endif  /* ACE_HAS_THREADS */
+#endif  /* ACE_HAS_THREADS && OPENSSL_VERSION_NUMBER < 0x10100000L */
     }
 }
 
@@ -236,7 +241,7 @@ ACE_SSL_Context::set_mode (int mode)
 
   switch (mode)
     {
-#if !defined (OPENSSL_NO_SSL2)
+#if !defined (OPENSSL_NO_SSL2) && OPENSSL_VERSION_NUMBER < 0x10100000L
     case ACE_SSL_Context::SSLv2_client:
       method = ::SSLv2_client_method ();
       break;
@@ -246,7 +251,8 @@ ACE_SSL_Context::set_mode (int mode)
     case ACE_SSL_Context::SSLv2:
       method = ::SSLv2_method ();
       break;
-#endif /* OPENSSL_NO_SSL2 */
+#endif /* !OPENSSL_NO_SSL2 && OPENSSL_VERSION_NUMBER < 0x10100000L */
+#if !defined (OPENSSL_NO_SSL3_METHOD)
     case ACE_SSL_Context::SSLv3_client:
       method = ::SSLv3_client_method ();
       break;
@@ -256,6 +262,7 @@ ACE_SSL_Context::set_mode (int mode)
     case ACE_SSL_Context::SSLv3:
       method = ::SSLv3_method ();
       break;
+#endif /* !OPENSSL_NO_SSL3_METHOD */
     case ACE_SSL_Context::SSLv23_client:
       method = ::SSLv23_client_method ();
       break;
@@ -297,7 +304,12 @@ ACE_SSL_Context::set_mode (int mode)
       break;
 #endif
     default:
+#if !defined (OPENSSL_NO_SSL3_METHOD)
       method = ::SSLv3_method ();
+#else
+      // Without SSLv3, the modes it lacks negotiate the version.
+      method = ::SSLv23_method ();
+#endif /* !OPENSSL_NO_SSL3_METHOD */
       break;
     }
 
@@ -556,8 +568,9 @@ ACE_SSL_Context::random_seed (const char * seed)
 int
 ACE_SSL_Context::egd_file (const char * socket_file)
 {
-#if OPENSSL_VERSION_NUMBER < 0x00905100L
-  // OpenSSL < 0.9.5 doesn't have EGD support.
+#if OPENSSL_VERSION_NUMBER < 0x00905100L || defined (OPENSSL_NO_EGD)
+  // OpenSSL < 0.9.5 doesn't have EGD support, nor OpenSSL >= 1.1.0
+  // unless configured with it.
   ACE_UNUSED_ARG (socket_file);
   ACE_NOTSUP_RETURN (-1);
 #else
@@ -568,7 +581,7 @@ ACE_SSL_Context::egd_file (const char * socket_file)
     return 0;
   else
     return -1;
-#endif  /* OPENSSL_VERSION_NUMBER >= 0x00905100L */
+#endif  /* OPENSSL_VERSION_NUMBER < 0x00905100L || OPENSSL_NO_EGD */
 }
 
 int
@@ -0,0 +1,625 @@
+// $Id$
+
+#include "ace/Log_Category.h"
+#include "ace/Flag_Manip.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_unistd.h"
+#include "ace/OS_NS_sys_socket.h"
+
+#include <openssl/err.h>
+
+#include "SSL_Stream_Handler.h"
+
+#if !defined (__ACE_INLINE__)
+#include "SSL_Stream_Handler.inl"
+#endif /* __ACE_INLINE__ */
+
+// Kernel TLS needs OpenSSL 3 built with it.
+#if defined (SSL_OP_ENABLE_KTLS) && !defined (OPENSSL_NO_KTLS)
+#  define ACE_SSL_HAS_KTLS
+#endif /* SSL_OP_ENABLE_KTLS && !OPENSSL_NO_KTLS */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_SSL_Stream_Handler)
+
+ACE_SSL_Stream_Handler::ACE_SSL_Stream_Handler (ACE_Reactor *reactor,
+                                                ACE_SSL_Context *context)
+  : ACE_Event_Handler (reactor),
+    ssl_ (0),
+    handle_ (ACE_INVALID_HANDLE),
+    established_ (false),
+    ktls_ (false),
+    shutting_down_ (false),
+    closed_ (false),
+    failed_ (false),
+    handshake_wants_write_ (false),
+    read_wants_write_ (false),
+    write_wants_read_ (false),
+    write_wants_write_ (false),
+    write_scheduled_ (false),
+    notify_drained_ (false),
+    queue_head_ (0),
+    queue_tail_ (0),
+    pending_ (0)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::ACE_SSL_Stream_Handler");
+
+  ACE_SSL_Context * ctx =
+    (context == 0 ? ACE_SSL_Context::instance () : context);
+
+  this->ssl_ = ::SSL_new (ctx->context ());
+
+  if (this->ssl_ == 0)
+    {
+      ACELIB_ERROR ((LM_ERROR,
+                  "(%P|%t) ACE_SSL_Stream_Handler "
+                  "- cannot allocate new SSL structure %p\n",
+                  ACE_TEXT ("")));
+      return;
+    }
+
+  // A write may return after sending part of the data, and a write
+  // that must be retried is retried from the queue, whose block may
+  // have moved.
+  ::SSL_set_mode (this->ssl_,
+                  SSL_MODE_ENABLE_PARTIAL_WRITE
+                  | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+}
+
+ACE_SSL_Stream_Handler::~ACE_SSL_Stream_Handler (void)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::~ACE_SSL_Stream_Handler");
+
+  ::SSL_free (this->ssl_);
+
+  if (this->queue_head_ != 0)
+    this->queue_head_->release ();
+
+  if (this->handle_ != ACE_INVALID_HANDLE)
+    ACE_OS::closesocket (this->handle_);
+}
+
+int
+ACE_SSL_Stream_Handler::open (ACE_HANDLE handle, bool server)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::open");
+
+  if (this->ssl_ == 0
+      || this->handle_ != ACE_INVALID_HANDLE
+      || this->reactor () == 0)
+    return -1;
+
+  if (ACE::set_flags (handle, ACE_NONBLOCK) == -1
+      || ::SSL_set_fd (this->ssl_, (int) handle) != 1)
+    return -1;
+
+#if defined (ACE_SSL_HAS_KTLS)
+  if (this->ktls_)
+    ::SSL_set_options (this->ssl_, SSL_OP_ENABLE_KTLS);
+#endif /* ACE_SSL_HAS_KTLS */
+
+  if (server)
+    ::SSL_set_accept_state (this->ssl_);
+  else
+    ::SSL_set_connect_state (this->ssl_);
+
+  this->handle_ = handle;
+
+  if (this->reactor ()->register_handler (this,
+                                          ACE_Event_Handler::READ_MASK) == -1)
+    {
+      this->handle_ = ACE_INVALID_HANDLE;
+      return -1;
+    }
+
+  // The client speaks first, so it starts at once; the server only
+  // finds out it must wait for the client.
+  if (this->handshake_i () == -1)
+    {
+      this->reactor ()->remove_handler (this,
+                                        ACE_Event_Handler::ALL_EVENTS_MASK
+                                        | ACE_Event_Handler::DONT_CALL);
+      this->handle_ = ACE_INVALID_HANDLE;
+      return -1;
+    }
+
+  return 0;
+}
+
+ssize_t
+ACE_SSL_Stream_Handler::send (const void *buf, size_t n)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::send");
+
+  if (this->handle_ == ACE_INVALID_HANDLE
+      || this->failed_
+      || this->shutting_down_)
+    {
+      errno = EPIPE;
+      return -1;
+    }
+
+  const char *data = static_cast<const char *> (buf);
+  size_t sent = 0;
+
+  // Only write at once if nothing is waiting before, else the data
+  // would overtake it.
+  if (this->established_ && this->queue_head_ == 0)
+    while (sent < n)
+      {
+        // SSL_write() takes an int.
+        size_t const chunk = n - sent > ACE_INT32_MAX
+          ? static_cast<size_t> (ACE_INT32_MAX)
+          : n - sent;
+        int const result = ::SSL_write (this->ssl_,
+                                        data + sent,
+                                        static_cast<int> (chunk));
+        if (result > 0)
+          {
+            sent += static_cast<size_t> (result);
+            continue;
+          }
+
+        int const status = this->status_i (result,
+                                           this->write_wants_read_,
+                                           this->write_wants_write_);
+        if (status == -1)
+          {
+            this->failed_ = true;
+            this->update_mask_i ();
+            return -1;
+          }
+        break;
+      }
+
+  if (sent < n)
+    {
+      // A write that must be retried is retried with the same data,
+      // which now starts the queue.
+      if (this->enqueue_i (data + sent, n - sent) == -1)
+        return -1;
+      this->notify_drained_ = true;
+      this->update_mask_i ();
+    }
+
+  return static_cast<ssize_t> (n);
+}
+
+ssize_t
+ACE_SSL_Stream_Handler::sendfile (ACE_HANDLE in_fd,
+                                  off_t *offset,
+                                  size_t count)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::sendfile");
+
+  if (this->handle_ == ACE_INVALID_HANDLE
+      || this->failed_
+      || this->shutting_down_)
+    {
+      errno = EPIPE;
+      return -1;
+    }
+
+  if (!this->established_ || this->queue_head_ != 0)
+    {
+      this->notify_drained_ = true;
+      errno = EWOULDBLOCK;
+      return -1;
+    }
+
+  if (count == 0)
+    return 0;
+
+#if defined (ACE_SSL_HAS_KTLS)
+  if (this->ktls_send ())
+    {
+      // The kernel encrypts the file on its way to the socket.
+      ossl_ssize_t const result =
+        ::SSL_sendfile (this->ssl_, (int) in_fd, *offset, count, 0);
+      if (result >= 0)
+        {
+          *offset += static_cast<off_t> (result);
+          return static_cast<ssize_t> (result);
+        }
+
+      if (this->status_i (-1,
+                          this->write_wants_read_,
+                          this->write_wants_write_) == -1)
+        {
+          this->failed_ = true;
+          this->update_mask_i ();
+          return -1;
+        }
+
+      this->notify_drained_ = true;
+      this->update_mask_i ();
+      errno = EWOULDBLOCK;
+      return -1;
+    }
+#endif /* ACE_SSL_HAS_KTLS */
+
+  // Read a record's worth of the file and send it as send() does.
+  char buf[16 * 1024];
+  ssize_t const n = ACE_OS::pread (in_fd,
+                                   buf,
+                                   count < sizeof buf ? count : sizeof buf,
+                                   *offset);
+  if (n <= 0)
+    return n;
+
+  if (this->send (buf, static_cast<size_t> (n)) == -1)
+    return -1;
+
+  *offset += static_cast<off_t> (n);
+  return n;
+}
+
+int
+ACE_SSL_Stream_Handler::shutdown (void)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::shutdown");
+
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    return -1;
+
+  // The reactor closes the connection from handle_output(), once the
+  // queue is sent.
+  this->shutting_down_ = true;
+  this->update_mask_i ();
+  return 0;
+}
+
+bool
+ACE_SSL_Stream_Handler::ktls_send (void) const
+{
+#if defined (ACE_SSL_HAS_KTLS)
+  return this->ssl_ != 0
+    && BIO_get_ktls_send (::SSL_get_wbio (this->ssl_)) != 0;
+#else
+  return false;
+#endif /* ACE_SSL_HAS_KTLS */
+}
+
+bool
+ACE_SSL_Stream_Handler::ktls_recv (void) const
+{
+#if defined (ACE_SSL_HAS_KTLS)
+  return this->ssl_ != 0
+    && BIO_get_ktls_recv (::SSL_get_rbio (this->ssl_)) != 0;
+#else
+  return false;
+#endif /* ACE_SSL_HAS_KTLS */
+}
+
+int
+ACE_SSL_Stream_Handler::handle_input (ACE_HANDLE)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::handle_input");
+
+  if (this->failed_)
+    return -1;
+
+  if (!this->established_)
+    return this->handshake_i ();
+
+  if (this->read_i () == -1)
+    return -1;
+
+  if (this->write_wants_read_)
+    {
+      this->write_wants_read_ = false;
+      if (this->flush_i () == -1)
+        return -1;
+    }
+
+  return this->update_mask_i ();
+}
+
+int
+ACE_SSL_Stream_Handler::handle_output (ACE_HANDLE)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::handle_output");
+
+  if (this->failed_)
+    return -1;
+
+  if (!this->established_)
+    {
+      // Not established yet but shutting down: nothing to say good
+      // bye to.
+      if (this->shutting_down_)
+        return -1;
+      return this->handshake_i ();
+    }
+
+  if (this->read_wants_write_)
+    {
+      this->read_wants_write_ = false;
+      if (this->read_i () == -1)
+        return -1;
+    }
+
+  if (!this->write_wants_read_ && this->flush_i () == -1)
+    return -1;
+
+  return this->update_mask_i ();
+}
+
+int
+ACE_SSL_Stream_Handler::handle_close (ACE_HANDLE, ACE_Reactor_Mask)
+{
+  ACE_TRACE ("ACE_SSL_Stream_Handler::handle_close");
+
+  if (this->closed_)
+    return 0;
+  this->closed_ = true;
+
+  if (this->handle_ != ACE_INVALID_HANDLE)
+    {
+      if (this->reactor () != 0)
+        this->reactor ()->remove_handler (this,
+                                          ACE_Event_Handler::ALL_EVENTS_MASK
+                                          | ACE_Event_Handler::DONT_CALL);
+      ACE_OS::closesocket (this->handle_);
+      this->handle_ = ACE_INVALID_HANDLE;
+    }
+
+  ::SSL_free (this->ssl_);
+  this->ssl_ = 0;
+
+  if (this->queue_head_ != 0)
+    this->queue_head_->release ();
+  this->queue_head_ = this->queue_tail_ = 0;
+  this->pending_ = 0;
+
+  return 0;
+}
+
+int
+ACE_SSL_Stream_Handler::handle_handshake (void)
+{
+  return 0;
+}
+
+int
+ACE_SSL_Stream_Handler::handle_data (const char *, size_t)
+{
+  return 0;
+}
+
+int
+ACE_SSL_Stream_Handler::handle_drained (void)
+{
+  return 0;
+}
+
+int
+ACE_SSL_Stream_Handler::handshake_i (void)
+{
+  int const result = ::SSL_do_handshake (this->ssl_);
+  bool want_read = false;
+
+  switch (this->status_i (result, want_read, this->handshake_wants_write_))
+    {
+    case -1:
+      return -1;
+
+    case 0:
+      return this->update_mask_i ();
+
+    default:
+      break;
+    }
+
+  this->established_ = true;
+
+  if (this->handle_handshake () == -1)
+    return -1;
+
+  // Send what was queued meanwhile, and hand out the data that came
+  // with the last handshake records, which the reactor will not tell
+  // about as it was read already.
+  if (this->flush_i () == -1 || this->read_i () == -1)
+    return -1;
+
+  return this->update_mask_i ();
+}
+
+int
+ACE_SSL_Stream_Handler::read_i (void)
+{
+  // One record at most.
+  char buf[16 * 1024];
+  bool want_read = false;
+
+  for (;;)
+    {
+      if (this->ssl_ == 0)
+        return -1;
+
+      int const result = ::SSL_read (this->ssl_, buf, sizeof buf);
+
+      if (result > 0)
+        {
+          if (this->handle_data (buf, static_cast<size_t> (result)) == -1)
+            return -1;
+          continue;
+        }
+
+      return this->status_i (result, want_read, this->read_wants_write_)
+        == -1 ? -1 : 0;
+    }
+}
+
+int
+ACE_SSL_Stream_Handler::flush_i (void)
+{
+  while (this->queue_head_ != 0)
+    {
+      ACE_Message_Block *mb = this->queue_head_;
+
+      if (mb->length () == 0)
+        {
+          this->queue_head_ = mb->next ();
+          if (this->queue_head_ == 0)
+            this->queue_tail_ = 0;
+          mb->next (0);
+          mb->release ();
+          continue;
+        }
+
+      size_t const chunk = mb->length () > ACE_INT32_MAX
+        ? static_cast<size_t> (ACE_INT32_MAX)
+        : mb->length ();
+      int const result = ::SSL_write (this->ssl_,
+                                      mb->rd_ptr (),
+                                      static_cast<int> (chunk));
+      if (result > 0)
+        {
+          mb->rd_ptr (static_cast<size_t> (result));
+          this->pending_ -= static_cast<size_t> (result);
+          continue;
+        }
+
+      return this->status_i (result,
+                             this->write_wants_read_,
+                             this->write_wants_write_) == -1 ? -1 : 0;
+    }
+
+  this->write_wants_read_ = false;
+  this->write_wants_write_ = false;
+
+  if (this->notify_drained_)
+    {
+      this->notify_drained_ = false;
+      if (this->handle_drained () == -1)
+        return -1;
+
+      // handle_drained() may have queued more.
+      if (this->queue_head_ != 0)
+        return 0;
+    }
+
+  return this->close_if_done_i ();
+}
+
+int
+ACE_SSL_Stream_Handler::enqueue_i (const char *buf, size_t n)
+{
+  ACE_Message_Block *mb = 0;
+  ACE_NEW_RETURN (mb, ACE_Message_Block (n), -1);
+  mb->copy (buf, n);
+
+  if (this->queue_tail_ == 0)
+    this->queue_head_ = mb;
+  else
+    this->queue_tail_->next (mb);
+  this->queue_tail_ = mb;
+  this->pending_ += n;
+
+  return 0;
+}
+
+int
+ACE_SSL_Stream_Handler::update_mask_i (void)
+{
+  if (this->handle_ == ACE_INVALID_HANDLE || this->closed_)
+    return 0;
+
+  // A queue waits for the socket unless its write waits for input.
+  bool const want =
+    this->failed_
+    || this->handshake_wants_write_
+    || this->read_wants_write_
+    || this->write_wants_write_
+    || (this->shutting_down_ && !this->established_)
+    || (this->established_
+        && !this->write_wants_read_
+        && (this->queue_head_ != 0 || this->shutting_down_));
+
+  if (want == this->write_scheduled_)
+    return 0;
+
+  int const result = want
+    ? this->reactor ()->schedule_wakeup (this, ACE_Event_Handler::WRITE_MASK)
+    : this->reactor ()->cancel_wakeup (this, ACE_Event_Handler::WRITE_MASK);
+  if (result == -1)
+    return -1;
+
+  this->write_scheduled_ = want;
+  return 0;
+}
+
+int
+ACE_SSL_Stream_Handler::status_i (int result,
+                                  bool &want_read,
+                                  bool &want_write)
+{
+  want_read = false;
+  want_write = false;
+
+  switch (::SSL_get_error (this->ssl_, result))
+    {
+    case SSL_ERROR_NONE:
+      return 1;
+
+    case SSL_ERROR_WANT_READ:
+      want_read = true;
+      return 0;
+
+    case SSL_ERROR_WANT_WRITE:
+      want_write = true;
+      return 0;
+
+    case SSL_ERROR_ZERO_RETURN:
+      // The peer sent close_notify.
+      errno = 0;
+      return -1;
+
+    case SSL_ERROR_SYSCALL:
+      if (::ERR_peek_error () == 0)
+        {
+          // The peer went away without close_notify, or the socket
+          // failed.
+          if (result == 0 || errno == 0)
+            errno = ECONNRESET;
+          else
+            ACELIB_ERROR ((LM_ERROR,
+                           ACE_TEXT ("(%P|%t) ACE_SSL_Stream_Handler %p\n"),
+                           ACE_TEXT ("")));
+          return -1;
+        }
+      // Fall through.
+
+    default:
+      ACE_SSL_Context::report_error ();
+      ::ERR_clear_error ();
+      errno = 0;
+      return -1;
+    }
+}
+
+int
+ACE_SSL_Stream_Handler::close_if_done_i (void)
+{
+  if (!this->shutting_down_ || this->queue_head_ != 0)
+    return 0;
+
+  if (!this->established_)
+    return -1;
+
+  // Send close_notify, without waiting for the peer's.
+  int const result = ::SSL_shutdown (this->ssl_);
+  if (result >= 0)
+    return -1;
+
+  if (this->status_i (result,
+                      this->write_wants_read_,
+                      this->write_wants_write_) == -1)
+    return -1;
+
+  return 0;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
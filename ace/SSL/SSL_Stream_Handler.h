@@ -0,0 +1,226 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    SSL_Stream_Handler.h
+ *
+ *  $Id$
+ *
+ *  A reactive, non-blocking TLS/SSL connection.
+ */
+//=============================================================================
+
+#ifndef ACE_SSL_STREAM_HANDLER_H
+#define ACE_SSL_STREAM_HANDLER_H
+
+#include /**/ "ace/pre.h"
+
+#include "SSL_Export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+// This must be included before any <openssl> include on LynxOS
+#include "ace/os_include/os_stdio.h"
+#include <openssl/ssl.h>
+
+#include "SSL_Context.h"
+#include "ace/Event_Handler.h"
+#include "ace/Reactor.h"
+#include "ace/Message_Block.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_SSL_Stream_Handler
+ *
+ * @brief An ACE_Event_Handler that runs a TLS/SSL connection on a
+ *        non-blocking socket from the reactor.
+ *
+ * Unlike ACE_SSL_SOCK_Stream, whose operations wait for the socket
+ * when OpenSSL needs it, and ACE_SSL_Asynch_Stream, which needs a
+ * proactor, no operation ever waits: the handshake, the records
+ * received and those sent are all driven from handle_input() and
+ * handle_output().  Whenever OpenSSL needs to read to go on, e.g., a
+ * write during the handshake or a renegotiation, the handler waits
+ * for input, and whenever it needs to write, e.g., a read that must
+ * answer the peer, it asks the reactor for handle_output() until the
+ * operation goes through, so that the handler is only called when it
+ * can make progress.  It runs with any reactor, and the records read
+ * are drained each time, so it also runs with the
+ * ACE_Dev_Poll_Reactor, which does not call the handler again for
+ * data already read by OpenSSL.
+ *
+ * Derived classes are given the decrypted data by handle_data(),
+ * and send with send() and sendfile(), which queue what the socket
+ * does not take at once and tell through handle_drained() when the
+ * queue is empty again.
+ *
+ * Where OpenSSL and the kernel support it (Linux with the "tls"
+ * module, and ACE_SSL built against OpenSSL 3 configured with
+ * enable-ktls), ktls() asks OpenSSL to hand the keys to the kernel
+ * after the handshake.  The records are then encrypted by the kernel,
+ * so send() costs a plain send() and sendfile() sends files with
+ * SSL_sendfile() without copying them through user space.  Elsewhere,
+ * as with OpenSSL releases before 3, ktls() does nothing and
+ * sendfile() reads the file and sends it as send() does.
+ *
+ * As with the other ACE_SSL classes, only one thread may use a
+ * handler at a time, which the reactors that suspend handlers while
+ * they dispatch them, or a single reactor thread, guarantee.
+ */
+class ACE_SSL_Export ACE_SSL_Stream_Handler : public ACE_Event_Handler
+{
+public:
+  /// Run with @a reactor, with a new SSL structure of @a context.
+  ACE_SSL_Stream_Handler (ACE_Reactor *reactor = ACE_Reactor::instance (),
+                          ACE_SSL_Context *context =
+                            ACE_SSL_Context::instance ());
+
+  virtual ~ACE_SSL_Stream_Handler (void);
+
+  /**
+   * Take over the connected socket @a handle, make it non-blocking,
+   * register with the reactor and start the handshake, as the server
+   * if @a server, else as the client.  Returns 0 on success or -1 on
+   * failure, in which case @a handle is not closed.
+   */
+  int open (ACE_HANDLE handle, bool server);
+
+  /**
+   * Send the @a n bytes at @a buf.  What the socket does not take
+   * now, or all of it before the handshake completed, is copied to
+   * the queue and sent as the socket allows.  Returns @a n, or -1 if
+   * the connection failed or is shutting down.
+   */
+  ssize_t send (const void *buf, size_t n);
+
+  /**
+   * Send up to @a count bytes of the file @a in_fd from @a offset,
+   * which is advanced by the bytes sent.  Only sends once the queue
+   * is empty, so the file follows what was sent before.  Returns the
+   * bytes sent, which may be fewer than @a count, 0 at the end of the
+   * file, or -1 with @c errno EWOULDBLOCK if nothing can be sent now,
+   * in which case handle_drained() is called once something can.
+   */
+  ssize_t sendfile (ACE_HANDLE in_fd, off_t *offset, size_t count);
+
+  /// Bytes queued that the socket did not take yet.
+  size_t pending (void) const;
+
+  /**
+   * Send the TLS close_notify once the queue is sent and close the
+   * connection, which calls handle_close().  Returns 0, or -1 if the
+   * handler was not open.
+   */
+  int shutdown (void);
+
+  /// Ask OpenSSL to use kernel TLS after the handshake, if it can.
+  /// Must be called before open().
+  void ktls (bool enable);
+
+  /// True once the handshake completed.
+  bool established (void) const;
+
+  /// True if records are sent, respectively received, by the kernel.
+  bool ktls_send (void) const;
+  bool ktls_recv (void) const;
+
+  /// The underlying SSL structure.
+  SSL *ssl (void) const;
+
+  // = ACE_Event_Handler hooks.
+  virtual ACE_HANDLE get_handle (void) const;
+  virtual int handle_input (ACE_HANDLE fd = ACE_INVALID_HANDLE);
+  virtual int handle_output (ACE_HANDLE fd = ACE_INVALID_HANDLE);
+
+  /// Remove the handler from the reactor, free the SSL session and
+  /// close the socket.  Derived classes that delete themselves do so
+  /// after calling this.
+  virtual int handle_close (ACE_HANDLE handle,
+                            ACE_Reactor_Mask close_mask);
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+  /// Called once the handshake completed.  Returning -1 closes the
+  /// connection.
+  virtual int handle_handshake (void);
+
+  /// Called with each piece of data received.  Returning -1 closes
+  /// the connection.
+  virtual int handle_data (const char *data, size_t n);
+
+  /// Called when the queue was emptied after send() queued data or
+  /// sendfile() could not send.  Returning -1 closes the connection.
+  virtual int handle_drained (void);
+
+private:
+  /// Go on with the handshake.
+  int handshake_i (void);
+
+  /// Read and hand out the records until OpenSSL needs more input.
+  int read_i (void);
+
+  /// Write the queue until the socket is full.
+  int flush_i (void);
+
+  /// Queue a copy of the @a n bytes at @a buf.
+  int enqueue_i (const char *buf, size_t n);
+
+  /// Ask the reactor for handle_output() if an operation waits for
+  /// the socket to be writable, and stop asking if none does.
+  int update_mask_i (void);
+
+  /// Map the result @a result of an SSL operation to 1 if it went
+  /// through, 0 if it must be retried when @a want_read or
+  /// @a want_write tells, and -1 on failure.
+  int status_i (int result, bool &want_read, bool &want_write);
+
+  /// Send close_notify and close if shutdown() was asked and the
+  /// queue is empty.  Returns -1 when closed.
+  int close_if_done_i (void);
+
+  SSL *ssl_;
+  ACE_HANDLE handle_;
+
+  bool established_;
+  bool ktls_;
+  bool shutting_down_;
+  bool closed_;
+
+  /// Set when send() or sendfile() failed, so that the reactor closes
+  /// the connection.
+  bool failed_;
+
+  /// Whether the handshake, the last read and the last write wait for
+  /// the socket to be writable (the handshake and write may instead
+  /// wait to be readable, which the handler always is).
+  bool handshake_wants_write_;
+  bool read_wants_write_;
+  bool write_wants_read_;
+  bool write_wants_write_;
+
+  /// Whether handle_output() is asked of the reactor.
+  bool write_scheduled_;
+
+  /// Whether handle_drained() is due once the queue is empty.
+  bool notify_drained_;
+
+  /// The data not sent yet, oldest first, linked by next().
+  ACE_Message_Block *queue_head_;
+  ACE_Message_Block *queue_tail_;
+  size_t pending_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "SSL_Stream_Handler.inl"
+#endif /* __ACE_INLINE__ */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_SSL_STREAM_HANDLER_H */
@@ -0,0 +1,37 @@
+// -*- C++ -*-
+//
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE size_t
+ACE_SSL_Stream_Handler::pending (void) const
+{
+  return this->pending_;
+}
+
+ACE_INLINE void
+ACE_SSL_Stream_Handler::ktls (bool enable)
+{
+  this->ktls_ = enable;
+}
+
+ACE_INLINE bool
+ACE_SSL_Stream_Handler::established (void) const
+{
+  return this->established_;
+}
+
+ACE_INLINE SSL *
+ACE_SSL_Stream_Handler::ssl (void) const
+{
+  return this->ssl_;
+}
+
+ACE_INLINE ACE_HANDLE
+ACE_SSL_Stream_Handler::get_handle (void) const
+{
+  return this->handle_;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
@@ -10,6 +10,10 @@
 #include "ace/Signal.h"
 #include "ace/OS_NS_fcntl.h"
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+#include "ace/Reactor_Instrumentation.h"
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 #if !defined (__ACE_INLINE__)
 #include "ace/Select_Reactor_Base.inl"
 #endif /* __ACE_INLINE__ */
@@ -569,7 +573,16 @@ ACE_Select_Reactor_Notify::purge_pending_notifications (ACE_Event_Handler *eh,
 
 #if defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE)
 
-  return notification_queue_.purge_pending_notifications(eh, mask);
+  int const n = notification_queue_.purge_pending_notifications(eh, mask);
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (n > 0
+      && this->select_reactor_ != 0
+      && this->select_reactor_->instrumentation_ != 0)
+    this->select_reactor_->instrumentation_->notify_dequeued (n);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
+  return n;
 
 #else /* defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE) */
   ACE_UNUSED_ARG (eh);
@@ -706,10 +719,24 @@ ACE_Select_Reactor_Notify::notify (ACE_Event_Handler *event_handler,
       // No failures, the handler is now owned by the notification queue
       safe_handler.release ();
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      if (this->select_reactor_->instrumentation_ != 0)
+        this->select_reactor_->instrumentation_->notify_queued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       return 0;
     }
 #endif /* ACE_HAS_REACTOR_NOTIFICATION_QUEUE */
 
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  // The eventfd never fills up, so there is nothing to wait for.
+  ACE_UNUSED_ARG (timeout);
+
+  if (this->notification_pipe_.signal () == -1)
+    {
+      return -1;
+    }
+#else
   ssize_t const n = ACE::send (this->notification_pipe_.write_handle (),
                                (char *) &buffer,
                                sizeof buffer,
@@ -718,10 +745,16 @@ ACE_Select_Reactor_Notify::notify (ACE_Event_Handler *event_handler,
     {
       return -1;
     }
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 
   // No failures.
   safe_handler.release ();
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (this->select_reactor_->instrumentation_ != 0)
+    this->select_reactor_->instrumentation_->notify_queued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   return 0;
 }
 
@@ -804,10 +837,20 @@ ACE_Select_Reactor_Notify::dispatch_notify (ACE_Notification_Buffer &buffer)
       return result;
     }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (this->select_reactor_->instrumentation_ != 0)
+    this->select_reactor_->instrumentation_->notify_dequeued ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   if(more_messages_queued)
     {
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+      ACE_UNUSED_ARG (next);
+      (void) this->notification_pipe_.signal ();
+#else
       (void) ACE::send(this->notification_pipe_.write_handle(),
             (char *)&next, sizeof(ACE_Notification_Buffer));
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
     }
 #endif /* ACE_HAS_REACTOR_NOTIFICATION_QUEUE */
 
@@ -824,6 +867,15 @@ ACE_Select_Reactor_Notify::dispatch_notify (ACE_Notification_Buffer &buffer)
         event_handler->reference_counting_policy ().value () ==
         ACE_Event_Handler::Reference_Counting_Policy::ENABLED;
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      ACE_Reactor_Instrumentation *const instrumentation =
+        this->select_reactor_->instrumentation_;
+      ACE_hrtime_t const start =
+        instrumentation == 0 ? 0 : instrumentation->start ();
+      const char *const type =
+        instrumentation == 0 ? 0 : instrumentation->handler_type (event_handler);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       switch (buffer.mask_)
         {
         case ACE_Event_Handler::READ_MASK:
@@ -849,6 +901,13 @@ ACE_Select_Reactor_Notify::dispatch_notify (ACE_Notification_Buffer &buffer)
                       buffer.mask_));
         }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      if (instrumentation != 0)
+        instrumentation->upcall (ACE_Reactor_Instrumentation::NOTIFY,
+                                 start,
+                                 type);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
       if (result == -1)
         event_handler->handle_close (ACE_INVALID_HANDLE,
                                      ACE_Event_Handler::EXCEPT_MASK);
@@ -868,6 +927,15 @@ ACE_Select_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
 {
   ACE_TRACE ("ACE_Select_Reactor_Notify::read_notify_pipe");
 
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  // The notifications themselves are in the queue, where
+  // dispatch_notify() gets them, the eventfd only tells that there
+  // are some.
+  ACE_UNUSED_ARG (handle);
+  ACE_UNUSED_ARG (buffer);
+
+  return this->notification_pipe_.clear ();
+#else
   // This is kind of a weird, fragile beast.  We first read with a
   // regular read.  The read side of this socket is non-blocking, so
   // the read may end up being short.
@@ -906,6 +974,13 @@ ACE_Select_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
             return -1;
         }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+# if !defined (ACE_HAS_REACTOR_NOTIFICATION_QUEUE)
+      // The pipe is the queue.
+      if (this->select_reactor_->instrumentation_ != 0)
+        this->select_reactor_->instrumentation_->notify_dequeued ();
+# endif /* !ACE_HAS_REACTOR_NOTIFICATION_QUEUE */
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
 
       return 1;
     }
@@ -915,6 +990,7 @@ ACE_Select_Reactor_Notify::read_notify_pipe (ACE_HANDLE handle,
     return -1;
 
   return 0;
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 }
 
 
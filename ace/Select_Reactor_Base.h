@@ -52,6 +52,9 @@ typedef int (ACE_Event_Handler::*ACE_EH_PTMF) (ACE_HANDLE);
 // Forward declaration.
 class ACE_Select_Reactor_Impl;
 class ACE_Sig_Handler;
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+class ACE_Reactor_Instrumentation;
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
 
 /*
  * Hook to specialize the Select_Reactor_Base implementation
@@ -243,7 +246,11 @@ protected:
    * on, as well as the ACE_HANDLE that threads wanting the
    * attention of the ACE_Select_Reactor will write to.
    */
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  ACE_Notification_Event notification_pipe_;
+#else
   ACE_Pipe notification_pipe_;
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 
   /**
    * Keeps track of the maximum number of times that the
@@ -265,8 +272,15 @@ protected:
    * the events in user-space.  The pipe is still needed to wake up
    * the reactor thread, but only one event is sent through the pipe
    * at a time.
+   *
+   * With an eventfd instead of the pipe, the queue is lock-free and
+   * notify() only signals the eventfd when it was empty.
    */
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+  ACE_Notification_Queue_Lock_Free notification_queue_;
+#else
   ACE_Notification_Queue notification_queue_;
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 #endif /* ACE_HAS_REACTOR_NOTIFICATION_QUEUE */
 };
 
@@ -487,6 +501,15 @@ public:
   /// resumed by the  application. So return 0;
   virtual int resumable_handler (void);
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  /// Record the latencies of this reactor in @a instrumentation, or
+  /// stop recording them if it is 0.  This must be done before the
+  /// event loop is run, and @a instrumentation must outlive the
+  /// reactor.
+  void instrumentation (ACE_Reactor_Instrumentation *instrumentation);
+  ACE_Reactor_Instrumentation *instrumentation (void) const;
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   /*
    * Hook to add concrete methods required to specialize the
    * implementation with concrete methods required for the concrete
@@ -587,6 +610,11 @@ protected:
    */
   bool mask_signals_;
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  /// Where latencies are recorded, 0 if they are not.
+  ACE_Reactor_Instrumentation *instrumentation_;
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   /// Controls/access whether the notify handler should renew the
   /// Select_Reactor's token or not.
   int supress_notify_renew (void);
@@ -130,6 +130,9 @@ ACE_Select_Reactor_Impl::ACE_Select_Reactor_Impl (bool ms)
   , requeue_position_ (-1) // Requeue at end of waiters by default.
   , state_changed_ (0)
   , mask_signals_ (ms)
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  , instrumentation_ (0)
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
   , supress_renew_ (0)
 {
 }
@@ -149,4 +152,19 @@ ACE_Select_Reactor_Impl::supress_notify_renew (int sr)
   this->supress_renew_ = sr;
 }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+ACE_INLINE void
+ACE_Select_Reactor_Impl::instrumentation (
+  ACE_Reactor_Instrumentation *instrumentation)
+{
+  this->instrumentation_ = instrumentation;
+}
+
+ACE_INLINE ACE_Reactor_Instrumentation *
+ACE_Select_Reactor_Impl::instrumentation (void) const
+{
+  return this->instrumentation_;
+}
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 ACE_END_VERSIONED_NAMESPACE_DECL
@@ -23,6 +23,10 @@
 // For timer_queue_
 #include "ace/Recursive_Thread_Mutex.h"
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+#include "ace/Reactor_Instrumentation.h"
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 /*
  * ACE Reactor specialization hook.
  */
@@ -825,8 +829,25 @@ ACE_Select_Reactor_T<ACE_SELECT_REACTOR_TOKEN>::notify_handle
       event_handler->add_reference ();
     }
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_Reactor_Instrumentation *const instrumentation =
+    this->instrumentation_;
+  ACE_hrtime_t const start =
+    instrumentation == 0 ? 0 : instrumentation->start ();
+  const char *const type =
+    instrumentation == 0 ? 0 : instrumentation->handler_type (event_handler);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   int const status = (event_handler->*ptmf) (handle);
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  if (instrumentation != 0)
+    instrumentation->upcall (ACE_Reactor_Instrumentation::upcall_type (mask),
+                             start,
+                             type,
+                             handle);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   if (status < 0)
     this->remove_handler_i (handle, mask);
   else if (status > 0)
@@ -1108,11 +1129,19 @@ ACE_Select_Reactor_T<ACE_SELECT_REACTOR_TOKEN>::wait_for_multiple_events
           dispatch_set.rd_mask_ = this->wait_set_.rd_mask_;
           dispatch_set.wr_mask_ = this->wait_set_.wr_mask_;
           dispatch_set.ex_mask_ = this->wait_set_.ex_mask_;
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+          ACE_hrtime_t const start =
+            this->instrumentation_ == 0 ? 0 : this->instrumentation_->start ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
           number_of_active_handles = ACE_OS::select (width,
                                                      dispatch_set.rd_mask_,
                                                      dispatch_set.wr_mask_,
                                                      dispatch_set.ex_mask_,
                                                      this_timeout);
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+          if (this->instrumentation_ != 0)
+            this->instrumentation_->waited (start);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
         }
       while (number_of_active_handles == -1 && this->handle_error () > 0);
 
@@ -1152,6 +1181,27 @@ template <class ACE_SELECT_REACTOR_TOKEN> int
 ACE_Select_Reactor_T<ACE_SELECT_REACTOR_TOKEN>::dispatch_timer_handlers
   (int &number_of_handlers_dispatched)
 {
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_Reactor_Instrumentation *const instrumentation =
+    this->instrumentation_;
+  if (instrumentation != 0 && !this->timer_queue_->is_empty ())
+    {
+      ACE_Time_Value const now = this->timer_queue_->gettimeofday ();
+      ACE_Time_Value const expiry = this->timer_queue_->earliest_time ();
+      ACE_hrtime_t const start = instrumentation->start ();
+      int const n = this->timer_queue_->expire ();
+      if (n > 0)
+        {
+          // All the timers that expired are timed as one upcall.
+          instrumentation->timer_expired (expiry, now);
+          instrumentation->upcall (ACE_Reactor_Instrumentation::TIMEOUT,
+                                   start);
+          number_of_handlers_dispatched += n;
+        }
+      return 0;
+    }
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   number_of_handlers_dispatched += this->timer_queue_->expire ();
 
   return 0;
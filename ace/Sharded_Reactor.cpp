@@ -0,0 +1,1030 @@
+// $Id$
+
+#include "ace/Sharded_Reactor.h"
+
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+
+#include "ace/ACE.h"
+#include "ace/Guard_T.h"
+#include "ace/Handle_Set.h"
+#include "ace/Log_Category.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_unistd.h"
+#include "ace/Sig_Handler.h"
+
+#if !defined (__ACE_INLINE__)
+# include "ace/Sharded_Reactor.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Sharded_Reactor)
+
+ACE_Sharded_Reactor::ACE_Sharded_Reactor (size_t shards,
+                                          size_t size,
+                                          bool restart)
+  : shards_ (0)
+  , shard_count_ (shards)
+  , size_ (0)
+  , handle_shards_ (0)
+  , shard_threads_ (0)
+  , next_shard_ (0)
+  , next_loop_shard_ (0)
+  , lock_adapter_ (lock_)
+  , initialized_ (false)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::ACE_Sharded_Reactor");
+
+  if (this->shard_count_ == 0)
+    {
+      long const cpus = ACE_OS::num_processors_online ();
+      this->shard_count_ = cpus > 0 ? static_cast<size_t> (cpus) : 1;
+    }
+
+  if (this->open (size == 0 ? ACE::max_handles () : size, restart) == -1)
+    ACELIB_ERROR ((LM_ERROR,
+                   ACE_TEXT ("%p\n"),
+                   ACE_TEXT ("ACE_Sharded_Reactor::open ")
+                   ACE_TEXT ("failed inside ACE_Sharded_Reactor::CTOR")));
+}
+
+ACE_Sharded_Reactor::~ACE_Sharded_Reactor (void)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::~ACE_Sharded_Reactor");
+
+  (void) this->close ();
+}
+
+int
+ACE_Sharded_Reactor::open (size_t size,
+                           bool restart,
+                           ACE_Sig_Handler *sh,
+                           ACE_Timer_Queue *tq,
+                           int disable_notify_pipe,
+                           ACE_Reactor_Notify *notify)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::open");
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+  // Can't initialize ourselves more than once.
+  if (this->initialized_)
+    return -1;
+
+  if (this->shard_count_ == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_NEW_RETURN (this->handle_shards_,
+                  int[size],
+                  -1);
+
+  for (size_t h = 0; h < size; ++h)
+    this->handle_shards_[h] = -1;
+
+  this->size_ = size;
+
+  ACE_NEW_RETURN (this->shards_,
+                  ACE_Dev_Poll_Reactor *[this->shard_count_],
+                  -1);
+
+  ACE_NEW_RETURN (this->shard_threads_,
+                  size_t[this->shard_count_],
+                  -1);
+
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    {
+      this->shards_[i] = 0;
+      this->shard_threads_[i] = 0;
+    }
+
+  int result = 0;
+
+  // Only the first shard may use the caller's signal handler, timer
+  // queue and notify handler; none of them can be shared.
+  for (size_t i = 0; result == 0 && i < this->shard_count_; ++i)
+    {
+      ACE_NEW_NORETURN (this->shards_[i],
+                        ACE_Dev_Poll_Reactor (size,
+                                              restart,
+                                              i == 0 ? sh : 0,
+                                              i == 0 ? tq : 0,
+                                              disable_notify_pipe,
+                                              i == 0 ? notify : 0));
+      if (this->shards_[i] == 0 || !this->shards_[i]->initialized ())
+        result = -1;
+    }
+
+  if (result == 0)
+    this->initialized_ = true;
+  else
+    {
+      ACE_Errno_Guard error (errno);
+      guard.release ();
+      (void) this->close ();
+    }
+
+  return result;
+}
+
+int
+ACE_Sharded_Reactor::current_info (ACE_HANDLE, size_t & /* size */)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+int
+ACE_Sharded_Reactor::set_sig_handler (ACE_Sig_Handler *signal_handler)
+{
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->set_sig_handler (signal_handler);
+}
+
+int
+ACE_Sharded_Reactor::timer_queue (ACE_Timer_Queue *tq)
+{
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->timer_queue (tq);
+}
+
+ACE_Timer_Queue *
+ACE_Sharded_Reactor::timer_queue (void) const
+{
+  return this->initialized_ ? this->shards_[0]->timer_queue () : 0;
+}
+
+int
+ACE_Sharded_Reactor::close (void)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::close");
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+  int result = 0;
+
+  if (this->shards_ != 0)
+    {
+      for (size_t i = 0; i < this->shard_count_; ++i)
+        {
+          if (this->shards_[i] != 0 && this->shards_[i]->close () == -1)
+            result = -1;
+          delete this->shards_[i];
+        }
+
+      delete [] this->shards_;
+      this->shards_ = 0;
+    }
+
+  delete [] this->handle_shards_;
+  this->handle_shards_ = 0;
+  delete [] this->shard_threads_;
+  this->shard_threads_ = 0;
+  this->size_ = 0;
+
+  this->initialized_ = false;
+
+  return result;
+}
+
+int
+ACE_Sharded_Reactor::bind_thread (size_t n)
+{
+  if (n >= this->shard_count_)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+  if (!this->initialized_)
+    return -1;
+
+  this->bind_thread_i (n);
+  return 0;
+}
+
+void
+ACE_Sharded_Reactor::bind_thread_i (size_t n)
+{
+  int const old = this->thread_shard ();
+  if (old != -1)
+    --this->shard_threads_[old];
+
+  ++this->shard_threads_[n];
+  *this->thread_shard_ = n + 1;
+}
+
+size_t
+ACE_Sharded_Reactor::next_loop_shard_i (void) const
+{
+  // Shards nobody runs first, so that every thread gets a shard of
+  // its own while there are enough of them.
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    {
+      size_t const n = (this->next_loop_shard_ + i) % this->shard_count_;
+      if (this->shard_threads_[n] == 0)
+        return n;
+    }
+
+  return this->next_loop_shard_ % this->shard_count_;
+}
+
+size_t
+ACE_Sharded_Reactor::place_i (void)
+{
+  int const bound = this->thread_shard ();
+  if (bound != -1)
+    return static_cast<size_t> (bound);
+
+  // Round-robin over the shards that have a thread to run them.
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    {
+      size_t const n = (this->next_shard_ + i) % this->shard_count_;
+      if (this->shard_threads_[n] != 0)
+        {
+          this->next_shard_ = n + 1;
+          return n;
+        }
+    }
+
+  // No thread yet: the first one to run an event loop will take this
+  // shard.
+  return this->next_loop_shard_i ();
+}
+
+int
+ACE_Sharded_Reactor::handle_shard (ACE_HANDLE handle) const
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+  if (!this->initialized_
+      || handle < 0
+      || static_cast<size_t> (handle) >= this->size_)
+    return -1;
+
+  int const n = this->handle_shards_[handle];
+
+  // The handle may have been removed, possibly from within its shard,
+  // since it was placed.
+  if (n == -1
+      || this->shards_[n]->handler (handle,
+                                    ACE_Event_Handler::NULL_MASK,
+                                    0) == -1)
+    return -1;
+
+  return n;
+}
+
+ACE_Dev_Poll_Reactor *
+ACE_Sharded_Reactor::find_shard (ACE_HANDLE handle) const
+{
+  int const n = this->handle_shard (handle);
+  return n == -1 ? 0 : this->shards_[n];
+}
+
+ACE_Dev_Poll_Reactor *
+ACE_Sharded_Reactor::select_shard (void)
+{
+  if (!this->initialized_)
+    return 0;
+
+  int const n = this->thread_shard ();
+  if (n != -1)
+    return this->shards_[n];
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+  return this->shards_[this->place_i ()];
+}
+
+ACE_Dev_Poll_Reactor *
+ACE_Sharded_Reactor::loop_shard (void)
+{
+  if (!this->initialized_)
+    return 0;
+
+  int n = this->thread_shard ();
+
+  if (n == -1)
+    {
+      ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, 0);
+      n = static_cast<int> (this->next_loop_shard_i ());
+      this->next_loop_shard_ = n + 1;
+      this->bind_thread_i (n);
+    }
+
+  return this->shards_[n];
+}
+
+int
+ACE_Sharded_Reactor::work_pending (const ACE_Time_Value &max_wait_time)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::work_pending");
+
+  if (!this->initialized_)
+    return -1;
+
+  int const n = this->thread_shard ();
+  if (n != -1)
+    return this->shards_[n]->work_pending (max_wait_time);
+
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    {
+      int const result = this->shards_[i]->work_pending ();
+      if (result != 0)
+        return result;
+    }
+
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::handle_events (ACE_Time_Value *max_wait_time)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::handle_events");
+
+  ACE_Dev_Poll_Reactor *shard = this->loop_shard ();
+  return shard == 0 ? -1 : shard->handle_events (max_wait_time);
+}
+
+int
+ACE_Sharded_Reactor::alertable_handle_events (ACE_Time_Value *max_wait_time)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::alertable_handle_events");
+
+  ACE_Dev_Poll_Reactor *shard = this->loop_shard ();
+  return shard == 0 ? -1 : shard->alertable_handle_events (max_wait_time);
+}
+
+int
+ACE_Sharded_Reactor::handle_events (ACE_Time_Value &max_wait_time)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::handle_events");
+
+  return this->handle_events (&max_wait_time);
+}
+
+int
+ACE_Sharded_Reactor::alertable_handle_events (ACE_Time_Value &max_wait_time)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::alertable_handle_events");
+
+  return this->alertable_handle_events (&max_wait_time);
+}
+
+int
+ACE_Sharded_Reactor::deactivated (void)
+{
+  if (!this->initialized_)
+    return 1;
+
+  // All shards are deactivated together.
+  int const n = this->thread_shard ();
+  return this->shards_[n == -1 ? 0 : n]->deactivated ();
+}
+
+void
+ACE_Sharded_Reactor::deactivate (int do_stop)
+{
+  if (!this->initialized_)
+    return;
+
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    this->shards_[i]->deactivate (do_stop);
+}
+
+int
+ACE_Sharded_Reactor::register_handler (ACE_Event_Handler *handler,
+                                       ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::register_handler");
+
+  return this->register_handler (handler->get_handle (), handler, mask);
+}
+
+int
+ACE_Sharded_Reactor::register_handler (ACE_HANDLE handle,
+                                       ACE_Event_Handler *event_handler,
+                                       ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::register_handler");
+
+  if (!this->initialized_)
+    return -1;
+
+  if (handle < 0 || static_cast<size_t> (handle) >= this->size_)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+
+  // Add to the existing registration, if any, else place the handle
+  // on the calling thread's shard or the next shard that is run.
+  int n = this->handle_shards_[handle];
+  if (n == -1
+      || this->shards_[n]->handler (handle,
+                                    ACE_Event_Handler::NULL_MASK,
+                                    0) == -1)
+    n = static_cast<int> (this->place_i ());
+
+  if (this->shards_[n]->register_handler (handle, event_handler, mask) == -1)
+    return -1;
+
+  this->handle_shards_[handle] = n;
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::register_handler (ACE_HANDLE /* event_handle */,
+                                       ACE_HANDLE /* io_handle */,
+                                       ACE_Event_Handler * /* event_handler */,
+                                       ACE_Reactor_Mask /* mask */)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+int
+ACE_Sharded_Reactor::register_handler (const ACE_Handle_Set &handle_set,
+                                       ACE_Event_Handler *event_handler,
+                                       ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::register_handler");
+
+  ACE_Handle_Set_Iterator handle_iter (handle_set);
+
+  for (ACE_HANDLE h = handle_iter ();
+       h != ACE_INVALID_HANDLE;
+       h = handle_iter ())
+    if (this->register_handler (h, event_handler, mask) == -1)
+      return -1;
+
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::register_handler (int signum,
+                                       ACE_Event_Handler *new_sh,
+                                       ACE_Sig_Action *new_disp,
+                                       ACE_Event_Handler **old_sh,
+                                       ACE_Sig_Action *old_disp)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::register_handler");
+
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->register_handler (signum,
+                                             new_sh,
+                                             new_disp,
+                                             old_sh,
+                                             old_disp);
+}
+
+int
+ACE_Sharded_Reactor::register_handler (const ACE_Sig_Set &sigset,
+                                       ACE_Event_Handler *new_sh,
+                                       ACE_Sig_Action *new_disp)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::register_handler");
+
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->register_handler (sigset, new_sh, new_disp);
+}
+
+int
+ACE_Sharded_Reactor::remove_handler (ACE_Event_Handler *handler,
+                                     ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::remove_handler");
+
+  return this->remove_handler (handler->get_handle (), mask);
+}
+
+int
+ACE_Sharded_Reactor::remove_handler (ACE_HANDLE handle,
+                                     ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::remove_handler");
+
+  // The placement lock isn't held across the removal since
+  // handle_close() may call back into this reactor.
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->remove_handler (handle, mask);
+}
+
+int
+ACE_Sharded_Reactor::remove_handler (const ACE_Handle_Set &handle_set,
+                                     ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::remove_handler");
+
+  ACE_Handle_Set_Iterator handle_iter (handle_set);
+
+  for (ACE_HANDLE h = handle_iter ();
+       h != ACE_INVALID_HANDLE;
+       h = handle_iter ())
+    if (this->remove_handler (h, mask) == -1)
+      return -1;
+
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::remove_handler (int signum,
+                                     ACE_Sig_Action *new_disp,
+                                     ACE_Sig_Action *old_disp,
+                                     int sigkey)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::remove_handler");
+
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->remove_handler (signum, new_disp, old_disp, sigkey);
+}
+
+int
+ACE_Sharded_Reactor::remove_handler (const ACE_Sig_Set &sigset)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::remove_handler");
+
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->remove_handler (sigset);
+}
+
+int
+ACE_Sharded_Reactor::suspend_handler (ACE_Event_Handler *event_handler)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::suspend_handler");
+
+  if (event_handler == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return this->suspend_handler (event_handler->get_handle ());
+}
+
+int
+ACE_Sharded_Reactor::suspend_handler (ACE_HANDLE handle)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::suspend_handler");
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->suspend_handler (handle);
+}
+
+int
+ACE_Sharded_Reactor::suspend_handler (const ACE_Handle_Set &handles)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::suspend_handler");
+
+  ACE_Handle_Set_Iterator handle_iter (handles);
+
+  for (ACE_HANDLE h = handle_iter ();
+       h != ACE_INVALID_HANDLE;
+       h = handle_iter ())
+    if (this->suspend_handler (h) == -1)
+      return -1;
+
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::suspend_handlers (void)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::suspend_handlers");
+
+  if (!this->initialized_)
+    return -1;
+
+  int result = 0;
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    if (this->shards_[i]->suspend_handlers () == -1)
+      result = -1;
+
+  return result;
+}
+
+int
+ACE_Sharded_Reactor::resume_handler (ACE_Event_Handler *event_handler)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::resume_handler");
+
+  if (event_handler == 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return this->resume_handler (event_handler->get_handle ());
+}
+
+int
+ACE_Sharded_Reactor::resume_handler (ACE_HANDLE handle)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::resume_handler");
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->resume_handler (handle);
+}
+
+int
+ACE_Sharded_Reactor::resume_handler (const ACE_Handle_Set &handles)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::resume_handler");
+
+  ACE_Handle_Set_Iterator handle_iter (handles);
+
+  for (ACE_HANDLE h = handle_iter ();
+       h != ACE_INVALID_HANDLE;
+       h = handle_iter ())
+    if (this->resume_handler (h) == -1)
+      return -1;
+
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::resume_handlers (void)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::resume_handlers");
+
+  if (!this->initialized_)
+    return -1;
+
+  int result = 0;
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    if (this->shards_[i]->resume_handlers () == -1)
+      result = -1;
+
+  return result;
+}
+
+int
+ACE_Sharded_Reactor::resumable_handler (void)
+{
+  // Same as the shards.
+  return 1;
+}
+
+bool
+ACE_Sharded_Reactor::uses_event_associations (void)
+{
+  return false;
+}
+
+long
+ACE_Sharded_Reactor::schedule_timer (ACE_Event_Handler *event_handler,
+                                     const void *arg,
+                                     const ACE_Time_Value &delay,
+                                     const ACE_Time_Value &interval)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::schedule_timer");
+
+  if (!this->initialized_)
+    return -1;
+
+  int n = this->handle_shard (event_handler->get_handle ());
+  if (n == -1)
+    {
+      ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, guard, this->lock_, -1);
+      n = static_cast<int> (this->place_i ());
+    }
+
+  long const timer_id =
+    this->shards_[n]->schedule_timer (event_handler, arg, delay, interval);
+
+  // Encode the shard in the timer id so it can be found again.
+  if (timer_id == -1)
+    return -1;
+
+  return timer_id * static_cast<long> (this->shard_count_) + n;
+}
+
+int
+ACE_Sharded_Reactor::reset_timer_interval (long timer_id,
+                                           const ACE_Time_Value &interval)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::reset_timer_interval");
+
+  if (!this->initialized_ || timer_id < 0)
+    return -1;
+
+  long const count = static_cast<long> (this->shard_count_);
+  return this->shards_[timer_id % count]->reset_timer_interval (timer_id / count,
+                                                                interval);
+}
+
+int
+ACE_Sharded_Reactor::cancel_timer (ACE_Event_Handler *event_handler,
+                                   int dont_call_handle_close)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::cancel_timer");
+
+  if (!this->initialized_)
+    return 0;
+
+  int result = 0;
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    result += this->shards_[i]->cancel_timer (event_handler,
+                                              dont_call_handle_close);
+
+  return result;
+}
+
+int
+ACE_Sharded_Reactor::cancel_timer (long timer_id,
+                                   const void **arg,
+                                   int dont_call_handle_close)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::cancel_timer");
+
+  if (!this->initialized_ || timer_id < 0)
+    return 0;
+
+  long const count = static_cast<long> (this->shard_count_);
+  return this->shards_[timer_id % count]->cancel_timer (timer_id / count,
+                                                        arg,
+                                                        dont_call_handle_close);
+}
+
+int
+ACE_Sharded_Reactor::schedule_wakeup (ACE_Event_Handler *eh,
+                                      ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::schedule_wakeup");
+
+  return this->schedule_wakeup (eh->get_handle (), mask);
+}
+
+int
+ACE_Sharded_Reactor::schedule_wakeup (ACE_HANDLE handle,
+                                      ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::schedule_wakeup");
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->schedule_wakeup (handle, mask);
+}
+
+int
+ACE_Sharded_Reactor::cancel_wakeup (ACE_Event_Handler *eh,
+                                    ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::cancel_wakeup");
+
+  return this->cancel_wakeup (eh->get_handle (), mask);
+}
+
+int
+ACE_Sharded_Reactor::cancel_wakeup (ACE_HANDLE handle,
+                                    ACE_Reactor_Mask mask)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::cancel_wakeup");
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->cancel_wakeup (handle, mask);
+}
+
+int
+ACE_Sharded_Reactor::notify (ACE_Event_Handler *eh,
+                             ACE_Reactor_Mask mask,
+                             ACE_Time_Value *timeout)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::notify");
+
+  if (!this->initialized_)
+    return -1;
+
+  // A bare wakeup is for whoever is waiting, so wake every shard.
+  if (eh == 0)
+    {
+      int result = 0;
+      for (size_t i = 0; i < this->shard_count_; ++i)
+        if (this->shards_[i]->notify (0, mask, timeout) == -1)
+          result = -1;
+      return result;
+    }
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (eh->get_handle ());
+  if (shard == 0)
+    shard = this->select_shard ();
+
+  return shard->notify (eh, mask, timeout);
+}
+
+void
+ACE_Sharded_Reactor::max_notify_iterations (int iterations)
+{
+  if (!this->initialized_)
+    return;
+
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    this->shards_[i]->max_notify_iterations (iterations);
+}
+
+int
+ACE_Sharded_Reactor::max_notify_iterations (void)
+{
+  return this->initialized_ ? this->shards_[0]->max_notify_iterations () : -1;
+}
+
+int
+ACE_Sharded_Reactor::purge_pending_notifications (ACE_Event_Handler *eh,
+                                                  ACE_Reactor_Mask mask)
+{
+  if (!this->initialized_)
+    return -1;
+
+  int result = 0;
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    {
+      int const n = this->shards_[i]->purge_pending_notifications (eh, mask);
+      if (n == -1)
+        return -1;
+      result += n;
+    }
+
+  return result;
+}
+
+ACE_Event_Handler *
+ACE_Sharded_Reactor::find_handler (ACE_HANDLE handle)
+{
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? 0 : shard->find_handler (handle);
+}
+
+int
+ACE_Sharded_Reactor::handler (ACE_HANDLE handle,
+                              ACE_Reactor_Mask mask,
+                              ACE_Event_Handler **event_handler)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::handler");
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->handler (handle, mask, event_handler);
+}
+
+int
+ACE_Sharded_Reactor::handler (int signum,
+                              ACE_Event_Handler **eh)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::handler");
+
+  if (!this->initialized_)
+    return -1;
+
+  return this->shards_[0]->handler (signum, eh);
+}
+
+bool
+ACE_Sharded_Reactor::initialized (void)
+{
+  return this->initialized_;
+}
+
+size_t
+ACE_Sharded_Reactor::size (void) const
+{
+  return this->size_;
+}
+
+ACE_Lock &
+ACE_Sharded_Reactor::lock (void)
+{
+  return this->lock_adapter_;
+}
+
+void
+ACE_Sharded_Reactor::wakeup_all_threads (void)
+{
+  if (!this->initialized_)
+    return;
+
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    this->shards_[i]->wakeup_all_threads ();
+}
+
+int
+ACE_Sharded_Reactor::owner (ACE_thread_t /* new_owner */,
+                            ACE_thread_t * /* old_owner */)
+{
+  // There is no need to set the owner of the event loop.  Multiple
+  // threads may invoke the event loop simulataneously.
+  return 0;
+}
+
+int
+ACE_Sharded_Reactor::owner (ACE_thread_t * /* owner */)
+{
+  // There is no need to set the owner of the event loop.  Multiple
+  // threads may invoke the event loop simulataneously.
+  return 0;
+}
+
+bool
+ACE_Sharded_Reactor::restart (void)
+{
+  return this->initialized_ ? this->shards_[0]->restart () : false;
+}
+
+bool
+ACE_Sharded_Reactor::restart (bool r)
+{
+  if (!this->initialized_)
+    return false;
+
+  bool const current_value = this->shards_[0]->restart ();
+  for (size_t i = 0; i < this->shard_count_; ++i)
+    this->shards_[i]->restart (r);
+
+  return current_value;
+}
+
+void
+ACE_Sharded_Reactor::requeue_position (int)
+{
+}
+
+int
+ACE_Sharded_Reactor::requeue_position (void)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+int
+ACE_Sharded_Reactor::mask_ops (ACE_Event_Handler *event_handler,
+                               ACE_Reactor_Mask mask,
+                               int ops)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::mask_ops");
+
+  return this->mask_ops (event_handler->get_handle (), mask, ops);
+}
+
+int
+ACE_Sharded_Reactor::mask_ops (ACE_HANDLE handle,
+                               ACE_Reactor_Mask mask,
+                               int ops)
+{
+  ACE_TRACE ("ACE_Sharded_Reactor::mask_ops");
+
+  ACE_Dev_Poll_Reactor *shard = this->find_shard (handle);
+  return shard == 0 ? -1 : shard->mask_ops (handle, mask, ops);
+}
+
+int
+ACE_Sharded_Reactor::ready_ops (ACE_Event_Handler * /* event_handler */,
+                                ACE_Reactor_Mask /* mask */,
+                                int /* ops */)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+int
+ACE_Sharded_Reactor::ready_ops (ACE_HANDLE /* handle */,
+                                ACE_Reactor_Mask /* mask */,
+                                int /* ops */)
+{
+  ACE_NOTSUP_RETURN (-1);
+}
+
+void
+ACE_Sharded_Reactor::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Sharded_Reactor::dump");
+
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("initialized_ = %d"),
+                 this->initialized_));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("shard_count_ = %B"),
+                 this->shard_count_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("size_ = %B"), this->size_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+
+  for (size_t i = 0; this->shards_ != 0 && i < this->shard_count_; ++i)
+    this->shards_[i]->dump ();
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif  /* ACE_HAS_EVENT_POLL || ACE_HAS_DEV_POLL */
@@ -0,0 +1,407 @@
+// -*- C++ -*-
+
+// =========================================================================
+/**
+ *  @file    Sharded_Reactor.h
+ *
+ *  $Id$
+ *
+ *  Reactor implementation running one @c /dev/poll (or Linux
+ *  @c sys_epoll) demultiplexer per event loop thread.
+ */
+// =========================================================================
+
+
+#ifndef ACE_SHARDED_REACTOR_H
+#define ACE_SHARDED_REACTOR_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/ACE_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+
+#include "ace/Dev_Poll_Reactor.h"
+#include "ace/Lock_Adapter_T.h"
+#include "ace/TSS_T.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Sharded_Reactor
+ *
+ * @brief A Reactor made of several independent ACE_Dev_Poll_Reactor
+ *        "shards", each with its own poll set and token.
+ *
+ * A multi-threaded ACE_Dev_Poll_Reactor or ACE_TP_Reactor makes all
+ * of its threads take turns on a single token and a single poll
+ * set.  This reactor instead gives each event loop thread a shard of
+ * its own, so threads running different shards never contend with
+ * each other while waiting for or dispatching events.
+ * @par
+ * Each thread calling one of the event loop methods is bound to a
+ * shard, either explicitly through bind_thread() or, on its first
+ * call, to the next shard no thread is bound to yet (or round-robin
+ * once every shard has one).  Handlers are pinned to a shard when
+ * their handle is registered: a thread bound to a shard registers on
+ * that shard, other threads spread registrations round-robin over
+ * the shards that have a thread bound to them.  Before any thread is
+ * bound, registrations go to the shard the first event loop thread
+ * will be bound to, so that with fewer event loop threads than
+ * shards no handler is left on a shard nobody runs.  A thread stays
+ * counted on its shard until it binds to another one, so an event
+ * loop thread that exits should be replaced on the same shard (e.g.
+ * with bind_thread()).  All later operations on the handle, and
+ * notifications for its handler, go to that shard, so a handler is
+ * only ever dispatched by the threads of one shard.  Connections
+ * accepted by an acceptor therefore stay on the acceptor's shard.
+ * @par
+ * To spread accepts across shards, open one ACE_SOCK_Acceptor per
+ * shard on the same address with the @c reuse_port argument (Linux
+ * @c SO_REUSEPORT) and register each one from the thread that runs
+ * its shard.  ACE_Acceptor has no such argument, so each acceptor is
+ * wrapped in an event handler whose get_handle() returns the handle
+ * of the acceptor and whose handle_input() accepts, e.g. in the event
+ * loop thread of shard @c i:
+ * @code
+ *   sharded.bind_thread (i);
+ *   ACE_SOCK_Acceptor &acceptor = handlers[i]->acceptor ();
+ *   if (acceptor.open (addr, 1, PF_UNSPEC, ACE_DEFAULT_BACKLOG, 0, 1) == -1
+ *       || reactor.register_handler (handlers[i],
+ *                                    ACE_Event_Handler::ACCEPT_MASK) == -1)
+ *     return -1;
+ *   reactor.run_reactor_event_loop ();
+ * @endcode
+ * @par
+ * Timers are scheduled on the shard of the handler's handle (or the
+ * calling thread's shard, or one placed as handles are), and signal
+ * handlers always live on the first shard.
+ *
+ * @note Event loop threads must not be shared between ACE_Sharded_Reactor
+ *       instances through the same thread binding; each reactor keeps
+ *       its own bindings.
+ */
+class ACE_Export ACE_Sharded_Reactor : public ACE_Reactor_Impl
+{
+public:
+
+  /// Initialize with @a shards shards, each sized to @a size handles.
+  /**
+   * If @a shards is 0 one shard per online processor is used.  If
+   * @a size is 0 the shards are sized to the maximum number of
+   * handles.
+   */
+  explicit ACE_Sharded_Reactor (size_t shards = 0,
+                                size_t size = 0,
+                                bool restart = false);
+
+  /// Close down and release all resources.
+  virtual ~ACE_Sharded_Reactor (void);
+
+  /// Initialization.
+  /**
+   * The signal handler, timer queue and notify handler, if supplied,
+   * are only used by the first shard; the other shards create their
+   * own timer queue and notify handler.
+   */
+  virtual int open (size_t size,
+                    bool restart = false,
+                    ACE_Sig_Handler * = 0,
+                    ACE_Timer_Queue * = 0,
+                    int disable_notify_pipe = 0,
+                    ACE_Reactor_Notify * = 0);
+
+  /// Not supported.
+  virtual int current_info (ACE_HANDLE handle, size_t & /* size */);
+
+  /// Use a user specified signal handler instead.
+  virtual int set_sig_handler (ACE_Sig_Handler *signal_handler);
+
+  /// Set the timer queue of the first shard.
+  virtual int timer_queue (ACE_Timer_Queue *tq);
+
+  /// Get the timer queue of the first shard.
+  virtual ACE_Timer_Queue *timer_queue (void) const;
+
+  /// Close down and release all resources.
+  virtual int close (void);
+
+  /// Return the number of shards.
+  size_t shard_count (void) const;
+
+  /// Return shard @a n, or 0 if there is no such shard.
+  ACE_Dev_Poll_Reactor *shard (size_t n) const;
+
+  /// Bind the calling thread to shard @a n, moving it off the shard
+  /// it was bound to.  Returns 0 on success, -1 with @c errno set to
+  /// @c EINVAL if there is no such shard.
+  int bind_thread (size_t n);
+
+  /// Return the shard the calling thread is bound to, or -1 if it is
+  /// not bound to one.
+  int thread_shard (void) const;
+
+  /// Return the shard the given handle is registered with, or -1 if
+  /// it is not registered.
+  int handle_shard (ACE_HANDLE handle) const;
+
+  // = Event loop drivers.
+  /**
+   * Returns non-zero if there are I/O events "ready" for dispatching
+   * on the calling thread's shard.  If the thread is not bound to a
+   * shard, all shards are polled without waiting.
+   */
+  virtual int work_pending (
+    const ACE_Time_Value &max_wait_time = ACE_Time_Value::zero);
+
+  /// Run the event loop of the calling thread's shard, binding the
+  /// thread to a shard first if needed.
+  virtual int handle_events (ACE_Time_Value *max_wait_time = 0);
+  virtual int alertable_handle_events (ACE_Time_Value *max_wait_time = 0);
+  virtual int handle_events (ACE_Time_Value &max_wait_time);
+  virtual int alertable_handle_events (ACE_Time_Value &max_wait_time);
+
+  // = Event handling control.
+  virtual int deactivated (void);
+
+  /// Deactivate (or reactivate) all shards.
+  virtual void deactivate (int do_stop);
+
+  // = Register and remove handlers.
+  virtual int register_handler (ACE_Event_Handler *event_handler,
+                                ACE_Reactor_Mask mask);
+
+  virtual int register_handler (ACE_HANDLE io_handle,
+                                ACE_Event_Handler *event_handler,
+                                ACE_Reactor_Mask mask);
+
+  /// Not supported.
+  virtual int register_handler (ACE_HANDLE event_handle,
+                                ACE_HANDLE io_handle,
+                                ACE_Event_Handler *event_handler,
+                                ACE_Reactor_Mask mask);
+
+  virtual int register_handler (const ACE_Handle_Set &handle_set,
+                                ACE_Event_Handler *event_handler,
+                                ACE_Reactor_Mask mask);
+
+  virtual int register_handler (int signum,
+                                ACE_Event_Handler *new_sh,
+                                ACE_Sig_Action *new_disp = 0,
+                                ACE_Event_Handler **old_sh = 0,
+                                ACE_Sig_Action *old_disp = 0);
+
+  virtual int register_handler (const ACE_Sig_Set &sigset,
+                                ACE_Event_Handler *new_sh,
+                                ACE_Sig_Action *new_disp = 0);
+
+  virtual int remove_handler (ACE_Event_Handler *event_handler,
+                              ACE_Reactor_Mask mask);
+
+  virtual int remove_handler (ACE_HANDLE handle,
+                              ACE_Reactor_Mask mask);
+
+  virtual int remove_handler (const ACE_Handle_Set &handle_set,
+                              ACE_Reactor_Mask mask);
+
+  virtual int remove_handler (int signum,
+                              ACE_Sig_Action *new_disp,
+                              ACE_Sig_Action *old_disp = 0,
+                              int sigkey = -1);
+
+  virtual int remove_handler (const ACE_Sig_Set &sigset);
+
+  // = Suspend and resume Handlers.
+  virtual int suspend_handler (ACE_Event_Handler *event_handler);
+  virtual int suspend_handler (ACE_HANDLE handle);
+  virtual int suspend_handler (const ACE_Handle_Set &handles);
+  virtual int suspend_handlers (void);
+  virtual int resume_handler (ACE_Event_Handler *event_handler);
+  virtual int resume_handler (ACE_HANDLE handle);
+  virtual int resume_handler (const ACE_Handle_Set &handles);
+  virtual int resume_handlers (void);
+  virtual int resumable_handler (void);
+  virtual bool uses_event_associations (void);
+
+  // = Timer management.
+  /**
+   * The timer is scheduled on the shard that @a event_handler's
+   * handle is registered with, else on the calling thread's shard,
+   * else on a shard placed as handles are.  The returned timer id
+   * identifies both the shard and the timer within it.
+   */
+  virtual long schedule_timer (ACE_Event_Handler *event_handler,
+                               const void *arg,
+                               const ACE_Time_Value &delay,
+                               const ACE_Time_Value &interval =
+                                 ACE_Time_Value::zero);
+
+  virtual int reset_timer_interval (long timer_id,
+                                    const ACE_Time_Value &interval);
+
+  /// Cancel all timers for @a event_handler, on every shard.
+  virtual int cancel_timer (ACE_Event_Handler *event_handler,
+                            int dont_call_handle_close = 1);
+
+  virtual int cancel_timer (long timer_id,
+                            const void **arg = 0,
+                            int dont_call_handle_close = 1);
+
+  // = High-level event handler scheduling operations
+  virtual int schedule_wakeup (ACE_Event_Handler *eh,
+                               ACE_Reactor_Mask mask);
+  virtual int schedule_wakeup (ACE_HANDLE handle,
+                               ACE_Reactor_Mask mask);
+  virtual int cancel_wakeup (ACE_Event_Handler *eh,
+                             ACE_Reactor_Mask mask);
+  virtual int cancel_wakeup (ACE_HANDLE handle,
+                             ACE_Reactor_Mask mask);
+
+  // = Notification methods.
+  /**
+   * Notify @a event_handler on the shard its handle is registered
+   * with (or on the calling thread's shard, or one placed as handles
+   * are).  A notification with no
+   * event handler wakes up every shard.
+   */
+  virtual int notify (ACE_Event_Handler *event_handler = 0,
+                      ACE_Reactor_Mask mask = ACE_Event_Handler::EXCEPT_MASK,
+                      ACE_Time_Value * = 0);
+
+  virtual void max_notify_iterations (int);
+  virtual int max_notify_iterations (void);
+
+  virtual int purge_pending_notifications (
+    ACE_Event_Handler * = 0,
+    ACE_Reactor_Mask = ACE_Event_Handler::ALL_EVENTS_MASK);
+
+  virtual ACE_Event_Handler *find_handler (ACE_HANDLE handle);
+
+  virtual int handler (ACE_HANDLE handle,
+                       ACE_Reactor_Mask mask,
+                       ACE_Event_Handler **event_handler = 0);
+
+  virtual int handler (int signum,
+                       ACE_Event_Handler ** = 0);
+
+  virtual bool initialized (void);
+
+  virtual size_t size (void) const;
+
+  /// Returns the lock serializing handler placement, not an event
+  /// loop lock; shards are never locked as a whole.
+  virtual ACE_Lock &lock (void);
+
+  virtual void wakeup_all_threads (void);
+
+  /// No-op, as with ACE_Dev_Poll_Reactor.
+  virtual int owner (ACE_thread_t new_owner, ACE_thread_t *old_owner = 0);
+  virtual int owner (ACE_thread_t *owner);
+
+  virtual bool restart (void);
+  virtual bool restart (bool r);
+
+  virtual void requeue_position (int);
+  virtual int requeue_position (void);
+
+  virtual int mask_ops (ACE_Event_Handler *event_handler,
+                        ACE_Reactor_Mask mask,
+                        int ops);
+  virtual int mask_ops (ACE_HANDLE handle,
+                        ACE_Reactor_Mask mask,
+                        int ops);
+
+  /// Not supported.
+  virtual int ready_ops (ACE_Event_Handler *event_handler,
+                         ACE_Reactor_Mask mask,
+                         int ops);
+  virtual int ready_ops (ACE_HANDLE handle,
+                         ACE_Reactor_Mask,
+                         int ops);
+
+  /// Dump the state of an object.
+  virtual void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+protected:
+
+  /// Return the shard @a handle is registered with, or 0.
+  ACE_Dev_Poll_Reactor *find_shard (ACE_HANDLE handle) const;
+
+  /// Return the shard to place new work on for the calling thread.
+  ACE_Dev_Poll_Reactor *select_shard (void);
+
+  /// Return the shard the calling thread runs, binding it first if
+  /// needed.
+  ACE_Dev_Poll_Reactor *loop_shard (void);
+
+  /// Return the shard the next event loop thread not bound to a shard
+  /// will be bound to.  Must be called with @c lock_ held.
+  size_t next_loop_shard_i (void) const;
+
+  /// Return the shard to place a handle on for the calling thread.
+  /// Must be called with @c lock_ held.
+  size_t place_i (void);
+
+  /// Bind the calling thread to shard @a n.  Must be called with
+  /// @c lock_ held.
+  void bind_thread_i (size_t n);
+
+protected:
+
+  /// The shards.
+  ACE_Dev_Poll_Reactor **shards_;
+
+  /// Number of elements in @c shards_.
+  size_t shard_count_;
+
+  /// Maximum number of handles.
+  size_t size_;
+
+  /// Shard index each handle was last placed on, or -1.
+  int *handle_shards_;
+
+  /// Number of threads bound to each shard.
+  size_t *shard_threads_;
+
+  /// Next shard for registrations from threads not bound to a shard.
+  size_t next_shard_;
+
+  /// Next shard for event loop threads not bound to a shard.
+  size_t next_loop_shard_;
+
+  /// Shard (plus one) the calling thread is bound to; 0 if none.
+  ACE_TSS<ACE_TSS_Type_Adapter<size_t> > thread_shard_;
+
+  /// Serializes handler placement.
+  mutable ACE_SYNCH_MUTEX lock_;
+
+  /// Adapter used to return internal lock to outside world.
+  ACE_Lock_Adapter<ACE_SYNCH_MUTEX> lock_adapter_;
+
+  /// Has the reactor been initialized.
+  bool initialized_;
+
+private:
+  /// Deny access since member-wise won't work...
+  ACE_Sharded_Reactor (const ACE_Sharded_Reactor &);
+  ACE_Sharded_Reactor &operator = (const ACE_Sharded_Reactor &);
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+# include "ace/Sharded_Reactor.inl"
+#endif /* __ACE_INLINE__ */
+
+#endif  /* ACE_HAS_EVENT_POLL || ACE_HAS_DEV_POLL */
+
+#include /**/ "ace/post.h"
+
+#endif  /* ACE_SHARDED_REACTOR_H */
@@ -0,0 +1,25 @@
+// -*- C++ -*-
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE size_t
+ACE_Sharded_Reactor::shard_count (void) const
+{
+  return this->shard_count_;
+}
+
+ACE_INLINE ACE_Dev_Poll_Reactor *
+ACE_Sharded_Reactor::shard (size_t n) const
+{
+  return n < this->shard_count_ ? this->shards_[n] : 0;
+}
+
+ACE_INLINE int
+ACE_Sharded_Reactor::thread_shard (void) const
+{
+  size_t const n = *this->thread_shard_;
+  return n == 0 ? -1 : static_cast<int> (n - 1);
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
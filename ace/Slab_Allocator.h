@@ -0,0 +1,34 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Slab_Allocator.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+
+#ifndef ACE_SLAB_ALLOCATOR_H
+#define ACE_SLAB_ALLOCATOR_H
+#include /**/ "ace/pre.h"
+
+#include "ace/Slab_Allocator_T.h"
+#include "ace/Synch_Traits.h"
+#include "ace/Thread_Mutex.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// The following typedef is here for ease of use.
+
+/// A slab allocator that can be shared by several threads.
+typedef ACE_Slab_Allocator_T<ACE_SYNCH_MUTEX> ACE_Slab_Allocator;
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#include /**/ "ace/post.h"
+#endif /* ACE_SLAB_ALLOCATOR_H */
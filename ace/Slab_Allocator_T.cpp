@@ -0,0 +1,291 @@
+// $Id$
+
+#ifndef ACE_SLAB_ALLOCATOR_T_CPP
+#define ACE_SLAB_ALLOCATOR_T_CPP
+
+#include "ace/Slab_Allocator_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Malloc.h"
+#include "ace/Guard_T.h"
+#include "ace/Log_Category.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_string.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Slab_Allocator_T)
+
+// Powers of two and the sizes halfway between them, up to a 64K
+// payload together with its headers, message block and data block.
+template <class ACE_LOCK> size_t const
+ACE_Slab_Allocator_T<ACE_LOCK>::class_size_[class_count] =
+{
+  32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048,
+  3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768, 49152,
+  65536 + 512
+};
+
+template <class ACE_LOCK>
+ACE_Slab_Allocator_T<ACE_LOCK>::ACE_Slab_Allocator_T (size_t slab_size,
+                                                      ACE_Allocator *backing)
+  : header_size_ (ACE_MALLOC_ROUNDUP (sizeof (Chunk_Header),
+                                      ACE_MALLOC_ALIGN)),
+    slab_size_ (slab_size),
+    backing_ (backing == 0 ? ACE_Allocator::instance () : backing),
+    slabs_ (0),
+    slab_count_ (0)
+{
+  for (u_int c = 0; c < class_count; ++c)
+    this->classes_[c].free_ = 0;
+
+  u_int c = 0;
+  for (size_t i = 0; i <= (lookup_limit >> lookup_shift); ++i)
+    {
+      while (class_size_[c] < (i << lookup_shift))
+        ++c;
+      this->lookup_[i] = static_cast<u_char> (c);
+    }
+}
+
+template <class ACE_LOCK>
+ACE_Slab_Allocator_T<ACE_LOCK>::~ACE_Slab_Allocator_T (void)
+{
+  while (this->slabs_ != 0)
+    {
+      Slab *const slab = this->slabs_;
+      this->slabs_ = slab->next_;
+      this->backing_->free (slab);
+    }
+  this->slab_count_ = 0;
+}
+
+// Returns the smallest size class with chunks of at least @a size
+// bytes, or large_class.
+
+template <class ACE_LOCK> u_int
+ACE_Slab_Allocator_T<ACE_LOCK>::size_class (size_t size) const
+{
+  if (size <= lookup_limit)
+    return this->lookup_[(size + (1 << lookup_shift) - 1) >> lookup_shift];
+
+  u_int c = this->lookup_[lookup_limit >> lookup_shift];
+  while (c < class_count && class_size_[c] < size)
+    ++c;
+  return c;
+}
+
+// Allocates a chunk of at least @a size bytes, header included, and
+// returns its header.
+
+template <class ACE_LOCK>
+typename ACE_Slab_Allocator_T<ACE_LOCK>::Chunk_Header *
+ACE_Slab_Allocator_T<ACE_LOCK>::allocate (size_t size)
+{
+  u_int const c = this->size_class (size);
+  Chunk_Header *header = 0;
+
+  if (c == large_class)
+    {
+      header = static_cast<Chunk_Header *> (this->backing_->malloc (size));
+      if (header == 0)
+        {
+          errno = ENOMEM;
+          return 0;
+        }
+    }
+  else
+    {
+      Size_Class &sc = this->classes_[c];
+      ACE_GUARD_RETURN (ACE_LOCK, ace_mon, sc.lock_, 0);
+      if (sc.free_ == 0 && this->grow (c) == -1)
+        return 0;
+      Free_Chunk *const chunk = sc.free_;
+      sc.free_ = chunk->next_;
+      header = reinterpret_cast<Chunk_Header *> (chunk);
+    }
+
+  header->class_ = c;
+  header->offset_ = 0;
+  header->parts_ = 0;
+  return header;
+}
+
+// Carves a new slab into chunks of class @a c.  The lock of the class
+// is held by the caller.
+
+template <class ACE_LOCK> int
+ACE_Slab_Allocator_T<ACE_LOCK>::grow (u_int c)
+{
+  size_t const chunk_size = class_size_[c];
+  size_t size = this->slab_size_;
+  if (size < 4 * chunk_size)
+    size = 4 * chunk_size;
+  size += this->header_size_;
+
+  char *const slab = static_cast<char *> (this->backing_->malloc (size));
+  if (slab == 0)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+
+  {
+    ACE_GUARD_RETURN (ACE_LOCK, ace_mon, this->slab_lock_, -1);
+    reinterpret_cast<Slab *> (slab)->next_ = this->slabs_;
+    this->slabs_ = reinterpret_cast<Slab *> (slab);
+    ++this->slab_count_;
+  }
+
+  // Chain the chunks in address order.
+  Size_Class &sc = this->classes_[c];
+  size_t const count = (size - this->header_size_) / chunk_size;
+  char *chunk = slab + this->header_size_ + (count - 1) * chunk_size;
+  for (size_t i = 0; i < count; ++i, chunk -= chunk_size)
+    {
+      Free_Chunk *const free_chunk = reinterpret_cast<Free_Chunk *> (chunk);
+      free_chunk->next_ = sc.free_;
+      sc.free_ = free_chunk;
+    }
+  return 0;
+}
+
+// Gives the chunk of @a header back, once all its parts are released.
+
+template <class ACE_LOCK> void
+ACE_Slab_Allocator_T<ACE_LOCK>::release (Chunk_Header *header)
+{
+  u_int const c = header->class_;
+
+  if (c == large_class)
+    {
+      if (header->parts_ != 0)
+        {
+          ACE_GUARD (ACE_LOCK, ace_mon, this->slab_lock_);
+          if (--header->parts_ > 0)
+            return;
+        }
+      this->backing_->free (header);
+      return;
+    }
+
+  Size_Class &sc = this->classes_[c];
+  ACE_GUARD (ACE_LOCK, ace_mon, sc.lock_);
+  if (header->parts_ != 0 && --header->parts_ > 0)
+    return;
+  Free_Chunk *const chunk = reinterpret_cast<Free_Chunk *> (header);
+  chunk->next_ = sc.free_;
+  sc.free_ = chunk;
+}
+
+template <class ACE_LOCK> void *
+ACE_Slab_Allocator_T<ACE_LOCK>::malloc (size_t nbytes)
+{
+  Chunk_Header *const header = this->allocate (nbytes + this->header_size_);
+  if (header == 0)
+    return 0;
+  return reinterpret_cast<char *> (header) + this->header_size_;
+}
+
+template <class ACE_LOCK> void *
+ACE_Slab_Allocator_T<ACE_LOCK>::calloc (size_t nbytes,
+                            char initial_value)
+{
+  void *const ptr = this->malloc (nbytes);
+  if (ptr != 0)
+    ACE_OS::memset (ptr, initial_value, nbytes);
+  return ptr;
+}
+
+template <class ACE_LOCK> void *
+ACE_Slab_Allocator_T<ACE_LOCK>::calloc (size_t n_elem,
+                            size_t elem_size,
+                            char initial_value)
+{
+  return this->calloc (n_elem * elem_size, initial_value);
+}
+
+template <class ACE_LOCK> void
+ACE_Slab_Allocator_T<ACE_LOCK>::free (void *ptr)
+{
+  if (ptr == 0)
+    return;
+
+  char *const part = static_cast<char *> (ptr) - this->header_size_;
+  Chunk_Header *const header = reinterpret_cast<Chunk_Header *> (part);
+  this->release (reinterpret_cast<Chunk_Header *> (part - header->offset_));
+}
+
+template <class ACE_LOCK> ACE_Message_Block *
+ACE_Slab_Allocator_T<ACE_LOCK>::message_block (size_t size,
+                                   ACE_Message_Block::ACE_Message_Type type,
+                                   ACE_Lock *locking_strategy,
+                                   unsigned long priority)
+{
+  // The chunk holds, each aligned, its header, the message block, the
+  // header of the data block part, the data block and the buffer.
+  size_t const mb_offset = this->header_size_;
+  size_t const db_header_offset =
+    mb_offset + ACE_MALLOC_ROUNDUP (sizeof (ACE_Message_Block),
+                                    ACE_MALLOC_ALIGN);
+  size_t const db_offset = db_header_offset + this->header_size_;
+  size_t const buffer_offset =
+    db_offset + ACE_MALLOC_ROUNDUP (sizeof (ACE_Data_Block),
+                                    ACE_MALLOC_ALIGN);
+
+  Chunk_Header *const header = this->allocate (buffer_offset + size);
+  if (header == 0)
+    return 0;
+
+  // The message block and the data block are released separately; the
+  // chunk goes back when both are.
+  char *const chunk = reinterpret_cast<char *> (header);
+  header->parts_ = 2;
+  Chunk_Header *const db_header =
+    reinterpret_cast<Chunk_Header *> (chunk + db_header_offset);
+  db_header->class_ = header->class_;
+  db_header->offset_ = static_cast<ACE_UINT32> (db_header_offset);
+  db_header->parts_ = 0;
+
+  // The buffer is part of the chunk, so the data block must not free
+  // it; it still uses this allocator if it is resized.
+  ACE_Data_Block *const db =
+    new (chunk + db_offset) ACE_Data_Block (size,
+                                            type,
+                                            chunk + buffer_offset,
+                                            this,
+                                            locking_strategy,
+                                            ACE_Message_Block::DONT_DELETE,
+                                            this);
+  ACE_Message_Block *const mb =
+    new (chunk + mb_offset) ACE_Message_Block (db, 0, this);
+  mb->msg_priority (priority);
+  return mb;
+}
+
+template <class ACE_LOCK> size_t
+ACE_Slab_Allocator_T<ACE_LOCK>::slab_count (void)
+{
+  ACE_GUARD_RETURN (ACE_LOCK, ace_mon, this->slab_lock_, 0);
+  return this->slab_count_;
+}
+
+template <class ACE_LOCK> void
+ACE_Slab_Allocator_T<ACE_LOCK>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Slab_Allocator_T<ACE_LOCK>::dump");
+
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("slab_size_ = %B\n"), this->slab_size_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("slab_count_ = %B\n"), this->slab_count_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_SLAB_ALLOCATOR_T_CPP */
@@ -0,0 +1,211 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Slab_Allocator_T.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+#ifndef ACE_SLAB_ALLOCATOR_T_H
+#define ACE_SLAB_ALLOCATOR_T_H
+#include /**/ "ace/pre.h"
+
+#include "ace/Malloc_Allocator.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/Message_Block.h"
+#include "ace/Default_Constants.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Slab_Allocator_T
+ *
+ * @brief A general purpose allocator that serves requests from size
+ * classes carved out of large slabs.
+ *
+ * Requests are rounded up to one of a fixed set of size classes,
+ * from 32 bytes to a 64K payload with its message block and data
+ * block, each at most half as large again as the one before it so
+ * that no more than a third of a chunk goes to waste.  Each class has
+ * a free list and a lock of its own; when its free list runs out, a
+ * new slab is taken from the backing allocator and carved into chunks.
+ * Slabs are only returned to the backing allocator when the slab
+ * allocator is destroyed.  Larger requests go straight to the backing
+ * allocator.
+ *
+ * An ACE_Slab_Allocator can be passed as any or all of the message
+ * block, data block and buffer allocators of an ACE_Message_Block.
+ * Better still, message_block() allocates an ACE_Message_Block, its
+ * ACE_Data_Block and its buffer together in a single chunk, so a
+ * message costs one allocation instead of three.
+ *
+ * Each size class is serialized by its own @a ACE_LOCK, e.g.
+ * ACE_Thread_Mutex, or ACE_Null_Mutex for an allocator used by a
+ * single thread.
+ *
+ * @sa ACE_Slab_Allocator
+ */
+template <class ACE_LOCK>
+class ACE_Slab_Allocator_T : public ACE_New_Allocator
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param slab_size  Size of the slabs the chunks are carved from.
+   *                   The slabs of the larger size classes hold at
+   *                   least four chunks.
+   * @param backing    Allocator the slabs come from.  If 0,
+   *                   ACE_Allocator::instance() is used.
+   */
+  ACE_Slab_Allocator_T (size_t slab_size = ACE_DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE,
+                        ACE_Allocator *backing = 0);
+
+  /// Return all the slabs to the backing allocator.
+  virtual ~ACE_Slab_Allocator_T (void);
+
+  /// Allocate @a nbytes from the smallest size class that fits.
+  virtual void *malloc (size_t nbytes);
+
+  /// Allocate @a nbytes, giving them @a initial_value.
+  virtual void *calloc (size_t nbytes,
+                        char initial_value = '\0');
+
+  /// Allocate @a n_elem elements of @a elem_size bytes, giving them
+  /// @a initial_value.
+  virtual void *calloc (size_t n_elem,
+                        size_t elem_size,
+                        char initial_value = '\0');
+
+  /// Return @a ptr to its size class.
+  virtual void free (void *ptr);
+
+  /**
+   * Allocate an ACE_Message_Block with a buffer of @a size bytes, the
+   * message block, its data block and the buffer all in one chunk.
+   * This allocator is used as the allocator of all three, so that
+   * duplicate() and clone() also allocate from it, and the chunk is
+   * freed once both the message block and the data block have been
+   * released.  Returns 0 if out of memory.
+   */
+  ACE_Message_Block *message_block (size_t size,
+                                    ACE_Message_Block::ACE_Message_Type type = ACE_Message_Block::MB_DATA,
+                                    ACE_Lock *locking_strategy = 0,
+                                    unsigned long priority = ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY);
+
+  /// Number of slabs taken from the backing allocator so far.
+  size_t slab_count (void);
+
+  /// Dump the state of an object.
+  virtual void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// Precedes every chunk, and each part of a chunk shared by a
+  /// message block and its data block.
+  struct Chunk_Header
+  {
+    /// Size class of the chunk, or large_class for the chunks of the
+    /// backing allocator.
+    ACE_UINT32 class_;
+
+    /// Distance back to the header of the chunk, 0 in the header of
+    /// the chunk itself.
+    ACE_UINT32 offset_;
+
+    /// Number of parts of the chunk still in use, or 0 if the chunk
+    /// isn't shared.
+    ACE_UINT32 parts_;
+  };
+
+  /// A free chunk in the free list of its class.
+  struct Free_Chunk
+  {
+    Free_Chunk *next_;
+  };
+
+  /// A slab, in the list of slabs.
+  struct Slab
+  {
+    Slab *next_;
+  };
+
+  /// The free list of a size class.
+  struct Size_Class
+  {
+    ACE_LOCK lock_;
+    Free_Chunk *free_;
+  };
+
+  enum
+  {
+    /// Number of size classes.
+    class_count = 23,
+
+    /// Class of the chunks too large for any size class.
+    large_class = class_count,
+
+    /// Granularity of <lookup_>.
+    lookup_shift = 4,
+
+    /// Requests up to this size are classified by <lookup_>.
+    lookup_limit = 4096
+  };
+
+  // The following are documented in the .cpp file.
+  u_int size_class (size_t size) const;
+  Chunk_Header *allocate (size_t size);
+  int grow (u_int c);
+  void release (Chunk_Header *header);
+
+  /// Chunk sizes of the size classes, headers included.
+  static size_t const class_size_[class_count];
+
+  /// Size class of each request size up to lookup_limit, in steps of
+  /// 1 << lookup_shift.
+  u_char lookup_[(lookup_limit >> lookup_shift) + 1];
+
+  /// Size of the chunk headers, rounded up for alignment.
+  size_t const header_size_;
+
+  /// Size of the slabs.
+  size_t const slab_size_;
+
+  /// Where the slabs and the large chunks come from.
+  ACE_Allocator *backing_;
+
+  Size_Class classes_[class_count];
+
+  /// Serializes the list of slabs, and the release of large shared
+  /// chunks.
+  ACE_LOCK slab_lock_;
+
+  /// The slabs.
+  Slab *slabs_;
+  size_t slab_count_;
+
+  // = Disallow copying.
+  ACE_UNIMPLEMENTED_FUNC (ACE_Slab_Allocator_T (const ACE_Slab_Allocator_T<ACE_LOCK> &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Slab_Allocator_T<ACE_LOCK> &))
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/Slab_Allocator_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("Slab_Allocator_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_SLAB_ALLOCATOR_T_H */
@@ -98,6 +98,15 @@ ACE_Stream<ACE_SYNCH_USE, TIME_POLICY>::get (ACE_Message_Block *&mb, ACE_Time_Va
   return this->stream_head_->reader ()->getq (mb, tv);
 }
 
+template <ACE_SYNCH_DECL, class TIME_POLICY> int
+ACE_Stream<ACE_SYNCH_USE, TIME_POLICY>::get_batch (ACE_Message_Block *&mb,
+                                                   size_t max_count,
+                                                   ACE_Time_Value *tv)
+{
+  ACE_TRACE ("ACE_Stream<ACE_SYNCH_USE, TIME_POLICY>::get_batch");
+  return this->stream_head_->reader ()->getq_batch (mb, max_count, tv);
+}
+
 // Return the "top" ACE_Module in a ACE_Stream, skipping over the
 // stream_head.
 
@@ -151,6 +151,17 @@ public:
   virtual int get (ACE_Message_Block *&mb,
                    ACE_Time_Value *timeout = 0);
 
+  /**
+   * Read up to @a max_count messages stored in the stream head, linked
+   * through their next() pointers, under a single lock acquisition.
+   * Wait for upto @a timeout amount of absolute time for the first
+   * one (or block forever if @a timeout == 0).  Returns the number of
+   * messages read or -1 on failure.
+   */
+  virtual int get_batch (ACE_Message_Block *&mb,
+                         size_t max_count,
+                         ACE_Time_Value *timeout = 0);
+
   /// Send control message down the stream.
   virtual int control (ACE_IO_Cntl_Msg::ACE_IO_Cntl_Cmds cmd,
                        void *args);
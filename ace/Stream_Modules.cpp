@@ -122,6 +122,11 @@ ACE_Stream_Head<ACE_SYNCH_USE, TIME_POLICY>::put (ACE_Message_Block *mb,
           break;
         }
 
+      // A series of messages linked through next() is queued as a
+      // whole, waking up all the readers.
+      if (mb->next () != 0)
+        return this->putq_chain (mb, tv);
+
       return this->putq (mb, tv);
     }
 }
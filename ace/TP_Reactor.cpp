@@ -8,6 +8,10 @@
 #include "ace/Functor_T.h"
 #include "ace/OS_NS_sys_time.h"
 
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+#include "ace/Reactor_Instrumentation.h"
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
 #if !defined (__ACE_INLINE__)
 #include "ace/TP_Reactor.inl"
 #endif /* __ACE_INLINE__ */
@@ -310,6 +314,28 @@ ACE_TP_Reactor::handle_timer_events (int & /*event_count*/,
   typedef ACE_Member_Function_Command<ACE_TP_Token_Guard> Guard_Release;
 
   Guard_Release release(guard, &ACE_TP_Token_Guard::release_token);
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_Reactor_Instrumentation *const instrumentation =
+    this->instrumentation_;
+  if (instrumentation != 0 && !this->timer_queue_->is_empty ())
+    {
+      // We hold the token, so the earliest timer is the one
+      // expire_single() dispatches, if it is due.
+      ACE_Time_Value const now = this->timer_queue_->gettimeofday ();
+      ACE_Time_Value const expiry = this->timer_queue_->earliest_time ();
+      ACE_hrtime_t const start = instrumentation->start ();
+      int const result = this->timer_queue_->expire_single(release);
+      if (result > 0)
+        {
+          instrumentation->timer_expired (expiry, now);
+          instrumentation->upcall (ACE_Reactor_Instrumentation::TIMEOUT,
+                                   start);
+        }
+      return result;
+    }
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   return this->timer_queue_->expire_single(release);
 }
 
@@ -540,9 +566,30 @@ ACE_TP_Reactor::dispatch_socket_event (ACE_EH_Dispatch_Info &dispatch_info)
   // ignored if the reactor state has changed. Just call back
   // as many times as the handler requests it. Other threads are off
   // handling other things.
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+  ACE_Reactor_Instrumentation *const instrumentation =
+    event_handler == this->notify_handler_ ? 0 : this->instrumentation_;
+  const char *const type =
+    instrumentation == 0 ? 0 : instrumentation->handler_type (event_handler);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+
   int status = 1;
   while (status > 0)
-    status = (event_handler->*callback) (dispatch_info.handle_);
+    {
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      ACE_hrtime_t const start =
+        instrumentation == 0 ? 0 : instrumentation->start ();
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+      status = (event_handler->*callback) (dispatch_info.handle_);
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+      if (instrumentation != 0)
+        instrumentation->upcall (
+          ACE_Reactor_Instrumentation::upcall_type (dispatch_info.mask_),
+          start,
+          type,
+          dispatch_info.handle_);
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
+    }
 
   // Post process socket event
   return this->post_process_socket_event (dispatch_info, status);
@@ -0,0 +1,269 @@
+// $Id$
+
+#include "ace/TSS_Cached_Allocator.h"
+#include "ace/Malloc.h"
+#include "ace/Log_Category.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_string.h"
+
+#if !defined (__ACE_INLINE__)
+#include "ace/TSS_Cached_Allocator.inl"
+#endif /* __ACE_INLINE__ */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_ALLOC_HOOK_DEFINE(ACE_TSS_Cached_Allocator)
+
+ACE_TSS_Cached_Allocator::Cache::Cache (void)
+  : owner_ (0),
+    chunks_ (0),
+    count_ (0),
+    spare_ (0)
+{
+}
+
+ACE_TSS_Cached_Allocator::Cache::~Cache (void)
+{
+  // The thread is exiting: give its chunks to the other threads.
+  if (this->owner_ != 0)
+    this->owner_->flush_i (*this);
+}
+
+ACE_TSS_Cached_Allocator::ACE_TSS_Cached_Allocator (size_t chunk_size,
+                                                    size_t n_chunks,
+                                                    size_t magazine_size,
+                                                    ACE_Allocator *backing)
+  : chunk_size_ (ACE_MALLOC_ROUNDUP ((chunk_size < sizeof (Chunk)
+                                      ? sizeof (Chunk)
+                                      : chunk_size),
+                                     ACE_MALLOC_ALIGN)),
+    magazine_size_ (magazine_size == 0 ? 1 : magazine_size),
+    backing_ (backing == 0 ? ACE_Allocator::instance () : backing),
+    depot_ (0),
+    depot_chunks_ (0)
+{
+  while (n_chunks > 0)
+    {
+      size_t const count =
+        n_chunks < this->magazine_size_ ? n_chunks : this->magazine_size_;
+      Chunk *magazine = 0;
+      for (size_t i = 0; i < count; ++i)
+        {
+          Chunk *const chunk =
+            static_cast<Chunk *> (this->backing_->malloc (this->chunk_size_));
+          if (chunk == 0)
+            {
+              ACELIB_ERROR ((LM_ERROR,
+                             ACE_TEXT ("ACE_TSS_Cached_Allocator: %p\n"),
+                             ACE_TEXT ("malloc")));
+              if (magazine != 0)
+                this->deposit (magazine, i);
+              return;
+            }
+          chunk->next_ = magazine;
+          magazine = chunk;
+        }
+      this->deposit (magazine, count);
+      n_chunks -= count;
+    }
+}
+
+ACE_TSS_Cached_Allocator::~ACE_TSS_Cached_Allocator (void)
+{
+  // The cache of the calling thread is deleted with <cache_>, after
+  // the depot is gone; empty it now.  The caches of the threads still
+  // running are lost.
+  Cache *const cache = this->cache_.ts_object ();
+  if (cache != 0)
+    {
+      this->flush_i (*cache);
+      cache->owner_ = 0;
+    }
+
+  while (this->depot_ != 0)
+    {
+      Chunk *chunk = this->depot_;
+      this->depot_ = chunk->next_magazine_;
+      while (chunk != 0)
+        {
+          Chunk *const next = chunk->next_;
+          this->backing_->free (chunk);
+          chunk = next;
+        }
+    }
+  this->depot_chunks_ = 0;
+}
+
+ACE_TSS_Cached_Allocator::Cache *
+ACE_TSS_Cached_Allocator::cache (void)
+{
+  Cache *const cache = this->cache_;
+  if (cache != 0 && cache->owner_ == 0)
+    cache->owner_ = this;
+  return cache;
+}
+
+void *
+ACE_TSS_Cached_Allocator::malloc (size_t nbytes)
+{
+  // Check if size requested fits within pre-determined size.
+  if (nbytes > this->chunk_size_)
+    return 0;
+
+  Cache *const cache = this->cache ();
+  if (cache == 0)
+    return 0;
+
+  if (cache->count_ == 0)
+    {
+      if (cache->spare_ != 0)
+        {
+          cache->chunks_ = cache->spare_;
+          cache->count_ = cache->spare_->count_;
+          cache->spare_ = 0;
+        }
+      else if (this->refill (*cache) == -1)
+        return 0;
+    }
+
+  Chunk *const chunk = cache->chunks_;
+  cache->chunks_ = chunk->next_;
+  --cache->count_;
+  return chunk;
+}
+
+void *
+ACE_TSS_Cached_Allocator::calloc (size_t nbytes,
+                                  char initial_value)
+{
+  void *const ptr = this->malloc (nbytes);
+  if (ptr != 0)
+    ACE_OS::memset (ptr, initial_value, this->chunk_size_);
+  return ptr;
+}
+
+void *
+ACE_TSS_Cached_Allocator::calloc (size_t, size_t, char)
+{
+  ACE_NOTSUP_RETURN (0);
+}
+
+void
+ACE_TSS_Cached_Allocator::free (void *ptr)
+{
+  if (ptr == 0)
+    return;
+
+  Cache *const cache = this->cache ();
+  if (cache == 0)
+    {
+      // No thread-specific storage left; go to the depot directly.
+      Chunk *const chunk = static_cast<Chunk *> (ptr);
+      chunk->next_ = 0;
+      this->deposit (chunk, 1);
+      return;
+    }
+
+  if (cache->count_ >= this->magazine_size_)
+    {
+      // Both magazines are full: the spare goes to the depot and the
+      // one in use becomes the spare.
+      if (cache->spare_ != 0)
+        this->deposit (cache->spare_, cache->spare_->count_);
+      cache->spare_ = cache->chunks_;
+      cache->spare_->count_ = cache->count_;
+      cache->chunks_ = 0;
+      cache->count_ = 0;
+    }
+
+  Chunk *const chunk = static_cast<Chunk *> (ptr);
+  chunk->next_ = cache->chunks_;
+  cache->chunks_ = chunk;
+  ++cache->count_;
+}
+
+void
+ACE_TSS_Cached_Allocator::flush (void)
+{
+  Cache *const cache = this->cache_.ts_object ();
+  if (cache != 0)
+    this->flush_i (*cache);
+}
+
+int
+ACE_TSS_Cached_Allocator::refill (Cache &cache)
+{
+  {
+    ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, -1);
+    if (this->depot_ != 0)
+      {
+        Chunk *const magazine = this->depot_;
+        this->depot_ = magazine->next_magazine_;
+        this->depot_chunks_ -= magazine->count_;
+        cache.chunks_ = magazine;
+        cache.count_ = magazine->count_;
+        return 0;
+      }
+  }
+
+  // The depot is empty: get a whole magazine of new chunks at once,
+  // without holding up the other threads.
+  for (size_t i = 0; i < this->magazine_size_; ++i)
+    {
+      Chunk *const chunk =
+        static_cast<Chunk *> (this->backing_->malloc (this->chunk_size_));
+      if (chunk == 0)
+        break;
+      chunk->next_ = cache.chunks_;
+      cache.chunks_ = chunk;
+      ++cache.count_;
+    }
+
+  if (cache.count_ == 0)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+  return 0;
+}
+
+void
+ACE_TSS_Cached_Allocator::deposit (Chunk *magazine, size_t count)
+{
+  magazine->count_ = count;
+
+  ACE_GUARD (ACE_SYNCH_MUTEX, ace_mon, this->lock_);
+  magazine->next_magazine_ = this->depot_;
+  this->depot_ = magazine;
+  this->depot_chunks_ += count;
+}
+
+void
+ACE_TSS_Cached_Allocator::flush_i (Cache &cache)
+{
+  if (cache.count_ > 0)
+    this->deposit (cache.chunks_, cache.count_);
+  if (cache.spare_ != 0)
+    this->deposit (cache.spare_, cache.spare_->count_);
+  cache.chunks_ = 0;
+  cache.count_ = 0;
+  cache.spare_ = 0;
+}
+
+void
+ACE_TSS_Cached_Allocator::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_TSS_Cached_Allocator::dump");
+
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("chunk_size_ = %B\n"), this->chunk_size_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("magazine_size_ = %B\n"),
+                 this->magazine_size_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("depot_chunks_ = %B\n"),
+                 this->depot_chunks_));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
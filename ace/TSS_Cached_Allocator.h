@@ -0,0 +1,218 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    TSS_Cached_Allocator.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+#ifndef ACE_TSS_CACHED_ALLOCATOR_H
+#define ACE_TSS_CACHED_ALLOCATOR_H
+#include /**/ "ace/pre.h"
+
+#include "ace/Malloc_Allocator.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/TSS_T.h"
+#include "ace/Synch_Traits.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Guard_T.h"
+#include "ace/Default_Constants.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_TSS_Cached_Allocator
+ *
+ * @brief A fixed-size allocator with a cache of free chunks in each
+ * thread.
+ *
+ * ACE_Cached_Allocator and ACE_Dynamic_Cached_Allocator serialize
+ * every malloc() and free() on the lock of their free list, which
+ * becomes a bottleneck when many threads allocate at once.  This
+ * allocator puts a cache of free chunks in thread-specific storage in
+ * front of a shared depot: malloc() and free() only use the cache of
+ * the calling thread, without locking.  Chunks move between the caches
+ * and the depot a magazine at a time, i.e., @c magazine_size chunks
+ * for one acquisition of the depot lock.  When the depot runs out,
+ * a magazine of new chunks is allocated from the backing allocator,
+ * such as an ACE_Cached_Allocator or an ACE_Malloc, which thus sees
+ * one request in @c magazine_size.  Chunks freed by another thread
+ * than the one that allocated them simply join the cache of that
+ * thread.
+ *
+ * Each thread caches up to two magazines.  When a thread exits its
+ * cache goes back to the depot.  The chunks in the depot are returned
+ * to the backing allocator when this allocator is destroyed, which
+ * must happen once the threads that use it are done with it.
+ *
+ * To take ACE_Message_Block allocation off the global heap and its
+ * lock, use one allocator for the message blocks, one for the data
+ * blocks and, for buffers of a known maximum size, one for the data:
+ * @code
+ * ACE_TSS_Cached_Allocator mb_allocator (sizeof (ACE_Message_Block));
+ * ACE_TSS_Cached_Allocator db_allocator (sizeof (ACE_Data_Block));
+ * ACE_TSS_Cached_Allocator buffer_allocator (4096);
+ *
+ * ACE_Message_Block *mb = 0;
+ * ACE_NEW_MALLOC (mb,
+ *                 static_cast<ACE_Message_Block *> (
+ *                   mb_allocator.malloc (sizeof (ACE_Message_Block))),
+ *                 ACE_Message_Block (4096,
+ *                                    ACE_Message_Block::MB_DATA,
+ *                                    0, 0,
+ *                                    &buffer_allocator,
+ *                                    0,
+ *                                    ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
+ *                                    ACE_Time_Value::zero,
+ *                                    ACE_Time_Value::max_time,
+ *                                    &db_allocator,
+ *                                    &mb_allocator));
+ * @endcode
+ *
+ * @sa ACE_Dynamic_Cached_Allocator
+ */
+class ACE_Export ACE_TSS_Cached_Allocator : public ACE_New_Allocator
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param chunk_size     Size of the chunks.  It is rounded up to
+   *                       make room for the bookkeeping of free chunks
+   *                       and for alignment; see chunk_size().
+   * @param n_chunks       Number of chunks to put in the depot right
+   *                       away.
+   * @param magazine_size  Number of chunks moved at a time between the
+   *                       thread caches and the depot.
+   * @param backing        Allocator the chunks come from.  It must be
+   *                       able to allocate chunk_size() bytes.  If 0,
+   *                       ACE_Allocator::instance() is used.
+   */
+  ACE_TSS_Cached_Allocator (size_t chunk_size,
+                            size_t n_chunks = 0,
+                            size_t magazine_size = ACE_DEFAULT_TSS_CACHED_ALLOCATOR_MAGAZINE_SIZE,
+                            ACE_Allocator *backing = 0);
+
+  /// Return the cache of the calling thread to the depot, and all the
+  /// chunks in the depot to the backing allocator.
+  virtual ~ACE_TSS_Cached_Allocator (void);
+
+  /**
+   * Get a chunk of memory from the cache of the calling thread.  Note
+   * that @a nbytes is only checked to make sure that it's less or equal
+   * to chunk_size(), and is otherwise ignored since malloc() always
+   * returns a chunk of chunk_size() bytes.
+   */
+  virtual void *malloc (size_t nbytes = 0);
+
+  /**
+   * Get a chunk of memory from the cache of the calling thread, giving
+   * it @a initial_value.  Note that @a nbytes is only checked to make
+   * sure that it's less or equal to chunk_size().
+   */
+  virtual void *calloc (size_t nbytes,
+                        char initial_value = '\0');
+
+  /// This method is a no-op and just returns 0 since the allocator
+  /// only works with fixed sized entities.
+  virtual void *calloc (size_t n_elem,
+                        size_t elem_size,
+                        char initial_value = '\0');
+
+  /// Return a chunk of memory to the cache of the calling thread.
+  virtual void free (void *);
+
+  /// Return the cache of the calling thread to the depot, e.g., before
+  /// a thread that wasn't spawned by ACE exits.
+  void flush (void);
+
+  /// Return the number of chunks in the depot, not counting those in
+  /// the thread caches.
+  size_t pool_depth (void);
+
+  /// Size of the chunks.
+  size_t chunk_size (void) const;
+
+  /// Dump the state of an object.
+  virtual void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// A free chunk.  The first chunk of a magazine also chains the
+  /// magazines of the depot and holds the size of its magazine.
+  struct Chunk
+  {
+    Chunk *next_;
+    Chunk *next_magazine_;
+    size_t count_;
+  };
+
+  /// The chunks cached by a thread: a magazine in use and a full
+  /// spare one.
+  struct Cache
+  {
+    Cache (void);
+    ~Cache (void);
+
+    ACE_TSS_Cached_Allocator *owner_;
+    Chunk *chunks_;
+    size_t count_;
+    Chunk *spare_;
+  };
+
+  /// Get the cache of the calling thread.
+  Cache *cache (void);
+
+  /// Fill the empty cache @a cache with a magazine from the depot or
+  /// the backing allocator.
+  int refill (Cache &cache);
+
+  /// Put the magazine of @a count chunks starting at @a magazine in the
+  /// depot.
+  void deposit (Chunk *magazine, size_t count);
+
+  /// Return all the chunks of @a cache to the depot.
+  void flush_i (Cache &cache);
+
+  /// Size of the chunks.
+  size_t const chunk_size_;
+
+  /// Number of chunks in a magazine.
+  size_t const magazine_size_;
+
+  /// Where the chunks come from.
+  ACE_Allocator *backing_;
+
+  /// The thread caches.
+  ACE_TSS<Cache> cache_;
+
+  /// Serializes access to the depot.
+  ACE_SYNCH_MUTEX lock_;
+
+  /// The magazines of the depot.
+  Chunk *depot_;
+
+  /// Number of chunks in the depot.
+  size_t depot_chunks_;
+
+  // = Disallow copying.
+  ACE_UNIMPLEMENTED_FUNC (ACE_TSS_Cached_Allocator (const ACE_TSS_Cached_Allocator &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_TSS_Cached_Allocator &))
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/TSS_Cached_Allocator.inl"
+#endif /* __ACE_INLINE__ */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_TSS_CACHED_ALLOCATOR_H */
@@ -0,0 +1,20 @@
+// -*- C++ -*-
+//
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE size_t
+ACE_TSS_Cached_Allocator::chunk_size (void) const
+{
+  return this->chunk_size_;
+}
+
+ACE_INLINE size_t
+ACE_TSS_Cached_Allocator::pool_depth (void)
+{
+  ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->lock_, 0);
+  return this->depot_chunks_;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
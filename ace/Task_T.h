@@ -95,6 +95,23 @@ public: // Should be protected:
    */
   int getq (ACE_Message_Block *&mb, ACE_Time_Value *timeout = 0);
 
+  /// Insert a series of messages linked through their next() pointers
+  /// into the message queue, taking the queue lock only once.  Note
+  /// that @a timeout uses <{absolute}> time rather than <{relative}>
+  /// time.
+  int putq_chain (ACE_Message_Block *, ACE_Time_Value *timeout = 0);
+
+  /**
+   * Extract up to @a max_count messages from the queue (blocking
+   * until there is at least one), linked through their next()
+   * pointers.  Note that @a timeout uses <{absolute}> time rather
+   * than <{relative}> time.  Returns the number of messages extracted
+   * if the call succeeds or -1 otherwise.
+   */
+  int getq_batch (ACE_Message_Block *&mb,
+                  size_t max_count,
+                  ACE_Time_Value *timeout = 0);
+
   /// Return a message to the queue.  Note that @a timeout uses
   /// <{absolute}> time rather than <{relative}> time.
   int ungetq (ACE_Message_Block *, ACE_Time_Value *timeout = 0);
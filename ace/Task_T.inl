@@ -29,6 +29,22 @@ ACE_Task<ACE_SYNCH_USE, TIME_POLICY>::putq (ACE_Message_Block *mb, ACE_Time_Valu
   return this->msg_queue_->enqueue_tail (mb, tv);
 }
 
+template <ACE_SYNCH_DECL, class TIME_POLICY> ACE_INLINE int
+ACE_Task<ACE_SYNCH_USE, TIME_POLICY>::getq_batch (ACE_Message_Block *&mb,
+                                                  size_t max_count,
+                                                  ACE_Time_Value *tv)
+{
+  ACE_TRACE ("ACE_Task<ACE_SYNCH_USE, TIME_POLICY>::getq_batch");
+  return this->msg_queue_->dequeue_batch (mb, max_count, tv);
+}
+
+template <ACE_SYNCH_DECL, class TIME_POLICY> ACE_INLINE int
+ACE_Task<ACE_SYNCH_USE, TIME_POLICY>::putq_chain (ACE_Message_Block *mb, ACE_Time_Value *tv)
+{
+  ACE_TRACE ("ACE_Task<ACE_SYNCH_USE, TIME_POLICY>::putq_chain");
+  return this->msg_queue_->enqueue_chain (mb, tv);
+}
+
 template <ACE_SYNCH_DECL, class TIME_POLICY> ACE_INLINE int
 ACE_Task<ACE_SYNCH_USE, TIME_POLICY>::ungetq (ACE_Message_Block *mb, ACE_Time_Value *tv)
 {
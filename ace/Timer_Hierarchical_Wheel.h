@@ -0,0 +1,41 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Timer_Hierarchical_Wheel.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+
+#ifndef ACE_TIMER_HIERARCHICAL_WHEEL_H
+#define ACE_TIMER_HIERARCHICAL_WHEEL_H
+#include /**/ "ace/pre.h"
+
+#include "ace/Timer_Hierarchical_Wheel_T.h"
+#include "ace/Event_Handler_Handle_Timeout_Upcall.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// The following typedefs are here for ease of use.
+
+typedef ACE_Timer_Hierarchical_Wheel_T<ACE_Event_Handler *,
+                                       ACE_Event_Handler_Handle_Timeout_Upcall,
+                                       ACE_SYNCH_RECURSIVE_MUTEX>
+        ACE_Timer_Hierarchical_Wheel;
+
+typedef ACE_Timer_Hierarchical_Wheel_Iterator_T<ACE_Event_Handler *,
+                                                ACE_Event_Handler_Handle_Timeout_Upcall,
+                                                ACE_SYNCH_RECURSIVE_MUTEX,
+                                                ACE_Default_Time_Policy>
+        ACE_Timer_Hierarchical_Wheel_Iterator;
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#include /**/ "ace/post.h"
+#endif /* ACE_TIMER_HIERARCHICAL_WHEEL_H */
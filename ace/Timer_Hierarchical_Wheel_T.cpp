@@ -0,0 +1,1116 @@
+// $Id$
+
+#ifndef ACE_TIMER_HIERARCHICAL_WHEEL_T_CPP
+#define ACE_TIMER_HIERARCHICAL_WHEEL_T_CPP
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_string.h"
+#include "ace/Guard_T.h"
+#include "ace/Reverse_Lock_T.h"
+#include "ace/Numeric_Limits.h"
+#include "ace/Timer_Hierarchical_Wheel_T.h"
+#include "ace/Log_Category.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// Design/implementation notes for ACE_Timer_Hierarchical_Wheel_T.
+//
+// Expiration times are converted to ticks, and each level of the
+// wheel consumes slot_bits_ bits of the tick number.  A timer goes on
+// the lowest level on which it shares all the higher bits with the
+// current tick: on level 0 if it is due in the current run of
+// 2^slot_bits_ ticks, on level 1 if it is due in the current run of
+// 2^(2*slot_bits_) ticks, and so on, or on the overflow list if it is
+// due beyond the top level.  Its slot on that level is given by the
+// bits of its tick the level consumes.  This way every timer on a
+// level is due before every timer on the levels above, and on each
+// level the slots after the current position are in order of time.
+// Timers that are already due go to the current slot of level 0.
+//
+// When the current tick reaches the start of a slot of a higher level,
+// the timers of that slot are linked again, which moves each of them
+// down to a lower level.  The overflow list is looked at again each
+// time the top level wraps around.  The wheel only advances in
+// <expire>, jumping straight to the next slot that is not empty, with
+// the help of a bitmap of the occupied slots of each level.
+//
+// Each slot is a circular list with a dummy root node, as in
+// ACE_Timer_Wheel_T.  Lists are not sorted.  <expire> moves the timers
+// of the current slot that are due to the due list, from where they
+// are dispatched one at a time, so that handlers may schedule and
+// cancel timers, including the ones on the due list, meanwhile.
+//
+// The timer ID is an index into the <timer_ids_> table, which holds
+// the node of each timer and the list it is on.  The earliest timer is
+// cached; it is only looked up again after it has been removed.
+
+/**
+* Default Constructor that sets defaults for the resolution and the
+* shape of the wheel and doesn't do any preallocation.
+*
+* @param upcall_functor A pointer to a functor to use instead of the default
+* @param freelist       A pointer to a freelist to use instead of the default
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::ACE_Timer_Hierarchical_Wheel_T
+(FUNCTOR* upcall_functor
+ , FreeList* freelist
+ , TIME_POLICY const & time_policy
+ )
+  : Base_Timer_Queue (upcall_functor, freelist, time_policy)
+, slots_ (0)
+, occupied_ (0)
+, occupied_words_ (0)
+, resolution_ (1)
+, levels_ (0)
+, slot_bits_ (0)
+, overflow_slot_ (0)
+, due_slot_ (0)
+, current_tick_ (0)
+, timer_ids_ (0)
+, timer_ids_size_ (0)
+, timer_ids_free_ (0)
+, timer_count_ (0)
+, earliest_ (0)
+, iterator_ (0)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::ACE_Timer_Hierarchical_Wheel_T");
+  this->open_i (0,
+                ACE_Time_Value (0, ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_RESOLUTION),
+                ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_LEVELS,
+                ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_SLOT_BITS);
+}
+
+/**
+* Constructor that sets up the wheel and also may preallocate some
+* nodes on the free list.
+*
+* @param resolution     The length of a tick
+* @param levels         The number of levels of the wheel
+* @param slot_bits      Log2 of the number of slots per level
+* @param prealloc       The number of entries to prealloc in the free_list
+* @param upcall_functor A pointer to a functor to use instead of the default
+* @param freelist       A pointer to a freelist to use instead of the default
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::ACE_Timer_Hierarchical_Wheel_T
+  (const ACE_Time_Value &resolution,
+   u_int levels,
+   u_int slot_bits,
+   size_t prealloc,
+   FUNCTOR* upcall_functor,
+   FreeList* freelist,
+   TIME_POLICY const & time_policy)
+: Base_Timer_Queue (upcall_functor, freelist, time_policy)
+, slots_ (0)
+, occupied_ (0)
+, occupied_words_ (0)
+, resolution_ (1)
+, levels_ (0)
+, slot_bits_ (0)
+, overflow_slot_ (0)
+, due_slot_ (0)
+, current_tick_ (0)
+, timer_ids_ (0)
+, timer_ids_size_ (0)
+, timer_ids_free_ (0)
+, timer_count_ (0)
+, earliest_ (0)
+, iterator_ (0)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::ACE_Timer_Hierarchical_Wheel_T");
+  this->open_i (prealloc, resolution, levels, slot_bits);
+}
+
+/**
+* Initialize the queue: allocate the slot lists, the bitmaps and the
+* timer id table.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::open_i
+  (size_t prealloc,
+   const ACE_Time_Value &resolution,
+   u_int levels,
+   u_int slot_bits)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::open_i");
+
+  const u_int MAX_LEVELS = 8;
+  const u_int MAX_SLOT_BITS = 12;
+  const u_int MAX_TICK_BITS = 60; // Leaves room for the overflow tick.
+
+  this->slot_bits_ = slot_bits < 1 ? 1 : (slot_bits > MAX_SLOT_BITS ? MAX_SLOT_BITS : slot_bits);
+  this->levels_ = levels < 1 ? 1 : (levels > MAX_LEVELS ? MAX_LEVELS : levels);
+  while (this->levels_ > 1 && this->levels_ * this->slot_bits_ > MAX_TICK_BITS)
+    --this->levels_;
+
+  if (resolution > ACE_Time_Value::zero)
+    resolution.to_usec (this->resolution_);
+  if (this->resolution_ == 0)
+    this->resolution_ = 1;
+
+  if (prealloc > 0)
+    this->free_list_->resize (prealloc);
+
+  this->overflow_slot_ = static_cast<size_t> (this->levels_) << this->slot_bits_;
+  this->due_slot_ = this->overflow_slot_ + 1;
+
+  ACE_NEW (this->slots_, ACE_Timer_Node_T<TYPE>[this->due_slot_ + 1]);
+  for (size_t i = 0; i <= this->due_slot_; ++i)
+    {
+      ACE_Timer_Node_T<TYPE>* root = &this->slots_[i];
+      root->set (0, 0, ACE_Time_Value::zero, ACE_Time_Value::zero, root, root, -1);
+    }
+
+  this->occupied_words_ = ((size_t (1) << this->slot_bits_) + 31) / 32;
+  ACE_NEW (this->occupied_,
+           ACE_UINT32[this->occupied_words_ * this->levels_]);
+  ACE_OS::memset (this->occupied_,
+                  0,
+                  this->occupied_words_ * this->levels_ * sizeof (ACE_UINT32));
+
+  this->timer_ids_size_ = prealloc > 0 ? prealloc : ACE_DEFAULT_TIMERS;
+  ACE_NEW (this->timer_ids_, Timer_Entry[this->timer_ids_size_]);
+  for (size_t i = 0; i < this->timer_ids_size_; ++i)
+    {
+      this->timer_ids_[i].node_ = 0;
+      this->timer_ids_[i].slot_ = i + 1;
+    }
+  this->timer_ids_free_ = 0;
+
+  ACE_NEW (iterator_, Iterator (*this));
+}
+
+/// Destructor just cleans up its memory
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::~ACE_Timer_Hierarchical_Wheel_T (void)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::~ACE_Timer_Hierarchical_Wheel_T");
+
+  delete iterator_;
+
+  this->close ();
+
+  delete [] this->slots_;
+  delete [] this->occupied_;
+  delete [] this->timer_ids_;
+}
+
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> int
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::close (void)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::close");
+
+  // Remove any remaining nodes
+  for (size_t i = 0; i <= this->due_slot_; ++i)
+    {
+      ACE_Timer_Node_T<TYPE>* root = &this->slots_[i];
+      ACE_Timer_Node_T<TYPE>* n = root->get_next ();
+      root->set_next (root);
+      root->set_prev (root);
+      while (n != root)
+        {
+          ACE_Timer_Node_T<TYPE>* next = n->get_next ();
+          this->upcall_functor ().deletion (*this,
+                                            n->get_type (),
+                                            n->get_act ());
+          this->free_node (n);
+          n = next;
+        }
+    }
+
+  ACE_OS::memset (this->occupied_,
+                  0,
+                  this->occupied_words_ * this->levels_ * sizeof (ACE_UINT32));
+  this->timer_count_ = 0;
+  this->earliest_ = 0;
+
+  return 0;
+}
+
+/// Converts an absolute time to a tick number.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> ACE_UINT64
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::ticks
+  (const ACE_Time_Value &t) const
+{
+  if (t <= ACE_Time_Value::zero)
+    return 0;
+  ACE_UINT64 usec;
+  t.to_usec (usec);
+  return usec / this->resolution_;
+}
+
+/// Takes an entry from the free chain of the timer id table, doubling
+/// the table if there is none left.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> long
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::alloc_timer_id (void)
+{
+  if (this->timer_ids_free_ == this->timer_ids_size_)
+    {
+      size_t const max_size =
+        static_cast<size_t> (ACE_Numeric_Limits<long>::max ());
+      if (this->timer_ids_size_ >= max_size)
+        return -1;
+      size_t const new_size =
+        this->timer_ids_size_ > max_size / 2 ? max_size : this->timer_ids_size_ * 2;
+
+      Timer_Entry* new_ids = 0;
+      ACE_NEW_RETURN (new_ids, Timer_Entry[new_size], -1);
+      ACE_OS::memcpy (new_ids,
+                      this->timer_ids_,
+                      this->timer_ids_size_ * sizeof (Timer_Entry));
+      for (size_t i = this->timer_ids_size_; i < new_size; ++i)
+        {
+          new_ids[i].node_ = 0;
+          new_ids[i].slot_ = i + 1;
+        }
+
+      delete [] this->timer_ids_;
+      this->timer_ids_ = new_ids;
+      this->timer_ids_size_ = new_size;
+    }
+
+  size_t const id = this->timer_ids_free_;
+  this->timer_ids_free_ = this->timer_ids_[id].slot_;
+  this->timer_ids_[id].slot_ = this->due_slot_ + 1;
+  return static_cast<long> (id);
+}
+
+/// Returns the node of a scheduled timer, or 0 if @a timer_id is not
+/// scheduled.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Node_T<TYPE>*
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::find_node (long timer_id) const
+{
+  if (timer_id < 0
+      || static_cast<size_t> (timer_id) >= this->timer_ids_size_)
+    return 0;
+
+  Timer_Entry const &entry = this->timer_ids_[timer_id];
+  if (entry.node_ == 0 || entry.slot_ > this->due_slot_)
+    return 0;
+  return entry.node_;
+}
+
+/// Releases the timer id of the node along with the node.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::free_node (ACE_Timer_Node_T<TYPE>* n)
+{
+  long const timer_id = n->get_timer_id ();
+  if (timer_id >= 0
+      && static_cast<size_t> (timer_id) < this->timer_ids_size_
+      && this->timer_ids_[timer_id].node_ == n)
+    {
+      this->timer_ids_[timer_id].node_ = 0;
+      this->timer_ids_[timer_id].slot_ = this->timer_ids_free_;
+      this->timer_ids_free_ = static_cast<size_t> (timer_id);
+    }
+
+  this->Base_Timer_Queue::free_node (n);
+}
+
+/**
+* Check to see if the wheel is empty
+*
+* @return True if empty
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> bool
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::is_empty (void) const
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::is_empty");
+  return this->timer_count_ == 0;
+}
+
+/**
+* @return The time of the earliest node in the wheel.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> const ACE_Time_Value &
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::earliest_time (void) const
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::earliest_time");
+  ACE_Timer_Node_T<TYPE>* n = this->get_first_i ();
+  if (n != 0)
+    return n->get_timer_value ();
+  return ACE_Time_Value::zero;
+}
+
+/**
+* Creates a ACE_Timer_Node_T based on the input parameters and links
+* it into the wheel.
+*
+*  @param type            The data of the timer node
+*  @param act             Asynchronous Completion Token (AKA magic cookie)
+*  @param future_time     The time the timer is scheduled for (absolute time)
+*  @param interval        If not ACE_Time_Value::zero, then this is a periodic
+*                         timer and interval is the time period
+*
+*  @return Unique identifier (can be used to cancel the timer).
+*          -1 on failure.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> long
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::schedule_i (const TYPE& type,
+                                                                     const void* act,
+                                                                     const ACE_Time_Value& future_time,
+                                                                     const ACE_Time_Value& interval)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::schedule_i");
+
+  ACE_Timer_Node_T<TYPE>* n = this->alloc_node ();
+  if (n == 0)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+
+  long const id = this->alloc_timer_id ();
+  if (id == -1)
+    {
+      this->Base_Timer_Queue::free_node (n);
+      errno = ENOMEM;
+      return -1;
+    }
+
+  // An empty wheel can be moved to the present, or to the new timer
+  // if it is in the past, so that it does not have to catch up with
+  // all the time that went by since it was last used.
+  if (this->timer_count_ == 0)
+    {
+      ACE_UINT64 const now = this->ticks (this->gettimeofday_static ());
+      ACE_UINT64 const due = this->ticks (future_time);
+      this->current_tick_ = due < now ? due : now;
+    }
+
+  n->set (type, act, future_time, interval, 0, 0, id);
+  this->timer_ids_[id].node_ = n;
+  this->link (n);
+  return id;
+}
+
+/**
+* Links a node at the end of the list it belongs on, given its
+* expiration time and the current tick.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::link (ACE_Timer_Node_T<TYPE>* n)
+{
+  u_int const bits = this->slot_bits_;
+  ACE_UINT64 const mask = (ACE_UINT64 (1) << bits) - 1;
+  ACE_UINT64 const tick = this->ticks (n->get_timer_value ());
+
+  size_t slot = this->overflow_slot_;
+  if (tick <= this->current_tick_)
+    slot = static_cast<size_t> (this->current_tick_ & mask);
+  else
+    {
+      ACE_UINT64 const diff = tick ^ this->current_tick_;
+      for (u_int level = 0; level < this->levels_; ++level)
+        if ((diff >> (bits * (level + 1))) == 0)
+          {
+            slot = (static_cast<size_t> (level) << bits)
+              | static_cast<size_t> ((tick >> (bits * level)) & mask);
+            break;
+          }
+    }
+
+  if (slot < this->overflow_slot_)
+    {
+      size_t const index = slot & static_cast<size_t> (mask);
+      this->occupied_[(slot >> bits) * this->occupied_words_ + (index >> 5)]
+        |= ACE_UINT32 (1) << (index & 31);
+    }
+
+  ACE_Timer_Node_T<TYPE>* root = &this->slots_[slot];
+  ACE_Timer_Node_T<TYPE>* last = root->get_prev ();
+  n->set_prev (last);
+  n->set_next (root);
+  last->set_next (n);
+  root->set_prev (n);
+
+  this->timer_ids_[n->get_timer_id ()].slot_ = slot;
+
+  if (++this->timer_count_ == 1)
+    this->earliest_ = n;
+  else if (this->earliest_ != 0
+           && n->get_timer_value () < this->earliest_->get_timer_value ())
+    this->earliest_ = n;
+}
+
+/// Takes a node off its list.  The node keeps its timer id.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::unlink (ACE_Timer_Node_T<TYPE>* n)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::unlink");
+
+  Timer_Entry &entry = this->timer_ids_[n->get_timer_id ()];
+  size_t const slot = entry.slot_;
+  entry.slot_ = this->due_slot_ + 1;
+
+  n->get_prev ()->set_next (n->get_next ());
+  n->get_next ()->set_prev (n->get_prev ());
+  n->set_prev (0);
+  n->set_next (0);
+
+  --this->timer_count_;
+  if (n == this->earliest_)
+    this->earliest_ = 0;
+
+  ACE_Timer_Node_T<TYPE>* root = &this->slots_[slot];
+  if (slot < this->overflow_slot_ && root->get_next () == root)
+    {
+      size_t const index = slot & ((size_t (1) << this->slot_bits_) - 1);
+      this->occupied_[(slot >> this->slot_bits_) * this->occupied_words_ + (index >> 5)]
+        &= ~(ACE_UINT32 (1) << (index & 31));
+    }
+}
+
+/// Empties a list and links its nodes again according to the current
+/// tick, which moves them down the wheel.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::relink_all (size_t slot)
+{
+  ACE_Timer_Node_T<TYPE>* root = &this->slots_[slot];
+  ACE_Timer_Node_T<TYPE>* n = root->get_next ();
+  if (n == root)
+    return;
+
+  root->get_prev ()->set_next (0);
+  root->set_next (root);
+  root->set_prev (root);
+  if (slot < this->overflow_slot_)
+    {
+      size_t const index = slot & ((size_t (1) << this->slot_bits_) - 1);
+      this->occupied_[(slot >> this->slot_bits_) * this->occupied_words_ + (index >> 5)]
+        &= ~(ACE_UINT32 (1) << (index & 31));
+    }
+
+  while (n != 0)
+    {
+      ACE_Timer_Node_T<TYPE>* next = n->get_next ();
+      --this->timer_count_;
+      this->link (n);
+      n = next;
+    }
+}
+
+/// Returns the first occupied slot of @a level at or after @a index,
+/// or the number of slots per level if there is none.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> size_t
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::next_occupied
+  (u_int level, size_t index) const
+{
+  size_t const count = size_t (1) << this->slot_bits_;
+  if (index >= count)
+    return count;
+
+  const ACE_UINT32* words = this->occupied_ + level * this->occupied_words_;
+  size_t w = index >> 5;
+  ACE_UINT32 bits = words[w] & (~ACE_UINT32 (0) << (index & 31));
+  while (bits == 0)
+    {
+      if (++w == this->occupied_words_)
+        return count;
+      bits = words[w];
+    }
+
+  // Find the lowest bit set.
+  size_t b = 0;
+  if ((bits & 0xffff) == 0) { b += 16; bits >>= 16; }
+  if ((bits & 0xff) == 0) { b += 8; bits >>= 8; }
+  if ((bits & 0xf) == 0) { b += 4; bits >>= 4; }
+  if ((bits & 0x3) == 0) { b += 2; bits >>= 2; }
+  if ((bits & 0x1) == 0) { b += 1; }
+
+  size_t const result = (w << 5) + b;
+  return result < count ? result : count;
+}
+
+/// Returns the next tick after the current one at which there is
+/// something to do: a slot of level 0 to expire, a slot of a higher
+/// level to cascade or the overflow list to look at.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> ACE_UINT64
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::next_event (void) const
+{
+  u_int const bits = this->slot_bits_;
+  size_t const mask = (size_t (1) << bits) - 1;
+
+  for (u_int level = 0; level < this->levels_; ++level)
+    {
+      u_int const shift = bits * level;
+      size_t const index =
+        static_cast<size_t> ((this->current_tick_ >> shift) & mask);
+      size_t const next = this->next_occupied (level, index + 1);
+      if (next <= mask)
+        return ((this->current_tick_ >> (shift + bits)) << (shift + bits))
+          | (static_cast<ACE_UINT64> (next) << shift);
+    }
+
+  ACE_Timer_Node_T<TYPE>* overflow = &this->slots_[this->overflow_slot_];
+  if (overflow->get_next () != overflow)
+    {
+      u_int const shift = bits * this->levels_;
+      return ((this->current_tick_ >> shift) + 1) << shift;
+    }
+
+  return ~ACE_UINT64 (0);
+}
+
+/// Moves the wheel to @a tick, which must not be beyond <next_event>,
+/// and cascades the slots that start there.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::advance (ACE_UINT64 tick)
+{
+  u_int const bits = this->slot_bits_;
+  ACE_UINT64 const mask = (ACE_UINT64 (1) << bits) - 1;
+
+  this->current_tick_ = tick;
+
+  if ((tick & ((ACE_UINT64 (1) << (bits * this->levels_)) - 1)) == 0)
+    this->relink_all (this->overflow_slot_);
+
+  for (u_int level = this->levels_ - 1; level > 0; --level)
+    {
+      u_int const shift = bits * level;
+      if ((tick & ((ACE_UINT64 (1) << shift) - 1)) == 0)
+        this->relink_all ((static_cast<size_t> (level) << bits)
+                          | static_cast<size_t> ((tick >> shift) & mask));
+    }
+}
+
+/// Moves the timers of the current slot that are due at @a now to the
+/// due list.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::collect_due
+  (const ACE_Time_Value& now)
+{
+  size_t const slot =
+    static_cast<size_t> (this->current_tick_ & ((ACE_UINT64 (1) << this->slot_bits_) - 1));
+  ACE_Timer_Node_T<TYPE>* root = &this->slots_[slot];
+  ACE_Timer_Node_T<TYPE>* due = &this->slots_[this->due_slot_];
+
+  for (ACE_Timer_Node_T<TYPE>* n = root->get_next (); n != root; )
+    {
+      ACE_Timer_Node_T<TYPE>* next = n->get_next ();
+      if (n->get_timer_value () <= now)
+        {
+          n->get_prev ()->set_next (next);
+          next->set_prev (n->get_prev ());
+
+          ACE_Timer_Node_T<TYPE>* last = due->get_prev ();
+          n->set_prev (last);
+          n->set_next (due);
+          last->set_next (n);
+          due->set_prev (n);
+
+          this->timer_ids_[n->get_timer_id ()].slot_ = this->due_slot_;
+        }
+      n = next;
+    }
+
+  if (root->get_next () == root)
+    this->occupied_[slot >> 5] &= ~(ACE_UINT32 (1) << (slot & 31));
+}
+
+/// Removes and returns the next timer due at @a now, advancing the
+/// wheel as far as @a now if needed, or returns 0 if none is due.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> ACE_Timer_Node_T<TYPE> *
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::remove_first_expired (const ACE_Time_Value& now)
+{
+  ACE_UINT64 const target = this->ticks (now);
+  ACE_Timer_Node_T<TYPE>* due = &this->slots_[this->due_slot_];
+
+  while (this->timer_count_ != 0)
+    {
+      ACE_Timer_Node_T<TYPE>* n = due->get_next ();
+      if (n != due)
+        {
+          this->unlink (n);
+          return n;
+        }
+
+      this->collect_due (now);
+      if (due->get_next () != due)
+        continue;
+
+      if (this->current_tick_ >= target)
+        break;
+
+      ACE_UINT64 const next = this->next_event ();
+      this->advance (next < target ? next : target);
+    }
+
+  return 0;
+}
+
+/// Returns the node with the smallest time among the nodes of list
+/// @a slot and @a best.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> ACE_Timer_Node_T<TYPE> *
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::find_earliest
+  (size_t slot, ACE_Timer_Node_T<TYPE>* best) const
+{
+  ACE_Timer_Node_T<TYPE>* root = &this->slots_[slot];
+  for (ACE_Timer_Node_T<TYPE>* n = root->get_next ();
+       n != root;
+       n = n->get_next ())
+    {
+      if (best == 0 || n->get_timer_value () < best->get_timer_value ())
+        best = n;
+    }
+  return best;
+}
+
+/// Returns the earliest timer, looking it up if it is not cached:
+/// the earliest timer is on the due list or on the first occupied slot
+/// of the lowest occupied level, or else on the overflow list.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Node_T<TYPE>*
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::get_first_i (void) const
+{
+  if (this->timer_count_ == 0)
+    return 0;
+  if (this->earliest_ != 0)
+    return this->earliest_;
+
+  u_int const bits = this->slot_bits_;
+  size_t const mask = (size_t (1) << bits) - 1;
+  ACE_Timer_Node_T<TYPE>* best = this->find_earliest (this->due_slot_, 0);
+
+  u_int level = 0;
+  for (; level < this->levels_; ++level)
+    {
+      size_t const index =
+        static_cast<size_t> ((this->current_tick_ >> (bits * level)) & mask);
+      size_t const next = this->next_occupied (level, index);
+      if (next <= mask)
+        {
+          best = this->find_earliest ((static_cast<size_t> (level) << bits) | next,
+                                      best);
+          break;
+        }
+    }
+
+  if (level == this->levels_)
+    best = this->find_earliest (this->overflow_slot_, best);
+
+  this->earliest_ = best;
+  return best;
+}
+
+/**
+* Takes an ACE_Timer_Node and links it into the wheel again.
+*
+* @param n The timer node to reschedule
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::reschedule (ACE_Timer_Node_T<TYPE>* n)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::reschedule");
+  this->link (n);
+}
+
+/**
+* Find the timer node by using the id as an index.  Then use
+* set_interval() on the node to update the interval.
+*
+* @param timer_id The timer identifier
+* @param interval The new interval
+*
+* @return 0 if successful, -1 if no.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> int
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::reset_interval (long timer_id,
+                                                                         const ACE_Time_Value &interval)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::reset_interval");
+  ACE_MT (ACE_GUARD_RETURN (ACE_LOCK, ace_mon, this->mutex_, -1));
+  ACE_Timer_Node_T<TYPE>* n = this->find_node (timer_id);
+  if (n != 0)
+    {
+      // The interval will take effect the next time this node is expired.
+      n->set_interval (interval);
+      return 0;
+    }
+  return -1;
+}
+
+/**
+* Goes through every list in the wheel and whenever we find one with the
+* correct type value, we remove it and continue.
+*
+* @param type       The value to search for.
+* @param skip_close If this non-zero, the cancellation method of the
+*                   functor will not be called for each cancelled timer.
+*
+* @return Number of timers cancelled
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> int
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::cancel (const TYPE& type, int skip_close)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::cancel");
+
+  int num_canceled = 0; // Note : Technically this can overflow.
+  int cookie = 0;
+
+  ACE_MT (ACE_GUARD_RETURN (ACE_LOCK, ace_mon, this->mutex_, -1));
+
+  for (size_t i = 0;
+       i <= this->due_slot_ && this->timer_count_ != 0;
+       ++i)
+    {
+      ACE_Timer_Node_T<TYPE>* root = &this->slots_[i];
+      for (ACE_Timer_Node_T<TYPE>* n = root->get_next (); n != root; )
+        {
+          ACE_Timer_Node_T<TYPE>* next = n->get_next ();
+          if (n->get_type () == type)
+            {
+              ++num_canceled;
+              this->cancel_i (n);
+            }
+          n = next;
+        }
+    }
+
+  // Call the close hooks.
+
+  // cancel_type() called once per <type>.
+  this->upcall_functor ().cancel_type (*this,
+                                       type,
+                                       skip_close,
+                                       cookie);
+
+  for (int i = 0;
+       i < num_canceled;
+       ++i)
+    {
+      // cancel_timer() called once per <timer>.
+      this->upcall_functor ().cancel_timer (*this,
+                                            type,
+                                            skip_close,
+                                            cookie);
+    }
+
+  return num_canceled;
+}
+
+/**
+* Cancels the single timer that is specified by the timer_id, which
+* indexes the timer id table.
+*
+* @param timer_id   Timer Identifier
+* @param act        Asychronous Completion Token (AKA magic cookie):
+*                   If this is non-zero, stores the magic cookie of
+*                   the cancelled timer here.
+* @param skip_close If this non-zero, the cancellation method of the
+*                   functor will not be called.
+*
+* @return 1 for sucess and 0 if the timer_id wasn't found (or was
+*         found to be invalid)
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> int
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::cancel (long timer_id,
+                                                                 const void **act,
+                                                                 int skip_close)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::cancel");
+  ACE_MT (ACE_GUARD_RETURN (ACE_LOCK, ace_mon, this->mutex_, -1));
+  ACE_Timer_Node_T<TYPE>* n = this->find_node (timer_id);
+  if (n != 0)
+    {
+      // Call the close hooks.
+      int cookie = 0;
+
+      // cancel_type() called once per <type>.
+      this->upcall_functor ().cancel_type (*this,
+                                           n->get_type (),
+                                           skip_close,
+                                           cookie);
+
+      // cancel_timer() called once per <timer>.
+      this->upcall_functor ().cancel_timer (*this,
+                                            n->get_type (),
+                                            skip_close,
+                                            cookie);
+      if (act != 0)
+        *act = n->get_act ();
+
+      this->cancel_i (n);
+
+      return 1;
+    }
+  return 0;
+}
+
+/// Shared subset of the two cancel() methods.
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::cancel_i (ACE_Timer_Node_T<TYPE>* n)
+{
+  this->unlink (n);
+  this->free_node (n);
+}
+
+/**
+* Dumps out the shape of the wheel and its contents.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::dump");
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+
+  ACELIB_DEBUG ((LM_DEBUG,
+    ACE_TEXT ("\nlevels_ = %d"), this->levels_));
+  ACELIB_DEBUG ((LM_DEBUG,
+    ACE_TEXT ("\nslot_count_ = %d"), 1 << this->slot_bits_));
+  ACELIB_DEBUG ((LM_DEBUG,
+    ACE_TEXT ("\nresolution_ = %Q"), this->resolution_));
+  ACELIB_DEBUG ((LM_DEBUG,
+    ACE_TEXT ("\ncurrent_tick_ = %Q"), this->current_tick_));
+  ACELIB_DEBUG ((LM_DEBUG,
+    ACE_TEXT ("\ntimer_count_ = %B"), this->timer_count_));
+  ACELIB_DEBUG ((LM_DEBUG,
+    ACE_TEXT ("\nwheel_ =\n")));
+
+  for (size_t i = 0; i <= this->due_slot_; ++i)
+    {
+      ACE_Timer_Node_T<TYPE>* root = &this->slots_[i];
+      if (root->get_next () == root)
+        continue;
+      ACELIB_DEBUG ((LM_DEBUG, ACE_TEXT ("%B\n"), i));
+      for (ACE_Timer_Node_T<TYPE>* n = root->get_next ();
+           n != root;
+           n = n->get_next ())
+        {
+          n->dump ();
+        }
+    }
+
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+/**
+* Removes the earliest node, advancing the wheel to its time as
+* expire() does, so that the wheel keeps up when it is driven by
+* expire_single() or dispatch_info().
+*
+* @return The earliest timer node.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> ACE_Timer_Node_T<TYPE> *
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::remove_first (void)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::remove_first");
+  ACE_Timer_Node_T<TYPE>* n = this->get_first_i ();
+  if (n == 0)
+    return 0;
+
+  // Timers left on the due list by an interrupted expire() are
+  // taken as they are.
+  ACE_Timer_Node_T<TYPE>* due = &this->slots_[this->due_slot_];
+  if (due->get_next () == due)
+    {
+      ACE_Timer_Node_T<TYPE>* first =
+        this->remove_first_expired (n->get_timer_value ());
+      if (first != 0)
+        return first;
+    }
+
+  this->unlink (n);
+  return n;
+}
+
+/**
+* Returns the earliest node without removing it
+*
+* @return The earliest timer node.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Node_T<TYPE>*
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::get_first (void)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::get_first");
+  return this->get_first_i ();
+}
+
+/**
+* @return The iterator
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Queue_Iterator_T<TYPE> &
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::iter (void)
+{
+  this->iterator_->first ();
+  return *this->iterator_;
+}
+
+/**
+* Dummy version of expire to get rid of warnings in Sun CC 4.2
+* Just call the expire of the base class.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> int
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::expire ()
+{
+  return Base_Timer_Queue::expire ();
+}
+
+/**
+* This is a specialized version of expire that advances the wheel to
+* @a cur_time and dispatches the timers slot by slot.  The lock is
+* released during the upcalls, as in ACE_Timer_Queue_T::expire().
+*
+* @param cur_time The time to expire timers up to.
+*
+* @return Number of timers expired
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> int
+ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::expire (const ACE_Time_Value& cur_time)
+{
+  ACE_TRACE ("ACE_Timer_Hierarchical_Wheel_T::expire");
+
+  int expcount = 0;
+
+  ACE_MT (ACE_GUARD_RETURN (ACE_LOCK, ace_mon, this->mutex_, -1));
+
+  ACE_Timer_Node_T<TYPE>* n = this->remove_first_expired (cur_time);
+
+  while (n != 0)
+    {
+      ++expcount;
+
+      ACE_Timer_Node_Dispatch_Info_T<TYPE> info;
+
+      // Get the dispatch info
+      n->get_dispatch_info (info);
+
+      if (n->get_interval () > ACE_Time_Value::zero)
+        {
+          // Make sure that we skip past values that have already
+          // "expired".
+          this->recompute_next_abs_interval_time (n, cur_time);
+
+          this->reschedule (n);
+        }
+      else
+        {
+          this->free_node (n);
+        }
+
+      {
+        ACE_MT (ACE_Reverse_Lock<ACE_LOCK> rev_lk (this->mutex_));
+        ACE_MT (ACE_GUARD_RETURN (ACE_Reverse_Lock<ACE_LOCK>, rmon, rev_lk, -1));
+
+        const void *upcall_act = 0;
+
+        this->preinvoke (info, cur_time, upcall_act);
+
+        this->upcall (info, cur_time);
+
+        this->postinvoke (info, cur_time, upcall_act);
+      }
+
+      n = this->remove_first_expired (cur_time);
+    }
+
+  return expcount;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// ACE_Timer_Hierarchical_Wheel_Iterator_T
+
+/**
+* Just initializes the iterator with a ACE_Timer_Hierarchical_Wheel_T
+* and then calls first() to initialize the rest of itself.
+*
+* @param wheel A reference for a timer queue to iterate over
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE,FUNCTOR,ACE_LOCK,TIME_POLICY>::ACE_Timer_Hierarchical_Wheel_Iterator_T
+(Wheel& wheel)
+: timer_wheel_ (wheel)
+{
+  this->first ();
+}
+
+/**
+* Destructor, at this level does nothing.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE,FUNCTOR,ACE_LOCK,TIME_POLICY>::~ACE_Timer_Hierarchical_Wheel_Iterator_T (void)
+{
+}
+
+/**
+* Positions the iterator at the first node of the first list that is
+* not empty.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::first (void)
+{
+  this->goto_next (0);
+}
+
+/**
+* Positions the iterator at the next node.
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::next (void)
+{
+  if (this->isdone ())
+    return;
+
+  ACE_Timer_Node_T<TYPE>* n = this->current_node_->get_next ();
+  ACE_Timer_Node_T<TYPE>* root = &this->timer_wheel_.slots_[this->slot_];
+  if (n == root)
+    this->goto_next (this->slot_ + 1);
+  else
+    this->current_node_ = n;
+}
+
+/// Helper class for common functionality of next() and first()
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> void
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::goto_next (size_t start_slot)
+{
+  // Find the first non-empty list.
+  size_t const sc = this->timer_wheel_.due_slot_ + 1;
+  for (size_t i = start_slot; i < sc; ++i)
+    {
+      ACE_Timer_Node_T<TYPE>* root = &this->timer_wheel_.slots_[i];
+      ACE_Timer_Node_T<TYPE>* n = root->get_next ();
+      if (n != root)
+        {
+          this->slot_ = i;
+          this->current_node_ = n;
+          return;
+        }
+    }
+  // empty
+  this->slot_ = sc;
+  this->current_node_ = 0;
+}
+
+/**
+* @return True when we there aren't any more items (when current_node_ == 0)
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> bool
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::isdone (void) const
+{
+  return this->current_node_ == 0;
+}
+
+/**
+* @return The node at the current position in the sequence or 0 if the
+*         wheel is empty
+*/
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY> ACE_Timer_Node_T<TYPE> *
+ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>::item (void)
+{
+  return this->current_node_;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_TIMER_HIERARCHICAL_WHEEL_T_CPP */
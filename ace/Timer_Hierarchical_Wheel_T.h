@@ -0,0 +1,297 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Timer_Hierarchical_Wheel_T.h
+ *
+ *  $Id$
+ */
+//=============================================================================
+
+#ifndef ACE_TIMER_HIERARCHICAL_WHEEL_T_H
+#define ACE_TIMER_HIERARCHICAL_WHEEL_T_H
+#include /**/ "ace/pre.h"
+
+#include "ace/Timer_Queue_T.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// Forward declaration
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY>
+class ACE_Timer_Hierarchical_Wheel_T;
+
+/**
+ * @class ACE_Timer_Hierarchical_Wheel_Iterator_T
+ *
+ * @brief Iterates over an ACE_Timer_Hierarchical_Wheel.
+ *
+ * This is a generic iterator that can be used to visit every
+ * node of a timer queue.  Be aware that it doesn't traverse
+ * in the order of timeout values.
+ */
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY = ACE_Default_Time_Policy>
+class ACE_Timer_Hierarchical_Wheel_Iterator_T
+  : public ACE_Timer_Queue_Iterator_T <TYPE>
+{
+public:
+  typedef ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY> Wheel;
+  typedef ACE_Timer_Node_T<TYPE> Node;
+
+  /// Constructor
+  ACE_Timer_Hierarchical_Wheel_Iterator_T (Wheel &);
+
+  /// Destructor
+  virtual ~ACE_Timer_Hierarchical_Wheel_Iterator_T (void);
+
+  /// Positions the iterator at the first node in the Timer Queue
+  virtual void first (void);
+
+  /// Positions the iterator at the next node in the Timer Queue
+  virtual void next (void);
+
+  /// Returns true when there are no more nodes in the sequence
+  virtual bool isdone (void) const;
+
+  /// Returns the node at the current position in the sequence
+  virtual ACE_Timer_Node_T<TYPE>* item (void);
+
+protected:
+  /// The wheel we are iterating over.
+  Wheel& timer_wheel_;
+
+  /// Current slot, counting the overflow and due lists.
+  size_t slot_;
+
+  /// Current node in the <slot_>th list.
+  ACE_Timer_Node_T<TYPE>* current_node_;
+
+private:
+  void goto_next (size_t start_slot);
+};
+
+/**
+ * @class ACE_Timer_Hierarchical_Wheel_T
+ *
+ * @brief Provides a hierarchical timing wheel version of
+ * ACE_Timer_Queue.
+ *
+ * Time is divided into ticks of a fixed resolution.  The wheel has a
+ * number of levels, each with 2^slot_bits slots: a slot on level 0
+ * holds the timers of a single tick, a slot on level 1 those of
+ * 2^slot_bits ticks, and so on.  Timers due beyond the range of the
+ * top level are kept on an overflow list.  Scheduling a timer hashes
+ * it straight into its slot and cancelling it unlinks it from there,
+ * both in constant time whatever the number of timers; timer ids
+ * index a table of the scheduled nodes.  As time advances the slots
+ * of the higher levels are cascaded down to the lower ones, so each
+ * timer is moved at most once per level.  This is the scheme described
+ * in George Varghese and Tony Lauck's paper "Hashed and Hierarchical
+ * Timing Wheels".
+ *
+ * Timers keep their exact expiration time and are never dispatched
+ * early, but the timers that fall in the same tick are dispatched as
+ * one batch, in the order they were scheduled rather than strictly in
+ * order of their expiration times.  A coarser resolution makes for
+ * bigger batches and fewer cascades; pick the coarsest resolution the
+ * application can live with.
+ *
+ * With the defaults, a resolution of 1 millisecond and 4 levels of
+ * 256 slots, the wheel covers about 49 days before using the overflow
+ * list.  Nodes are taken from the free list, which can be preallocated.
+ */
+template <class TYPE, class FUNCTOR, class ACE_LOCK, typename TIME_POLICY = ACE_Default_Time_Policy>
+class ACE_Timer_Hierarchical_Wheel_T
+  : public ACE_Timer_Queue_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>
+{
+public:
+  /// Type of iterator
+  typedef ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY> Iterator;
+  /// Iterator is a friend
+  friend class ACE_Timer_Hierarchical_Wheel_Iterator_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY>;
+  typedef ACE_Timer_Node_T<TYPE> Node;
+  /// Type inherited from
+  typedef ACE_Timer_Queue_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY> Base_Timer_Queue;
+  typedef ACE_Free_List<Node> FreeList;
+
+  /// Default constructor
+  ACE_Timer_Hierarchical_Wheel_T (FUNCTOR* upcall_functor = 0,
+                                  FreeList* freelist = 0,
+                                  TIME_POLICY const & time_policy = TIME_POLICY());
+
+  /**
+   * Constructor with opportunities to set the shape of the wheel.
+   *
+   * @param resolution     Length of a tick.  Rounded up to one
+   *                       microsecond.
+   * @param levels         Number of levels, between 1 and 8.
+   * @param slot_bits      Log2 of the number of slots per level,
+   *                       between 1 and 12.  @a levels * @a slot_bits
+   *                       is limited to 60.
+   * @param prealloc       Number of nodes to preallocate.
+   */
+  ACE_Timer_Hierarchical_Wheel_T (const ACE_Time_Value &resolution,
+                                  u_int levels,
+                                  u_int slot_bits,
+                                  size_t prealloc = 0,
+                                  FUNCTOR* upcall_functor = 0,
+                                  FreeList* freelist = 0,
+                                  TIME_POLICY const & time_policy = TIME_POLICY());
+
+  /// Destructor
+  virtual ~ACE_Timer_Hierarchical_Wheel_T (void);
+
+  /// True if queue is empty, else false.
+  virtual bool is_empty (void) const;
+
+  /// Returns the time of the earlier node in the wheel.
+  /// Must be called on a non-empty queue.
+  virtual const ACE_Time_Value& earliest_time (void) const;
+
+  /// Changes the interval of a timer (and can make it periodic or non
+  /// periodic by setting it to ACE_Time_Value::zero or not).
+  virtual int reset_interval (long timer_id,
+                              const ACE_Time_Value& interval);
+
+  /// Cancel all timer associated with @a type.  If @a dont_call_handle_close is
+  /// 0 then the <functor> will be invoked.  Returns number of timers
+  /// cancelled.
+  virtual int cancel (const TYPE& type,
+                      int dont_call_handle_close = 1);
+
+  // Cancel a timer, storing the magic cookie in act (if nonzero).
+  // Calls the functor if dont_call_handle_close is 0 and returns 1
+  // on success
+  virtual int cancel (long timer_id,
+                      const void** act = 0,
+                      int dont_call_handle_close = 1);
+
+  /**
+   * Destroy timer queue. Cancels all timers.
+   */
+  virtual int close (void);
+
+  /// Run the <functor> for all timers whose values are <=
+  /// <ACE_OS::gettimeofday>.  Also accounts for <timer_skew>.  Returns
+  /// the number of timers canceled.
+  virtual int expire (void);
+
+  // Run the <functor> for all timers whose values are <= @a current_time.
+  // This does not account for <timer_skew>.  Returns the number of
+  // timers canceled.
+  int expire (const ACE_Time_Value& current_time);
+
+  /// Returns a pointer to this <ACE_Timer_Queue_T>'s iterator.
+  virtual ACE_Timer_Queue_Iterator_T<TYPE> & iter (void);
+
+  /// Removes the earliest node from the queue and returns it
+  virtual ACE_Timer_Node_T<TYPE>* remove_first (void);
+
+  /// Dump the state of an object.
+  virtual void dump (void) const;
+
+  /// Reads the earliest node from the queue and returns it.
+  virtual ACE_Timer_Node_T<TYPE>* get_first (void);
+
+protected:
+
+  /// Schedules a timer.
+  virtual long schedule_i (const TYPE& type,
+                           const void* act,
+                           const ACE_Time_Value& future_time,
+                           const ACE_Time_Value& interval);
+
+  /// Frees a node and the timer id it was holding.
+  virtual void free_node (ACE_Timer_Node_T<TYPE> *);
+
+private:
+  /// Where a scheduled timer is: its node and the list it is on.
+  /// Free entries are chained through <slot_>.
+  struct Timer_Entry
+  {
+    ACE_Timer_Node_T<TYPE>* node_;
+    size_t slot_;
+  };
+
+  // The following are documented in the .cpp file.
+  void open_i (size_t prealloc,
+               const ACE_Time_Value &resolution,
+               u_int levels,
+               u_int slot_bits);
+  virtual void reschedule (ACE_Timer_Node_T<TYPE> *);
+  ACE_UINT64 ticks (const ACE_Time_Value &t) const;
+  long alloc_timer_id (void);
+  ACE_Timer_Node_T<TYPE>* find_node (long timer_id) const;
+  void link (ACE_Timer_Node_T<TYPE>* n);
+  void unlink (ACE_Timer_Node_T<TYPE>* n);
+  void relink_all (size_t slot);
+  size_t next_occupied (u_int level, size_t index) const;
+  ACE_UINT64 next_event (void) const;
+  void advance (ACE_UINT64 tick);
+  void collect_due (const ACE_Time_Value& now);
+  ACE_Timer_Node_T<TYPE>* remove_first_expired (const ACE_Time_Value& now);
+  ACE_Timer_Node_T<TYPE>* get_first_i (void) const;
+  ACE_Timer_Node_T<TYPE>* find_earliest (size_t slot,
+                                         ACE_Timer_Node_T<TYPE>* best) const;
+  void cancel_i (ACE_Timer_Node_T<TYPE>* n);
+
+private:
+  /// Dummy root nodes of the slot lists: the levels one after the
+  /// other, then the overflow list and the list of due timers.
+  ACE_Timer_Node_T<TYPE>* slots_;
+
+  /// One bit per slot of each level, set if the slot is not empty.
+  ACE_UINT32* occupied_;
+
+  /// Number of ACE_UINT32 in <occupied_> per level.
+  size_t occupied_words_;
+
+  /// Length of a tick in microseconds.
+  ACE_UINT64 resolution_;
+
+  u_int levels_;
+  u_int slot_bits_;
+
+  /// Index of the overflow list in <slots_>; the due list follows it.
+  size_t overflow_slot_;
+  size_t due_slot_;
+
+  /// The tick up to which the wheel has been advanced.
+  ACE_UINT64 current_tick_;
+
+  /// Scheduled timers, indexed by timer id.
+  Timer_Entry* timer_ids_;
+  size_t timer_ids_size_;
+
+  /// First free entry in <timer_ids_>, or <timer_ids_size_> if none.
+  size_t timer_ids_free_;
+
+  /// Number of timers on the lists.
+  size_t timer_count_;
+
+  /// Earliest timer, or 0 if it must be looked up again.
+  mutable ACE_Timer_Node_T<TYPE>* earliest_;
+
+  /// Iterator returned by <iter>.
+  Iterator* iterator_;
+
+  // = Don't allow these operations for now.
+  ACE_UNIMPLEMENTED_FUNC (ACE_Timer_Hierarchical_Wheel_T (const ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY> &))
+  ACE_UNIMPLEMENTED_FUNC (void operator= (const ACE_Timer_Hierarchical_Wheel_T<TYPE, FUNCTOR, ACE_LOCK, TIME_POLICY> &))
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (ACE_TEMPLATES_REQUIRE_SOURCE)
+#include "ace/Timer_Hierarchical_Wheel_T.cpp"
+#endif /* ACE_TEMPLATES_REQUIRE_SOURCE */
+
+#if defined (ACE_TEMPLATES_REQUIRE_PRAGMA)
+#pragma implementation ("Timer_Hierarchical_Wheel_T.cpp")
+#endif /* ACE_TEMPLATES_REQUIRE_PRAGMA */
+
+#include /**/ "ace/post.h"
+#endif /* ACE_TIMER_HIERARCHICAL_WHEEL_T_H */
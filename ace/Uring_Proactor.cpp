@@ -0,0 +1,1104 @@
+// $Id$
+
+#include "ace/Uring_Proactor.h"
+
+#if defined (ACE_HAS_AIO_CALLS) && defined (ACE_HAS_IO_URING)
+
+#include "ace/ACE.h"
+#include "ace/Addr.h"
+#include "ace/Flag_Manip.h"
+#include "ace/Log_Category.h"
+#include "ace/Countdown_Time.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_poll.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_sys_mman.h"
+#include "ace/OS_NS_sys_socket.h"
+#include "ace/OS_NS_unistd.h"
+
+#include /**/ <linux/io_uring.h>
+#include /**/ <sys/syscall.h>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+// There is no C library wrapper for the io_uring system calls.
+
+static int
+ace_io_uring_setup (unsigned int entries, struct io_uring_params *params)
+{
+  return static_cast<int> (::syscall (__NR_io_uring_setup, entries, params));
+}
+
+static int
+ace_io_uring_enter (ACE_HANDLE fd,
+                    unsigned int to_submit,
+                    unsigned int min_complete,
+                    unsigned int flags)
+{
+  return static_cast<int> (::syscall (__NR_io_uring_enter,
+                                      fd,
+                                      to_submit,
+                                      min_complete,
+                                      flags,
+                                      0,
+                                      0));
+}
+
+// user_data of the completion queue entries: 0 for entries nobody
+// waits for (cancellations), a pointer with the low bit set for
+// posted results and (slot + 1) << 1 for started operations.
+
+static const ACE_UINT64 URING_POSTED_BIT = 1;
+
+ACE_Uring_Proactor::ACE_Uring_Proactor (size_t max_aio_operations)
+  : ring_fd_ (ACE_INVALID_HANDLE),
+    sq_ring_ (MAP_FAILED),
+    sq_ring_size_ (0),
+    cq_ring_ (MAP_FAILED),
+    cq_ring_size_ (0),
+    sqes_ (0),
+    sqes_size_ (0),
+    sq_head_ (0),
+    sq_tail_ (0),
+    sq_flags_ (0),
+    sq_mask_ (0),
+    sq_entries_ (0),
+    sq_array_ (0),
+    cq_head_ (0),
+    cq_tail_ (0),
+    cq_mask_ (0),
+    cqes_ (0),
+    sq_pending_ (0),
+    wakeup_pending_ (false),
+    num_waiters_ (0),
+    slots_ (0),
+    free_slots_ (0),
+    max_aio_operations_ (max_aio_operations),
+    num_started_aio_ (0)
+{
+  if (this->max_aio_operations_ == 0)
+    this->max_aio_operations_ = ACE_AIO_DEFAULT_SIZE;
+  else if (this->max_aio_operations_ > ACE_AIO_MAX_SIZE)
+    this->max_aio_operations_ = ACE_AIO_MAX_SIZE;
+
+  ACE_NEW (this->slots_, Aio_Slot[this->max_aio_operations_]);
+  ACE_NEW (this->free_slots_, size_t[this->max_aio_operations_]);
+
+  for (size_t i = 0; i < this->max_aio_operations_; ++i)
+    {
+      this->slots_[i].result_ = 0;
+      this->slots_[i].owner_ = 0;
+      // Hand out the low slots first.
+      this->free_slots_[i] = this->max_aio_operations_ - 1 - i;
+    }
+
+  if (this->wakeup_pipe_.open () == -1
+      || ACE::set_flags (this->wakeup_pipe_.read_handle (), ACE_NONBLOCK) == -1)
+    ACELIB_ERROR ((LM_ERROR,
+                   ACE_TEXT ("%N:%l:(%P | %t)::%p\n"),
+                   ACE_TEXT ("ACE_Uring_Proactor::ACE_Uring_Proactor:")
+                   ACE_TEXT ("pipe")));
+  else if (this->open_ring (static_cast<unsigned int> (this->max_aio_operations_)) == -1)
+    ACELIB_ERROR ((LM_ERROR,
+                   ACE_TEXT ("%N:%l:(%P | %t)::%p\n"),
+                   ACE_TEXT ("ACE_Uring_Proactor::ACE_Uring_Proactor:")
+                   ACE_TEXT ("open_ring")));
+}
+
+ACE_Uring_Proactor::~ACE_Uring_Proactor (void)
+{
+  this->close ();
+
+  delete [] this->slots_;
+  delete [] this->free_slots_;
+}
+
+ACE_POSIX_Proactor::Proactor_Type
+ACE_Uring_Proactor::get_impl_type (void)
+{
+  return PROACTOR_URING;
+}
+
+bool
+ACE_Uring_Proactor::supported (void)
+{
+  struct io_uring_params params;
+  ACE_OS::memset (&params, 0, sizeof params);
+
+  int const fd = ace_io_uring_setup (1, &params);
+  if (fd == -1)
+    return false;
+
+  ACE_OS::close (fd);
+  return ACE_BIT_ENABLED (params.features, IORING_FEAT_NODROP);
+}
+
+int
+ACE_Uring_Proactor::open_ring (unsigned int entries)
+{
+  struct io_uring_params params;
+  ACE_OS::memset (&params, 0, sizeof params);
+
+  int const fd = ace_io_uring_setup (entries, &params);
+  if (fd == -1)
+    return -1;
+
+  // Without IORING_FEAT_NODROP completions that don't fit into the
+  // completion ring would be lost, and posted results with them.
+  if (ACE_BIT_DISABLED (params.features, IORING_FEAT_NODROP))
+    {
+      ACE_OS::close (fd);
+      errno = ENOTSUP;
+      return -1;
+    }
+
+  this->ring_fd_ = fd;
+  this->sq_ring_size_ =
+    params.sq_off.array + params.sq_entries * sizeof (unsigned int);
+  this->cq_ring_size_ =
+    params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+
+  bool const single_mmap =
+    ACE_BIT_ENABLED (params.features, IORING_FEAT_SINGLE_MMAP);
+  if (single_mmap)
+    {
+      if (this->cq_ring_size_ > this->sq_ring_size_)
+        this->sq_ring_size_ = this->cq_ring_size_;
+      this->cq_ring_size_ = this->sq_ring_size_;
+    }
+
+  this->sq_ring_ = ACE_OS::mmap (0,
+                                 this->sq_ring_size_,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE,
+                                 fd,
+                                 IORING_OFF_SQ_RING);
+  if (this->sq_ring_ == MAP_FAILED)
+    {
+      this->close ();
+      return -1;
+    }
+
+  if (single_mmap)
+    this->cq_ring_ = this->sq_ring_;
+  else
+    {
+      this->cq_ring_ = ACE_OS::mmap (0,
+                                     this->cq_ring_size_,
+                                     PROT_READ | PROT_WRITE,
+                                     MAP_SHARED | MAP_POPULATE,
+                                     fd,
+                                     IORING_OFF_CQ_RING);
+      if (this->cq_ring_ == MAP_FAILED)
+        {
+          this->close ();
+          return -1;
+        }
+    }
+
+  this->sqes_size_ = params.sq_entries * sizeof (struct io_uring_sqe);
+  void *sqes = ACE_OS::mmap (0,
+                             this->sqes_size_,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             fd,
+                             IORING_OFF_SQES);
+  if (sqes == MAP_FAILED)
+    {
+      this->close ();
+      return -1;
+    }
+  this->sqes_ = static_cast<struct io_uring_sqe *> (sqes);
+
+  char *sq = static_cast<char *> (this->sq_ring_);
+  this->sq_head_ = reinterpret_cast<unsigned int *> (sq + params.sq_off.head);
+  this->sq_tail_ = reinterpret_cast<unsigned int *> (sq + params.sq_off.tail);
+  this->sq_flags_ = reinterpret_cast<unsigned int *> (sq + params.sq_off.flags);
+  this->sq_mask_ = *reinterpret_cast<unsigned int *> (sq + params.sq_off.ring_mask);
+  this->sq_entries_ = *reinterpret_cast<unsigned int *> (sq + params.sq_off.ring_entries);
+  this->sq_array_ = reinterpret_cast<unsigned int *> (sq + params.sq_off.array);
+
+  char *cq = static_cast<char *> (this->cq_ring_);
+  this->cq_head_ = reinterpret_cast<unsigned int *> (cq + params.cq_off.head);
+  this->cq_tail_ = reinterpret_cast<unsigned int *> (cq + params.cq_off.tail);
+  this->cq_mask_ = *reinterpret_cast<unsigned int *> (cq + params.cq_off.ring_mask);
+  this->cqes_ = reinterpret_cast<struct io_uring_cqe *> (cq + params.cq_off.cqes);
+
+  return 0;
+}
+
+int
+ACE_Uring_Proactor::close (void)
+{
+  ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+
+  if (this->sqes_ != 0)
+    {
+      // Posted results are only known to the ring, so push out the
+      // queued entries and cancel the started operations; then wait
+      // for everything to come back before freeing the results.
+      for (size_t i = 0; i < this->max_aio_operations_; ++i)
+        if (this->slots_[i].result_ != 0)
+          this->cancel_slot_i (i);
+      this->submit_i ();
+
+      for (;;)
+        {
+          unsigned int head = *this->cq_head_;
+          unsigned int const tail =
+            __atomic_load_n (this->cq_tail_, __ATOMIC_ACQUIRE);
+
+          for (; head != tail; ++head)
+            {
+              struct io_uring_cqe *cqe = &this->cqes_[head & this->cq_mask_];
+              ACE_UINT64 const user_data = cqe->user_data;
+              if (user_data == 0)
+                continue;
+
+              if (ACE_BIT_ENABLED (user_data, URING_POSTED_BIT))
+                delete reinterpret_cast<ACE_POSIX_Asynch_Result *>
+                  (static_cast<uintptr_t> (user_data & ~URING_POSTED_BIT));
+              else
+                {
+                  size_t const slot =
+                    static_cast<size_t> ((user_data >> 1) - 1);
+                  ACE_POSIX_Asynch_Result *result =
+                    this->slots_[slot].result_;
+                  this->slots_[slot].result_ = 0;
+                  this->slots_[slot].owner_ = 0;
+                  this->free_slots_[this->max_aio_operations_
+                                    - this->num_started_aio_] = slot;
+                  --this->num_started_aio_;
+                  delete result;
+                }
+            }
+          __atomic_store_n (this->cq_head_, head, __ATOMIC_RELEASE);
+
+          if (this->num_started_aio_ == 0 && this->sq_pending_ == 0)
+            break;
+
+          if (ace_io_uring_enter (this->ring_fd_,
+                                  this->sq_pending_,
+                                  1,
+                                  IORING_ENTER_GETEVENTS) == -1
+              && errno != EINTR)
+            {
+              ACELIB_ERROR ((LM_ERROR,
+                             ACE_TEXT ("%N:%l:(%P | %t)::%p\n"),
+                             ACE_TEXT ("ACE_Uring_Proactor::close:")
+                             ACE_TEXT ("io_uring_enter")));
+              break;
+            }
+          this->sq_pending_ = 0;
+        }
+
+      ACE_OS::munmap (this->sqes_, this->sqes_size_);
+      this->sqes_ = 0;
+    }
+
+  if (this->cq_ring_ != MAP_FAILED && this->cq_ring_ != this->sq_ring_)
+    ACE_OS::munmap (this->cq_ring_, this->cq_ring_size_);
+  this->cq_ring_ = MAP_FAILED;
+
+  if (this->sq_ring_ != MAP_FAILED)
+    ACE_OS::munmap (this->sq_ring_, this->sq_ring_size_);
+  this->sq_ring_ = MAP_FAILED;
+
+  if (this->ring_fd_ != ACE_INVALID_HANDLE)
+    {
+      ACE_OS::close (this->ring_fd_);
+      this->ring_fd_ = ACE_INVALID_HANDLE;
+    }
+
+  // Anything the kernel never saw is dropped.
+  for (size_t i = 0; i < this->max_aio_operations_; ++i)
+    if (this->slots_[i].result_ != 0)
+      {
+        delete this->slots_[i].result_;
+        this->slots_[i].result_ = 0;
+      }
+  this->num_started_aio_ = 0;
+
+  this->wakeup_pipe_.close ();
+  this->wakeup_pending_ = false;
+
+  return 0;
+}
+
+int
+ACE_Uring_Proactor::handle_events (ACE_Time_Value &wait_time)
+{
+  return this->handle_events_i (&wait_time);
+}
+
+int
+ACE_Uring_Proactor::handle_events (void)
+{
+  return this->handle_events_i (0);
+}
+
+int
+ACE_Uring_Proactor::handle_events_i (ACE_Time_Value *max_wait)
+{
+  if (this->ring_fd_ == ACE_INVALID_HANDLE)
+    ACE_NOTSUP_RETURN (-1);
+
+  // Decrement <max_wait> with the amount of time spent in the method
+  ACE_Countdown_Time countdown (max_wait);
+
+  for (;;)
+    {
+      bool const wait =
+        max_wait == 0 || *max_wait != ACE_Time_Value::zero;
+
+      int const dispatched = this->dispatch_completions (wait);
+      if (dispatched != 0)
+        return dispatched > 0 ? 1 : -1;
+
+      if (!wait)
+        return 0;
+
+      // The ring descriptor polls readable while completions are
+      // waiting in the completion ring; the pipe is written to when
+      // other threads queue submissions.
+      struct pollfd pfd[2];
+      pfd[0].fd = this->ring_fd_;
+      pfd[0].events = POLLIN;
+      pfd[0].revents = 0;
+      pfd[1].fd = this->wakeup_pipe_.read_handle ();
+      pfd[1].events = POLLIN;
+      pfd[1].revents = 0;
+
+      int const rc = ACE_OS::poll (pfd, 2, max_wait);
+
+      {
+        ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+        --this->num_waiters_;
+      }
+
+      if (rc == -1 && errno != EINTR)
+        return -1;
+      if (rc == 0)
+        return 0;
+
+      countdown.update ();
+    }
+}
+
+int
+ACE_Uring_Proactor::dispatch_completions (bool wait)
+{
+  struct Completion
+  {
+    ACE_POSIX_Asynch_Result *result_;
+    size_t bytes_;
+    u_long error_;
+  };
+
+  Completion batch[MAX_COMPLETIONS_PER_DISPATCH];
+  int count = 0;
+
+  {
+    ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+
+    if (this->ring_fd_ == ACE_INVALID_HANDLE)
+      ACE_NOTSUP_RETURN (-1);
+
+    if (this->wakeup_pending_)
+      {
+        char buf[64];
+        while (ACE_OS::read (this->wakeup_pipe_.read_handle (),
+                             buf,
+                             sizeof buf) > 0)
+          continue;
+        this->wakeup_pending_ = false;
+      }
+
+    if (this->sq_pending_ > 0 && this->submit_i () == -1)
+      ACELIB_ERROR ((LM_ERROR,
+                     ACE_TEXT ("%N:%l:(%P | %t)::%p\n"),
+                     ACE_TEXT ("ACE_Uring_Proactor::dispatch_completions:")
+                     ACE_TEXT ("submit")));
+
+    unsigned int head = *this->cq_head_;
+    unsigned int tail = __atomic_load_n (this->cq_tail_, __ATOMIC_ACQUIRE);
+
+    // Completions the kernel couldn't fit into the ring are only moved
+    // over by io_uring_enter().
+    if (head == tail
+        && ACE_BIT_ENABLED (__atomic_load_n (this->sq_flags_, __ATOMIC_RELAXED),
+                            IORING_SQ_CQ_OVERFLOW))
+      {
+        ace_io_uring_enter (this->ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+        tail = __atomic_load_n (this->cq_tail_, __ATOMIC_ACQUIRE);
+      }
+
+    for (; head != tail && count < MAX_COMPLETIONS_PER_DISPATCH; ++head)
+      {
+        struct io_uring_cqe *cqe = &this->cqes_[head & this->cq_mask_];
+        ACE_UINT64 const user_data = cqe->user_data;
+        if (user_data == 0)
+          continue;
+
+        Completion &c = batch[count++];
+        if (ACE_BIT_ENABLED (user_data, URING_POSTED_BIT))
+          {
+            c.result_ = reinterpret_cast<ACE_POSIX_Asynch_Result *>
+              (static_cast<uintptr_t> (user_data & ~URING_POSTED_BIT));
+            c.bytes_ = c.result_->bytes_transferred ();
+            c.error_ = c.result_->error ();
+          }
+        else
+          c.result_ =
+            this->complete_slot_i (static_cast<size_t> ((user_data >> 1) - 1),
+                                   cqe->res,
+                                   c.bytes_,
+                                   c.error_);
+      }
+
+    __atomic_store_n (this->cq_head_, head, __ATOMIC_RELEASE);
+
+    // Checked by <start_submit_i> under the same lock, so no
+    // submission can slip in between the flush above and the wait.
+    if (count == 0 && wait)
+      ++this->num_waiters_;
+  }
+
+  if (count == 0)
+    return 0;
+
+  // Operations started from the upcalls are only queued; they are
+  // submitted together once the whole batch has been dispatched.
+  int &dispatching = *this->dispatching_;
+  ++dispatching;
+
+  for (int i = 0; i < count; ++i)
+    this->application_specific_code (batch[i].result_,
+                                     batch[i].bytes_,
+                                     0,  // No completion key.
+                                     batch[i].error_);
+
+  --dispatching;
+
+  {
+    ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+    if (this->sq_pending_ > 0 && this->submit_i () == -1)
+      ACELIB_ERROR ((LM_ERROR,
+                     ACE_TEXT ("%N:%l:(%P | %t)::%p\n"),
+                     ACE_TEXT ("ACE_Uring_Proactor::dispatch_completions:")
+                     ACE_TEXT ("submit")));
+  }
+
+  return count;
+}
+
+ACE_POSIX_Asynch_Result *
+ACE_Uring_Proactor::complete_slot_i (size_t slot,
+                                     int res,
+                                     size_t &bytes,
+                                     u_long &error)
+{
+  Aio_Slot &s = this->slots_[slot];
+  ACE_POSIX_Asynch_Result *result = s.result_;
+  s.result_ = 0;
+  s.owner_ = 0;
+  this->free_slots_[this->max_aio_operations_ - this->num_started_aio_] = slot;
+  --this->num_started_aio_;
+
+  bytes = 0;
+  error = res < 0 ? static_cast<u_long> (-res) : 0;
+
+  switch (result->aio_lio_opcode)
+    {
+    case ACE_OPCODE_ACCEPT:
+      // The listen handle is replaced by the new connection.
+      result->aio_fildes = res < 0 ? ACE_INVALID_HANDLE : res;
+      break;
+
+    case ACE_OPCODE_CONNECT:
+      if (res >= 0)
+        {
+          int sockerror = 0;
+          int lsockerror = sizeof sockerror;
+          ACE_OS::getsockopt (result->aio_fildes,
+                              SOL_SOCKET,
+                              SO_ERROR,
+                              (char *) &sockerror,
+                              &lsockerror);
+          error = sockerror;
+        }
+      break;
+
+    default:
+      if (res > 0)
+        bytes = static_cast<size_t> (res);
+      break;
+    }
+
+  return result;
+}
+
+struct io_uring_sqe *
+ACE_Uring_Proactor::get_sqe_i (void)
+{
+  unsigned int const tail = *this->sq_tail_;
+  if (tail - __atomic_load_n (this->sq_head_, __ATOMIC_ACQUIRE)
+      >= this->sq_entries_)
+    {
+      this->submit_i ();
+      if (tail - __atomic_load_n (this->sq_head_, __ATOMIC_ACQUIRE)
+          >= this->sq_entries_)
+        {
+          errno = EAGAIN;
+          return 0;
+        }
+    }
+
+  unsigned int const index = tail & this->sq_mask_;
+  struct io_uring_sqe *sqe = &this->sqes_[index];
+  ACE_OS::memset (sqe, 0, sizeof *sqe);
+  this->sq_array_[index] = index;
+
+  // The kernel only looks at the submission ring from io_uring_enter(),
+  // which is called under <mutex_> as well, so the entry can be
+  // published before the caller fills it in.
+  __atomic_store_n (this->sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  ++this->sq_pending_;
+
+  return sqe;
+}
+
+int
+ACE_Uring_Proactor::submit_i (void)
+{
+  while (this->sq_pending_ > 0)
+    {
+      int const n = ace_io_uring_enter (this->ring_fd_,
+                                        this->sq_pending_,
+                                        0,
+                                        0);
+      if (n == -1)
+        {
+          if (errno == EINTR)
+            continue;
+          return -1;
+        }
+      if (n == 0)
+        {
+          errno = EAGAIN;
+          return -1;
+        }
+
+      this->sq_pending_ -= n;
+    }
+
+  return 0;
+}
+
+void
+ACE_Uring_Proactor::start_submit_i (void)
+{
+  // The kernel cancels the requests of a thread when it exits, so
+  // entries are only handed over by threads dispatching completions:
+  // this one at the end of its batch, or a waiting one.
+  if (*this->dispatching_ != 0
+      || this->num_waiters_ == 0
+      || this->wakeup_pending_)
+    return;
+
+  if (ACE_OS::write (this->wakeup_pipe_.write_handle (), "", 1) == 1)
+    this->wakeup_pending_ = true;
+  else
+    ACELIB_ERROR ((LM_ERROR,
+                   ACE_TEXT ("%N:%l:(%P | %t)::%p\n"),
+                   ACE_TEXT ("ACE_Uring_Proactor::start_submit_i:")
+                   ACE_TEXT ("write")));
+}
+
+int
+ACE_Uring_Proactor::post_completion (ACE_POSIX_Asynch_Result *result)
+{
+  ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+
+  if (result == 0)
+    return -1;
+
+  if (this->ring_fd_ == ACE_INVALID_HANDLE)
+    ACE_NOTSUP_RETURN (-1);
+
+  struct io_uring_sqe *sqe = this->get_sqe_i ();
+  if (sqe == 0)
+    return -1;
+
+  sqe->opcode = IORING_OP_NOP;
+  sqe->user_data = reinterpret_cast<uintptr_t> (result) | URING_POSTED_BIT;
+
+  this->start_submit_i ();
+  return 0;
+}
+
+int
+ACE_Uring_Proactor::start_aio (ACE_POSIX_Asynch_Result *result,
+                               ACE_POSIX_Proactor::Opcode op)
+{
+  return this->start_aio (result, op, 0);
+}
+
+int
+ACE_Uring_Proactor::start_aio (ACE_POSIX_Asynch_Result *result,
+                               ACE_POSIX_Proactor::Opcode op,
+                               const void *owner)
+{
+  ACE_TRACE ("ACE_Uring_Proactor::start_aio");
+
+  if (this->ring_fd_ == ACE_INVALID_HANDLE)
+    ACE_NOTSUP_RETURN (-1);
+
+  switch (op)
+    {
+    case ACE_OPCODE_READ:
+    case ACE_OPCODE_WRITE:
+    case ACE_OPCODE_ACCEPT:
+    case ACE_OPCODE_CONNECT:
+      break;
+    default:
+      errno = EINVAL;
+      return -1;
+    }
+
+  ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+
+  if (this->num_started_aio_ >= this->max_aio_operations_)
+    {
+      errno = EAGAIN;
+      return -1;
+    }
+
+  if (result == 0) // Just check the status of the list
+    return 0;
+
+  struct io_uring_sqe *sqe = this->get_sqe_i ();
+  if (sqe == 0)
+    return -1;
+
+  size_t const slot =
+    this->free_slots_[this->max_aio_operations_ - this->num_started_aio_ - 1];
+  ++this->num_started_aio_;
+  this->slots_[slot].result_ = result;
+  this->slots_[slot].owner_ = owner;
+
+  result->aio_lio_opcode = op;
+
+  switch (op)
+    {
+    case ACE_OPCODE_READ:
+    case ACE_OPCODE_WRITE:
+      sqe->opcode = op == ACE_OPCODE_READ ? IORING_OP_READ : IORING_OP_WRITE;
+      sqe->fd = result->aio_fildes;
+      sqe->addr = reinterpret_cast<uintptr_t> (result->aio_buf);
+      sqe->len = static_cast<ACE_UINT32> (result->aio_nbytes);
+      sqe->off = result->aio_offset;
+      break;
+
+    case ACE_OPCODE_ACCEPT:
+      // <aio_fildes> holds the listen handle until the accept
+      // completes.
+      sqe->opcode = IORING_OP_ACCEPT;
+      sqe->fd = result->aio_fildes;
+      break;
+
+    default:
+      {
+        // Wait for the non-blocking connect to finish.
+        ACE_UINT32 events = POLLOUT;
+#if !defined (ACE_LITTLE_ENDIAN)
+        events = (events << 16) | (events >> 16);
+#endif /* !ACE_LITTLE_ENDIAN */
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = result->aio_fildes;
+        sqe->poll32_events = events;
+      }
+      break;
+    }
+
+  sqe->user_data = static_cast<ACE_UINT64> (slot + 1) << 1;
+
+  this->start_submit_i ();
+  return 0;
+}
+
+int
+ACE_Uring_Proactor::cancel_slot_i (size_t slot)
+{
+  struct io_uring_sqe *sqe = this->get_sqe_i ();
+  if (sqe == 0)
+    return -1;
+
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = static_cast<ACE_UINT64> (slot + 1) << 1;
+  sqe->user_data = 0;
+  return 0;
+}
+
+int
+ACE_Uring_Proactor::cancel_aio (ACE_HANDLE h)
+{
+  ACE_TRACE ("ACE_Uring_Proactor::cancel_aio");
+
+  if (h == ACE_INVALID_HANDLE)
+    return 1;
+
+  ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+
+  if (this->ring_fd_ == ACE_INVALID_HANDLE)
+    ACE_NOTSUP_RETURN (-1);
+
+  int num_cancelled = 0;
+  for (size_t i = 0; i < this->max_aio_operations_; ++i)
+    if (this->slots_[i].result_ != 0
+        && this->slots_[i].result_->aio_fildes == h)
+      {
+        if (this->cancel_slot_i (i) == -1)
+          return -1;
+        ++num_cancelled;
+      }
+
+  if (num_cancelled == 0)
+    return 1; // AIO_ALLDONE
+
+  this->start_submit_i ();
+  return 0;   // AIO_CANCELED
+}
+
+int
+ACE_Uring_Proactor::cancel_owner (const void *owner)
+{
+  ACE_TRACE ("ACE_Uring_Proactor::cancel_owner");
+
+  if (owner == 0)
+    return 1;
+
+  ACE_MT (ACE_GUARD_RETURN (ACE_SYNCH_MUTEX, ace_mon, this->mutex_, -1));
+
+  if (this->ring_fd_ == ACE_INVALID_HANDLE)
+    ACE_NOTSUP_RETURN (-1);
+
+  int num_cancelled = 0;
+  for (size_t i = 0; i < this->max_aio_operations_; ++i)
+    if (this->slots_[i].result_ != 0 && this->slots_[i].owner_ == owner)
+      {
+        if (this->cancel_slot_i (i) == -1)
+          return -1;
+        ++num_cancelled;
+      }
+
+  if (num_cancelled == 0)
+    return 1; // AIO_ALLDONE
+
+  this->start_submit_i ();
+  return 0;   // AIO_CANCELED
+}
+
+ACE_Asynch_Accept_Impl *
+ACE_Uring_Proactor::create_asynch_accept (void)
+{
+  ACE_Asynch_Accept_Impl *implementation = 0;
+  ACE_NEW_RETURN (implementation,
+                  ACE_Uring_Asynch_Accept (this),
+                  0);
+  return implementation;
+}
+
+ACE_Asynch_Connect_Impl *
+ACE_Uring_Proactor::create_asynch_connect (void)
+{
+  ACE_Asynch_Connect_Impl *implementation = 0;
+  ACE_NEW_RETURN (implementation,
+                  ACE_Uring_Asynch_Connect (this),
+                  0);
+  return implementation;
+}
+
+// *********************************************************************
+
+ACE_Uring_Asynch_Accept::ACE_Uring_Asynch_Accept (ACE_Uring_Proactor *proactor)
+  : ACE_POSIX_Asynch_Operation (proactor),
+    uring_proactor_ (proactor)
+{
+}
+
+ACE_Uring_Asynch_Accept::~ACE_Uring_Asynch_Accept (void)
+{
+  this->cancel ();
+}
+
+int
+ACE_Uring_Asynch_Accept::open (const ACE_Handler::Proxy_Ptr &handler_proxy,
+                               ACE_HANDLE handle,
+                               const void *completion_key,
+                               ACE_Proactor *proactor)
+{
+  ACE_TRACE ("ACE_Uring_Asynch_Accept::open");
+
+  if (this->handle_ != ACE_INVALID_HANDLE)
+    ACELIB_ERROR_RETURN ((LM_ERROR,
+                          ACE_TEXT ("%N:%l:ACE_Uring_Asynch_Accept::open:")
+                          ACE_TEXT ("acceptor already open\n")),
+                         -1);
+
+  return ACE_POSIX_Asynch_Operation::open (handler_proxy,
+                                           handle,
+                                           completion_key,
+                                           proactor);
+}
+
+int
+ACE_Uring_Asynch_Accept::accept (ACE_Message_Block &message_block,
+                                 size_t bytes_to_read,
+                                 ACE_HANDLE accept_handle,
+                                 const void *act,
+                                 int priority,
+                                 int signal_number,
+                                 int addr_family)
+{
+  ACE_TRACE ("ACE_Uring_Asynch_Accept::accept");
+
+  if (this->handle_ == ACE_INVALID_HANDLE)
+    ACELIB_ERROR_RETURN ((LM_ERROR,
+                          ACE_TEXT ("%N:%l:ACE_Uring_Asynch_Accept::accept")
+                          ACE_TEXT ("acceptor was not opened before\n")),
+                         -1);
+
+  // Sanity check: make sure that enough space has been allocated by
+  // the caller.
+  size_t address_size = sizeof (sockaddr_in);
+#if defined (ACE_HAS_IPV6)
+  if (addr_family == AF_INET6)
+    address_size = sizeof (sockaddr_in6);
+#else
+  ACE_UNUSED_ARG (addr_family);
+#endif
+  if (message_block.space () < bytes_to_read + 2 * address_size)
+    {
+      ACE_OS::last_error (ENOBUFS);
+      return -1;
+    }
+
+  // The kernel always creates the new handle; <accept_handle> is
+  // replaced on completion.
+  ACE_UNUSED_ARG (accept_handle);
+
+  ACE_POSIX_Asynch_Accept_Result *result = 0;
+  ACE_NEW_RETURN (result,
+                  ACE_POSIX_Asynch_Accept_Result (this->handler_proxy_,
+                                                  this->handle_,
+                                                  this->handle_,
+                                                  message_block,
+                                                  bytes_to_read,
+                                                  act,
+                                                  this->uring_proactor_->get_handle (),
+                                                  priority,
+                                                  signal_number),
+                  -1);
+
+  if (this->uring_proactor_->start_aio (result,
+                                        ACE_POSIX_Proactor::ACE_OPCODE_ACCEPT,
+                                        this) == -1)
+    {
+      delete result;
+      return -1;
+    }
+
+  return 0;
+}
+
+int
+ACE_Uring_Asynch_Accept::cancel (void)
+{
+  ACE_TRACE ("ACE_Uring_Asynch_Accept::cancel");
+  return this->uring_proactor_->cancel_owner (this);
+}
+
+// *********************************************************************
+
+ACE_Uring_Asynch_Connect::ACE_Uring_Asynch_Connect (ACE_Uring_Proactor *proactor)
+  : ACE_POSIX_Asynch_Operation (proactor),
+    uring_proactor_ (proactor)
+{
+}
+
+ACE_Uring_Asynch_Connect::~ACE_Uring_Asynch_Connect (void)
+{
+  this->cancel ();
+}
+
+int
+ACE_Uring_Asynch_Connect::open (const ACE_Handler::Proxy_Ptr &handler_proxy,
+                                ACE_HANDLE handle,
+                                const void *completion_key,
+                                ACE_Proactor *proactor)
+{
+  ACE_TRACE ("ACE_Uring_Asynch_Connect::open");
+
+  // Ignore result as we pass ACE_INVALID_HANDLE
+  ACE_POSIX_Asynch_Operation::open (handler_proxy,
+                                    handle,
+                                    completion_key,
+                                    proactor);
+  return 0;
+}
+
+int
+ACE_Uring_Asynch_Connect::connect (ACE_HANDLE connect_handle,
+                                   const ACE_Addr &remote_sap,
+                                   const ACE_Addr &local_sap,
+                                   int reuse_addr,
+                                   const void *act,
+                                   int priority,
+                                   int signal_number)
+{
+  ACE_TRACE ("ACE_Uring_Asynch_Connect::connect");
+
+  ACE_POSIX_Asynch_Connect_Result *result = 0;
+  ACE_NEW_RETURN (result,
+                  ACE_POSIX_Asynch_Connect_Result (this->handler_proxy_,
+                                                   connect_handle,
+                                                   act,
+                                                   this->uring_proactor_->get_handle (),
+                                                   priority,
+                                                   signal_number),
+                  -1);
+
+  int const rc = this->connect_i (result, remote_sap, local_sap, reuse_addr);
+
+  if (rc == 0
+      && this->uring_proactor_->start_aio (result,
+                                           ACE_POSIX_Proactor::ACE_OPCODE_CONNECT,
+                                           this) == 0)
+    return 0;
+
+  if (rc == 0)
+    result->set_error (errno);
+
+  // The connect finished (or failed) right away: report it as a
+  // completion, as the other POSIX proactors do.
+  if (this->uring_proactor_->post_completion (result) == 0)
+    return 0;
+
+  ACELIB_ERROR ((LM_ERROR,
+                 ACE_TEXT ("Error:(%P | %t):%p\n"),
+                 ACE_TEXT ("ACE_Uring_Asynch_Connect::connect: ")
+                 ACE_TEXT (" <post_completion> failed")));
+
+  if (result->connect_handle () != ACE_INVALID_HANDLE)
+    ACE_OS::closesocket (result->connect_handle ());
+  delete result;
+  return -1;
+}
+
+int
+ACE_Uring_Asynch_Connect::connect_i (ACE_POSIX_Asynch_Connect_Result *result,
+                                     const ACE_Addr &remote_sap,
+                                     const ACE_Addr &local_sap,
+                                     int reuse_addr)
+{
+  result->set_bytes_transferred (0);
+
+  ACE_HANDLE handle = result->connect_handle ();
+
+  if (handle == ACE_INVALID_HANDLE)
+    {
+      int protocol_family = remote_sap.get_type ();
+
+      handle = ACE_OS::socket (protocol_family, SOCK_STREAM, 0);
+      result->connect_handle (handle);
+      if (handle == ACE_INVALID_HANDLE)
+        {
+          result->set_error (errno);
+          ACELIB_ERROR_RETURN
+            ((LM_ERROR,
+              ACE_TEXT ("ACE_Uring_Asynch_Connect::connect_i: %p\n"),
+              ACE_TEXT ("socket")),
+             -1);
+        }
+
+      // Reuse the address
+      int one = 1;
+      if (protocol_family != PF_UNIX &&
+          reuse_addr != 0 &&
+          ACE_OS::setsockopt (handle,
+                              SOL_SOCKET,
+                              SO_REUSEADDR,
+                              (const char*) &one,
+                              sizeof one) == -1)
+        {
+          result->set_error (errno);
+          ACELIB_ERROR_RETURN
+            ((LM_ERROR,
+              ACE_TEXT ("ACE_Uring_Asynch_Connect::connect_i: %p\n"),
+              ACE_TEXT ("setsockopt")),
+             -1);
+        }
+    }
+
+  if (local_sap != ACE_Addr::sap_any)
+    {
+      sockaddr * laddr = reinterpret_cast<sockaddr *> (local_sap.get_addr ());
+      size_t size = local_sap.get_size ();
+
+      if (ACE_OS::bind (handle, laddr, size) == -1)
+        {
+          result->set_error (errno);
+          ACELIB_ERROR_RETURN
+            ((LM_ERROR,
+              ACE_TEXT ("ACE_Uring_Asynch_Connect::connect_i: %p\n"),
+              ACE_TEXT ("bind")),
+             -1);
+        }
+    }
+
+  // set non blocking mode; ACE_Asynch_Connector restores blocking
+  // mode once connected.
+  if (ACE::set_flags (handle, ACE_NONBLOCK) != 0)
+    {
+      result->set_error (errno);
+      ACELIB_ERROR_RETURN
+        ((LM_ERROR,
+          ACE_TEXT ("ACE_Uring_Asynch_Connect::connect_i: %p\n"),
+          ACE_TEXT ("set_flags")),
+         -1);
+    }
+
+  for (;;)
+    {
+      int rc = ACE_OS::connect
+        (handle,
+         reinterpret_cast<sockaddr *> (remote_sap.get_addr ()),
+         remote_sap.get_size ());
+      if (rc < 0)  // failure
+        {
+          if (errno == EWOULDBLOCK || errno == EINPROGRESS)
+            return 0; // connect started
+
+          if (errno == EINTR)
+            continue;
+
+          result->set_error (errno);
+        }
+
+      return 1;  // connect finished
+    }
+
+  ACE_NOTREACHED (return 0);
+}
+
+int
+ACE_Uring_Asynch_Connect::cancel (void)
+{
+  ACE_TRACE ("ACE_Uring_Asynch_Connect::cancel");
+  return this->uring_proactor_->cancel_owner (this);
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_AIO_CALLS && ACE_HAS_IO_URING */
@@ -0,0 +1,314 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Uring_Proactor.h
+ *
+ *  $Id$
+ *
+ *  Proactor implementation on top of the Linux io_uring submission
+ *  and completion rings.
+ */
+//=============================================================================
+
+#ifndef ACE_URING_PROACTOR_H
+#define ACE_URING_PROACTOR_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/config-all.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_AIO_CALLS) && defined (ACE_HAS_IO_URING)
+
+#include "ace/POSIX_Proactor.h"
+#include "ace/POSIX_Asynch_IO.h"
+#include "ace/Pipe.h"
+#include "ace/TSS_T.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+/**
+ * @class ACE_Uring_Proactor
+ *
+ * @brief Proactor implementation based on Linux io_uring.
+ *
+ * Reads and writes (stream, file and datagram), accepts and connects
+ * are started as io_uring submission queue entries, so no thread is
+ * spent waiting on an operation and the number of outstanding
+ * operations is not limited by the <aio_suspend> scan.  Transmit_File
+ * is layered on the read and write operations, as with the other
+ * POSIX proactors.
+ *
+ * Operations started from a completion upcall are queued in the
+ * submission ring and handed to the kernel with a single
+ * <io_uring_enter> once the thread has dispatched its batch of
+ * completions.  Since the kernel cancels the requests of a thread
+ * that exits, operations started by any other thread are queued as
+ * well and a thread waiting in <handle_events> is woken up to submit
+ * them.  Operations submitted by a thread that later leaves the event
+ * loop and exits still complete with ECANCELED.
+ *
+ * Completions posted by the application (timers, wakeups,
+ * <post_completion>) travel through the ring as no-op entries, so a
+ * single wait covers both kinds of completion.
+ */
+class ACE_Export ACE_Uring_Proactor : public ACE_POSIX_Proactor
+{
+public:
+  /// Constructor defines max number asynchronous operations that can
+  /// be started at the same time.
+  ACE_Uring_Proactor (size_t max_aio_operations = ACE_AIO_DEFAULT_SIZE);
+
+  /// Destructor.
+  virtual ~ACE_Uring_Proactor (void);
+
+  virtual Proactor_Type get_impl_type (void);
+
+  /// Return true if the kernel lets this process create an io_uring
+  /// with the features this proactor needs.  It may not, e.g., with
+  /// kernels older than 5.5 or when a seccomp filter blocks
+  /// io_uring, in which case the proactor cannot start operations.
+  static bool supported (void);
+
+  /// Close down the Proactor.  Outstanding operations are dropped
+  /// without upcalls.
+  virtual int close (void);
+
+  /**
+   * Dispatch a single set of events.  If @a wait_time elapses before
+   * any events occur, return 0.  Return 1 on success i.e., when a
+   * completion is dispatched, non-zero (-1) on errors and errno is
+   * set accordingly.
+   */
+  virtual int handle_events (ACE_Time_Value &wait_time);
+
+  /**
+   * Block indefinitely until at least one event is dispatched.
+   * Dispatch a single set of events.  Return 1 on success i.e., when
+   * a completion is dispatched, non-zero (-1) on errors and errno is
+   * set accordingly.
+   */
+  virtual int handle_events (void);
+
+  /// Post a result to the completion ring.
+  virtual int post_completion (ACE_POSIX_Asynch_Result *result);
+
+  /**
+   * Start an asynchronous operation.  Returns 0 on success and -1
+   * with errno set otherwise; EAGAIN means @a max_aio_operations are
+   * already outstanding.  A null @a result only checks whether
+   * another operation can be started.
+   */
+  virtual int start_aio (ACE_POSIX_Asynch_Result *result,
+                         ACE_POSIX_Proactor::Opcode op);
+
+  /// Same as above, remembering @a owner for <cancel_owner>.
+  int start_aio (ACE_POSIX_Asynch_Result *result,
+                 ACE_POSIX_Proactor::Opcode op,
+                 const void *owner);
+
+  /**
+   * Cancel all operations started on handle @a h.  Returns 0 if
+   * cancellation was requested for at least one operation (each one
+   * then completes with ECANCELED), 1 if there was nothing to cancel
+   * and -1 on errors.
+   */
+  virtual int cancel_aio (ACE_HANDLE h);
+
+  /// Cancel all operations started on behalf of @a owner.  Return
+  /// values are the same as for <cancel_aio>.
+  int cancel_owner (const void *owner);
+
+  /// Maximum number of completions dispatched per <handle_events>
+  /// call.
+  enum { MAX_COMPLETIONS_PER_DISPATCH = 64 };
+
+  virtual ACE_Asynch_Accept_Impl *create_asynch_accept (void);
+
+  virtual ACE_Asynch_Connect_Impl *create_asynch_connect (void);
+
+protected:
+  /// Bookkeeping for an operation in flight.
+  struct Aio_Slot
+  {
+    ACE_POSIX_Asynch_Result *result_;
+    const void *owner_;
+  };
+
+  /// Create the rings.  Returns -1 on failure.
+  int open_ring (unsigned int entries);
+
+  /// Wait at most @a max_wait (forever if 0) for completions and
+  /// dispatch them.
+  int handle_events_i (ACE_Time_Value *max_wait);
+
+  /// Submit the queued entries, then reap and dispatch up to
+  /// MAX_COMPLETIONS_PER_DISPATCH completions.  Returns the number
+  /// dispatched, or -1 on errors.  If there is nothing to dispatch and
+  /// @a wait is set, the caller is counted as waiting.
+  int dispatch_completions (bool wait);
+
+  /// Get a free submission entry, flushing the ring if it is full.
+  /// Must be called with <mutex_> held.
+  io_uring_sqe *get_sqe_i (void);
+
+  /// Hand the queued submission entries to the kernel.  Must be
+  /// called with <mutex_> held.
+  int submit_i (void);
+
+  /// Make sure queued entries get submitted: by the calling thread at
+  /// the end of its batch if it is dispatching completions, otherwise
+  /// by waking up a waiting thread.  Must be called with <mutex_> held.
+  void start_submit_i (void);
+
+  /// Queue cancellation of the operation in slot @a slot.
+  int cancel_slot_i (size_t slot);
+
+  /// Translate a completion queue entry for the operation in @a slot.
+  ACE_POSIX_Asynch_Result *complete_slot_i (size_t slot,
+                                            int res,
+                                            size_t &bytes,
+                                            u_long &error);
+
+  /// Protects the rings and the slots.
+  ACE_SYNCH_MUTEX mutex_;
+
+  /// The io_uring file descriptor.
+  ACE_HANDLE ring_fd_;
+
+  /// Mapped submission/completion rings and submission entries.
+  void *sq_ring_;
+  size_t sq_ring_size_;
+  void *cq_ring_;
+  size_t cq_ring_size_;
+  io_uring_sqe *sqes_;
+  size_t sqes_size_;
+
+  /// Pointers into the mapped rings.
+  unsigned int *sq_head_;
+  unsigned int *sq_tail_;
+  unsigned int *sq_flags_;
+  unsigned int sq_mask_;
+  unsigned int sq_entries_;
+  unsigned int *sq_array_;
+  unsigned int *cq_head_;
+  unsigned int *cq_tail_;
+  unsigned int cq_mask_;
+  io_uring_cqe *cqes_;
+
+  /// Entries queued but not yet handed to the kernel.
+  unsigned int sq_pending_;
+
+  /// Wakes up threads waiting in <handle_events_i>.
+  ACE_Pipe wakeup_pipe_;
+  bool wakeup_pending_;
+
+  /// Number of threads waiting in <handle_events_i>.
+  size_t num_waiters_;
+
+  /// Operations in flight and the stack of free slots.
+  Aio_Slot *slots_;
+  size_t *free_slots_;
+  size_t max_aio_operations_;
+  size_t num_started_aio_;
+
+  /// Non-zero while the calling thread dispatches completions.
+  ACE_TSS<ACE_TSS_Type_Adapter<int> > dispatching_;
+};
+
+/**
+ * @class ACE_Uring_Asynch_Accept
+ *
+ * @brief Asynchronous accept started as an IORING_OP_ACCEPT.
+ *
+ * No data is read along with the connection; the new handle is
+ * reported in the result's <accept_handle>.
+ */
+class ACE_Export ACE_Uring_Asynch_Accept :
+  public virtual ACE_Asynch_Accept_Impl,
+  public ACE_POSIX_Asynch_Operation
+{
+public:
+  ACE_Uring_Asynch_Accept (ACE_Uring_Proactor *proactor);
+
+  /// Cancels the pending accepts.
+  virtual ~ACE_Uring_Asynch_Accept (void);
+
+  int open (const ACE_Handler::Proxy_Ptr &handler_proxy,
+            ACE_HANDLE handle,
+            const void *completion_key,
+            ACE_Proactor *proactor = 0);
+
+  int accept (ACE_Message_Block &message_block,
+              size_t bytes_to_read,
+              ACE_HANDLE accept_handle,
+              const void *act,
+              int priority,
+              int signal_number = 0,
+              int addr_family = AF_INET);
+
+  /// Cancel all pending accepts.  They complete with ECANCELED.
+  int cancel (void);
+
+private:
+  ACE_Uring_Proactor *uring_proactor_;
+};
+
+/**
+ * @class ACE_Uring_Asynch_Connect
+ *
+ * @brief Asynchronous connect: a non-blocking <connect> whose
+ * completion is awaited with an IORING_OP_POLL_ADD.
+ */
+class ACE_Export ACE_Uring_Asynch_Connect :
+  public virtual ACE_Asynch_Connect_Impl,
+  public ACE_POSIX_Asynch_Operation
+{
+public:
+  ACE_Uring_Asynch_Connect (ACE_Uring_Proactor *proactor);
+
+  /// Cancels the pending connects.
+  virtual ~ACE_Uring_Asynch_Connect (void);
+
+  int open (const ACE_Handler::Proxy_Ptr &handler_proxy,
+            ACE_HANDLE handle,
+            const void *completion_key,
+            ACE_Proactor *proactor = 0);
+
+  int connect (ACE_HANDLE connect_handle,
+               const ACE_Addr &remote_sap,
+               const ACE_Addr &local_sap,
+               int reuse_addr,
+               const void *act,
+               int priority,
+               int signal_number = 0);
+
+  /// Cancel all pending connects.  They complete with ECANCELED.
+  int cancel (void);
+
+private:
+  /// Create, bind and start connecting the socket.  Returns 0 if the
+  /// connect is in progress, 1 if it finished and -1 on errors, with
+  /// the error stored in @a result.
+  int connect_i (ACE_POSIX_Asynch_Connect_Result *result,
+                 const ACE_Addr &remote_sap,
+                 const ACE_Addr &local_sap,
+                 int reuse_addr);
+
+  ACE_Uring_Proactor *uring_proactor_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_AIO_CALLS && ACE_HAS_IO_URING */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_URING_PROACTOR_H */
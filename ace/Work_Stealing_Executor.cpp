@@ -0,0 +1,594 @@
+// $Id$
+
+#include "ace/Work_Stealing_Executor.h"
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+#if !defined (__ACE_INLINE__)
+#include "ace/Work_Stealing_Executor.inl"
+#endif /* __ACE_INLINE__ */
+
+#include "ace/Method_Request.h"
+#include "ace/Guard_T.h"
+#include "ace/Log_Category.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_Thread.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_Memory.h"
+#include "ace/Truncate.h"
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_Work_Stealing_Deque::ACE_Work_Stealing_Deque (size_t initial_capacity)
+  : top_ (0),
+    bottom_ (0),
+    buffer_ (0),
+    thieves_ (0)
+{
+  // The capacity must be a power of two.
+  size_t capacity = 1;
+  while (capacity < initial_capacity)
+    capacity <<= 1;
+  this->buffer_.store (this->new_buffer (capacity));
+}
+
+ACE_Work_Stealing_Deque::~ACE_Work_Stealing_Deque (void)
+{
+  for (Buffer *buffer = this->buffer_.load (); buffer != 0; )
+    {
+      Buffer *retired = buffer->retired_;
+      delete [] buffer->slots_;
+      delete buffer;
+      buffer = retired;
+    }
+}
+
+ACE_Work_Stealing_Deque::Buffer *
+ACE_Work_Stealing_Deque::new_buffer (size_t capacity)
+{
+  Buffer *buffer = 0;
+  ACE_NEW_RETURN (buffer, Buffer, 0);
+  ACE_NEW_NORETURN (buffer->slots_,
+                    std::atomic<ACE_Method_Request *>[capacity]);
+  if (buffer->slots_ == 0)
+    {
+      delete buffer;
+      return 0;
+    }
+  buffer->mask_ = capacity - 1;
+  buffer->retired_ = 0;
+  return buffer;
+}
+
+ACE_Work_Stealing_Deque::Buffer *
+ACE_Work_Stealing_Deque::grow (Buffer *buffer, ssize_t top, ssize_t bottom)
+{
+  Buffer *bigger = this->new_buffer ((buffer->mask_ + 1) * 2);
+  if (bigger == 0)
+    return 0;
+
+  for (ssize_t i = top; i < bottom; ++i)
+    bigger->slots_[i & bigger->mask_].store
+      (buffer->slots_[i & buffer->mask_].load (std::memory_order_relaxed),
+       std::memory_order_relaxed);
+
+  // Thieves may still read from the old buffer, so keep it around
+  // until none can.
+  bigger->retired_ = buffer;
+  this->buffer_.store (bigger, std::memory_order_seq_cst);
+  this->reclaim (bigger);
+  return bigger;
+}
+
+void
+ACE_Work_Stealing_Deque::reclaim (Buffer *buffer)
+{
+  // A thief counts itself before it loads <buffer_>.  If no thief is
+  // counted after <buffer> was stored, any thief coming later reads
+  // <buffer> or a newer one, so the older buffers are unused.
+  if (this->thieves_.load (std::memory_order_seq_cst) != 0)
+    return;
+
+  for (Buffer *retired = buffer->retired_; retired != 0; )
+    {
+      Buffer *next = retired->retired_;
+      delete [] retired->slots_;
+      delete retired;
+      retired = next;
+    }
+  buffer->retired_ = 0;
+}
+
+int
+ACE_Work_Stealing_Deque::push (ACE_Method_Request *mr)
+{
+  ssize_t const bottom = this->bottom_.load (std::memory_order_relaxed);
+  ssize_t const top = this->top_.load (std::memory_order_acquire);
+  Buffer *buffer = this->buffer_.load (std::memory_order_relaxed);
+
+  if (bottom - top > static_cast<ssize_t> (buffer->mask_))
+    {
+      buffer = this->grow (buffer, top, bottom);
+      if (buffer == 0)
+        return -1;
+    }
+  else if (buffer->retired_ != 0)
+    this->reclaim (buffer);
+
+  buffer->slots_[bottom & buffer->mask_].store (mr, std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_release);
+  this->bottom_.store (bottom + 1, std::memory_order_relaxed);
+  return 0;
+}
+
+ACE_Method_Request *
+ACE_Work_Stealing_Deque::take (void)
+{
+  ssize_t const bottom = this->bottom_.load (std::memory_order_relaxed) - 1;
+  Buffer *buffer = this->buffer_.load (std::memory_order_relaxed);
+  this->bottom_.store (bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+  ssize_t top = this->top_.load (std::memory_order_relaxed);
+
+  ACE_Method_Request *mr = 0;
+  if (top <= bottom)
+    {
+      mr = buffer->slots_[bottom & buffer->mask_].load (std::memory_order_relaxed);
+      if (top == bottom)
+        {
+          // The last request: race the thieves for it.
+          if (!this->top_.compare_exchange_strong (top,
+                                                   top + 1,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed))
+            mr = 0;
+          this->bottom_.store (bottom + 1, std::memory_order_relaxed);
+        }
+    }
+  else
+    this->bottom_.store (bottom + 1, std::memory_order_relaxed);
+
+  return mr;
+}
+
+ACE_Method_Request *
+ACE_Work_Stealing_Deque::steal (void)
+{
+  ssize_t top = this->top_.load (std::memory_order_acquire);
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+  ssize_t const bottom = this->bottom_.load (std::memory_order_acquire);
+
+  if (top >= bottom)
+    return 0;
+
+  // Keep the owner from freeing the buffer while we read it.
+  this->thieves_.fetch_add (1, std::memory_order_seq_cst);
+  Buffer *buffer = this->buffer_.load (std::memory_order_seq_cst);
+  ACE_Method_Request *mr =
+    buffer->slots_[top & buffer->mask_].load (std::memory_order_relaxed);
+  this->thieves_.fetch_sub (1, std::memory_order_release);
+
+  if (!this->top_.compare_exchange_strong (top,
+                                           top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+    return 0;
+  return mr;
+}
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Work_Stealing_Executor)
+
+ACE_Work_Stealing_Executor::ACE_Work_Stealing_Executor (size_t max_threads,
+                                                        ACE_Thread_Manager *thr_mgr)
+  : ACE_Task_Base (thr_mgr),
+    workers_ (0),
+    max_threads_ (max_threads),
+    claimed_ (0),
+    free_ (0),
+    free_count_ (0),
+    work_available_ (lock_),
+    injected_ (0),
+    injected_capacity_ (0),
+    injected_head_ (0),
+    injected_count_ (0),
+    pending_ (0),
+    sleepers_ (0),
+    deactivated_ (false)
+{
+  if (this->thr_mgr () == 0)
+    this->thr_mgr (ACE_Thread_Manager::instance ());
+
+  if (this->max_threads_ > 0)
+    {
+      ACE_NEW_NORETURN (this->workers_, Worker[this->max_threads_]);
+      ACE_NEW_NORETURN (this->free_, size_t[this->max_threads_]);
+      if (this->workers_ == 0 || this->free_ == 0)
+        {
+          delete [] this->workers_;
+          this->workers_ = 0;
+          delete [] this->free_;
+          this->free_ = 0;
+          this->max_threads_ = 0;
+        }
+    }
+}
+
+ACE_Work_Stealing_Executor::~ACE_Work_Stealing_Executor (void)
+{
+  this->deactivate ();
+  this->wait ();
+
+  // Whatever was not executed is ours to delete.
+  for (ACE_Method_Request *mr = 0;
+       (mr = this->find_work (0)) != 0; )
+    delete mr;
+
+  // The calling thread's slot is deleted with <slot_>, after the
+  // deques.
+  this->slot_->executor_ = 0;
+
+  delete [] this->workers_;
+  delete [] this->free_;
+  delete [] this->injected_;
+}
+
+ACE_Work_Stealing_Executor::Slot::Slot (void)
+  : executor_ (0),
+    index_ (0)
+{
+}
+
+ACE_Work_Stealing_Executor::Slot::~Slot (void)
+{
+  if (this->executor_ != 0)
+    this->executor_->release_deque (this->index_ - 1);
+}
+
+void
+ACE_Work_Stealing_Executor::release_deque (size_t index)
+{
+  // The requests left on the deque are stolen by the other threads
+  // meanwhile, and the next owner takes over the rest.
+  ACE_GUARD (ACE_Thread_Mutex, ace_mon, this->lock_);
+  size_t const count = this->free_count_.load ();
+  this->free_[count] = index;
+  this->free_count_.store (count + 1);
+}
+
+ACE_Work_Stealing_Deque *
+ACE_Work_Stealing_Executor::current_deque (void)
+{
+  size_t const slot = this->slot_->index_;
+  if (slot == 0 || slot > this->max_threads_)
+    return 0;
+  return &this->workers_[slot - 1].deque_;
+}
+
+ACE_Work_Stealing_Deque *
+ACE_Work_Stealing_Executor::own_deque (void)
+{
+  Slot *slot = this->slot_;
+  if (slot == 0)
+    return 0;
+
+  // A thread that found none left tries again once one is given back.
+  if (slot->index_ == 0
+      || (slot->index_ > this->max_threads_
+          && this->free_count_.load () > 0))
+    {
+      ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->lock_, 0);
+
+      size_t const free_count = this->free_count_.load ();
+      size_t const claimed = this->claimed_.load ();
+      if (free_count > 0)
+        {
+          slot->index_ = this->free_[free_count - 1] + 1;
+          this->free_count_.store (free_count - 1);
+        }
+      else if (claimed < this->max_threads_)
+        {
+          slot->index_ = claimed + 1;
+          this->claimed_.store (claimed + 1);
+        }
+      else
+        slot->index_ = this->max_threads_ + 1;
+
+      if (slot->index_ <= this->max_threads_)
+        slot->executor_ = this;
+    }
+
+  if (slot->index_ > this->max_threads_)
+    return 0;
+  return &this->workers_[slot->index_ - 1].deque_;
+}
+
+int
+ACE_Work_Stealing_Executor::inject_i (ACE_Method_Request *mr)
+{
+  if (this->injected_count_ == this->injected_capacity_)
+    {
+      size_t const capacity =
+        this->injected_capacity_ == 0 ? 64 : this->injected_capacity_ * 2;
+      ACE_Method_Request **ring = 0;
+      ACE_NEW_RETURN (ring, ACE_Method_Request *[capacity], -1);
+      for (size_t i = 0; i < this->injected_count_; ++i)
+        ring[i] =
+          this->injected_[(this->injected_head_ + i) % this->injected_capacity_];
+      delete [] this->injected_;
+      this->injected_ = ring;
+      this->injected_capacity_ = capacity;
+      this->injected_head_ = 0;
+    }
+
+  this->injected_[(this->injected_head_ + this->injected_count_)
+                  % this->injected_capacity_] = mr;
+  ++this->injected_count_;
+  return 0;
+}
+
+void
+ACE_Work_Stealing_Executor::wake_one (void)
+{
+  // Pairs with the fence in <dequeue>: either the waiter sees the new
+  // request, or we see the waiter.
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+  if (this->sleepers_.load (std::memory_order_relaxed) > 0)
+    {
+      ACE_GUARD (ACE_Thread_Mutex, ace_mon, this->lock_);
+      this->work_available_.signal ();
+    }
+}
+
+int
+ACE_Work_Stealing_Executor::enqueue (ACE_Method_Request *mr,
+                                     ACE_Time_Value *)
+{
+  if (this->deactivated_.load ())
+    {
+      errno = ESHUTDOWN;
+      return -1;
+    }
+
+  // Count the request first, so that nobody goes to sleep while it is
+  // on its way.
+  size_t const pending = ++this->pending_;
+
+  ACE_Work_Stealing_Deque *own = this->current_deque ();
+  if (own != 0)
+    {
+      if (own->push (mr) == -1)
+        {
+          --this->pending_;
+          return -1;
+        }
+      this->wake_one ();
+    }
+  else
+    {
+      ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->lock_, -1);
+      if (this->inject_i (mr) == -1)
+        {
+          --this->pending_;
+          return -1;
+        }
+      if (this->sleepers_.load () > 0)
+        this->work_available_.signal ();
+    }
+
+  return ACE_Utils::truncate_cast<int> (pending);
+}
+
+ACE_Method_Request *
+ACE_Work_Stealing_Executor::take_injected (ACE_Work_Stealing_Deque *own)
+{
+  ACE_Method_Request *batch[INJECTION_BATCH];
+  size_t count = 0;
+  {
+    ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->lock_, 0);
+
+    size_t const wanted = own == 0 ? 1 : INJECTION_BATCH;
+    while (count < wanted && this->injected_count_ > 0)
+      {
+        batch[count++] = this->injected_[this->injected_head_];
+        this->injected_head_ =
+          (this->injected_head_ + 1) % this->injected_capacity_;
+        --this->injected_count_;
+      }
+  }
+
+  if (count == 0)
+    return 0;
+
+  // Push the rest in reverse order, so that the owner takes them in
+  // enqueue order from the bottom while thieves get the newest.
+  for (size_t i = count - 1; i > 0; --i)
+    if (own->push (batch[i]) == -1)
+      {
+        // Out of memory: put it back where it came from.
+        ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->lock_, batch[0]);
+        this->inject_i (batch[i]);
+      }
+
+  if (count > 1)
+    this->wake_one ();
+
+  return batch[0];
+}
+
+ACE_Method_Request *
+ACE_Work_Stealing_Executor::steal (ACE_Work_Stealing_Deque *own)
+{
+  size_t const claimed = ACE_MIN (this->claimed_.load (), this->max_threads_);
+  if (claimed == 0)
+    return 0;
+
+  // Start with a different victim each time around.
+  size_t const start =
+    own == 0 ? 0 : static_cast<size_t> (own - &this->workers_[0].deque_);
+  for (size_t i = 1; i <= claimed; ++i)
+    {
+      ACE_Work_Stealing_Deque &victim =
+        this->workers_[(start + i) % claimed].deque_;
+      if (&victim == own)
+        continue;
+
+      ACE_Method_Request *mr = victim.steal ();
+      if (mr != 0)
+        return mr;
+    }
+  return 0;
+}
+
+ACE_Method_Request *
+ACE_Work_Stealing_Executor::find_work (ACE_Work_Stealing_Deque *own)
+{
+  ACE_Method_Request *mr = 0;
+
+  if (own != 0)
+    mr = own->take ();
+  if (mr == 0)
+    mr = this->take_injected (own);
+  if (mr == 0)
+    mr = this->steal (own);
+
+  if (mr != 0)
+    --this->pending_;
+  return mr;
+}
+
+ACE_Method_Request *
+ACE_Work_Stealing_Executor::dequeue (ACE_Time_Value *timeout)
+{
+  ACE_Work_Stealing_Deque *own = this->own_deque ();
+
+  for (size_t spins = 0; ; )
+    {
+      ACE_Method_Request *mr = this->find_work (own);
+      if (mr != 0)
+        return mr;
+
+      // A request is counted before it is pushed, so spin a little
+      // while one is on its way or being stolen by somebody else.
+      if (this->pending_.load () > 0 && spins < SPIN_LIMIT)
+        {
+          ++spins;
+          ACE_OS::thr_yield ();
+          continue;
+        }
+
+      ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->lock_, 0);
+
+      ++this->sleepers_;
+      std::atomic_thread_fence (std::memory_order_seq_cst);
+
+      ACE_Time_Value nap;
+      ACE_Time_Value *until = timeout;
+      if (this->pending_.load (std::memory_order_relaxed) == 0)
+        {
+          if (this->deactivated_.load ())
+            {
+              --this->sleepers_;
+              errno = ESHUTDOWN;
+              return 0;
+            }
+        }
+      else
+        {
+          // The request may have been pushed before we counted
+          // ourselves, without waking anybody, so only nap before
+          // looking again, and never past the timeout.
+          nap = ACE_OS::gettimeofday () + ACE_Time_Value (0, NAP_USECS);
+          if (timeout == 0 || nap < *timeout)
+            until = &nap;
+          spins = 0;
+        }
+
+      int const result = this->work_available_.wait (until);
+
+      --this->sleepers_;
+      if (result == -1)
+        {
+          if (errno == ETIME && until == &nap)
+            continue;
+          if (errno == ETIME)
+            errno = EWOULDBLOCK;
+          return 0;
+        }
+    }
+}
+
+int
+ACE_Work_Stealing_Executor::deactivate (void)
+{
+  ACE_GUARD_RETURN (ACE_Thread_Mutex, ace_mon, this->lock_, -1);
+  this->deactivated_ = true;
+  return this->work_available_.broadcast ();
+}
+
+int
+ACE_Work_Stealing_Executor::svc (void)
+{
+  for (ACE_Method_Request *mr = 0;
+       (mr = this->dequeue ()) != 0; )
+    {
+      mr->call ();
+      delete mr;
+    }
+  return 0;
+}
+
+void
+ACE_Work_Stealing_Executor::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("max_threads_ = %B\nclaimed_ = %B\n")
+                 ACE_TEXT ("pending_ = %B\nsleepers_ = %d\n")
+                 ACE_TEXT ("deactivated_ = %d\n"),
+                 this->max_threads_,
+                 this->claimed_.load (),
+                 this->pending_.load (),
+                 this->sleepers_.load (),
+                 this->deactivated_.load () ? 1 : 0));
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_ALLOC_HOOK_DEFINE(ACE_Work_Stealing_Activation_Queue)
+
+ACE_Work_Stealing_Activation_Queue::ACE_Work_Stealing_Activation_Queue (ACE_Work_Stealing_Executor *executor)
+  : executor_ (executor),
+    delete_executor_ (false)
+{
+  if (this->executor_ == 0)
+    {
+      ACE_NEW (this->executor_,
+               ACE_Work_Stealing_Executor);
+      this->delete_executor_ = true;
+    }
+}
+
+ACE_Work_Stealing_Activation_Queue::~ACE_Work_Stealing_Activation_Queue (void)
+{
+  if (this->delete_executor_)
+    delete this->executor_;
+}
+
+void
+ACE_Work_Stealing_Activation_Queue::dump (void) const
+{
+#if defined (ACE_HAS_DUMP)
+  ACELIB_DEBUG ((LM_DEBUG, ACE_BEGIN_DUMP, this));
+  ACELIB_DEBUG ((LM_DEBUG,
+                 ACE_TEXT ("delete_executor_ = %d\n"),
+                 this->delete_executor_));
+  ACELIB_DEBUG ((LM_INFO, ACE_TEXT ("executor_:\n")));
+  this->executor_->dump ();
+  ACELIB_DEBUG ((LM_DEBUG, ACE_END_DUMP));
+#endif /* ACE_HAS_DUMP */
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */
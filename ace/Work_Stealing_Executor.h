@@ -0,0 +1,372 @@
+// -*- C++ -*-
+
+//=============================================================================
+/**
+ *  @file    Work_Stealing_Executor.h
+ *
+ *  $Id$
+ *
+ *  A pool of threads executing ACE_Method_Requests from per-thread
+ *  work-stealing deques, and an ACE_Activation_Queue look-alike on top
+ *  of it.
+ */
+//=============================================================================
+
+#ifndef ACE_WORK_STEALING_EXECUTOR_H
+#define ACE_WORK_STEALING_EXECUTOR_H
+
+#include /**/ "ace/pre.h"
+
+#include /**/ "ace/ACE_export.h"
+
+#if !defined (ACE_LACKS_PRAGMA_ONCE)
+# pragma once
+#endif /* ACE_LACKS_PRAGMA_ONCE */
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+#include "ace/Task.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+#include "ace/TSS_T.h"
+#include "ace/Copy_Disabled.h"
+
+#include <atomic>
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+class ACE_Method_Request;
+
+/**
+ * @class ACE_Work_Stealing_Deque
+ *
+ * @brief Chase-Lev deque of ACE_Method_Request pointers.
+ *
+ * The owning thread pushes and takes requests at the bottom without
+ * any locking; other threads steal from the top with a single
+ * compare-and-swap.  The circular buffer grows as needed.  A buffer
+ * that was outgrown is freed by the owner once no thief is in the
+ * middle of a steal, since a thief may still be reading from it.
+ */
+class ACE_Export ACE_Work_Stealing_Deque : private ACE_Copy_Disabled
+{
+public:
+  ACE_Work_Stealing_Deque (size_t initial_capacity = 64);
+  ~ACE_Work_Stealing_Deque (void);
+
+  /// Add @a mr at the bottom.  Only called by the owner.  Returns -1
+  /// if the deque could not grow.
+  int push (ACE_Method_Request *mr);
+
+  /// Take the request at the bottom, or 0 if there is none.  Only
+  /// called by the owner.
+  ACE_Method_Request *take (void);
+
+  /// Take the request at the top, or 0 if there is none or another
+  /// thread got it first.  Called by any thread.
+  ACE_Method_Request *steal (void);
+
+  /// Number of requests on the deque; only a hint unless the owner
+  /// asks.
+  size_t size (void) const;
+
+private:
+  struct Buffer
+  {
+    std::atomic<ACE_Method_Request *> *slots_;
+    size_t mask_;
+    Buffer *retired_;
+  };
+
+  Buffer *new_buffer (size_t capacity);
+
+  /// Copy the requests into a buffer twice as big.
+  Buffer *grow (Buffer *buffer, ssize_t top, ssize_t bottom);
+
+  /// Free the buffers @a buffer outgrew if no thief may be reading
+  /// them.  Only called by the owner.
+  void reclaim (Buffer *buffer);
+
+  std::atomic<ssize_t> top_;
+  std::atomic<ssize_t> bottom_;
+  std::atomic<Buffer *> buffer_;
+
+  /// Number of threads in <steal>.
+  std::atomic<int> thieves_;
+};
+
+/**
+ * @class ACE_Work_Stealing_Executor
+ *
+ * @brief Executes ACE_Method_Requests on a pool of threads, each
+ * working from its own deque and stealing from the others when it
+ * runs out of work.
+ *
+ * This is an alternative to an ACE_Task whose threads share one
+ * ACE_Message_Queue or ACE_Activation_Queue: each thread takes
+ * requests from its own ACE_Work_Stealing_Deque, so the threads do
+ * not contend on a common lock.  Requests enqueued by a pool thread
+ * (typically from within another request's <call>) go onto that
+ * thread's deque; requests from any other thread go through a shared
+ * injection queue, from which an idle pool thread takes them several
+ * at a time.  Idle threads steal from the top of the other deques and
+ * only block once there is nothing left anywhere.
+ *
+ * The pool threads are started with the inherited <activate> and run
+ * under the executor's ACE_Thread_Manager; each one runs <svc>, which
+ * calls and deletes requests until the executor is deactivated and no
+ * request is left.  Threads that are not part of the pool may also
+ * take requests with <dequeue>, which makes them work-stealing
+ * threads as well.  A thread's deque is handed to another thread once
+ * it exits, along with any requests left on it, so threads may come
+ * and go for as long as the executor lives.
+ *
+ * Unlike ACE_Activation_Queue, requests are not ordered by priority.
+ * Requests from a single thread outside the pool are started in
+ * enqueue order, but with more than one pool thread they may of
+ * course run concurrently; requests from a pool thread are taken
+ * most recent first by that thread.
+ */
+class ACE_Export ACE_Work_Stealing_Executor : public ACE_Task_Base
+{
+public:
+  enum
+  {
+    /// Default maximum number of threads with a deque of their own.
+    DEFAULT_MAX_THREADS = 64,
+
+    /// Number of requests an idle thread moves from the injection
+    /// queue to its deque at once.
+    INJECTION_BATCH = 16,
+
+    /// Number of times an idle thread yields while a request is on
+    /// its way to a deque or being stolen, before it naps.
+    SPIN_LIMIT = 64,
+
+    /// Microseconds an idle thread naps for while a request is on its
+    /// way, as that may not wake it up.
+    NAP_USECS = 1000
+  };
+
+  /**
+   * Create an executor for up to @a max_threads threads with a deque
+   * of their own, counting both pool threads and threads calling
+   * <dequeue>.  Any further thread only takes requests from the
+   * injection queue and from the other threads' deques.  The pool
+   * threads are managed by @a thr_mgr, or by
+   * ACE_Thread_Manager::instance() if it is 0.
+   */
+  ACE_Work_Stealing_Executor (size_t max_threads = DEFAULT_MAX_THREADS,
+                              ACE_Thread_Manager *thr_mgr = 0);
+
+  /// Deactivate the executor, wait for the pool threads and delete the
+  /// requests that were not executed.
+  virtual ~ACE_Work_Stealing_Executor (void);
+
+  /**
+   * Queue @a mr for execution.  The executor owns @a mr from now on;
+   * the pool thread that runs it deletes it once <call> returns.
+   * @a timeout is accepted for compatibility with
+   * ACE_Activation_Queue; the executor is never full.
+   *
+   * @retval >0 The number of requests pending after adding @a mr.
+   * @retval -1 On failure; errno is ESHUTDOWN if the executor was
+   *            deactivated.
+   */
+  int enqueue (ACE_Method_Request *mr, ACE_Time_Value *timeout = 0);
+
+  /**
+   * Take the next request to execute, waiting until the absolute time
+   * @a timeout (forever if 0) for one.  The caller owns the request.
+   *
+   * @retval 0 On failure; errno is EWOULDBLOCK if @a timeout elapsed
+   *           and ESHUTDOWN if the executor was deactivated and no
+   *           request is left.
+   */
+  ACE_Method_Request *dequeue (ACE_Time_Value *timeout = 0);
+
+  /// Refuse new requests and wake up the threads waiting for one.
+  /// Requests already queued are still handed out.
+  int deactivate (void);
+
+  /// True once <deactivate> was called.
+  bool deactivated (void) const;
+
+  /// Number of requests queued but not yet taken.
+  size_t method_count (void) const;
+
+  /// Number of deques held by live threads.
+  size_t deques_in_use (void) const;
+
+  /// True if no request is queued.
+  bool is_empty (void) const;
+
+  /// Run requests until the executor is deactivated and drained.
+  virtual int svc (void);
+
+  /// Dump the state of an object.
+  void dump (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  /// A thread's deque, on cache lines of its own.
+  struct Worker
+  {
+    char pad0_[64];
+    ACE_Work_Stealing_Deque deque_;
+    char pad1_[64];
+  };
+
+  /// The deque a thread holds, given back when the thread exits.
+  struct Slot
+  {
+    Slot (void);
+    ~Slot (void);
+
+    /// Executor to give the deque back to, or 0 if there is none to
+    /// give back.
+    ACE_Work_Stealing_Executor *executor_;
+
+    /// Index + 1 of the deque, or max_threads_ + 1 if the thread could
+    /// not get one.
+    size_t index_;
+  };
+
+  friend struct Slot;
+
+  /// Give deque @a index back for another thread to use.
+  void release_deque (size_t index);
+
+  /// Deque of the calling thread, claiming one if it has none yet, or
+  /// 0 if all are taken.
+  ACE_Work_Stealing_Deque *own_deque (void);
+
+  /// Deque of the calling thread, without claiming one.
+  ACE_Work_Stealing_Deque *current_deque (void);
+
+  /// Look for a request without waiting: own deque, injection queue,
+  /// then the other threads' deques.
+  ACE_Method_Request *find_work (ACE_Work_Stealing_Deque *own);
+
+  /// Take up to INJECTION_BATCH requests from the injection queue,
+  /// returning the first one and pushing the others onto @a own.
+  ACE_Method_Request *take_injected (ACE_Work_Stealing_Deque *own);
+
+  /// Steal a request from any deque but @a own.
+  ACE_Method_Request *steal (ACE_Work_Stealing_Deque *own);
+
+  /// Add @a mr to the injection queue.  Must be called with <lock_>
+  /// held.
+  int inject_i (ACE_Method_Request *mr);
+
+  /// Wake up a waiting thread, if any, after adding a request.
+  void wake_one (void);
+
+  /// The deques, of which <claimed_> have been given to threads at
+  /// some point.
+  Worker *workers_;
+  size_t max_threads_;
+  std::atomic<size_t> claimed_;
+
+  /// Stack of the <free_count_> deques given back by threads that
+  /// exited.
+  size_t *free_;
+  std::atomic<size_t> free_count_;
+
+  /// The calling thread's deque.
+  ACE_TSS<Slot> slot_;
+
+  /// Protects the injection queue and the free deques, and serializes
+  /// sleeping and waking.
+  ACE_Thread_Mutex lock_;
+  ACE_Condition_Thread_Mutex work_available_;
+
+  /// Ring of requests enqueued by threads without a deque.
+  ACE_Method_Request **injected_;
+  size_t injected_capacity_;
+  size_t injected_head_;
+  size_t injected_count_;
+
+  /// Number of requests queued anywhere.
+  std::atomic<size_t> pending_;
+
+  /// Number of threads waiting on <work_available_>.
+  std::atomic<int> sleepers_;
+
+  std::atomic<bool> deactivated_;
+};
+
+/**
+ * @class ACE_Work_Stealing_Activation_Queue
+ *
+ * @brief Drop-in replacement for ACE_Activation_Queue backed by an
+ * ACE_Work_Stealing_Executor.
+ *
+ * Active objects that have their own threads call <dequeue> and
+ * invoke the requests themselves, as with ACE_Activation_Queue, but
+ * each of those threads gets a work-stealing deque of its own and
+ * they no longer contend on a single queue lock.  Requests are not
+ * ordered by priority.  Active objects that do not need their own
+ * scheduler threads can hand the requests to a pool of executor
+ * threads instead, by passing an executor that has been activated and
+ * not calling <dequeue>.
+ */
+class ACE_Export ACE_Work_Stealing_Activation_Queue : private ACE_Copy_Disabled
+{
+public:
+  /// Use @a executor, which is not deleted by this object, or create
+  /// an executor without pool threads if it is 0.
+  ACE_Work_Stealing_Activation_Queue (ACE_Work_Stealing_Executor *executor = 0);
+
+  /// Destructor.
+  ~ACE_Work_Stealing_Activation_Queue (void);
+
+  /// Dequeue the next available ACE_Method_Request, as
+  /// ACE_Activation_Queue::dequeue() does.
+  ACE_Method_Request *dequeue (ACE_Time_Value *tv = 0);
+
+  /// Enqueue the ACE_Method_Request, as ACE_Activation_Queue::enqueue()
+  /// does, except that requests are not ordered by priority.
+  int enqueue (ACE_Method_Request *new_method_request, ACE_Time_Value *tv = 0);
+
+  /// Get the current number of method objects in the queue.
+  size_t method_count (void) const;
+
+  /// Returns 1 if the queue is empty, 0 otherwise.
+  int is_empty (void) const;
+
+  /// Returns 0: the queue is never full.
+  int is_full (void) const;
+
+  /// Wake up the threads waiting in <dequeue> and refuse new requests.
+  int deactivate (void);
+
+  /// Dump the state of an request.
+  void dump (void) const;
+
+  /// Get the executor.
+  ACE_Work_Stealing_Executor *executor (void) const;
+
+  /// Declare the dynamic allocation hooks.
+  ACE_ALLOC_HOOK_DECLARE;
+
+private:
+  ACE_Work_Stealing_Executor *executor_;
+
+  /// Keeps track of whether we need to delete the executor.
+  bool delete_executor_;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+#if defined (__ACE_INLINE__)
+#include "ace/Work_Stealing_Executor.inl"
+#endif /* __ACE_INLINE__ */
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */
+
+#include /**/ "ace/post.h"
+
+#endif /* ACE_WORK_STEALING_EXECUTOR_H */
@@ -0,0 +1,82 @@
+// -*- C++ -*-
+//
+// $Id$
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+ACE_INLINE size_t
+ACE_Work_Stealing_Deque::size (void) const
+{
+  ssize_t const bottom = this->bottom_.load (std::memory_order_relaxed);
+  ssize_t const top = this->top_.load (std::memory_order_relaxed);
+  return bottom > top ? static_cast<size_t> (bottom - top) : 0;
+}
+
+ACE_INLINE bool
+ACE_Work_Stealing_Executor::deactivated (void) const
+{
+  return this->deactivated_.load ();
+}
+
+ACE_INLINE size_t
+ACE_Work_Stealing_Executor::method_count (void) const
+{
+  return this->pending_.load ();
+}
+
+ACE_INLINE size_t
+ACE_Work_Stealing_Executor::deques_in_use (void) const
+{
+  return this->claimed_.load () - this->free_count_.load ();
+}
+
+ACE_INLINE bool
+ACE_Work_Stealing_Executor::is_empty (void) const
+{
+  return this->pending_.load () == 0;
+}
+
+ACE_INLINE ACE_Method_Request *
+ACE_Work_Stealing_Activation_Queue::dequeue (ACE_Time_Value *tv)
+{
+  return this->executor_->dequeue (tv);
+}
+
+ACE_INLINE int
+ACE_Work_Stealing_Activation_Queue::enqueue (ACE_Method_Request *mr,
+                                             ACE_Time_Value *tv)
+{
+  return this->executor_->enqueue (mr, tv);
+}
+
+ACE_INLINE size_t
+ACE_Work_Stealing_Activation_Queue::method_count (void) const
+{
+  return this->executor_->method_count ();
+}
+
+ACE_INLINE int
+ACE_Work_Stealing_Activation_Queue::is_empty (void) const
+{
+  return this->executor_->is_empty () ? 1 : 0;
+}
+
+ACE_INLINE int
+ACE_Work_Stealing_Activation_Queue::is_full (void) const
+{
+  return 0;
+}
+
+ACE_INLINE int
+ACE_Work_Stealing_Activation_Queue::deactivate (void)
+{
+  return this->executor_->deactivate ();
+}
+
+ACE_INLINE ACE_Work_Stealing_Executor *
+ACE_Work_Stealing_Activation_Queue::executor (void) const
+{
+  return this->executor_;
+}
+
+ACE_END_VERSIONED_NAMESPACE_DECL
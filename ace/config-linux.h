@@ -379,6 +379,37 @@
 # endif
 #endif
 
+// eventfd() with EFD_NONBLOCK and EFD_CLOEXEC, which the reactors
+// wake up their event loop with, is available since 2.6.27.
+#if !defined (ACE_HAS_EVENTFD) && !defined (ACE_LACKS_EVENTFD)
+# if (LINUX_VERSION_CODE >= KERNEL_VERSION (2,6,27))
+#  define ACE_HAS_EVENTFD
+# endif
+#endif
+
+// inotify_init1() with IN_NONBLOCK and IN_CLOEXEC, which ACE_Filecache
+// learns of changed files with, is available since 2.6.27.
+#if !defined (ACE_HAS_INOTIFY) && !defined (ACE_LACKS_INOTIFY)
+# if (LINUX_VERSION_CODE >= KERNEL_VERSION (2,6,27))
+#  define ACE_HAS_INOTIFY
+# endif
+#endif
+
+// sched_getcpu() is in glibc since 2.6.
+#if !defined (ACE_HAS_SCHED_GETCPU) && defined (__GLIBC__)
+# if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 6)
+#  define ACE_HAS_SCHED_GETCPU
+# endif
+#endif
+
+// io_uring with IORING_OP_READ/WRITE, which ACE_Uring_Proactor
+// relies on, is available since 5.6.
+#if !defined (ACE_HAS_IO_URING) && !defined (ACE_LACKS_IO_URING)
+# if (LINUX_VERSION_CODE >= KERNEL_VERSION (5,6,0))
+#  define ACE_HAS_IO_URING
+# endif
+#endif
+
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(2,5,8))
 # define ACE_HAS_SCHED_GETAFFINITY 1
 # define ACE_HAS_SCHED_SETAFFINITY 1
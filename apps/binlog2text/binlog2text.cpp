@@ -0,0 +1,102 @@
+// $Id$
+
+// Prints the messages of binary logs written by ACE_Log_Binary_Writer,
+// i.e., by ACE_Log_Msg with the BINARY flag, as ACE_Log_Msg would have
+// printed them.
+//
+// Usage: binlog2text [-v | -l] binary-log...
+//
+//   -v  prefix the messages with the VERBOSE header.
+//   -l  prefix the messages with the VERBOSE_LITE header.
+
+#include "ace/Log_Binary.h"
+#include "ace/Log_Msg.h"
+#include "ace/Log_Record.h"
+#include "ace/Get_Opt.h"
+#include "ace/OS_NS_stdio.h"
+#include "ace/OS_NS_string.h"
+
+// Conversion of an ACE_TCHAR string in an ACE_TCHAR format.
+#if !defined (ACE_WIN32) && defined (ACE_USES_WCHAR)
+# define BINLOG2TEXT_TSTRING ACE_TEXT ("%ls")
+#else
+# define BINLOG2TEXT_TSTRING ACE_TEXT ("%s")
+#endif /* !ACE_WIN32 && ACE_USES_WCHAR */
+
+static void
+usage (const ACE_TCHAR *program)
+{
+  ACE_OS::fprintf (stderr,
+                   "usage: %s [-v | -l] binary-log...\n",
+                   ACE_TEXT_ALWAYS_CHAR (program));
+}
+
+// Print the messages of @a path to stdout.
+static int
+print_log (const ACE_TCHAR *path, u_long flags)
+{
+  ACE_Log_Binary_Reader reader;
+  if (reader.open (path) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), path), -1);
+
+  ACE_Log_Record record;
+  ACE_TCHAR *msg = 0;
+  ACE_NEW_RETURN (msg, ACE_TCHAR[ACE_Log_Record::MAXVERBOSELOGMSGLEN], -1);
+
+  int result = 0;
+  while ((result = reader.read (record)) == 1)
+    {
+      const ACE_TCHAR *text = record.msg_data ();
+      if (ACE_BIT_ENABLED (flags, ACE_Log_Msg::VERBOSE))
+        {
+          // ACE_Log_Msg puts the program name in front of the text.
+          ACE_OS::snprintf (msg,
+                            ACE_Log_Record::MAXVERBOSELOGMSGLEN,
+                            BINLOG2TEXT_TSTRING ACE_TEXT ("|")
+                            BINLOG2TEXT_TSTRING,
+                            reader.program_name (),
+                            text);
+          record.msg_data (msg);
+        }
+      record.print (reader.host_name (), flags, stdout);
+    }
+  delete [] msg;
+
+  if (result == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%s: %p\n"), path, ACE_TEXT ("read")),
+                      -1);
+  return 0;
+}
+
+int
+ACE_TMAIN (int argc, ACE_TCHAR *argv[])
+{
+  u_long flags = 0;
+
+  ACE_Get_Opt get_opt (argc, argv, ACE_TEXT ("vl"));
+  for (int c; (c = get_opt ()) != -1; )
+    switch (c)
+      {
+      case 'v':
+        flags = ACE_Log_Msg::VERBOSE;
+        break;
+      case 'l':
+        flags = ACE_Log_Msg::VERBOSE_LITE;
+        break;
+      default:
+        usage (argv[0]);
+        return 1;
+      }
+
+  if (get_opt.opt_ind () >= argc)
+    {
+      usage (argv[0]);
+      return 1;
+    }
+
+  int status = 0;
+  for (int i = get_opt.opt_ind (); i < argc; ++i)
+    if (print_log (argv[i], flags) == -1)
+      status = 1;
+  return status;
+}
@@ -0,0 +1,259 @@
+// $Id$
+
+// This program measures the cost of swapping the byte order of arrays
+// of shorts, longs, long longs and doubles, as done when a CDR stream
+// of the other byte order is demarshaled.  For each type, array
+// length and misalignment of the arrays it times
+//
+// 1. swapping the array one element at a time with ACE_CDR::swap_2,
+//    swap_4 or swap_8,
+//
+// 2. swapping it with ACE_CDR::swap_2_array, swap_4_array or
+//    swap_8_array, which use vector instructions where available, and
+//
+// 3. reading it with ACE_InputCDR::read_short_array and friends from
+//    a stream of the other byte order,
+//
+// and prints the nanoseconds per element.  <-l> gives the array
+// lengths, as a comma separated list, and <-o> the offsets of the
+// source and target arrays from their alignment, in elements.  Each
+// measurement swaps about <-n> elements in all.  Build ACE with
+// ACE_LACKS_CDR_SIMD_SWAP defined to get the scalar figures for
+// comparison.
+//
+// Typical use:
+//
+// ./cdr_swap_perf -l 4,16,64,256,1024,16384 -o 0,1 -n 50000000
+
+#include "ace/OS_main.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_string.h"
+#include "ace/Get_Opt.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/Log_Msg.h"
+#include "ace/CDR_Stream.h"
+
+static size_t total_elements = 20000000;
+static const ACE_TCHAR *lengths = ACE_TEXT ("4,16,64,256,1024,16384");
+static const ACE_TCHAR *offsets = ACE_TEXT ("0,1");
+
+// Defeats the optimizer.
+static volatile char sink;
+
+typedef void (*Array_Swap) (char const *, char *, size_t);
+typedef void (*Element_Swap) (char const *, char *);
+
+static double
+per_element (const ACE_High_Res_Timer &timer, size_t elements)
+{
+  ACE_hrtime_t nsecs;
+  timer.elapsed_time (nsecs);
+  return elements == 0
+    ? 0.0
+    : static_cast<double> (ACE_HRTIME_CONVERSION (nsecs)) / elements;
+}
+
+static double
+time_elements (size_t size, Element_Swap swap,
+               char const *orig, char *target,
+               size_t length, size_t rounds)
+{
+  ACE_High_Res_Timer timer;
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    {
+      for (size_t i = 0; i < length; ++i)
+        swap (orig + i * size, target + i * size);
+      sink = target[r % (length * size)];
+    }
+  timer.stop ();
+  return per_element (timer, length * rounds);
+}
+
+static double
+time_array (Array_Swap swap_array,
+            char const *orig, char *target,
+            size_t length, size_t rounds, size_t size)
+{
+  ACE_High_Res_Timer timer;
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    {
+      swap_array (orig, target, length);
+      sink = target[r % (length * size)];
+    }
+  timer.stop ();
+  return per_element (timer, length * rounds);
+}
+
+static double
+time_read (const ACE_TCHAR *type, char *target,
+           const ACE_Message_Block *mb,
+           size_t length, size_t rounds)
+{
+  int const opposite_byte_order = 1 - ACE_CDR_BYTE_ORDER;
+  ACE_High_Res_Timer timer;
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    {
+      ACE_InputCDR in (mb, opposite_byte_order);
+      switch (type[0])
+        {
+        case 's':
+          in.read_short_array (reinterpret_cast<ACE_CDR::Short *> (target),
+                               length);
+          break;
+        case 'l':
+          if (type[4] == 'l')
+            in.read_longlong_array
+              (reinterpret_cast<ACE_CDR::LongLong *> (target), length);
+          else
+            in.read_long_array (reinterpret_cast<ACE_CDR::Long *> (target),
+                                length);
+          break;
+        default:
+          in.read_double_array (reinterpret_cast<ACE_CDR::Double *> (target),
+                                length);
+          break;
+        }
+      sink = target[r % length];
+    }
+  timer.stop ();
+  return per_element (timer, length * rounds);
+}
+
+static int
+run_type (const ACE_TCHAR *type, size_t size,
+          Array_Swap swap_array, Element_Swap swap,
+          size_t length, size_t offset)
+{
+  // One extra element each side for the offset, plus slack.
+  size_t const bytes = (length + offset + 1) * size;
+  ACE_CDR::ULongLong *orig_words = new ACE_CDR::ULongLong[bytes / 8 + 2];
+  ACE_CDR::ULongLong *target_words = new ACE_CDR::ULongLong[bytes / 8 + 2];
+  char *const orig = reinterpret_cast<char *> (orig_words) + offset * size;
+  char *const target =
+    reinterpret_cast<char *> (target_words) + offset * size;
+  for (size_t i = 0; i < length * size; ++i)
+    orig[i] = static_cast<char> (i);
+
+  size_t const rounds = total_elements / length + 1;
+
+  double const element_nsec =
+    time_elements (size, swap, orig, target, length, rounds);
+  double const array_nsec =
+    time_array (swap_array, orig, target, length, rounds, size);
+
+  // The stream holds the array at the offset the CDR alignment allows.
+  ACE_OutputCDR out (length * size + ACE_CDR::MAX_ALIGNMENT * 2);
+  out.write_octet_array (reinterpret_cast<const ACE_CDR::Octet *> (orig),
+                         length * size);
+  double const read_nsec = time_read (type, target, out.begin (),
+                                      length, rounds);
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%-9s %8B %6B %10.3f %10.3f %10.3f %8.2f\n"),
+              type,
+              length,
+              offset,
+              element_nsec,
+              array_nsec,
+              read_nsec,
+              array_nsec > 0.0 ? element_nsec / array_nsec : 0.0));
+
+  delete [] orig_words;
+  delete [] target_words;
+  return 0;
+}
+
+// Returns the number at the start of the comma separated list @a list
+// and moves @a list past it.
+static size_t
+next_number (const ACE_TCHAR *&list)
+{
+  ACE_TCHAR *end = 0;
+  size_t const n = ACE_OS::strtoul (list, &end, 10);
+  while (*end != 0 && *end != ACE_TEXT (','))
+    ++end;
+  list = *end == 0 ? end : end + 1;
+  return n;
+}
+
+static int
+parse_args (int argc, ACE_TCHAR *argv[])
+{
+  ACE_Get_Opt get_opt (argc, argv, ACE_TEXT ("n:l:o:"));
+  int c;
+
+  while ((c = get_opt ()) != -1)
+    switch (c)
+      {
+      case 'n':
+        total_elements = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 'l':
+        lengths = get_opt.opt_arg ();
+        break;
+      case 'o':
+        offsets = get_opt.opt_arg ();
+        break;
+      default:
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("usage: %s [-n elements per measurement]")
+                           ACE_TEXT (" [-l length,...] [-o offset,...]\n"),
+                           argv[0]),
+                          -1);
+      }
+
+  if (total_elements == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("-n must be positive\n")), -1);
+  return 0;
+}
+
+int
+ACE_TMAIN (int argc, ACE_TCHAR *argv[])
+{
+  if (parse_args (argc, argv) == -1)
+    return 1;
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("nsecs per element:\n")
+              ACE_TEXT ("%-9s %8s %6s %10s %10s %10s %8s\n"),
+              ACE_TEXT ("type"),
+              ACE_TEXT ("length"),
+              ACE_TEXT ("offset"),
+              ACE_TEXT ("swap_N"),
+              ACE_TEXT ("array"),
+              ACE_TEXT ("read"),
+              ACE_TEXT ("speedup")));
+
+  static const struct
+  {
+    const ACE_TCHAR *name_;
+    size_t size_;
+    Array_Swap swap_array_;
+    Element_Swap swap_;
+  } types[] =
+    {
+      { ACE_TEXT ("short"), 2, ACE_CDR::swap_2_array, ACE_CDR::swap_2 },
+      { ACE_TEXT ("long"), 4, ACE_CDR::swap_4_array, ACE_CDR::swap_4 },
+      { ACE_TEXT ("longlong"), 8, ACE_CDR::swap_8_array, ACE_CDR::swap_8 },
+      { ACE_TEXT ("double"), 8, ACE_CDR::swap_8_array, ACE_CDR::swap_8 }
+    };
+
+  for (size_t t = 0; t < sizeof types / sizeof types[0]; ++t)
+    for (const ACE_TCHAR *l = lengths; *l != 0; )
+      {
+        size_t const length = next_number (l);
+        for (const ACE_TCHAR *o = offsets; *o != 0; )
+          {
+            size_t const offset = next_number (o);
+            if (length > 0)
+              run_type (types[t].name_, types[t].size_,
+                        types[t].swap_array_, types[t].swap_,
+                        length, offset);
+          }
+      }
+
+  return 0;
+}
@@ -0,0 +1,269 @@
+// $Id$
+
+// This program measures how lookups and updates of a hash map shared
+// by several threads scale with the number of threads, as with the
+// connection cache of ACE_Cached_Connect_Strategy_Ex.  The map is
+// filled with <-k> random integer keys, then each thread makes <-n>
+// operations on keys picked at random among them, of which <-u> percent unbind the key,
+// or bind it again if it was not there, and the others find it.
+//
+// For each thread count given with <-t>, as a comma separated list,
+// it prints the total number of operations per microsecond of
+//
+// 1. ACE_Hash_Map_Manager_Ex with an ACE_Thread_Mutex,
+//
+// 2. ACE_Hash_Map_Manager_Ex with an ACE_RW_Thread_Mutex,
+//
+// 3. ACE_Concurrent_Hash_Map with an ACE_Thread_Mutex per stripe,
+//
+// 4. ACE_Concurrent_Hash_Map with an ACE_RW_Thread_Mutex per stripe.
+//
+// Typical use:
+//
+// ./concurrent_map_perf -t 1,2,4,8,16 -k 10000 -n 1000000 -u 10
+
+#include "ace/OS_main.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/Get_Opt.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/Log_Msg.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Barrier.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/RW_Thread_Mutex.h"
+#include "ace/Hash_Map_Manager_T.h"
+#include "ace/Concurrent_Hash_Map_T.h"
+
+#if defined (ACE_HAS_THREADS)
+
+static size_t keys = 10000;
+static size_t operations = 1000000;
+static unsigned int update_percent = 10;
+static size_t stripes = ACE_DEFAULT_CONCURRENT_MAP_STRIPES;
+static const ACE_TCHAR *thread_counts = ACE_TEXT ("1,2,4,8");
+
+// The keys, scattered as the hashes of addresses would be.
+static long *key_set = 0;
+
+typedef ACE_Hash_Map_Manager_Ex<long,
+                                long,
+                                ACE_Hash<long>,
+                                ACE_Equal_To<long>,
+                                ACE_Thread_Mutex> Mutex_Map;
+
+typedef ACE_Hash_Map_Manager_Ex<long,
+                                long,
+                                ACE_Hash<long>,
+                                ACE_Equal_To<long>,
+                                ACE_RW_Thread_Mutex> RW_Map;
+
+typedef ACE_Concurrent_Hash_Map<long,
+                                long,
+                                ACE_Hash<long>,
+                                ACE_Equal_To<long>,
+                                ACE_Thread_Mutex> Striped_Mutex_Map;
+
+typedef ACE_Concurrent_Hash_Map<long,
+                                long,
+                                ACE_Hash<long>,
+                                ACE_Equal_To<long>,
+                                ACE_RW_Thread_Mutex> Striped_RW_Map;
+
+// What a thread is given and hands back.
+template <class MAP>
+struct Worker_Args
+{
+  MAP *map_;
+  ACE_Barrier *barrier_;
+  unsigned int seed_;
+  long found_;
+  ACE_hrtime_t nsecs_;
+};
+
+template <class MAP> static ACE_THR_FUNC_RETURN
+worker (void *arg)
+{
+  Worker_Args<MAP> *args = static_cast<Worker_Args<MAP> *> (arg);
+  MAP &map = *args->map_;
+  unsigned int seed = args->seed_;
+  unsigned int const updates = update_percent * (RAND_MAX / 100);
+  long found = 0;
+  long value = 0;
+
+  args->barrier_->wait ();
+
+  ACE_High_Res_Timer timer;
+  timer.start ();
+  for (size_t i = 0; i < operations; ++i)
+    {
+      long const key = key_set[ACE_OS::rand_r (&seed) % keys];
+      if (static_cast<unsigned int> (ACE_OS::rand_r (&seed)) < updates)
+        {
+          if (map.unbind (key) != 0)
+            map.bind (key, key);
+        }
+      else
+        found += map.find (key, value) == 0;
+    }
+  timer.stop ();
+
+  timer.elapsed_time (args->nsecs_);
+  args->found_ = found;
+  return 0;
+}
+
+template <class MAP> static double
+run_map (MAP &map, size_t threads)
+{
+  for (size_t i = 0; i < keys; ++i)
+    map.bind (key_set[i], key_set[i]);
+
+  ACE_Barrier barrier (static_cast<unsigned int> (threads));
+  Worker_Args<MAP> *args = new Worker_Args<MAP>[threads];
+
+  for (size_t t = 0; t < threads; ++t)
+    {
+      args[t].map_ = &map;
+      args[t].barrier_ = &barrier;
+      args[t].seed_ = static_cast<unsigned int> (t + 1);
+      args[t].found_ = 0;
+      args[t].nsecs_ = 0;
+      if (ACE_Thread_Manager::instance ()->spawn (ACE_THR_FUNC (worker<MAP>),
+                                                  &args[t]) == -1)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn")),
+                          0.0);
+    }
+  ACE_Thread_Manager::instance ()->wait ();
+
+  // The slowest thread gives the time all the operations took.
+  ACE_hrtime_t slowest = 0;
+  for (size_t t = 0; t < threads; ++t)
+    if (args[t].nsecs_ > slowest)
+      slowest = args[t].nsecs_;
+  delete [] args;
+
+  double const usecs =
+    static_cast<double> (ACE_HRTIME_CONVERSION (slowest)) / 1000.0;
+  return usecs == 0.0 ? 0.0 : (threads * operations) / usecs;
+}
+
+static void
+run_threads (size_t threads)
+{
+  Mutex_Map mutex_map (keys);
+  RW_Map rw_map (keys);
+  Striped_Mutex_Map striped_mutex_map (keys, 0, 0, stripes);
+  Striped_RW_Map striped_rw_map (keys, 0, 0, stripes);
+
+  double const mutex_ops = run_map (mutex_map, threads);
+  double const rw_ops = run_map (rw_map, threads);
+  double const striped_mutex_ops = run_map (striped_mutex_map, threads);
+  double const striped_rw_ops = run_map (striped_rw_map, threads);
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%7B %10.2f %10.2f %10.2f %10.2f\n"),
+              threads,
+              mutex_ops,
+              rw_ops,
+              striped_mutex_ops,
+              striped_rw_ops));
+}
+
+// Returns the number at the start of the comma separated list @a list
+// and moves @a list past it.
+static size_t
+next_number (const ACE_TCHAR *&list)
+{
+  ACE_TCHAR *end = 0;
+  size_t const n = ACE_OS::strtoul (list, &end, 10);
+  while (*end != 0 && *end != ACE_TEXT (','))
+    ++end;
+  list = *end == 0 ? end : end + 1;
+  return n;
+}
+
+static int
+parse_args (int argc, ACE_TCHAR *argv[])
+{
+  ACE_Get_Opt get_opt (argc, argv, ACE_TEXT ("t:k:n:u:s:"));
+  int c;
+
+  while ((c = get_opt ()) != -1)
+    switch (c)
+      {
+      case 't':
+        thread_counts = get_opt.opt_arg ();
+        break;
+      case 'k':
+        keys = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 'n':
+        operations = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 'u':
+        update_percent = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 's':
+        stripes = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      default:
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("usage: %s [-t threads,...] [-k keys]")
+                           ACE_TEXT (" [-n operations per thread]")
+                           ACE_TEXT (" [-u update percent] [-s stripes]\n"),
+                           argv[0]),
+                          -1);
+      }
+
+  if (keys == 0 || update_percent > 100)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("-k must be positive, -u at most 100\n")),
+                      -1);
+  return 0;
+}
+
+int
+ACE_TMAIN (int argc, ACE_TCHAR *argv[])
+{
+  if (parse_args (argc, argv) == -1)
+    return 1;
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("operations per usec, %B keys, %u%% updates:\n")
+              ACE_TEXT ("%7s %10s %10s %10s %10s\n"),
+              keys,
+              update_percent,
+              ACE_TEXT ("threads"),
+              ACE_TEXT ("mutex"),
+              ACE_TEXT ("rw"),
+              ACE_TEXT ("striped"),
+              ACE_TEXT ("stripedrw")));
+
+  key_set = new long[keys];
+  unsigned int seed = 4711;
+  for (size_t i = 0; i < keys; ++i)
+    key_set[i] = static_cast<long> (ACE_OS::rand_r (&seed));
+
+  for (const ACE_TCHAR *t = thread_counts; *t != 0; )
+    {
+      size_t const n = next_number (t);
+      if (n > 0)
+        run_threads (n);
+    }
+
+  delete [] key_set;
+
+  return 0;
+}
+
+#else
+
+int
+ACE_TMAIN (int, ACE_TCHAR *[])
+{
+  ACE_ERROR ((LM_ERROR,
+              ACE_TEXT ("threads not supported on this platform\n")));
+  return 0;
+}
+
+#endif /* ACE_HAS_THREADS */
@@ -0,0 +1,288 @@
+// $Id$
+
+// This program compares ACE_Flat_Hash_Map with ACE_Hash_Map_Manager_Ex
+// on tables of integer keys, as used for connection tables.  For each
+// table size given with <-l>, as a comma separated list, and each map
+// it times
+//
+// 1. binding that many keys, in random order,
+//
+// 2. finding all of them, in another random order,
+//
+// 3. looking up as many keys that are not in the map,
+//
+// 4. unbinding and binding again a quarter of the keys, in rounds,
+//
+// 5. iterating over the map,
+//
+// and prints the nanoseconds per operation.  Each measurement is
+// repeated until it made about <-n> operations.  The last column is
+// the longest single bind, in microseconds: ACE_Hash_Map_Manager_Ex
+// never grows and is opened with <-s> buckets (the table size if
+// 0), while ACE_Flat_Hash_Map starts empty and grows incrementally.
+//
+// Typical use:
+//
+// ./hash_map_perf -l 1000,100000,1000000 -n 10000000
+
+#include "ace/OS_main.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/Get_Opt.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/Log_Msg.h"
+#include "ace/Null_Mutex.h"
+#include "ace/Hash_Map_Manager_T.h"
+#include "ace/Flat_Hash_Map_T.h"
+
+static size_t total_operations = 5000000;
+static size_t buckets = 0;
+static const ACE_TCHAR *lengths = ACE_TEXT ("1000,100000,1000000");
+
+// Defeats the optimizer.
+static volatile long sink;
+
+typedef ACE_Hash_Map_Manager_Ex<long,
+                                long,
+                                ACE_Hash<long>,
+                                ACE_Equal_To<long>,
+                                ACE_Null_Mutex> Chained_Map;
+
+typedef ACE_Flat_Hash_Map<long,
+                          long,
+                          ACE_Hash<long>,
+                          ACE_Equal_To<long>,
+                          ACE_Null_Mutex> Flat_Map;
+
+static double
+per_operation (const ACE_High_Res_Timer &timer, size_t operations)
+{
+  ACE_hrtime_t nsecs;
+  timer.elapsed_time (nsecs);
+  return operations == 0
+    ? 0.0
+    : static_cast<double> (ACE_HRTIME_CONVERSION (nsecs)) / operations;
+}
+
+static void
+shuffle (long *keys, size_t n)
+{
+  for (size_t i = n; i > 1; --i)
+    {
+      size_t const j = static_cast<size_t> (ACE_OS::rand ()) % i;
+      long const tmp = keys[i - 1];
+      keys[i - 1] = keys[j];
+      keys[j] = tmp;
+    }
+}
+
+// Opens @a map for @a n keys.
+static void
+open_map (Chained_Map &map, size_t n)
+{
+  map.open (buckets == 0 ? n : buckets);
+}
+
+static void
+open_map (Flat_Map &, size_t)
+{
+}
+
+template <class MAP> static void
+run_map (const ACE_TCHAR *name,
+         const long *keys,
+         const long *lookups,
+         const long *missing,
+         size_t n)
+{
+  size_t const rounds = total_operations / n + 1;
+  ACE_High_Res_Timer timer;
+
+  // Bind, once per round in a new map.
+  double bind_nsec = 0.0;
+  ACE_hrtime_t worst = 0;
+  for (size_t r = 0; r < rounds; ++r)
+    {
+      MAP map;
+      open_map (map, n);
+      timer.reset ();
+      timer.start ();
+      for (size_t i = 0; i < n; ++i)
+        map.bind (keys[i], static_cast<long> (i));
+      timer.stop ();
+      bind_nsec += per_operation (timer, n);
+    }
+  bind_nsec /= rounds;
+
+  MAP map;
+  open_map (map, n);
+  for (size_t i = 0; i < n; ++i)
+    {
+      ACE_hrtime_t const start = ACE_OS::gethrtime ();
+      map.bind (keys[i], static_cast<long> (i));
+      ACE_hrtime_t const elapsed = ACE_OS::gethrtime () - start;
+      if (elapsed > worst)
+        worst = elapsed;
+    }
+
+  // Successful lookups.
+  long value = 0;
+  timer.reset ();
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    for (size_t i = 0; i < n; ++i)
+      {
+        map.find (lookups[i], value);
+        sink = value;
+      }
+  timer.stop ();
+  double const find_nsec = per_operation (timer, n * rounds);
+
+  // Failed lookups.
+  int found = 0;
+  timer.reset ();
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    for (size_t i = 0; i < n; ++i)
+      found += map.find (missing[i]) == 0;
+  timer.stop ();
+  double const miss_nsec = per_operation (timer, n * rounds);
+  sink = found;
+
+  // Churn: unbind a quarter of the keys and bind them again.
+  size_t const quarter = n / 4 + 1;
+  timer.reset ();
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    {
+      size_t const first = (r * quarter) % (n - quarter + 1);
+      for (size_t i = first; i < first + quarter; ++i)
+        map.unbind (lookups[i]);
+      for (size_t i = first; i < first + quarter; ++i)
+        map.bind (lookups[i], static_cast<long> (i));
+    }
+  timer.stop ();
+  double const churn_nsec = per_operation (timer, 2 * quarter * rounds);
+
+  // Iteration.
+  long sum = 0;
+  timer.reset ();
+  timer.start ();
+  for (size_t r = 0; r < rounds; ++r)
+    for (typename MAP::iterator iter = map.begin ();
+         iter != map.end ();
+         ++iter)
+      sum += (*iter).int_id_;
+  timer.stop ();
+  double const iterate_nsec = per_operation (timer, n * rounds);
+  sink = sum;
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%-8s %8B %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n"),
+              name,
+              n,
+              bind_nsec,
+              find_nsec,
+              miss_nsec,
+              churn_nsec,
+              iterate_nsec,
+              static_cast<double> (ACE_HRTIME_CONVERSION (worst))
+                / ACE_High_Res_Timer::global_scale_factor ()));
+}
+
+static void
+run_size (size_t n)
+{
+  long *keys = new long[n];
+  long *lookups = new long[n];
+  long *missing = new long[n];
+
+  // Scattered keys, the even ones bound and the odd ones missing.
+  for (size_t i = 0; i < n; ++i)
+    {
+      keys[i] = static_cast<long> (i) * 2 * 40503 + 17;
+      lookups[i] = keys[i];
+      missing[i] = keys[i] + 40503;
+    }
+  shuffle (keys, n);
+  shuffle (lookups, n);
+  shuffle (missing, n);
+
+  run_map<Chained_Map> (ACE_TEXT ("chained"), keys, lookups, missing, n);
+  run_map<Flat_Map> (ACE_TEXT ("flat"), keys, lookups, missing, n);
+
+  delete [] keys;
+  delete [] lookups;
+  delete [] missing;
+}
+
+// Returns the number at the start of the comma separated list @a list
+// and moves @a list past it.
+static size_t
+next_number (const ACE_TCHAR *&list)
+{
+  ACE_TCHAR *end = 0;
+  size_t const n = ACE_OS::strtoul (list, &end, 10);
+  while (*end != 0 && *end != ACE_TEXT (','))
+    ++end;
+  list = *end == 0 ? end : end + 1;
+  return n;
+}
+
+static int
+parse_args (int argc, ACE_TCHAR *argv[])
+{
+  ACE_Get_Opt get_opt (argc, argv, ACE_TEXT ("n:l:s:"));
+  int c;
+
+  while ((c = get_opt ()) != -1)
+    switch (c)
+      {
+      case 'n':
+        total_operations = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 'l':
+        lengths = get_opt.opt_arg ();
+        break;
+      case 's':
+        buckets = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      default:
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("usage: %s [-n operations per measurement]")
+                           ACE_TEXT (" [-l size,...] [-s buckets]\n"),
+                           argv[0]),
+                          -1);
+      }
+
+  if (total_operations == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("-n must be positive\n")), -1);
+  return 0;
+}
+
+int
+ACE_TMAIN (int argc, ACE_TCHAR *argv[])
+{
+  if (parse_args (argc, argv) == -1)
+    return 1;
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("nsecs per operation, longest bind in usecs:\n")
+              ACE_TEXT ("%-8s %8s %9s %9s %9s %9s %9s %9s\n"),
+              ACE_TEXT ("map"),
+              ACE_TEXT ("size"),
+              ACE_TEXT ("bind"),
+              ACE_TEXT ("find"),
+              ACE_TEXT ("miss"),
+              ACE_TEXT ("churn"),
+              ACE_TEXT ("iterate"),
+              ACE_TEXT ("worst")));
+
+  for (const ACE_TCHAR *l = lengths; *l != 0; )
+    {
+      size_t const n = next_number (l);
+      if (n > 0)
+        run_size (n);
+    }
+
+  return 0;
+}
@@ -0,0 +1,368 @@
+//=============================================================================
+/**
+ *  @file   proactor_test.cpp
+ *
+ *  $Id$
+ *
+ * Measures the round-trip throughput of the POSIX proactor
+ * implementations.  A number of loopback TCP connections is set up
+ * and each one ping-pongs fixed size messages through asynchronous
+ * reads and writes, all dispatched by a pool of threads running the
+ * proactor event loop.
+ */
+//=============================================================================
+
+#include "ace/Proactor.h"
+#include "ace/Asynch_IO.h"
+#include "ace/Message_Block.h"
+#include "ace/SOCK_Acceptor.h"
+#include "ace/SOCK_Connector.h"
+#include "ace/SOCK_Stream.h"
+#include "ace/INET_Addr.h"
+#include "ace/Get_Opt.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Atomic_Op.h"
+#include "ace/Log_Msg.h"
+#include "ace/OS_main.h"
+#include "ace/OS_NS_ctype.h"
+#include "ace/OS_NS_string.h"
+
+#if defined (ACE_HAS_AIO_CALLS)
+#  include "ace/POSIX_Proactor.h"
+#  include "ace/POSIX_CB_Proactor.h"
+#  include "ace/Uring_Proactor.h"
+#endif /* ACE_HAS_AIO_CALLS */
+
+static const u_short DEFPORT = 5060;
+
+static ACE_TCHAR proactor_type = 'D';
+static int threads = 4;
+static int connections = 16;
+static int iterations = 10000;
+static size_t bufsz = 64;
+static u_short port = DEFPORT;
+
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> finished (0);
+
+/**
+ * @class Echo_Handler
+ *
+ * One end of a connection.  The initiator writes a message and waits
+ * for it to come back; the other end echoes whatever it reads.
+ */
+class Echo_Handler : public ACE_Handler
+{
+public:
+  Echo_Handler (void);
+  virtual ~Echo_Handler (void);
+
+  int open (ACE_HANDLE handle, ACE_Proactor *proactor, bool initiator);
+
+  virtual void handle_read_stream (const ACE_Asynch_Read_Stream::Result &result);
+  virtual void handle_write_stream (const ACE_Asynch_Write_Stream::Result &result);
+
+private:
+  int start_read (void);
+  int start_write (void);
+  void done (void);
+
+  ACE_HANDLE handle_;
+  ACE_Asynch_Read_Stream rs_;
+  ACE_Asynch_Write_Stream ws_;
+  ACE_Message_Block mb_;
+  bool initiator_;
+  int round_trips_;
+};
+
+Echo_Handler::Echo_Handler (void)
+  : handle_ (ACE_INVALID_HANDLE),
+    mb_ (bufsz),
+    initiator_ (false),
+    round_trips_ (0)
+{
+}
+
+Echo_Handler::~Echo_Handler (void)
+{
+  if (this->handle_ != ACE_INVALID_HANDLE)
+    ACE_OS::closesocket (this->handle_);
+}
+
+int
+Echo_Handler::open (ACE_HANDLE handle, ACE_Proactor *proactor, bool initiator)
+{
+  this->handle_ = handle;
+  this->initiator_ = initiator;
+  this->proactor (proactor);
+
+  if (this->rs_.open (*this, handle, 0, proactor) == -1
+      || this->ws_.open (*this, handle, 0, proactor) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("open")), -1);
+
+  if (!initiator)
+    return this->start_read ();
+
+  ACE_OS::memset (this->mb_.wr_ptr (), 'x', bufsz);
+  this->mb_.wr_ptr (bufsz);
+  return this->start_write ();
+}
+
+int
+Echo_Handler::start_read (void)
+{
+  if (this->rs_.read (this->mb_, this->mb_.space ()) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("read")), -1);
+  return 0;
+}
+
+int
+Echo_Handler::start_write (void)
+{
+  if (this->ws_.write (this->mb_, this->mb_.length ()) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("write")), -1);
+  return 0;
+}
+
+void
+Echo_Handler::done (void)
+{
+  if (this->initiator_
+      && ++finished == connections)
+    this->proactor ()->proactor_end_event_loop ();
+}
+
+void
+Echo_Handler::handle_read_stream (const ACE_Asynch_Read_Stream::Result &result)
+{
+  if (!result.success () || result.bytes_transferred () == 0)
+    {
+      // The echoers' last reads are cancelled when the connections
+      // are torn down.
+      if (!result.success () && result.error () != ECANCELED)
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("(%t) read: %d\n"),
+                    static_cast<int> (result.error ())));
+      this->done ();
+      return;
+    }
+
+  if (!this->initiator_)
+    {
+      this->start_write ();
+      return;
+    }
+
+  // Wait for the whole message to come back.
+  if (this->mb_.space () > 0)
+    {
+      this->start_read ();
+      return;
+    }
+
+  if (++this->round_trips_ == iterations)
+    {
+      this->done ();
+      return;
+    }
+
+  this->mb_.rd_ptr (this->mb_.base ());
+  this->start_write ();
+}
+
+void
+Echo_Handler::handle_write_stream (const ACE_Asynch_Write_Stream::Result &result)
+{
+  if (!result.success ())
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("(%t) write: %d\n"),
+                  static_cast<int> (result.error ())));
+      this->done ();
+      return;
+    }
+
+  if (this->mb_.length () > 0)
+    {
+      this->start_write ();
+      return;
+    }
+
+  this->mb_.reset ();
+  this->start_read ();
+}
+
+static ACE_THR_FUNC_RETURN
+worker (void *arg)
+{
+  ACE_Proactor *proactor = static_cast<ACE_Proactor *> (arg);
+  proactor->proactor_run_event_loop ();
+  return 0;
+}
+
+static ACE_Proactor *
+make_proactor (void)
+{
+  ACE_Proactor_Impl *impl = 0;
+
+  // Each connection has one operation outstanding on either end; leave
+  // some room for the proactor's own notifications.
+  size_t const max_aio = connections * 2 + 16;
+
+#if defined (ACE_HAS_AIO_CALLS)
+  switch (ACE_OS::ace_toupper (proactor_type))
+    {
+    case 'A':
+      ACE_NEW_RETURN (impl, ACE_POSIX_AIOCB_Proactor (max_aio), 0);
+      break;
+#  if !defined (ACE_HAS_BROKEN_SIGEVENT_STRUCT)
+    case 'C':
+      ACE_NEW_RETURN (impl, ACE_POSIX_CB_Proactor (max_aio), 0);
+      break;
+#  endif /* !ACE_HAS_BROKEN_SIGEVENT_STRUCT */
+#  if defined (ACE_HAS_IO_URING)
+    case 'U':
+      ACE_NEW_RETURN (impl, ACE_Uring_Proactor (max_aio), 0);
+      break;
+#  endif /* ACE_HAS_IO_URING */
+    default:
+      break;
+    }
+#else
+  ACE_UNUSED_ARG (max_aio);
+#endif /* ACE_HAS_AIO_CALLS */
+
+  ACE_Proactor *proactor = 0;
+  ACE_NEW_RETURN (proactor, ACE_Proactor (impl, 1), 0);
+  return proactor;
+}
+
+static int
+parse_args (int argc, ACE_TCHAR *argv[])
+{
+  ACE_Get_Opt get_opt (argc, argv, ACE_TEXT ("t:n:c:i:b:p:"));
+  int c;
+
+  while ((c = get_opt ()) != -1)
+    switch (c)
+      {
+      case 't':
+        proactor_type = *get_opt.opt_arg ();
+        break;
+      case 'n':
+        threads = ACE_OS::atoi (get_opt.opt_arg ());
+        break;
+      case 'c':
+        connections = ACE_OS::atoi (get_opt.opt_arg ());
+        break;
+      case 'i':
+        iterations = ACE_OS::atoi (get_opt.opt_arg ());
+        break;
+      case 'b':
+        bufsz = ACE_OS::atoi (get_opt.opt_arg ());
+        break;
+      case 'p':
+        port = static_cast<u_short> (ACE_OS::atoi (get_opt.opt_arg ()));
+        break;
+      default:
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("usage: %s [-t a|c|u|d] [-n threads]")
+                           ACE_TEXT (" [-c connections] [-i iterations]")
+                           ACE_TEXT (" [-b message size] [-p port]\n")
+                           ACE_TEXT ("  -t a AIOCB, c CB, u URING,")
+                           ACE_TEXT (" d default proactor\n"),
+                           argv[0]),
+                          -1);
+      }
+
+  if (threads <= 0 || connections <= 0 || iterations <= 0 || bufsz == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("invalid arguments\n")), -1);
+
+  return 0;
+}
+
+int
+ACE_TMAIN (int argc, ACE_TCHAR *argv[])
+{
+  if (parse_args (argc, argv) == -1)
+    return 1;
+
+  ACE_Proactor *proactor = make_proactor ();
+  if (proactor == 0)
+    return 1;
+
+  ACE_INET_Addr addr (port, ACE_LOCALHOST);
+  ACE_SOCK_Acceptor acceptor;
+  if (acceptor.open (addr, 1) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("acceptor")), 1);
+
+  Echo_Handler *initiators = 0;
+  Echo_Handler *echoers = 0;
+  ACE_NEW_RETURN (initiators, Echo_Handler[connections], 1);
+  ACE_NEW_RETURN (echoers, Echo_Handler[connections], 1);
+
+  // Set up all the connections before any traffic starts.
+  ACE_SOCK_Stream *client = 0;
+  ACE_SOCK_Stream *server = 0;
+  ACE_NEW_RETURN (client, ACE_SOCK_Stream[connections], 1);
+  ACE_NEW_RETURN (server, ACE_SOCK_Stream[connections], 1);
+
+  ACE_SOCK_Connector connector;
+  for (int i = 0; i < connections; ++i)
+    if (connector.connect (client[i], addr) == -1
+        || acceptor.accept (server[i]) == -1)
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("connect")), 1);
+
+  ACE_High_Res_Timer timer;
+  timer.start ();
+
+  for (int i = 0; i < connections; ++i)
+    {
+      echoers[i].open (server[i].get_handle (), proactor, false);
+      initiators[i].open (client[i].get_handle (), proactor, true);
+    }
+
+  // The POSIX proactors run a helper thread of their own in the same
+  // thread manager, so only wait for the event loop threads.
+  int const grp_id =
+    ACE_Thread_Manager::instance ()->spawn_n (threads, worker, proactor);
+  if (grp_id == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn_n")), 1);
+  ACE_Thread_Manager::instance ()->wait_grp (grp_id);
+
+  timer.stop ();
+
+  ACE_hrtime_t usecs = 0;
+  timer.elapsed_microseconds (usecs);
+  double const seconds = static_cast<double> (usecs) / 1000000.0;
+  double const round_trips =
+    static_cast<double> (connections) * static_cast<double> (iterations);
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("proactor %c: %d threads, %d connections, ")
+              ACE_TEXT ("%d round trips of %B bytes each\n")
+              ACE_TEXT ("  %.3f s, %.0f round trips/s, %.2f MB/s\n"),
+              proactor_type,
+              threads,
+              connections,
+              iterations,
+              bufsz,
+              seconds,
+              seconds > 0 ? round_trips / seconds : 0.0,
+              seconds > 0
+              ? 2.0 * round_trips * bufsz / seconds / (1024.0 * 1024.0)
+              : 0.0));
+
+  // Close the sockets before the proactor goes away so the echoers'
+  // outstanding reads complete.
+  delete [] initiators;
+  delete [] client;
+  proactor->proactor_reset_event_loop ();
+  ACE_Time_Value tv (0, 100000);
+  proactor->proactor_run_event_loop (tv);
+  delete [] echoers;
+  delete [] server;
+  delete proactor;
+
+  return 0;
+}
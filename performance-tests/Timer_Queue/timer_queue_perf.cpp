@@ -0,0 +1,255 @@
+// $Id$
+
+// This program measures the cost of the basic timer queue operations
+// with large numbers of long-range timers, such as the idle and
+// retransmission timers of many connections, for each of the ACE
+// timer queues.  For every queue it
+//
+// 1. schedules <-n> timers at random times over the next <-r>
+//    seconds,
+//
+// 2. cancels and reschedules a random timer <-c> times, the way an
+//    idle timer is pushed back each time data arrives, and
+//
+// 3. expires all the timers, advancing the time by <-s> milliseconds
+//    at a time.
+//
+// The queues are driven with explicit times, so the program runs as
+// fast as the queues allow rather than in real time.  Use <-q> to
+// select the queues, as a comma separated list of hierarchical, heap,
+// wheel, hash and list.  Scheduling on ACE_Timer_List takes time
+// proportional to the number of timers, so leave it out for large
+// values of <-n>.
+//
+// Typical use:
+//
+// ./timer_queue_perf -n 1000000 -r 600 -q hierarchical,heap,wheel,hash
+
+#include "ace/OS_main.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_time.h"
+#include "ace/Get_Opt.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/Log_Msg.h"
+#include "ace/Event_Handler.h"
+#include "ace/Timer_Hierarchical_Wheel.h"
+#include "ace/Timer_Heap.h"
+#include "ace/Timer_Wheel.h"
+#include "ace/Timer_Hash.h"
+#include "ace/Timer_List.h"
+#include "ace/Recursive_Thread_Mutex.h"
+
+static size_t timer_count = 20000;
+static size_t churn_count = 0;
+static int range_sec = 600;
+static int step_msec = 10;
+static const ACE_TCHAR *queues = ACE_TEXT ("hierarchical,heap,wheel,hash,list");
+
+class Expire_Handler : public ACE_Event_Handler
+{
+public:
+  Expire_Handler (void) : count_ (0) {}
+
+  virtual int handle_timeout (const ACE_Time_Value &, const void *)
+  {
+    ++this->count_;
+    return 0;
+  }
+
+  size_t count_;
+};
+
+// Returns a random delay within the range, with microsecond
+// granularity even where RAND_MAX is small.
+static ACE_Time_Value
+random_delay (void)
+{
+  ACE_UINT64 const r = (static_cast<ACE_UINT64> (ACE_OS::rand ()) << 30)
+    ^ (static_cast<ACE_UINT64> (ACE_OS::rand ()) << 15)
+    ^ static_cast<ACE_UINT64> (ACE_OS::rand ());
+  ACE_UINT64 const usec =
+    r % (static_cast<ACE_UINT64> (range_sec) * ACE_ONE_SECOND_IN_USECS);
+  return ACE_Time_Value (static_cast<time_t> (usec / ACE_ONE_SECOND_IN_USECS),
+                         static_cast<suseconds_t> (usec % ACE_ONE_SECOND_IN_USECS));
+}
+
+static double
+per_op (const ACE_High_Res_Timer &timer, size_t ops)
+{
+  ACE_hrtime_t nsecs;
+  timer.elapsed_time (nsecs);
+  return ops == 0
+    ? 0.0
+    : static_cast<double> (ACE_HRTIME_CONVERSION (nsecs)) / 1000.0 / ops;
+}
+
+static ACE_Timer_Queue *
+make_queue (const ACE_TCHAR *name)
+{
+  if (ACE_OS::strcmp (name, ACE_TEXT ("hierarchical")) == 0)
+    return new ACE_Timer_Hierarchical_Wheel (ACE_Time_Value (0, ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_RESOLUTION),
+                                             ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_LEVELS,
+                                             ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_SLOT_BITS,
+                                             timer_count);
+  if (ACE_OS::strcmp (name, ACE_TEXT ("heap")) == 0)
+    return new ACE_Timer_Heap (timer_count, true);
+  if (ACE_OS::strcmp (name, ACE_TEXT ("wheel")) == 0)
+    return new ACE_Timer_Wheel (ACE_DEFAULT_TIMER_WHEEL_SIZE,
+                                ACE_DEFAULT_TIMER_WHEEL_RESOLUTION,
+                                timer_count);
+  if (ACE_OS::strcmp (name, ACE_TEXT ("hash")) == 0)
+    return new ACE_Timer_Hash;
+  if (ACE_OS::strcmp (name, ACE_TEXT ("list")) == 0)
+    return new ACE_Timer_List;
+  return 0;
+}
+
+static int
+run_queue (const ACE_TCHAR *name)
+{
+  ACE_Timer_Queue *tq = make_queue (name);
+  if (tq == 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("unknown timer queue %s\n"),
+                       name),
+                      -1);
+
+  Expire_Handler handler;
+  long *ids = new long[timer_count];
+  ACE_Time_Value const start = tq->gettimeofday ();
+  ACE_High_Res_Timer timer;
+
+  ACE_OS::srand (42);
+
+  // Schedule.
+  timer.start ();
+  for (size_t i = 0; i < timer_count; ++i)
+    ids[i] = tq->schedule (&handler, 0, start + random_delay ());
+  timer.stop ();
+  double const schedule_usec = per_op (timer, timer_count);
+
+  // Cancel and reschedule, as when an idle timer is pushed back.
+  timer.reset ();
+  timer.start ();
+  for (size_t i = 0; i < churn_count; ++i)
+    {
+      size_t const victim =
+        ((static_cast<size_t> (ACE_OS::rand ()) << 15)
+         ^ static_cast<size_t> (ACE_OS::rand ())) % timer_count;
+      tq->cancel (ids[victim]);
+      ids[victim] = tq->schedule (&handler, 0, start + random_delay ());
+    }
+  timer.stop ();
+  double const churn_usec = per_op (timer, churn_count);
+
+  // Expire everything.
+  ACE_Time_Value const step (0, step_msec * 1000);
+  ACE_Time_Value now = start;
+  size_t expire_calls = 0;
+  timer.reset ();
+  timer.start ();
+  while (!tq->is_empty ())
+    {
+      now += step;
+      tq->expire (now);
+      ++expire_calls;
+    }
+  timer.stop ();
+  double const expire_usec = per_op (timer, handler.count_);
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%-14s %12.3f %12.3f %12.3f %10B\n"),
+              name,
+              schedule_usec,
+              churn_usec,
+              expire_usec,
+              expire_calls));
+
+  if (handler.count_ != timer_count)
+    ACE_ERROR ((LM_ERROR,
+                ACE_TEXT ("%s: %B timers expired, expected %B\n"),
+                name,
+                handler.count_,
+                timer_count));
+
+  delete [] ids;
+  delete tq;
+  return 0;
+}
+
+static int
+parse_args (int argc, ACE_TCHAR *argv[])
+{
+  ACE_Get_Opt get_opt (argc, argv, ACE_TEXT ("n:c:r:s:q:"));
+  int c;
+
+  while ((c = get_opt ()) != -1)
+    switch (c)
+      {
+      case 'n':
+        timer_count = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 'c':
+        churn_count = ACE_OS::strtoul (get_opt.opt_arg (), 0, 10);
+        break;
+      case 'r':
+        range_sec = ACE_OS::atoi (get_opt.opt_arg ());
+        break;
+      case 's':
+        step_msec = ACE_OS::atoi (get_opt.opt_arg ());
+        break;
+      case 'q':
+        queues = get_opt.opt_arg ();
+        break;
+      default:
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("usage: %s [-n timers] [-c churn operations]")
+                           ACE_TEXT (" [-r range in seconds] [-s expire step in msec]")
+                           ACE_TEXT (" [-q queue,...]\n"),
+                           argv[0]),
+                          -1);
+      }
+
+  if (timer_count == 0 || range_sec <= 0 || step_msec <= 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("-n, -r and -s must be positive\n")),
+                      -1);
+  if (churn_count == 0)
+    churn_count = timer_count;
+  return 0;
+}
+
+int
+ACE_TMAIN (int argc, ACE_TCHAR *argv[])
+{
+  if (parse_args (argc, argv) == -1)
+    return 1;
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%B timers over %d seconds, %B reschedules, ")
+              ACE_TEXT ("expired %d msec at a time\n")
+              ACE_TEXT ("usecs per operation:\n")
+              ACE_TEXT ("%-14s %12s %12s %12s %10s\n"),
+              timer_count,
+              range_sec,
+              churn_count,
+              step_msec,
+              ACE_TEXT ("queue"),
+              ACE_TEXT ("schedule"),
+              ACE_TEXT ("reschedule"),
+              ACE_TEXT ("expire"),
+              ACE_TEXT ("expire()s")));
+
+  ACE_TCHAR *list = ACE_OS::strdup (queues);
+  ACE_TCHAR *lasts = 0;
+  int status = 0;
+  for (ACE_TCHAR *name = ACE_OS::strtok_r (list, ACE_TEXT (","), &lasts);
+       name != 0;
+       name = ACE_OS::strtok_r (0, ACE_TEXT (","), &lasts))
+    if (run_queue (name) != 0)
+      status = 1;
+
+  ACE_OS::free (list);
+  return status;
+}
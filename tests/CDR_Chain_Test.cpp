@@ -0,0 +1,471 @@
+//=============================================================================
+/**
+ *  @file    CDR_Chain_Test.cpp
+ *
+ *  $Id$
+ *
+ *  Checks that an ACE_InputCDR reading a chain of message blocks in
+ *  place, made from an ACE_InputCDR::Chain, reads the same values as
+ *  one reading the same data from a single block, whatever the sizes
+ *  of the blocks, and that ACE_OutputCDR::duplicate_chain() shares
+ *  the data of the stream.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/CDR_Stream.h"
+#include "ace/Message_Block.h"
+#include "ace/OS_NS_string.h"
+#include "ace/SString.h"
+
+static const ACE_CDR::ULong short_count = 37;
+static const ACE_CDR::ULong long_count = 19;
+static const ACE_CDR::ULong double_count = 11;
+static const ACE_CDR::ULong octet_count = 50;
+
+// What read_values() reads.
+struct Values
+{
+  ACE_CDR::Octet o;
+  ACE_CDR::Short s;
+  ACE_CDR::Long l;
+  ACE_CDR::LongLong ll;
+  ACE_CDR::Double d;
+  ACE_CDR::Boolean b;
+  ACE_CString str;
+  ACE_CDR::Short shorts[short_count];
+  ACE_CDR::Long longs[long_count];
+  ACE_CDR::Double doubles[double_count];
+  ACE_CDR::Char chars[8];
+  ACE_CDR::Long enc_l;
+  ACE_CString enc_str;
+  ACE_CDR::ULong ul;
+  ACE_CString last;
+  ACE_CDR::Octet octets[octet_count];
+};
+
+static void
+clear (Values &v)
+{
+  v.o = 0;
+  v.s = 0;
+  v.l = 0;
+  v.ll = 0;
+  v.d = 0.0;
+  v.b = false;
+  v.str = "";
+  ACE_OS::memset (v.shorts, 0, sizeof v.shorts);
+  ACE_OS::memset (v.longs, 0, sizeof v.longs);
+  ACE_OS::memset (v.doubles, 0, sizeof v.doubles);
+  ACE_OS::memset (v.chars, 0, sizeof v.chars);
+  v.enc_l = 0;
+  v.enc_str = "";
+  v.ul = 0;
+  v.last = "";
+  ACE_OS::memset (v.octets, 0, sizeof v.octets);
+}
+
+static bool
+operator== (const Values &a, const Values &b)
+{
+  return a.o == b.o
+    && a.s == b.s
+    && a.l == b.l
+    && a.ll == b.ll
+    && ACE_OS::memcmp (&a.d, &b.d, sizeof a.d) == 0
+    && a.b == b.b
+    && a.str == b.str
+    && ACE_OS::memcmp (a.shorts, b.shorts, sizeof a.shorts) == 0
+    && ACE_OS::memcmp (a.longs, b.longs, sizeof a.longs) == 0
+    && ACE_OS::memcmp (a.doubles, b.doubles, sizeof a.doubles) == 0
+    && ACE_OS::memcmp (a.chars, b.chars, sizeof a.chars) == 0
+    && a.enc_l == b.enc_l
+    && a.enc_str == b.enc_str
+    && a.ul == b.ul
+    && a.last == b.last
+    && ACE_OS::memcmp (a.octets, b.octets, sizeof a.octets) == 0;
+}
+
+static void
+fill (Values &v)
+{
+  v.o = 0x7f;
+  v.s = -1234;
+  v.l = 0x12345678;
+  v.ll = ACE_INT64_LITERAL (0x0102030405060708);
+  v.d = 3.25;
+  v.b = true;
+  v.str = "a string long enough to straddle a few blocks";
+  for (ACE_CDR::ULong i = 0; i < short_count; ++i)
+    v.shorts[i] = static_cast<ACE_CDR::Short> (i * 0x0101 + 1);
+  for (ACE_CDR::ULong i = 0; i < long_count; ++i)
+    v.longs[i] = static_cast<ACE_CDR::Long> (i * 0x01010101 + 2);
+  for (ACE_CDR::ULong i = 0; i < double_count; ++i)
+    v.doubles[i] = i * 0.5 - 1.0;
+  ACE_OS::memcpy (v.chars, "chars!\0", sizeof v.chars);
+  v.enc_l = -42;
+  v.enc_str = "encapsulated";
+  v.ul = 0xdeadbeef;
+  v.last = "the end";
+  for (ACE_CDR::ULong i = 0; i < octet_count; ++i)
+    v.octets[i] = static_cast<ACE_CDR::Octet> (i * 3);
+}
+
+static bool
+write_values (ACE_OutputCDR &out, const Values &v)
+{
+  ACE_OutputCDR enc;
+  enc << ACE_OutputCDR::from_boolean (ACE_CDR_BYTE_ORDER);
+  enc << v.enc_l;
+  enc << v.enc_str;
+  if (enc.consolidate () == -1)
+    return false;
+
+  out << ACE_OutputCDR::from_octet (v.o);
+  out << v.s;
+  out << v.l;
+  out << v.ll;
+  out << v.d;
+  out << ACE_OutputCDR::from_boolean (v.b);
+  out << v.str;
+  out.write_short_array (v.shorts, short_count);
+  out.write_long_array (v.longs, long_count);
+  out.write_double_array (v.doubles, double_count);
+  out.write_char_array (v.chars, sizeof v.chars);
+  out << static_cast<ACE_CDR::ULong> (enc.length ());
+  out.write_octet_array (reinterpret_cast<const ACE_CDR::Octet *> (enc.buffer ()),
+                         static_cast<ACE_CDR::ULong> (enc.length ()));
+  out << v.ul;
+  out << ACE_CString ("skipped");
+  out << v.last;
+  out.write_octet_array (v.octets, octet_count);
+  return out.good_bit ();
+}
+
+static bool
+read_values (ACE_InputCDR &in, Values &v)
+{
+  ACE_CDR::ULong enc_length = 0;
+  in >> ACE_InputCDR::to_octet (v.o);
+  in >> v.s;
+  in >> v.l;
+  in >> v.ll;
+  in >> v.d;
+  in >> ACE_InputCDR::to_boolean (v.b);
+  in >> v.str;
+  in.read_short_array (v.shorts, short_count);
+  in.read_long_array (v.longs, long_count);
+  in.read_double_array (v.doubles, double_count);
+  in.read_char_array (v.chars, sizeof v.chars);
+  in >> enc_length;
+  if (!in.good_bit ())
+    return false;
+  {
+    ACE_InputCDR enc (in, enc_length);
+    enc >> v.enc_l;
+    enc >> v.enc_str;
+    if (!enc.good_bit ())
+      return false;
+  }
+  in.skip_bytes (enc_length);
+  in >> v.ul;
+  in.skip_string ();
+  in >> v.last;
+  in.read_octet_array (v.octets, octet_count);
+  return in.good_bit () && in.length () == 0;
+}
+
+// Copy the stream in @a data, which starts on a MAX_ALIGNMENT
+// boundary, into a chain of blocks of @a block_size bytes.  The
+// blocks after the first are misaligned by @a skew bytes.
+static ACE_Message_Block *
+make_chain (const char *data,
+            size_t length,
+            size_t block_size,
+            size_t skew)
+{
+  ACE_Message_Block *head = 0;
+  ACE_Message_Block *tail = 0;
+  for (size_t offset = 0; offset < length; offset += block_size)
+    {
+      size_t const n =
+        offset + block_size <= length ? block_size : length - offset;
+      ACE_Message_Block *mb = 0;
+      ACE_NEW_NORETURN (mb,
+                        ACE_Message_Block (n + 2 * ACE_CDR::MAX_ALIGNMENT));
+      if (mb == 0)
+        {
+          ACE_Message_Block::release (head);
+          return 0;
+        }
+      ACE_CDR::mb_align (mb);
+      mb->rd_ptr ((offset + (offset == 0 ? 0 : skew))
+                  % ACE_CDR::MAX_ALIGNMENT);
+      mb->wr_ptr (mb->rd_ptr ());
+      mb->copy (data + offset, n);
+      if (head == 0)
+        head = mb;
+      else
+        tail->cont (mb);
+      tail = mb;
+    }
+  return head;
+}
+
+// Read the values of the stream in @a data split into a chain, and
+// compare them with @a expected.
+static int
+check_chain (const char *data,
+             size_t length,
+             size_t block_size,
+             size_t skew,
+             int byte_order,
+             const Values &expected)
+{
+  ACE_Message_Block * const head =
+    make_chain (data, length, block_size, skew);
+  if (head == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot make the chain\n")), 1);
+
+  ACE_InputCDR in ((ACE_InputCDR::Chain (head)), byte_order);
+  bool const in_place = (in.start ()->rd_ptr () == head->rd_ptr ());
+  // The stream shares the blocks.
+  head->release ();
+
+  if (in.length () != length)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("Blocks of %B bytes skewed by %B: ")
+                       ACE_TEXT ("length is %B instead of %B\n"),
+                       block_size, skew, in.length (), length),
+                      1);
+  if (in_place != (skew == 0 || length <= block_size))
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("Blocks of %B bytes skewed by %B: %C\n"),
+                       block_size, skew,
+                       in_place ? "read misaligned blocks in place"
+                                : "copied the chain"),
+                      1);
+
+  Values v;
+  clear (v);
+  if (!read_values (in, v) || !(v == expected))
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("Blocks of %B bytes skewed by %B: ")
+                       ACE_TEXT ("wrong values\n"),
+                       block_size, skew),
+                      1);
+  return 0;
+}
+
+// Read swapped arrays, a straddling element at a time.
+static int
+check_swapped_arrays (void)
+{
+  ACE_CDR::Long longs[long_count];
+  ACE_CDR::Double doubles[double_count];
+  for (ACE_CDR::ULong i = 0; i < long_count; ++i)
+    longs[i] = static_cast<ACE_CDR::Long> (i * 0x01020304 + 5);
+  for (ACE_CDR::ULong i = 0; i < double_count; ++i)
+    doubles[i] = i * 1.5;
+
+  ACE_OutputCDR out;
+  out.write_long_array (longs, long_count);
+  out.write_double_array (doubles, double_count);
+  if (!out.good_bit () || out.consolidate () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot write the arrays\n")), 1);
+
+  int const byte_order = !ACE_CDR_BYTE_ORDER;
+  ACE_InputCDR whole (out.buffer (), out.length (), byte_order);
+  ACE_CDR::Long longs_expected[long_count];
+  ACE_CDR::Double doubles_expected[double_count];
+  whole.read_long_array (longs_expected, long_count);
+  whole.read_double_array (doubles_expected, double_count);
+
+  int errors = 0;
+  for (size_t block_size = 1; block_size <= 24; ++block_size)
+    {
+      ACE_Message_Block * const head =
+        make_chain (out.buffer (), out.length (), block_size, 0);
+      if (head == 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("Cannot make the chain\n")),
+                          1);
+
+      ACE_InputCDR in ((ACE_InputCDR::Chain (head)), byte_order);
+      head->release ();
+      ACE_CDR::Long longs_in[long_count];
+      ACE_CDR::Double doubles_in[double_count];
+      if (!in.read_long_array (longs_in, long_count)
+          || !in.read_double_array (doubles_in, double_count)
+          || ACE_OS::memcmp (longs_in, longs_expected, sizeof longs_in) != 0
+          || ACE_OS::memcmp (doubles_in,
+                             doubles_expected,
+                             sizeof doubles_in) != 0)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("Swapped arrays in blocks of %B bytes ")
+                      ACE_TEXT ("are wrong\n"),
+                      block_size));
+          ++errors;
+        }
+    }
+  return errors;
+}
+
+// Operations that need contiguous data consolidate the rest of the
+// chain.
+static int
+check_consolidate (const char *data, size_t length)
+{
+  ACE_Message_Block * const head = make_chain (data, length, 5, 0);
+  if (head == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot make the chain\n")), 1);
+  ACE_InputCDR in ((ACE_InputCDR::Chain (head)));
+  head->release ();
+
+  ACE_CDR::Octet o = 0;
+  char *buf = 0;
+  if (!in.read_octet (o)
+      || in.adjust (40, 1, buf) == -1
+      || ACE_OS::memcmp (buf, data + 1, 40) != 0
+      || in.start ()->length () != length - 41
+      || in.length () != length - 41)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("adjust() across the chain failed\n")),
+                      1);
+
+  ACE_Message_Block * const chain = make_chain (data, length, 7, 0);
+  if (chain == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot make the chain\n")), 1);
+  ACE_InputCDR copy ((ACE_InputCDR::Chain (chain)));
+  chain->release ();
+  if (!copy.skip_bytes (10))
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("skip_bytes() failed\n")), 1);
+  ACE_Message_Block * const rest = copy.steal_contents ();
+  bool const ok = rest != 0
+    && rest->cont () == 0
+    && rest->length () == length - 10
+    && ACE_OS::memcmp (rest->rd_ptr (), data + 10, length - 10) == 0;
+  ACE_Message_Block::release (rest);
+  if (!ok)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("steal_contents() of a chain failed\n")),
+                      1);
+  return 0;
+}
+
+// The chain of an ACE_OutputCDR that has grown shares its data and
+// reads back in place.
+static int
+check_output_chain (const Values &expected)
+{
+  ACE_OutputCDR out (32);
+  for (int i = 0; i < 4; ++i)
+    if (!write_values (out, expected))
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot write the values\n")), 1);
+  if (out.begin ()->cont () == 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("The output stream didn't grow\n")),
+                      1);
+
+  ACE_Message_Block *chain = out.duplicate_chain ();
+  if (chain == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("duplicate_chain failed\n")), 1);
+  size_t const total = ACE_CDR::total_length (chain, 0);
+  bool const shared = chain->rd_ptr () == out.begin ()->rd_ptr ();
+  ACE_InputCDR in ((ACE_InputCDR::Chain (chain)));
+  bool const in_place = in.start ()->rd_ptr () == out.begin ()->rd_ptr ();
+  chain->release ();
+
+  if (total != out.total_length () || !shared || !in_place)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("The output chain has %B bytes of %B, ")
+                       ACE_TEXT ("shared %d, read in place %d\n"),
+                       total, out.total_length (),
+                       static_cast<int> (shared),
+                       static_cast<int> (in_place)),
+                      1);
+
+  for (int i = 0; i < 4; ++i)
+    {
+      Values v;
+      clear (v);
+      ACE_CDR::ULong enc_length = 0;
+      in >> ACE_InputCDR::to_octet (v.o);
+      in >> v.s;
+      in >> v.l;
+      in >> v.ll;
+      in >> v.d;
+      in >> ACE_InputCDR::to_boolean (v.b);
+      in >> v.str;
+      in.read_short_array (v.shorts, short_count);
+      in.read_long_array (v.longs, long_count);
+      in.read_double_array (v.doubles, double_count);
+      in.read_char_array (v.chars, sizeof v.chars);
+      in >> enc_length;
+      in.skip_bytes (enc_length);
+      in >> v.ul;
+      in.skip_string ();
+      in >> v.last;
+      in.read_octet_array (v.octets, octet_count);
+      if (!in.good_bit ()
+          || v.s != expected.s
+          || v.ll != expected.ll
+          || v.str != expected.str
+          || ACE_OS::memcmp (v.doubles,
+                             expected.doubles,
+                             sizeof v.doubles) != 0
+          || v.last != expected.last
+          || ACE_OS::memcmp (v.octets, expected.octets, sizeof v.octets) != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("Copy %d of the values read back from ")
+                           ACE_TEXT ("the output chain is wrong\n"),
+                           i),
+                          1);
+    }
+  return in.length () == 0 ? 0 : 1;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("CDR_Chain_Test"));
+
+  Values expected;
+  fill (expected);
+
+  int errors = 0;
+  ACE_OutputCDR out;
+  if (!write_values (out, expected) || out.consolidate () == -1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("Cannot write the values\n")));
+      ++errors;
+    }
+  else
+    {
+      // Blocks of every size up to more than the largest value, in
+      // place, and misaligned ones, which are consolidated.
+      for (size_t block_size = 1; block_size <= 40; ++block_size)
+        {
+          errors += check_chain (out.buffer (), out.length (),
+                                 block_size, 0,
+                                 ACE_CDR_BYTE_ORDER, expected);
+          errors += check_chain (out.buffer (), out.length (),
+                                 block_size, 3,
+                                 ACE_CDR_BYTE_ORDER, expected);
+        }
+      errors += check_chain (out.buffer (), out.length (),
+                             out.length (), 0,
+                             ACE_CDR_BYTE_ORDER, expected);
+      errors += check_consolidate (out.buffer (), out.length ());
+    }
+
+  errors += check_swapped_arrays ();
+  errors += check_output_chain (expected);
+
+  if (errors == 0)
+    ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("All the chains read right\n")));
+
+  ACE_END_TEST;
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,406 @@
+//=============================================================================
+/**
+ *  @file    CDR_Fixed_Test.cpp
+ *
+ *  $Id$
+ *
+ *  Checks that ACE_CDR_Fixed writes the same stream as writing the
+ *  fields of a structure one at a time with the CDR operators, and
+ *  reads back the same values, for structures that have the same
+ *  layout in memory as on the wire and for structures that do not,
+ *  at all the alignments of the stream, one at a time and in arrays,
+ *  from streams of both byte orders.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/CDR_Fixed_T.h"
+#include "ace/OS_NS_string.h"
+#include "ace/os_include/os_stddef.h"
+
+// The same layout in memory as on the wire.
+struct Sample
+{
+  ACE_CDR::Long id;
+  ACE_CDR::Short flags;
+  ACE_CDR::Double value;
+};
+
+// Padded at the end in memory but not on the wire.
+struct Tail
+{
+  ACE_CDR::Double d;
+  ACE_CDR::UShort s;
+};
+
+// Not in the same order in memory as on the wire, with a Boolean.
+struct Mixed
+{
+  ACE_CDR::Octet tag;
+  ACE_CDR::Boolean ok;
+  ACE_CDR::ULongLong big;
+  ACE_CDR::Char c;
+  ACE_CDR::Float f;
+  ACE_CDR::LongLong ll;
+  ACE_CDR::ULong ul;
+};
+
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+
+template <>
+struct ACE_CDR_Fixed_Traits<Sample>
+{
+  typedef ACE_CDR_Fixed_Field<ACE_CDR::Long, offsetof (Sample, id),
+          ACE_CDR_Fixed_Field<ACE_CDR::Short, offsetof (Sample, flags),
+          ACE_CDR_Fixed_Field<ACE_CDR::Double, offsetof (Sample, value)
+          > > > fields;
+};
+
+template <>
+struct ACE_CDR_Fixed_Traits<Tail>
+{
+  typedef ACE_CDR_Fixed_Field<ACE_CDR::Double, offsetof (Tail, d),
+          ACE_CDR_Fixed_Field<ACE_CDR::UShort, offsetof (Tail, s)
+          > > fields;
+};
+
+template <>
+struct ACE_CDR_Fixed_Traits<Mixed>
+{
+  typedef ACE_CDR_Fixed_Field<ACE_CDR::Char, offsetof (Mixed, c),
+          ACE_CDR_Fixed_Field<ACE_CDR::ULongLong, offsetof (Mixed, big),
+          ACE_CDR_Fixed_Field<ACE_CDR::Octet, offsetof (Mixed, tag),
+          ACE_CDR_Fixed_Field<ACE_CDR::Float, offsetof (Mixed, f),
+          ACE_CDR_Fixed_Field<ACE_CDR::Boolean, offsetof (Mixed, ok),
+          ACE_CDR_Fixed_Field<ACE_CDR::LongLong, offsetof (Mixed, ll),
+          ACE_CDR_Fixed_Field<ACE_CDR::ULong, offsetof (Mixed, ul)
+          > > > > > > > fields;
+};
+
+ACE_END_VERSIONED_NAMESPACE_DECL
+
+// = Writing and reading the fields one at a time, and comparing.
+
+static void
+write_fields (ACE_OutputCDR &cdr, const Sample &x)
+{
+  cdr.write_long (x.id);
+  cdr.write_short (x.flags);
+  cdr.write_double (x.value);
+}
+
+static void
+read_fields (ACE_InputCDR &cdr, Sample &x)
+{
+  cdr.read_long (x.id);
+  cdr.read_short (x.flags);
+  cdr.read_double (x.value);
+}
+
+static bool
+same (const Sample &a, const Sample &b)
+{
+  return a.id == b.id && a.flags == b.flags && a.value == b.value;
+}
+
+static void
+init (Sample &x, size_t i)
+{
+  // Zero the padding, which the single memcpy copies too.
+  ACE_OS::memset (&x, 0, sizeof x);
+  x.id = static_cast<ACE_CDR::Long> (i * 0x01020304 + 1);
+  x.flags = static_cast<ACE_CDR::Short> (i * 0x0102 + 2);
+  x.value = static_cast<ACE_CDR::Double> (i) * 1.5 - 3.25;
+}
+
+static void
+write_fields (ACE_OutputCDR &cdr, const Tail &x)
+{
+  cdr.write_double (x.d);
+  cdr.write_ushort (x.s);
+}
+
+static void
+read_fields (ACE_InputCDR &cdr, Tail &x)
+{
+  cdr.read_double (x.d);
+  cdr.read_ushort (x.s);
+}
+
+static bool
+same (const Tail &a, const Tail &b)
+{
+  return a.d == b.d && a.s == b.s;
+}
+
+static void
+init (Tail &x, size_t i)
+{
+  ACE_OS::memset (&x, 0, sizeof x);
+  x.d = static_cast<ACE_CDR::Double> (i) * -0.75 + 1.0;
+  x.s = static_cast<ACE_CDR::UShort> (i * 0x0203 + 7);
+}
+
+static void
+write_fields (ACE_OutputCDR &cdr, const Mixed &x)
+{
+  cdr.write_char (x.c);
+  cdr.write_ulonglong (x.big);
+  cdr.write_octet (x.tag);
+  cdr.write_float (x.f);
+  cdr.write_boolean (x.ok);
+  cdr.write_longlong (x.ll);
+  cdr.write_ulong (x.ul);
+}
+
+static void
+read_fields (ACE_InputCDR &cdr, Mixed &x)
+{
+  cdr.read_char (x.c);
+  cdr.read_ulonglong (x.big);
+  cdr.read_octet (x.tag);
+  cdr.read_float (x.f);
+  cdr.read_boolean (x.ok);
+  cdr.read_longlong (x.ll);
+  cdr.read_ulong (x.ul);
+}
+
+static bool
+same (const Mixed &a, const Mixed &b)
+{
+  return a.c == b.c && a.big == b.big && a.tag == b.tag && a.f == b.f
+    && a.ok == b.ok && a.ll == b.ll && a.ul == b.ul;
+}
+
+static void
+init (Mixed &x, size_t i)
+{
+  ACE_OS::memset (&x, 0, sizeof x);
+  x.c = static_cast<ACE_CDR::Char> ('a' + i % 26);
+  x.big = static_cast<ACE_CDR::ULongLong> (i) * ACE_UINT64_LITERAL (0x0102030405060708);
+  x.tag = static_cast<ACE_CDR::Octet> (i + 0x80);
+  x.f = static_cast<ACE_CDR::Float> (i) * 0.5f + 0.25f;
+  x.ok = (i % 3 != 0);
+  x.ll = -static_cast<ACE_CDR::LongLong> (i) * 12345;
+  x.ul = static_cast<ACE_CDR::ULong> (i * 0x10203 + 9);
+}
+
+// = The checks.
+
+static const size_t count = 13;
+static const size_t buffer_size = 128;
+
+// Write <prefix> octets, then the structures with ACE_CDR_Fixed and
+// with the CDR operators, and compare the streams.
+template <typename S> int
+check_write (const ACE_TCHAR *name, size_t prefix, bool array)
+{
+  S values[count];
+  for (size_t i = 0; i != count; ++i)
+    init (values[i], i);
+
+  // Write to zeroed buffers, big enough for all the structures, as
+  // the streams leave the padding alone.
+  ACE_CDR::ULongLong fixed_buffer[buffer_size];
+  ACE_CDR::ULongLong fields_buffer[buffer_size];
+  ACE_OS::memset (fixed_buffer, 0, sizeof fixed_buffer);
+  ACE_OS::memset (fields_buffer, 0, sizeof fields_buffer);
+  ACE_OutputCDR fixed (reinterpret_cast<char *> (fixed_buffer),
+                       sizeof fixed_buffer);
+  ACE_OutputCDR fields (reinterpret_cast<char *> (fields_buffer),
+                        sizeof fields_buffer);
+  ACE_SizeCDR sizer;
+  for (size_t i = 0; i != prefix; ++i)
+    {
+      fixed.write_octet (static_cast<ACE_CDR::Octet> (i));
+      fields.write_octet (static_cast<ACE_CDR::Octet> (i));
+      sizer.write_octet (static_cast<ACE_CDR::Octet> (i));
+    }
+
+  bool written = true;
+  if (array)
+    {
+      written = ACE_CDR_Fixed<S>::write_array (fixed, values, count)
+        && ACE_CDR_Fixed<S>::write_array (sizer, values, count);
+    }
+  else
+    for (size_t i = 0; i != count; ++i)
+      written = written
+        && ACE_CDR_Fixed<S>::write (fixed, values[i])
+        && ACE_CDR_Fixed<S>::write (sizer, values[i]);
+
+  for (size_t i = 0; i != count; ++i)
+    write_fields (fields, values[i]);
+
+  if (!written || fixed.consolidate () == -1 || fields.consolidate () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s: cannot write after %B octets\n"),
+                       name, prefix),
+                      1);
+
+  if (fixed.total_length () != fields.total_length ()
+      || sizer.total_length () != fields.total_length ()
+      || ACE_OS::memcmp (fixed.buffer (),
+                         fields.buffer (),
+                         fields.total_length ()) != 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s%s: wrote %B (sized %B) octets after ")
+                       ACE_TEXT ("%B octets instead of the same %B octets ")
+                       ACE_TEXT ("as the CDR operators\n"),
+                       name,
+                       array ? ACE_TEXT (" array") : ACE_TEXT (""),
+                       fixed.total_length (),
+                       sizer.total_length (),
+                       prefix,
+                       fields.total_length ()),
+                      1);
+  return 0;
+}
+
+// Read structures written with the CDR operators, in both byte
+// orders, with ACE_CDR_Fixed and with the CDR operators, and compare
+// the values.
+template <typename S> int
+check_read (const ACE_TCHAR *name, size_t prefix, bool array)
+{
+  S values[count];
+  for (size_t i = 0; i != count; ++i)
+    init (values[i], i);
+
+  ACE_OutputCDR out;
+  for (size_t i = 0; i != prefix; ++i)
+    out.write_octet (static_cast<ACE_CDR::Octet> (i));
+  for (size_t i = 0; i != count; ++i)
+    write_fields (out, values[i]);
+  if (!out.good_bit () || out.consolidate () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s: cannot write after %B octets\n"),
+                       name, prefix),
+                      1);
+
+  for (int byte_order = 0; byte_order != 2; ++byte_order)
+    {
+      ACE_InputCDR fixed (out.buffer (), out.length (), byte_order);
+      ACE_InputCDR fields (out.buffer (), out.length (), byte_order);
+      fixed.skip_bytes (prefix);
+      fields.skip_bytes (prefix);
+
+      S read_fixed[count];
+      S read_fields_values[count];
+      ACE_OS::memset (read_fixed, 0, sizeof read_fixed);
+      ACE_OS::memset (read_fields_values, 0, sizeof read_fields_values);
+
+      bool read = true;
+      if (array)
+        read = ACE_CDR_Fixed<S>::read_array (fixed, read_fixed, count);
+      else
+        for (size_t i = 0; i != count; ++i)
+          read = read && ACE_CDR_Fixed<S>::read (fixed, read_fixed[i]);
+      for (size_t i = 0; i != count; ++i)
+        read_fields (fields, read_fields_values[i]);
+
+      if (!read || !fields.good_bit ()
+          || fixed.length () != 0 || fields.length () != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%s%s: cannot read after %B octets ")
+                           ACE_TEXT ("in byte order %d\n"),
+                           name,
+                           array ? ACE_TEXT (" array") : ACE_TEXT (""),
+                           prefix,
+                           byte_order),
+                          1);
+
+      for (size_t i = 0; i != count; ++i)
+        if (!same (read_fixed[i], read_fields_values[i])
+            || (byte_order == ACE_CDR_BYTE_ORDER
+                && !same (read_fixed[i], values[i])))
+          ACE_ERROR_RETURN ((LM_ERROR,
+                             ACE_TEXT ("%s%s: element %B read after %B ")
+                             ACE_TEXT ("octets in byte order %d is not ")
+                             ACE_TEXT ("what the CDR operators read\n"),
+                             name,
+                             array ? ACE_TEXT (" array") : ACE_TEXT (""),
+                             i,
+                             prefix,
+                             byte_order),
+                            1);
+    }
+  return 0;
+}
+
+// Reading past the end of the stream fails.
+template <typename S> int
+check_short_read (const ACE_TCHAR *name)
+{
+  S value;
+  init (value, 5);
+  ACE_OutputCDR out;
+  write_fields (out, value);
+  if (out.consolidate () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%s: cannot write\n"), name), 1);
+
+  ACE_InputCDR in (out.buffer (), out.length () - 1);
+  S x;
+  if (ACE_CDR_Fixed<S>::read (in, x) || in.good_bit ())
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s: read past the end of the stream\n"),
+                       name),
+                      1);
+  return 0;
+}
+
+template <typename S> int
+check (const ACE_TCHAR *name)
+{
+  int errors = 0;
+  for (size_t prefix = 0; prefix <= 2 * ACE_CDR::MAX_ALIGNMENT; ++prefix)
+    {
+      errors += check_write<S> (name, prefix, false);
+      errors += check_write<S> (name, prefix, true);
+      errors += check_read<S> (name, prefix, false);
+      errors += check_read<S> (name, prefix, true);
+    }
+  errors += check_short_read<S> (name);
+  return errors;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("CDR_Fixed_Test"));
+
+  int errors = 0;
+
+#if !defined (ACE_LACKS_CDR_ALIGNMENT)
+  // The layouts are known at compile time.
+  if (ACE_CDR_Fixed<Sample>::wire_size != 16
+      || ACE_CDR_Fixed<Sample>::alignment != 8
+      || ACE_CDR_Fixed<Tail>::wire_size != 10
+      || ACE_CDR_Fixed<Tail>::stride != 16
+      || ACE_CDR_Fixed<Mixed>::wire_size != 44
+      || ACE_CDR_Fixed<Mixed>::native_layout)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("Wrong layouts\n")));
+      ++errors;
+    }
+
+  // No padding where the compiler would not put any.
+  if (sizeof (Sample) == 16 && offsetof (Sample, value) == 8
+      && !ACE_CDR_Fixed<Sample>::native_layout)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("Sample should be copied\n")));
+      ++errors;
+    }
+#endif /* ACE_LACKS_CDR_ALIGNMENT */
+
+  errors += check<Sample> (ACE_TEXT ("Sample"));
+  errors += check<Tail> (ACE_TEXT ("Tail"));
+  errors += check<Mixed> (ACE_TEXT ("Mixed"));
+
+  if (errors == 0)
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("All the structures are marshaled right\n")));
+
+  ACE_END_TEST;
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+//=============================================================================
+/**
+ *  @file    CDR_Swap_Test.cpp
+ *
+ *  $Id$
+ *
+ *  Checks ACE_CDR::swap_2_array, swap_4_array and swap_8_array, which
+ *  swap the bulk of the arrays with vector instructions on some
+ *  platforms, against swapping one element at a time, for arrays of
+ *  all the lengths up to a few vectors, at all the alignments of the
+ *  elements, in place or not, and when reading arrays from a CDR
+ *  stream of the other byte order.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/CDR_Base.h"
+#include "ace/CDR_Stream.h"
+#include "ace/OS_NS_string.h"
+
+static const size_t max_elements = 100;
+
+// Room for the largest array, misaligned by up to 32 bytes.
+static const size_t buffer_size = 8 * max_elements + 64;
+
+typedef void (*Array_Swap) (char const *, char *, size_t);
+typedef void (*Element_Swap) (char const *, char *);
+
+static int
+check_swap (size_t size, Array_Swap swap_array, Element_Swap swap)
+{
+  // Aligned for the largest element.
+  ACE_CDR::ULongLong orig_words[buffer_size / 8];
+  ACE_CDR::ULongLong target_words[buffer_size / 8];
+  ACE_CDR::ULongLong expected_words[buffer_size / 8];
+  char *const orig_buffer = reinterpret_cast<char *> (orig_words);
+  char *const target_buffer = reinterpret_cast<char *> (target_words);
+  char *const expected_buffer = reinterpret_cast<char *> (expected_words);
+
+  for (size_t i = 0; i < buffer_size; ++i)
+    orig_buffer[i] = static_cast<char> (i * 7 + 3);
+
+  int errors = 0;
+  for (size_t n = 1; n <= max_elements; ++n)
+    for (size_t orig_offset = 0; orig_offset < 32; orig_offset += size)
+      for (size_t target_offset = 0; target_offset < 32; target_offset += size)
+        {
+          char const *const orig = orig_buffer + orig_offset;
+          char *const target = target_buffer + target_offset;
+          char *const expected = expected_buffer + target_offset;
+
+          // The bytes around the array must be left alone.
+          ACE_OS::memset (target_buffer, 0x5a, buffer_size);
+          ACE_OS::memset (expected_buffer, 0x5a, buffer_size);
+          for (size_t i = 0; i < n; ++i)
+            swap (orig + i * size, expected + i * size);
+
+          swap_array (orig, target, n);
+          if (ACE_OS::memcmp (target_buffer, expected_buffer, buffer_size) != 0)
+            {
+              ACE_ERROR ((LM_ERROR,
+                          ACE_TEXT ("swap_%B_array of %B elements from ")
+                          ACE_TEXT ("offset %B to offset %B failed\n"),
+                          size, n, orig_offset, target_offset));
+              ++errors;
+            }
+
+          // In place.
+          if (orig_offset == target_offset)
+            {
+              ACE_OS::memcpy (target_buffer, orig_buffer, buffer_size);
+              ACE_OS::memcpy (expected_buffer, orig_buffer, buffer_size);
+              for (size_t i = 0; i < n; ++i)
+                swap (orig + i * size, expected + i * size);
+
+              swap_array (target, target, n);
+              if (ACE_OS::memcmp (target_buffer,
+                                  expected_buffer,
+                                  buffer_size) != 0)
+                {
+                  ACE_ERROR ((LM_ERROR,
+                              ACE_TEXT ("swap_%B_array of %B elements in ")
+                              ACE_TEXT ("place at offset %B failed\n"),
+                              size, n, orig_offset));
+                  ++errors;
+                }
+            }
+        }
+
+  return errors;
+}
+
+// Read arrays from a stream of the other byte order.
+static int
+check_read_swapped (void)
+{
+  ACE_CDR::Short shorts[max_elements];
+  ACE_CDR::Long longs[max_elements];
+  ACE_CDR::Double doubles[max_elements];
+  for (size_t i = 0; i < max_elements; ++i)
+    {
+      shorts[i] = static_cast<ACE_CDR::Short> (i * 0x0102 + 3);
+      longs[i] = static_cast<ACE_CDR::Long> (i * 0x01020304 + 5);
+      doubles[i] = static_cast<ACE_CDR::Double> (i) * 1.25 - 17.0;
+    }
+
+  ACE_OutputCDR out;
+  out.write_short_array (shorts, max_elements);
+  out.write_long_array (longs, max_elements);
+  out.write_double_array (doubles, max_elements);
+  if (!out.good_bit () || out.consolidate () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot write the arrays\n")), 1);
+
+  int const opposite_byte_order = 1 - ACE_CDR_BYTE_ORDER;
+  ACE_InputCDR in (out.buffer (), out.length (), opposite_byte_order);
+  ACE_CDR::Short shorts_in[max_elements];
+  ACE_CDR::Long longs_in[max_elements];
+  ACE_CDR::Double doubles_in[max_elements];
+  if (!in.read_short_array (shorts_in, max_elements)
+      || !in.read_long_array (longs_in, max_elements)
+      || !in.read_double_array (doubles_in, max_elements))
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("Cannot read the arrays\n")), 1);
+
+  for (size_t i = 0; i < max_elements; ++i)
+    {
+      ACE_CDR::Short s;
+      ACE_CDR::Long l;
+      ACE_CDR::Double d;
+      ACE_CDR::swap_2 (reinterpret_cast<char const *> (&shorts[i]),
+                       reinterpret_cast<char *> (&s));
+      ACE_CDR::swap_4 (reinterpret_cast<char const *> (&longs[i]),
+                       reinterpret_cast<char *> (&l));
+      ACE_CDR::swap_8 (reinterpret_cast<char const *> (&doubles[i]),
+                       reinterpret_cast<char *> (&d));
+      if (s != shorts_in[i]
+          || l != longs_in[i]
+          || ACE_OS::memcmp (&d, &doubles_in[i], sizeof d) != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("Element %B of the arrays read from a ")
+                           ACE_TEXT ("stream of the other byte order is ")
+                           ACE_TEXT ("wrong\n"),
+                           i),
+                          1);
+    }
+  return 0;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("CDR_Swap_Test"));
+
+  int errors = 0;
+  errors += check_swap (2, ACE_CDR::swap_2_array, ACE_CDR::swap_2);
+  errors += check_swap (4, ACE_CDR::swap_4_array, ACE_CDR::swap_4);
+  errors += check_swap (8, ACE_CDR::swap_8_array, ACE_CDR::swap_8);
+  errors += check_read_swapped ();
+
+  if (errors == 0)
+    ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("All the swaps are right\n")));
+
+  ACE_END_TEST;
+  return errors == 0 ? 0 : 1;
+}
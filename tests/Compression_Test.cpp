@@ -0,0 +1,707 @@
+
+//=============================================================================
+/**
+ *  @file    Compression_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that ACE_LZ4Compressor gives back what it
+ *  compressed, with data of all kinds and sizes, that it stops at the
+ *  end of its output, and that it refuses corrupt input, and that
+ *  ACE_RLECompressor makes the same packets of runs of any length
+ *  wherever they start.  It then compresses a stream cut into random
+ *  pieces with ACE_Streaming_Compressor and both the LZ4 and RLE
+ *  compressors, decompresses the frames cut differently with
+ *  ACE_Streaming_Decompressor, and checks the stream is unchanged.
+ *  Last it checks that data that does not compress is mostly not
+ *  given to the compressor, and that messages written to an ACE_Stream
+ *  through an ACE_Compression_Module with worker threads come back
+ *  up in order.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Compression/Streaming_Compressor.h"
+#include "ace/Compression/lz4/LZ4Compressor.h"
+#include "ace/Compression/rle/RLECompressor.h"
+#include "ace/Compression/Compression_Task_T.h"
+#include "ace/Stream.h"
+#include "ace/Stream_Modules.h"
+#include "ace/Message_Block.h"
+#include "ace/Min_Max.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_sys_time.h"
+
+static unsigned int seed = 4711;
+
+static size_t
+random_size (size_t max)
+{
+  return static_cast<size_t> (ACE_OS::rand_r (&seed)) % max;
+}
+
+// Fill @a buf with data of the given kind: 0 random, 1 a single
+// byte, 2 short runs of a few bytes, 3 text-like words, 4 a pattern
+// with a period of 1 to 16 bytes and random changes.
+static void
+fill (char *buf, size_t len, int kind)
+{
+  static const char *const words[] =
+    {
+      "reactor ", "acceptor ", "connector ", "message block ",
+      "stream ", "task ", "the ", "of ", "handle_input ", "\n"
+    };
+
+  size_t const period = 1 + random_size (16);
+
+  for (size_t i = 0; i < len; )
+    switch (kind)
+      {
+      case 0:
+        buf[i++] = static_cast<char> (ACE_OS::rand_r (&seed));
+        break;
+      case 1:
+        buf[i++] = 'A';
+        break;
+      case 2:
+        {
+          char const c = static_cast<char> ('a' + random_size (4));
+          for (size_t run = 1 + random_size (6); run > 0 && i < len; --run)
+            buf[i++] = c;
+        }
+        break;
+      case 3:
+        for (const char *w = words[random_size (10)]; *w != 0 && i < len; ++w)
+          buf[i++] = *w;
+        break;
+      default:
+        buf[i] = i < period || random_size (64) == 0
+          ? static_cast<char> (ACE_OS::rand_r (&seed))
+          : buf[i - period];
+        ++i;
+        break;
+      }
+}
+
+static int
+test_lz4 (void)
+{
+  int errors = 0;
+  ACE_LZ4Compressor &lz4 = *ACE_LZ4Compression::instance ();
+
+  static const size_t sizes[] =
+    { 1, 4, 12, 13, 17, 100, 255, 270, 4096, 65535, 65536, 70000, 300000 };
+  size_t const max_size = 300000;
+
+  char *data = new char[max_size];
+  char *compressed = new char[ACE_LZ4Compressor::compress_bound (max_size)];
+  char *decompressed = new char[max_size];
+
+  for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; ++s)
+    for (int kind = 0; kind < 5; ++kind)
+      {
+        size_t const len = sizes[s];
+        fill (data, len, kind);
+
+        ACE_UINT64 const bound = ACE_LZ4Compressor::compress_bound (len);
+        ACE_UINT64 const clen = lz4.compress (data, len, compressed, bound);
+        if (clen == ACE_UINT64 (-1) || clen > bound)
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("compress of %B bytes of kind %d failed\n"),
+                        len, kind));
+            ++errors;
+            continue;
+          }
+
+        ACE_UINT64 const dlen =
+          lz4.decompress (compressed, clen, decompressed, len);
+        if (dlen != len || ACE_OS::memcmp (data, decompressed, len) != 0)
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("%B bytes of kind %d did not round trip\n"),
+                        len, kind));
+            ++errors;
+          }
+
+        // Too little output is an error, not an overflow.
+        if (clen > 1
+            && lz4.compress (data, len, compressed, clen - 1) != ACE_UINT64 (-1))
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("compress of %B bytes into %Q did not fail\n"),
+                        len, clen - 1));
+            ++errors;
+          }
+
+        if (len > 1
+            && lz4.decompress (compressed, clen, decompressed, len - 1)
+               != ACE_UINT64 (-1))
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("decompress of %B bytes into %B ")
+                        ACE_TEXT ("did not fail\n"),
+                        len, len - 1));
+            ++errors;
+          }
+
+        if (lz4.decompress (compressed, clen - 1, decompressed, len)
+            == ACE_UINT64 (len))
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("truncated block of %B bytes ")
+                        ACE_TEXT ("decompressed\n"),
+                        len));
+            ++errors;
+          }
+
+        if (len == 65536)
+          ACE_DEBUG ((LM_DEBUG,
+                      ACE_TEXT ("%B bytes of kind %d compressed to %Q\n"),
+                      len, kind, clen));
+      }
+
+  // Garbage must fail or give something, never overrun.
+  for (int i = 0; i < 1000; ++i)
+    {
+      size_t const len = 1 + random_size (512);
+      fill (compressed, len, i % 2 == 0 ? 0 : 4);
+      ACE_UINT64 const dlen =
+        lz4.decompress (compressed, len, decompressed, 4096);
+      if (dlen != ACE_UINT64 (-1) && dlen > 4096)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("garbage decompressed to %Q bytes\n"),
+                      dlen));
+          ++errors;
+        }
+    }
+
+  delete [] decompressed;
+  delete [] compressed;
+  delete [] data;
+  return errors;
+}
+
+// The runs are found many bytes at a time: check the packets at
+// every run length around the width of the scan and its multiples,
+// and at every offset from the start.
+static int
+test_rle (void)
+{
+  int errors = 0;
+  ACE_RLECompressor &rle = *ACE_RLECompression::instance ();
+
+  // The example of RLECompressor.h.
+  static const char example[] =
+    "WWWWWWWWWWWWBWWWWWWWWWWWWBBBWWWWWWWWWWWWWWWWWWWWWWWWBWWWWWWWWWWWWWW";
+  static const ACE_Byte expected[] =
+    { 0x8B, 0x57, 0x00, 0x42, 0x8B, 0x57, 0x82, 0x42,
+      0x97, 0x57, 0x00, 0x42, 0x8D, 0x57 };
+
+  ACE_Byte packed[sizeof expected + 1];
+  if (rle.compress (example, sizeof example - 1, packed, sizeof packed)
+        != sizeof expected
+      || ACE_OS::memcmp (packed, expected, sizeof expected) != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("RLE example not compressed as documented\n")));
+      ++errors;
+    }
+
+  size_t const max_size = 3 * 300 + 64;
+  char *data = new char[max_size];
+  char *compressed = new char[2 * max_size];
+  char *decompressed = new char[max_size];
+
+  for (size_t run = 1; run <= 300; ++run)
+    for (size_t offset = 0; offset < 40; offset += 13)
+      {
+        // Bytes that differ from their neighbours, the run, and a copy
+        // of them after it.
+        size_t len = 0;
+        for (size_t i = 0; i < offset; ++i)
+          data[len++] = static_cast<char> (i);
+        ACE_OS::memset (data + len, 'r', run);
+        len += run;
+        for (size_t i = 0; i < offset; ++i)
+          data[len++] = static_cast<char> (i);
+
+        ACE_UINT64 const clen =
+          rle.compress (data, len, compressed, 2 * max_size);
+
+        // Two bytes for each 128 of the run and for the rest of it, but
+        // a single byte left over is copied along with the bytes after
+        // it, and a run of one joins the bytes before it too.
+        size_t const rest = (run - 1) % 128 + 1;
+        size_t const after = offset + (rest == 1 ? 1 : 0);
+        size_t expected_len =
+          2 * ((run - 1) / 128 + (rest > 1 ? 1 : 0))
+          + (offset > 0 ? 1 + offset : 0)
+          + (after > 0 ? 1 + after : 0);
+        if (run == 1 && offset > 0)
+          --expected_len;
+
+        if (clen != expected_len)
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("run of %B after %B bytes compressed ")
+                        ACE_TEXT ("to %Q bytes\n"),
+                        run, offset, clen));
+            ++errors;
+            continue;
+          }
+
+        if (rle.decompress (compressed, clen, decompressed, max_size) != len
+            || ACE_OS::memcmp (data, decompressed, len) != 0)
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("run of %B after %B bytes did not ")
+                        ACE_TEXT ("round trip\n"),
+                        run, offset));
+            ++errors;
+          }
+
+        if (rle.compress (data, len, compressed, clen - 1) != ACE_UINT64 (-1))
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("RLE compress of %B bytes into %Q ")
+                        ACE_TEXT ("did not fail\n"),
+                        len, clen - 1));
+            ++errors;
+          }
+      }
+
+  delete [] decompressed;
+  delete [] compressed;
+  delete [] data;
+  return errors;
+}
+
+// Hand the @a len bytes at @a data to @a sink in random pieces, some
+// of them chained, and return the result of the last call.
+template <class SINK> static int
+feed (SINK &sink,
+      const char *data,
+      size_t len,
+      size_t max_piece,
+      ACE_Message_Block *&out)
+{
+  while (len > 0)
+    {
+      ACE_Message_Block *chain = 0;
+      ACE_Message_Block *tail = 0;
+
+      for (size_t blocks = 1 + random_size (3); blocks > 0 && len > 0; --blocks)
+        {
+          size_t const n = ace_min (len, 1 + random_size (max_piece));
+          ACE_Message_Block *mb = new ACE_Message_Block (data, n);
+          mb->wr_ptr (n);
+          if (tail == 0)
+            chain = mb;
+          else
+            tail->cont (mb);
+          tail = mb;
+          data += n;
+          len -= n;
+        }
+
+      int const result = sink.compress_or_decompress (chain, out);
+      chain->release ();
+      if (result != 0)
+        return result;
+    }
+
+  return 0;
+}
+
+struct Compress_Sink
+{
+  ACE_Streaming_Compressor &c_;
+  int compress_or_decompress (const ACE_Message_Block *in,
+                              ACE_Message_Block *&out)
+  {
+    return c_.compress (in, out);
+  }
+};
+
+struct Decompress_Sink
+{
+  ACE_Streaming_Decompressor &d_;
+  int compress_or_decompress (const ACE_Message_Block *in,
+                              ACE_Message_Block *&out)
+  {
+    return d_.decompress (in, out);
+  }
+};
+
+// Copy the data of the chain @a mb to @a buf.
+static size_t
+gather (const ACE_Message_Block *mb, char *buf)
+{
+  size_t len = 0;
+  for (; mb != 0; mb = mb->cont ())
+    {
+      ACE_OS::memcpy (buf + len, mb->rd_ptr (), mb->length ());
+      len += mb->length ();
+    }
+  return len;
+}
+
+static int
+test_streaming (ACE_Compressor &compressor, const ACE_TCHAR *name)
+{
+  int errors = 0;
+  size_t const len = 1000000;
+  char *data = new char[len];
+  char *wire = new char[2 * len];
+  char *result = new char[len];
+
+  // A stream of pieces of each kind of data.
+  for (size_t i = 0; i < len; )
+    {
+      size_t const n = ace_min (len - i, 1 + random_size (50000));
+      fill (data + i, n, static_cast<int> (random_size (5)));
+      i += n;
+    }
+
+  static const size_t block_sizes[] = { 1, 100, 4096, 65536 };
+
+  for (size_t b = 0; b < sizeof block_sizes / sizeof block_sizes[0]; ++b)
+    {
+      size_t const block_size = block_sizes[b];
+      size_t const stream_len = block_size == 1 ? 10000 : len;
+
+      ACE_Streaming_Compressor c (compressor, block_size);
+      Compress_Sink cs = { c };
+      ACE_Message_Block *frames = 0;
+      if (feed (cs, data, stream_len, 3 * block_size, frames) != 0
+          || c.flush (frames) != 0
+          || c.pending () != 0)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("%s: compress in blocks of %B failed\n"),
+                      name, block_size));
+          ++errors;
+          if (frames != 0)
+            frames->release ();
+          continue;
+        }
+
+      size_t const wire_len = gather (frames, wire);
+      frames->release ();
+
+      ACE_Streaming_Decompressor d (compressor);
+      Decompress_Sink ds = { d };
+      ACE_Message_Block *blocks = 0;
+      if (feed (ds, wire, wire_len, 1 + block_size / 3, blocks) != 0
+          || d.pending () != 0)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("%s: decompress in blocks of %B failed\n"),
+                      name, block_size));
+          ++errors;
+          if (blocks != 0)
+            blocks->release ();
+          continue;
+        }
+
+      size_t const result_len = gather (blocks, result);
+      blocks->release ();
+
+      if (result_len != stream_len
+          || ACE_OS::memcmp (data, result, stream_len) != 0)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("%s: %B bytes in blocks of %B ")
+                      ACE_TEXT ("came back as %B\n"),
+                      name, stream_len, block_size, result_len));
+          ++errors;
+        }
+      else
+        ACE_DEBUG ((LM_DEBUG,
+                    ACE_TEXT ("%s: %B bytes in blocks of %B ")
+                    ACE_TEXT ("compressed to %B\n"),
+                    name, stream_len, block_size, wire_len));
+
+      // A frame that lies about its length is refused, and so is
+      // anything after it.
+      if (wire_len > 8)
+        {
+          wire[0] = static_cast<char> (0xff);
+          ACE_Message_Block bad (wire, wire_len);
+          bad.wr_ptr (wire_len);
+          ACE_Streaming_Decompressor bad_d (compressor);
+          ACE_Message_Block *bad_out = 0;
+          if (bad_d.decompress (&bad, bad_out) != -1
+              || bad_d.decompress (&bad, bad_out) != -1)
+            {
+              ACE_ERROR ((LM_ERROR,
+                          ACE_TEXT ("%s: corrupt frame accepted\n"),
+                          name));
+              ++errors;
+            }
+          if (bad_out != 0)
+            bad_out->release ();
+        }
+    }
+
+  delete [] result;
+  delete [] wire;
+  delete [] data;
+  return errors;
+}
+
+// Counts the blocks given to the LZ4 compressor.
+class Counting_Compressor : public ACE_Compressor
+{
+public:
+  Counting_Compressor (void)
+    : ACE_Compressor (ACE_COMPRESSORID_LZ4),
+      calls_ (0)
+  {
+  }
+
+  virtual ACE_UINT64 compress (const void *in_ptr,
+                               ACE_UINT64 in_len,
+                               void *out_ptr,
+                               ACE_UINT64 max_out_len)
+  {
+    ++this->calls_;
+    return ACE_LZ4Compression::instance ()->compress (in_ptr,
+                                                      in_len,
+                                                      out_ptr,
+                                                      max_out_len);
+  }
+
+  virtual ACE_UINT64 decompress (const void *in_ptr,
+                                 ACE_UINT64 in_len,
+                                 void *out_ptr,
+                                 ACE_UINT64 max_out_len)
+  {
+    return ACE_LZ4Compression::instance ()->decompress (in_ptr,
+                                                        in_len,
+                                                        out_ptr,
+                                                        max_out_len);
+  }
+
+  size_t calls_;
+};
+
+static int
+test_bypass (void)
+{
+  int errors = 0;
+  size_t const block_size = 4096;
+  size_t const blocks = 256;
+  char *data = new char[block_size];
+
+  Counting_Compressor counter;
+  ACE_Streaming_Compressor c (counter, block_size);
+
+  // Random data is tried less and less often.
+  for (size_t i = 0; i < blocks; ++i)
+    {
+      fill (data, block_size, 0);
+      ACE_Message_Block mb (data, block_size);
+      mb.wr_ptr (block_size);
+      ACE_Message_Block *frames = 0;
+      c.compress (&mb, frames);
+      frames->release ();
+    }
+
+  size_t const random_calls = counter.calls_;
+  float const random_ratio = c.compression_ratio ();
+
+  // Text is compressed again after the next try.
+  counter.calls_ = 0;
+  for (size_t i = 0; i < blocks; ++i)
+    {
+      fill (data, block_size, 3);
+      ACE_Message_Block mb (data, block_size);
+      mb.wr_ptr (block_size);
+      ACE_Message_Block *frames = 0;
+      c.compress (&mb, frames);
+      frames->release ();
+    }
+
+  size_t const text_calls = counter.calls_;
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%B random blocks tried %B times, ratio %.2f, ")
+              ACE_TEXT ("%B text blocks %B times, ratio %.2f\n"),
+              blocks, random_calls, random_ratio,
+              blocks, text_calls, c.compression_ratio ()));
+
+  if (random_calls > blocks / 8
+      || text_calls < blocks - ACE_Streaming_Compressor::MAX_BYPASS_BLOCKS
+      || random_ratio <= c.bypass_ratio ()
+      || c.compression_ratio () > 0.5f)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("compression was not bypassed right\n")));
+      ++errors;
+    }
+
+  // Small blocks are never tried.
+  counter.calls_ = 0;
+  ACE_Message_Block small (data, c.min_size () - 1);
+  small.wr_ptr (small.size ());
+  ACE_Message_Block *frames = 0;
+  c.compress (&small, frames);
+  c.flush (frames);
+  if (counter.calls_ != 0 || frames == 0)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("small block compressed\n")));
+      ++errors;
+    }
+  if (frames != 0)
+    frames->release ();
+
+  delete [] data;
+  return errors;
+}
+
+#if defined (ACE_HAS_THREADS)
+
+typedef ACE_Stream<ACE_MT_SYNCH> STREAM;
+typedef ACE_Module<ACE_MT_SYNCH> MODULE;
+
+// Sends the messages written down the stream back up.
+class Loopback_Task : public ACE_Task<ACE_MT_SYNCH>
+{
+public:
+  virtual int put (ACE_Message_Block *mb, ACE_Time_Value *tv = 0)
+  {
+    return this->is_writer () ? this->reply (mb, tv) : this->put_next (mb, tv);
+  }
+};
+
+// Counts the bytes written down the stream.
+class Counting_Task : public ACE_Task<ACE_MT_SYNCH>
+{
+public:
+  Counting_Task (void) : bytes_ (0) {}
+
+  virtual int put (ACE_Message_Block *mb, ACE_Time_Value *tv = 0)
+  {
+    this->bytes_ += mb->total_length ();
+    return this->put_next (mb, tv);
+  }
+
+  size_t bytes_;
+};
+
+static int
+test_stream (void)
+{
+  int errors = 0;
+  int const messages = 500;
+  size_t const max_message = 20000;
+
+  Counting_Task *counter = new Counting_Task;
+  MODULE *tail = new MODULE (ACE_TEXT ("Loopback"),
+                             new Loopback_Task,
+                             new Loopback_Task);
+  STREAM stream (0, 0, tail);
+
+  if (stream.push (new MODULE (ACE_TEXT ("Counter"),
+                               counter,
+                               new ACE_Thru_Task<ACE_MT_SYNCH>)) == -1
+      || stream.push (new ACE_Compression_Module<ACE_MT_SYNCH> (
+                        ACE_TEXT ("Compression"),
+                        *ACE_LZ4Compression::instance (),
+                        3,
+                        4096)) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("push")), 1);
+
+  // All the messages are written before they are read back.
+  stream.head ()->reader ()->water_marks (ACE_IO_Cntl_Msg::SET_HWM,
+                                          2 * messages * max_message);
+
+  char *sent = new char[messages * max_message];
+  char *received = new char[messages * max_message];
+  size_t sent_len = 0;
+
+  for (int i = 0; i < messages; ++i)
+    {
+      size_t const len = 1 + random_size (max_message);
+      fill (sent + sent_len, len, static_cast<int> (random_size (5)));
+
+      ACE_Message_Block *mb = new ACE_Message_Block (len);
+      mb->copy (sent + sent_len, len);
+      sent_len += len;
+      if (stream.put (mb) == -1)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("put")));
+          mb->release ();
+          ++errors;
+        }
+    }
+
+  size_t received_len = 0;
+  while (received_len < sent_len)
+    {
+      ACE_Time_Value timeout (ACE_OS::gettimeofday () + ACE_Time_Value (10));
+      ACE_Message_Block *mb = 0;
+      if (stream.get (mb, &timeout) == -1)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("get")));
+          ++errors;
+          break;
+        }
+      for (ACE_Message_Block *b = mb; b != 0; b = b->cont ())
+        {
+          size_t const n = ace_min (b->length (), sent_len - received_len);
+          ACE_OS::memcpy (received + received_len, b->rd_ptr (), n);
+          received_len += n;
+        }
+      mb->release ();
+    }
+
+  if (received_len != sent_len
+      || ACE_OS::memcmp (sent, received, sent_len) != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B bytes written, %B different bytes read\n"),
+                  sent_len, received_len));
+      ++errors;
+    }
+  else
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("%d messages of %B bytes through the stream ")
+                ACE_TEXT ("as %B bytes\n"),
+                messages, sent_len, counter->bytes_));
+
+  if (counter->bytes_ >= sent_len)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("stream not compressed\n")));
+      ++errors;
+    }
+
+  stream.close ();
+
+  delete [] received;
+  delete [] sent;
+  return errors;
+}
+
+#endif /* ACE_HAS_THREADS */
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Compression_Test"));
+
+  int errors = test_lz4 ();
+  errors += test_rle ();
+  errors += test_streaming (*ACE_LZ4Compression::instance (), ACE_TEXT ("LZ4"));
+  errors += test_streaming (*ACE_RLECompression::instance (), ACE_TEXT ("RLE"));
+  errors += test_bypass ();
+#if defined (ACE_HAS_THREADS)
+  errors += test_stream ();
+#endif /* ACE_HAS_THREADS */
+
+  ACE_END_TEST;
+  return errors;
+}
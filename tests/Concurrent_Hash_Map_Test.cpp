@@ -0,0 +1,342 @@
+
+//=============================================================================
+/**
+ *  @file    Concurrent_Hash_Map_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that ACE_Concurrent_Hash_Map returns what
+ *  ACE_Hash_Map_Manager_Ex returns, that its iterators visit every
+ *  entry of every stripe once, that threads can bind, find and
+ *  unbind their own keys while looking up those of the others, and
+ *  that it can be the map of an ACE_Hash_Cache_Map_Manager.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Concurrent_Hash_Map_T.h"
+#include "ace/Hash_Map_Manager_T.h"
+#include "ace/Hash_Cache_Map_Manager_T.h"
+#include "ace/Caching_Strategies_T.h"
+#include "ace/Null_Mutex.h"
+#include "ace/RW_Thread_Mutex.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Atomic_Op.h"
+#include "ace/OS_NS_stdlib.h"
+
+typedef ACE_Concurrent_Hash_Map<int,
+                                int,
+                                ACE_Hash<int>,
+                                ACE_Equal_To<int>,
+                                ACE_Null_Mutex> INT_MAP;
+
+typedef ACE_Hash_Map_Manager_Ex<int,
+                                int,
+                                ACE_Hash<int>,
+                                ACE_Equal_To<int>,
+                                ACE_Null_Mutex> ORACLE_MAP;
+
+typedef ACE_Concurrent_Hash_Map<int,
+                                int,
+                                ACE_Hash<int>,
+                                ACE_Equal_To<int>,
+                                ACE_RW_Thread_Mutex> SHARED_MAP;
+
+// = Cache of ACE_Concurrent_Hash_Map.
+typedef std::pair<int, int> CACHE_VALUE;
+typedef ACE_Concurrent_Hash_Map<int,
+                                CACHE_VALUE,
+                                ACE_Hash<int>,
+                                ACE_Equal_To<int>,
+                                ACE_RW_Thread_Mutex> CACHE_MAP;
+typedef ACE_Pair_Caching_Utility<int, CACHE_VALUE, CACHE_MAP, CACHE_MAP::ITERATOR, int>
+        CACHING_UTILITY;
+typedef ACE_LRU_Caching_Strategy<int, CACHING_UTILITY>
+        LRU;
+typedef ACE_Hash_Cache_Map_Manager<int, int, ACE_Hash<int>, ACE_Equal_To<int>, LRU, int, CACHE_MAP>
+        CACHE;
+
+static const int ENTRIES = 20000;
+static const int OPERATIONS = 200000;
+static const int THREADS = 4;
+static const int THREAD_KEYS = 5000;
+static const int ROUNDS = 20;
+
+// Apply the same random operations to an ACE_Concurrent_Hash_Map and
+// an ACE_Hash_Map_Manager_Ex and compare their results.
+static int
+test_oracle (void)
+{
+  int errors = 0;
+  INT_MAP map (256, 0, 0, 8);
+  ORACLE_MAP oracle;
+
+  ACE_OS::srand (4711);
+
+  for (int i = 0; i < OPERATIONS && errors < 10; ++i)
+    {
+      int const key = ACE_OS::rand () % (ENTRIES / 4);
+      int const value = ACE_OS::rand ();
+      int const op = ACE_OS::rand () % 6;
+      int result = 0;
+      int expected = 0;
+      int result_value = -1;
+      int expected_value = -1;
+
+      switch (op)
+        {
+        case 0:
+          result = map.bind (key, value);
+          expected = oracle.bind (key, value);
+          break;
+        case 1:
+          result_value = expected_value = value;
+          result = map.trybind (key, result_value);
+          expected = oracle.trybind (key, expected_value);
+          break;
+        case 2:
+          result = map.rebind (key, value, result_value);
+          expected = oracle.rebind (key, value, expected_value);
+          break;
+        case 3:
+          result = map.find (key, result_value);
+          expected = oracle.find (key, expected_value);
+          break;
+        default:
+          result = map.unbind (key, result_value);
+          expected = oracle.unbind (key, expected_value);
+          break;
+        }
+
+      if (result != expected
+          || (expected >= 0 && result_value != expected_value)
+          || map.current_size () != oracle.current_size ())
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("operation %d on key %d returned %d (%d), ")
+                      ACE_TEXT ("expected %d (%d)\n"),
+                      op, key, result, result_value,
+                      expected, expected_value));
+          ++errors;
+        }
+    }
+
+  // Both iterators visit every entry once.
+  size_t visited = 0;
+  long sum = 0;
+  for (INT_MAP::iterator iter = map.begin (); iter != map.end (); ++iter)
+    {
+      ++visited;
+      sum += (*iter).key ();
+    }
+
+  size_t reverse_visited = 0;
+  long reverse_sum = 0;
+  for (INT_MAP::reverse_iterator iter = map.rbegin ();
+       iter != map.rend ();
+       ++iter)
+    {
+      ++reverse_visited;
+      reverse_sum += iter->key ();
+    }
+
+  long expected_sum = 0;
+  for (ORACLE_MAP::iterator iter = oracle.begin ();
+       iter != oracle.end ();
+       ++iter)
+    expected_sum += (*iter).ext_id_;
+
+  if (visited != oracle.current_size ()
+      || reverse_visited != visited
+      || sum != expected_sum
+      || reverse_sum != expected_sum)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("iterated over %B and %B entries, expected %B\n"),
+                  visited, reverse_visited, oracle.current_size ()));
+      ++errors;
+    }
+
+  // The bucket of a key holds its entry.
+  int const key = (*oracle.begin ()).ext_id_;
+  int in_bucket = 0;
+  for (INT_MAP::BUCKET_ITERATOR iter (map, key), end (map, key, 1);
+       iter != end;
+       ++iter)
+    in_bucket += (*iter).ext_id_ == key;
+
+  if (in_bucket != 1)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("key %d found %d times in its bucket\n"),
+                  key, in_bucket));
+      ++errors;
+    }
+
+  map.unbind_all ();
+  if (map.current_size () != 0 || map.begin () != map.end ())
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("entries left after unbind_all\n")));
+      ++errors;
+    }
+
+  return errors;
+}
+
+#if defined (ACE_HAS_THREADS)
+
+static SHARED_MAP *shared_map = 0;
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> thread_count (0);
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> thread_errors (0);
+
+// Every key is bound to twice its value, so that threads can check
+// the entries of the others.
+static void *
+worker (void *)
+{
+  int const first = static_cast<int> (thread_count++) * THREAD_KEYS;
+  int const others = THREADS * THREAD_KEYS;
+  long errors = 0;
+
+  for (int r = 0; r < ROUNDS; ++r)
+    {
+      for (int i = first; i < first + THREAD_KEYS; ++i)
+        if (shared_map->bind (i, i * 2) != 0)
+          ++errors;
+
+      for (int i = 0; i < THREAD_KEYS; ++i)
+        {
+          int const key = (i * 7919 + r) % others;
+          int value = -1;
+          if (shared_map->find (key, value) == 0 && value != key * 2)
+            ++errors;
+          if (key >= first && key < first + THREAD_KEYS && value != key * 2)
+            ++errors;
+        }
+
+      for (int i = first; i < first + THREAD_KEYS; ++i)
+        if (i % 2 != 0 || r + 1 < ROUNDS)
+          {
+            if (shared_map->unbind (i) != 0)
+              ++errors;
+          }
+        else if (shared_map->rebind (i, i * 2) != 1)
+          ++errors;
+    }
+
+  if (errors != 0)
+    ACE_ERROR ((LM_ERROR,
+                ACE_TEXT ("(%t) %d errors on keys from %d\n"),
+                static_cast<int> (errors), first));
+  thread_errors += errors;
+  return 0;
+}
+
+static int
+test_threads (void)
+{
+  int errors = 0;
+  SHARED_MAP map (1024);
+  shared_map = &map;
+
+  if (ACE_Thread_Manager::instance ()->spawn_n (THREADS,
+                                                ACE_THR_FUNC (worker)) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn_n")), 1);
+  ACE_Thread_Manager::instance ()->wait ();
+
+  errors += static_cast<int> (thread_errors.value ());
+
+  size_t const expected = THREADS * THREAD_KEYS / 2;
+  if (map.current_size () != expected)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B entries left, expected %B\n"),
+                  map.current_size (), expected));
+      ++errors;
+    }
+
+  for (int i = 0; i < THREADS * THREAD_KEYS; ++i)
+    if ((map.find (i) == 0) != (i % 2 == 0))
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("wrong entry for key %d\n"), i));
+        ++errors;
+        break;
+      }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%d threads, %B entries in %B stripes\n"),
+              THREADS, map.current_size (), map.stripes ()));
+
+  shared_map = 0;
+  return errors;
+}
+
+#endif /* ACE_HAS_THREADS */
+
+// Purge the least recently used entries of a cache.
+static int
+test_cache (void)
+{
+  int errors = 0;
+  LRU lru;
+  CACHE cache (lru, 64);
+
+  for (int i = 0; i < 100; ++i)
+    cache.bind (i, i * 2);
+
+  // Use the first ten entries, which would otherwise be purged.
+  for (int i = 0; i < 10; ++i)
+    {
+      int value = 0;
+      if (cache.find (i, value) != 0 || value != i * 2)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("key %d not cached\n"), i));
+          ++errors;
+        }
+    }
+
+  cache.caching_strategy ().purge_percent (10);
+  if (cache.purge () != 0 || cache.current_size () != 90)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B entries left after purge\n"),
+                  cache.current_size ()));
+      ++errors;
+    }
+
+  for (int i = 0; i < 20; ++i)
+    if ((cache.find (i) == 0) != (i < 10))
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("key %d purged wrongly\n"), i));
+        ++errors;
+      }
+
+  size_t visited = 0;
+  for (CACHE::ITERATOR iter = cache.begin (); iter != cache.end (); ++iter)
+    ++visited;
+
+  if (visited != cache.current_size ())
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("iterated over %B cached entries\n"),
+                  visited));
+      ++errors;
+    }
+
+  return errors;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Concurrent_Hash_Map_Test"));
+
+  int errors = test_oracle ();
+#if defined (ACE_HAS_THREADS)
+  errors += test_threads ();
+#endif /* ACE_HAS_THREADS */
+  errors += test_cache ();
+
+  ACE_END_TEST;
+  return errors;
+}
@@ -0,0 +1,352 @@
+
+//=============================================================================
+/**
+ *  @file    Dev_Poll_Reactor_Batch_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test verifies that an ACE_Dev_Poll_Reactor harvesting
+ *  several events per epoll_wait() call (see
+ *  ACE_Dev_Poll_Reactor::max_events_per_wait()) still dispatches
+ *  each ready handle exactly once, never dispatches a handle to two
+ *  threads at the same time, resumes handles after their upcall, and
+ *  discards harvested events for handlers removed before dispatch.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Reactor.h"
+#include "ace/Dev_Poll_Reactor.h"
+#include "ace/Pipe.h"
+#include "ace/ACE.h"
+#include "ace/Atomic_Op.h"
+#include "ace/Thread_Manager.h"
+#include "ace/OS_NS_sys_time.h"
+
+#if defined (ACE_HAS_EVENT_POLL)
+
+static const size_t handler_count = 32;
+static const int thread_count = 4;
+static const int batch_size = 16;
+
+class Batch_Handler : public ACE_Event_Handler
+{
+public:
+  Batch_Handler (void);
+
+  ~Batch_Handler (void);
+
+  virtual int handle_input (ACE_HANDLE fd);
+
+  virtual ACE_HANDLE get_handle (void) const;
+
+  /// Write a single byte to the pipe, making the handle readable.
+  int poke (void);
+
+  ACE_Pipe pipe_;
+
+  /// Number of handle_input() upcalls.
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> count_;
+
+  /// Number of threads currently in handle_input().
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> in_upcall_;
+
+  /// Shared count of upcalls across all handlers.
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> *total_;
+
+  /// If set, the handlers to remove on the first upcall.
+  Batch_Handler *victims_;
+
+  /// Handlers to register on the victims' handles once removed.
+  Batch_Handler *intruders_;
+
+  bool ok_;
+};
+
+Batch_Handler::Batch_Handler (void)
+  : count_ (0),
+    in_upcall_ (0),
+    total_ (0),
+    victims_ (0),
+    intruders_ (0),
+    ok_ (false)
+{
+  if (0 != this->pipe_.open ())
+    ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("pipe")));
+  else
+    this->ok_ = true;
+}
+
+Batch_Handler::~Batch_Handler (void)
+{
+  this->pipe_.close ();
+}
+
+ACE_HANDLE
+Batch_Handler::get_handle (void) const
+{
+  return this->pipe_.read_handle ();
+}
+
+int
+Batch_Handler::poke (void)
+{
+  return ACE::send_n (this->pipe_.write_handle (), "x", 1) == 1 ? 0 : -1;
+}
+
+int
+Batch_Handler::handle_input (ACE_HANDLE fd)
+{
+  if (++this->in_upcall_ != 1)
+    ACE_ERROR ((LM_ERROR,
+                ACE_TEXT ("(%t) handle %d dispatched concurrently\n"),
+                fd));
+
+  // Don't block if dispatched for a handle that isn't readable.
+  ACE_Time_Value no_wait (ACE_Time_Value::zero);
+  char c;
+  if (ACE::recv (fd, &c, 1, &no_wait) != 1)
+    ACE_ERROR ((LM_ERROR,
+                ACE_TEXT ("(%t) %p on handle %d\n"),
+                ACE_TEXT ("recv"),
+                fd));
+
+  // Drain and remove the other handlers, then reuse their handles for
+  // new handlers. The events already harvested for those handles are
+  // stale and must not reach the new handlers.
+  if (this->victims_ != 0)
+    {
+      for (size_t i = 0; i < handler_count; ++i)
+        {
+          Batch_Handler &victim = this->victims_[i];
+          if (&victim == this)
+            continue;
+
+          no_wait = ACE_Time_Value::zero;
+          ACE::recv (victim.get_handle (), &c, 1, &no_wait);
+          this->reactor ()->remove_handler (&victim,
+                                            ACE_Event_Handler::ALL_EVENTS_MASK
+                                            | ACE_Event_Handler::DONT_CALL);
+          this->reactor ()->register_handler (victim.get_handle (),
+                                              &this->intruders_[i],
+                                              ACE_Event_Handler::READ_MASK);
+        }
+      this->victims_ = 0;
+    }
+
+  ++this->count_;
+  ++*this->total_;
+  --this->in_upcall_;
+  return 0;
+}
+
+struct Worker_Args
+{
+  ACE_Reactor *reactor;
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> *total;
+  long expected;
+};
+
+static ACE_THR_FUNC_RETURN
+worker (void *p)
+{
+  Worker_Args *args = static_cast<Worker_Args *> (p);
+
+  ACE_Time_Value const deadline =
+    ACE_OS::gettimeofday () + ACE_Time_Value (10);
+
+  while (args->total->value () < args->expected
+         && ACE_OS::gettimeofday () < deadline)
+    {
+      ACE_Time_Value tv (0, 100000);
+      if (args->reactor->handle_events (tv) == -1)
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("(%t) %p\n"), ACE_TEXT ("handle_events")));
+    }
+
+  return 0;
+}
+
+// Make every handle ready, twice, and have a pool of threads dispatch
+// the events. Each handler must see exactly one upcall per round,
+// which also shows that handles are resumed after their upcall.
+static int
+test_batch_dispatch (void)
+{
+  int status = 0;
+
+  ACE_Dev_Poll_Reactor dp_reactor;
+  ACE_Reactor reactor (&dp_reactor);
+
+  if (dp_reactor.max_events_per_wait (batch_size) != 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%p\n"),
+                       ACE_TEXT ("max_events_per_wait")),
+                      1);
+
+  if (dp_reactor.max_events_per_wait () != batch_size)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("max_events_per_wait is %d; expected %d\n"),
+                       dp_reactor.max_events_per_wait (),
+                       batch_size),
+                      1);
+
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> total (0);
+  Batch_Handler handlers[handler_count];
+
+  for (size_t i = 0; i < handler_count; ++i)
+    {
+      handlers[i].total_ = &total;
+      if (!handlers[i].ok_
+          || reactor.register_handler (&handlers[i],
+                                       ACE_Event_Handler::READ_MASK) != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("register_handler")),
+                          1);
+    }
+
+  for (long round = 1; round <= 2; ++round)
+    {
+      for (size_t i = 0; i < handler_count; ++i)
+        handlers[i].poke ();
+
+      Worker_Args args;
+      args.reactor = &reactor;
+      args.total = &total;
+      args.expected = round * static_cast<long> (handler_count);
+
+      ACE_Thread_Manager::instance ()->spawn_n (thread_count, worker, &args);
+      ACE_Thread_Manager::instance ()->wait ();
+
+      if (total.value () != args.expected)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("Round %d: %d upcalls; expected %d\n"),
+                      static_cast<int> (round),
+                      static_cast<int> (total.value ()),
+                      static_cast<int> (args.expected)));
+          status = 1;
+        }
+
+      for (size_t i = 0; i < handler_count; ++i)
+        if (handlers[i].count_.value () != round)
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("Round %d: handler %B dispatched %d times\n"),
+                        static_cast<int> (round),
+                        i,
+                        static_cast<int> (handlers[i].count_.value ())));
+            status = 1;
+          }
+    }
+
+  for (size_t i = 0; i < handler_count; ++i)
+    reactor.remove_handler (&handlers[i],
+                            ACE_Event_Handler::ALL_EVENTS_MASK
+                            | ACE_Event_Handler::DONT_CALL);
+
+  return status;
+}
+
+// Harvest events for all handles in one epoll_wait(), then replace all
+// other handlers from the first upcall. Neither the removed handlers nor
+// their replacements may be dispatched from the already-harvested batch.
+static int
+test_removal_discards_events (void)
+{
+  int status = 0;
+
+  ACE_Dev_Poll_Reactor dp_reactor;
+  ACE_Reactor reactor (&dp_reactor);
+  dp_reactor.max_events_per_wait (static_cast<int> (handler_count));
+
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> total (0);
+  Batch_Handler handlers[handler_count];
+  Batch_Handler intruders[handler_count];
+
+  for (size_t i = 0; i < handler_count; ++i)
+    {
+      handlers[i].total_ = &total;
+      handlers[i].victims_ = handlers;
+      handlers[i].intruders_ = intruders;
+      intruders[i].total_ = &total;
+      if (!handlers[i].ok_
+          || reactor.register_handler (&handlers[i],
+                                       ACE_Event_Handler::READ_MASK) != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("register_handler")),
+                          1);
+    }
+
+  for (size_t i = 0; i < handler_count; ++i)
+    handlers[i].poke ();
+
+  ACE_Time_Value tv (1);
+  reactor.handle_events (tv);
+
+  // The rest of the batch is still waiting to be drained.
+  if (dp_reactor.max_events_per_wait (1) != -1 || errno != EBUSY)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("max_events_per_wait should fail with ")
+                  ACE_TEXT ("EBUSY while events are pending\n")));
+      status = 1;
+    }
+
+  for (size_t i = 0; i < handler_count; ++i)
+    {
+      tv = ACE_Time_Value::zero;
+      reactor.handle_events (tv);
+    }
+
+  if (total.value () != 1)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%d upcalls after removal; expected 1\n"),
+                  static_cast<int> (total.value ())));
+      status = 1;
+    }
+
+  if (dp_reactor.max_events_per_wait (1) != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%p\n"),
+                  ACE_TEXT ("max_events_per_wait after draining")));
+      status = 1;
+    }
+
+  for (size_t i = 0; i < handler_count; ++i)
+    reactor.remove_handler (handlers[i].get_handle (),
+                            ACE_Event_Handler::ALL_EVENTS_MASK
+                            | ACE_Event_Handler::DONT_CALL);
+
+  return status;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Dev_Poll_Reactor_Batch_Test"));
+
+  int result = test_batch_dispatch ();
+  result += test_removal_discards_events ();
+
+  ACE_END_TEST;
+  return result;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Dev_Poll_Reactor_Batch_Test"));
+  ACE_ERROR ((LM_INFO,
+              ACE_TEXT ("Event Poll is not supported ")
+              ACE_TEXT ("on this platform\n")));
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif  /* ACE_HAS_EVENT_POLL */
@@ -0,0 +1,301 @@
+
+//=============================================================================
+/**
+ *  @file    Filecache_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that ACE_Filecache keeps the files it caches
+ *  within its byte budget, evicting first the files that were not
+ *  fetched again, that it does not cache a file larger than the
+ *  budget, that a file evicted while in use stays readable, that a
+ *  file changed on disk or written through an ACE_Filecache_Handle is
+ *  fetched anew, and that ACE_Filecache_Handle::sendfile() sends the
+ *  file.  With inotify it also checks that a link to a file changed
+ *  on disk is fetched anew after another link to it was evicted.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Filecache.h"
+#include "ace/Pipe.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_unistd.h"
+#include "ace/OS_NS_fcntl.h"
+#include "ace/OS_NS_stdio.h"
+
+#if !defined (ACE_LACKS_MMAP)
+
+static const size_t FILE_SIZE = 1000;
+static const int FILES = 5;
+
+static ACE_TCHAR names[FILES][MAXPATHLEN];
+
+// Write @a len bytes of @a c to file @a i.
+static int
+write_file (int i, char c, size_t len)
+{
+  ACE_HANDLE const h = ACE_OS::open (names[i],
+                                     O_RDWR | O_CREAT | O_TRUNC,
+                                     ACE_DEFAULT_FILE_PERMS);
+  if (h == ACE_INVALID_HANDLE)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), names[i]), -1);
+
+  char buf[FILE_SIZE];
+  ACE_OS::memset (buf, c, sizeof buf);
+  for (size_t left = len; left > 0; )
+    {
+      size_t const n = left < sizeof buf ? left : sizeof buf;
+      if (ACE_OS::write (h, buf, n) != static_cast<ssize_t> (n))
+        {
+          ACE_OS::close (h);
+          ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), names[i]), -1);
+        }
+      left -= n;
+    }
+
+  ACE_OS::close (h);
+  return 0;
+}
+
+// Fetch file @a i and check it has @a len bytes of @a c.
+static int
+check_file (int i, char c, size_t len)
+{
+  ACE_Filecache_Handle handle (names[i]);
+
+  if (handle.error () != ACE_Filecache_Handle::ACE_SUCCESS
+      || handle.size () != static_cast<ACE_OFF_T> (len))
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s: error %d, %d bytes\n"),
+                       names[i],
+                       handle.error (),
+                       static_cast<int> (handle.size ())),
+                      1);
+
+  const char *data = static_cast<const char *> (handle.address ());
+  for (size_t j = 0; j < len; ++j)
+    if (data[j] != c)
+      ACE_ERROR_RETURN ((LM_ERROR,
+                         ACE_TEXT ("%s: byte %B is not %c\n"),
+                         names[i],
+                         j,
+                         c),
+                        1);
+
+  return 0;
+}
+
+static int
+check_cached (int i, bool cached)
+{
+  if ((ACE_Filecache::instance ()->find (names[i]) == 0) != cached)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s is%s cached\n"),
+                       names[i],
+                       cached ? ACE_TEXT (" not") : ACE_TEXT ("")),
+                      1);
+  return 0;
+}
+
+static int
+test_eviction (void)
+{
+  int errors = 0;
+  ACE_Filecache &cache = *ACE_Filecache::instance ();
+
+  // Room for three files.
+  cache.max_size (static_cast<ACE_OFF_T> (3 * FILE_SIZE));
+
+  for (int i = 0; i < 3; ++i)
+    errors += check_file (i, static_cast<char> ('a' + i), FILE_SIZE);
+  for (int i = 0; i < 3; ++i)
+    errors += check_cached (i, true);
+
+  // The first file is fetched again, so the second one makes room for
+  // the fourth.
+  errors += check_file (0, 'a', FILE_SIZE);
+  errors += check_file (3, 'd', FILE_SIZE);
+  errors += check_cached (0, true);
+  errors += check_cached (1, false);
+  errors += check_cached (2, true);
+  errors += check_cached (3, true);
+
+  if (cache.cached_size () != static_cast<ACE_OFF_T> (3 * FILE_SIZE)
+      || cache.current_size () != 3)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B files of %d bytes cached\n"),
+                  cache.current_size (),
+                  static_cast<int> (cache.cached_size ())));
+      ++errors;
+    }
+
+  // Larger than the budget: handed out, not cached.
+  if (write_file (4, 'e', 4 * FILE_SIZE) != 0)
+    return errors + 1;
+  errors += check_file (4, 'e', 4 * FILE_SIZE);
+  errors += check_cached (4, false);
+
+  // A file in use when it is evicted stays readable.
+  {
+    ACE_Filecache_Handle held (names[2]);
+    cache.purge ();
+    errors += check_cached (2, false);
+    const char *data = static_cast<const char *> (held.address ());
+    if (data == 0 || data[FILE_SIZE - 1] != 'c')
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("evicted file not readable\n")));
+        ++errors;
+      }
+  }
+
+  if (cache.cached_size () != 0 || cache.current_size () != 0)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("cache not empty after purge\n")));
+      ++errors;
+    }
+
+  return errors;
+}
+
+static int
+test_invalidation (void)
+{
+  int errors = 0;
+
+  errors += check_file (0, 'a', FILE_SIZE);
+
+#if !defined (ACE_HAS_INOTIFY)
+  // The modification time has a granularity of a second.
+  ACE_OS::sleep (2);
+#endif /* !ACE_HAS_INOTIFY */
+
+  if (write_file (0, 'A', FILE_SIZE / 2) != 0)
+    return errors + 1;
+  errors += check_file (0, 'A', FILE_SIZE / 2);
+
+  // Written through the cache.
+  {
+    ACE_Filecache_Handle handle (names[1], static_cast<int> (FILE_SIZE));
+    if (handle.error () != ACE_Filecache_Handle::ACE_SUCCESS)
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("cannot write %s\n"), names[1]));
+        return errors + 1;
+      }
+    ACE_OS::memset (handle.address (), 'B', FILE_SIZE);
+  }
+  errors += check_file (1, 'B', FILE_SIZE);
+
+  return errors;
+}
+
+static int
+test_sendfile (void)
+{
+  ACE_Pipe pipe;
+  if (pipe.open () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("pipe")), 1);
+
+  ACE_Filecache_Handle handle (names[3], ACE_NOMAP);
+  off_t offset = 0;
+  ssize_t const sent =
+    handle.sendfile (pipe.write_handle (), &offset, FILE_SIZE);
+
+  char buf[FILE_SIZE];
+  ssize_t got = 0;
+  while (got < sent)
+    {
+      ssize_t const n = ACE_OS::read (pipe.read_handle (),
+                                      buf + got,
+                                      sizeof buf - got);
+      if (n <= 0)
+        break;
+      got += n;
+    }
+
+  if (sent != static_cast<ssize_t> (FILE_SIZE)
+      || offset != static_cast<off_t> (FILE_SIZE)
+      || got != sent
+      || buf[0] != 'd'
+      || buf[FILE_SIZE - 1] != 'd')
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("sendfile sent %d, read %d bytes\n"),
+                       static_cast<int> (sent),
+                       static_cast<int> (got)),
+                      1);
+
+  return 0;
+}
+
+#if defined (ACE_HAS_INOTIFY)
+// Links to a file share its watch, which evicting one of them to
+// make room for another must not remove.
+static int
+test_links (void)
+{
+  int errors = 0;
+  ACE_Filecache &cache = *ACE_Filecache::instance ();
+
+  ACE_OS::unlink (names[4]);
+  if (::link (ACE_TEXT_ALWAYS_CHAR (names[1]),
+              ACE_TEXT_ALWAYS_CHAR (names[4])) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), names[4]), 1);
+
+  // Room for one file.
+  cache.purge ();
+  cache.max_size (static_cast<ACE_OFF_T> (FILE_SIZE));
+
+  errors += check_file (1, 'B', FILE_SIZE);
+  errors += check_file (4, 'B', FILE_SIZE);
+  errors += check_cached (1, false);
+  errors += check_cached (4, true);
+
+  if (write_file (1, 'F', FILE_SIZE / 2) != 0)
+    return errors + 1;
+  errors += check_file (4, 'F', FILE_SIZE / 2);
+
+  return errors;
+}
+#endif /* ACE_HAS_INOTIFY */
+
+#endif /* !ACE_LACKS_MMAP */
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Filecache_Test"));
+
+  int errors = 0;
+
+#if !defined (ACE_LACKS_MMAP)
+  for (int i = 0; i < FILES; ++i)
+    {
+      ACE_OS::snprintf (names[i],
+                        MAXPATHLEN,
+                        ACE_TEXT ("Filecache_Test_%d.tmp"),
+                        i);
+      if (write_file (i, static_cast<char> ('a' + i), FILE_SIZE) != 0)
+        ++errors;
+    }
+
+  if (errors == 0)
+    {
+      errors += test_eviction ();
+      errors += test_invalidation ();
+      errors += test_sendfile ();
+#if defined (ACE_HAS_INOTIFY)
+      errors += test_links ();
+#endif /* ACE_HAS_INOTIFY */
+    }
+
+  ACE_Filecache::instance ()->purge ();
+  for (int i = 0; i < FILES; ++i)
+    ACE_OS::unlink (names[i]);
+#else
+  ACE_DEBUG ((LM_INFO, ACE_TEXT ("mmap is not supported on this platform\n")));
+#endif /* !ACE_LACKS_MMAP */
+
+  ACE_END_TEST;
+  return errors;
+}
@@ -0,0 +1,304 @@
+
+//=============================================================================
+/**
+ *  @file    Flat_Hash_Map_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that ACE_Flat_Hash_Map finds all its entries
+ *  while its table grows, that its bind, trybind, rebind, find and
+ *  unbind methods return what those of ACE_Hash_Map_Manager_Ex
+ *  return, and that its iterators visit every entry once.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Flat_Hash_Map_T.h"
+#include "ace/Hash_Map_Manager_T.h"
+#include "ace/Null_Mutex.h"
+#include "ace/SString.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_stdio.h"
+
+typedef ACE_Flat_Hash_Map<int,
+                          int,
+                          ACE_Hash<int>,
+                          ACE_Equal_To<int>,
+                          ACE_Null_Mutex> INT_MAP;
+
+typedef ACE_Hash_Map_Manager_Ex<int,
+                                int,
+                                ACE_Hash<int>,
+                                ACE_Equal_To<int>,
+                                ACE_Null_Mutex> ORACLE_MAP;
+
+typedef ACE_Flat_Hash_Map<ACE_CString,
+                          ACE_CString,
+                          ACE_Hash<ACE_CString>,
+                          ACE_Equal_To<ACE_CString>,
+                          ACE_Null_Mutex> STRING_MAP;
+
+static const int ENTRIES = 20000;
+static const int OPERATIONS = 200000;
+
+// Bind keys one by one, checking that all of them are found whenever
+// the table starts growing and once it is done.
+static int
+test_growth (void)
+{
+  int errors = 0;
+  int rehashes = 0;
+  INT_MAP map;
+
+  for (int i = 0; i < ENTRIES; ++i)
+    {
+      bool const was_rehashing = map.rehashing ();
+
+      if (map.bind (i, i * 3) != 0)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("bind %d failed\n"), i));
+          return 1;
+        }
+
+      if (map.rehashing () != was_rehashing || i == ENTRIES - 1)
+        {
+          rehashes += map.rehashing () ? 1 : 0;
+
+          for (int j = 0; j <= i; ++j)
+            {
+              int value = 0;
+              if (map.find (j, value) != 0 || value != j * 3)
+                {
+                  ACE_ERROR ((LM_ERROR,
+                              ACE_TEXT ("key %d not found after %d binds, ")
+                              ACE_TEXT ("capacity %B\n"),
+                              j, i + 1, map.total_size ()));
+                  return 1;
+                }
+            }
+        }
+    }
+
+  if (map.current_size () != static_cast<size_t> (ENTRIES))
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B entries, expected %d\n"),
+                  map.current_size (), ENTRIES));
+      ++errors;
+    }
+
+  if (map.find (ENTRIES) != -1 || map.find (-1) != -1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("found a key never bound\n")));
+      ++errors;
+    }
+
+  // Every entry is visited once.
+  size_t visited = 0;
+  long sum = 0;
+  for (INT_MAP::iterator iter = map.begin (); iter != map.end (); ++iter)
+    {
+      ++visited;
+      sum += (*iter).key ();
+    }
+
+  long const expected_sum = static_cast<long> (ENTRIES) * (ENTRIES - 1) / 2;
+  if (visited != map.current_size () || sum != expected_sum)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("iterated over %B entries, key sum %d\n"),
+                  visited, static_cast<int> (sum)));
+      ++errors;
+    }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%d entries in %B slots after %d rehashes\n"),
+              ENTRIES, map.total_size (), rehashes));
+
+  // Unbind the odd keys while iterating.
+  for (INT_MAP::iterator iter = map.begin (); !iter.done (); )
+    {
+      if (iter->key () % 2 != 0)
+        map.unbind (iter++);
+      else
+        ++iter;
+    }
+
+  visited = 0;
+  INT_MAP::ENTRY *entry = 0;
+  for (INT_MAP::CONST_ITERATOR iter (map); iter.next (entry); iter.advance ())
+    {
+      ++visited;
+      if (entry->key () % 2 != 0)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("key %d left after unbind\n"),
+                      entry->key ()));
+          ++errors;
+          break;
+        }
+    }
+
+  if (visited != static_cast<size_t> (ENTRIES / 2)
+      || map.current_size () != visited)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B entries left, expected %d\n"),
+                  visited, ENTRIES / 2));
+      ++errors;
+    }
+
+  map.unbind_all ();
+  if (map.current_size () != 0 || map.begin () != map.end ())
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("entries left after unbind_all\n")));
+      ++errors;
+    }
+
+  return errors;
+}
+
+// Apply the same random operations to an ACE_Flat_Hash_Map and an
+// ACE_Hash_Map_Manager_Ex and compare their results.
+static int
+test_oracle (void)
+{
+  int errors = 0;
+  INT_MAP map (64);
+  ORACLE_MAP oracle;
+
+  ACE_OS::srand (4711);
+
+  for (int i = 0; i < OPERATIONS && errors < 10; ++i)
+    {
+      int const key = ACE_OS::rand () % (ENTRIES / 4);
+      int const value = ACE_OS::rand ();
+      int const op = ACE_OS::rand () % 6;
+      int result = 0;
+      int expected = 0;
+      int result_value = -1;
+      int expected_value = -1;
+
+      switch (op)
+        {
+        case 0:
+          result = map.bind (key, value);
+          expected = oracle.bind (key, value);
+          break;
+        case 1:
+          result_value = expected_value = value;
+          result = map.trybind (key, result_value);
+          expected = oracle.trybind (key, expected_value);
+          break;
+        case 2:
+          result = map.rebind (key, value, result_value);
+          expected = oracle.rebind (key, value, expected_value);
+          break;
+        case 3:
+          result = map.find (key, result_value);
+          expected = oracle.find (key, expected_value);
+          break;
+        default:
+          result = map.unbind (key, result_value);
+          expected = oracle.unbind (key, expected_value);
+          break;
+        }
+
+      if (result != expected
+          || (expected >= 0 && result_value != expected_value)
+          || map.current_size () != oracle.current_size ())
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("operation %d on key %d returned %d (%d), ")
+                      ACE_TEXT ("expected %d (%d)\n"),
+                      op, key, result, result_value,
+                      expected, expected_value));
+          ++errors;
+        }
+    }
+
+  for (ORACLE_MAP::iterator iter = oracle.begin ();
+       iter != oracle.end ();
+       ++iter)
+    {
+      int value = 0;
+      if (map.find ((*iter).ext_id_, value) != 0
+          || value != (*iter).int_id_)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("key %d missing at the end\n"),
+                      (*iter).ext_id_));
+          ++errors;
+          break;
+        }
+    }
+
+  return errors;
+}
+
+// Entries with strings are constructed, copied when the table grows
+// and destroyed properly.
+static int
+test_strings (void)
+{
+  int errors = 0;
+  STRING_MAP map;
+
+  for (int i = 0; i < 1000; ++i)
+    {
+      char key[32];
+      ACE_OS::sprintf (key, "key-%d", i);
+      map.bind (key, ACE_CString ("value of ") + key);
+    }
+
+  ACE_CString old_key;
+  ACE_CString old_value;
+  if (map.rebind ("key-7", "seven", old_key, old_value) != 1
+      || old_value != "value of key-7")
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("rebind of key-7 failed\n")));
+      ++errors;
+    }
+
+  STRING_MAP::ENTRY *entry = 0;
+  if (map.find ("key-7", entry) != 0 || entry->item () != "seven")
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("key-7 not rebound\n")));
+      ++errors;
+    }
+  else if (map.unbind (entry) != 0 || map.find ("key-7") != -1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("key-7 not unbound\n")));
+      ++errors;
+    }
+
+  ACE_CString value;
+  if (map.find ("key-999", value) != 0 || value != "value of key-999")
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("key-999 not found\n")));
+      ++errors;
+    }
+
+  map.close ();
+  if (map.total_size () != 0 || map.bind ("again", "bound") != 0
+      || map.current_size () != 1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("map not usable after close\n")));
+      ++errors;
+    }
+
+  return errors;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Flat_Hash_Map_Test"));
+
+  int errors = test_growth ();
+  errors += test_oracle ();
+  errors += test_strings ();
+
+  ACE_END_TEST;
+  return errors;
+}
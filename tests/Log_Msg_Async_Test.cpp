@@ -0,0 +1,311 @@
+//=============================================================================
+/**
+ *  @file    Log_Msg_Async_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks ACE_Log_Msg_Async.  Several threads log numbered
+ *  messages through ACE_Log_Msg with the CUSTOM and ASYNC flags, and
+ *  a target backend checks that each thread's messages arrive, in
+ *  order, once the asynchronous backend has been closed.  With the
+ *  DROP policy and small rings, the messages that don't arrive must
+ *  have been counted as dropped.  The messages are then formatted to
+ *  a file by the asynchronous backend itself, and the time it takes
+ *  to log is compared with that of the synchronous path.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Log_Msg.h"
+#include "ace/Log_Msg_Async.h"
+#include "ace/Log_Record.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Atomic_Op.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/OS_NS_stdio.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_unistd.h"
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+static const int producers = 4;
+static const int messages_per_producer = 20000;
+
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, int> next_producer (0);
+
+/**
+ * @class Collector
+ *
+ * Checks the messages "<producer>:<sequence>" logged by the producers.
+ */
+class Collector : public ACE_Log_Msg_Backend
+{
+public:
+  Collector (bool slow = false)
+    : slow_ (slow), received_ (0), errors_ (0)
+  {
+    for (int i = 0; i < producers; ++i)
+      this->last_[i] = -1;
+  }
+
+  virtual int open (const ACE_TCHAR *) { return 0; }
+  virtual int reset (void) { return 0; }
+  virtual int close (void) { return 0; }
+
+  virtual ssize_t log (ACE_Log_Record &log_record)
+  {
+    ACE_TCHAR *end = 0;
+    const ACE_TCHAR *const text = log_record.msg_data ();
+    long const producer = ACE_OS::strtol (text, &end, 10);
+    if (*end != ACE_TEXT (':') || producer < 0 || producer >= producers)
+      {
+        ++this->errors_;
+        return -1;
+      }
+    long const sequence = ACE_OS::strtol (end + 1, 0, 10);
+
+    // Some messages may have been dropped, but the others come in
+    // order.
+    if (sequence <= this->last_[producer]
+        || (!this->slow_ && sequence != this->last_[producer] + 1))
+      ++this->errors_;
+    this->last_[producer] = sequence;
+    ++this->received_;
+
+    if (this->slow_ && this->received_ % 64 == 0)
+      ACE_OS::sleep (ACE_Time_Value (0, 1000));
+    return 0;
+  }
+
+  bool slow_;
+  size_t received_;
+  size_t errors_;
+  long last_[producers];
+};
+
+static ACE_THR_FUNC_RETURN
+producer (void *)
+{
+  int const index = next_producer++;
+  for (int i = 0; i < messages_per_producer; ++i)
+    ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("%d:%d\n"), index, i));
+  return 0;
+}
+
+// Run the producers with the given logging flags, and return the time
+// it took them, in usecs per message.
+static double
+run_producers (u_long flags)
+{
+  // Only log to the custom backend meanwhile.
+  u_long const saved_flags = ACE_LOG_MSG->flags ();
+  ACE_LOG_MSG->clr_flags (ACE_Log_Msg::STDERR | ACE_Log_Msg::OSTREAM);
+  ACE_LOG_MSG->set_flags (flags);
+  next_producer = 0;
+
+  ACE_High_Res_Timer timer;
+  timer.start ();
+  if (ACE_Thread_Manager::instance ()->spawn_n (producers, producer) == -1)
+    {
+      ACE_LOG_MSG->clr_flags (flags);
+      ACE_LOG_MSG->set_flags (saved_flags);
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn_n")),
+                        -1.0);
+    }
+  ACE_Thread_Manager::instance ()->wait ();
+  timer.stop ();
+
+  ACE_LOG_MSG->clr_flags (flags);
+  ACE_LOG_MSG->set_flags (saved_flags);
+
+  ACE_hrtime_t usecs = 0;
+  timer.elapsed_microseconds (usecs);
+  return static_cast<double> (usecs) / (producers * messages_per_producer);
+}
+
+static int
+check (const ACE_TCHAR *name,
+       const Collector &collector,
+       size_t dropped)
+{
+  size_t const sent = producers * messages_per_producer;
+  if (collector.errors_ != 0 || collector.received_ + dropped != sent)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s: %B messages received, %B dropped ")
+                       ACE_TEXT ("and %B out of order, expected %B\n"),
+                       name,
+                       collector.received_,
+                       dropped,
+                       collector.errors_,
+                       sent),
+                      -1);
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%s: %B messages received, %B dropped\n"),
+              name,
+              collector.received_,
+              dropped));
+  return 0;
+}
+
+static int
+async_test (const ACE_TCHAR *name,
+            Collector &collector,
+            size_t ring_size,
+            ACE_Log_Msg_Async::Overflow_Policy policy,
+            double &usecs)
+{
+  ACE_Log_Msg_Async async (&collector, ring_size, policy);
+  ACE_Log_Msg_Backend *const old_backend = ACE_Log_Msg::msg_backend (&async);
+  if (async.open (0) == -1)
+    {
+      ACE_Log_Msg::msg_backend (old_backend);
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("open")), -1);
+    }
+
+  usecs = run_producers (ACE_Log_Msg::CUSTOM | ACE_Log_Msg::ASYNC);
+  async.close ();
+  ACE_Log_Msg::msg_backend (old_backend);
+
+  return check (name, collector, async.dropped ());
+}
+
+/**
+ * @class File_Backend
+ *
+ * Writes each record to a FILE as ACE_Log_Msg does for STDERR.
+ */
+class File_Backend : public ACE_Log_Msg_Backend
+{
+public:
+  File_Backend (FILE *fp) : fp_ (fp) {}
+
+  virtual int open (const ACE_TCHAR *) { return 0; }
+  virtual int reset (void) { return 0; }
+  virtual int close (void) { return 0; }
+
+  virtual ssize_t log (ACE_Log_Record &log_record)
+  {
+    return log_record.print (ACE_LOG_MSG->local_host (),
+                             ACE_LOG_MSG->flags (),
+                             this->fp_);
+  }
+
+  FILE *fp_;
+};
+
+// Log to a file synchronously, or asynchronously, check that all the
+// messages were written and return the time it took, in usecs per
+// message, or -1.
+static double
+file_test (bool async)
+{
+  ACE_TCHAR path[MAXPATHLEN];
+  ACE_OS::sprintf (path,
+                   ACE_TEXT ("%sLog_Msg_Async_Test%s"),
+                   ACE_LOG_DIRECTORY,
+                   ACE_TEXT (".out"));
+  FILE *const fp = ACE_OS::fopen (path, ACE_TEXT ("w+"));
+  if (fp == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), path), -1.0);
+
+  double usecs = -1.0;
+  File_Backend file_backend (fp);
+  ACE_Log_Msg_Async async_backend (0,
+                                   ACE_DEFAULT_LOG_MSG_ASYNC_RING_SIZE,
+                                   ACE_Log_Msg_Async::BLOCK,
+                                   fp);
+  if (async)
+    {
+      ACE_Log_Msg_Backend *const old_backend =
+        ACE_Log_Msg::msg_backend (&async_backend);
+      if (async_backend.open (0) == 0)
+        {
+          usecs = run_producers (ACE_Log_Msg::CUSTOM | ACE_Log_Msg::ASYNC);
+          async_backend.close ();
+        }
+      ACE_Log_Msg::msg_backend (old_backend);
+    }
+  else
+    {
+      ACE_Log_Msg_Backend *const old_backend =
+        ACE_Log_Msg::msg_backend (&file_backend);
+      usecs = run_producers (ACE_Log_Msg::CUSTOM);
+      ACE_Log_Msg::msg_backend (old_backend);
+    }
+
+  // Count the lines written.
+  ACE_OS::rewind (fp);
+  size_t lines = 0;
+  char line[ACE_Log_Record::MAXVERBOSELOGMSGLEN];
+  while (ACE_OS::fgets (line, sizeof line, fp) != 0)
+    ++lines;
+  ACE_OS::fclose (fp);
+  ACE_OS::unlink (path);
+
+  size_t const sent = producers * messages_per_producer;
+  if (usecs < 0 || lines != sent)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%B lines written, expected %B\n"),
+                       lines,
+                       sent),
+                      -1.0);
+  return usecs;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Log_Msg_Async_Test"));
+
+  int status = 0;
+  double usecs = 0;
+
+  // Small rings: the producers have to wait for room.
+  Collector blocking;
+  if (async_test (ACE_TEXT ("BLOCK"),
+                  blocking,
+                  4 * 1024,
+                  ACE_Log_Msg_Async::BLOCK,
+                  usecs) != 0)
+    status = 1;
+
+  // Small rings and a slow target: messages have to be dropped.
+  Collector dropping (true);
+  if (async_test (ACE_TEXT ("DROP"),
+                  dropping,
+                  4 * 1024,
+                  ACE_Log_Msg_Async::DROP,
+                  usecs) != 0)
+    status = 1;
+
+  // Write to a file, through ACE_Log_Msg_Async or under the lock of
+  // ACE_Log_Msg.
+  double const async_usecs = file_test (true);
+  double const sync_usecs = file_test (false);
+  if (async_usecs < 0 || sync_usecs < 0)
+    status = 1;
+  else
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("usecs per message written to a file ")
+                ACE_TEXT ("synchronously: %.3f, asynchronously: %.3f\n"),
+                sync_usecs,
+                async_usecs));
+
+  ACE_END_TEST;
+  return status;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Log_Msg_Async_Test"));
+  ACE_ERROR ((LM_INFO,
+              ACE_TEXT ("threads or C++11 not supported on this platform\n")));
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */
@@ -0,0 +1,362 @@
+//=============================================================================
+/**
+ *  @file    Log_Msg_Binary_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks the binary log of ACE_Log_Msg.  A series of
+ *  messages using most of the directives is logged with the BINARY
+ *  flag, then with the usual formatting to a backend that keeps them,
+ *  and ACE_Log_Binary_Reader must give back the same texts, and
+ *  categories, from the binary log.  The time it takes to log to the binary log is then
+ *  compared with that of formatting the messages to a file.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Log_Msg.h"
+#include "ace/Log_Msg_Backend.h"
+#include "ace/Log_Category.h"
+#include "ace/Log_Binary.h"
+#include "ace/Log_Record.h"
+#include "ace/High_Res_Timer.h"
+#include "ace/SString.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_signal.h"
+#include "ace/OS_NS_stdio.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_unistd.h"
+
+static const size_t max_messages = 64;
+
+static const int timed_messages = 100000;
+
+/**
+ * @class Collector
+ *
+ * Keeps the messages formatted by ACE_Log_Msg.
+ */
+class Collector : public ACE_Log_Msg_Backend
+{
+public:
+  Collector (void) : count_ (0) {}
+
+  virtual int open (const ACE_TCHAR *) { return 0; }
+  virtual int reset (void) { return 0; }
+  virtual int close (void) { return 0; }
+
+  virtual ssize_t log (ACE_Log_Record &log_record)
+  {
+    if (this->count_ < max_messages)
+      {
+        this->types_[this->count_] = log_record.type ();
+        this->texts_[this->count_] = log_record.msg_data ();
+        this->categories_[this->count_] =
+          log_record.category () != 0
+            ? ACE_TEXT_CHAR_TO_TCHAR (log_record.category ()->name ())
+            : ACE_TEXT ("");
+      }
+    ++this->count_;
+    return 0;
+  }
+
+  size_t count_;
+  ACE_UINT32 types_[max_messages];
+  ACE_TString texts_[max_messages];
+  ACE_TString categories_[max_messages];
+};
+
+static ACE_Log_Category test_category ("Log_Msg_Binary_Test");
+
+// Log the same messages whatever the destination.
+static void
+log_messages (void)
+{
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("integers: %d %5i %-4u| %x %X %o %c %%\n"),
+              -42, 7, 3u, 255, 255, 8, 'z'));
+  ACE_DEBUG ((LM_INFO,
+              ACE_TEXT ("width: %*d|%-*s|%.*f\n"),
+              6, 12, 8, ACE_TEXT ("left"), 2, 3.14159));
+  ACE_DEBUG ((LM_NOTICE,
+              ACE_TEXT ("floats: %f %e %E %g %G %A %8.3F\n"),
+              1.5, 12345.678, 0.00012, 100.0, 1e-10, 2.25, -7.0));
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("64 bits: %Q %q; sizes: %B %b; time: %:\n"),
+              ACE_UINT64_MAX,
+              static_cast<ACE_INT64> (-1234567890123LL),
+              static_cast<size_t> (4096),
+              static_cast<ssize_t> (-1),
+              static_cast<time_t> (1234567890)));
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("strings: %s|%10s|%-10.3s|%C|%s\n"),
+              ACE_TEXT ("one"),
+              ACE_TEXT ("two"),
+              ACE_TEXT ("three"),
+              "narrow",
+              static_cast<ACE_TCHAR *> (0)));
+  ACE_DEBUG ((LM_WARNING,
+              ACE_TEXT ("context: %M %.1M pid %P thread %t at %N:%l in %n\n")));
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("pointer %@, signal %S, status %R\n"),
+              reinterpret_cast<void *> (0x1234),
+              SIGINT,
+              -1));
+
+  errno = ENOENT;
+  ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p; again: %m\n"), ACE_TEXT ("open")));
+
+  ACE_Time_Value const tv (1000000000, 123456);
+  ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("time values: %#D,%#T\n"), &tv, &tv));
+
+  // These can't be deferred.
+  ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("%Iindented %d\n"), 1));
+  ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("%{%Inested%}\n")));
+
+  // Two formats at the same address.
+  ACE_TCHAR format[64];
+  ACE_OS::strcpy (format, ACE_TEXT ("first format %d\n"));
+  ACE_DEBUG ((LM_DEBUG, format, 1));
+  ACE_OS::strcpy (format, ACE_TEXT ("second format %s\n"));
+  ACE_DEBUG ((LM_DEBUG, format, ACE_TEXT ("two")));
+  ACE_DEBUG ((LM_DEBUG, format, ACE_TEXT ("again")));
+
+  // In a category, deferred or not.
+  test_category.per_thr_obj ()->log (LM_DEBUG,
+                                     ACE_TEXT ("in a category: %d\n"),
+                                     1);
+  test_category.per_thr_obj ()->log (LM_DEBUG,
+                                     ACE_TEXT ("%Iin a category: %d\n"),
+                                     2);
+
+  ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("no newline")));
+}
+
+static void
+binary_path (ACE_TCHAR path[])
+{
+  ACE_OS::sprintf (path,
+                   ACE_TEXT ("%sLog_Msg_Binary_Test%s"),
+                   ACE_LOG_DIRECTORY,
+                   ACE_TEXT (".bin"));
+}
+
+// Only log to the given destination meanwhile.
+static u_long
+log_only_to (u_long flags)
+{
+  u_long const saved_flags = ACE_LOG_MSG->flags ();
+  ACE_LOG_MSG->clr_flags (ACE_Log_Msg::STDERR
+                          | ACE_Log_Msg::OSTREAM
+                          | ACE_Log_Msg::VERBOSE
+                          | ACE_Log_Msg::VERBOSE_LITE);
+  ACE_LOG_MSG->set_flags (flags);
+  return saved_flags;
+}
+
+static void
+restore_flags (u_long flags, u_long saved_flags)
+{
+  ACE_LOG_MSG->clr_flags (flags);
+  ACE_LOG_MSG->set_flags (saved_flags);
+}
+
+static int
+round_trip_test (void)
+{
+  ACE_TCHAR path[MAXPATHLEN];
+  binary_path (path);
+
+  // Log the messages to the binary log...
+  ACE_Log_Binary_Writer writer;
+  if (writer.open (path) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), path), -1);
+  ACE_Log_Binary_Writer *const old_writer = ACE_Log_Msg::binary_writer (&writer);
+  u_long saved_flags = log_only_to (ACE_Log_Msg::BINARY);
+  log_messages ();
+  restore_flags (ACE_Log_Msg::BINARY, saved_flags);
+  ACE_Log_Msg::binary_writer (old_writer);
+  writer.close ();
+
+  // ... and as usual.
+  Collector collector;
+  ACE_Log_Msg_Backend *const old_backend = ACE_Log_Msg::msg_backend (&collector);
+  saved_flags = log_only_to (ACE_Log_Msg::CUSTOM);
+  log_messages ();
+  restore_flags (ACE_Log_Msg::CUSTOM, saved_flags);
+  ACE_Log_Msg::msg_backend (old_backend);
+
+  ACE_Log_Binary_Reader reader;
+  if (reader.open (path) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), path), -1);
+
+  int status = 0;
+  size_t count = 0;
+  ACE_Log_Record record;
+  int result = 0;
+  while ((result = reader.read (record)) == 1)
+    {
+      if (count >= collector.count_)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("Unexpected message: %s"),
+                      record.msg_data ()));
+          status = -1;
+        }
+      else if (record.type () != collector.types_[count]
+               || collector.texts_[count] != record.msg_data ()
+               || collector.categories_[count] != reader.category ())
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("Message %B is\n%s [%s]\ninstead of\n%s [%s]\n"),
+                      count,
+                      record.msg_data (),
+                      reader.category (),
+                      collector.texts_[count].c_str (),
+                      collector.categories_[count].c_str ()));
+          status = -1;
+        }
+      ++count;
+    }
+  if (result == -1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("read")));
+      status = -1;
+    }
+  if (count != collector.count_)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B messages read back, expected %B\n"),
+                  count,
+                  collector.count_));
+      status = -1;
+    }
+  if (ACE_OS::strcmp (reader.program_name (), ACE_Log_Msg::program_name ()) != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("Program name is %s instead of %s\n"),
+                  reader.program_name (),
+                  ACE_Log_Msg::program_name ()));
+      status = -1;
+    }
+  reader.close ();
+
+  if (status == 0)
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("%B messages read back from the binary log\n"),
+                count));
+  ACE_OS::unlink (path);
+  return status;
+}
+
+/**
+ * @class File_Backend
+ *
+ * Writes each record to a FILE as ACE_Log_Msg does for STDERR.
+ */
+class File_Backend : public ACE_Log_Msg_Backend
+{
+public:
+  File_Backend (FILE *fp) : fp_ (fp) {}
+
+  virtual int open (const ACE_TCHAR *) { return 0; }
+  virtual int reset (void) { return 0; }
+  virtual int close (void) { return 0; }
+
+  virtual ssize_t log (ACE_Log_Record &log_record)
+  {
+    return log_record.print (ACE_LOG_MSG->local_host (), 0, this->fp_);
+  }
+
+  FILE *fp_;
+};
+
+static void
+log_timed_messages (void)
+{
+  for (int i = 0; i < timed_messages; ++i)
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("request %d from %s took %.3f ms, %B bytes\n"),
+                i,
+                ACE_TEXT ("client.example.com"),
+                i * 0.001,
+                static_cast<size_t> (i * 8)));
+}
+
+// Return the time it takes to log a message, in usecs, to the binary
+// log or to a file, or -1.
+static double
+time_logging (bool binary, ACE_UINT64 &size)
+{
+  ACE_TCHAR path[MAXPATHLEN];
+  binary_path (path);
+
+  ACE_High_Res_Timer timer;
+  if (binary)
+    {
+      ACE_Log_Binary_Writer writer;
+      if (writer.open (path) == -1)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), path), -1.0);
+      ACE_Log_Binary_Writer *const old_writer =
+        ACE_Log_Msg::binary_writer (&writer);
+      u_long const saved_flags = log_only_to (ACE_Log_Msg::BINARY);
+      timer.start ();
+      log_timed_messages ();
+      writer.flush ();
+      timer.stop ();
+      restore_flags (ACE_Log_Msg::BINARY, saved_flags);
+      ACE_Log_Msg::binary_writer (old_writer);
+      size = writer.size ();
+    }
+  else
+    {
+      FILE *const fp = ACE_OS::fopen (path, ACE_TEXT ("w"));
+      if (fp == 0)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), path), -1.0);
+      File_Backend file_backend (fp);
+      ACE_Log_Msg_Backend *const old_backend =
+        ACE_Log_Msg::msg_backend (&file_backend);
+      u_long const saved_flags = log_only_to (ACE_Log_Msg::CUSTOM);
+      timer.start ();
+      log_timed_messages ();
+      ACE_OS::fflush (fp);
+      timer.stop ();
+      restore_flags (ACE_Log_Msg::CUSTOM, saved_flags);
+      ACE_Log_Msg::msg_backend (old_backend);
+      size = static_cast<ACE_UINT64> (ACE_OS::ftell (fp));
+      ACE_OS::fclose (fp);
+    }
+  ACE_OS::unlink (path);
+
+  ACE_hrtime_t usecs = 0;
+  timer.elapsed_microseconds (usecs);
+  return static_cast<double> (usecs) / timed_messages;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Log_Msg_Binary_Test"));
+
+  int status = 0;
+  if (round_trip_test () != 0)
+    status = 1;
+
+  ACE_UINT64 binary_size = 0;
+  ACE_UINT64 text_size = 0;
+  double const binary_usecs = time_logging (true, binary_size);
+  double const text_usecs = time_logging (false, text_size);
+  if (binary_usecs < 0 || text_usecs < 0)
+    status = 1;
+  else
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("usecs per message formatted to a file: %.3f, ")
+                ACE_TEXT ("%Q bytes; logged in binary: %.3f, %Q bytes\n"),
+                text_usecs,
+                text_size,
+                binary_usecs,
+                binary_size));
+
+  ACE_END_TEST;
+  return status;
+}
@@ -7,7 +7,8 @@
  *
  *    This test program is a torture test that illustrates how
  *    <ACE_Message_Block> reference counting works in multi-threaded
- *    code.
+ *    code.  It also compares the cost of allocating message blocks
+ *    with the default allocators and with an <ACE_Slab_Allocator>.
  *
  *
  *  @author Doug Schmidt <schmidt@cs.wustl.edu> and Nanbor Wang <nanbor@cs.wustl.edu>
@@ -19,11 +20,13 @@
 #include "ace/OS_NS_string.h"
 #include "ace/Task.h"
 #include "ace/Malloc_T.h"
+#include "ace/Slab_Allocator.h"
 #include "ace/Profile_Timer.h"
+#include "ace/High_Res_Timer.h"
 #include "ace/Free_List.h"
 
 // Number of memory allocation strategies used in this test.
-static const int ACE_ALLOC_STRATEGY_NO = 2;
+static const int ACE_ALLOC_STRATEGY_NO = 3;
 
 // Size of a memory block (multiple of ACE_MALLOC_ALIGN).
 static const int ACE_ALLOC_SIZE = 5;
@@ -238,7 +241,8 @@ Worker_Task::Worker_Task (void)
 
 static int
 produce (Worker_Task &worker_task,
-         ACE_Allocator *alloc_strategy)
+         ACE_Allocator *alloc_strategy,
+         ACE_Slab_Allocator *slab_allocator)
 {
   ACE_Message_Block *mb = 0;
   int status;
@@ -251,16 +255,29 @@ produce (Worker_Task &worker_task,
 
       size_t n = (ACE_OS::strlen (buf) + 1) * sizeof (ACE_TCHAR);
 
-      // Allocate a new message.
-      ACE_NEW_RETURN (mb,
-                      ACE_Message_Block (n, // size
-                                         ACE_Message_Block::MB_DATA, // type
-                                         0, // cont
-                                         0, // data
-                                         alloc_strategy, // allocator
-                                         &lock_adapter_, // locking strategy
-                                         ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY), // priority
-                      -1);
+      // Allocate a new message, all in one chunk from the slab
+      // allocator if there is one.
+      if (slab_allocator != 0)
+        {
+          mb = slab_allocator->message_block (n,
+                                              ACE_Message_Block::MB_DATA,
+                                              &lock_adapter_);
+          if (mb == 0)
+            ACE_ERROR_RETURN ((LM_ERROR,
+                               ACE_TEXT (" (%t) %p\n"),
+                               ACE_TEXT ("message_block")),
+                              -1);
+        }
+      else
+        ACE_NEW_RETURN (mb,
+                        ACE_Message_Block (n, // size
+                                           ACE_Message_Block::MB_DATA, // type
+                                           0, // cont
+                                           0, // data
+                                           alloc_strategy, // allocator
+                                           &lock_adapter_, // locking strategy
+                                           ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY), // priority
+                        -1);
 
       // Try once to copy in more than the block will hold; should yield an
       // error with ENOSPC.
@@ -332,18 +349,109 @@ ACE_Cached_Allocator<MEMORY_CHUNK,
 struct alloc_struct_type
 {
   ACE_Allocator *strategy_;
+  ACE_Slab_Allocator *slab_;
   const ACE_TCHAR *name_;
   ACE_Profile_Timer::ACE_Elapsed_Time et_;
 };
 
 alloc_struct_type alloc_struct[ACE_ALLOC_STRATEGY_NO] =
 {
-  { 0, ACE_TEXT ("Default"), {0,0,0} },
-  { &mem_allocator, ACE_TEXT ("Cached Memory"), {0,0,0} }
+  { 0, 0, ACE_TEXT ("Default"), {0,0,0} },
+  { &mem_allocator, 0, ACE_TEXT ("Cached Memory"), {0,0,0} },
+  { 0, 0, ACE_TEXT ("Slab"), {0,0,0} }
 };
 
 #endif /* ACE_HAS_THREADS */
 
+// Number of messages allocated by each round of the allocation
+// benchmark, and their sizes, typical of network payloads.
+static const int allocation_rounds = 100000;
+static const size_t allocation_sizes[] = { 64, 512, 1460, 9000 };
+
+// Allocates, duplicates and releases messages, with the default
+// allocators, with a slab allocator for each of the three allocators
+// of the message block, or with everything in one slab chunk, and
+// returns the time taken per message in microseconds.
+static double
+time_allocation (ACE_Slab_Allocator *slab, bool co_allocate, int &errors)
+{
+  size_t const size_count =
+    sizeof allocation_sizes / sizeof allocation_sizes[0];
+  ACE_High_Res_Timer timer;
+
+  timer.start ();
+  for (int i = 0; i < allocation_rounds; ++i)
+    {
+      size_t const size = allocation_sizes[i % size_count];
+      ACE_Message_Block *mb = 0;
+      if (slab == 0)
+        ACE_NEW_RETURN (mb, ACE_Message_Block (size), 0.0);
+      else if (co_allocate)
+        mb = slab->message_block (size);
+      else
+        ACE_NEW_MALLOC_RETURN (mb,
+                               static_cast<ACE_Message_Block *> (
+                                 slab->malloc (sizeof (ACE_Message_Block))),
+                               ACE_Message_Block (size,
+                                                  ACE_Message_Block::MB_DATA,
+                                                  0,
+                                                  0,
+                                                  slab,
+                                                  0,
+                                                  ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
+                                                  ACE_Time_Value::zero,
+                                                  ACE_Time_Value::max_time,
+                                                  slab,
+                                                  slab),
+                               0.0);
+      if (mb == 0 || mb->size () != size)
+        {
+          ++errors;
+          continue;
+        }
+
+      mb->wr_ptr ()[0] = 'a';
+      mb->wr_ptr ()[size - 1] = 'z';
+      mb->wr_ptr (size);
+      ACE_Message_Block *dup = mb->duplicate ();
+      mb->release ();
+      if (dup->rd_ptr ()[0] != 'a' || dup->rd_ptr ()[size - 1] != 'z')
+        ++errors;
+      dup->release ();
+    }
+  timer.stop ();
+
+  ACE_hrtime_t nsecs;
+  timer.elapsed_time (nsecs);
+  return static_cast<double> (ACE_HRTIME_CONVERSION (nsecs))
+    / 1000.0 / allocation_rounds;
+}
+
+static int
+allocation_benchmark (void)
+{
+  ACE_Slab_Allocator slab;
+  int errors = 0;
+
+  double const default_usec = time_allocation (0, false, errors);
+  double const slab_usec = time_allocation (&slab, false, errors);
+  double const co_allocated_usec = time_allocation (&slab, true, errors);
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("usecs per message with the default allocators: %.3f, ")
+              ACE_TEXT ("slab allocators: %.3f, one slab chunk: %.3f\n"),
+              default_usec,
+              slab_usec,
+              co_allocated_usec));
+
+  if (errors != 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%d messages allocated incorrectly\n"),
+                       errors),
+                      -1);
+  return 0;
+}
+
 int
 run_main (int, ACE_TCHAR *[])
 {
@@ -355,6 +463,10 @@ run_main (int, ACE_TCHAR *[])
 
   ACE_Profile_Timer ptime;
 
+  ACE_Slab_Allocator slab_allocator;
+  alloc_struct[2].strategy_ = &slab_allocator;
+  alloc_struct[2].slab_ = &slab_allocator;
+
   int i;
 
   for (i = 0; i < ACE_ALLOC_STRATEGY_NO; i++)
@@ -372,7 +484,9 @@ run_main (int, ACE_TCHAR *[])
 
       ptime.start ();
       // Generate messages and pass them through the pipeline.
-      produce (worker_task[0], alloc_struct[i].strategy_);
+      produce (worker_task[0],
+               alloc_struct[i].strategy_,
+               alloc_struct[i].slab_);
 
       // Wait for all the threads to reach their exit point.
 
@@ -399,6 +513,9 @@ run_main (int, ACE_TCHAR *[])
   ACE_ERROR ((LM_INFO,
               ACE_TEXT ("threads not supported on this platform\n")));
 #endif /* ACE_HAS_THREADS */
+
+  int status = allocation_benchmark ();
+
   ACE_END_TEST;
-  return 0;
+  return status;
 }
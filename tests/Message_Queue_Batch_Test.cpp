@@ -0,0 +1,410 @@
+//=============================================================================
+/**
+ *  @file    Message_Queue_Batch_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks the bulk operations of the message queues:
+ *  <enqueue_chain> and <dequeue_batch> on ACE_Message_Queue, the
+ *  dynamic and lock-free queues, <enqueue_batch> and <dequeue_batch>
+ *  on ACE_Message_Queue_Ex, and their ACE_Task and ACE_Stream
+ *  counterparts.  Messages must come out in order, counts and byte
+ *  totals must be kept straight, and a pool of consumers must all be
+ *  woken up by a single <enqueue_chain>.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Message_Queue.h"
+#include "ace/Message_Queue_Lock_Free_T.h"
+#include "ace/Task.h"
+#include "ace/Stream.h"
+#include "ace/Module.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Atomic_Op.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_sys_time.h"
+
+typedef ACE_Message_Queue<ACE_MT_SYNCH> QUEUE;
+typedef ACE_Message_Queue_Factory<ACE_MT_SYNCH> QUEUE_FACTORY;
+
+static const int chain_length = 100;
+static const size_t batch_size = 16;
+
+// Build a chain of <count> messages numbered from <first>.
+static ACE_Message_Block *
+make_chain (int first, int count)
+{
+  ACE_Message_Block *head = 0;
+  ACE_Message_Block *tail = 0;
+  for (int i = first; i < first + count; ++i)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_NEW_RETURN (mb, ACE_Message_Block (sizeof (int)), 0);
+      *reinterpret_cast<int *> (mb->wr_ptr ()) = i;
+      mb->wr_ptr (sizeof (int));
+      if (head == 0)
+        head = mb;
+      else
+        tail->next (mb);
+      tail = mb;
+    }
+  return head;
+}
+
+// Check that the <count> messages starting at <mb> are numbered from
+// <expected> on, and release them.
+static int
+check_and_release (ACE_Message_Block *mb, int count, int &expected)
+{
+  int status = 0;
+  for (int i = 0; i < count; ++i)
+    {
+      if (mb == 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("batch ends after %d of %d messages\n"),
+                           i,
+                           count),
+                          -1);
+
+      int const value = *reinterpret_cast<int *> (mb->rd_ptr ());
+      if (value != expected)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("got message %d, expected %d\n"),
+                      value,
+                      expected));
+          status = -1;
+        }
+      ++expected;
+
+      ACE_Message_Block *next = mb->next ();
+      mb->next (0);
+      mb->prev (0);
+      mb->release ();
+      mb = next;
+    }
+
+  if (mb != 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("batch has more than %d messages\n"),
+                       count),
+                      -1);
+  return status;
+}
+
+// Enqueue one chain and take it out in batches.
+static int
+queue_test (QUEUE *queue, const ACE_TCHAR *name)
+{
+  int status = 0;
+
+  int const queued = queue->enqueue_chain (make_chain (0, chain_length));
+  if (queued != chain_length
+      || queue->message_bytes () != chain_length * sizeof (int))
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: enqueue_chain returned %d, %B bytes queued\n"),
+                  name,
+                  queued,
+                  queue->message_bytes ()));
+      status = -1;
+    }
+
+  int expected = 0;
+  while (expected < chain_length)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_Time_Value timeout (ACE_OS::gettimeofday () + ACE_Time_Value (5));
+      int const count = queue->dequeue_batch (mb, batch_size, &timeout);
+      if (count <= 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%s: %p\n"),
+                           name,
+                           ACE_TEXT ("dequeue_batch")),
+                          -1);
+
+      int const wanted =
+        ACE_MIN (static_cast<int> (batch_size), chain_length - expected);
+      if (count != wanted)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("%s: dequeued %d messages, expected %d\n"),
+                      name,
+                      count,
+                      wanted));
+          status = -1;
+        }
+      if (check_and_release (mb, count, expected) != 0)
+        status = -1;
+    }
+
+  if (queue->message_count () != 0 || queue->message_bytes () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: %B messages, %B bytes left\n"),
+                  name,
+                  queue->message_count (),
+                  queue->message_bytes ()));
+      status = -1;
+    }
+
+  ACE_Message_Block *mb = 0;
+  ACE_Time_Value timeout (ACE_OS::gettimeofday ());
+  if (queue->dequeue_batch (mb, batch_size, &timeout) != -1
+      || errno != EWOULDBLOCK)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: dequeue_batch on empty queue did not ")
+                  ACE_TEXT ("time out\n"),
+                  name));
+      status = -1;
+    }
+
+  if (queue->dequeue_batch (mb, 0, &timeout) != -1 || errno != EINVAL)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: dequeue_batch accepted a zero count\n"),
+                  name));
+      status = -1;
+    }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%s: %s\n"),
+              name,
+              status == 0 ? ACE_TEXT ("ok") : ACE_TEXT ("FAILED")));
+  return status;
+}
+
+static int
+queue_ex_test (void)
+{
+  ACE_Message_Queue_Ex<int, ACE_MT_SYNCH> queue;
+  int status = 0;
+
+  int values[chain_length];
+  int *items[chain_length];
+  for (int i = 0; i < chain_length; ++i)
+    {
+      values[i] = i;
+      items[i] = &values[i];
+    }
+
+  if (queue.enqueue_batch (items, chain_length) != chain_length)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%p\n"),
+                       ACE_TEXT ("Ex enqueue_batch")),
+                      -1);
+
+  int expected = 0;
+  while (expected < chain_length)
+    {
+      int *batch[batch_size];
+      int const count = queue.dequeue_batch (batch, batch_size);
+      if (count <= 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("Ex dequeue_batch")),
+                          -1);
+      for (int i = 0; i < count; ++i, ++expected)
+        if (batch[i] != &values[expected])
+          {
+            ACE_ERROR ((LM_ERROR,
+                        ACE_TEXT ("Ex: got item %d, expected %d\n"),
+                        *batch[i],
+                        expected));
+            status = -1;
+          }
+    }
+
+  if (!queue.is_empty ())
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("Ex: queue not empty\n")));
+      status = -1;
+    }
+
+  // Nothing of a failed batch may be queued.
+  queue.deactivate ();
+  if (queue.enqueue_batch (items, chain_length) != -1
+      || errno != ESHUTDOWN
+      || !queue.is_empty ())
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("Ex: enqueue_batch on a deactivated queue\n")));
+      status = -1;
+    }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("Ex: %s\n"),
+              status == 0 ? ACE_TEXT ("ok") : ACE_TEXT ("FAILED")));
+  return status;
+}
+
+#if defined (ACE_HAS_THREADS)
+
+/**
+ * @class Batch_Task
+ *
+ * A pool of threads taking batches of messages off the task's queue,
+ * until they each get an MB_HANGUP.
+ */
+class Batch_Task : public ACE_Task<ACE_MT_SYNCH>
+{
+public:
+  Batch_Task (void) : received_ (0) {}
+
+  virtual int svc (void)
+  {
+    for (;;)
+      {
+        ACE_Message_Block *mb = 0;
+        int const count = this->getq_batch (mb, batch_size);
+        if (count == -1)
+          return -1;
+
+        bool hangup = false;
+        for (int i = 0; i < count; ++i)
+          {
+            ACE_Message_Block *next = mb->next ();
+            mb->next (0);
+            if (mb->msg_type () == ACE_Message_Block::MB_HANGUP)
+              {
+                // Leave the rest for the other threads.
+                hangup = true;
+                if (next != 0)
+                  {
+                    next->prev (0);
+                    this->ungetq (next);
+                  }
+                mb->release ();
+                break;
+              }
+            ++this->received_;
+            mb->release ();
+            mb = next;
+          }
+        if (hangup)
+          return 0;
+      }
+  }
+
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, int> received_;
+};
+
+static int
+task_test (void)
+{
+  int const threads = 4;
+  int const chains = 50;
+
+  Batch_Task task;
+  if (task.activate (THR_NEW_LWP | THR_JOINABLE, threads) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("activate")), -1);
+
+  for (int i = 0; i < chains; ++i)
+    task.putq_chain (make_chain (i * chain_length, chain_length));
+
+  ACE_Message_Block *hangups = 0;
+  for (int i = 0; i < threads; ++i)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_NEW_RETURN (mb,
+                      ACE_Message_Block (0, ACE_Message_Block::MB_HANGUP),
+                      -1);
+      mb->next (hangups);
+      hangups = mb;
+    }
+  task.putq_chain (hangups);
+  task.wait ();
+
+  int status = 0;
+  if (task.received_.value () != chains * chain_length)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("task received %d messages, expected %d\n"),
+                  task.received_.value (),
+                  chains * chain_length));
+      status = -1;
+    }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("Task: %s\n"),
+              status == 0 ? ACE_TEXT ("ok") : ACE_TEXT ("FAILED")));
+  return status;
+}
+
+#endif /* ACE_HAS_THREADS */
+
+// Messages put in the stream head's reader come out of <get_batch>.
+static int
+stream_test (void)
+{
+  ACE_Stream<ACE_MT_SYNCH> stream;
+  if (stream.open (0) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("open")), -1);
+
+  ACE_Module<ACE_MT_SYNCH> *head = stream.head ();
+  if (head->reader ()->put (make_chain (0, chain_length)) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("put")), -1);
+
+  int status = 0;
+  int expected = 0;
+  while (expected < chain_length)
+    {
+      ACE_Message_Block *mb = 0;
+      int const count = stream.get_batch (mb, batch_size);
+      if (count <= 0)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("get_batch")));
+          status = -1;
+          break;
+        }
+      if (check_and_release (mb, count, expected) != 0)
+        status = -1;
+    }
+
+  stream.close ();
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("Stream: %s\n"),
+              status == 0 ? ACE_TEXT ("ok") : ACE_TEXT ("FAILED")));
+  return status;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Message_Queue_Batch_Test"));
+
+  int status = 0;
+
+  QUEUE queue;
+  if (queue_test (&queue, ACE_TEXT ("ACE_Message_Queue")) != 0)
+    status = -1;
+
+  QUEUE *dynamic = QUEUE_FACTORY::create_deadline_message_queue ();
+  if (queue_test (dynamic, ACE_TEXT ("Deadline queue")) != 0)
+    status = -1;
+  delete dynamic;
+
+#if defined (ACE_HAS_CPP11)
+  QUEUE *mpsc = QUEUE_FACTORY::create_mpsc_message_queue ();
+  if (queue_test (mpsc, ACE_TEXT ("MPSC")) != 0)
+    status = -1;
+  delete mpsc;
+#endif /* ACE_HAS_CPP11 */
+
+  if (queue_ex_test () != 0)
+    status = -1;
+
+#if defined (ACE_HAS_THREADS)
+  if (task_test () != 0)
+    status = -1;
+#endif /* ACE_HAS_THREADS */
+
+  if (stream_test () != 0)
+    status = -1;
+
+  ACE_END_TEST;
+  return status;
+}
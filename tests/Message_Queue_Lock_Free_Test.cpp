@@ -0,0 +1,335 @@
+//=============================================================================
+/**
+ *  @file    Message_Queue_Lock_Free_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks the lock-free ACE_Message_Queue_SPSC and
+ *  ACE_Message_Queue_MPSC: messages must come out in the order each
+ *  producer enqueued them, none may be lost when the producers have to
+ *  wait for a small ring or the high water mark, a consumer waiting on
+ *  an empty queue must time out or be woken up by deactivate(), and
+ *  the queues must work as the message queue of an ACE_Task.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Message_Queue.h"
+#include "ace/Message_Queue_Lock_Free_T.h"
+#include "ace/Task.h"
+#include "ace/Thread_Manager.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_unistd.h"
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+typedef ACE_Message_Queue_Factory<ACE_MT_SYNCH> QUEUE_FACTORY;
+typedef ACE_Message_Queue<ACE_MT_SYNCH> QUEUE;
+
+static const int producer_count = 4;
+static const int message_count = 20000;
+
+struct Producer_Args
+{
+  QUEUE *queue_;
+  int id_;
+};
+
+// Enqueue <message_count> messages tagged with the producer id and a
+// sequence number; every tenth one is part of a chain of three.
+static ACE_THR_FUNC_RETURN
+producer (void *arg)
+{
+  Producer_Args *args = static_cast<Producer_Args *> (arg);
+
+  for (int seq = 0; seq < message_count; )
+    {
+      int const chain = (seq % 10 == 0 && seq + 3 <= message_count) ? 3 : 1;
+      ACE_Message_Block *first = 0;
+      ACE_Message_Block *last = 0;
+      for (int i = 0; i < chain; ++i, ++seq)
+        {
+          ACE_Message_Block *mb = 0;
+          ACE_NEW_RETURN (mb, ACE_Message_Block (16), 0);
+          mb->msg_priority (static_cast<unsigned long> (args->id_));
+          *reinterpret_cast<int *> (mb->wr_ptr ()) = seq;
+          mb->wr_ptr (sizeof (int));
+          if (first == 0)
+            first = mb;
+          else
+            last->next (mb);
+          last = mb;
+        }
+
+      if (args->queue_->enqueue_tail (first) == -1)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("(%t) %p\n"),
+                      ACE_TEXT ("enqueue_tail")));
+          return 0;
+        }
+    }
+  return 0;
+}
+
+// Dequeue messages from <producers> producers and check that each
+// producer's messages arrive in order.
+static int
+consume (QUEUE *queue, int producers)
+{
+  int next_seq[producer_count] = { 0 };
+  int status = 0;
+
+  for (int received = 0; received < producers * message_count; ++received)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_Time_Value timeout (ACE_OS::gettimeofday () + ACE_Time_Value (30));
+      if (queue->dequeue_head (mb, &timeout) == -1)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%p after %d messages\n"),
+                           ACE_TEXT ("dequeue_head"),
+                           received),
+                          -1);
+
+      int const id = static_cast<int> (mb->msg_priority ());
+      int const seq = *reinterpret_cast<int *> (mb->rd_ptr ());
+      if (id < 0 || id >= producers || mb->next () != 0)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("bad message from %d\n"), id));
+          status = -1;
+        }
+      else if (seq != next_seq[id]++)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("producer %d: got %d, expected %d\n"),
+                      id,
+                      seq,
+                      next_seq[id] - 1));
+          next_seq[id] = seq + 1;
+          status = -1;
+        }
+      mb->release ();
+    }
+
+  if (queue->message_count () != 0 || queue->message_bytes () != 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%B messages, %B bytes left\n"),
+                       queue->message_count (),
+                       queue->message_bytes ()),
+                      -1);
+  return status;
+}
+
+static int
+run_producers (QUEUE *queue, int producers, const ACE_TCHAR *name)
+{
+  Producer_Args args[producer_count];
+  for (int i = 0; i < producers; ++i)
+    {
+      args[i].queue_ = queue;
+      args[i].id_ = i;
+      if (ACE_Thread_Manager::instance ()->spawn (producer, &args[i]) == -1)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn")), -1);
+    }
+
+  int const status = consume (queue, producers);
+  ACE_Thread_Manager::instance ()->wait ();
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%s: %d producer(s) %s\n"),
+              name,
+              producers,
+              status == 0 ? ACE_TEXT ("ok") : ACE_TEXT ("FAILED")));
+  return status;
+}
+
+// A consumer waiting on an empty queue must time out, and be woken up
+// with ESHUTDOWN when the queue is deactivated.
+static ACE_THR_FUNC_RETURN
+deactivator (void *arg)
+{
+  ACE_OS::sleep (ACE_Time_Value (0, 200000));
+  static_cast<QUEUE *> (arg)->deactivate ();
+  return 0;
+}
+
+static int
+wait_test (QUEUE *queue, const ACE_TCHAR *name)
+{
+  int status = 0;
+
+  ACE_Message_Block *mb = 0;
+  ACE_Time_Value timeout (ACE_OS::gettimeofday () + ACE_Time_Value (0, 100000));
+  if (queue->dequeue_head (mb, &timeout) != -1 || errno != EWOULDBLOCK)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: dequeue_head on empty queue did not ")
+                  ACE_TEXT ("time out\n"),
+                  name));
+      status = -1;
+    }
+
+  if (ACE_Thread_Manager::instance ()->spawn (deactivator, queue) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn")), -1);
+
+  if (queue->dequeue_head (mb) != -1 || errno != ESHUTDOWN)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: deactivate did not wake up dequeue_head\n"),
+                  name));
+      status = -1;
+    }
+  ACE_Thread_Manager::instance ()->wait ();
+
+  if (queue->enqueue_head (mb) != -1 || errno != ENOTSUP)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: enqueue_head should not be supported\n"),
+                  name));
+      status = -1;
+    }
+
+  return status;
+}
+
+/**
+ * @class Sink_Task
+ *
+ * Counts the messages put into its lock-free queue by other threads.
+ */
+class Sink_Task : public ACE_Task<ACE_MT_SYNCH>
+{
+public:
+  Sink_Task (QUEUE *queue)
+    : ACE_Task<ACE_MT_SYNCH> (0, queue), received_ (0)
+  {
+  }
+
+  virtual int svc (void)
+  {
+    for (ACE_Message_Block *mb = 0; this->getq (mb) != -1; )
+      {
+        bool const hangup = mb->msg_type () == ACE_Message_Block::MB_HANGUP;
+        mb->release ();
+        if (hangup)
+          break;
+        ++this->received_;
+      }
+    return 0;
+  }
+
+  int received_;
+};
+
+static ACE_THR_FUNC_RETURN
+putter (void *arg)
+{
+  Sink_Task *task = static_cast<Sink_Task *> (arg);
+  for (int i = 0; i < message_count; ++i)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_NEW_RETURN (mb, ACE_Message_Block (8), 0);
+      if (task->putq (mb) == -1)
+        {
+          mb->release ();
+          ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("putq")), 0);
+        }
+    }
+  return 0;
+}
+
+static int
+task_test (void)
+{
+  QUEUE *queue = QUEUE_FACTORY::create_mpsc_message_queue ();
+  if (queue == 0)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("queue")), -1);
+
+  int status = 0;
+  {
+    Sink_Task task (queue);
+    if (task.activate () == -1)
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("activate")), -1);
+
+    int const grp_id =
+      ACE_Thread_Manager::instance ()->spawn_n (producer_count, putter, &task);
+    if (grp_id != -1)
+      ACE_Thread_Manager::instance ()->wait_grp (grp_id);
+    else
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn_n")));
+        status = -1;
+      }
+
+    ACE_Message_Block *hangup = 0;
+    ACE_NEW_RETURN (hangup,
+                    ACE_Message_Block (0, ACE_Message_Block::MB_HANGUP),
+                    -1);
+    task.putq (hangup);
+    task.wait ();
+
+    if (status == 0 && task.received_ != producer_count * message_count)
+      {
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("task received %d messages, expected %d\n"),
+                    task.received_,
+                    producer_count * message_count));
+        status = -1;
+      }
+  }
+
+  delete queue;
+  return status;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Message_Queue_Lock_Free_Test"));
+
+  int status = 0;
+
+  // A small ring and high water mark make the producer wait.
+  QUEUE *spsc = QUEUE_FACTORY::create_spsc_message_queue (64);
+  if (run_producers (spsc, 1, ACE_TEXT ("SPSC")) != 0)
+    status = -1;
+  delete spsc;
+
+  spsc = QUEUE_FACTORY::create_spsc_message_queue (1024, 256, 128);
+  if (run_producers (spsc, 1, ACE_TEXT ("SPSC, water marks")) != 0
+      || wait_test (spsc, ACE_TEXT ("SPSC")) != 0)
+    status = -1;
+  delete spsc;
+
+  QUEUE *mpsc = QUEUE_FACTORY::create_mpsc_message_queue ();
+  if (run_producers (mpsc, producer_count, ACE_TEXT ("MPSC")) != 0)
+    status = -1;
+  delete mpsc;
+
+  mpsc = QUEUE_FACTORY::create_mpsc_message_queue (256, 128);
+  if (run_producers (mpsc, producer_count, ACE_TEXT ("MPSC, water marks")) != 0
+      || wait_test (mpsc, ACE_TEXT ("MPSC")) != 0)
+    status = -1;
+  delete mpsc;
+
+  if (task_test () != 0)
+    status = -1;
+
+  ACE_END_TEST;
+  return status;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Message_Queue_Lock_Free_Test"));
+  ACE_ERROR ((LM_INFO,
+              ACE_TEXT ("Lock-free message queues need threads and C++11\n")));
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */
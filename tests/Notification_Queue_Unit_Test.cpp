@@ -3,7 +3,9 @@
  *
  * $Id$
  *
- * A unit test for the ACE_Notification_Queue class.
+ * A unit test for the ACE_Notification_Queue class, and for
+ * ACE_Notification_Queue_Lock_Free and ACE_Notification_Event where
+ * they are available.
  *
  * @author Carlos O'Ryan <coryan@atdesk.com>
  *
@@ -11,6 +13,26 @@
 
 #include "test_config.h"
 #include "ace/Notification_Queue.h"
+#include "ace/Thread_Manager.h"
+
+#if defined (ACE_HAS_CPP11)
+# define LOCK_FREE_TEST_LIST \
+  ACTION(lock_free_pop_returns_element_pushed) \
+  ACTION(lock_free_purge_with_multiple_matches) \
+  ACTION(lock_free_queue_grows) \
+  ACTION(lock_free_reset_non_empty_queue) \
+  ACTION(lock_free_concurrent_push) \
+  ACTION(lock_free_concurrent_growth)
+#else
+# define LOCK_FREE_TEST_LIST
+#endif /* ACE_HAS_CPP11 */
+
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+# define EVENT_TEST_LIST \
+  ACTION(event_signals_coalesce)
+#else
+# define EVENT_TEST_LIST
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
 
 #define TEST_LIST \
   ACTION(null_test) \
@@ -21,6 +43,8 @@
   ACTION(purge_with_multiple_matches) \
   ACTION(reset_empty_queue) \
   ACTION(reset_non_empty_queue) \
+  LOCK_FREE_TEST_LIST \
+  EVENT_TEST_LIST \
 
 // Declare all the tests
 #define ACTION(TEST_NAME) void TEST_NAME (char const * test_name);
@@ -278,6 +302,288 @@ void reset_non_empty_queue(char const * /* test_name */)
   queue.reset();
 }
 
+#if defined (ACE_HAS_CPP11)
+void lock_free_pop_returns_element_pushed(char const * test_name)
+{
+  ACE_Notification_Queue_Lock_Free queue;
+
+  Event_Handler eh1(1);
+  Event_Handler eh2(2);
+
+  int result = queue.push_new_notification(
+      ACE_Notification_Buffer(&eh1,
+                              ACE_Event_Handler::READ_MASK));
+  TEST_ASSERT(result == 1, "push[1] should return 1");
+
+  result = queue.push_new_notification(
+      ACE_Notification_Buffer(&eh2,
+                              ACE_Event_Handler::WRITE_MASK));
+  TEST_ASSERT(result == 0, "push[2] should return 0");
+
+  ACE_Notification_Buffer current;
+  bool more_messages_queued;
+  ACE_Notification_Buffer next;
+
+  result = queue.pop_next_notification(current, more_messages_queued, next);
+  TEST_ASSERT(result == 1, "pop[0] should return 1");
+  TEST_ASSERT(more_messages_queued, "pop[0] should have more messages");
+  TEST_EQUAL(current.eh_, &eh1, "Wrong handler extracted");
+  TEST_EQUAL(next.eh_, &eh2, "Wrong next handler");
+
+  result = queue.pop_next_notification(current, more_messages_queued, next);
+  TEST_ASSERT(result == 1, "pop[1] should return 1");
+  TEST_ASSERT(!more_messages_queued, "pop[1] should not have more messages");
+  TEST_EQUAL(current.eh_, &eh2, "Wrong handler extracted");
+  TEST_EQUAL(current.mask_, ACE_Event_Handler::WRITE_MASK,
+             "Wrong mask extracted");
+
+  result = queue.pop_next_notification(current, more_messages_queued, next);
+  TEST_ASSERT(result == 0, "pop[2] should return 0");
+
+  // Once empty, the next push must wake up the reactor again.
+  result = queue.push_new_notification(
+      ACE_Notification_Buffer(&eh1,
+                              ACE_Event_Handler::READ_MASK));
+  TEST_ASSERT(result == 1, "push after pop should return 1");
+}
+
+void lock_free_purge_with_multiple_matches(char const * test_name)
+{
+  ACE_Notification_Queue_Lock_Free queue;
+  TEST_EQUAL(queue.open(), 0, "open should succeed");
+
+  Event_Handler eh1(1);
+  Event_Handler eh2(2);
+
+  queue.push_new_notification(
+      ACE_Notification_Buffer(&eh1,
+                              ACE_Event_Handler::READ_MASK |
+                              ACE_Event_Handler::WRITE_MASK));
+  queue.push_new_notification(
+      ACE_Notification_Buffer(&eh2,
+                              ACE_Event_Handler::WRITE_MASK));
+  queue.push_new_notification(
+      ACE_Notification_Buffer(&eh2,
+                              ACE_Event_Handler::READ_MASK));
+  queue.push_new_notification(
+      ACE_Notification_Buffer(&eh2,
+                              ACE_Event_Handler::WRITE_MASK));
+
+  int result = queue.purge_pending_notifications(&eh2,
+                                                 ACE_Event_Handler::WRITE_MASK);
+  TEST_EQUAL(result, 2, "purge of eh2/WRITE should return 2");
+
+  ACE_Notification_Buffer current;
+  bool more_messages_queued;
+  ACE_Notification_Buffer next;
+
+  result = queue.pop_next_notification(current, more_messages_queued, next);
+  TEST_EQUAL(current.eh_, &eh1, "Wrong handler extracted");
+  TEST_ASSERT(more_messages_queued, "pop[0] should have more messages");
+
+  result = queue.pop_next_notification(current, more_messages_queued, next);
+  TEST_EQUAL(current.eh_, &eh2, "Wrong handler extracted");
+  TEST_EQUAL(current.mask_, ACE_Event_Handler::READ_MASK,
+             "Wrong mask extracted");
+  TEST_ASSERT(!more_messages_queued, "pop[1] should not have more messages");
+}
+
+void lock_free_queue_grows(char const * test_name)
+{
+  ACE_Notification_Queue_Lock_Free queue;
+
+  Event_Handler eh1(1);
+
+  // Enough notifications for the queue to allocate three arrays.
+  unsigned long const count = 5 * ACE_REACTOR_NOTIFICATION_ARRAY_SIZE;
+  for (unsigned long i = 0; i != count; ++i)
+    {
+      int const result = queue.push_new_notification(
+          ACE_Notification_Buffer(&eh1, i));
+      TEST_EQUAL(result, i == 0 ? 1 : 0, "Wrong push result");
+    }
+
+  ACE_Notification_Buffer current;
+  bool more_messages_queued = true;
+  ACE_Notification_Buffer next;
+
+  for (unsigned long i = 0; i != count; ++i)
+    {
+      int const result =
+        queue.pop_next_notification(current, more_messages_queued, next);
+      TEST_EQUAL(result, 1, "pop should return 1");
+      TEST_EQUAL(static_cast<int>(current.mask_), static_cast<int>(i),
+                 "Notifications out of order");
+      TEST_ASSERT(more_messages_queued == (i + 1 != count),
+                  "Wrong more_messages_queued");
+    }
+}
+
+void lock_free_reset_non_empty_queue(char const * /* test_name */)
+{
+  ACE_Notification_Queue_Lock_Free queue;
+
+  Event_Handler eh1(1);
+
+  queue.push_new_notification(
+      ACE_Notification_Buffer(0,
+                              ACE_Event_Handler::READ_MASK));
+  queue.push_new_notification(
+      ACE_Notification_Buffer(&eh1,
+                              ACE_Event_Handler::READ_MASK));
+
+  queue.reset();
+}
+
+# if defined (ACE_HAS_THREADS)
+static int const producer_count = 4;
+static unsigned long const notifications_per_producer = 10000;
+
+struct Producer
+{
+  ACE_Notification_Queue_Lock_Free * queue;
+  Event_Handler * eh;
+  int woken_up;
+};
+
+static ACE_THR_FUNC_RETURN
+produce (void * arg)
+{
+  Producer * producer = static_cast<Producer *>(arg);
+  for (unsigned long i = 0; i != notifications_per_producer; ++i)
+    {
+      if (producer->queue->push_new_notification(
+            ACE_Notification_Buffer(producer->eh, i)) == 1)
+        {
+          ++producer->woken_up;
+        }
+    }
+  return 0;
+}
+# endif /* ACE_HAS_THREADS */
+
+void lock_free_concurrent_push(char const * test_name)
+{
+# if defined (ACE_HAS_THREADS)
+  ACE_Notification_Queue_Lock_Free queue;
+  TEST_EQUAL(queue.open(), 0, "open should succeed");
+
+  Event_Handler eh1(1);
+  Event_Handler eh2(2);
+  Event_Handler eh3(3);
+  Event_Handler eh4(4);
+  Event_Handler * handlers[producer_count] = { &eh1, &eh2, &eh3, &eh4 };
+
+  Producer producers[producer_count];
+  for (int i = 0; i != producer_count; ++i)
+    {
+      producers[i].queue = &queue;
+      producers[i].eh = handlers[i];
+      producers[i].woken_up = 0;
+      if (ACE_Thread_Manager::instance ()->spawn (produce,
+                                                  &producers[i]) == -1)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("(%t) %p\n"),
+                      ACE_TEXT ("spawn")));
+          return;
+        }
+    }
+  ACE_Thread_Manager::instance ()->wait ();
+
+  // Nothing was popped in the meantime, so the reactor would have been
+  // woken up once for all of them.
+  int woken_up = 0;
+  for (int i = 0; i != producer_count; ++i)
+    woken_up += producers[i].woken_up;
+  TEST_EQUAL(woken_up, 1, "Notifications should be coalesced");
+
+  unsigned long expected[producer_count] = { 0, 0, 0, 0 };
+  ACE_Notification_Buffer current;
+  bool more_messages_queued = true;
+  ACE_Notification_Buffer next;
+
+  while (queue.pop_next_notification(current, more_messages_queued, next) == 1)
+    {
+      int const id = static_cast<Event_Handler *>(current.eh_)->id - 1;
+      TEST_EQUAL(static_cast<int>(current.mask_),
+                 static_cast<int>(expected[id]),
+                 "Notifications of a producer out of order");
+      expected[id] = current.mask_ + 1;
+    }
+
+  for (int i = 0; i != producer_count; ++i)
+    TEST_EQUAL(static_cast<int>(expected[i]),
+               static_cast<int>(notifications_per_producer),
+               "Notifications lost");
+# else
+  ACE_UNUSED_ARG (test_name);
+# endif /* ACE_HAS_THREADS */
+}
+
+void lock_free_concurrent_growth(char const * test_name)
+{
+# if defined (ACE_HAS_THREADS)
+  // Not opened, so that all the producers find the free list empty
+  // from the start.
+  ACE_Notification_Queue_Lock_Free queue;
+
+  Event_Handler eh1(1);
+
+  Producer producers[producer_count];
+  for (int i = 0; i != producer_count; ++i)
+    {
+      producers[i].queue = &queue;
+      producers[i].eh = &eh1;
+      producers[i].woken_up = 0;
+    }
+  for (int i = 0; i != producer_count; ++i)
+    {
+      if (ACE_Thread_Manager::instance ()->spawn (produce,
+                                                  &producers[i]) == -1)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("(%t) %p\n"),
+                      ACE_TEXT ("spawn")));
+          return;
+        }
+    }
+  ACE_Thread_Manager::instance ()->wait ();
+
+  // The queue only grows when all its nodes are used, so it never
+  // has more than twice the nodes it needs, plus the first array.
+  size_t const used = producer_count * notifications_per_producer;
+  TEST_ASSERT(queue.capacity() >= used, "Too few nodes allocated");
+  TEST_ASSERT(queue.capacity() <= 2 * used + ACE_REACTOR_NOTIFICATION_ARRAY_SIZE,
+              "The queue grew more than needed");
+# else
+  ACE_UNUSED_ARG (test_name);
+# endif /* ACE_HAS_THREADS */
+}
+#endif /* ACE_HAS_CPP11 */
+
+#if defined (ACE_HAS_REACTOR_EVENTFD_NOTIFY)
+void event_signals_coalesce(char const * test_name)
+{
+  ACE_Notification_Event event;
+
+  TEST_EQUAL(event.open(), 0, "open should succeed");
+  TEST_ASSERT(event.read_handle() == event.write_handle(),
+              "read and write handles should be the same");
+
+  TEST_EQUAL(event.clear(), 0, "clear of a new event should return 0");
+
+  TEST_EQUAL(event.signal(), 0, "signal[0] should succeed");
+  TEST_EQUAL(event.signal(), 0, "signal[1] should succeed");
+  TEST_EQUAL(event.clear(), 1, "clear should consume both signals");
+  TEST_EQUAL(event.clear(), 0, "clear should find no more signals");
+
+  TEST_EQUAL(event.close(), 0, "close should succeed");
+  TEST_ASSERT(event.read_handle() == ACE_INVALID_HANDLE,
+              "close should invalidate the handle");
+}
+#endif /* ACE_HAS_REACTOR_EVENTFD_NOTIFY */
+
 void test_equal(int x, int y, char const * x_msg, char const * y_msg,
                 char const * error_message,
                 char const * test_name, char const * filename, int lineno)
@@ -52,11 +52,12 @@
 #  include "ace/POSIX_Proactor.h"
 #  include "ace/POSIX_CB_Proactor.h"
 #  include "ace/SUN_Proactor.h"
+#  include "ace/Uring_Proactor.h"
 
 #endif /* ACE_WIN32 */
 
 // Proactor Type (UNIX only, Win32 ignored)
-typedef enum { DEFAULT = 0, AIOCB, SIG, SUN, CB } ProactorType;
+typedef enum { DEFAULT = 0, AIOCB, SIG, SUN, CB, URING } ProactorType;
 static ProactorType proactor_type = DEFAULT;
 
 // POSIX : > 0 max number aio operations  proactor,
@@ -259,6 +260,16 @@ MyTask::create_proactor (ProactorType type_proactor, size_t max_op)
       break;
 #  endif /* !ACE_HAS_BROKEN_SIGEVENT_STRUCT */
 
+#  if defined (ACE_HAS_IO_URING)
+    case URING:
+      ACE_NEW_RETURN (proactor_impl,
+                      ACE_Uring_Proactor (max_op),
+                      -1);
+      ACE_DEBUG ((LM_DEBUG,
+                  ACE_TEXT ("(%t) Create Proactor Type = URING\n")));
+      break;
+#  endif /* ACE_HAS_IO_URING */
+
     default:
       ACE_DEBUG ((LM_DEBUG,
                   ACE_TEXT ("(%t) Create Proactor Type = DEFAULT\n")));
@@ -1996,6 +2007,7 @@ print_usage (int /* argc */, ACE_TCHAR *argv[])
       ACE_TEXT ("\n    i SIG")
       ACE_TEXT ("\n    c CB")
       ACE_TEXT ("\n    s SUN")
+      ACE_TEXT ("\n    u URING")
       ACE_TEXT ("\n    d default")
       ACE_TEXT ("\n-d <duplex mode 1-on/0-off>")
       ACE_TEXT ("\n-h <host> for Client mode")
@@ -2044,12 +2056,26 @@ set_proactor_type (const ACE_TCHAR *ptype)
        proactor_type = CB;
        return 1;
 #endif /* !ACE_HAS_BROKEN_SIGEVENT_STRUCT */
+    case 'U':
+      // Checked by run_main(), which skips the test without io_uring.
+      proactor_type = URING;
+      return 1;
     default:
       break;
     }
   return 0;
 }
 
+static bool
+uring_supported (void)
+{
+#if defined (ACE_HAS_IO_URING)
+  return ACE_Uring_Proactor::supported ();
+#else
+  return false;
+#endif /* ACE_HAS_IO_URING */
+}
+
 static int
 parse_args (int argc, ACE_TCHAR *argv[])
 {
@@ -2140,6 +2166,15 @@ run_main (int argc, ACE_TCHAR *argv[])
   if (::parse_args (argc, argv) == -1)
     return -1;
 
+  if (proactor_type == URING && !uring_supported ())
+    {
+      ACE_DEBUG ((LM_INFO,
+                  ACE_TEXT ("io_uring is unsupported.\n")
+                  ACE_TEXT ("Proactor_UDP_Test will not be run with it.\n")));
+      ACE_END_TEST;
+      return 0;
+    }
+
   disable_signal (ACE_SIGRTMIN, ACE_SIGRTMAX);
   disable_signal (SIGPIPE, SIGPIPE);
 
@@ -0,0 +1,335 @@
+
+//=============================================================================
+/**
+ *  @file    Reactor_Instrumentation_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that ACE_Select_Reactor, ACE_TP_Reactor and
+ *  ACE_Dev_Poll_Reactor record their wait time, upcall times, timer
+ *  lateness, notification queue depth and slow upcalls in the monitor
+ *  points of an ACE_Reactor_Instrumentation.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Reactor_Instrumentation.h"
+
+#if defined (ACE_HAS_MONITOR_POINTS) && (ACE_HAS_MONITOR_POINTS == 1)
+
+#include "ace/Reactor.h"
+#include "ace/Select_Reactor.h"
+#include "ace/TP_Reactor.h"
+#include "ace/Dev_Poll_Reactor.h"
+#include "ace/Monitor_Point_Registry.h"
+#include "ace/Pipe.h"
+#include "ace/OS_NS_unistd.h"
+
+using ACE::Monitor_Control::Histogram_Monitor;
+using ACE::Monitor_Control::Monitor_Base;
+using ACE::Monitor_Control::Monitor_Point_Registry;
+
+static const int NOTIFICATIONS = 3;
+
+class Handler : public ACE_Event_Handler
+{
+public:
+  Handler (ACE_HANDLE handle)
+    : handle_ (handle), inputs_ (0), timeouts_ (0), notifications_ (0)
+  {
+  }
+
+  virtual ACE_HANDLE get_handle (void) const
+  {
+    return this->handle_;
+  }
+
+  virtual int handle_input (ACE_HANDLE handle)
+  {
+    if (handle == ACE_INVALID_HANDLE)
+      {
+        ++this->notifications_;
+        return 0;
+      }
+
+    char c;
+    if (ACE_OS::read (handle, &c, 1) != 1)
+      return -1;
+
+    // Slow enough to be listed as a slow upcall.
+    ACE_OS::sleep (ACE_Time_Value (0, 20000));
+    ++this->inputs_;
+    return 0;
+  }
+
+  virtual int handle_timeout (const ACE_Time_Value &, const void *)
+  {
+    ++this->timeouts_;
+    return 0;
+  }
+
+  bool done (void) const
+  {
+    return this->inputs_ > 0
+      && this->timeouts_ > 0
+      && this->notifications_ == NOTIFICATIONS;
+  }
+
+private:
+  ACE_HANDLE handle_;
+
+public:
+  int inputs_;
+  int timeouts_;
+  int notifications_;
+};
+
+static int
+check_histogram (const char *what,
+                 Histogram_Monitor *monitor,
+                 unsigned long min)
+{
+  if (monitor->samples () < min)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%C: %u samples, expected at least %u\n"),
+                       what,
+                       static_cast<unsigned int> (monitor->samples ()),
+                       static_cast<unsigned int> (min)),
+                      1);
+
+  unsigned long in_buckets = 0;
+  for (size_t i = 0; i < Histogram_Monitor::BUCKETS; ++i)
+    in_buckets += monitor->bucket (i);
+
+  if (in_buckets != monitor->samples ())
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%C: %u samples but %u in buckets\n"),
+                       what,
+                       static_cast<unsigned int> (monitor->samples ()),
+                       static_cast<unsigned int> (in_buckets)),
+                      1);
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%C: %u samples, %Q usec\n"),
+              what,
+              static_cast<unsigned int> (monitor->samples ()),
+              monitor->sum ()));
+  return 0;
+}
+
+static int
+run_reactor (const char *name, ACE_Reactor_Impl *impl)
+{
+  ACE_Reactor reactor (impl, true);
+
+  ACE_Pipe pipe;
+  if (pipe.open () == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("pipe")), 1);
+
+  Handler handler (pipe.read_handle ());
+
+  if (reactor.register_handler (&handler,
+                                ACE_Event_Handler::READ_MASK) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%C: %p\n"),
+                       name, ACE_TEXT ("register_handler")),
+                      1);
+
+  reactor.schedule_timer (&handler, 0, ACE_Time_Value::zero);
+
+  for (int i = 0; i < NOTIFICATIONS; ++i)
+    reactor.notify (&handler, ACE_Event_Handler::READ_MASK);
+
+  char c = 'x';
+  ACE_OS::write (pipe.write_handle (), &c, 1);
+
+  for (int i = 0; i < 20 && !handler.done (); ++i)
+    {
+      ACE_Time_Value tv (1);
+      reactor.handle_events (tv);
+    }
+
+  reactor.remove_handler (&handler,
+                          ACE_Event_Handler::ALL_EVENTS_MASK
+                          | ACE_Event_Handler::DONT_CALL);
+  reactor.cancel_timer (&handler);
+  pipe.close ();
+
+  if (!handler.done ())
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%C: %d inputs, %d timeouts, ")
+                       ACE_TEXT ("%d notifications\n"),
+                       name,
+                       handler.inputs_,
+                       handler.timeouts_,
+                       handler.notifications_),
+                      1);
+  return 0;
+}
+
+static int
+test_reactor (const char *name, ACE_Reactor_Impl *impl)
+{
+  int errors = 0;
+
+  ACE_Reactor_Instrumentation instrumentation (name);
+  instrumentation.slow_upcall_threshold (ACE_Time_Value (0, 10000));
+
+  if (ACE_Select_Reactor_Impl *sr =
+        dynamic_cast<ACE_Select_Reactor_Impl *> (impl))
+    sr->instrumentation (&instrumentation);
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+  else if (ACE_Dev_Poll_Reactor *dp =
+             dynamic_cast<ACE_Dev_Poll_Reactor *> (impl))
+    dp->instrumentation (&instrumentation);
+#endif /* ACE_HAS_EVENT_POLL || ACE_HAS_DEV_POLL */
+
+  errors += run_reactor (name, impl);
+
+  errors += check_histogram ("WaitTime", instrumentation.wait_time (), 1);
+  errors += check_histogram (
+    "Upcall/Input",
+    instrumentation.upcall_time (ACE_Reactor_Instrumentation::INPUT),
+    1);
+  errors += check_histogram (
+    "Upcall/Timeout",
+    instrumentation.upcall_time (ACE_Reactor_Instrumentation::TIMEOUT),
+    1);
+  errors += check_histogram (
+    "Upcall/Notify",
+    instrumentation.upcall_time (ACE_Reactor_Instrumentation::NOTIFY),
+    NOTIFICATIONS);
+  errors += check_histogram ("TimerLateness",
+                             instrumentation.timer_lateness (),
+                             1);
+
+  // The input upcall sleeps longer than the slow upcall threshold.
+  if (instrumentation.upcall_time (ACE_Reactor_Instrumentation::INPUT)
+        ->sum () < 10000)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%C: input upcall took less than 10 msec\n"),
+                  name));
+      ++errors;
+    }
+
+  if (instrumentation.notify_queue_depth ()->last_sample () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%C: %f notifications left in the queue\n"),
+                  name,
+                  instrumentation.notify_queue_depth ()->last_sample ()));
+      ++errors;
+    }
+
+  ACE::Monitor_Control::Monitor_Control_Types::NameList slow =
+    instrumentation.slow_upcalls ()->get_list ();
+  if (slow.size () == 0)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("%C: no slow upcall\n"), name));
+      ++errors;
+    }
+  for (size_t i = 0; i < slow.size (); ++i)
+    ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("%C: slow %C\n"), name, slow[i].c_str ()));
+
+  // The monitor points can be found by name, and publish their counts
+  // when they are updated.
+  ACE_CString wait_name (name);
+  wait_name += "/WaitTime";
+  Monitor_Base *wait = Monitor_Point_Registry::instance ()->get (wait_name);
+  if (wait == 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%C not registered\n"),
+                  wait_name.c_str ()));
+      ++errors;
+    }
+  else
+    {
+      wait->update ();
+      ACE::Monitor_Control::Monitor_Control_Types::NameList list =
+        wait->get_list ();
+      if (list.size () < 3 || list[0].find ("samples: ") != 0)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("%C: unexpected list of %B entries\n"),
+                      wait_name.c_str (),
+                      list.size ()));
+          ++errors;
+        }
+      wait->remove_ref ();
+    }
+
+  return errors;
+}
+
+static int
+test_buckets (void)
+{
+  int errors = 0;
+
+  struct { ACE_UINT64 sample; size_t bucket; } const expected[] =
+    {
+      { 0, 0 },
+      { 1, 1 },
+      { 2, 2 },
+      { 3, 2 },
+      { 4, 3 },
+      { 1000, 10 },
+      { 1024, 11 },
+      { (ACE_UINT64 (1) << 30) - 1, 30 },
+      { ACE_UINT64 (1) << 30, Histogram_Monitor::BUCKETS - 1 },
+      { ACE_UINT64 (1) << 40, Histogram_Monitor::BUCKETS - 1 }
+    };
+
+  for (size_t i = 0; i < sizeof expected / sizeof expected[0]; ++i)
+    {
+      size_t const bucket =
+        Histogram_Monitor::bucket_index (expected[i].sample);
+      if (bucket != expected[i].bucket)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("sample %Q in bucket %B, expected %B\n"),
+                      expected[i].sample,
+                      bucket,
+                      expected[i].bucket));
+          ++errors;
+        }
+    }
+
+  return errors;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Reactor_Instrumentation_Test"));
+
+  int errors = test_buckets ();
+
+  errors += test_reactor ("Select_Reactor", new ACE_Select_Reactor);
+  errors += test_reactor ("TP_Reactor", new ACE_TP_Reactor);
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+  errors += test_reactor ("Dev_Poll_Reactor", new ACE_Dev_Poll_Reactor);
+#endif /* ACE_HAS_EVENT_POLL || ACE_HAS_DEV_POLL */
+
+  ACE_END_TEST;
+  return errors;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Reactor_Instrumentation_Test"));
+
+  ACE_DEBUG ((LM_INFO,
+              ACE_TEXT ("Reactor instrumentation requires ")
+              ACE_TEXT ("ACE_HAS_MONITOR_POINTS\n")));
+
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif /* ACE_HAS_MONITOR_POINTS==1 */
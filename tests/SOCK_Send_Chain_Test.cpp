@@ -0,0 +1,315 @@
+//=============================================================================
+/**
+ *  @file    SOCK_Send_Chain_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks ACE_SOCK_Stream::send_chain() and
+ *  ACE_SOCK_Zerocopy_Sender.  A chain of message blocks much larger
+ *  than the socket buffers is sent on a non-blocking socket, resuming
+ *  after each partial write, while the other end of the connection
+ *  reads and checks the data.  Every block must be released once its
+ *  data has gone out, and, for the zero-copy sender, once the kernel
+ *  has reported that it is done with it.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/SOCK_Acceptor.h"
+#include "ace/SOCK_Connector.h"
+#include "ace/SOCK_Stream.h"
+#include "ace/SOCK_Zerocopy_Sender.h"
+#include "ace/INET_Addr.h"
+#include "ace/Message_Block.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_unistd.h"
+
+static const size_t block_count = 256;
+static const size_t block_size = 16 * 1024;
+
+/**
+ * @class Chain
+ *
+ * A chain of message blocks holding a known pattern, some of them
+ * empty, and a reference of our own to the data of each block to
+ * tell when the chain has let go of it.
+ */
+class Chain
+{
+public:
+  Chain (void) : head_ (0), total_ (0)
+  {
+    ACE_Message_Block *last = 0;
+    for (size_t i = 0; i < block_count; ++i)
+      {
+        size_t const size = i % 17 == 5 ? 0 : block_size - i;
+        ACE_Message_Block *mb = new ACE_Message_Block (size);
+        for (size_t j = 0; j < size; ++j)
+          mb->wr_ptr ()[j] = pattern (this->total_ + j);
+        mb->wr_ptr (size);
+        this->total_ += size;
+        this->refs_[i] = mb->duplicate ();
+
+        if (last == 0)
+          this->head_ = mb;
+        else
+          last->cont (mb);
+        last = mb;
+      }
+  }
+
+  ~Chain (void)
+  {
+    if (this->head_ != 0)
+      this->head_->release ();
+    for (size_t i = 0; i < block_count; ++i)
+      this->refs_[i]->release ();
+  }
+
+  static char pattern (size_t offset)
+  {
+    return static_cast<char> (offset % 251);
+  }
+
+  /// Number of blocks still referenced other than by us.
+  size_t held (void) const
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < block_count; ++i)
+      if (this->refs_[i]->data_block ()->reference_count () > 1)
+        ++count;
+    return count;
+  }
+
+  ACE_Message_Block *head_;
+  size_t total_;
+  ACE_Message_Block *refs_[block_count];
+};
+
+/**
+ * @class Receiver
+ *
+ * Reads what is available on the receiving end and checks it.
+ */
+class Receiver
+{
+public:
+  Receiver (ACE_SOCK_Stream &stream)
+    : stream_ (stream), received_ (0), errors_ (0)
+  {
+  }
+
+  void drain (const ACE_Time_Value &timeout)
+  {
+    char buf[64 * 1024];
+    for (;;)
+      {
+        ssize_t const n = this->stream_.recv (buf, sizeof buf, &timeout);
+        if (n <= 0)
+          return;
+        for (ssize_t i = 0; i < n; ++i)
+          if (buf[i] != Chain::pattern (this->received_ + i))
+            ++this->errors_;
+        this->received_ += n;
+      }
+  }
+
+  ACE_SOCK_Stream &stream_;
+  size_t received_;
+  size_t errors_;
+};
+
+static int
+check (const ACE_TCHAR *name,
+       const Chain &chain,
+       const Receiver &receiver,
+       size_t partial_writes)
+{
+  int status = 0;
+  if (receiver.received_ != chain.total_ || receiver.errors_ != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: received %B bytes with %B errors, ")
+                  ACE_TEXT ("expected %B bytes\n"),
+                  name,
+                  receiver.received_,
+                  receiver.errors_,
+                  chain.total_));
+      status = -1;
+    }
+  if (chain.head_ != 0 || chain.held () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: %B blocks not released\n"),
+                  name,
+                  chain.held ()));
+      status = -1;
+    }
+  if (partial_writes == 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%s: the socket never filled up\n"),
+                  name));
+      status = -1;
+    }
+  if (status == 0)
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("%s: sent %B bytes, resumed %B times\n"),
+                name,
+                chain.total_,
+                partial_writes));
+  return status;
+}
+
+static int
+send_chain_test (ACE_SOCK_Stream &sender, ACE_SOCK_Stream &receiving)
+{
+  Chain chain;
+  Receiver receiver (receiving);
+  ACE_Time_Value const poll (0, 10000);
+  size_t partial_writes = 0;
+  int status = 0;
+
+  while (chain.head_ != 0)
+    {
+      if (sender.send_chain (chain.head_) != -1)
+        continue;
+      if (errno != EWOULDBLOCK)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("send_chain")),
+                          -1);
+
+      // The first time the socket is full, check the timeout.  A little
+      // room may still be left while the data is in flight.
+      if (partial_writes++ == 0)
+        {
+          ACE_Time_Value const timeout (0, 100000);
+          ssize_t result = 0;
+          for (int i = 0; i < 10 && result != -1 && chain.head_ != 0; ++i)
+            result = sender.send_chain (chain.head_, &timeout);
+          if (result != -1 || errno != ETIME)
+            {
+              ACE_ERROR ((LM_ERROR,
+                          ACE_TEXT ("send_chain on a full socket did not time out\n")));
+              status = -1;
+            }
+        }
+      receiver.drain (poll);
+    }
+  receiver.drain (poll);
+
+  if (check (ACE_TEXT ("send_chain"), chain, receiver, partial_writes) != 0)
+    status = -1;
+  return status;
+}
+
+static int
+zerocopy_test (ACE_SOCK_Stream &sender, ACE_SOCK_Stream &receiving)
+{
+  ACE_SOCK_Zerocopy_Sender zerocopy;
+  if (zerocopy.open (sender) == -1)
+    {
+      if (errno == ENOTSUP || errno == EOPNOTSUPP || errno == ENOPROTOOPT)
+        {
+          ACE_DEBUG ((LM_INFO,
+                      ACE_TEXT ("Zero-copy sends are not supported: %p\n"),
+                      ACE_TEXT ("open")));
+          return 0;
+        }
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("open")), -1);
+    }
+
+  Chain chain;
+  Receiver receiver (receiving);
+  ACE_Time_Value const poll (0, 10000);
+  size_t partial_writes = 0;
+  int status = 0;
+
+  while (chain.head_ != 0)
+    {
+      if (zerocopy.send_chain (chain.head_) != -1)
+        continue;
+      if (errno != EWOULDBLOCK && errno != ENOBUFS)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("send_chain")),
+                          -1);
+      ++partial_writes;
+      receiver.drain (poll);
+      if (zerocopy.handle_completions () == -1)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("handle_completions")),
+                          -1);
+    }
+  receiver.drain (poll);
+
+  // Wait for the last completions.
+  ACE_Time_Value const deadline =
+    ACE_OS::gettimeofday () + ACE_Time_Value (5);
+  while (zerocopy.pending () > 0 && ACE_OS::gettimeofday () < deadline)
+    {
+      if (zerocopy.handle_completions () == -1)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("handle_completions")),
+                          -1);
+      ACE_OS::sleep (poll);
+    }
+
+  if (zerocopy.pending () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B zero-copy sends did not complete\n"),
+                  zerocopy.pending ()));
+      status = -1;
+    }
+  else
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("The kernel copied %B of the zero-copy sends\n"),
+                zerocopy.copied ()));
+
+  if (check (ACE_TEXT ("Zero-copy send_chain"),
+             chain,
+             receiver,
+             partial_writes) != 0)
+    status = -1;
+  return status;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("SOCK_Send_Chain_Test"));
+
+  ACE_SOCK_Acceptor acceptor;
+  ACE_INET_Addr server_addr;
+  if (acceptor.open (ACE_sap_any_cast (const ACE_INET_Addr &)) == -1
+      || acceptor.get_local_addr (server_addr) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("acceptor")), 1);
+  server_addr.set (server_addr.get_port_number (), ACE_LOCALHOST);
+
+  ACE_SOCK_Stream sender;
+  ACE_SOCK_Stream receiving;
+  ACE_SOCK_Connector connector;
+  if (connector.connect (sender, server_addr) == -1
+      || acceptor.accept (receiving) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("connect")), 1);
+  sender.enable (ACE_NONBLOCK);
+
+  // Keep the socket buffers small for the chain to fill them up.
+  int size = 64 * 1024;
+  sender.set_option (SOL_SOCKET, SO_SNDBUF, &size, sizeof size);
+  receiving.set_option (SOL_SOCKET, SO_RCVBUF, &size, sizeof size);
+
+  int status = 0;
+  if (send_chain_test (sender, receiving) != 0)
+    status = 1;
+  if (zerocopy_test (sender, receiving) != 0)
+    status = 1;
+
+  sender.close ();
+  receiving.close ();
+  acceptor.close ();
+
+  ACE_END_TEST;
+  return status;
+}
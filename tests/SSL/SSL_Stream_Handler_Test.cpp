@@ -0,0 +1,304 @@
+
+//=============================================================================
+/**
+ *  @file    SSL_Stream_Handler_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test runs both ends of a TLS connection on one thread with
+ *  ACE_SSL_Stream_Handler, on the ACE_Dev_Poll_Reactor where it is
+ *  available.  The client sends a megabyte with one send(), which the
+ *  socket cannot take at once, then a file with sendfile(), and the
+ *  server echoes everything back.  The client checks the echo and
+ *  shuts the connection down.  This is done once with kernel TLS
+ *  asked for and once without; kernel TLS is only used where OpenSSL
+ *  and the kernel support it.
+ */
+//=============================================================================
+
+#include "../test_config.h"
+#include "ace/SSL/SSL_Stream_Handler.h"
+#include "ace/SOCK_Acceptor.h"
+#include "ace/SOCK_Connector.h"
+#include "ace/INET_Addr.h"
+#include "ace/Reactor.h"
+#include "ace/Select_Reactor.h"
+#include "ace/Dev_Poll_Reactor.h"
+#include "ace/OS_NS_fcntl.h"
+#include "ace/OS_NS_stdlib.h"
+#include "ace/OS_NS_string.h"
+#include "ace/OS_NS_unistd.h"
+
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+typedef ACE_Dev_Poll_Reactor Reactor_Impl;
+#else
+typedef ACE_Select_Reactor Reactor_Impl;
+#endif /* ACE_HAS_EVENT_POLL || ACE_HAS_DEV_POLL */
+
+static const size_t SEND_SIZE = 1024 * 1024;
+static const size_t FILE_SIZE = 256 * 1024 + 123;
+static const size_t TOTAL = SEND_SIZE + FILE_SIZE;
+
+static const ACE_TCHAR FILE_NAME[] = ACE_TEXT ("SSL_Stream_Handler_Test.tmp");
+
+// What the client sends: the first SEND_SIZE bytes with send(), the
+// rest from the file.
+static char *expected = 0;
+
+// Echoes what it receives, and deletes itself once closed.
+class Server_Handler : public ACE_SSL_Stream_Handler
+{
+public:
+  Server_Handler (ACE_Reactor *reactor, bool &closed)
+    : ACE_SSL_Stream_Handler (reactor),
+      closed_ (closed)
+  {
+  }
+
+  virtual int handle_close (ACE_HANDLE handle, ACE_Reactor_Mask mask)
+  {
+    this->ACE_SSL_Stream_Handler::handle_close (handle, mask);
+    this->closed_ = true;
+    delete this;
+    return 0;
+  }
+
+protected:
+  virtual int handle_data (const char *data, size_t n)
+  {
+    return this->send (data, n) == -1 ? -1 : 0;
+  }
+
+private:
+  bool &closed_;
+};
+
+class Client_Handler : public ACE_SSL_Stream_Handler
+{
+public:
+  Client_Handler (ACE_Reactor *reactor)
+    : ACE_SSL_Stream_Handler (reactor),
+      file_ (ACE_INVALID_HANDLE),
+      offset_ (0),
+      received_ (0),
+      errors_ (0),
+      closed_ (false)
+  {
+  }
+
+  virtual ~Client_Handler (void)
+  {
+    if (this->file_ != ACE_INVALID_HANDLE)
+      ACE_OS::close (this->file_);
+  }
+
+  size_t received (void) const { return this->received_; }
+  int errors (void) const { return this->errors_; }
+  bool closed (void) const { return this->closed_; }
+
+  virtual int handle_close (ACE_HANDLE handle, ACE_Reactor_Mask mask)
+  {
+    this->closed_ = true;
+    return this->ACE_SSL_Stream_Handler::handle_close (handle, mask);
+  }
+
+protected:
+  virtual int handle_handshake (void)
+  {
+    ACE_DEBUG ((LM_DEBUG,
+                ACE_TEXT ("(%t) client connected, kernel TLS send %d")
+                ACE_TEXT (" receive %d\n"),
+                this->ktls_send (),
+                this->ktls_recv ()));
+
+    this->file_ = ACE_OS::open (FILE_NAME, O_RDONLY);
+    if (this->file_ == ACE_INVALID_HANDLE)
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), FILE_NAME), -1);
+
+    if (this->send (expected, SEND_SIZE) != static_cast<ssize_t> (SEND_SIZE))
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("send")), -1);
+
+    if (this->pending () == 0)
+      {
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("the socket took a megabyte at once\n")));
+        ++this->errors_;
+      }
+
+    return this->send_file ();
+  }
+
+  virtual int handle_drained (void)
+  {
+    return this->send_file ();
+  }
+
+  virtual int handle_data (const char *data, size_t n)
+  {
+    if (this->received_ + n > TOTAL
+        || ACE_OS::memcmp (data, expected + this->received_, n) != 0)
+      {
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("echo differs after %B bytes\n"),
+                    this->received_));
+        ++this->errors_;
+        return -1;
+      }
+
+    this->received_ += n;
+    if (this->received_ == TOTAL)
+      this->shutdown ();
+    return 0;
+  }
+
+private:
+  // Send the file until the socket is full.
+  int send_file (void)
+  {
+    while (this->offset_ < static_cast<off_t> (FILE_SIZE))
+      {
+        ssize_t const n = this->sendfile (this->file_,
+                                          &this->offset_,
+                                          FILE_SIZE - this->offset_);
+        if (n == -1 && errno == EWOULDBLOCK)
+          return 0;
+        if (n <= 0)
+          ACE_ERROR_RETURN ((LM_ERROR,
+                             ACE_TEXT ("%p\n"),
+                             ACE_TEXT ("sendfile")),
+                            -1);
+      }
+    return 0;
+  }
+
+  ACE_HANDLE file_;
+  off_t offset_;
+  size_t received_;
+  int errors_;
+  bool closed_;
+};
+
+static int
+run_connection (bool ktls)
+{
+  Reactor_Impl impl;
+  ACE_Reactor reactor (&impl);
+
+  ACE_SOCK_Acceptor acceptor;
+  ACE_INET_Addr addr (u_short (0), ACE_LOCALHOST);
+  if (acceptor.open (addr, 1) == -1 || acceptor.get_local_addr (addr) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("listen")), 1);
+
+  ACE_SOCK_Stream client_stream;
+  ACE_SOCK_Stream server_stream;
+  ACE_SOCK_Connector connector;
+  if (connector.connect (client_stream, addr) == -1
+      || acceptor.accept (server_stream) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("connect")), 1);
+  acceptor.close ();
+
+  // Small socket buffers, so that the handlers must queue and wait
+  // for the sockets.
+  int size = 32 * 1024;
+  client_stream.set_option (SOL_SOCKET, SO_SNDBUF, &size, sizeof size);
+  client_stream.set_option (SOL_SOCKET, SO_RCVBUF, &size, sizeof size);
+  server_stream.set_option (SOL_SOCKET, SO_SNDBUF, &size, sizeof size);
+  server_stream.set_option (SOL_SOCKET, SO_RCVBUF, &size, sizeof size);
+
+  bool server_closed = false;
+  Server_Handler *server = 0;
+  ACE_NEW_RETURN (server, Server_Handler (&reactor, server_closed), 1);
+  Client_Handler client (&reactor);
+
+  server->ktls (ktls);
+  client.ktls (ktls);
+
+  if (server->open (server_stream.get_handle (), true) == -1)
+    {
+      delete server;
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("open")), 1);
+    }
+  if (client.open (client_stream.get_handle (), false) == -1)
+    {
+      server->handle_close (ACE_INVALID_HANDLE,
+                            ACE_Event_Handler::ALL_EVENTS_MASK);
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("open")), 1);
+    }
+
+  ACE_Time_Value timeout (60);
+  while (!(client.closed () && server_closed)
+         && timeout > ACE_Time_Value::zero)
+    if (reactor.handle_events (timeout) == -1)
+      break;
+
+  int errors = client.errors ();
+
+  if (client.received () != TOTAL || !client.closed () || !server_closed)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("received %B of %B bytes, client %s,")
+                  ACE_TEXT (" server %s\n"),
+                  client.received (),
+                  TOTAL,
+                  client.closed () ? ACE_TEXT ("closed") : ACE_TEXT ("open"),
+                  server_closed ? ACE_TEXT ("closed") : ACE_TEXT ("open")));
+      ++errors;
+    }
+
+  // Close whatever the timeout left open before the reactor goes.
+  if (!server_closed)
+    server->handle_close (ACE_INVALID_HANDLE,
+                          ACE_Event_Handler::ALL_EVENTS_MASK);
+  if (!client.closed ())
+    client.handle_close (ACE_INVALID_HANDLE,
+                         ACE_Event_Handler::ALL_EVENTS_MASK);
+
+  return errors;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("SSL_Stream_Handler_Test"));
+
+  ACE_SSL_Context *context = ACE_SSL_Context::instance ();
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+  // The test certificate is signed with MD5.
+  ::SSL_CTX_set_security_level (context->context (), 0);
+#endif /* OPENSSL_VERSION_NUMBER >= 0x10100000L */
+  // Note - the next two strings are naked on purpose... the arguments to
+  // the ACE_SSL_Context methods are const char *, not ACE_TCHAR *.
+  context->certificate ("dummy.pem", SSL_FILETYPE_PEM);
+  context->private_key ("key.pem", SSL_FILETYPE_PEM);
+
+  int errors = 0;
+
+  ACE_NEW_RETURN (expected, char[TOTAL], 1);
+  for (size_t i = 0; i < TOTAL; ++i)
+    expected[i] = static_cast<char> (ACE_OS::rand ());
+
+  ACE_HANDLE const file = ACE_OS::open (FILE_NAME,
+                                        O_RDWR | O_CREAT | O_TRUNC,
+                                        ACE_DEFAULT_FILE_PERMS);
+  if (file == ACE_INVALID_HANDLE
+      || ACE_OS::write (file, expected + SEND_SIZE, FILE_SIZE)
+         != static_cast<ssize_t> (FILE_SIZE))
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), FILE_NAME));
+      ++errors;
+    }
+  if (file != ACE_INVALID_HANDLE)
+    ACE_OS::close (file);
+
+  if (errors == 0)
+    {
+      errors += run_connection (false);
+      errors += run_connection (true);
+    }
+
+  ACE_OS::unlink (FILE_NAME);
+  delete [] expected;
+
+  ACE_END_TEST;
+  return errors;
+}
@@ -0,0 +1,219 @@
+
+//=============================================================================
+/**
+ *  @file    Sharded_Monitor_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that the counts of Sharded_Counter_Monitor and
+ *  Sharded_Gauge_Monitor updated by several threads add up, and that
+ *  Monitor_Point_Registry lookups made at the same time as monitor
+ *  points are added and removed find the ones that stay registered.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Monitor_Sharded.h"
+
+#if defined (ACE_HAS_MONITOR_FRAMEWORK) && (ACE_HAS_MONITOR_FRAMEWORK == 1)
+
+#include "ace/Monitor_Point_Registry.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Atomic_Op.h"
+#include "ace/OS_NS_stdio.h"
+
+using ACE::Monitor_Control::Monitor_Base;
+using ACE::Monitor_Control::Monitor_Point_Registry;
+using ACE::Monitor_Control::Sharded_Counter_Monitor;
+using ACE::Monitor_Control::Sharded_Gauge_Monitor;
+
+static const int THREADS = 4;
+static const int ITERATIONS = 100000;
+static const int CHURN = 200;
+
+static Sharded_Counter_Monitor *counter = 0;
+static Sharded_Gauge_Monitor *gauge = 0;
+
+/// Set once the churn thread is done.
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> churn_done (0);
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> lookup_errors (0);
+
+static ACE_THR_FUNC_RETURN
+update (void *)
+{
+  for (int i = 0; i < ITERATIONS; ++i)
+    {
+      counter->increment ();
+      gauge->add (2);
+      gauge->add (-1);
+    }
+  return 0;
+}
+
+static ACE_THR_FUNC_RETURN
+lookup (void *)
+{
+  while (churn_done.value () == 0)
+    {
+      Monitor_Base *mp =
+        Monitor_Point_Registry::instance ()->get ("Test/Counter");
+      if (mp != counter)
+        ++lookup_errors;
+      if (mp != 0)
+        mp->remove_ref ();
+    }
+  return 0;
+}
+
+static ACE_THR_FUNC_RETURN
+churn (void *)
+{
+  for (int i = 0; i < CHURN; ++i)
+    {
+      char name[32];
+      ACE_OS::sprintf (name, "Test/Churn/%d", i);
+
+      Sharded_Gauge_Monitor *mp = 0;
+      ACE_NEW_RETURN (mp, Sharded_Gauge_Monitor (name), 0);
+
+      Monitor_Point_Registry::instance ()->add (mp);
+      Monitor_Point_Registry::instance ()->remove (name);
+      mp->remove_ref ();
+    }
+
+  churn_done = 1;
+  return 0;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Sharded_Monitor_Test"));
+
+  int errors = 0;
+
+  ACE_NEW_RETURN (counter, Sharded_Counter_Monitor ("Test/Counter"), -1);
+  ACE_NEW_RETURN (gauge, Sharded_Gauge_Monitor ("Test/Gauge"), -1);
+
+  Monitor_Point_Registry::instance ()->add (counter);
+  Monitor_Point_Registry::instance ()->add (gauge);
+
+#if defined (ACE_HAS_THREADS)
+  ACE_Thread_Manager *tm = ACE_Thread_Manager::instance ();
+
+  if (tm->spawn_n (THREADS, update) == -1
+      || tm->spawn_n (2, lookup) == -1
+      || tm->spawn (churn) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn")), -1);
+
+  tm->wait ();
+  int const updaters = THREADS;
+#else
+  churn (0);
+  update (0);
+  int const updaters = 1;
+#endif /* ACE_HAS_THREADS */
+
+  if (lookup_errors.value () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%d lookups did not find Test/Counter\n"),
+                  lookup_errors.value ()));
+      ++errors;
+    }
+
+  ACE_UINT64 const expected = updaters * ITERATIONS;
+
+  if (counter->value () != expected)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("counter is %Q, expected %Q\n"),
+                  counter->value (),
+                  expected));
+      ++errors;
+    }
+
+  if (gauge->value () != static_cast<ACE_INT64> (expected))
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("gauge is %q, expected %Q\n"),
+                  gauge->value (),
+                  expected));
+      ++errors;
+    }
+
+  // update() publishes the values read from the shards.
+  counter->update ();
+  gauge->update ();
+  gauge->add (-10);
+  gauge->update ();
+
+  if (counter->count () != expected)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("counter count is %B after update\n"),
+                  counter->count ()));
+      ++errors;
+    }
+
+  if (gauge->last_sample () != static_cast<double> (expected) - 10
+      || gauge->maximum_sample () != static_cast<double> (expected)
+      || gauge->count () != 2)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("gauge samples are wrong: last %f, max %f, ")
+                  ACE_TEXT ("count %B\n"),
+                  gauge->last_sample (),
+                  gauge->maximum_sample (),
+                  gauge->count ()));
+      ++errors;
+    }
+
+  counter->clear ();
+  if (counter->value () != 0 || counter->count () != 0)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("counter not cleared\n")));
+      ++errors;
+    }
+
+  ACE::Monitor_Control::Monitor_Control_Types::NameList names =
+    Monitor_Point_Registry::instance ()->names ();
+  for (size_t i = 0; i < names.size (); ++i)
+    if (names[i].find ("Test/Churn/") == 0)
+      {
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("%C still registered\n"),
+                    names[i].c_str ()));
+        ++errors;
+      }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%B monitor points registered, %B shards\n"),
+              names.size (),
+              ACE::Monitor_Control::Monitor_Shards ().size ()));
+
+  Monitor_Point_Registry::instance ()->remove ("Test/Counter");
+  Monitor_Point_Registry::instance ()->remove ("Test/Gauge");
+  counter->remove_ref ();
+  gauge->remove_ref ();
+
+  ACE_END_TEST;
+  return errors;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Sharded_Monitor_Test"));
+
+  ACE_DEBUG ((LM_INFO,
+              ACE_TEXT ("Sharded monitors require ")
+              ACE_TEXT ("ACE_HAS_MONITOR_FRAMEWORK\n")));
+
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif /* ACE_HAS_MONITOR_FRAMEWORK==1 */
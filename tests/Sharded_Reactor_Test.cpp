@@ -0,0 +1,550 @@
+
+//=============================================================================
+/**
+ *  @file    Sharded_Reactor_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks that an ACE_Sharded_Reactor keeps every handler on
+ *  the shard of the thread that registered it: I/O, accepts on
+ *  per-shard @c SO_REUSEPORT acceptors sharing one address, timers
+ *  and notifications must all be dispatched by that thread only.  It
+ *  also checks that timer ids handed out by the sharded reactor can be
+ *  cancelled from any thread, and that with fewer event loop threads
+ *  than shards no handler is placed on a shard no thread runs.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Reactor.h"
+#include "ace/Sharded_Reactor.h"
+#include "ace/Pipe.h"
+#include "ace/ACE.h"
+#include "ace/Atomic_Op.h"
+#include "ace/Barrier.h"
+#include "ace/INET_Addr.h"
+#include "ace/SOCK_Acceptor.h"
+#include "ace/SOCK_Connector.h"
+#include "ace/SOCK_Stream.h"
+#include "ace/Thread_Manager.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_Thread.h"
+#include "ace/OS_NS_errno.h"
+
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+
+static const size_t shard_count = 3;
+static const int connection_count = 12;
+
+// Upcalls still expected; the workers run until it drops to 0.
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> outstanding (0);
+
+// Upcalls made by a thread other than the handler's owner.
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> stray_upcalls (0);
+
+class Shard_Handler : public ACE_Event_Handler
+{
+public:
+  Shard_Handler (void);
+
+  virtual ~Shard_Handler (void);
+
+  virtual int handle_input (ACE_HANDLE fd);
+
+  virtual int handle_timeout (const ACE_Time_Value &, const void *);
+
+  virtual int handle_exception (ACE_HANDLE);
+
+  virtual ACE_HANDLE get_handle (void) const;
+
+  /// Note the upcall and check it is made by the owner thread.
+  void upcall (const ACE_TCHAR *what);
+
+  ACE_Pipe pipe_;
+
+  /// Set if the handler accepts connections rather than reading.
+  ACE_SOCK_Acceptor *acceptor_;
+
+  /// Thread the handler was registered from.
+  ACE_thread_t owner_;
+
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> inputs_;
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> timeouts_;
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> notifications_;
+};
+
+Shard_Handler::Shard_Handler (void)
+  : acceptor_ (0),
+    owner_ (ACE_OS::NULL_thread),
+    inputs_ (0),
+    timeouts_ (0),
+    notifications_ (0)
+{
+}
+
+Shard_Handler::~Shard_Handler (void)
+{
+  this->pipe_.close ();
+}
+
+ACE_HANDLE
+Shard_Handler::get_handle (void) const
+{
+  return this->acceptor_ != 0
+    ? this->acceptor_->get_handle ()
+    : this->pipe_.read_handle ();
+}
+
+void
+Shard_Handler::upcall (const ACE_TCHAR *what)
+{
+  if (!ACE_OS::thr_equal (ACE_OS::thr_self (), this->owner_))
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("(%t) %s upcall for handle %d made ")
+                  ACE_TEXT ("outside its shard\n"),
+                  what,
+                  this->get_handle ()));
+      ++stray_upcalls;
+    }
+  --outstanding;
+}
+
+int
+Shard_Handler::handle_input (ACE_HANDLE fd)
+{
+  if (this->acceptor_ != 0)
+    {
+      ACE_SOCK_Stream stream;
+      if (this->acceptor_->accept (stream) == -1)
+        {
+          // Another acceptor may have taken the connection.
+          if (errno == EWOULDBLOCK)
+            return 0;
+          ACE_ERROR_RETURN ((LM_ERROR,
+                             ACE_TEXT ("(%t) %p\n"),
+                             ACE_TEXT ("accept")),
+                            0);
+        }
+      stream.close ();
+    }
+  else
+    {
+      char c;
+      if (ACE::recv (fd, &c, 1) != 1)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("(%t) %p\n"),
+                           ACE_TEXT ("recv")),
+                          0);
+    }
+
+  ++this->inputs_;
+  this->upcall (ACE_TEXT ("input"));
+  return 0;
+}
+
+int
+Shard_Handler::handle_timeout (const ACE_Time_Value &, const void *)
+{
+  ++this->timeouts_;
+  this->upcall (ACE_TEXT ("timeout"));
+  return 0;
+}
+
+int
+Shard_Handler::handle_exception (ACE_HANDLE)
+{
+  ++this->notifications_;
+  this->upcall (ACE_TEXT ("notify"));
+  return 0;
+}
+
+struct Shard_Args
+{
+  ACE_Reactor *reactor;
+  ACE_Sharded_Reactor *sharded;
+  ACE_Barrier *barrier;
+  Shard_Handler *pipe_handlers;
+  Shard_Handler *accept_handlers;
+  Shard_Handler *timer_handlers;
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> next_shard;
+};
+
+static ACE_THR_FUNC_RETURN
+worker (void *p)
+{
+  Shard_Args *args = static_cast<Shard_Args *> (p);
+  size_t const n = static_cast<size_t> (args->next_shard++);
+
+  if (args->sharded->bind_thread (n) != 0
+      || args->sharded->thread_shard () != static_cast<int> (n))
+    ACE_ERROR ((LM_ERROR,
+                ACE_TEXT ("(%t) could not bind to shard %B\n"),
+                n));
+
+  Shard_Handler *handlers[] =
+    {
+      &args->pipe_handlers[n], &args->accept_handlers[n]
+    };
+
+  for (size_t i = 0; i < 2; ++i)
+    {
+      handlers[i]->owner_ = ACE_OS::thr_self ();
+      if (args->reactor->register_handler (handlers[i],
+                                           ACE_Event_Handler::READ_MASK) != 0)
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("(%t) %p\n"),
+                    ACE_TEXT ("register_handler")));
+      else if (args->sharded->handle_shard (handlers[i]->get_handle ())
+               != static_cast<int> (n))
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("(%t) handle %d not placed on shard %B\n"),
+                    handlers[i]->get_handle (),
+                    n));
+    }
+
+  // A handler without a handle has its timers on the calling
+  // thread's shard.
+  args->timer_handlers[n].owner_ = ACE_OS::thr_self ();
+  if (args->reactor->schedule_timer (&args->timer_handlers[n],
+                                     0,
+                                     ACE_Time_Value (0, 50000)) == -1)
+    ACE_ERROR ((LM_ERROR,
+                ACE_TEXT ("(%t) %p\n"),
+                ACE_TEXT ("schedule_timer")));
+
+  args->barrier->wait ();
+
+  ACE_Time_Value const deadline =
+    ACE_OS::gettimeofday () + ACE_Time_Value (10);
+
+  while (outstanding.value () > 0 && ACE_OS::gettimeofday () < deadline)
+    {
+      ACE_Time_Value tv (0, 50000);
+      if (args->reactor->handle_events (tv) == -1)
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("(%t) %p\n"),
+                    ACE_TEXT ("handle_events")));
+    }
+
+  return 0;
+}
+
+static int
+test_sharded_reactor (void)
+{
+  int status = 0;
+
+  ACE_Sharded_Reactor sharded (shard_count);
+  ACE_Reactor reactor (&sharded);
+
+  if (sharded.shard_count () != shard_count
+      || sharded.shard (shard_count) != 0
+      || sharded.bind_thread (shard_count) != -1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("Bad shard bookkeeping\n")));
+      status = 1;
+    }
+
+  Shard_Handler pipe_handlers[shard_count];
+  Shard_Handler accept_handlers[shard_count];
+  Shard_Handler timer_handlers[shard_count];
+  ACE_SOCK_Acceptor acceptors[shard_count];
+
+  // One acceptor per shard, all listening on the same address.
+  ACE_INET_Addr listen_addr (static_cast<u_short> (0),
+                             ACE_LOCALHOST,
+                             PF_INET);
+  for (size_t i = 0; i < shard_count; ++i)
+    {
+      if (acceptors[i].open (listen_addr, 1, PF_INET,
+                             ACE_DEFAULT_BACKLOG, 0, 1) != 0)
+        {
+          if (errno == ENOTSUP)
+            ACE_ERROR_RETURN ((LM_INFO,
+                               ACE_TEXT ("SO_REUSEPORT is not supported ")
+                               ACE_TEXT ("on this platform\n")),
+                              0);
+          ACE_ERROR_RETURN ((LM_ERROR,
+                             ACE_TEXT ("%p\n"),
+                             ACE_TEXT ("acceptor open")),
+                            1);
+        }
+      acceptors[i].enable (ACE_NONBLOCK);
+      if (i == 0)
+        acceptors[i].get_local_addr (listen_addr);
+
+      accept_handlers[i].acceptor_ = &acceptors[i];
+
+      if (pipe_handlers[i].pipe_.open () != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%p\n"),
+                           ACE_TEXT ("pipe")),
+                          1);
+    }
+
+  // A pipe read, a timeout and a notification per shard, plus the
+  // connections.
+  outstanding = 3 * static_cast<long> (shard_count) + connection_count;
+
+  ACE_Barrier barrier (shard_count + 1);
+  Shard_Args args;
+  args.reactor = &reactor;
+  args.sharded = &sharded;
+  args.barrier = &barrier;
+  args.pipe_handlers = pipe_handlers;
+  args.accept_handlers = accept_handlers;
+  args.timer_handlers = timer_handlers;
+  args.next_shard = 0;
+
+  ACE_Thread_Manager::instance ()->spawn_n (shard_count, worker, &args);
+  barrier.wait ();
+
+  // A long timer cancelled by its id from a thread that's on no shard.
+  long const timer_id =
+    reactor.schedule_timer (&accept_handlers[shard_count - 1],
+                            0,
+                            ACE_Time_Value (60));
+  if (timer_id == -1 || reactor.cancel_timer (timer_id) != 1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("Could not cancel timer by id\n")));
+      status = 1;
+    }
+
+  for (size_t i = 0; i < shard_count; ++i)
+    {
+      ACE::send_n (pipe_handlers[i].pipe_.write_handle (), "x", 1);
+      reactor.notify (&pipe_handlers[i]);
+    }
+
+  ACE_SOCK_Connector connector;
+  for (int i = 0; i < connection_count; ++i)
+    {
+      ACE_SOCK_Stream client;
+      if (connector.connect (client, listen_addr) == -1)
+        {
+          ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("connect")));
+          --outstanding;
+          status = 1;
+        }
+      client.close ();
+    }
+
+  ACE_Thread_Manager::instance ()->wait ();
+
+  long accepted = 0;
+  for (size_t i = 0; i < shard_count; ++i)
+    {
+      if (pipe_handlers[i].inputs_.value () != 1
+          || pipe_handlers[i].notifications_.value () != 1
+          || timer_handlers[i].timeouts_.value () != 1)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("Shard %B: %d inputs, %d notifications, ")
+                      ACE_TEXT ("%d timeouts; expected 1 each\n"),
+                      i,
+                      static_cast<int> (pipe_handlers[i].inputs_.value ()),
+                      static_cast<int> (pipe_handlers[i].notifications_.value ()),
+                      static_cast<int> (timer_handlers[i].timeouts_.value ())));
+          status = 1;
+        }
+
+      ACE_DEBUG ((LM_DEBUG,
+                  ACE_TEXT ("Shard %B accepted %d connections\n"),
+                  i,
+                  static_cast<int> (accept_handlers[i].inputs_.value ())));
+      accepted += accept_handlers[i].inputs_.value ();
+    }
+
+  if (accepted != connection_count)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%d connections accepted; expected %d\n"),
+                  static_cast<int> (accepted),
+                  connection_count));
+      status = 1;
+    }
+
+  if (stray_upcalls.value () != 0)
+    status = 1;
+
+  for (size_t i = 0; i < shard_count; ++i)
+    {
+      reactor.remove_handler (&pipe_handlers[i],
+                              ACE_Event_Handler::ALL_EVENTS_MASK
+                              | ACE_Event_Handler::DONT_CALL);
+      reactor.remove_handler (&accept_handlers[i],
+                              ACE_Event_Handler::ALL_EVENTS_MASK
+                              | ACE_Event_Handler::DONT_CALL);
+      acceptors[i].close ();
+    }
+
+  return status;
+}
+
+struct Lone_Args
+{
+  ACE_Reactor *reactor;
+  ACE_Sharded_Reactor *sharded;
+  ACE_Barrier *barrier;
+  ACE_thread_t thread;
+  int shard;
+};
+
+// The only event loop thread of a reactor with more shards.
+static ACE_THR_FUNC_RETURN
+lone_worker (void *p)
+{
+  Lone_Args *args = static_cast<Lone_Args *> (p);
+
+  // The first event loop call binds the thread to a shard.
+  ACE_Time_Value tv (ACE_Time_Value::zero);
+  args->reactor->handle_events (tv);
+  args->thread = ACE_OS::thr_self ();
+  args->shard = args->sharded->thread_shard ();
+
+  args->barrier->wait ();
+
+  ACE_Time_Value const deadline =
+    ACE_OS::gettimeofday () + ACE_Time_Value (10);
+
+  while (outstanding.value () > 0 && ACE_OS::gettimeofday () < deadline)
+    {
+      ACE_Time_Value tv (0, 50000);
+      args->reactor->handle_events (tv);
+    }
+
+  return 0;
+}
+
+// With fewer event loop threads than shards, handles registered by
+// threads bound to no shard, before and after the event loop thread
+// started, must all land on the shard that thread runs.
+static int
+test_fewer_threads (void)
+{
+  int status = 0;
+  size_t const shards = 4;
+  size_t const count = 2 * shards;
+
+  ACE_Sharded_Reactor sharded (shards);
+  ACE_Reactor reactor (&sharded);
+
+  Shard_Handler handlers[count];
+  Shard_Handler timer_handler;
+
+  for (size_t i = 0; i < count; ++i)
+    if (handlers[i].pipe_.open () != 0)
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("pipe")), 1);
+
+  // Half registered before the thread is started.
+  for (size_t i = 0; i < count / 2; ++i)
+    if (reactor.register_handler (&handlers[i],
+                                  ACE_Event_Handler::READ_MASK) != 0)
+      ACE_ERROR_RETURN ((LM_ERROR,
+                         ACE_TEXT ("%p\n"),
+                         ACE_TEXT ("register_handler")),
+                        1);
+
+  // An input, a notification per handler and one timeout.
+  outstanding = 2 * static_cast<long> (count) + 1;
+
+  ACE_Barrier barrier (2);
+  Lone_Args args;
+  args.reactor = &reactor;
+  args.sharded = &sharded;
+  args.barrier = &barrier;
+  args.thread = ACE_OS::NULL_thread;
+  args.shard = -1;
+
+  if (ACE_Thread_Manager::instance ()->spawn (lone_worker, &args) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn")), 1);
+  barrier.wait ();
+
+  // The other half once it runs.
+  for (size_t i = count / 2; i < count; ++i)
+    if (reactor.register_handler (&handlers[i],
+                                  ACE_Event_Handler::READ_MASK) != 0)
+      {
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("%p\n"),
+                    ACE_TEXT ("register_handler")));
+        status = 1;
+      }
+
+  for (size_t i = 0; i < count; ++i)
+    {
+      handlers[i].owner_ = args.thread;
+      if (sharded.handle_shard (handlers[i].get_handle ()) != args.shard)
+        {
+          ACE_ERROR ((LM_ERROR,
+                      ACE_TEXT ("Handle %d is on shard %d, the thread ")
+                      ACE_TEXT ("runs shard %d\n"),
+                      handlers[i].get_handle (),
+                      sharded.handle_shard (handlers[i].get_handle ()),
+                      args.shard));
+          status = 1;
+        }
+    }
+  timer_handler.owner_ = args.thread;
+
+  for (size_t i = 0; i < count; ++i)
+    {
+      ACE::send_n (handlers[i].pipe_.write_handle (), "x", 1);
+      reactor.notify (&handlers[i]);
+    }
+  if (reactor.schedule_timer (&timer_handler,
+                              0,
+                              ACE_Time_Value (0, 10000)) == -1)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("schedule_timer")));
+      status = 1;
+    }
+
+  ACE_Thread_Manager::instance ()->wait ();
+
+  if (outstanding.value () != 0 || stray_upcalls.value () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%d upcalls missing with one thread ")
+                  ACE_TEXT ("for %B shards\n"),
+                  static_cast<int> (outstanding.value ()),
+                  shards));
+      status = 1;
+    }
+
+  for (size_t i = 0; i < count; ++i)
+    reactor.remove_handler (&handlers[i],
+                            ACE_Event_Handler::ALL_EVENTS_MASK
+                            | ACE_Event_Handler::DONT_CALL);
+
+  return status;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Sharded_Reactor_Test"));
+
+  int result = test_sharded_reactor ();
+  if (test_fewer_threads () != 0)
+    result = 1;
+
+  ACE_END_TEST;
+  return result;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Sharded_Reactor_Test"));
+  ACE_ERROR ((LM_INFO,
+              ACE_TEXT ("Dev Poll and Event Poll are not supported ")
+              ACE_TEXT ("on this platform\n")));
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif  /* ACE_HAS_EVENT_POLL || ACE_HAS_DEV_POLL */
@@ -0,0 +1,241 @@
+//=============================================================================
+/**
+ *  @file    TSS_Cached_Allocator_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks ACE_TSS_Cached_Allocator.  Producer threads build
+ *  message blocks whose message block, data block and buffer all come
+ *  from thread-cached allocators and hand them to consumer threads,
+ *  which check and release them, so that chunks keep moving from the
+ *  cache of one thread to that of another.  Once the threads have
+ *  exited all the chunks must be back in the depots, and once the
+ *  allocators are gone, back in the backing allocator.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/TSS_Cached_Allocator.h"
+#include "ace/Message_Block.h"
+#include "ace/Message_Queue.h"
+#include "ace/Thread_Manager.h"
+#include "ace/Atomic_Op.h"
+#include "ace/OS_NS_string.h"
+
+#if defined (ACE_HAS_THREADS)
+
+static const int producers = 2;
+static const int consumers = 2;
+static const int blocks_per_producer = 100000;
+static const size_t buffer_size = 256;
+
+/**
+ * @class Counting_Allocator
+ *
+ * Keeps track of the chunks the thread-cached allocators get from it.
+ */
+class Counting_Allocator : public ACE_New_Allocator
+{
+public:
+  virtual void *malloc (size_t nbytes)
+  {
+    ++this->outstanding_;
+    return this->ACE_New_Allocator::malloc (nbytes);
+  }
+
+  virtual void free (void *ptr)
+  {
+    --this->outstanding_;
+    this->ACE_New_Allocator::free (ptr);
+  }
+
+  ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> outstanding_;
+};
+
+static Counting_Allocator backing;
+static ACE_TSS_Cached_Allocator *mb_allocator = 0;
+static ACE_TSS_Cached_Allocator *db_allocator = 0;
+static ACE_TSS_Cached_Allocator *buffer_allocator = 0;
+static ACE_Message_Queue<ACE_MT_SYNCH> *queue = 0;
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> errors (0);
+
+static ACE_THR_FUNC_RETURN
+producer (void *)
+{
+  for (int i = 0; i < blocks_per_producer; ++i)
+    {
+      ACE_Message_Block *mb = 0;
+      ACE_NEW_MALLOC_RETURN (mb,
+                             static_cast<ACE_Message_Block *> (
+                               mb_allocator->malloc (sizeof (ACE_Message_Block))),
+                             ACE_Message_Block (buffer_size,
+                                                ACE_Message_Block::MB_DATA,
+                                                0,
+                                                0,
+                                                buffer_allocator,
+                                                0,
+                                                ACE_DEFAULT_MESSAGE_BLOCK_PRIORITY,
+                                                ACE_Time_Value::zero,
+                                                ACE_Time_Value::max_time,
+                                                db_allocator,
+                                                mb_allocator),
+                             0);
+      ACE_OS::memset (mb->wr_ptr (), i & 0xff, buffer_size);
+      mb->wr_ptr (buffer_size);
+      queue->enqueue_tail (mb);
+    }
+
+  ACE_Message_Block *stop = 0;
+  ACE_NEW_RETURN (stop, ACE_Message_Block (0, ACE_Message_Block::MB_STOP), 0);
+  queue->enqueue_tail (stop);
+  return 0;
+}
+
+static ACE_THR_FUNC_RETURN
+consumer (void *)
+{
+  for (;;)
+    {
+      ACE_Message_Block *mb = 0;
+      if (queue->dequeue_head (mb) == -1)
+        {
+          ++errors;
+          return 0;
+        }
+
+      if (mb->msg_type () == ACE_Message_Block::MB_STOP)
+        {
+          mb->release ();
+          return 0;
+        }
+
+      char const expected = mb->rd_ptr ()[0];
+      if (mb->length () != buffer_size)
+        ++errors;
+      else
+        for (size_t i = 1; i < buffer_size; ++i)
+          if (mb->rd_ptr ()[i] != expected)
+            {
+              ++errors;
+              break;
+            }
+      mb->release ();
+    }
+}
+
+static int
+check_depots (void)
+{
+  size_t const in_depots = mb_allocator->pool_depth ()
+    + db_allocator->pool_depth ()
+    + buffer_allocator->pool_depth ();
+  if (backing.outstanding_.value () != static_cast<long> (in_depots))
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%d chunks allocated, %B in the depots\n"),
+                       backing.outstanding_.value (),
+                       in_depots),
+                      -1);
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("%B chunks back in the depots\n"),
+              in_depots));
+  return 0;
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("TSS_Cached_Allocator_Test"));
+
+  int status = 0;
+
+  ACE_NEW_RETURN (mb_allocator,
+                  ACE_TSS_Cached_Allocator (sizeof (ACE_Message_Block),
+                                            0,
+                                            ACE_DEFAULT_TSS_CACHED_ALLOCATOR_MAGAZINE_SIZE,
+                                            &backing),
+                  -1);
+  ACE_NEW_RETURN (db_allocator,
+                  ACE_TSS_Cached_Allocator (sizeof (ACE_Data_Block),
+                                            1000,
+                                            ACE_DEFAULT_TSS_CACHED_ALLOCATOR_MAGAZINE_SIZE,
+                                            &backing),
+                  -1);
+  ACE_NEW_RETURN (buffer_allocator,
+                  ACE_TSS_Cached_Allocator (buffer_size, 0, 16, &backing),
+                  -1);
+  ACE_NEW_RETURN (queue, ACE_Message_Queue<ACE_MT_SYNCH>, -1);
+
+  if (db_allocator->pool_depth () != 1000)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B chunks preallocated, expected 1000\n"),
+                  db_allocator->pool_depth ()));
+      status = -1;
+    }
+
+  // Oversized requests are refused.
+  if (buffer_allocator->malloc (buffer_allocator->chunk_size () + 1) != 0)
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("oversized malloc succeeded\n")));
+      status = -1;
+    }
+
+  if (ACE_Thread_Manager::instance ()->spawn_n (producers, producer) == -1
+      || ACE_Thread_Manager::instance ()->spawn_n (consumers, consumer) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn_n")), -1);
+  ACE_Thread_Manager::instance ()->wait ();
+
+  if (errors.value () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%d corrupted or lost message blocks\n"),
+                  errors.value ()));
+      status = -1;
+    }
+
+  // The caches of the threads went back to the depots when they exited.
+  if (check_depots () != 0)
+    status = -1;
+
+  // The main thread gets a cache of its own.
+  void *chunk = buffer_allocator->calloc (buffer_size, 'x');
+  if (chunk == 0 || static_cast<char *> (chunk)[buffer_size - 1] != 'x')
+    {
+      ACE_ERROR ((LM_ERROR, ACE_TEXT ("calloc failed\n")));
+      status = -1;
+    }
+  buffer_allocator->free (chunk);
+  buffer_allocator->flush ();
+  if (check_depots () != 0)
+    status = -1;
+
+  delete queue;
+  delete mb_allocator;
+  delete db_allocator;
+  delete buffer_allocator;
+
+  if (backing.outstanding_.value () != 0)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%d chunks not returned to the backing allocator\n"),
+                  backing.outstanding_.value ()));
+      status = -1;
+    }
+
+  ACE_END_TEST;
+  return status;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("TSS_Cached_Allocator_Test"));
+  ACE_ERROR ((LM_INFO,
+              ACE_TEXT ("threads not supported on this platform\n")));
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif /* ACE_HAS_THREADS */
@@ -5,9 +5,10 @@
  *
  *  $Id$
  *
- *    This is a simple test of <ACE_Timer_Queue> and four of its
+ *    This is a simple test of <ACE_Timer_Queue> and five of its
  *    subclasses (<ACE_Timer_List>, <ACE_Timer_Heap>,
- *    <ACE_Timer_Wheel>, and <ACE_Timer_Hash>).  The test sets up a
+ *    <ACE_Timer_Wheel>, <ACE_Timer_Hash> and
+ *    <ACE_Timer_Hierarchical_Wheel>).  The test sets up a
  *    bunch of timers and then adds them to a timer queue. The
  *    functionality of the timer queue is then tested. No command
  *    line arguments are needed to run the test.
@@ -27,6 +28,7 @@
 #include "ace/Timer_Heap.h"
 #include "ace/Timer_Wheel.h"
 #include "ace/Timer_Hash.h"
+#include "ace/Timer_Hierarchical_Wheel.h"
 #include "ace/Timer_Queue.h"
 #include "ace/Time_Policy.h"
 #include "ace/Recursive_Thread_Mutex.h"
@@ -34,6 +36,7 @@
 #include "ace/OS_NS_unistd.h"
 #include "ace/Containers_T.h"
 #include "ace/Event_Handler.h"
+#include "ace/OS_NS_stdlib.h"
 
 // Number of iterations for the performance tests.  Some platforms
 // have a very high ACE_DEFAULT_TIMERS (HP-UX is 400), so limit this
@@ -579,6 +582,105 @@ test_unique_timer_heap_ids (void)
   return;
 }
 
+struct Cascade_Handler : public ACE_Event_Handler
+{
+  Cascade_Handler (void) : fired_ (0), errors_ (0) { }
+
+  virtual int handle_timeout (const ACE_Time_Value &cur_time,
+                              const void *arg)
+  {
+    // Each timer must fire in the first expire() at or after its time.
+    const ACE_Time_Value *due = static_cast<const ACE_Time_Value *> (arg);
+    if (*due > cur_time || *due <= this->last_expire_)
+      ++this->errors_;
+    ++this->fired_;
+    return 0;
+  }
+
+  ACE_Time_Value last_expire_;
+  int fired_;
+  int errors_;
+};
+
+// Check that ACE_Timer_Hierarchical_Wheel neither loses timers nor
+// fires them early or late as they cascade down its levels.  A small
+// wheel of two levels of 16 ticks makes sure that the timers go
+// through both levels and the overflow list.  The wheel is driven by
+// expire(), or, if @a single, one timer at a time by dispatch_info(),
+// as expire_single() does.
+static void
+test_hierarchical_wheel_cascading (bool single)
+{
+  ACE_Timer_Hierarchical_Wheel wheel (ACE_Time_Value (0, 1000), 2, 4);
+  Cascade_Handler handler;
+  const int timer_count = 1000;
+  const int max_delay_msec = 2000;
+
+  ACE_Time_Value *times = 0;
+  ACE_NEW (times, ACE_Time_Value[timer_count]);
+  long *ids = 0;
+  ACE_NEW (ids, long[timer_count]);
+
+  // A fixed seed, so that a failure can be reproduced.
+  u_int const seed = 20261017;
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("hierarchical wheel (%s): seed %u\n"),
+              single ? ACE_TEXT ("dispatch_info") : ACE_TEXT ("expire"),
+              seed));
+  ACE_OS::srand (seed);
+  ACE_Time_Value const start = wheel.gettimeofday ();
+  for (int i = 0; i < timer_count; ++i)
+    {
+      times[i] = start
+        + ACE_Time_Value (0, (ACE_OS::rand () % max_delay_msec) * 1000
+                             + ACE_OS::rand () % 1000);
+      ids[i] = wheel.schedule (&handler, &times[i], times[i]);
+      ACE_TEST_ASSERT (ids[i] != -1);
+    }
+
+  // Cancel every third timer.
+  int cancelled = 0;
+  for (int i = 0; i < timer_count; i += 3)
+    {
+      ACE_TEST_ASSERT (wheel.cancel (ids[i]) == 1);
+      ACE_TEST_ASSERT (wheel.cancel (ids[i]) == 0);
+      ++cancelled;
+    }
+
+  ACE_Time_Value now = start;
+  ACE_Time_Value const step (0, 7000);
+  while (!wheel.is_empty ())
+    {
+      // earliest_time() must agree with the timers still there.
+      ACE_Time_Value earliest = ACE_Time_Value::max_time;
+      for (int i = 0; i < timer_count; ++i)
+        if (i % 3 != 0 && times[i] > handler.last_expire_ && times[i] < earliest)
+          earliest = times[i];
+      ACE_TEST_ASSERT (wheel.earliest_time () == earliest);
+
+      now += step;
+      if (single)
+        {
+          ACE_Timer_Node_Dispatch_Info_T<ACE_Event_Handler *> info;
+          while (wheel.dispatch_info (now, info) != 0)
+            info.type_->handle_timeout (now, info.act_);
+        }
+      else
+        wheel.expire (now);
+      handler.last_expire_ = now;
+    }
+
+  ACE_DEBUG ((LM_DEBUG,
+              ACE_TEXT ("hierarchical wheel: %d timers fired, %d cancelled, ")
+              ACE_TEXT ("%d errors\n"),
+              handler.fired_, cancelled, handler.errors_));
+  ACE_TEST_ASSERT (handler.fired_ + cancelled == timer_count);
+  ACE_TEST_ASSERT (handler.errors_ == 0);
+
+  delete [] ids;
+  delete [] times;
+}
+
 /**
  * @class Timer_Queue_Stack
  *
@@ -660,6 +762,24 @@ run_main (int argc, ACE_TCHAR *argv[])
                                      ACE_TEXT ("ACE_Timer_Wheel (preallocated)"),
                                      tq_stack),
                   -1);
+  // Timer_Hierarchical_Wheel without preallocated memory.
+  ACE_NEW_RETURN (tq_stack,
+                  Timer_Queue_Stack (new ACE_Timer_Hierarchical_Wheel,
+                                     ACE_TEXT ("ACE_Timer_Hierarchical_Wheel (non-preallocated)"),
+                                     tq_stack),
+                  -1);
+
+  // Timer_Hierarchical_Wheel with preallocated memory.
+  ACE_NEW_RETURN (tq_stack,
+                  Timer_Queue_Stack (new ACE_Timer_Hierarchical_Wheel (
+                                       ACE_Time_Value (0, ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_RESOLUTION),
+                                       ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_LEVELS,
+                                       ACE_DEFAULT_TIMER_HIERARCHICAL_WHEEL_SLOT_BITS,
+                                       max_iterations),
+                                     ACE_TEXT ("ACE_Timer_Hierarchical_Wheel (preallocated)"),
+                                     tq_stack),
+                  -1);
+
   // Timer_Heap without preallocated memory.
   ACE_NEW_RETURN (tq_stack,
                   Timer_Queue_Stack (new ACE_Timer_Heap,
@@ -728,6 +848,12 @@ run_main (int argc, ACE_TCHAR *argv[])
       ACE_TEXT ("**** starting unique IDs test for ACE_Timer_Heap\n")));
   test_unique_timer_heap_ids ();
 
+  ACE_DEBUG
+    ((LM_DEBUG,
+      ACE_TEXT ("**** starting cascading test for ACE_Timer_Hierarchical_Wheel\n")));
+  test_hierarchical_wheel_cascading (false);
+  test_hierarchical_wheel_cascading (true);
+
   ACE_END_TEST;
   return 0;
 }
@@ -0,0 +1,377 @@
+//=============================================================================
+/**
+ *  @file    Work_Stealing_Executor_Test.cpp
+ *
+ *  $Id$
+ *
+ *  This test checks ACE_Work_Stealing_Executor and
+ *  ACE_Work_Stealing_Activation_Queue: every request must be executed
+ *  exactly once, whether it is enqueued from outside the pool or by a
+ *  request running in the pool, an active object must be able to use
+ *  the activation queue adapter with threads of its own, requests
+ *  left over when the executor goes away must be deleted, and threads
+ *  that come and go must give their deques back.
+ */
+//=============================================================================
+
+#include "test_config.h"
+#include "ace/Work_Stealing_Executor.h"
+#include "ace/Method_Request.h"
+#include "ace/Task.h"
+#include "ace/Atomic_Op.h"
+#include "ace/OS_NS_errno.h"
+#include "ace/OS_NS_sys_time.h"
+#include "ace/OS_NS_unistd.h"
+
+#if defined (ACE_HAS_THREADS) && defined (ACE_HAS_CPP11)
+
+static const int pool_threads = 4;
+static const int request_count = 100000;
+static const int tree_depth = 14;
+
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> executed (0);
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> deleted (0);
+
+/**
+ * @class Count_Request
+ *
+ * Counts its execution and deletion.
+ */
+class Count_Request : public ACE_Method_Request
+{
+public:
+  virtual ~Count_Request (void) { ++deleted; }
+
+  virtual int call (void)
+  {
+    ++executed;
+    return 0;
+  }
+};
+
+/**
+ * @class Tree_Request
+ *
+ * Enqueues two more requests, one level down, from within the pool,
+ * so that the pool threads have to steal from each other.
+ */
+class Tree_Request : public ACE_Method_Request
+{
+public:
+  Tree_Request (ACE_Work_Stealing_Executor &executor, int depth)
+    : executor_ (executor), depth_ (depth)
+  {
+  }
+
+  virtual ~Tree_Request (void) { ++deleted; }
+
+  virtual int call (void)
+  {
+    ++executed;
+    if (this->depth_ > 0)
+      for (int i = 0; i < 2; ++i)
+        this->executor_.enqueue (new Tree_Request (this->executor_,
+                                                   this->depth_ - 1));
+    return 0;
+  }
+
+private:
+  ACE_Work_Stealing_Executor &executor_;
+  int depth_;
+};
+
+static int
+check_counts (const ACE_TCHAR *name, long expected)
+{
+  if (executed.value () != expected || deleted.value () != expected)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%s: %d executed, %d deleted, %d expected\n"),
+                       name,
+                       executed.value (),
+                       deleted.value (),
+                       expected),
+                      -1);
+  ACE_DEBUG ((LM_DEBUG, ACE_TEXT ("%s: ok\n"), name));
+  executed = 0;
+  deleted = 0;
+  return 0;
+}
+
+// A pool of executor threads runs requests enqueued from outside and
+// from within the pool.
+static int
+pool_test (void)
+{
+  ACE_Work_Stealing_Executor executor;
+  if (executor.activate (THR_NEW_LWP | THR_JOINABLE, pool_threads) == -1)
+    ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("activate")), -1);
+
+  for (int i = 0; i < request_count; ++i)
+    if (executor.enqueue (new Count_Request) == -1)
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("enqueue")), -1);
+
+  executor.enqueue (new Tree_Request (executor, tree_depth));
+
+  // Wait for the tree to be complete before refusing new requests.
+  long const total = request_count + (2L << tree_depth) - 1;
+  ACE_Time_Value const deadline =
+    ACE_OS::gettimeofday () + ACE_Time_Value (60);
+  while (executed.value () < total && ACE_OS::gettimeofday () < deadline)
+    ACE_OS::sleep (ACE_Time_Value (0, 10000));
+
+  executor.deactivate ();
+  executor.wait ();
+
+  int status = 0;
+  if (!executor.is_empty ())
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("%B requests left\n"),
+                  executor.method_count ()));
+      status = -1;
+    }
+
+  Count_Request *late = new Count_Request;
+  if (executor.enqueue (late) != -1 || errno != ESHUTDOWN)
+    {
+      ACE_ERROR ((LM_ERROR,
+                  ACE_TEXT ("deactivated executor accepted a request\n")));
+      status = -1;
+    }
+  else
+    {
+      delete late;
+      --deleted;
+    }
+
+  if (check_counts (ACE_TEXT ("Pool"), total) != 0)
+    status = -1;
+  return status;
+}
+
+/**
+ * @class Exit_Request
+ *
+ * Tells the active object thread that runs it to exit.
+ */
+class Exit_Request : public ACE_Method_Request
+{
+public:
+  virtual int call (void) { return -1; }
+};
+
+/**
+ * @class Active_Object
+ *
+ * A classic active object, with scheduler threads of its own taking
+ * requests from a work-stealing activation queue.
+ */
+class Active_Object : public ACE_Task_Base
+{
+public:
+  virtual int svc (void)
+  {
+    for (;;)
+      {
+        ACE_Method_Request *mr = this->activation_queue_.dequeue ();
+        if (mr == 0)
+          return -1;
+        int const result = mr->call ();
+        delete mr;
+        if (result == -1)
+          return 0;
+      }
+  }
+
+  ACE_Work_Stealing_Activation_Queue activation_queue_;
+};
+
+static int
+activation_queue_test (void)
+{
+  int status = 0;
+  {
+    Active_Object object;
+    if (object.activate (THR_NEW_LWP | THR_JOINABLE, pool_threads) == -1)
+      ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("activate")), -1);
+
+    for (int i = 0; i < request_count; ++i)
+      object.activation_queue_.enqueue (new Count_Request);
+    for (int i = 0; i < pool_threads; ++i)
+      object.activation_queue_.enqueue (new Exit_Request);
+
+    object.wait ();
+
+    if (object.activation_queue_.is_empty () == 0
+        || object.activation_queue_.is_full () != 0)
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("activation queue not empty\n")));
+        status = -1;
+      }
+
+    // Timeouts and deactivation.
+    ACE_Time_Value timeout (ACE_OS::gettimeofday () + ACE_Time_Value (0, 100000));
+    if (object.activation_queue_.dequeue (&timeout) != 0
+        || errno != EWOULDBLOCK)
+      {
+        ACE_ERROR ((LM_ERROR, ACE_TEXT ("dequeue did not time out\n")));
+        status = -1;
+      }
+
+    object.activation_queue_.deactivate ();
+    if (object.activation_queue_.dequeue () != 0 || errno != ESHUTDOWN)
+      {
+        ACE_ERROR ((LM_ERROR,
+                    ACE_TEXT ("dequeue on a deactivated queue\n")));
+        status = -1;
+      }
+  }
+
+  if (check_counts (ACE_TEXT ("Activation queue"), request_count) != 0)
+    status = -1;
+  return status;
+}
+
+// Requests that never ran are deleted with the executor.
+static int
+leftover_test (void)
+{
+  {
+    ACE_Work_Stealing_Executor executor;
+    for (int i = 0; i < 100; ++i)
+      executor.enqueue (new Count_Request);
+
+    // Give this thread a deque and leave requests on it too.
+    ACE_Method_Request *mr = executor.dequeue ();
+    delete mr;
+    for (int i = 0; i < 100; ++i)
+      executor.enqueue (new Count_Request);
+
+    if (executor.method_count () != 199)
+      ACE_ERROR_RETURN ((LM_ERROR,
+                         ACE_TEXT ("%B requests queued, expected 199\n"),
+                         executor.method_count ()),
+                        -1);
+  }
+
+  executed = deleted.value ();
+  return check_counts (ACE_TEXT ("Leftovers"), 200);
+}
+
+static const int turnover_rounds = 20;
+static const int turnover_threads = 2;
+static const int turnover_left = 50;
+
+static ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> turnover_errors (0);
+
+// Take a request, which gives the thread a deque, then leave requests
+// on that deque and exit.
+static ACE_THR_FUNC_RETURN
+short_lived (void *arg)
+{
+  ACE_Work_Stealing_Executor *executor =
+    static_cast<ACE_Work_Stealing_Executor *> (arg);
+
+  ACE_Method_Request *mr = executor->dequeue ();
+  if (mr == 0)
+    {
+      ++turnover_errors;
+      return 0;
+    }
+  mr->call ();
+  delete mr;
+
+  if (executor->deques_in_use () > static_cast<size_t> (turnover_threads))
+    ++turnover_errors;
+
+  for (int i = 0; i < turnover_left; ++i)
+    executor->enqueue (new Count_Request);
+  return 0;
+}
+
+// Threads that come and go must give their deques back, and the
+// requests they leave behind must still be executed.
+static int
+turnover_test (void)
+{
+  executed = 0;
+  deleted = 0;
+  turnover_errors = 0;
+
+  ACE_Work_Stealing_Executor executor (turnover_threads);
+
+  for (int round = 0; round < turnover_rounds; ++round)
+    {
+      for (int i = 0; i < turnover_threads; ++i)
+        executor.enqueue (new Count_Request);
+
+      if (ACE_Thread_Manager::instance ()->spawn_n (turnover_threads,
+                                                    short_lived,
+                                                    &executor) == -1)
+        ACE_ERROR_RETURN ((LM_ERROR, ACE_TEXT ("%p\n"), ACE_TEXT ("spawn_n")),
+                          -1);
+      ACE_Thread_Manager::instance ()->wait ();
+
+      if (executor.deques_in_use () != 0)
+        ACE_ERROR_RETURN ((LM_ERROR,
+                           ACE_TEXT ("%B deques still held after round %d\n"),
+                           executor.deques_in_use (),
+                           round),
+                          -1);
+    }
+
+  if (turnover_errors.value () != 0)
+    ACE_ERROR_RETURN ((LM_ERROR,
+                       ACE_TEXT ("%d short-lived threads failed\n"),
+                       static_cast<int> (turnover_errors.value ())),
+                      -1);
+
+  // Run what the threads left behind.
+  for (;;)
+    {
+      ACE_Time_Value timeout =
+        ACE_OS::gettimeofday () + ACE_Time_Value (0, 100000);
+      ACE_Method_Request *mr = executor.dequeue (&timeout);
+      if (mr == 0)
+        break;
+      mr->call ();
+      delete mr;
+    }
+
+  return check_counts (ACE_TEXT ("Turnover"),
+                       turnover_rounds * turnover_threads
+                       * (1 + turnover_left));
+}
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Work_Stealing_Executor_Test"));
+
+  int status = 0;
+  if (pool_test () != 0)
+    status = -1;
+  if (activation_queue_test () != 0)
+    status = -1;
+  if (leftover_test () != 0)
+    status = -1;
+  if (turnover_test () != 0)
+    status = -1;
+
+  ACE_END_TEST;
+  return status;
+}
+
+#else
+
+int
+run_main (int, ACE_TCHAR *[])
+{
+  ACE_START_TEST (ACE_TEXT ("Work_Stealing_Executor_Test"));
+  ACE_ERROR ((LM_INFO,
+              ACE_TEXT ("The work-stealing executor needs threads and C++11\n")));
+  ACE_END_TEST;
+  return 0;
+}
+
+#endif /* ACE_HAS_THREADS && ACE_HAS_CPP11 */